@@ -4,7 +4,7 @@ use std::time::Instant;
 use openentropy_core::TelemetryWindowReport;
 use openentropy_core::conditioning::{quick_min_entropy, quick_quality, quick_shannon};
 use openentropy_core::platform::detect_available_sources;
-use serde::Serialize;
+use serde::{Deserialize, Serialize};
 
 #[derive(Clone, Copy, Debug)]
 enum BenchProfile {
@@ -18,6 +18,7 @@ enum RankBy {
     Balanced,
     MinEntropy,
     Throughput,
+    MinEntropyRate,
 }
 
 #[derive(Clone, Copy, Debug)]
@@ -42,6 +43,7 @@ struct SourceAccumulator {
 struct BenchRow {
     name: String,
     composite: bool,
+    prototype: bool,
     success_rounds: usize,
     failures: u64,
     avg_shannon: f64,
@@ -51,6 +53,13 @@ struct BenchRow {
     score: f64,
 }
 
+impl BenchRow {
+    /// H∞ bits per second: min-entropy per byte times bytes per second.
+    fn min_entropy_rate(&self) -> f64 {
+        self.avg_min_entropy * self.avg_throughput_bps
+    }
+}
+
 #[derive(Serialize)]
 struct BenchReport {
     generated_unix: u64,
@@ -76,12 +85,15 @@ struct BenchSettingsJson {
 struct BenchSourceReport {
     name: String,
     composite: bool,
+    #[serde(skip_serializing_if = "std::ops::Not::not")]
+    prototype: bool,
     healthy: bool,
     success_rounds: usize,
     failures: u64,
     avg_shannon: f64,
     avg_min_entropy: f64,
     avg_throughput_bps: f64,
+    min_entropy_rate_bps: f64,
     stability: f64,
     grade: char,
     score: f64,
@@ -96,6 +108,34 @@ struct PoolQualityReport {
     total_sources: usize,
 }
 
+/// Schema tag written by `research/poc/poc_bench`.
+const POC_BENCH_SCHEMA: &str = "poc_bench_v1";
+
+#[derive(Deserialize)]
+struct PocBenchFile {
+    schema: String,
+    collectors: Vec<PocBenchCollector>,
+}
+
+#[derive(Deserialize)]
+struct PocBenchCollector {
+    name: String,
+    /// Background load the collector ran under (`poc_bench -L`).
+    #[serde(default)]
+    load: Option<String>,
+    batches: Vec<PocBenchBatch>,
+}
+
+#[derive(Deserialize)]
+struct PocBenchBatch {
+    reps: usize,
+    #[serde(default)]
+    failed_reps: u64,
+    samples_per_sec: f64,
+    shannon: f64,
+    min_entropy: f64,
+}
+
 pub struct BenchCommandConfig<'a> {
     pub source_filter: Option<&'a str>,
     pub conditioning: &'a str,
@@ -107,6 +147,7 @@ pub struct BenchCommandConfig<'a> {
     pub timeout_sec: Option<f64>,
     pub rank_by: &'a str,
     pub output_path: Option<&'a str>,
+    pub poc_json_path: Option<&'a str>,
     pub include_pool_quality: bool,
     pub include_telemetry: bool,
 }
@@ -241,6 +282,7 @@ pub fn run(cfg: BenchCommandConfig<'_>) {
             BenchRow {
                 name: info.name.clone(),
                 composite: info.composite,
+                prototype: false,
                 success_rounds,
                 failures,
                 avg_shannon,
@@ -252,6 +294,19 @@ pub fn run(cfg: BenchCommandConfig<'_>) {
         })
         .collect();
 
+    if let Some(path) = cfg.poc_json_path {
+        match load_poc_rows(path, settings.rounds) {
+            Ok(poc) => {
+                println!("Merged {} PoC collectors from {path}", poc.len());
+                rows.extend(poc);
+            }
+            Err(e) => {
+                eprintln!("Failed to read PoC benchmark {path}: {e}");
+                std::process::exit(1);
+            }
+        }
+    }
+
     let max_throughput = rows
         .iter()
         .map(|r| r.avg_throughput_bps)
@@ -261,6 +316,7 @@ pub fn run(cfg: BenchCommandConfig<'_>) {
         row.score = match rank_by {
             RankBy::MinEntropy => row.avg_min_entropy,
             RankBy::Throughput => row.avg_throughput_bps,
+            RankBy::MinEntropyRate => row.min_entropy_rate(),
             RankBy::Balanced => {
                 let min_h_term = (row.avg_min_entropy / 8.0).clamp(0.0, 1.0);
                 let throughput_term = if max_throughput > 0.0 {
@@ -288,12 +344,12 @@ pub fn run(cfg: BenchCommandConfig<'_>) {
             .unwrap_or(std::cmp::Ordering::Equal)
     });
 
-    println!("\n{}", "=".repeat(96));
+    println!("\n{}", "=".repeat(107));
     println!(
-        "{:<25} {:>5} {:>7} {:>7} {:>10} {:>8} {:>10} {:>6} {:>9}",
-        "Source", "Grade", "H", "H∞", "KB/s", "Stability", "Rounds", "Fail", "State"
+        "{:<25} {:>5} {:>7} {:>7} {:>10} {:>10} {:>8} {:>10} {:>6} {:>9}",
+        "Source", "Grade", "H", "H∞", "KB/s", "H∞ kb/s", "Stability", "Rounds", "Fail", "State"
     );
-    println!("{}", "-".repeat(96));
+    println!("{}", "-".repeat(107));
     for row in &rows {
         let grade = openentropy_core::grade_min_entropy(row.avg_min_entropy.max(0.0));
         let state = if row.success_rounds == 0 || row.failures > 0 {
@@ -301,14 +357,21 @@ pub fn run(cfg: BenchCommandConfig<'_>) {
         } else {
             "OK"
         };
-        let composite = if row.composite { " [C]" } else { "" };
+        let composite = if row.composite {
+            " [C]"
+        } else if row.prototype {
+            " [P]"
+        } else {
+            ""
+        };
         println!(
-            "{:<25} {:>5} {:>7.3} {:>7.3} {:>10.1} {:>8.2} {:>6}/{} {:>6} {:>9}{}",
+            "{:<25} {:>5} {:>7.3} {:>7.3} {:>10.1} {:>10.1} {:>8.2} {:>6}/{} {:>6} {:>9}{}",
             row.name,
             grade,
             row.avg_shannon,
             row.avg_min_entropy,
             row.avg_throughput_bps / 1024.0,
+            row.min_entropy_rate() / 1000.0,
             row.stability,
             row.success_rounds,
             settings.rounds,
@@ -320,6 +383,11 @@ pub fn run(cfg: BenchCommandConfig<'_>) {
     println!();
     println!("Grade is based on min-entropy (H∞), not Shannon.");
     println!("Stability is derived from run-to-run min-entropy consistency (1.0 = most stable).");
+    if cfg.poc_json_path.is_some() {
+        println!(
+            "[P] rows are research/poc collectors (best batch size; stability across batch sizes)."
+        );
+    }
 
     let pool_report = if cfg.include_pool_quality {
         let bytes = 65_536usize;
@@ -375,12 +443,14 @@ pub fn run(cfg: BenchCommandConfig<'_>) {
                 .map(|row| BenchSourceReport {
                     name: row.name.clone(),
                     composite: row.composite,
+                    prototype: row.prototype,
                     healthy: row.avg_min_entropy > 1.0 && row.failures == 0,
                     success_rounds: row.success_rounds,
                     failures: row.failures,
                     avg_shannon: row.avg_shannon,
                     avg_min_entropy: row.avg_min_entropy,
                     avg_throughput_bps: row.avg_throughput_bps,
+                    min_entropy_rate_bps: row.min_entropy_rate(),
                     stability: row.stability,
                     grade: openentropy_core::grade_min_entropy(row.avg_min_entropy.max(0.0)),
                     score: row.score,
@@ -401,6 +471,54 @@ fn snapshot_counters(sources: &[openentropy_core::SourceHealth]) -> HashMap<Stri
         .collect()
 }
 
+fn load_poc_rows(path: &str, rounds: usize) -> Result<Vec<BenchRow>, String> {
+    let text = std::fs::read_to_string(path).map_err(|e| e.to_string())?;
+    let file: PocBenchFile = serde_json::from_str(&text).map_err(|e| e.to_string())?;
+    poc_rows(file, rounds)
+}
+
+/// One row per PoC collector at its best batch size by H∞ rate. Each
+/// C sample is XOR-folded to one byte, so samples/sec is bytes/sec and
+/// the row ranks on the same scale as a Rust source. Rows measured under
+/// a background load other than idle are named `poc:<name>@<load>`.
+fn poc_rows(file: PocBenchFile, rounds: usize) -> Result<Vec<BenchRow>, String> {
+    if file.schema != POC_BENCH_SCHEMA {
+        return Err(format!(
+            "unsupported schema '{}' (expected {POC_BENCH_SCHEMA})",
+            file.schema
+        ));
+    }
+    Ok(file
+        .collectors
+        .into_iter()
+        .map(|c| {
+            let measured: Vec<&PocBenchBatch> = c.batches.iter().filter(|b| b.reps > 0).collect();
+            let failures = c.batches.iter().map(|b| b.failed_reps).sum();
+            let best = measured.iter().copied().max_by(|a, b| {
+                (a.min_entropy * a.samples_per_sec)
+                    .partial_cmp(&(b.min_entropy * b.samples_per_sec))
+                    .unwrap_or(std::cmp::Ordering::Equal)
+            });
+            let per_batch: Vec<f64> = measured.iter().map(|b| b.min_entropy).collect();
+            BenchRow {
+                name: match c.load.as_deref() {
+                    Some(load) if load != "idle" => format!("poc:{}@{load}", c.name),
+                    _ => format!("poc:{}", c.name),
+                },
+                composite: false,
+                prototype: true,
+                success_rounds: if best.is_some() { rounds } else { 0 },
+                failures,
+                avg_shannon: best.map_or(0.0, |b| b.shannon),
+                avg_min_entropy: best.map_or(0.0, |b| b.min_entropy),
+                avg_throughput_bps: best.map_or(0.0, |b| b.samples_per_sec),
+                stability: stability_index(&per_batch),
+                score: 0.0,
+            }
+        })
+        .collect())
+}
+
 fn stability_index(values: &[f64]) -> f64 {
     if values.is_empty() {
         return 0.0;
@@ -465,6 +583,7 @@ impl RankBy {
         match s {
             "min_entropy" => Self::MinEntropy,
             "throughput" => Self::Throughput,
+            "min_entropy_rate" => Self::MinEntropyRate,
             _ => Self::Balanced,
         }
     }
@@ -474,6 +593,7 @@ impl RankBy {
             Self::Balanced => "balanced",
             Self::MinEntropy => "min_entropy",
             Self::Throughput => "throughput",
+            Self::MinEntropyRate => "min_entropy_rate",
         }
     }
 }
@@ -536,3 +656,76 @@ fn run_single_source(
     println!("  Unique values:   {}", quality.unique_values);
     println!("  Time:            {:.3}s", elapsed.as_secs_f64());
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn poc_file(json: &str) -> PocBenchFile {
+        serde_json::from_str(json).expect("valid poc_bench JSON")
+    }
+
+    #[test]
+    fn test_poc_rows_pick_best_batch_by_rate() {
+        let file = poc_file(
+            r#"{"schema": "poc_bench_v1", "generated_unix": 0, "collectors": [
+                {"name": "tlb_shootdown", "batches": [
+                    {"batch": 64, "reps": 10, "samples_per_sec": 1000.0,
+                     "shannon": 7.9, "min_entropy": 7.0},
+                    {"batch": 1024, "reps": 10, "samples_per_sec": 4000.0,
+                     "shannon": 7.5, "min_entropy": 6.0}
+                ]}
+            ]}"#,
+        );
+        let rows = poc_rows(file, 5).unwrap();
+        assert_eq!(rows.len(), 1);
+        let row = &rows[0];
+        assert_eq!(row.name, "poc:tlb_shootdown");
+        assert!(row.prototype);
+        assert_eq!(row.success_rounds, 5);
+        assert_eq!(row.avg_min_entropy, 6.0);
+        assert_eq!(row.avg_throughput_bps, 4000.0);
+        assert_eq!(row.min_entropy_rate(), 24000.0);
+    }
+
+    #[test]
+    fn test_poc_rows_without_samples_never_succeed() {
+        let file = poc_file(
+            r#"{"schema": "poc_bench_v1", "collectors": [
+                {"name": "kqueue_events", "batches": [
+                    {"batch": 64, "reps": 0, "failed_reps": 5, "samples_per_sec": 0.0,
+                     "shannon": 0.0, "min_entropy": 0.0}
+                ]}
+            ]}"#,
+        );
+        let rows = poc_rows(file, 5).unwrap();
+        assert_eq!(rows[0].success_rounds, 0);
+        assert_eq!(rows[0].failures, 5);
+        assert_eq!(rows[0].min_entropy_rate(), 0.0);
+    }
+
+    #[test]
+    fn test_poc_rows_name_the_load() {
+        let file = poc_file(
+            r#"{"schema": "poc_bench_v1", "collectors": [
+                {"name": "cas_contention", "load": "idle", "batches": []},
+                {"name": "cas_contention", "load": "mem", "batches": []}
+            ]}"#,
+        );
+        let rows = poc_rows(file, 5).unwrap();
+        assert_eq!(rows[0].name, "poc:cas_contention");
+        assert_eq!(rows[1].name, "poc:cas_contention@mem");
+    }
+
+    #[test]
+    fn test_poc_rows_reject_unknown_schema() {
+        let file = poc_file(r#"{"schema": "poc_bench_v0", "collectors": []}"#);
+        assert!(poc_rows(file, 5).is_err());
+    }
+
+    #[test]
+    fn test_rank_by_min_entropy_rate_roundtrip() {
+        let r = RankBy::parse("min_entropy_rate");
+        assert_eq!(r.as_str(), "min_entropy_rate");
+    }
+}
@@ -4,8 +4,12 @@ pub fn run(
     source_filter: Option<&str>,
     allow_raw: bool,
     include_telemetry: bool,
+    poc_harvest: Option<&str>,
 ) {
-    let pool = super::make_pool(source_filter);
+    let mut pool = super::make_pool(source_filter);
+    if let Some(socket) = poc_harvest {
+        add_harvest_sources(&mut pool, socket);
+    }
 
     let base = format!("http://{host}:{port}");
     let n_sources = pool.source_count();
@@ -46,3 +50,28 @@ pub fn run(
     let rt = tokio::runtime::Runtime::new().unwrap();
     rt.block_on(openentropy_server::run_server(pool, host, port, allow_raw));
 }
+
+#[cfg(unix)]
+fn add_harvest_sources(pool: &mut openentropy_core::EntropyPool, socket: &str) {
+    use openentropy_core::sources::frontier::harvest::{default_socket, harvest_sources};
+    let path = if socket.is_empty() {
+        default_socket()
+    } else {
+        std::path::PathBuf::from(socket)
+    };
+    let socket = path.display();
+    match harvest_sources(&path) {
+        Ok(sources) => {
+            println!("   {} poc collectors from {socket}", sources.len());
+            for source in sources {
+                pool.add_source(Box::new(source), 1.0);
+            }
+        }
+        Err(e) => eprintln!("Warning: no poc_runner harvest daemon at {socket}: {e}"),
+    }
+}
+
+#[cfg(not(unix))]
+fn add_harvest_sources(_pool: &mut openentropy_core::EntropyPool, socket: &str) {
+    eprintln!("Warning: --poc-harvest {socket} needs Unix domain sockets");
+}
@@ -6,8 +6,8 @@ use std::collections::HashMap;
 use std::time::Duration;
 
 use openentropy_core::{
-    TelemetryMetricDelta, TelemetrySnapshot, TelemetryWindowReport, collect_telemetry_snapshot,
-    collect_telemetry_window,
+    PocHistReport, TelemetryMetric, TelemetryMetricDelta, TelemetrySnapshot, TelemetryWindowReport,
+    collect_telemetry_snapshot, collect_telemetry_window, load_poc_hist_report, poc_hist_metrics,
 };
 
 /// Telemetry capture lifecycle helper shared by command handlers.
@@ -292,27 +292,110 @@ pub fn print_snapshot_if_enabled(enabled: bool, label: &str) -> Option<Telemetry
     Some(snapshot)
 }
 
+/// Pool budget a `poc_hist_v1` report is checked against.
+pub struct PocHistCheck<'a> {
+    pub path: &'a str,
+    pub pool_timeout_sec: f64,
+    pub pool_samples: usize,
+}
+
+fn merge_metrics(snapshot: &mut TelemetrySnapshot, extra: &[TelemetryMetric]) {
+    snapshot.metrics.extend_from_slice(extra);
+    snapshot.metrics.sort_by(|a, b| {
+        a.domain
+            .cmp(&b.domain)
+            .then(a.name.cmp(&b.name))
+            .then(a.source.cmp(&b.source))
+            .then(a.unit.cmp(&b.unit))
+    });
+}
+
+/// Rank PoC collectors by the p99 cost of one pool round (per-sample p99
+/// times the round's samples) and flag those that would miss the pool
+/// timeout, since `collect_all_parallel_n` drops and backs off a source
+/// that does.
+fn print_poc_hist_summary(report: &PocHistReport, check: &PocHistCheck) {
+    println!("\n{:=<68}", "");
+    println!(
+        "PoC collector latency ({} samples/round, {:.1}s pool timeout)",
+        check.pool_samples, check.pool_timeout_sec
+    );
+    println!("{:=<68}", "");
+    if report.collectors.is_empty() {
+        println!("  no collector calls recorded");
+        return;
+    }
+    let mut rows: Vec<_> = report.collectors.iter().collect();
+    let n = check.pool_samples;
+    rows.sort_by(|a, b| {
+        b.projected_p99_secs(n)
+            .partial_cmp(&a.projected_p99_secs(n))
+            .unwrap_or(Ordering::Equal)
+    });
+    println!(
+        "  {:<24} {:>7} {:>10} {:>10} {:>10} {:>10}",
+        "collector", "calls", "call p50", "call p99", "call max", "round p99"
+    );
+    let mut stalls = 0;
+    for c in rows {
+        let secs = c.projected_p99_secs(n);
+        let stall = secs > check.pool_timeout_sec;
+        stalls += stall as usize;
+        println!(
+            "  {:<24} {:>7} {:>10} {:>10} {:>10} {:>10}{}",
+            c.name,
+            c.calls,
+            format_value(c.call_ns.p50 / 1000.0, "us"),
+            format_value(c.call_ns.p99 / 1000.0, "us"),
+            format_value(c.call_ns.max / 1000.0, "us"),
+            format_value(secs, "s"),
+            if stall { "  STALLS POOL" } else { "" }
+        );
+    }
+    if stalls > 0 {
+        println!("  {stalls} collector(s) would exceed the pool timeout at p99");
+    }
+}
+
 /// Standalone telemetry command.
-pub fn run(window_sec: f64, output_path: Option<&str>) {
+pub fn run(window_sec: f64, output_path: Option<&str>, poc_hist: Option<PocHistCheck>) {
     if !window_sec.is_finite() || window_sec < 0.0 {
         eprintln!("Invalid --window-sec value: {window_sec}. Expected a finite value >= 0.");
         std::process::exit(2);
     }
+    let poc_report = poc_hist.as_ref().map(|check| {
+        match load_poc_hist_report(std::path::Path::new(check.path)) {
+            Ok(report) => report,
+            Err(e) => {
+                eprintln!("Cannot read --poc-hist report: {e}");
+                std::process::exit(2);
+            }
+        }
+    });
+    let poc_metrics = poc_report
+        .as_ref()
+        .map(poc_hist_metrics)
+        .unwrap_or_default();
     let window_sec = window_sec.min(86_400.0);
     if window_sec > 0.0 {
         println!("Collecting telemetry window for {:.2}s...", window_sec);
         let start = collect_telemetry_snapshot();
         std::thread::sleep(Duration::from_secs_f64(window_sec));
-        let report = collect_telemetry_window(start);
+        let mut report = collect_telemetry_window(start);
+        merge_metrics(&mut report.end, &poc_metrics);
         print_window_summary("telemetry", &report);
         if let Some(path) = output_path {
             super::write_json(&report, path, "Telemetry window");
         }
     } else {
-        let snapshot = collect_telemetry_snapshot();
+        let mut snapshot = collect_telemetry_snapshot();
+        merge_metrics(&mut snapshot, &poc_metrics);
         print_snapshot_summary("telemetry", &snapshot);
         if let Some(path) = output_path {
             super::write_json(&snapshot, path, "Telemetry snapshot");
         }
     }
+    if let (Some(report), Some(check)) = (&poc_report, &poc_hist) {
+        print_poc_hist_summary(report, check);
+    }
 }
@@ -60,7 +60,7 @@ enum Commands {
         timeout_sec: Option<f64>,
 
         /// Ranking strategy
-        #[arg(long, default_value = "balanced", value_parser = ["balanced", "min_entropy", "throughput"])]
+        #[arg(long, default_value = "balanced", value_parser = ["balanced", "min_entropy", "throughput", "min_entropy_rate"])]
         rank_by: String,
 
         /// Include telemetry_v1 start/end environment snapshots in output.
@@ -71,6 +71,11 @@ enum Commands {
         #[arg(long)]
         output: Option<String>,
 
+        /// Rank research/poc collectors alongside the Rust sources, from a
+        /// `poc_bench` JSON report (research/poc: make bench)
+        #[arg(long)]
+        poc_json: Option<String>,
+
         /// Skip conditioned pool output quality section
         #[arg(long)]
         no_pool: bool,
@@ -247,6 +252,12 @@ enum Commands {
         /// Print a telemetry_v1 snapshot at server startup.
         #[arg(long)]
         telemetry: bool,
+
+        /// Also serve the collectors of a running `poc_runner harvest`
+        /// daemon (research/poc) as sources named poc:<name>. Without a
+        /// SOCKET, the daemon's per-user default is used.
+        #[arg(long, value_name = "SOCKET", num_args = 0..=1, default_missing_value = "")]
+        poc_harvest: Option<String>,
     },
 
     /// Capture telemetry_v1 as a standalone snapshot or timed window
@@ -258,6 +269,19 @@ enum Commands {
         /// Write telemetry JSON to path.
         #[arg(long)]
         output: Option<String>,
+
+        /// Merge a poc_hist_v1 report (research/poc, POC_HIST=<path>) as
+        /// `collector` metrics and rank its collectors by p99 round cost.
+        #[arg(long)]
+        poc_hist: Option<String>,
+
+        /// Pool timeout a PoC collector's p99 round must fit in.
+        #[arg(long, default_value = "10")]
+        pool_timeout_sec: f64,
+
+        /// Samples per source in one pool round.
+        #[arg(long, default_value = "1000")]
+        pool_samples: usize,
     },
 }
 
@@ -278,6 +302,7 @@ fn main() {
             rank_by,
             telemetry,
             output,
+            poc_json,
             no_pool,
         } => commands::bench::run(commands::bench::BenchCommandConfig {
             source_filter: sources.as_deref(),
@@ -290,6 +315,7 @@ fn main() {
             timeout_sec,
             rank_by: &rank_by,
             output_path: output.as_deref(),
+            poc_json_path: poc_json.as_deref(),
             include_pool_quality: !no_pool,
             include_telemetry: telemetry,
         }),
@@ -376,9 +402,30 @@ fn main() {
             sources,
             allow_raw,
             telemetry,
-        } => commands::server::run(&host, port, sources.as_deref(), allow_raw, telemetry),
-        Commands::Telemetry { window_sec, output } => {
-            commands::telemetry::run(window_sec, output.as_deref())
+            poc_harvest,
+        } => commands::server::run(
+            &host,
+            port,
+            sources.as_deref(),
+            allow_raw,
+            telemetry,
+            poc_harvest.as_deref(),
+        ),
+        Commands::Telemetry {
+            window_sec,
+            output,
+            poc_hist,
+            pool_timeout_sec,
+            pool_samples,
+        } => {
+            let poc_hist = poc_hist
+                .as_deref()
+                .map(|path| commands::telemetry::PocHistCheck {
+                    path,
+                    pool_timeout_sec,
+                    pool_samples,
+                });
+            commands::telemetry::run(window_sec, output.as_deref(), poc_hist)
         }
     }
 }
@@ -1,6 +1,75 @@
 fn main() {
+    println!("cargo::rustc-check-cfg=cfg(poc_native)");
+
     // Link Accelerate framework on macOS for AMX coprocessor entropy source (cblas_sgemm).
     if std::env::var("CARGO_CFG_TARGET_OS").as_deref() == Ok("macos") {
         println!("cargo:rustc-link-lib=framework=Accelerate");
     }
+
+    #[cfg(feature = "poc-native")]
+    build_poc_native();
+}
+
+/// Compile research/poc/{lib,collectors} into static libraries and link
+/// the frameworks the collector registry needs. The collectors are
+/// macOS-only (mach, IOKit, libcompression), so elsewhere the feature is a
+/// no-op and `poc_native` stays unset.
+#[cfg(feature = "poc-native")]
+fn build_poc_native() {
+    use std::path::{Path, PathBuf};
+
+    if std::env::var("CARGO_CFG_TARGET_OS").as_deref() != Ok("macos") {
+        return;
+    }
+    let poc = Path::new(env!("CARGO_MANIFEST_DIR")).join("../../research/poc");
+
+    let mut c_files: Vec<PathBuf> = Vec::new();
+    let mut m_files: Vec<PathBuf> = Vec::new();
+    for dir in ["lib", "collectors"] {
+        let dir = poc.join(dir);
+        println!("cargo:rerun-if-changed={}", dir.display());
+        let entries = std::fs::read_dir(&dir)
+            .unwrap_or_else(|e| panic!("poc-native: cannot read {}: {e}", dir.display()));
+        for entry in entries.flatten() {
+            let path = entry.path();
+            match path.extension().and_then(|e| e.to_str()) {
+                Some("c") => c_files.push(path),
+                Some("m") => m_files.push(path),
+                _ => {}
+            }
+        }
+    }
+    c_files.sort();
+    m_files.sort();
+
+    cc::Build::new()
+        .include(&poc)
+        .files(&c_files)
+        .opt_level(2)
+        .warnings(false)
+        .compile("poc_collectors");
+    if !m_files.is_empty() {
+        cc::Build::new()
+            .include(&poc)
+            .files(&m_files)
+            .flag("-fobjc-arc")
+            .opt_level(2)
+            .warnings(false)
+            .compile("poc_collectors_objc");
+    }
+
+    for fw in [
+        "CoreFoundation",
+        "CoreServices",
+        "IOKit",
+        "CoreML",
+        "Foundation",
+        "Metal",
+        "Security",
+    ] {
+        println!("cargo:rustc-link-lib=framework={fw}");
+    }
+    println!("cargo:rustc-link-lib=z");
+    println!("cargo:rustc-link-lib=compression");
+    println!("cargo:rustc-cfg=poc_native");
 }
@@ -98,11 +98,7 @@ pub fn sha256_condition_bytes(raw: &[u8], n_output: usize) -> Vec<u8> {
     while output.len() < n_output {
         let end = (offset + 64).min(raw.len());
         let chunk = &raw[offset..end];
-        let mut h = Sha256::new();
-        h.update(state);
-        h.update(chunk);
-        h.update(counter.to_le_bytes());
-        state = h.finalize().into();
+        state = sha256_parts(&[&state, chunk, &counter.to_le_bytes()]);
         output.extend_from_slice(&state);
         offset += 64;
         counter += 1;
@@ -122,20 +118,80 @@ pub fn sha256_condition(
     counter: u64,
     extra: &[u8],
 ) -> ([u8; 32], [u8; 32]) {
-    let mut h = Sha256::new();
-    h.update(state);
-    h.update(sample);
-    h.update(counter.to_le_bytes());
-
     let ts = std::time::SystemTime::now()
         .duration_since(std::time::UNIX_EPOCH)
         .unwrap_or_default();
-    h.update(ts.as_nanos().to_le_bytes());
+    let digest = sha256_parts(&[
+        state,
+        sample,
+        &counter.to_le_bytes(),
+        &ts.as_nanos().to_le_bytes(),
+        extra,
+    ]);
+    (digest, digest)
+}
+
+/// SHA-256 of the concatenation of `parts` — the one hash every
+/// conditioning path goes through.
+///
+/// With `poc-native` on a target whose C kernel uses the ARMv8 SHA-2
+/// instructions (`research/poc/lib/poc_sha256.c`), the digest is computed
+/// there in one FFI call; otherwise by the `sha2` crate. Both produce the
+/// same bytes.
+pub fn sha256_parts(parts: &[&[u8]]) -> [u8; 32] {
+    #[cfg(poc_native)]
+    if let Some(digest) = native_sha256::digest(parts) {
+        return digest;
+    }
+    let mut h = Sha256::new();
+    for part in parts {
+        h.update(part);
+    }
+    h.finalize().into()
+}
 
-    h.update(extra);
+#[cfg(poc_native)]
+mod native_sha256 {
+    use std::ffi::c_int;
 
-    let digest: [u8; 32] = h.finalize().into();
-    (digest, digest)
+    /// Most parts any conditioning call passes; longer lists use `sha2`.
+    const MAX_PARTS: usize = 8;
+
+    #[repr(C)]
+    #[derive(Clone, Copy)]
+    struct PocSha256Part {
+        data: *const u8,
+        len: usize,
+    }
+
+    unsafe extern "C" {
+        fn poc_sha256_hardware() -> c_int;
+        fn poc_sha256_parts(parts: *const PocSha256Part, n: c_int, out: *mut u8);
+    }
+
+    pub(super) fn digest(parts: &[&[u8]]) -> Option<[u8; 32]> {
+        static HARDWARE: std::sync::OnceLock<bool> = std::sync::OnceLock::new();
+        // SAFETY: takes no arguments and reads no state.
+        let hw = *HARDWARE.get_or_init(|| unsafe { poc_sha256_hardware() } != 0);
+        if !hw || parts.len() > MAX_PARTS {
+            return None;
+        }
+        let mut list = [PocSha256Part {
+            data: std::ptr::null(),
+            len: 0,
+        }; MAX_PARTS];
+        for (slot, part) in list.iter_mut().zip(parts) {
+            *slot = PocSha256Part {
+                data: part.as_ptr(),
+                len: part.len(),
+            };
+        }
+        let mut out = [0u8; 32];
+        // SAFETY: the first parts.len() entries point at live slices for
+        // the duration of the call; out has room for the 32-byte digest.
+        unsafe { poc_sha256_parts(list.as_ptr(), parts.len() as c_int, out.as_mut_ptr()) };
+        Some(out)
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -790,6 +846,17 @@ mod tests {
         assert_ne!(out1, out2);
     }
 
+    #[test]
+    fn test_sha256_parts_matches_one_shot() {
+        let data: Vec<u8> = (0..300).map(|i| (i * 7 + 3) as u8).collect();
+        for split in [0, 1, 55, 56, 64, 65, 200, 300] {
+            let (a, b) = data.split_at(split);
+            let expected: [u8; 32] = Sha256::digest(&data).into();
+            assert_eq!(sha256_parts(&[a, b]), expected, "split at {split}");
+            assert_eq!(sha256_parts(&[a, &[], b]), expected, "split at {split}");
+        }
+    }
+
     #[test]
     fn test_sha256_empty_input() {
         let out = sha256_condition_bytes(&[], 32);
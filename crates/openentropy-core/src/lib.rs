@@ -57,14 +57,15 @@ pub use conditioning::{
 pub use platform::{detect_available_sources, platform_info};
 pub use pool::{EntropyPool, HealthReport, SourceHealth, SourceInfoSnapshot};
 pub use session::{
-    MachineInfo, SessionConfig, SessionMeta, SessionSourceAnalysis, SessionWriter,
-    detect_machine_info,
+    MachineInfo, RawCapture, RawCaptureHeader, SessionConfig, SessionMeta, SessionSourceAnalysis,
+    SessionWriter, detect_machine_info,
 };
 pub use source::{EntropySource, Platform, Requirement, SourceCategory, SourceInfo};
 pub use telemetry::{
-    MODEL_ID as TELEMETRY_MODEL_ID, MODEL_VERSION as TELEMETRY_MODEL_VERSION, TelemetryMetric,
-    TelemetryMetricDelta, TelemetrySnapshot, TelemetryWindowReport, build_telemetry_window,
-    collect_telemetry_snapshot, collect_telemetry_window,
+    MODEL_ID as TELEMETRY_MODEL_ID, MODEL_VERSION as TELEMETRY_MODEL_VERSION, POC_HIST_SCHEMA,
+    PocCollectorHistograms, PocHistReport, PocHistogram, TelemetryMetric, TelemetryMetricDelta,
+    TelemetrySnapshot, TelemetryWindowReport, build_telemetry_window, collect_telemetry_snapshot,
+    collect_telemetry_window, load_poc_hist_report, poc_hist_metrics,
 };
 
 /// Library version (from Cargo.toml).
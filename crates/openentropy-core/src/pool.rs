@@ -15,7 +15,7 @@ use std::time::{Duration, Instant};
 
 use sha2::{Digest, Sha256};
 
-use crate::conditioning::{quick_min_entropy, quick_shannon};
+use crate::conditioning::{quick_min_entropy, quick_shannon, sha256_parts};
 use crate::source::{EntropySource, SourceState};
 
 /// Thread-safe multi-source entropy pool.
@@ -332,24 +332,22 @@ impl EntropyPool {
             };
 
             // SHA-256 conditioning
-            let mut h = Sha256::new();
-            let state = self.state.lock().unwrap();
-            h.update(*state);
-            drop(state);
-            h.update(&sample);
-            h.update(cnt.to_le_bytes());
-
+            let state = *self.state.lock().unwrap();
             let ts = std::time::SystemTime::now()
                 .duration_since(std::time::UNIX_EPOCH)
                 .unwrap_or_default();
-            h.update(ts.as_nanos().to_le_bytes());
 
             // Mix in OS entropy as safety net
             let mut os_random = [0u8; 8];
             getrandom(&mut os_random);
-            h.update(os_random);
 
-            let digest: [u8; 32] = h.finalize().into();
+            let digest = sha256_parts(&[
+                &state,
+                &sample,
+                &cnt.to_le_bytes(),
+                &ts.as_nanos().to_le_bytes(),
+                &os_random,
+            ]);
             *self.state.lock().unwrap() = digest;
             output.extend_from_slice(&digest);
         }
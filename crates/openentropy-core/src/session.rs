@@ -13,6 +13,10 @@
 //! - `raw_index.csv` — byte offset index into raw.bin
 //! - `conditioned.bin` — concatenated conditioned bytes
 //! - `conditioned_index.csv` — byte offset index into conditioned.bin
+//!
+//! [`RawCapture`] reads the research harness's raw timing captures
+//! (`*.oeraw`): a 256-byte header followed by little-endian `u64` tick
+//! deltas, memory-mapped so repeated analyses never re-run the collector.
 
 use std::collections::{HashMap, VecDeque};
 use std::fs::{self, File};
@@ -591,6 +595,224 @@ impl Drop for SessionWriter {
     }
 }
 
+// ---------------------------------------------------------------------------
+// Raw timing captures
+// ---------------------------------------------------------------------------
+
+/// Magic bytes at the start of a raw timing capture (`*.oeraw`).
+pub const RAW_CAPTURE_MAGIC: &[u8; 8] = b"OETRAW01";
+
+/// Raw capture format version understood by [`RawCapture`].
+pub const RAW_CAPTURE_VERSION: u32 = 1;
+
+/// Fixed header size; samples start at this offset.
+const RAW_CAPTURE_HEADER_LEN: usize = 256;
+
+/// Header of a raw timing capture written by the research PoC harness
+/// (`research/poc/lib/poc_capture.h`).
+#[derive(Debug, Clone, Serialize)]
+pub struct RawCaptureHeader {
+    pub source: String,
+    /// `mach_timebase_info`: nanoseconds = ticks * numer / denom.
+    pub timebase_numer: u32,
+    pub timebase_denom: u32,
+    /// Samples committed by the writer (those present in the file).
+    pub sample_count: u64,
+    pub created_unix: u64,
+    pub machine: MachineInfo,
+}
+
+enum RawBacking {
+    #[cfg(unix)]
+    Mapped { ptr: *mut libc::c_void, len: usize },
+    // u64 storage keeps the sample region 8-byte aligned.
+    #[cfg(not(unix))]
+    Owned { words: Vec<u64>, len: usize },
+}
+
+// SAFETY: the mapping is owned by this value, read-only (PROT_READ) and
+// never mutated through the pointer, so sharing it across threads is sound.
+unsafe impl Send for RawBacking {}
+unsafe impl Sync for RawBacking {}
+
+/// A raw timing capture opened read-only.
+///
+/// On Unix the file is memory-mapped and [`RawCapture::samples`] points
+/// straight into the mapping, so re-analysing a multi-gigabyte capture costs
+/// no copy and no allocation. Samples a writer appended after `open` are not
+/// visible; reopen to pick them up.
+pub struct RawCapture {
+    header: RawCaptureHeader,
+    backing: RawBacking,
+    n: usize,
+}
+
+impl RawCapture {
+    /// Open and validate a capture file.
+    pub fn open(path: impl AsRef<Path>) -> std::io::Result<Self> {
+        use std::io::{Error, ErrorKind};
+
+        if cfg!(target_endian = "big") {
+            return Err(Error::new(
+                ErrorKind::Unsupported,
+                "raw captures store little-endian samples",
+            ));
+        }
+        let file = File::open(path.as_ref())?;
+        let len = usize::try_from(file.metadata()?.len())
+            .map_err(|_| Error::new(ErrorKind::InvalidData, "capture too large to map"))?;
+        if len < RAW_CAPTURE_HEADER_LEN {
+            return Err(Error::new(
+                ErrorKind::InvalidData,
+                "truncated capture header",
+            ));
+        }
+        let backing = map_capture(&file, len)?;
+        let header = parse_capture_header(&backing.bytes()[..RAW_CAPTURE_HEADER_LEN])?;
+        let present = (len - RAW_CAPTURE_HEADER_LEN) / 8;
+        let n = usize::try_from(header.sample_count)
+            .unwrap_or(usize::MAX)
+            .min(present);
+        Ok(Self { header, backing, n })
+    }
+
+    pub fn header(&self) -> &RawCaptureHeader {
+        &self.header
+    }
+
+    /// Raw collector deltas in timebase ticks, borrowed from the mapping.
+    pub fn samples(&self) -> &[u64] {
+        let bytes =
+            &self.backing.bytes()[RAW_CAPTURE_HEADER_LEN..RAW_CAPTURE_HEADER_LEN + self.n * 8];
+        // SAFETY: the region is in bounds (n <= present samples), 8-byte
+        // aligned (page-aligned mapping or Vec<u64> plus a 256-byte offset),
+        // every bit pattern is a valid u64, and the host is little-endian
+        // (checked in open), matching the on-disk byte order.
+        unsafe { std::slice::from_raw_parts(bytes.as_ptr().cast::<u64>(), self.n) }
+    }
+
+    /// Convert a tick delta to nanoseconds using the capture's timebase.
+    pub fn ticks_to_ns(&self, ticks: u64) -> f64 {
+        ticks as f64 * f64::from(self.header.timebase_numer) / f64::from(self.header.timebase_denom)
+    }
+
+    /// XOR-fold every sample to one byte, the same reduction the PoC
+    /// harness applies (`poc_fold64`), for use with [`crate::analysis`].
+    pub fn fold_bytes(&self) -> Vec<u8> {
+        self.samples()
+            .iter()
+            .map(|&s| {
+                let mut x = s;
+                x ^= x >> 32;
+                x ^= x >> 16;
+                x ^= x >> 8;
+                x as u8
+            })
+            .collect()
+    }
+}
+
+impl RawBacking {
+    fn bytes(&self) -> &[u8] {
+        match self {
+            #[cfg(unix)]
+            RawBacking::Mapped { ptr, len } => {
+                // SAFETY: ptr/len describe a live PROT_READ mapping owned by
+                // this backing and released only in Drop.
+                unsafe { std::slice::from_raw_parts(ptr.cast::<u8>(), *len) }
+            }
+            #[cfg(not(unix))]
+            RawBacking::Owned { words, len } => {
+                // SAFETY: words holds at least len initialised bytes.
+                unsafe { std::slice::from_raw_parts(words.as_ptr().cast::<u8>(), *len) }
+            }
+        }
+    }
+}
+
+impl Drop for RawBacking {
+    fn drop(&mut self) {
+        // The owned fallback frees itself.
+        #[cfg(unix)]
+        {
+            let RawBacking::Mapped { ptr, len } = *self;
+            // SAFETY: ptr was returned by mmap with this len and is unmapped
+            // exactly once.
+            unsafe {
+                libc::munmap(ptr, len);
+            }
+        }
+    }
+}
+
+#[cfg(unix)]
+fn map_capture(file: &File, len: usize) -> std::io::Result<RawBacking> {
+    use std::os::unix::io::AsRawFd;
+
+    // SAFETY: a read-only shared mapping of an open file descriptor; the
+    // result is checked against MAP_FAILED before use.
+    let ptr = unsafe {
+        libc::mmap(
+            std::ptr::null_mut(),
+            len,
+            libc::PROT_READ,
+            libc::MAP_SHARED,
+            file.as_raw_fd(),
+            0,
+        )
+    };
+    if ptr == libc::MAP_FAILED {
+        return Err(std::io::Error::last_os_error());
+    }
+    Ok(RawBacking::Mapped { ptr, len })
+}
+
+#[cfg(not(unix))]
+fn map_capture(file: &File, len: usize) -> std::io::Result<RawBacking> {
+    use std::io::Read;
+
+    let mut words = vec![0u64; len.div_ceil(8)];
+    // SAFETY: the Vec owns words.len() * 8 >= len initialised bytes.
+    let buf = unsafe { std::slice::from_raw_parts_mut(words.as_mut_ptr().cast::<u8>(), len) };
+    (&*file).read_exact(buf)?;
+    Ok(RawBacking::Owned { words, len })
+}
+
+fn parse_capture_header(h: &[u8]) -> std::io::Result<RawCaptureHeader> {
+    let invalid = |msg| std::io::Error::new(std::io::ErrorKind::InvalidData, msg);
+    let u32_at = |off: usize| u32::from_le_bytes(h[off..off + 4].try_into().unwrap());
+    let u64_at = |off: usize| u64::from_le_bytes(h[off..off + 8].try_into().unwrap());
+    let str_at = |off: usize, cap: usize| {
+        let field = &h[off..off + cap];
+        let end = field.iter().position(|&b| b == 0).unwrap_or(cap);
+        String::from_utf8_lossy(&field[..end]).into_owned()
+    };
+
+    if &h[..8] != RAW_CAPTURE_MAGIC {
+        return Err(invalid("not a raw timing capture"));
+    }
+    if u32_at(8) != RAW_CAPTURE_VERSION || u32_at(12) as usize != RAW_CAPTURE_HEADER_LEN {
+        return Err(invalid("unsupported raw capture version"));
+    }
+    let timebase_denom = u32_at(20);
+    if timebase_denom == 0 {
+        return Err(invalid("raw capture has a zero timebase"));
+    }
+    Ok(RawCaptureHeader {
+        source: str_at(48, 64),
+        timebase_numer: u32_at(16),
+        timebase_denom,
+        sample_count: u64_at(24),
+        created_unix: u64_at(32),
+        machine: MachineInfo {
+            os: str_at(192, 64),
+            arch: str_at(112, 16),
+            chip: str_at(128, 64),
+            cores: u32_at(40) as usize,
+        },
+    })
+}
+
 // ---------------------------------------------------------------------------
 // Helpers
 // ---------------------------------------------------------------------------
@@ -1171,4 +1393,87 @@ mod tests {
         assert!(!is_leap(1900));
         assert!(!is_leap(2023));
     }
+
+    // -----------------------------------------------------------------------
+    // Raw capture tests
+    // -----------------------------------------------------------------------
+
+    /// Build a capture the way lib/poc_capture.c lays it out.
+    fn write_raw_capture(path: &Path, source: &str, samples: &[u64], count: u64) {
+        let mut h = vec![0u8; RAW_CAPTURE_HEADER_LEN];
+        h[..8].copy_from_slice(RAW_CAPTURE_MAGIC);
+        h[8..12].copy_from_slice(&RAW_CAPTURE_VERSION.to_le_bytes());
+        h[12..16].copy_from_slice(&(RAW_CAPTURE_HEADER_LEN as u32).to_le_bytes());
+        h[16..20].copy_from_slice(&125u32.to_le_bytes());
+        h[20..24].copy_from_slice(&3u32.to_le_bytes());
+        h[24..32].copy_from_slice(&count.to_le_bytes());
+        h[32..40].copy_from_slice(&1_771_030_200u64.to_le_bytes());
+        h[40..44].copy_from_slice(&10u32.to_le_bytes());
+        h[48..48 + source.len()].copy_from_slice(source.as_bytes());
+        h[112..117].copy_from_slice(b"arm64");
+        h[128..136].copy_from_slice(b"Apple M4");
+        h[192..205].copy_from_slice(b"Darwin 25.0.0");
+        for s in samples {
+            h.extend_from_slice(&s.to_le_bytes());
+        }
+        fs::write(path, h).unwrap();
+    }
+
+    #[test]
+    fn test_raw_capture_roundtrip() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("ioregistry.oeraw");
+        let samples: Vec<u64> = (0..1000u64).map(|i| i * 0x0101_0101 + 7).collect();
+        write_raw_capture(&path, "ioregistry", &samples, samples.len() as u64);
+
+        let cap = RawCapture::open(&path).unwrap();
+        let h = cap.header();
+        assert_eq!(h.source, "ioregistry");
+        assert_eq!((h.timebase_numer, h.timebase_denom), (125, 3));
+        assert_eq!(h.sample_count, 1000);
+        assert_eq!(h.machine.arch, "arm64");
+        assert_eq!(h.machine.chip, "Apple M4");
+        assert_eq!(h.machine.os, "Darwin 25.0.0");
+        assert_eq!(h.machine.cores, 10);
+        assert_eq!(cap.samples(), samples.as_slice());
+        assert!((cap.ticks_to_ns(24) - 1000.0).abs() < 1e-9);
+    }
+
+    #[test]
+    fn test_raw_capture_ignores_uncommitted_tail() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("tail.oeraw");
+        write_raw_capture(&path, "tail", &[1, 2, 3, 4, 5], 3);
+        let cap = RawCapture::open(&path).unwrap();
+        assert_eq!(cap.samples(), &[1, 2, 3]);
+
+        // A count ahead of the data (torn append) is clamped to what exists.
+        write_raw_capture(&path, "tail", &[1, 2], 9);
+        let cap = RawCapture::open(&path).unwrap();
+        assert_eq!(cap.samples(), &[1, 2]);
+    }
+
+    #[test]
+    fn test_raw_capture_fold_bytes() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("fold.oeraw");
+        write_raw_capture(&path, "fold", &[0x0102_0304_0506_0708, 0xff], 2);
+        let cap = RawCapture::open(&path).unwrap();
+        assert_eq!(cap.fold_bytes(), vec![0x08, 0xff]);
+    }
+
+    #[test]
+    fn test_raw_capture_rejects_bad_header() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("bad.oeraw");
+        fs::write(&path, [0u8; 16]).unwrap();
+        assert!(RawCapture::open(&path).is_err());
+
+        write_raw_capture(&path, "bad", &[1], 1);
+        let mut bytes = fs::read(&path).unwrap();
+        bytes[0] = b'X';
+        fs::write(&path, bytes).unwrap();
+        let err = RawCapture::open(&path).err().unwrap();
+        assert_eq!(err.kind(), std::io::ErrorKind::InvalidData);
+    }
 }
@@ -0,0 +1,290 @@
+//! research/poc collectors served by a running `poc_runner harvest` daemon.
+//!
+//! The daemon (`research/poc/lib/poc_harvest.h`) keeps the selected C
+//! collectors running and buffers their raw samples in one ring each. A
+//! [`HarvestSource`] is one of those collectors as a pool source named
+//! `poc:<name>`. It pulls samples over the daemon's Unix socket when the
+//! pool collects and reduces them the same way the
+//! [`poc-native`](super::native) sources do. The daemon stops collecting
+//! while a ring is full, so a pool that is not collecting holds the daemon
+//! back instead of making it drop samples. A new frontier collector can
+//! therefore run under production load before it has a Rust port.
+//!
+//! The daemon's socket is private to its user: [`default_socket`] is in a
+//! per-user directory, and a connection is dropped unless the daemon runs
+//! as the same user as this process.
+
+use std::io::{self, BufRead, BufReader, Read, Write};
+use std::os::unix::io::AsRawFd;
+use std::os::unix::net::UnixStream;
+use std::path::{Path, PathBuf};
+use std::sync::Mutex;
+use std::time::Duration;
+
+use crate::source::{EntropySource, Platform, SourceCategory, SourceInfo};
+use crate::sources::helpers::extract_timing_entropy;
+
+/// File name of the daemon's socket inside its per-user directory
+/// (`POC_HARVEST_SOCKET_NAME`).
+const SOCKET_NAME: &str = "openentropy-poc.sock";
+
+/// Where `poc_runner harvest` listens unless given `-s`, by the same rule
+/// as `poc_harvest_default_socket`: `$XDG_RUNTIME_DIR`, else the Darwin
+/// per-user temp dir, else `/tmp/openentropy-poc-<uid>/`.
+pub fn default_socket() -> PathBuf {
+    if let Some(dir) = std::env::var_os("XDG_RUNTIME_DIR").filter(|d| !d.is_empty()) {
+        return Path::new(&dir).join(SOCKET_NAME);
+    }
+    #[cfg(target_os = "macos")]
+    if let Some(dir) = darwin_user_temp_dir() {
+        return dir.join(SOCKET_NAME);
+    }
+    // SAFETY: geteuid has no preconditions.
+    let uid = unsafe { libc::geteuid() };
+    PathBuf::from(format!("/tmp/openentropy-poc-{uid}")).join(SOCKET_NAME)
+}
+
+#[cfg(target_os = "macos")]
+fn darwin_user_temp_dir() -> Option<PathBuf> {
+    use std::os::unix::ffi::OsStrExt;
+    let mut buf = vec![0u8; 1024];
+    // SAFETY: buf is writable for its length; confstr NUL-terminates.
+    let n = unsafe {
+        libc::confstr(
+            libc::_CS_DARWIN_USER_TEMP_DIR,
+            buf.as_mut_ptr().cast(),
+            buf.len(),
+        )
+    };
+    if n == 0 || n > buf.len() {
+        return None;
+    }
+    buf.truncate(n - 1);
+    Some(PathBuf::from(std::ffi::OsStr::from_bytes(&buf)))
+}
+
+/// The uid of the process at the other end of `stream`.
+fn peer_uid(stream: &UnixStream) -> io::Result<libc::uid_t> {
+    let fd = stream.as_raw_fd();
+    #[cfg(any(target_os = "linux", target_os = "android"))]
+    {
+        let mut cred = libc::ucred {
+            pid: 0,
+            uid: 0,
+            gid: 0,
+        };
+        let mut len = std::mem::size_of::<libc::ucred>() as libc::socklen_t;
+        // SAFETY: cred and len are valid for writes of the sizes passed.
+        let rc = unsafe {
+            libc::getsockopt(
+                fd,
+                libc::SOL_SOCKET,
+                libc::SO_PEERCRED,
+                (&mut cred as *mut libc::ucred).cast(),
+                &mut len,
+            )
+        };
+        if rc != 0 {
+            return Err(io::Error::last_os_error());
+        }
+        Ok(cred.uid)
+    }
+    #[cfg(not(any(target_os = "linux", target_os = "android")))]
+    {
+        let (mut uid, mut gid) = (0, 0);
+        // SAFETY: uid and gid are valid for writes.
+        if unsafe { libc::getpeereid(fd, &mut uid, &mut gid) } != 0 {
+            return Err(io::Error::last_os_error());
+        }
+        Ok(uid)
+    }
+}
+
+/// Largest READ the daemon answers (`POC_HARVEST_MAX_READ`).
+const MAX_READ: usize = 1 << 20;
+
+const IO_TIMEOUT: Duration = Duration::from_secs(2);
+
+fn connect(socket: &Path) -> io::Result<BufReader<UnixStream>> {
+    let stream = UnixStream::connect(socket)?;
+    // SAFETY: geteuid has no preconditions.
+    if peer_uid(&stream)? != unsafe { libc::geteuid() } {
+        return Err(io::Error::new(
+            io::ErrorKind::PermissionDenied,
+            "harvest daemon runs as another user",
+        ));
+    }
+    stream.set_read_timeout(Some(IO_TIMEOUT))?;
+    stream.set_write_timeout(Some(IO_TIMEOUT))?;
+    Ok(BufReader::new(stream))
+}
+
+/// Names of the collectors the daemon at `socket` is running.
+pub fn list_collectors(socket: &Path) -> io::Result<Vec<String>> {
+    let mut conn = connect(socket)?;
+    conn.get_mut().write_all(b"LIST\n")?;
+    let mut line = String::new();
+    conn.read_line(&mut line)?;
+    let names = line
+        .trim_end()
+        .strip_prefix("OK")
+        .ok_or_else(|| io::Error::new(io::ErrorKind::InvalidData, "bad LIST reply"))?;
+    Ok(names.split_whitespace().map(String::from).collect())
+}
+
+/// One [`HarvestSource`] per collector the daemon at `socket` is running.
+pub fn harvest_sources(socket: &Path) -> io::Result<Vec<HarvestSource>> {
+    Ok(list_collectors(socket)?
+        .iter()
+        .map(|name| HarvestSource::new(socket, name))
+        .collect())
+}
+
+/// Up to `n` raw samples of `collector`; fewer when the daemon's ring did
+/// not fill in time.
+fn read_samples(
+    conn: &mut BufReader<UnixStream>,
+    collector: &str,
+    n: usize,
+) -> io::Result<Vec<u64>> {
+    conn.get_mut()
+        .write_all(format!("READ {collector} {n}\n").as_bytes())?;
+    let mut count = [0u8; 4];
+    conn.read_exact(&mut count)?;
+    let k = u32::from_ne_bytes(count) as usize;
+    if k > n {
+        return Err(io::Error::new(
+            io::ErrorKind::InvalidData,
+            "READ reply longer than asked",
+        ));
+    }
+    let mut bytes = vec![0u8; k * 8];
+    conn.read_exact(&mut bytes)?;
+    Ok(bytes
+        .chunks_exact(8)
+        .map(|c| u64::from_ne_bytes(c.try_into().expect("8-byte chunk")))
+        .collect())
+}
+
+/// A collector running in a `poc_runner harvest` daemon.
+pub struct HarvestSource {
+    info: SourceInfo,
+    collector: String,
+    socket: PathBuf,
+    // Reconnected on the next collection after any I/O error.
+    conn: Mutex<Option<BufReader<UnixStream>>>,
+}
+
+impl HarvestSource {
+    pub fn new(socket: &Path, collector: &str) -> Self {
+        // SourceInfo holds &'static strs. Harvest sources are made once,
+        // when the server starts, so leaking their few strings is bounded.
+        let leak = |s: String| -> &'static str { Box::leak(s.into_boxed_str()) };
+        let info = SourceInfo {
+            name: leak(format!("poc:{collector}")),
+            description: leak(format!(
+                "research/poc collector {collector}, served by poc_runner harvest"
+            )),
+            physics: leak(format!(
+                "Raw samples of research/poc/collectors' {collector} collector, \
+                 buffered by a local poc_runner harvest daemon; see that \
+                 collector's header comment for the mechanism."
+            )),
+            category: SourceCategory::Timing,
+            platform: Platform::Any,
+            requirements: &[],
+            entropy_rate_estimate: 1.0,
+            composite: false,
+        };
+        Self {
+            info,
+            collector: collector.to_string(),
+            socket: socket.to_path_buf(),
+            conn: Mutex::new(None),
+        }
+    }
+
+    fn read_raw(&self, n: usize) -> Option<Vec<u64>> {
+        let mut conn = self.conn.lock().unwrap_or_else(|e| e.into_inner());
+        if conn.is_none() {
+            *conn = connect(&self.socket).ok();
+        }
+        match read_samples(conn.as_mut()?, &self.collector, n) {
+            Ok(raw) => Some(raw),
+            Err(_) => {
+                *conn = None;
+                None
+            }
+        }
+    }
+}
+
+impl EntropySource for HarvestSource {
+    fn info(&self) -> &SourceInfo {
+        &self.info
+    }
+
+    fn is_available(&self) -> bool {
+        connect(&self.socket).is_ok()
+    }
+
+    fn collect(&self, n_samples: usize) -> Vec<u8> {
+        let want = (n_samples + 2).min(MAX_READ);
+        self.read_raw(want)
+            .map(|raw| extract_timing_entropy(&raw, n_samples))
+            .unwrap_or_default()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::os::unix::net::UnixListener;
+
+    // Answers LIST with one collector and every READ with 0, 1, 2, ...
+    fn fake_daemon(path: &Path) -> std::thread::JoinHandle<()> {
+        let listener = UnixListener::bind(path).unwrap();
+        std::thread::spawn(move || {
+            for stream in listener.incoming().take(2) {
+                let stream = stream.unwrap();
+                let mut out = stream.try_clone().unwrap();
+                for line in BufReader::new(stream).lines() {
+                    let line = line.unwrap();
+                    if line == "LIST" {
+                        out.write_all(b"OK fake\n").unwrap();
+                    } else if let Some(n) = line.strip_prefix("READ fake ") {
+                        let n: u32 = n.parse().unwrap();
+                        out.write_all(&n.to_ne_bytes()).unwrap();
+                        for i in 0..u64::from(n) {
+                            out.write_all(&(i * i).to_ne_bytes()).unwrap();
+                        }
+                    }
+                }
+            }
+        })
+    }
+
+    #[test]
+    fn default_socket_is_per_user() {
+        let path = default_socket();
+        assert!(path.ends_with(SOCKET_NAME));
+        assert_ne!(path, Path::new("/tmp").join(SOCKET_NAME));
+    }
+
+    #[test]
+    fn harvested_samples_fold_like_native_sources() {
+        let path = std::env::temp_dir().join(format!("oe-harvest-{}.sock", std::process::id()));
+        let _ = std::fs::remove_file(&path);
+        let daemon = fake_daemon(&path);
+
+        let sources = harvest_sources(&path).unwrap();
+        assert_eq!(sources.len(), 1);
+        assert_eq!(sources[0].name(), "poc:fake");
+        let raw: Vec<u64> = (0..66u64).map(|i| i * i).collect();
+        assert_eq!(sources[0].collect(64), extract_timing_entropy(&raw, 64));
+
+        drop(sources);
+        daemon.join().unwrap();
+        let _ = std::fs::remove_file(&path);
+    }
+}
@@ -20,7 +20,9 @@
 //! ├── keychain_timing.rs  ← Keychain/securityd round-trip timing
 //! ├── counter_beat.rs     ← Two-oscillator beat frequency: CPU counter vs audio PLL
 //! ├── display_pll.rs      ← Display PLL phase noise from pixel clock domain crossing
-//! └── pcie_pll.rs         ← PCIe PHY PLL jitter from IOKit clock domain crossings
+//! ├── pcie_pll.rs         ← PCIe PHY PLL jitter from IOKit clock domain crossings
+//! ├── native.rs           ← research/poc C collectors via FFI (`poc-native`, macOS)
+//! └── harvest.rs          ← research/poc collectors served by `poc_runner harvest`
 //! ```
 //!
 //! Each source measures a single, independent physical entropy domain.
@@ -57,6 +59,14 @@ mod thread_lifecycle;
 mod tlb_shootdown;
 mod usb_timing;
 
+// C twins of the sources above, linked by build.rs under `poc-native`.
+#[cfg(poc_native)]
+pub mod native;
+
+// C collectors running in a `poc_runner harvest` daemon, read over its socket.
+#[cfg(unix)]
+pub mod harvest;
+
 // Re-export all source structs and their configs.
 pub use amx_timing::{AMXTimingConfig, AMXTimingSource};
 pub use audio_pll_timing::AudioPLLTimingSource;
@@ -0,0 +1,233 @@
+//! Native C collectors — the research/poc implementations behind existing
+//! source names.
+//!
+//! With the `poc-native` feature on macOS, `build.rs` compiles
+//! `research/poc/{lib,collectors}` into a static library and
+//! [`replace_with_native`] swaps every source in [`NATIVE_SOURCES`] for a
+//! [`NativeSource`] that keeps the Rust source's metadata but collects
+//! through the C collector of the same name. One implementation serves the
+//! research harness (`validate_*`, `poc_bench`) and production.
+//!
+//! The C side fills a caller buffer (`poc_ffi_collect`), so a collection
+//! reuses one scratch buffer per source and allocates only the returned
+//! bytes. The collectors keep their state in C statics shared by every
+//! collector of one object file; `poc_ffi_collect` serializes calls within
+//! such a group, parameter writes included, so sources may collect from
+//! any thread. Parameters are process-wide C globals: the last
+//! [`NativeSource`] to collect a collector leaves its values in force for
+//! every other user of that collector in the process.
+
+use std::ffi::{CString, c_char, c_int};
+use std::sync::Mutex;
+
+use crate::source::{EntropySource, SourceInfo};
+use crate::sources::helpers::xor_fold_u64;
+
+/// Frontier sources whose C collector is registered under the same name
+/// and measures the same mechanism.
+pub const NATIVE_SOURCES: &[&str] = &[
+    "cas_contention",
+    "dvfs_race",
+    "kqueue_events",
+    "mach_ipc",
+    "pipe_buffer",
+    "thread_lifecycle",
+    "tlb_shootdown",
+];
+
+#[repr(C)]
+struct PocFfiParam {
+    name: *const c_char,
+    value: i32,
+}
+
+#[repr(C)]
+struct PocFfiParams {
+    count: i32,
+    items: *const PocFfiParam,
+}
+
+unsafe extern "C" {
+    fn poc_ffi_find(name: *const c_char) -> c_int;
+    fn poc_ffi_collect(
+        index: c_int,
+        out: *mut u64,
+        n: c_int,
+        params: *const PocFfiParams,
+    ) -> c_int;
+}
+
+/// A registry C collector wearing a Rust source's [`SourceInfo`].
+pub struct NativeSource {
+    inner: Box<dyn EntropySource>,
+    index: c_int,
+    // `items` points into `names`; both are fixed after construction.
+    names: Vec<CString>,
+    items: Vec<PocFfiParam>,
+    scratch: Mutex<Vec<u64>>,
+}
+
+// SAFETY: the raw pointers in `items` only reference the CStrings owned by
+// `names`, which are never mutated or dropped before `self`. The C state a
+// collection touches is guarded by `poc_ffi_collect`'s per-group mutex.
+unsafe impl Send for NativeSource {}
+unsafe impl Sync for NativeSource {}
+
+impl NativeSource {
+    /// Wrap `inner` when a C collector with its name is linked in;
+    /// otherwise hand `inner` back unchanged.
+    pub fn wrap(inner: Box<dyn EntropySource>) -> Result<Self, Box<dyn EntropySource>> {
+        Self::with_params(inner, &[])
+    }
+
+    /// Like [`wrap`](Self::wrap), setting the collector's registry
+    /// tunables (`collectors/registry.c`, e.g. `("threads", 2)` for
+    /// `cas_contention`) before every collection. The tunables are
+    /// process-wide, so they also apply to other wrappers of the same
+    /// collector until those set their own. Unknown names make the C call
+    /// fail, so they are rejected here.
+    pub fn with_params(
+        inner: Box<dyn EntropySource>,
+        params: &[(&str, i32)],
+    ) -> Result<Self, Box<dyn EntropySource>> {
+        let Ok(cname) = CString::new(inner.name()) else {
+            return Err(inner);
+        };
+        // SAFETY: cname is a valid NUL-terminated string for the call.
+        let index = unsafe { poc_ffi_find(cname.as_ptr()) };
+        if index < 0 {
+            return Err(inner);
+        }
+        let mut names = Vec::with_capacity(params.len());
+        for (name, _) in params {
+            match CString::new(*name) {
+                Ok(c) => names.push(c),
+                Err(_) => return Err(inner),
+            }
+        }
+        let items = names
+            .iter()
+            .zip(params)
+            .map(|(c, &(_, value))| PocFfiParam {
+                name: c.as_ptr(),
+                value,
+            })
+            .collect();
+        let source = Self {
+            inner,
+            index,
+            names,
+            items,
+            scratch: Mutex::new(Vec::new()),
+        };
+        // One probe call validates the parameter names.
+        if !source.items.is_empty() && source.with_raw(8, |_| ()).is_none() {
+            return Err(source.inner);
+        }
+        Ok(source)
+    }
+
+    /// Collect `n` raw C samples into the scratch buffer and run `f` on
+    /// the valid prefix. None when the C call rejects the index, count or
+    /// a parameter name.
+    fn with_raw<R>(&self, n: usize, f: impl FnOnce(&[u64]) -> R) -> Option<R> {
+        let n_c = c_int::try_from(n).ok()?;
+        let mut buf = self.scratch.lock().unwrap_or_else(|e| e.into_inner());
+        if buf.len() < n {
+            buf.resize(n, 0);
+        }
+        let params = PocFfiParams {
+            count: self.items.len() as i32,
+            items: self.items.as_ptr(),
+        };
+        debug_assert_eq!(self.names.len(), self.items.len());
+        // SAFETY: buf holds at least n u64s; params and its items point at
+        // memory owned by self for the duration of the call.
+        let got = unsafe { poc_ffi_collect(self.index, buf.as_mut_ptr(), n_c, &params) };
+        if got < 0 {
+            return None;
+        }
+        Some(f(&buf[..(got as usize).min(n)]))
+    }
+}
+
+/// [`extract_timing_entropy`](crate::sources::helpers::extract_timing_entropy)
+/// without the intermediate delta vectors: consecutive deltas, adjacent
+/// deltas XORed, each folded to a byte.
+fn fold_durations(raw: &[u64], n_samples: usize) -> Vec<u8> {
+    let mut out = Vec::with_capacity(n_samples.min(raw.len().saturating_sub(2)));
+    for w in raw.windows(3).take(n_samples) {
+        let d0 = w[1].wrapping_sub(w[0]);
+        let d1 = w[2].wrapping_sub(w[1]);
+        out.push(xor_fold_u64(d0 ^ d1));
+    }
+    out
+}
+
+impl EntropySource for NativeSource {
+    fn info(&self) -> &SourceInfo {
+        self.inner.info()
+    }
+
+    fn is_available(&self) -> bool {
+        self.inner.is_available()
+    }
+
+    fn collect(&self, n_samples: usize) -> Vec<u8> {
+        self.with_raw(n_samples + 2, |raw| fold_durations(raw, n_samples))
+            .unwrap_or_default()
+    }
+}
+
+/// Replace each source named in [`NATIVE_SOURCES`] with its [`NativeSource`].
+/// Sources whose C collector is missing stay as they are.
+pub fn replace_with_native(sources: Vec<Box<dyn EntropySource>>) -> Vec<Box<dyn EntropySource>> {
+    sources
+        .into_iter()
+        .map(|s| {
+            if !NATIVE_SOURCES.contains(&s.name()) {
+                return s;
+            }
+            match NativeSource::wrap(s) {
+                Ok(native) => Box::new(native) as Box<dyn EntropySource>,
+                Err(s) => s,
+            }
+        })
+        .collect()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::sources::frontier::ThreadLifecycleSource;
+    use crate::sources::helpers::extract_timing_entropy;
+
+    #[test]
+    fn fold_matches_extract_timing_entropy() {
+        let raw: Vec<u64> = (0..100u64).map(|i| i * i * 37 + (i ^ 0x5a)).collect();
+        assert_eq!(fold_durations(&raw, 64), extract_timing_entropy(&raw, 64));
+        assert_eq!(fold_durations(&raw, 1000), extract_timing_entropy(&raw, 1000));
+        assert!(fold_durations(&raw[..2], 8).is_empty());
+    }
+
+    #[test]
+    fn native_keeps_rust_metadata() {
+        let native = NativeSource::wrap(Box::new(ThreadLifecycleSource))
+            .unwrap_or_else(|_| panic!("thread_lifecycle C collector not linked"));
+        assert_eq!(native.name(), "thread_lifecycle");
+    }
+
+    #[test]
+    fn unknown_param_is_rejected() {
+        assert!(NativeSource::with_params(Box::new(ThreadLifecycleSource), &[("nope", 1)]).is_err());
+    }
+
+    #[test]
+    #[ignore] // Spawns threads
+    fn collects_bytes() {
+        let native = NativeSource::with_params(Box::new(ThreadLifecycleSource), &[("max_work", 50)])
+            .unwrap_or_else(|_| panic!("thread_lifecycle C collector not linked"));
+        let data = native.collect(64);
+        assert_eq!(data.len(), 64);
+    }
+}
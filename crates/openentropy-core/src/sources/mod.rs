@@ -35,7 +35,7 @@ use crate::source::EntropySource;
 
 /// All entropy source constructors. Each returns a boxed source.
 pub fn all_sources() -> Vec<Box<dyn EntropySource>> {
-    vec![
+    let sources: Vec<Box<dyn EntropySource>> = vec![
         // Timing
         Box::new(timing::ClockJitterSource),
         Box::new(timing::MachTimingSource),
@@ -97,5 +97,11 @@ pub fn all_sources() -> Vec<Box<dyn EntropySource>> {
         // Frontier: independent oscillator/PLL sources (2026-02-15)
         Box::new(frontier::DisplayPllSource),
         Box::new(frontier::PciePllSource),
-    ]
+    ];
+
+    // With `poc-native`, frontier sources that have a C twin collect through it.
+    #[cfg(poc_native)]
+    let sources = frontier::native::replace_with_native(sources);
+
+    sources
 }
@@ -9,7 +9,6 @@ use serde::{Deserialize, Serialize};
 use std::collections::HashMap;
 #[cfg(target_os = "macos")]
 use std::io::Read;
-#[cfg(target_os = "linux")]
 use std::path::Path;
 #[cfg(target_os = "macos")]
 use std::process::Stdio;
@@ -1682,6 +1681,101 @@ pub fn collect_telemetry_window(start: TelemetrySnapshot) -> TelemetryWindowRepo
     build_telemetry_window(start, end)
 }
 
+/// Schema of the per-collector histogram report the research PoCs write
+/// under `POC_HIST=<path>` (`research/poc/collectors/hist.c`).
+pub const POC_HIST_SCHEMA: &str = "poc_hist_v1";
+
+/// One HDR-style log-linear histogram from a `poc_hist_v1` report.
+/// Quantiles are the highest value of their bucket, capped at `max`.
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct PocHistogram {
+    pub count: u64,
+    pub min: f64,
+    pub max: f64,
+    pub mean: f64,
+    pub p50: f64,
+    pub p90: f64,
+    pub p99: f64,
+    pub p999: f64,
+    /// `[lower bound, count]` for every nonempty bucket.
+    #[serde(default)]
+    pub buckets: Vec<(f64, u64)>,
+}
+
+/// Call cost and sample distribution of one C collector.
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct PocCollectorHistograms {
+    pub name: String,
+    pub calls: u64,
+    #[serde(default)]
+    pub failed_calls: u64,
+    /// Wall time of each collector call.
+    pub call_ns: PocHistogram,
+    /// Call time divided by the samples it returned.
+    pub sample_ns: PocHistogram,
+    /// Raw sample values, in timebase ticks.
+    pub value_ticks: PocHistogram,
+}
+
+/// A `poc_hist_v1` report.
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct PocHistReport {
+    pub schema: String,
+    pub generated_unix: u64,
+    pub ns_per_tick: f64,
+    pub sub_bucket_bits: u32,
+    pub collectors: Vec<PocCollectorHistograms>,
+}
+
+impl PocCollectorHistograms {
+    /// p99 cost of collecting `n_samples` in one call, from the per-sample
+    /// histogram: what one pool round of this collector is likely to cost.
+    pub fn projected_p99_secs(&self, n_samples: usize) -> f64 {
+        self.sample_ns.p99 * n_samples as f64 / 1e9
+    }
+}
+
+/// Read a `poc_hist_v1` report.
+pub fn load_poc_hist_report(path: &Path) -> Result<PocHistReport, String> {
+    let text = std::fs::read_to_string(path).map_err(|e| format!("{}: {e}", path.display()))?;
+    let report: PocHistReport =
+        serde_json::from_str(&text).map_err(|e| format!("{}: {e}", path.display()))?;
+    if report.schema != POC_HIST_SCHEMA {
+        return Err(format!(
+            "{}: unsupported schema '{}' (expected {POC_HIST_SCHEMA})",
+            path.display(),
+            report.schema
+        ));
+    }
+    Ok(report)
+}
+
+/// Flatten a histogram report into `collector`-domain telemetry metrics:
+/// call counts, call-cost and per-sample-cost quantiles, and sample value
+/// quantiles, named `<collector>.<metric>`.
+pub fn poc_hist_metrics(report: &PocHistReport) -> Vec<TelemetryMetric> {
+    let mut out = Vec::new();
+    for c in &report.collectors {
+        let rows = [
+            ("calls", c.calls as f64, "count"),
+            ("failed_calls", c.failed_calls as f64, "count"),
+            ("call_p50", c.call_ns.p50 / 1000.0, "us"),
+            ("call_p99", c.call_ns.p99 / 1000.0, "us"),
+            ("call_p999", c.call_ns.p999 / 1000.0, "us"),
+            ("call_max", c.call_ns.max / 1000.0, "us"),
+            ("sample_p50", c.sample_ns.p50, "ns"),
+            ("sample_p99", c.sample_ns.p99, "ns"),
+            ("value_p50", c.value_ticks.p50, "ticks"),
+            ("value_p99", c.value_ticks.p99, "ticks"),
+        ];
+        for (metric, value, unit) in rows {
+            let name = format!("{}.{metric}", c.name);
+            push_metric(&mut out, "collector", name, value, unit, "poc_hist");
+        }
+    }
+    out
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -1695,6 +1789,33 @@ mod tests {
         assert!(s.cpu_count >= 1);
     }
 
+    #[test]
+    fn poc_hist_report_flattens_to_metrics() {
+        let hist = r#"{"count": 10, "min": 100.0, "max": 900.0, "mean": 200.0, "p50": 150.0,
+            "p90": 300.0, "p99": 800.0, "p999": 900.0, "buckets": [[96.0, 9], [896.0, 1]]}"#;
+        let json = format!(
+            r#"{{"schema": "poc_hist_v1", "generated_unix": 1, "ns_per_tick": 41.6667,
+                "sub_bucket_bits": 5, "collectors": [{{"name": "tlb_shootdown", "calls": 10,
+                "failed_calls": 0, "call_ns": {hist}, "sample_ns": {hist},
+                "value_ticks": {hist}}}]}}"#
+        );
+        let report: PocHistReport = serde_json::from_str(&json).unwrap();
+        assert_eq!(
+            report.collectors[0].call_ns.buckets,
+            vec![(96.0, 9), (896.0, 1)]
+        );
+        let metrics = poc_hist_metrics(&report);
+        let p99 = metrics
+            .iter()
+            .find(|m| m.name == "tlb_shootdown.call_p99")
+            .unwrap();
+        assert_eq!(p99.domain, "collector");
+        assert_eq!(p99.unit, "us");
+        assert!((p99.value - 0.8).abs() < 1e-9);
+        let projected = report.collectors[0].projected_p99_secs(1000);
+        assert!((projected - 800e-6).abs() < 1e-12);
+    }
+
     #[test]
     fn window_delta_aligns_metrics() {
         let start = TelemetrySnapshot {
@@ -13,21 +13,9 @@
 #include <pthread.h>
 #include <sys/sysctl.h>
 
-#define N_SAMPLES 20000
-
-static inline uint64_t read_cntvct(void) {
-    uint64_t val;
-    __asm__ volatile("mrs %0, CNTVCT_EL0" : "=r"(val));
-    return val;
-}
+#include "lib/poc_time.h"
 
-static inline uint64_t read_cntpct(void) {
-    uint64_t val;
-    // On macOS, CNTPCT_EL0 may trap. Use CNTVCT_EL0 as primary.
-    // mach_absolute_time reads the same counter but through Mach.
-    __asm__ volatile("mrs %0, CNTVCT_EL0" : "=r"(val));
-    return val;
-}
+#define N_SAMPLES 20000
 
 static inline void isb(void) {
     __asm__ volatile("isb" ::: "memory");
@@ -53,9 +41,9 @@ int main(void) {
     {
         uint64_t timings[N_SAMPLES];
         for (int i = 0; i < N_SAMPLES; i++) {
-            uint64_t t0 = read_cntvct();
+            uint64_t t0 = poc_ts_cntvct();
             isb();
-            uint64_t t1 = read_cntvct();
+            uint64_t t1 = poc_ts_cntvct();
             timings[i] = t1 - t0;
         }
 
@@ -122,9 +110,9 @@ int main(void) {
                     break;
             }
 
-            uint64_t t0 = read_cntvct();
+            uint64_t t0 = poc_ts_cntvct();
             isb();
-            uint64_t t1 = read_cntvct();
+            uint64_t t1 = poc_ts_cntvct();
             timings[i] = t1 - t0;
         }
 
@@ -165,9 +153,9 @@ int main(void) {
             // Create some dirty cache lines
             array[i % 1024] = (uint64_t)i * 0xdeadbeef;
 
-            uint64_t t0 = read_cntvct();
+            uint64_t t0 = poc_ts_cntvct();
             dsb();
-            uint64_t t1 = read_cntvct();
+            uint64_t t1 = poc_ts_cntvct();
             timings[i] = t1 - t0;
         }
 
@@ -222,7 +210,7 @@ int main(void) {
     {
         uint64_t diffs[N_SAMPLES];
         for (int i = 0; i < N_SAMPLES; i++) {
-            uint64_t mrs_val = read_cntvct();
+            uint64_t mrs_val = poc_ts_cntvct();
             uint64_t mach_val = mach_absolute_time();
             diffs[i] = mach_val - mrs_val;  // should be small positive
         }
@@ -262,9 +250,9 @@ int main(void) {
     {
         uint64_t timings[N_SAMPLES];
         for (int i = 0; i < N_SAMPLES; i++) {
-            uint64_t t0 = read_cntvct();
+            uint64_t t0 = poc_ts_cntvct();
             sched_yield();
-            uint64_t t1 = read_cntvct();
+            uint64_t t1 = poc_ts_cntvct();
             timings[i] = t1 - t0;
         }
 
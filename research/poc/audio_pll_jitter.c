@@ -3,18 +3,55 @@
 // This PLL is an independent oscillator from the CPU clock.
 // By reading the audio device's host time rapidly, we capture PLL phase jitter.
 // This is NOT recording audio — it's probing the audio clock domain.
+//
+//   ./audio_pll_jitter            Method 1 times HAL property round trips
+//   ./audio_pll_jitter --stamps   Method 1 instead takes host/sample time
+//                                 pairs from an IOProc (lib/poc_audioclock.h)
+//                                 and analyses the PLL phase error between
+//                                 consecutive pairs; Method 1b shows the
+//                                 HAL-interpolated AudioDeviceGetCurrentTime
+//                                 pairs for comparison
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <math.h>
 #include <mach/mach_time.h>
 #include <CoreAudio/CoreAudio.h>
 #include <AudioToolbox/AudioToolbox.h>
 
+#include "lib/poc_audioclock.h"
+#include "lib/poc_stats.h"
+
 #define N_SAMPLES 20000
+#define N_IOPROC_STAMPS 4000
+#define IOPROC_TIMEOUT_S 15.0
+
+// Fill timings[] with the phase error between consecutive stamps, shifted so
+// the smallest error is 0, and print its spread and XOR-fold H∞. Returns
+// the count.
+static int stamps_to_timings(const PocAudioStamp *s, int n, uint64_t *timings) {
+    int64_t *err = malloc((size_t)(n > 1 ? n : 2) * sizeof(int64_t));
+    if (!err) return 0;
+    double tps = 0;
+    int m = poc_audioclock_phase_error(s, n, err, &tps);
+    int64_t lo = 0;
+    for (int i = 0; i < m; i++)
+        if (i == 0 || err[i] < lo) lo = err[i];
+    for (int i = 0; i < m; i++) timings[i] = (uint64_t)(err[i] - lo);
+    free(err);
+    if (m > 0) {
+        Stats st = compute_stats(timings, m);
+        printf("  %d pairs, %.4f ticks/sample fitted, phase error σ %.1f ticks, "
+               "XOR-folded H∞=%.3f\n", n, tps, st.stddev, st.min_entropy);
+    }
+    return m;
+}
+
+int main(int argc, char **argv) {
+    int stamps = argc > 1 && strcmp(argv[1], "--stamps") == 0;
 
-int main(void) {
     printf("# Audio PLL Clock Jitter Probe\n");
     printf("# Measuring audio clock vs system clock drift/jitter...\n\n");
 
@@ -75,14 +112,43 @@ int main(void) {
     // METHOD 1: Rapidly read the device's current time and measure host-time jitter
     // AudioDeviceGetCurrentTime gives us the relationship between audio time and host time
     uint64_t timings[N_SAMPLES];
-    uint64_t host_times[N_SAMPLES];
-    Float64 audio_times[N_SAMPLES];
+    int valid = 0;
 
-    printf("Method 1: AudioDeviceGetCurrentTime rapid probing...\n");
+    if (stamps) {
+        PocAudioClock clk;
+        if (poc_audioclock_start(&clk, device) != 0) {
+            fprintf(stderr, "Cannot start an IOProc on device %u\n", device);
+            return 1;
+        }
+        PocAudioStamp *s = malloc(N_SAMPLES * sizeof(PocAudioStamp));
+
+        // Only the IOProc pairs carry the device clock; they feed Method 1.
+        // AudioDeviceGetCurrentTime pairs are the HAL's interpolation between
+        // them, shown alongside as a comparison.
+        printf("Method 1: IOProc host/sample time pairs (phase error, ticks above min)\n");
+        int ns = poc_audioclock_read(&clk, s, N_IOPROC_STAMPS, IOPROC_TIMEOUT_S);
+        valid = stamps_to_timings(s, ns, timings);
+
+        printf("Method 1b: AudioDeviceGetCurrentTime pairs (HAL-interpolated, not PLL)\n");
+        uint64_t *hal = malloc(N_SAMPLES * sizeof(uint64_t));
+        if (hal) {
+            ns = poc_audioclock_poll(&clk, s, N_SAMPLES);
+            stamps_to_timings(s, ns, hal);
+            free(hal);
+        }
+        printf("\n");
+        poc_audioclock_stop(&clk);
+        free(s);
+        if (valid < 2) {
+            fprintf(stderr, "Device produced no usable time pairs\n");
+            return 1;
+        }
+    }
+
+    if (!stamps) printf("Method 1: AudioDeviceGetCurrentTime rapid probing...\n");
 
-    int valid = 0;
     AudioTimeStamp ts;
-    for (int i = 0; i < N_SAMPLES; i++) {
+    for (int i = 0; !stamps && i < N_SAMPLES; i++) {
         uint64_t t0 = mach_absolute_time();
 
         // Translate current time — this queries the audio clock
@@ -97,7 +163,6 @@ int main(void) {
 
         uint64_t t1 = mach_absolute_time();
         timings[valid] = t1 - t0;
-        host_times[valid] = t1;
         valid++;
     }
 
@@ -0,0 +1,47 @@
+// amx_timing.c — AMX/Accelerate matrix multiply timing entropy collector
+// Mechanism: cblas_sgemm with varying matrix sizes, interleaved volatile memory ops
+
+#define ACCELERATE_NEW_LAPACK
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include <Accelerate/Accelerate.h>
+
+static volatile uint8_t g_scratch[65536];
+
+int collect_amx_timing(uint64_t *timings, int n) {
+    int sizes[] = {16, 32, 48, 64, 96, 128};
+    int nsizes = sizeof(sizes) / sizeof(sizes[0]);
+    uint64_t rng = mach_absolute_time();
+
+    // Pre-allocate for largest size
+    float *a = (float *)malloc(128 * 128 * sizeof(float));
+    float *b = (float *)malloc(128 * 128 * sizeof(float));
+    float *c = (float *)malloc(128 * 128 * sizeof(float));
+    if (!a || !b || !c) { free(a); free(b); free(c); return 0; }
+
+    for (int i = 0; i < 128 * 128; i++) {
+        a[i] = (float)(lcg_next(&rng) & 0xFFFF) / 65536.0f;
+        b[i] = (float)(lcg_next(&rng) & 0xFFFF) / 65536.0f;
+    }
+
+    int valid = 0;
+    for (int i = 0; i < n; i++) {
+        int sz = sizes[lcg_next(&rng) % nsizes];
+
+        // Interleave volatile memory ops on scratch buffer
+        for (int j = 0; j < 16; j++) {
+            int off = (int)(lcg_next(&rng) % sizeof(g_scratch));
+            g_scratch[off] = (uint8_t)(g_scratch[off] ^ (uint8_t)j);
+        }
+
+        uint64_t t0 = mach_absolute_time();
+        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans,
+                    sz, sz, sz, 1.0f, a, sz, b, sz, 0.0f, c, sz);
+        uint64_t t1 = mach_absolute_time();
+
+        timings[valid++] = t1 - t0;
+    }
+
+    free(a); free(b); free(c);
+    return valid;
+}
@@ -0,0 +1,78 @@
+// cache_contention.c — Entropy source collector
+// Mechanism: 8MB buffer, alternate sequential/random/strided-64 access patterns (512 reads each)
+//
+// With POC_HEATMAP set, each burst's 64K window starts inside one of the
+// map's two highest-variance slices of the buffer (lib/poc_heatmap.h).
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "lib/poc_heatmap.h"
+
+#define CACHE_BUF_SIZE (8 * 1024 * 1024)
+#define CACHE_WINDOW 65536
+#define CACHE_HOT_SLICES 2
+
+static volatile uint8_t *g_cache_buf = NULL;
+static uint64_t g_hot[CACHE_HOT_SLICES];
+static int g_n_hot;
+static size_t g_slice_bytes;
+
+static void ensure_cache_buf(void) {
+    if (g_cache_buf) return;
+    g_cache_buf = (volatile uint8_t *)mmap(NULL, CACHE_BUF_SIZE,
+        PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
+    if (g_cache_buf == MAP_FAILED) {
+        g_cache_buf = NULL;
+        return;
+    }
+    // Touch every page
+    long page_size = sysconf(_SC_PAGESIZE);
+    for (size_t off = 0; off < CACHE_BUF_SIZE; off += (size_t)page_size)
+        ((volatile uint8_t *)g_cache_buf)[off] = (uint8_t)(off & 0xFF);
+    g_n_hot = poc_heatmap_env_slices(CACHE_BUF_SIZE, g_hot, CACHE_HOT_SLICES, &g_slice_bytes);
+    if (g_slice_bytes <= CACHE_WINDOW) g_n_hot = 0;
+}
+
+int collect_cache_contention(uint64_t *timings, int n) {
+    ensure_cache_buf();
+    if (!g_cache_buf) return 0;
+
+    uint64_t lcg = mach_absolute_time();
+    int valid = 0;
+    volatile uint8_t sink;
+
+    for (int i = 0; i < n; i++) {
+        int pattern = i % 3; // 0=sequential, 1=random, 2=strided-64
+        size_t base = g_n_hot
+            ? g_hot[lcg_next(&lcg) % g_n_hot] + (size_t)(lcg_next(&lcg) % (g_slice_bytes - CACHE_WINDOW))
+            : (size_t)(lcg_next(&lcg) % (CACHE_BUF_SIZE - CACHE_WINDOW));
+
+        uint64_t t0 = mach_absolute_time();
+        switch (pattern) {
+        case 0: // Sequential: 512 consecutive reads
+            for (int j = 0; j < 512; j++)
+                sink = g_cache_buf[base + j];
+            break;
+        case 1: // Random: 512 random reads within 64K window
+            for (int j = 0; j < 512; j++) {
+                size_t off = base + (size_t)(lcg_next(&lcg) % CACHE_WINDOW);
+                sink = g_cache_buf[off];
+            }
+            break;
+        case 2: // Strided-64: 512 reads at stride 64 (cache-line sized)
+            for (int j = 0; j < 512; j++)
+                sink = g_cache_buf[base + (size_t)j * 64];
+            break;
+        }
+        uint64_t t1 = mach_absolute_time();
+        (void)sink;
+        timings[valid++] = t1 - t0;
+    }
+    return valid;
+}
+
+void release_cache_contention(void) {
+    if (g_cache_buf) munmap((void *)g_cache_buf, CACHE_BUF_SIZE);
+    g_cache_buf = NULL;
+    g_n_hot = 0;
+}
@@ -0,0 +1,139 @@
+// cas_contention.c — CAS contention timing entropy collector
+// Mechanism: 64 atomic targets (128-byte spaced), 4 threads doing CAS, XOR-combine timings
+//
+// poc_cas_run() is the parameterized core (thread count, target count,
+// spacing, QoS class) that validate_cas_contention --sweep scans; the
+// registry collector is its default configuration, with the thread count a
+// registry tunable (poc_tune, the openentropy-core FFI).
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include <stdatomic.h>
+
+#define NUM_TARGETS 64
+#define TARGET_SPACING 128
+#define NUM_CAS_THREADS 4
+
+int poc_cas_contention_threads = NUM_CAS_THREADS;
+
+// Cache-line-isolated atomic targets, sized for the largest sweep point
+static char g_target_buf[POC_CAS_MAX_TARGETS * POC_CAS_MAX_SPACING]
+    __attribute__((aligned(128)));
+
+static inline atomic_uint_fast64_t *target_at(const PocCasConfig *cfg, int idx) {
+    return (atomic_uint_fast64_t *)(g_target_buf + (size_t)idx * cfg->spacing);
+}
+
+struct cas_thread_ctx {
+    const PocCasConfig *cfg;
+    int thread_id;
+    int samples_per_thread;
+    uint64_t *timings;  // output array, size = samples_per_thread
+    atomic_int *ready;
+    atomic_int *go;
+};
+
+static void *cas_worker(void *arg) {
+    struct cas_thread_ctx *ctx = (struct cas_thread_ctx *)arg;
+    const PocCasConfig *cfg = ctx->cfg;
+    uint64_t rng = mach_absolute_time() ^ ((uint64_t)ctx->thread_id * 0xDEADBEEF);
+
+    // QoS steers the thread toward the P (interactive) or E (background) cluster
+    poc_place_worker(cfg->qos, 0);
+
+    // Wait for go signal
+    atomic_fetch_add(ctx->ready, 1);
+    while (!atomic_load(ctx->go)) {}
+
+    for (int i = 0; i < ctx->samples_per_thread; i++) {
+        int tgt = (int)(lcg_next(&rng) % (uint64_t)cfg->targets);
+        atomic_uint_fast64_t *target = target_at(cfg, tgt);
+
+        uint64_t expected = atomic_load(target);
+        uint64_t t0 = mach_absolute_time();
+        atomic_compare_exchange_weak(target, &expected, expected + 1);
+        uint64_t t1 = mach_absolute_time();
+
+        ctx->timings[i] = t1 - t0;
+    }
+    poc_place_worker_done();
+    return NULL;
+}
+
+int poc_cas_run(const PocCasConfig *cfg, int samples_per_thread, uint64_t *out,
+                uint64_t *elapsed) {
+    if (cfg->threads < 1 || cfg->threads > POC_CAS_MAX_THREADS || cfg->targets < 1 ||
+        cfg->targets > POC_CAS_MAX_TARGETS || cfg->spacing < (int)sizeof(atomic_uint_fast64_t) ||
+        cfg->spacing > POC_CAS_MAX_SPACING || samples_per_thread < 1)
+        return -1;
+
+    // Initialize targets
+    memset(g_target_buf, 0, sizeof(g_target_buf));
+    for (int i = 0; i < cfg->targets; i++) {
+        atomic_store(target_at(cfg, i), 0);
+    }
+
+    atomic_int ready = 0, go = 0;
+    struct cas_thread_ctx ctxs[POC_CAS_MAX_THREADS];
+    pthread_t tids[POC_CAS_MAX_THREADS];
+    int started = 0;
+
+    for (int i = 0; i < cfg->threads; i++) {
+        ctxs[i].cfg = cfg;
+        ctxs[i].thread_id = i;
+        ctxs[i].samples_per_thread = samples_per_thread;
+        ctxs[i].timings = out + (size_t)i * samples_per_thread;
+        ctxs[i].ready = &ready;
+        ctxs[i].go = &go;
+        if (pthread_create(&tids[i], NULL, cas_worker, &ctxs[i]) != 0) break;
+        started++;
+    }
+
+    // Signal all threads to start once every one is spinning
+    while (atomic_load(&ready) < started) {}
+    uint64_t t0 = mach_absolute_time();
+    atomic_store(&go, 1);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    if (elapsed) *elapsed = mach_absolute_time() - t0;
+    return started == cfg->threads ? 0 : -1;
+}
+
+int collect_cas_contention(uint64_t *timings, int n) {
+    const int threads = poc_cas_contention_threads < 1 ? 1
+                      : poc_cas_contention_threads > POC_CAS_MAX_THREADS ? POC_CAS_MAX_THREADS
+                      : poc_cas_contention_threads;
+    const PocCasConfig cfg = {
+        .threads = threads,
+        .targets = NUM_TARGETS,
+        .spacing = TARGET_SPACING,
+        .qos = POC_QOS_INHERIT,
+    };
+
+    int samples_per_thread = n / threads;
+    if (samples_per_thread < 1) samples_per_thread = 1;
+
+    // Per-thread timing arrays, back to back
+    uint64_t *thread_timings =
+        (uint64_t *)malloc((size_t)threads * samples_per_thread * sizeof(uint64_t));
+    if (!thread_timings) return 0;
+    if (poc_cas_run(&cfg, samples_per_thread, thread_timings, NULL) != 0) {
+        free(thread_timings);
+        return 0;
+    }
+
+    // XOR-combine timings from all threads
+    int valid = 0;
+    for (int s = 0; s < samples_per_thread && valid < n; s++) {
+        uint64_t combined = 0;
+        for (int t = 0; t < threads; t++) {
+            combined ^= thread_timings[(size_t)t * samples_per_thread + s];
+        }
+        timings[valid++] = combined;
+    }
+
+    free(thread_timings);
+    return valid;
+}
@@ -0,0 +1,344 @@
+// collectors.h — Registry of every validate_* entropy collector
+//
+// Each collector is implemented once, in collectors/<name>.c, and looked up
+// by name: validate_<name> runs the standard harness on its own entry and
+// cross-correlates against the registry entries named in .cross, and
+// poc_runner runs any subset of the catalog in one process.
+//
+// Build: collectors/libcollectors.a (see Makefile), linked before lib/libpoc.a.
+
+#ifndef POC_COLLECTORS_H
+#define POC_COLLECTORS_H
+
+#include <stdint.h>
+
+#include "lib/poc_place.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_MAX_CROSS 2
+
+// Fewer than this many samples in Test 1 ends a validation early.
+#define POC_MIN_VALID 100
+
+typedef struct {
+    const char *name;
+    int (*collect)(uint64_t *timings, int n);
+    void (*release)(void);              // optional: drop workers / buffers
+    int large_n;                        // Test 1; 0 = LARGE_N
+    int trial_n;                        // Test 3 per trial; 0 = TRIAL_N
+    int cc_n;                           // Test 4; 0 = 5000
+    const char *cross[POC_MAX_CROSS];   // Test 4 partners, by registry name
+    int demote_if_short;                // < POC_MIN_VALID is DEMOTE, not FAIL
+    const char *note;                   // printed under the header; %d = large_n
+    const char *object;                 // collectors/<object>.o; NULL = <name>.o
+} PocCollector;
+
+extern const PocCollector poc_collectors[];
+extern const int poc_n_collectors;
+
+// NULL when no collector has that name.
+const PocCollector *poc_collector_find(const char *name);
+
+// Registry index of the first collector built from the same object file as
+// c. Collectors of one object share its static state (worker pools, shared
+// buffers, probed maps), so two calls into the same group must not overlap.
+int poc_collector_group(const PocCollector *c);
+
+// Tests 1-4 and the verdict for one collector (honours POC_SOAK_N).
+// Returns the process exit status: 0, or 1 on setup failure.
+int poc_validate(const PocCollector *c);
+
+// c->collect(out, n), timed and binned into c's histograms when POC_HIST
+// names a report file (collectors/hist.c). Every registry program collects
+// through this. poc_hist_flush() writes the report now; it is also written
+// at exit.
+int poc_collect(const PocCollector *c, uint64_t *out, int n);
+void poc_hist_flush(void);
+
+// --- collectors/<name>.c ---------------------------------------------------
+
+int collect_amx_timing(uint64_t *timings, int n);
+int collect_cache_contention(uint64_t *timings, int n);
+int collect_cas_contention(uint64_t *timings, int n);
+int collect_compression_timing(uint64_t *timings, int n);
+int collect_compression_zstream(uint64_t *timings, int n);
+int collect_compression_lzfse(uint64_t *timings, int n);
+int collect_coreml_ane(uint64_t *timings, int n);
+int collect_cpu_io_beat(uint64_t *timings, int n);
+int collect_cpu_memory_beat(uint64_t *timings, int n);
+int collect_dispatch_queue(uint64_t *timings, int n);
+int collect_dram_row_buffer(uint64_t *timings, int n);
+int collect_dram_row_conflict(uint64_t *timings, int n);
+int collect_dvfs_race(uint64_t *timings, int n);
+int collect_dyld_timing(uint64_t *timings, int n);
+int collect_hash_timing(uint64_t *timings, int n);
+int collect_hash_concurrent(uint64_t *timings, int n);
+int collect_ioregistry(uint64_t *timings, int n);
+int collect_kqueue_events(uint64_t *timings, int n);
+int collect_kqueue_events_batch(uint64_t *timings, int n);
+int collect_mach_ipc(uint64_t *timings, int n);
+int collect_mach_ipc_roundtrip(uint64_t *timings, int n);
+int collect_multi_domain_beat(uint64_t *timings, int n);
+int collect_page_fault_timing(uint64_t *timings, int n);
+int collect_page_fault_recycled(uint64_t *timings, int n);
+int collect_pipe_buffer(uint64_t *timings, int n);
+int collect_pipe_buffer_writev(uint64_t *timings, int n);
+int collect_sensor_noise(uint64_t *timings, int n);
+int collect_sep_signing(uint64_t *timings, int n);
+int collect_speculative_execution(uint64_t *timings, int n);
+int collect_speculative_unrolled(uint64_t *timings, int n);
+int collect_sme_transition(uint64_t *timings, int n);
+int collect_sme_fmopa(uint64_t *timings, int n);
+int collect_spotlight_timing(uint64_t *timings, int n);
+int collect_spotlight_mditem(uint64_t *timings, int n);
+int collect_thread_lifecycle(uint64_t *timings, int n);
+int collect_thread_wakeup_semaphore(uint64_t *timings, int n);
+int collect_thread_wakeup_ulock(uint64_t *timings, int n);
+int collect_thread_wakeup_unfair(uint64_t *timings, int n);
+int collect_tlb_shootdown(uint64_t *timings, int n);
+int collect_tlb_shootdown_shared(uint64_t *timings, int n);
+int collect_vm_page_timing(uint64_t *timings, int n);
+
+// hash_timing: `threads` concurrent SHA-256 loops. Thread t's timings land
+// in out[t * samples_per_thread + i]; *elapsed (optional) is the wall time
+// from release to last join, *bytes (optional) the total bytes hashed.
+// Returns 0, or -1 on a bad thread count or start failure.
+#define POC_HASH_MAX_THREADS 64
+
+int poc_hash_run(int threads, int samples_per_thread, uint64_t *out, uint64_t *elapsed,
+                 uint64_t *bytes);
+
+// spotlight_timing: `inflight` threads each issuing per_query in-process
+// MDItem lookups at once; thread t's timings land in out[t * per_query + i].
+// Returns 0, or -1 on a bad count, start failure, or off macOS.
+#define POC_SPOTLIGHT_MAX_INFLIGHT 16
+
+int poc_spotlight_run(int inflight, int per_query, uint64_t *out, uint64_t *elapsed);
+
+// cas_contention: one CAS burst with an explicit configuration. Thread t
+// writes its samples_per_thread timings to out[t * samples_per_thread + i];
+// *elapsed (optional) gets the wall time from release to last join.
+// Returns 0, or -1 on an out-of-range config or thread start failure.
+#define POC_CAS_MAX_THREADS 64
+#define POC_CAS_MAX_TARGETS 256
+#define POC_CAS_MAX_SPACING 256
+
+typedef struct {
+    int threads;
+    int targets;
+    int spacing;    // bytes between targets
+    PocQos qos;     // QoS class of the workers (lib/poc_place.h)
+} PocCasConfig;
+
+int poc_cas_run(const PocCasConfig *cfg, int samples_per_thread, uint64_t *out,
+                uint64_t *elapsed);
+
+// tlb_shootdown: the mprotect collector with `helpers` threads on other
+// cores reading the region throughout (0 = single-threaded collector).
+// Writes delta-of-deltas like the registry collectors and returns the
+// count; *syscall_ticks (optional) gets the summed mprotect-pair time.
+#define POC_TLB_MAX_HELPERS 32
+
+int poc_tlb_run(int helpers, uint64_t *timings, int n, uint64_t *syscall_ticks);
+
+// speculative_execution: compile-time unrolled branch kernels (len steps
+// of the collector's four-branch body, no loop inside the sample).
+// poc_spec_run() times n calls of one kernel; period > 0 repeats the step
+// values every `period` steps, 0 draws fresh random values. Returns n, or
+// 0 on a period outside [0, POC_SPEC_MAX_LEN].
+#define POC_SPEC_MAX_LEN 128
+
+typedef struct {
+    int len;
+    int (*fn)(const uint64_t *vals);
+} PocSpecKernel;
+
+extern const PocSpecKernel poc_spec_kernels[];
+extern const int poc_n_spec_kernels;
+
+int poc_spec_run(const PocSpecKernel *k, int period, uint64_t *timings, int n);
+
+// sme_timing: 1 when the CPU reports FEAT_SME; otherwise the sme_*
+// collectors fall back to collect_amx_timing().
+int poc_sme_available(void);
+
+// coreml_ane: n intervals between consecutive completions of a tiny Core ML
+// model on the Neural Engine, `inflight` async predictions queued at once.
+// *elapsed (optional) is the wall time of the run. Returns n, or 0 on a bad
+// count or when no model loads; poc_coreml_available() says which.
+#define POC_COREML_MAX_INFLIGHT 16
+
+int poc_coreml_available(void);
+int poc_coreml_run(int inflight, uint64_t *timings, int n, uint64_t *elapsed);
+
+// dvfs_race: racer pairs on the cluster combinations P/P, P/E and E/E, all
+// racing at once. poc_dvfs_pairs() fills in the combinations this machine
+// has, on distinct CPUs while each cluster has enough of them, and returns
+// the count. poc_dvfs_race_pairs() lets every pair race for window_ticks
+// per sample, n samples each (collect_dvfs_race()'s XOR of adjacent count
+// differences); pair p's land in out[p * n + i], and seen_a / seen_b get
+// the CPUs its racers ended on. Returns 0, or -1 on a bad count or start
+// failure.
+#define POC_DVFS_MAX_PAIRS 3
+
+typedef struct {
+    PocCluster a, b;
+    int cpu_a, cpu_b;           // placement targets (pinned on Linux)
+    int seen_a, seen_b;         // -1 when the system does not say
+} PocDvfsPair;
+
+int poc_dvfs_pairs(PocDvfsPair pairs[POC_DVFS_MAX_PAIRS]);
+int poc_dvfs_race_pairs(PocDvfsPair *pairs, int n_pairs, int window_ticks, uint64_t *out,
+                        int n);
+
+// pipe_buffer: the writev collector with an explicit pipe count and
+// segments per syscall. Samples alternate writev and readv durations;
+// rounds whose writev moves nothing are dropped. Returns the count (n
+// rounded down to even, fewer if n rounds failed first), or 0 on an
+// out-of-range count or when the pipes cannot be opened.
+#define POC_PIPEV_MAX_PIPES    64
+#define POC_PIPEV_MAX_SEGMENTS 16
+
+int poc_pipev_run(int n_pipes, int segments, uint64_t *timings, int n);
+
+// sep_signing: n intervals between consecutive completions of ECDSA P-256
+// signatures by a Secure Enclave key, `inflight` worker threads signing at
+// once. *elapsed (optional) is the wall time of the run. Returns n, or 0 on
+// a bad count, a failed signature, or when no Secure Enclave key could be
+// made (poc_sep_available() is then 0); there is no software fallback.
+#define POC_SEP_MAX_INFLIGHT 16
+
+int poc_sep_available(void);
+int poc_sep_run(int inflight, uint64_t *timings, int n, uint64_t *elapsed);
+
+// gpu_load: registers Metal compute bursts as the lib/poc_load.h gpu
+// profile, or one-threadgroup dispatches as the lib/poc_beat.h gpu domain.
+// Returns 0, or -1 when no Metal device or pipeline is available.
+int poc_gpu_load_install(void);
+int poc_gpu_beat_install(void);
+
+// dram_row_buffer: timing-derived row-conflict map. Pair latencies of two
+// flushed lines split into a hit and a conflict cluster. poc_dram_map()
+// loads the copy cached for this boot ($POC_DRAM_MAP, default
+// POC_DRAM_MAP_DEFAULT) or measures and saves it (always when
+// force). Returns 0, or -1 when the clusters are not separated (m is then
+// still filled, with valid = 0).
+typedef struct {
+    uint64_t hit_ticks;         // mean of the fast cluster
+    uint64_t conflict_ticks;    // mean of the slow cluster
+    uint64_t threshold_ticks;
+    int page_size;
+    int valid;
+} PocDramMap;
+
+#define POC_DRAM_MAP_DEFAULT "/tmp/poc_dram_map.txt"
+
+int poc_dram_map(PocDramMap *m, int force);
+
+// Conflicting page pairs found in the collector's own buffer (scanned once
+// per buffer); 0 means collect_dram_row_conflict() falls back to the
+// random-pair collector.
+int poc_dram_conflict_pairs(void);
+
+// compression_timing: n compressions of seeded inputs in one mode. Equal
+// seeds give identical input sequences across modes. Returns n, or 0 if the
+// mode is unavailable (LZFSE / LZ4 need Apple's libcompression).
+typedef enum {
+    POC_COMPRESS2,          // compress2(): fresh deflate state per call
+    POC_COMPRESS_ZSTREAM,   // one z_stream, deflateReset() per sample
+    POC_COMPRESS_LZFSE,     // compression_encode_buffer(), scratch reused
+    POC_COMPRESS_LZ4,
+} PocCompressMode;
+
+int poc_compress_run(PocCompressMode mode, uint64_t seed, uint64_t *timings, int n);
+const char *poc_compress_mode_name(PocCompressMode mode);
+
+// Tunable parameters: plain ints a collector reads at the start of every
+// call, defined next to it. poc_tune searches them (coarse grid, then local
+// refinement) for the best H∞ × samples/s and saves the winners per machine
+// model; poc_params_apply_env() loads the rows for this model from
+// $POC_TUNE, and the registry programs call it at startup.
+typedef struct {
+    const char *collector;  // registry name the tuner scores it through
+    const char *name;
+    int *value;
+    int def, min, max;
+} PocParam;
+
+extern const PocParam poc_params[];
+extern const int poc_n_params;
+
+extern int poc_cas_contention_threads;
+extern int poc_compression_timing_min_bytes;
+extern int poc_compression_timing_span_bytes;
+extern int poc_cpu_io_beat_lcg_iters;
+extern int poc_cpu_io_beat_write_bytes;
+extern int poc_cpu_io_beat_flush_every;
+extern int poc_cpu_memory_beat_lcg_iters;
+extern int poc_pipe_buffer_writev_pipes;
+extern int poc_pipe_buffer_writev_segments;
+extern int poc_thread_lifecycle_max_work;
+extern int poc_tlb_shootdown_min_pages;
+extern int poc_tlb_shootdown_span_pages;
+
+// NULL when the collector has no parameter of that name.
+const PocParam *poc_param_find(const char *collector, const char *name);
+void poc_params_reset(void);
+
+// hw.model on macOS ("Mac16,1"), the DMI product name on Linux, else
+// "unknown"; no whitespace, so it can key a row of the tune file.
+const char *poc_machine_model(void);
+
+// Tune file, one row per parameter (tab separated, '#' comments):
+//   # poc_tune v1
+//   <model>  <collector>  <param>  <value>  <score bits/s>
+// poc_params_load() applies the rows for `model` and returns how many, or
+// -1 when the file cannot be read. poc_params_save() rewrites the file with
+// the current values of `collector`'s parameters replacing any earlier rows
+// for (model, collector), keeping every other row; the new file is written
+// beside it and renamed into place. Returns 0, or -1 on I/O failure (the
+// old file is then left as it was).
+int poc_params_load(const char *path, const char *model);
+int poc_params_save(const char *path, const char *model, const char *collector, double score);
+void poc_params_apply_env(void);
+
+// Fixed C ABI for linking the collectors into openentropy-core (feature
+// poc-native, sources/frontier/native.rs). poc_ffi_find() returns a
+// collector's registry index, or -1. poc_ffi_collect() sets the listed
+// tunables (clamped to their ranges; a NULL or empty set keeps the current
+// values), then fills out[0..n) with the collector's raw samples and
+// returns how many are valid, or -1 on a bad index, name or count. Calls
+// into one collector group (poc_collector_group) are serialized, parameter
+// writes included, so callers on any thread may share an index. Tunables
+// are process-wide: a set passed here stays in force for every later
+// collection of that collector, from this ABI or any other caller.
+typedef struct {
+    const char *name;
+    int32_t value;
+} PocFfiParam;
+
+typedef struct {
+    int32_t count;
+    const PocFfiParam *items;
+} PocFfiParams;
+
+int poc_ffi_find(const char *name);
+int poc_ffi_collect(int index, uint64_t *out, int n, const PocFfiParams *params);
+
+void release_cache_contention(void);
+void release_compression(void);
+void release_coreml_ane(void);
+void release_dispatch_queue(void);
+void release_dram_row_buffer(void);
+void release_page_fault_recycled(void);
+void release_sep_signing(void);
+void release_thread_wakeup(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_COLLECTORS_H
@@ -0,0 +1,155 @@
+// compression_timing.c — Entropy source collector
+// Mechanism: Compress varying-size data (128-512 bytes, mixed patterns) with zlib
+//
+// compress2() builds and frees a whole deflate state (~256 KB of window and
+// hash tables) per call, so its samples are as much allocator as codec.
+// poc_compress_run() can instead time a single long-lived z_stream that is
+// deflateReset() between samples, or Apple's compression_encode_buffer()
+// (LZFSE / LZ4) with a scratch buffer allocated once. Every mode draws the
+// same inputs from the same seed, so the modes can be compared sample by
+// sample.
+//
+// The input size range (min_bytes .. min_bytes + span_bytes) is a registry
+// tunable (poc_tune, tuned through compression_timing); it applies to every
+// mode.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include <zlib.h>
+
+#if defined(__APPLE__)
+#include <compression.h>
+#endif
+
+#define COMP_MAX_SRC 4096
+#define COMP_DST 8192
+
+int poc_compression_timing_min_bytes = 128;
+int poc_compression_timing_span_bytes = 384;
+
+static z_stream g_zs;
+static int g_zs_ready;
+#if defined(__APPLE__)
+static void *g_scratch[2];   // LZFSE, LZ4
+#endif
+
+const char *poc_compress_mode_name(PocCompressMode mode) {
+    switch (mode) {
+    case POC_COMPRESS2: return "compress2";
+    case POC_COMPRESS_ZSTREAM: return "z_stream reuse";
+    case POC_COMPRESS_LZFSE: return "LZFSE";
+    case POC_COMPRESS_LZ4: return "LZ4";
+    }
+    return "?";
+}
+
+static int fill_input(uint8_t *src, uint64_t *lcg) {
+    // Vary size between min_bytes and min_bytes + span_bytes (128-512 by default)
+    int lo = poc_compression_timing_min_bytes < 1 ? 1
+           : poc_compression_timing_min_bytes > COMP_MAX_SRC ? COMP_MAX_SRC
+           : poc_compression_timing_min_bytes;
+    int span = poc_compression_timing_span_bytes < 0 ? 0 : poc_compression_timing_span_bytes;
+    if (lo + span > COMP_MAX_SRC) span = COMP_MAX_SRC - lo;
+    int sz = lo + (int)(lcg_next(lcg) % (uint64_t)(span + 1));
+    // Fill with mix of random and repeating patterns
+    for (int j = 0; j < sz; j++) {
+        if (j % 3 == 0)
+            src[j] = (uint8_t)(lcg_next(lcg) & 0xFF);
+        else
+            src[j] = (uint8_t)(j & 0xFF);
+    }
+    return sz;
+}
+
+// One-time setup for the reuse modes. Returns 0, or -1 if unavailable.
+static int prepare(PocCompressMode mode) {
+    if (mode == POC_COMPRESS_ZSTREAM && !g_zs_ready) {
+        memset(&g_zs, 0, sizeof(g_zs));
+        if (deflateInit(&g_zs, Z_DEFAULT_COMPRESSION) != Z_OK) return -1;
+        g_zs_ready = 1;
+    }
+#if defined(__APPLE__)
+    if (mode == POC_COMPRESS_LZFSE || mode == POC_COMPRESS_LZ4) {
+        int k = mode == POC_COMPRESS_LZ4;
+        if (!g_scratch[k]) {
+            size_t sz = compression_encode_scratch_buffer_size(
+                k ? COMPRESSION_LZ4 : COMPRESSION_LZFSE);
+            g_scratch[k] = malloc(sz ? sz : 1);
+            if (!g_scratch[k]) return -1;
+        }
+    }
+#else
+    if (mode == POC_COMPRESS_LZFSE || mode == POC_COMPRESS_LZ4) return -1;
+#endif
+    return 0;
+}
+
+int poc_compress_run(PocCompressMode mode, uint64_t seed, uint64_t *timings, int n) {
+    if (prepare(mode) != 0) return 0;
+
+    uint64_t lcg = seed;
+    uint8_t src[COMP_MAX_SRC];
+    uint8_t dst[COMP_DST];
+    int valid = 0;
+
+    for (int i = 0; i < n; i++) {
+        int sz = fill_input(src, &lcg);
+        uint64_t t0 = 0, t1 = 0;
+
+        switch (mode) {
+        case POC_COMPRESS2: {
+            uLongf dst_len = sizeof(dst);
+            t0 = mach_absolute_time();
+            compress2(dst, &dst_len, src, (uLong)sz, Z_DEFAULT_COMPRESSION);
+            t1 = mach_absolute_time();
+            break;
+        }
+        case POC_COMPRESS_ZSTREAM:
+            t0 = mach_absolute_time();
+            deflateReset(&g_zs);
+            g_zs.next_in = src;
+            g_zs.avail_in = (uInt)sz;
+            g_zs.next_out = dst;
+            g_zs.avail_out = sizeof(dst);
+            deflate(&g_zs, Z_FINISH);
+            t1 = mach_absolute_time();
+            break;
+        case POC_COMPRESS_LZFSE:
+        case POC_COMPRESS_LZ4:
+#if defined(__APPLE__)
+            t0 = mach_absolute_time();
+            compression_encode_buffer(dst, sizeof(dst), src, (size_t)sz,
+                                      g_scratch[mode == POC_COMPRESS_LZ4],
+                                      mode == POC_COMPRESS_LZ4 ? COMPRESSION_LZ4
+                                                               : COMPRESSION_LZFSE);
+            t1 = mach_absolute_time();
+#endif
+            break;
+        }
+        timings[valid++] = t1 - t0;
+    }
+    return valid;
+}
+
+int collect_compression_timing(uint64_t *timings, int n) {
+    return poc_compress_run(POC_COMPRESS2, mach_absolute_time(), timings, n);
+}
+
+int collect_compression_zstream(uint64_t *timings, int n) {
+    return poc_compress_run(POC_COMPRESS_ZSTREAM, mach_absolute_time(), timings, n);
+}
+
+int collect_compression_lzfse(uint64_t *timings, int n) {
+    return poc_compress_run(POC_COMPRESS_LZFSE, mach_absolute_time(), timings, n);
+}
+
+void release_compression(void) {
+    if (g_zs_ready) deflateEnd(&g_zs);
+    g_zs_ready = 0;
+#if defined(__APPLE__)
+    for (int k = 0; k < 2; k++) {
+        free(g_scratch[k]);
+        g_scratch[k] = NULL;
+    }
+#endif
+}
@@ -0,0 +1,261 @@
+// coreml_ane.m — Neural Engine inference timing entropy collector
+// Mechanism: a tiny Core ML model pinned to MLComputeUnitsCPUAndNeuralEngine,
+// several async predictions in flight, every completion timestamped
+//
+// The Accelerate-based "ANE" PoCs (coreml_neural_engine, unprecedented_ane_jitter)
+// time cblas / vDSP, which run on the CPU and AMX. This collector drives the
+// Neural Engine itself. The model is one 256x256 inner product and a ReLU,
+// written as a Core ML protobuf spec and compiled once per process, or any
+// compiled .mlmodelc named by POC_COREML_MODEL (its first multi-array input
+// is filled with random values). Up to `inflight` predictions are queued at
+// once (macOS 14 async API), each on its own input slot, so the ANE always
+// has the next request waiting; a sample is the interval between
+// consecutive completions. Before macOS 14 predictions run synchronously.
+
+#import <CoreML/CoreML.h>
+#import <Foundation/Foundation.h>
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+
+#include <stdatomic.h>
+
+#define ANE_CHANNELS 256
+#define DEFAULT_INFLIGHT 4
+
+static MLModel *g_model;
+static id<MLFeatureProvider> g_slots[POC_COREML_MAX_INFLIGHT];
+static int g_tried;
+
+// --- protobuf spec --------------------------------------------------------
+
+static void pb_varint(NSMutableData *d, uint64_t v) {
+    uint8_t b[10];
+    int n = 0;
+    do {
+        b[n] = v & 0x7F;
+        v >>= 7;
+        if (v) b[n] |= 0x80;
+        n++;
+    } while (v);
+    [d appendBytes:b length:n];
+}
+
+static void pb_key(NSMutableData *d, int field, int wire) {
+    pb_varint(d, ((uint64_t)field << 3) | wire);
+}
+
+static void pb_uint(NSMutableData *d, int field, uint64_t v) {
+    pb_key(d, field, 0);
+    pb_varint(d, v);
+}
+
+static void pb_bytes(NSMutableData *d, int field, const void *p, size_t len) {
+    pb_key(d, field, 2);
+    pb_varint(d, len);
+    [d appendBytes:p length:len];
+}
+
+static void pb_msg(NSMutableData *d, int field, NSData *m) {
+    pb_bytes(d, field, m.bytes, m.length);
+}
+
+static void pb_str(NSMutableData *d, int field, const char *s) {
+    pb_bytes(d, field, s, strlen(s));
+}
+
+// FeatureDescription{name, type: multiArrayType{shape [ANE_CHANNELS], FLOAT32}}
+static NSData *feature_desc(const char *name) {
+    NSMutableData *shape = [NSMutableData data];
+    pb_varint(shape, ANE_CHANNELS);
+    NSMutableData *array = [NSMutableData data];
+    pb_msg(array, 1, shape);          // shape, packed
+    pb_uint(array, 2, 65568);         // ArrayDataType FLOAT32
+    NSMutableData *type = [NSMutableData data];
+    pb_msg(type, 5, array);           // multiArrayType
+    NSMutableData *fd = [NSMutableData data];
+    pb_str(fd, 1, name);
+    pb_msg(fd, 3, type);
+    return fd;
+}
+
+// Model{specificationVersion 4, description, neuralNetwork{innerProduct, ReLU}}
+static NSData *build_spec(void) {
+    uint64_t rng = mach_absolute_time() | 1;
+    NSMutableData *w = [NSMutableData dataWithLength:ANE_CHANNELS * ANE_CHANNELS * sizeof(float)];
+    float *wf = w.mutableBytes;
+    for (int i = 0; i < ANE_CHANNELS * ANE_CHANNELS; i++)
+        wf[i] = (float)(lcg_next(&rng) & 0xFFFFFF) / (float)(1 << 24) - 0.5f;
+
+    NSMutableData *weights = [NSMutableData data];
+    pb_msg(weights, 1, w);            // floatValue, packed
+    NSMutableData *ip = [NSMutableData data];
+    pb_uint(ip, 1, ANE_CHANNELS);     // inputChannels
+    pb_uint(ip, 2, ANE_CHANNELS);     // outputChannels
+    pb_msg(ip, 20, weights);
+    NSMutableData *dense = [NSMutableData data];
+    pb_str(dense, 1, "dense");
+    pb_str(dense, 2, "x");
+    pb_str(dense, 3, "h");
+    pb_msg(dense, 140, ip);           // innerProduct
+
+    NSMutableData *act = [NSMutableData data];
+    pb_bytes(act, 10, "", 0);         // ReLU
+    NSMutableData *relu = [NSMutableData data];
+    pb_str(relu, 1, "relu");
+    pb_str(relu, 2, "h");
+    pb_str(relu, 3, "y");
+    pb_msg(relu, 130, act);           // activation
+
+    NSMutableData *nn = [NSMutableData data];
+    pb_msg(nn, 1, dense);
+    pb_msg(nn, 1, relu);
+
+    NSMutableData *desc = [NSMutableData data];
+    pb_msg(desc, 1, feature_desc("x"));
+    pb_msg(desc, 10, feature_desc("y"));
+
+    NSMutableData *model = [NSMutableData data];
+    pb_uint(model, 1, 4);
+    pb_msg(model, 2, desc);
+    pb_msg(model, 500, nn);
+    return model;
+}
+
+// --- model and input slots ------------------------------------------------
+
+// The model to load: POC_COREML_MODEL, or the built-in spec compiled into a
+// temporary .mlmodelc (*temporary = YES) that the caller removes once loaded.
+static NSURL *compiled_model_url(BOOL *temporary) {
+    *temporary = NO;
+    const char *env = getenv("POC_COREML_MODEL");
+    if (env && *env) return [NSURL fileURLWithPath:@(env)];
+
+    NSString *path = [NSTemporaryDirectory()
+        stringByAppendingPathComponent:[NSString stringWithFormat:@"poc_ane_%d.mlmodel",
+                                                                  getpid()]];
+    if (![build_spec() writeToFile:path atomically:YES]) return nil;
+    NSError *err = nil;
+    NSURL *url = [MLModel compileModelAtURL:[NSURL fileURLWithPath:path] error:&err];
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+    *temporary = url != nil;
+    return url;
+}
+
+static int load_model(void) {
+    if (g_model || g_tried) return g_model ? 0 : -1;
+    g_tried = 1;
+    @autoreleasepool {
+        BOOL temporary;
+        NSURL *url = compiled_model_url(&temporary);
+        if (!url) return -1;
+
+        MLModelConfiguration *cfg = [[MLModelConfiguration alloc] init];
+        if (@available(macOS 13.0, *)) cfg.computeUnits = MLComputeUnitsCPUAndNeuralEngine;
+        NSError *err = nil;
+        MLModel *model = [MLModel modelWithContentsOfURL:url configuration:cfg error:&err];
+        if (temporary) [[NSFileManager defaultManager] removeItemAtURL:url error:NULL];
+        if (!model) return -1;
+
+        // First multi-array input; one pre-filled provider per in-flight slot
+        MLFeatureDescription *input = nil;
+        for (MLFeatureDescription *fd in model.modelDescription.inputDescriptionsByName.allValues)
+            if (fd.type == MLFeatureTypeMultiArray) { input = fd; break; }
+        if (!input) return -1;
+
+        uint64_t rng = mach_absolute_time() | 1;
+        for (int s = 0; s < POC_COREML_MAX_INFLIGHT; s++) {
+            MLMultiArray *a = [[MLMultiArray alloc] initWithShape:input.multiArrayConstraint.shape
+                                                         dataType:MLMultiArrayDataTypeFloat32
+                                                            error:&err];
+            if (!a) return -1;
+            float *p = a.dataPointer;
+            for (NSInteger i = 0; i < a.count; i++)
+                p[i] = (float)(lcg_next(&rng) & 0xFFFFFF) / (float)(1 << 24);
+            g_slots[s] = [[MLDictionaryFeatureProvider alloc]
+                initWithDictionary:@{input.name : [MLFeatureValue featureValueWithMultiArray:a]}
+                             error:&err];
+            if (!g_slots[s]) return -1;
+        }
+        g_model = model;
+    }
+    return 0;
+}
+
+int poc_coreml_available(void) { return load_model() == 0; }
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+int poc_coreml_run(int inflight, uint64_t *timings, int n, uint64_t *elapsed) {
+    if (inflight < 1 || inflight > POC_COREML_MAX_INFLIGHT || n < 1) return 0;
+    if (load_model() != 0) return 0;
+
+    // n intervals need n + 1 completions
+    uint64_t *stamps = malloc((size_t)(n + 1) * sizeof(uint64_t));
+    if (!stamps) return 0;
+    // The handlers only touch these through pointers; the group wait below
+    // keeps the frame alive until the last one has run.
+    atomic_int done = 0, failed = 0;
+    atomic_int *pdone = &done, *pfailed = &failed;
+    uint64_t t_start = mach_absolute_time();
+
+    @autoreleasepool {
+        if (@available(macOS 14.0, *)) {
+            dispatch_semaphore_t slot_free[POC_COREML_MAX_INFLIGHT];
+            for (int s = 0; s < inflight; s++) slot_free[s] = dispatch_semaphore_create(1);
+            dispatch_group_t group = dispatch_group_create();
+            MLPredictionOptions *opts = [[MLPredictionOptions alloc] init];
+
+            for (int i = 0; i <= n; i++) {
+                int s = i % inflight;
+                dispatch_semaphore_wait(slot_free[s], DISPATCH_TIME_FOREVER);
+                dispatch_semaphore_t sem = slot_free[s];
+                dispatch_group_enter(group);
+                [g_model predictionFromFeatures:g_slots[s]
+                                        options:opts
+                              completionHandler:^(id<MLFeatureProvider> out, NSError *error) {
+                                  uint64_t t = mach_absolute_time();
+                                  if (!out || error) atomic_fetch_add(pfailed, 1);
+                                  stamps[atomic_fetch_add(pdone, 1)] = t;
+                                  dispatch_semaphore_signal(sem);
+                                  dispatch_group_leave(group);
+                              }];
+            }
+            dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+        } else {
+            for (int i = 0; i <= n; i++) {
+                @autoreleasepool {
+                    NSError *error = nil;
+                    id<MLFeatureProvider> out = [g_model predictionFromFeatures:g_slots[0]
+                                                                          error:&error];
+                    if (!out) atomic_fetch_add(&failed, 1);
+                    stamps[atomic_fetch_add(&done, 1)] = mach_absolute_time();
+                }
+            }
+        }
+    }
+
+    if (elapsed) *elapsed = mach_absolute_time() - t_start;
+    int valid = 0;
+    if (atomic_load(&failed) == 0) {
+        // Handlers can stamp and claim an index in either order
+        qsort(stamps, (size_t)n + 1, sizeof(uint64_t), cmp_u64);
+        for (int i = 0; i < n; i++) timings[valid++] = stamps[i + 1] - stamps[i];
+    }
+    free(stamps);
+    return valid;
+}
+
+int collect_coreml_ane(uint64_t *timings, int n) {
+    return poc_coreml_available() ? poc_coreml_run(DEFAULT_INFLIGHT, timings, n, NULL)
+                                  : collect_amx_timing(timings, n);
+}
+
+void release_coreml_ane(void) {
+    for (int s = 0; s < POC_COREML_MAX_INFLIGHT; s++) g_slots[s] = nil;
+    g_model = nil;
+    g_tried = 0;
+}
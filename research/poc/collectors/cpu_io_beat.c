@@ -0,0 +1,26 @@
+// cpu_io_beat.c — CPU/IO cross-domain beat timing entropy collector
+// Mechanism: Alternate CPU-bound (50 LCG iterations) and disk I/O (write 64 bytes
+//            to tmpfile, flush every 16th). Record both CPU and IO timings separately,
+//            interleave into timings array.
+//
+// The "cpu,io" pattern on the beat engine (lib/poc_beat.h). The three
+// counts are registry tunables (poc_tune); the values above are the
+// defaults.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "lib/poc_beat.h"
+
+int poc_cpu_io_beat_lcg_iters = 50;
+int poc_cpu_io_beat_write_bytes = 64;
+int poc_cpu_io_beat_flush_every = 16;
+
+int collect_cpu_io_beat(uint64_t *timings, int n) {
+    PocBeatConfig cfg;
+    poc_beat_defaults(&cfg);
+    poc_beat_parse("cpu,io", &cfg);
+    cfg.lcg_iters = poc_cpu_io_beat_lcg_iters;
+    cfg.io_bytes = poc_cpu_io_beat_write_bytes;
+    cfg.io_flush_every = poc_cpu_io_beat_flush_every;
+    return poc_beat_run(&cfg, timings, n, NULL);
+}
@@ -0,0 +1,24 @@
+// cpu_memory_beat.c — CPU/Memory cross-domain beat timing entropy collector
+// Mechanism: Allocate 16MB buffer, touch pages. Alternate: 50 LCG iterations (CPU),
+//            then random read_volatile from buffer (memory). Record both domain timings,
+//            interleave into timings array.
+//
+// The "cpu,mem" pattern on the beat engine (lib/poc_beat.h). The LCG count
+// is a registry tunable (poc_tune); 50 is the default.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "lib/poc_beat.h"
+
+#define MEM_BUF_SIZE (16 * 1024 * 1024)
+
+int poc_cpu_memory_beat_lcg_iters = 50;
+
+int collect_cpu_memory_beat(uint64_t *timings, int n) {
+    PocBeatConfig cfg;
+    poc_beat_defaults(&cfg);
+    poc_beat_parse("cpu,mem", &cfg);
+    cfg.lcg_iters = poc_cpu_memory_beat_lcg_iters;
+    cfg.mem_bytes = MEM_BUF_SIZE;
+    return poc_beat_run(&cfg, timings, n, NULL);
+}
@@ -0,0 +1,76 @@
+// dispatch_queue.c — Entropy source collector
+// Mechanism: 4 worker pthreads with pipe-based IPC, measure scheduling latency
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+
+#define NUM_WORKERS 4
+
+typedef struct {
+    int pipe_to_worker[2];   // main -> worker
+    int pipe_from_worker[2]; // worker -> main
+    volatile int running;
+} WorkerCtx;
+
+static void *worker_thread(void *arg) {
+    WorkerCtx *ctx = (WorkerCtx *)arg;
+    poc_place_worker(POC_QOS_INHERIT, 0);
+    uint64_t ts;
+    while (ctx->running) {
+        ssize_t r = read(ctx->pipe_to_worker[0], &ts, sizeof(ts));
+        if (r != sizeof(ts)) break;
+        uint64_t now = mach_absolute_time();
+        uint64_t latency = now - ts;
+        write(ctx->pipe_from_worker[1], &latency, sizeof(latency));
+    }
+    poc_place_worker_done();
+    return NULL;
+}
+
+static WorkerCtx g_workers[NUM_WORKERS];
+static pthread_t g_threads[NUM_WORKERS];
+static int g_workers_started = 0;
+
+static void start_workers(void) {
+    if (g_workers_started) return;
+    for (int i = 0; i < NUM_WORKERS; i++) {
+        pipe(g_workers[i].pipe_to_worker);
+        pipe(g_workers[i].pipe_from_worker);
+        g_workers[i].running = 1;
+        pthread_create(&g_threads[i], NULL, worker_thread, &g_workers[i]);
+    }
+    g_workers_started = 1;
+    usleep(10000); // Let workers settle
+}
+
+void release_dispatch_queue(void) {
+    if (!g_workers_started) return;
+    for (int i = 0; i < NUM_WORKERS; i++) {
+        g_workers[i].running = 0;
+        close(g_workers[i].pipe_to_worker[1]);
+        pthread_join(g_threads[i], NULL);
+        close(g_workers[i].pipe_to_worker[0]);
+        close(g_workers[i].pipe_from_worker[0]);
+        close(g_workers[i].pipe_from_worker[1]);
+    }
+    g_workers_started = 0;
+}
+
+int collect_dispatch_queue(uint64_t *timings, int n) {
+    start_workers();
+    int valid = 0;
+
+    for (int i = 0; i < n; i++) {
+        int w = i % NUM_WORKERS;
+        uint64_t ts = mach_absolute_time();
+        ssize_t wr = write(g_workers[w].pipe_to_worker[1], &ts, sizeof(ts));
+        if (wr != sizeof(ts)) continue;
+
+        uint64_t latency;
+        ssize_t rd = read(g_workers[w].pipe_from_worker[0], &latency, sizeof(latency));
+        if (rd == sizeof(latency)) {
+            timings[valid++] = latency;
+        }
+    }
+    return valid;
+}
@@ -0,0 +1,298 @@
+// dram_row_buffer.c — Entropy source collector
+// Mechanism: Allocate 32MB buffer, random reads from 2 distant locations, measure timing
+//
+// With POC_HEATMAP naming a poc_numa_asymmetry --map file, the two reads
+// come from two different slices among the map's highest-variance ones
+// (lib/poc_heatmap.h) instead of the two halves of the buffer.
+//
+// collect_dram_row_conflict() makes every read a row conflict on purpose.
+// Physical addresses are not visible from user space, so the mapping is
+// done by timing: two flushed lines read back to back are slow when they
+// sit in the same bank but different rows. poc_dram_map() calibrates the
+// hit / conflict latency split on page pairs; the result is cached for the
+// current boot in $POC_DRAM_MAP (default /tmp/poc_dram_map.txt). A split
+// counts only when the slow cluster is both DRAM_MIN_SPLIT slower and at
+// least DRAM_MIN_SLOW_FRAC of the probed pages, so a handful of outliers
+// cannot pass for a conflict cluster. With the threshold known,
+// the collector scans its own buffer for page pairs above it — those pages
+// differ per process, so that part is redone per buffer — and each sample
+// reads one such pair at a shared random in-page offset, both lines
+// flushed first.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "lib/poc_heatmap.h"
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+#define DRAM_BUF_SIZE (32 * 1024 * 1024)
+#define DRAM_HOT_SLICES 4
+#define DRAM_CAL_ROUNDS 16      // median of this many per pair while mapping
+#define DRAM_SCAN_ROUNDS 8      // per pair while scanning the buffer
+#define DRAM_SCAN_BASES 8       // base pages scanned for partners
+#define DRAM_MAX_PAIRS 512
+#define DRAM_MIN_SPLIT 1.15     // conflict cluster must be this much slower
+#define DRAM_MIN_SLOW_FRAC 0.05 // ... and hold at least this share of the probes
+
+static volatile uint8_t *g_dram_buf = NULL;
+static uint64_t g_hot[DRAM_HOT_SLICES];
+static int g_n_hot;
+static size_t g_slice_bytes;
+
+typedef struct {
+    uint32_t a, b;      // page indices into g_dram_buf
+} ConflictPair;
+
+static ConflictPair g_pairs[DRAM_MAX_PAIRS];
+static int g_n_pairs = -1;      // -1 = not scanned yet
+static PocDramMap g_map;
+
+static void ensure_dram_buf(void) {
+    if (g_dram_buf) return;
+    g_dram_buf = (volatile uint8_t *)mmap(NULL, DRAM_BUF_SIZE,
+        PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
+    if (g_dram_buf == MAP_FAILED) {
+        g_dram_buf = NULL;
+        return;
+    }
+    // Touch every page to populate
+    long page_size = sysconf(_SC_PAGESIZE);
+    for (size_t off = 0; off < DRAM_BUF_SIZE; off += (size_t)page_size) {
+        ((volatile uint8_t *)g_dram_buf)[off] = (uint8_t)(off & 0xFF);
+    }
+    g_n_hot = poc_heatmap_env_slices(DRAM_BUF_SIZE, g_hot, DRAM_HOT_SLICES, &g_slice_bytes);
+}
+
+int collect_dram_row_buffer(uint64_t *timings, int n) {
+    ensure_dram_buf();
+    if (!g_dram_buf) return 0;
+
+    uint64_t lcg = mach_absolute_time();
+    int valid = 0;
+
+    for (int i = 0; i < n; i++) {
+        size_t off1, off2;
+        if (g_n_hot >= 2) {
+            // Two distinct high-variance slices
+            int a = (int)(lcg_next(&lcg) % g_n_hot);
+            int b = (a + 1 + (int)(lcg_next(&lcg) % (g_n_hot - 1))) % g_n_hot;
+            off1 = g_hot[a] + (size_t)(lcg_next(&lcg) % g_slice_bytes);
+            off2 = g_hot[b] + (size_t)(lcg_next(&lcg) % g_slice_bytes);
+        } else {
+            // Two distant random locations (at least 16MB apart)
+            off1 = (size_t)(lcg_next(&lcg) % (DRAM_BUF_SIZE / 2));
+            off2 = (DRAM_BUF_SIZE / 2) + (size_t)(lcg_next(&lcg) % (DRAM_BUF_SIZE / 2));
+        }
+
+        uint64_t t0 = mach_absolute_time();
+        volatile uint8_t v1 = g_dram_buf[off1];
+        volatile uint8_t v2 = g_dram_buf[off2];
+        uint64_t t1 = mach_absolute_time();
+        (void)v1; (void)v2;
+
+        timings[valid++] = t1 - t0;
+    }
+    return valid;
+}
+
+void release_dram_row_buffer(void) {
+    if (g_dram_buf) munmap((void *)g_dram_buf, DRAM_BUF_SIZE);
+    g_dram_buf = NULL;
+    g_n_hot = 0;
+    g_n_pairs = -1;
+}
+
+// --- Row-conflict mapping -------------------------------------------------
+
+static inline void flush_line(const volatile void *p) {
+#if defined(__aarch64__)
+    __asm__ volatile("dc civac, %0" : : "r"(p) : "memory");  // EL0 on macOS
+#elif defined(__x86_64__)
+    __asm__ volatile("clflush (%0)" : : "r"(p) : "memory");
+#else
+    (void)p;
+#endif
+}
+
+static inline void mem_barrier(void) {
+#if defined(__aarch64__)
+    __asm__ volatile("dsb sy\nisb" : : : "memory");
+#elif defined(__x86_64__)
+    __asm__ volatile("mfence" : : : "memory");
+#else
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+// One flushed back-to-back read of a and b, in ticks.
+static inline uint64_t pair_once(const volatile uint8_t *a, const volatile uint8_t *b) {
+    flush_line(a);
+    flush_line(b);
+    mem_barrier();
+    uint64_t t0 = mach_absolute_time();
+    volatile uint8_t v1 = *a;
+    volatile uint8_t v2 = *b;
+    uint64_t t1 = mach_absolute_time();
+    (void)v1;
+    (void)v2;
+    return t1 - t0;
+}
+
+static int cmp_u64(const void *x, const void *y) {
+    uint64_t a = *(const uint64_t *)x, b = *(const uint64_t *)y;
+    return a < b ? -1 : a > b;
+}
+
+static uint64_t pair_median(const volatile uint8_t *a, const volatile uint8_t *b, int rounds) {
+    uint64_t t[DRAM_CAL_ROUNDS];
+    if (rounds > DRAM_CAL_ROUNDS) rounds = DRAM_CAL_ROUNDS;
+    for (int r = 0; r < rounds; r++) t[r] = pair_once(a, b);
+    qsort(t, (size_t)rounds, sizeof(uint64_t), cmp_u64);
+    return t[rounds / 2];
+}
+
+// Two-means split of sorted latencies; returns the threshold, the two
+// cluster means and the slow cluster's size.
+static uint64_t split_clusters(const uint64_t *sorted, int n, double *lo, double *hi,
+                               int *n_hi) {
+    double thr = (double)(sorted[0] + sorted[n - 1]) / 2;
+    for (int it = 0; it < 32; it++) {
+        double s0 = 0, s1 = 0;
+        int n0 = 0, n1 = 0;
+        for (int i = 0; i < n; i++) {
+            if (sorted[i] <= thr) { s0 += sorted[i]; n0++; }
+            else { s1 += sorted[i]; n1++; }
+        }
+        *lo = n0 ? s0 / n0 : thr;
+        *hi = n1 ? s1 / n1 : thr;
+        *n_hi = n1;
+        double next = (*lo + *hi) / 2;
+        if (next == thr) break;
+        thr = next;
+    }
+    return (uint64_t)thr;
+}
+
+static void boot_id(char *buf, size_t len) {
+    snprintf(buf, len, "unknown");
+#if defined(__APPLE__)
+    struct timeval tv;
+    size_t sz = sizeof(tv);
+    if (sysctlbyname("kern.boottime", &tv, &sz, NULL, 0) == 0)
+        snprintf(buf, len, "%ld", (long)tv.tv_sec);
+#else
+    FILE *f = fopen("/proc/sys/kernel/random/boot_id", "r");
+    if (f) {
+        if (fgets(buf, (int)len, f)) buf[strcspn(buf, "\n")] = 0;
+        fclose(f);
+    }
+#endif
+}
+
+static const char *map_path(void) {
+    const char *p = getenv("POC_DRAM_MAP");
+    return p && *p ? p : POC_DRAM_MAP_DEFAULT;
+}
+
+static int load_map(PocDramMap *m) {
+    FILE *f = fopen(map_path(), "r");
+    if (!f) return -1;
+    char boot[64], want[64];
+    unsigned long long hit, conflict, thr;
+    int page, valid;
+    int got = fscanf(f, "boot %63s page %d hit %llu conflict %llu threshold %llu valid %d",
+                     boot, &page, &hit, &conflict, &thr, &valid);
+    fclose(f);
+    boot_id(want, sizeof(want));
+    if (got != 6 || strcmp(boot, want) != 0 || page != (int)sysconf(_SC_PAGESIZE)) return -1;
+    *m = (PocDramMap){hit, conflict, thr, page, valid};
+    return 0;
+}
+
+static void save_map(const PocDramMap *m) {
+    FILE *f = fopen(map_path(), "w");
+    if (!f) return;
+    char boot[64];
+    boot_id(boot, sizeof(boot));
+    fprintf(f, "boot %s page %d hit %llu conflict %llu threshold %llu valid %d\n",
+            boot, m->page_size, (unsigned long long)m->hit_ticks,
+            (unsigned long long)m->conflict_ticks, (unsigned long long)m->threshold_ticks,
+            m->valid);
+    fclose(f);
+}
+
+static void measure_map(PocDramMap *m) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    int npages = (int)(DRAM_BUF_SIZE / page);
+    memset(m, 0, sizeof(*m));
+    m->page_size = (int)page;
+
+    // Page 0 against every other page: same-bank pages form the slow cluster
+    uint64_t *lat = malloc((size_t)npages * sizeof(uint64_t));
+    if (!lat) return;
+    for (int p = 1; p < npages; p++)
+        lat[p - 1] = pair_median(g_dram_buf, g_dram_buf + (size_t)p * page, DRAM_CAL_ROUNDS);
+    qsort(lat, (size_t)npages - 1, sizeof(uint64_t), cmp_u64);
+    double lo, hi;
+    int n_slow;
+    m->threshold_ticks = split_clusters(lat, npages - 1, &lo, &hi, &n_slow);
+    m->hit_ticks = (uint64_t)lo;
+    m->conflict_ticks = (uint64_t)hi;
+    free(lat);
+    m->valid = lo > 0 && hi >= lo * DRAM_MIN_SPLIT &&
+               n_slow >= DRAM_MIN_SLOW_FRAC * (npages - 1);
+}
+
+int poc_dram_map(PocDramMap *m, int force) {
+    ensure_dram_buf();
+    if (!g_dram_buf) return -1;
+    if (force || load_map(&g_map) != 0) {
+        measure_map(&g_map);
+        save_map(&g_map);
+    }
+    if (m) *m = g_map;
+    return g_map.valid ? 0 : -1;
+}
+
+// Pages of this buffer whose pair latency with a base page is over the
+// threshold, DRAM_SCAN_BASES bases spread over the buffer.
+static void scan_pairs(void) {
+    g_n_pairs = 0;
+    if (poc_dram_map(NULL, 0) != 0) return;
+    size_t page = (size_t)g_map.page_size;
+    int npages = (int)(DRAM_BUF_SIZE / page);
+    for (int b = 0; b < DRAM_SCAN_BASES && g_n_pairs < DRAM_MAX_PAIRS; b++) {
+        int base = b * (npages / DRAM_SCAN_BASES);
+        for (int p = 0; p < npages && g_n_pairs < DRAM_MAX_PAIRS; p++) {
+            if (p == base) continue;
+            uint64_t t = pair_median(g_dram_buf + (size_t)base * page,
+                                     g_dram_buf + (size_t)p * page, DRAM_SCAN_ROUNDS);
+            if (t > g_map.threshold_ticks)
+                g_pairs[g_n_pairs++] = (ConflictPair){(uint32_t)base, (uint32_t)p};
+        }
+    }
+}
+
+int poc_dram_conflict_pairs(void) {
+    ensure_dram_buf();
+    if (!g_dram_buf) return 0;
+    if (g_n_pairs < 0) scan_pairs();
+    return g_n_pairs;
+}
+
+int collect_dram_row_conflict(uint64_t *timings, int n) {
+    if (poc_dram_conflict_pairs() == 0) return collect_dram_row_buffer(timings, n);
+
+    size_t page = (size_t)g_map.page_size;
+    uint64_t lcg = mach_absolute_time();
+    for (int i = 0; i < n; i++) {
+        const ConflictPair *cp = &g_pairs[lcg_next(&lcg) % g_n_pairs];
+        // Same offset in both pages keeps the in-page bank bits equal
+        size_t off = (size_t)(lcg_next(&lcg) % (page / 64)) * 64;
+        timings[i] = pair_once(g_dram_buf + (size_t)cp->a * page + off,
+                               g_dram_buf + (size_t)cp->b * page + off);
+    }
+    return n;
+}
@@ -0,0 +1,227 @@
+// dvfs_race.c — DVFS frequency race timing entropy collector
+// Mechanism: 2 threads run tight counting loops, measure abs_diff of counts
+//
+// poc_dvfs_race_pairs() runs one racer pair per cluster combination (P/P,
+// P/E, E/E) at once instead. The racers stay up for the whole run, each
+// storing its count to its own 128-byte line, and a sampler reads all the
+// counters every window and works out the count differences in batches.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include <stdatomic.h>
+
+struct race_ctx {
+    atomic_uint_fast64_t counter_a;
+    atomic_uint_fast64_t counter_b;
+    atomic_int ready_a;
+    atomic_int ready_b;
+    atomic_int stop;
+};
+
+static void *racer_a(void *arg) {
+    struct race_ctx *ctx = (struct race_ctx *)arg;
+    poc_place_worker(POC_QOS_INHERIT, 0);
+    atomic_store(&ctx->ready_a, 1);
+    // Spin until both ready
+    while (!atomic_load(&ctx->ready_b)) {}
+
+    while (!atomic_load(&ctx->stop)) {
+        atomic_fetch_add(&ctx->counter_a, 1);
+    }
+    poc_place_worker_done();
+    return NULL;
+}
+
+static void *racer_b(void *arg) {
+    struct race_ctx *ctx = (struct race_ctx *)arg;
+    poc_place_worker(POC_QOS_INHERIT, 0);
+    atomic_store(&ctx->ready_b, 1);
+    // Spin until both ready
+    while (!atomic_load(&ctx->ready_a)) {}
+
+    while (!atomic_load(&ctx->stop)) {
+        atomic_fetch_add(&ctx->counter_b, 1);
+    }
+    poc_place_worker_done();
+    return NULL;
+}
+
+int collect_dvfs_race(uint64_t *timings, int n) {
+    int valid = 0;
+    uint64_t prev_diff = 0;
+
+    for (int i = 0; i < n + 1; i++) {
+        struct race_ctx ctx;
+        atomic_store(&ctx.counter_a, 0);
+        atomic_store(&ctx.counter_b, 0);
+        atomic_store(&ctx.ready_a, 0);
+        atomic_store(&ctx.ready_b, 0);
+        atomic_store(&ctx.stop, 0);
+
+        pthread_t ta, tb;
+        pthread_create(&ta, NULL, racer_a, &ctx);
+        pthread_create(&tb, NULL, racer_b, &ctx);
+
+        // Wait for both threads to be ready
+        while (!atomic_load(&ctx.ready_a) || !atomic_load(&ctx.ready_b)) {}
+
+        // Let them race for ~2 microseconds (approx 48 mach ticks at 24MHz timebase)
+        uint64_t start = mach_absolute_time();
+        while ((mach_absolute_time() - start) < 48) {}
+
+        atomic_store(&ctx.stop, 1);
+
+        pthread_join(ta, NULL);
+        pthread_join(tb, NULL);
+
+        uint64_t ca = atomic_load(&ctx.counter_a);
+        uint64_t cb = atomic_load(&ctx.counter_b);
+        uint64_t diff = (ca > cb) ? (ca - cb) : (cb - ca);
+
+        // XOR adjacent diffs for better entropy extraction
+        if (i > 0) {
+            timings[valid++] = diff ^ prev_diff;
+        }
+        prev_diff = diff;
+
+        if (valid >= n) break;
+    }
+    return valid;
+}
+
+// --- padded racer pairs, one per cluster combination ---------------------------
+
+#define DVFS_BATCH 1024
+
+// One racer's counter, alone on its 128-byte line (the M-series line size),
+// so the sampler's reads and the other racers' stores never touch it.
+typedef struct {
+    _Alignas(128) _Atomic uint64_t count;
+} PaddedCounter;
+
+typedef struct {
+    PaddedCounter *counter;
+    atomic_int *stop;
+    atomic_int *ready;
+    PocQos qos;
+    int cpu;                    // placement target; ends as the CPU it stopped on
+} PairRacer;
+
+static void *pair_racer(void *arg) {
+    PairRacer *r = arg;
+    poc_place_apply(r->qos, r->cpu + 1);
+    atomic_fetch_add(r->ready, 1);
+    // Single writer: a relaxed store, no read-modify-write on the line
+    uint64_t c = 0;
+    while (!atomic_load_explicit(r->stop, memory_order_relaxed))
+        atomic_store_explicit(&r->counter->count, ++c, memory_order_relaxed);
+    r->cpu = poc_place_cpu();
+    return NULL;
+}
+
+int poc_dvfs_pairs(PocDvfsPair pairs[POC_DVFS_MAX_PAIRS]) {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu < 1) ncpu = 1;
+    if (ncpu > 256) ncpu = 256;
+    int cpus[2][256], n_cpus[2] = {0, 0};
+    for (int c = 0; c < ncpu; c++) {
+        int k = poc_place_cluster(c) == POC_CLUSTER_E;
+        cpus[k][n_cpus[k]++] = c;
+    }
+    static const PocCluster combos[POC_DVFS_MAX_PAIRS][2] = {
+        {POC_CLUSTER_P, POC_CLUSTER_P},
+        {POC_CLUSTER_P, POC_CLUSTER_E},
+        {POC_CLUSTER_E, POC_CLUSTER_E},
+    };
+    // Hand out each cluster's CPUs in order, wrapping when a cluster has
+    // fewer CPUs than racers; a combination whose cluster is empty is left out.
+    int next[2] = {0, 0}, n = 0;
+    for (int p = 0; p < POC_DVFS_MAX_PAIRS; p++) {
+        int ka = combos[p][0] == POC_CLUSTER_E, kb = combos[p][1] == POC_CLUSTER_E;
+        if (n_cpus[ka] == 0 || n_cpus[kb] == 0) continue;
+        pairs[n].a = combos[p][0];
+        pairs[n].b = combos[p][1];
+        pairs[n].cpu_a = cpus[ka][next[ka]++ % n_cpus[ka]];
+        pairs[n].cpu_b = cpus[kb][next[kb]++ % n_cpus[kb]];
+        pairs[n].seen_a = pairs[n].seen_b = -1;
+        n++;
+    }
+    return n;
+}
+
+static PocQos cluster_qos(PocCluster c) {
+    return c == POC_CLUSTER_E ? POC_QOS_BACKGROUND : POC_QOS_USER_INTERACTIVE;
+}
+
+int poc_dvfs_race_pairs(PocDvfsPair *pairs, int n_pairs, int window_ticks, uint64_t *out,
+                        int n) {
+    if (n_pairs < 1 || n_pairs > POC_DVFS_MAX_PAIRS || window_ticks < 1 || n < 1) return -1;
+    const int n_racers = 2 * n_pairs;
+    PaddedCounter *counters = aligned_alloc(_Alignof(PaddedCounter),
+                                            sizeof(PaddedCounter) * (size_t)n_racers);
+    // Snapshots of every counter, DVFS_BATCH + 1 windows at a time
+    uint64_t *snap = malloc(sizeof(uint64_t) * (size_t)(DVFS_BATCH + 1) * (size_t)n_racers);
+    if (!counters || !snap) {
+        free(counters);
+        free(snap);
+        return -1;
+    }
+    memset(counters, 0, sizeof(PaddedCounter) * (size_t)n_racers);
+
+    _Alignas(128) atomic_int stop = 0;
+    atomic_int ready = 0;
+    PairRacer racers[2 * POC_DVFS_MAX_PAIRS];
+    pthread_t tids[2 * POC_DVFS_MAX_PAIRS];
+    int started = 0;
+    for (; started < n_racers; started++) {
+        const PocDvfsPair *p = &pairs[started / 2];
+        PocCluster c = started % 2 ? p->b : p->a;
+        racers[started] = (PairRacer){&counters[started], &stop, &ready, cluster_qos(c),
+                                      started % 2 ? p->cpu_b : p->cpu_a};
+        if (pthread_create(&tids[started], NULL, pair_racer, &racers[started]) != 0) break;
+    }
+    while (atomic_load(&ready) < started) {}
+
+    // Every pair races in every window. The sampler only reads counters
+    // while the windows run and turns a batch into samples between them;
+    // each batch starts from a fresh snapshot, so the time spent converting
+    // never lands in a window.
+    uint64_t prev_diff[POC_DVFS_MAX_PAIRS] = {0};
+    int valid = 0, batch_start = 1;
+    while (started == n_racers && valid < n) {
+        int windows = n - valid + batch_start < DVFS_BATCH ? n - valid + batch_start
+                                                           : DVFS_BATCH;
+        for (int r = 0; r < n_racers; r++)
+            snap[r] = atomic_load_explicit(&counters[r].count, memory_order_relaxed);
+        for (int w = 1; w <= windows; w++) {
+            uint64_t t0 = mach_absolute_time();
+            while (mach_absolute_time() - t0 < (uint64_t)window_ticks) {}
+            uint64_t *row = snap + (size_t)w * n_racers;
+            for (int r = 0; r < n_racers; r++)
+                row[r] = atomic_load_explicit(&counters[r].count, memory_order_relaxed);
+        }
+        for (int w = 1; w <= windows; w++) {
+            const uint64_t *row = snap + (size_t)w * n_racers, *last = row - n_racers;
+            for (int p = 0; p < n_pairs; p++) {
+                uint64_t da = row[2 * p] - last[2 * p];
+                uint64_t db = row[2 * p + 1] - last[2 * p + 1];
+                uint64_t diff = da > db ? da - db : db - da;
+                // XOR adjacent diffs, as collect_dvfs_race() does
+                if (!(batch_start && w == 1)) out[(size_t)p * n + valid] = diff ^ prev_diff[p];
+                prev_diff[p] = diff;
+            }
+            if (!(batch_start && w == 1)) valid++;
+        }
+        batch_start = 0;
+    }
+
+    atomic_store(&stop, 1);
+    for (int r = 0; r < started; r++) pthread_join(tids[r], NULL);
+    for (int r = 0; r < started; r++) {
+        if (r % 2) pairs[r / 2].seen_b = racers[r].cpu;
+        else pairs[r / 2].seen_a = racers[r].cpu;
+    }
+    free(counters);
+    free(snap);
+    return started == n_racers ? 0 : -1;
+}
@@ -0,0 +1,28 @@
+// dyld_timing.c — Entropy source collector
+// Mechanism: dlopen/dlclose system libraries in a cycle, measure timing
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include <dlfcn.h>
+
+static const char *g_libs[] = {
+    "/usr/lib/libz.dylib",
+    "/usr/lib/libc++.dylib",
+    "/usr/lib/libobjc.dylib",
+    "/usr/lib/libSystem.B.dylib",
+};
+static const int g_nlibs = 4;
+
+int collect_dyld_timing(uint64_t *timings, int n) {
+    int valid = 0;
+    for (int i = 0; i < n; i++) {
+        const char *lib = g_libs[i % g_nlibs];
+        uint64_t t0 = mach_absolute_time();
+        void *h = dlopen(lib, RTLD_LAZY | RTLD_NOLOAD);
+        if (!h) h = dlopen(lib, RTLD_LAZY);
+        if (h) dlclose(h);
+        uint64_t t1 = mach_absolute_time();
+        timings[valid++] = t1 - t0;
+    }
+    return valid;
+}
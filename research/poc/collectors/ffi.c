@@ -0,0 +1,54 @@
+// ffi.c — C ABI over the registry for openentropy-core
+//
+// The Rust wrappers hold an index from poc_ffi_find() and a parameter set
+// built once, and call poc_ffi_collect() into a reused buffer, so a
+// collection allocates nothing on the C side beyond what the collector
+// itself does.
+//
+// Nothing on the Rust side keeps two sources from collecting at once, and
+// the collectors keep their state in statics shared by every collector of
+// their object file. Each call therefore holds its group's mutex while it
+// writes the tunables and collects.
+
+#include "collectors/collectors.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t *g_locks;    // one per registry index; groups use their first
+
+static void locks_init(void) {
+    g_locks = malloc(sizeof(*g_locks) * (size_t)poc_n_collectors);
+    if (!g_locks) return;
+    for (int i = 0; i < poc_n_collectors; i++) pthread_mutex_init(&g_locks[i], NULL);
+}
+
+int poc_ffi_find(const char *name) {
+    if (!name) return -1;
+    const PocCollector *c = poc_collector_find(name);
+    return c ? (int)(c - poc_collectors) : -1;
+}
+
+int poc_ffi_collect(int index, uint64_t *out, int n, const PocFfiParams *params) {
+    if (index < 0 || index >= poc_n_collectors || !out || n <= 0) return -1;
+    pthread_once(&g_once, locks_init);
+    if (!g_locks) return -1;
+    const PocCollector *c = &poc_collectors[index];
+
+    for (int i = 0; params && i < params->count; i++)
+        if (!poc_param_find(c->name, params->items[i].name)) return -1;
+
+    pthread_mutex_t *lock = &g_locks[poc_collector_group(c)];
+    pthread_mutex_lock(lock);
+    for (int i = 0; params && i < params->count; i++) {
+        const PocParam *p = poc_param_find(c->name, params->items[i].name);
+        int v = params->items[i].value;
+        *p->value = v < p->min ? p->min : v > p->max ? p->max : v;
+    }
+    int got = poc_collect(c, out, n);
+    pthread_mutex_unlock(lock);
+    return got;
+}
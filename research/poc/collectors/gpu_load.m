@@ -0,0 +1,86 @@
+// gpu_load.m — Metal compute for the lib/poc_load.h gpu profile and the
+// lib/poc_beat.h gpu domain
+//
+// lib/ is plain C, so the GPU work lives here and is handed over as hooks.
+// One burst is a dispatch of GPU_THREADS threads that each run 256
+// dependent FMAs on their own float of one buffer, committed and waited
+// for. Back to back, that keeps the GPU busy and its clients (DART, SLC,
+// fabric) loaded while a collector runs. A beat tick is the same kernel
+// over one threadgroup, GPU_BEAT_THREADS threads, so it is a short
+// submit-to-completion round trip.
+
+#import <Foundation/Foundation.h>
+#import <Metal/Metal.h>
+
+#include "collectors/collectors.h"
+#include "lib/poc_beat.h"
+#include "lib/poc_load.h"
+
+#define GPU_THREADS (1 << 20)
+#define GPU_BEAT_THREADS 256
+
+static id<MTLCommandQueue> g_queue;
+static id<MTLComputePipelineState> g_pipe;
+static id<MTLBuffer> g_buf;
+static int g_tried;
+
+static NSString *const kKernel =
+    @"#include <metal_stdlib>\n"
+     "kernel void burn(device float *x [[buffer(0)]], uint i [[thread_position_in_grid]]) {\n"
+     "    float v = x[i];\n"
+     "    for (int k = 0; k < 256; k++) v = fma(v, 0.999f, 0.001f);\n"
+     "    x[i] = v;\n"
+     "}\n";
+
+static int gpu_dispatch(NSUInteger threads) {
+    @autoreleasepool {
+        id<MTLCommandBuffer> cb = [g_queue commandBuffer];
+        id<MTLComputeCommandEncoder> enc = [cb computeCommandEncoder];
+        [enc setComputePipelineState:g_pipe];
+        [enc setBuffer:g_buf offset:0 atIndex:0];
+        NSUInteger w = g_pipe.maxTotalThreadsPerThreadgroup;
+        [enc dispatchThreads:MTLSizeMake(threads, 1, 1)
+            threadsPerThreadgroup:MTLSizeMake(w < 256 ? w : 256, 1, 1)];
+        [enc endEncoding];
+        [cb commit];
+        [cb waitUntilCompleted];
+        return cb.status == MTLCommandBufferStatusCompleted ? 0 : -1;
+    }
+}
+
+static int gpu_burst(void) {
+    return gpu_dispatch(GPU_THREADS);
+}
+
+static int gpu_tick(void) {
+    return gpu_dispatch(GPU_BEAT_THREADS);
+}
+
+static int gpu_init(void) {
+    if (!g_tried) {
+        g_tried = 1;
+        @autoreleasepool {
+            NSError *err = nil;
+            id<MTLDevice> dev = MTLCreateSystemDefaultDevice();
+            id<MTLLibrary> lib = [dev newLibraryWithSource:kKernel options:nil error:&err];
+            id<MTLFunction> fn = [lib newFunctionWithName:@"burn"];
+            if (fn) g_pipe = [dev newComputePipelineStateWithFunction:fn error:&err];
+            g_queue = [dev newCommandQueue];
+            g_buf = [dev newBufferWithLength:GPU_THREADS * sizeof(float)
+                                     options:MTLResourceStorageModeShared];
+        }
+    }
+    return g_pipe && g_queue && g_buf ? 0 : -1;
+}
+
+int poc_gpu_load_install(void) {
+    if (gpu_init() != 0) return -1;
+    poc_load_set_gpu(gpu_burst);
+    return 0;
+}
+
+int poc_gpu_beat_install(void) {
+    if (gpu_init() != 0) return -1;
+    poc_beat_set_gpu(gpu_tick);
+    return 0;
+}
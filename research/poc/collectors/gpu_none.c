@@ -0,0 +1,14 @@
+// gpu_none.c — The gpu_load hooks where collectors/gpu_load.m is not built
+//
+// Without Metal there is no GPU work to hand to lib/poc_load.h or
+// lib/poc_beat.h, so both installs fail and the gpu profile and domain
+// stay unavailable, as on a Mac without a Metal device.
+
+#include "collectors/collectors.h"
+
+#if !defined(__APPLE__)
+
+int poc_gpu_load_install(void) { return -1; }
+int poc_gpu_beat_install(void) { return -1; }
+
+#endif
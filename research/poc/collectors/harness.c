@@ -0,0 +1,258 @@
+// harness.c — Standard validation harness shared by every registry collector
+//
+// Test 1: large-sample entropy, with the SP 800-90B estimator suite
+// (lib/poc_estimators.h) on the folded bytes. Test 2: lag 1-5 autocorrelation plus the
+// long-range FFT screen. Test 3: N_TRIALS stability trials (sequential
+// under POC_SEQUENTIAL, lib/poc_seqtrial.h). Test 4: Pearson and lagged
+// cross-correlation against the entry's .cross partners. Then the CUT /
+// DEMOTE / KEEP verdict.
+//
+// Sample buffers are process-wide slices of one PocSampleArena
+// (lib/poc_arena.h), sized for the largest counts in the registry, so a
+// poc_runner sweep over the whole catalog maps, pre-faults and locks them
+// once and no collection takes a first-touch fault. Test 4 reuses the head
+// of the Test 1 samples instead of collecting the source again.
+//
+// POC_CAPTURE_DIR=<dir> tapes every source to <dir>/<name>.oeraw
+// (lib/poc_capture.h). Samples already on tape are replayed zero-copy from
+// the mapping; anything beyond the tape is collected live and appended, so
+// the first run pays for collection and later runs only re-analyse.
+
+#include <errno.h>
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "lib/poc_arena.h"
+
+static PocSampleArena g_arena;
+static uint64_t *g_main_buf, *g_aux_buf;
+static uint8_t *g_fold_buf;
+
+typedef struct {
+    const PocCollector *c;
+    PocCapture tape;        // samples on disk at open time
+    PocCaptureWriter out;   // appends live samples
+    uint64_t cursor;        // next tape sample to replay
+    int warmed;
+} Tape;
+
+static Tape g_tapes[64];
+static int g_n_tapes;
+
+// Carve the Test 1 and Test 3/4 buffers (and Test 1's folded bytes) for
+// the largest counts any registry entry asks for. -1 if mapping fails.
+static int buffers_init(void) {
+    if (g_main_buf) return 0;
+    int large = LARGE_N, aux = TRIAL_N > 5000 ? TRIAL_N : 5000;
+    for (int i = 0; i < poc_n_collectors; i++) {
+        const PocCollector *c = &poc_collectors[i];
+        if (c->large_n > large) large = c->large_n;
+        if (c->trial_n > aux) aux = c->trial_n;
+        if (c->cc_n > aux) aux = c->cc_n;
+    }
+    size_t bytes = ((size_t)large + aux) * sizeof(uint64_t) + (size_t)large + 3 * 64;
+    if (poc_samples_init(&g_arena, bytes) != 0) return -1;
+    if (!g_arena.locked)
+        fprintf(stderr, "  sample arena pre-faulted but not locked (RLIMIT_MEMLOCK)\n");
+    g_main_buf = POC_SAMPLES_U64(&g_arena, large);
+    g_aux_buf = POC_SAMPLES_U64(&g_arena, aux);
+    g_fold_buf = POC_SAMPLES_U8(&g_arena, large);
+    return 0;
+}
+
+static Tape *tape_for(const PocCollector *c) {
+    for (int i = 0; i < g_n_tapes; i++)
+        if (g_tapes[i].c == c) return &g_tapes[i];
+    if (g_n_tapes == (int)(sizeof(g_tapes) / sizeof(g_tapes[0]))) return NULL;
+    Tape *t = &g_tapes[g_n_tapes++];
+    memset(t, 0, sizeof(*t));
+    t->c = c;
+    t->out.fd = -1;
+
+    const char *dir = getenv("POC_CAPTURE_DIR");
+    if (dir && *dir) {
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s.oeraw", dir, c->name);
+        poc_capture_map(&t->tape, path); // absent on the first run
+        if (poc_capture_open(&t->out, path, c->name) != 0)
+            fprintf(stderr, "  capture %s: %s (collecting live only)\n", path, strerror(errno));
+    }
+    return t;
+}
+
+// n samples of c: a zero-copy slice of its tape when the tape still has
+// them, otherwise a live collection into buf (taped when capturing).
+// One warmup pass precedes a source's first live collection, so first-call
+// setup (page faults, worker spawn, dyld binding) stays out of the tests.
+static const uint64_t *draw(const PocCollector *c, uint64_t *buf, int n, int *got) {
+    Tape *t = tape_for(c);
+    if (t && t->cursor + (uint64_t)n <= t->tape.n) {
+        const uint64_t *p = t->tape.samples + t->cursor;
+        t->cursor += (uint64_t)n;
+        *got = n;
+        return p;
+    }
+    if (t && !t->warmed) {
+        int warm_n = (c->trial_n ? c->trial_n : TRIAL_N) / 10;
+        poc_collect(c, buf, warm_n < n ? (warm_n > 0 ? warm_n : 1) : n);
+        t->warmed = 1;
+    }
+    *got = poc_collect(c, buf, n);
+    if (t && t->out.fd >= 0 && *got > 0) poc_capture_append(&t->out, buf, *got);
+    return buf;
+}
+
+static void print_count(const char *fmt, int n) {
+    char num[16];
+    if (n >= 1000 && n % 1000 == 0)
+        snprintf(num, sizeof(num), "%dK", n / 1000);
+    else
+        snprintf(num, sizeof(num), "%d", n);
+    printf(fmt, num);
+}
+
+int poc_validate(const PocCollector *c) {
+    const int large_n = c->large_n ? c->large_n : LARGE_N;
+    const int trial_n = c->trial_n ? c->trial_n : TRIAL_N;
+    int cc_n = c->cc_n ? c->cc_n : 5000;
+
+    poc_params_apply_env();
+    print_validation_header(c->name);
+    if (run_soak_if_requested(c->name, c->collect)) return 0;
+    if (c->note) {
+        printf("  NOTE: ");
+        printf(c->note, large_n);
+        printf("\n\n");
+    }
+
+    if (buffers_init() != 0) {
+        printf("  FAIL: cannot map %d-sample buffers\n", large_n);
+        return 1;
+    }
+    uint64_t *main_buf = g_main_buf, *aux_buf = g_aux_buf;
+
+    // === Test 1: Large sample entropy ===
+    print_count("=== Test 1: %s Sample Entropy ===\n", large_n);
+    int valid;
+    const uint64_t *timings = draw(c, main_buf, large_n, &valid);
+    if (valid < POC_MIN_VALID) {
+        if (!c->demote_if_short) {
+            printf("  FAIL: Only got %d samples (need >= %d)\n", valid, POC_MIN_VALID);
+            return 1;
+        }
+        printf("  WARNING: Only got %d changing values (need >= %d)\n", valid, POC_MIN_VALID);
+        printf("  Automatic DEMOTE: insufficient changing values\n\n");
+        printf("=== SUMMARY ===\n");
+        printf("  Samples: %d\n", valid);
+        printf("  VERDICT: DEMOTE (fewer than %d changing values)\n\n", POC_MIN_VALID);
+        if (c->release) c->release();
+        return 0;
+    }
+    Stats s = compute_stats(timings, valid);
+    printf("  Samples: %d  Mean=%.1f  StdDev=%.1f\n", valid, s.mean, s.stddev);
+    printf("  Shannon=%.3f  H_inf=%.3f\n", s.shannon, s.min_entropy);
+    PocEstimates est = {.floor = -1};
+    poc_xorfold(timings, g_fold_buf, valid);
+    if (poc_estimate_all(g_fold_buf, valid, &est) == 0) poc_print_estimates(&est);
+    printf("\n");
+
+    // === Test 2: Autocorrelation (lag 1-5) ===
+    printf("=== Test 2: Autocorrelation (lag 1-5) ===\n");
+    double max_ac = 0;
+    static double acf[ACF_SCREEN_LAG + 1];
+    poc_acf(timings, valid, ACF_SCREEN_LAG, acf);
+    for (int lag = 1; lag <= 5; lag++) {
+        double ac = acf[lag];
+        printf("  lag-%d: %.4f%s\n", lag, ac,
+               fabs(ac) > 0.5 ? " *** HIGH ***" : fabs(ac) > 0.1 ? " * warn *" : "");
+        if (fabs(ac) > max_ac) max_ac = fabs(ac);
+    }
+    PocLagPeak pk = poc_acf_peak(acf, ACF_SCREEN_LAG);
+    printf("  peak |r| over lags 1-%d: lag-%d %.4f%s\n", ACF_SCREEN_LAG, pk.lag, pk.r,
+           fabs(pk.r) > 0.1 ? " * periodic coupling *" : "");
+    printf("\n");
+
+    // === Test 3: Stability ===
+    // Sequential mode stops as soon as the σ interval clears both verdict
+    // thresholds, and runs past N_TRIALS while it straddles one.
+    static const double std_bands[] = {1.0, 2.0};
+    const int seq_max = poc_seq_env_max();
+    if (seq_max)
+        printf("=== Test 3: Stability (sequential, %d-%d trials x %d samples) ===\n",
+               POC_SEQ_MIN_TRIALS, seq_max, trial_n);
+    else
+        printf("=== Test 3: Stability (%d trials x %d samples) ===\n", N_TRIALS, trial_n);
+    PocSeqTrials st = {0};
+    int settled = 0;
+    for (int t = 0; t < (seq_max ? seq_max : N_TRIALS); t++) {
+        int tv;
+        const uint64_t *trial = draw(c, aux_buf, trial_n, &tv);
+        Stats ts = compute_stats(trial, tv > 0 ? tv : 1);
+        poc_seq_add(&st, ts.min_entropy);
+        printf("  Trial %2d: H_inf=%.3f  Shannon=%.3f  N=%d",
+               t + 1, ts.min_entropy, ts.shannon, tv);
+        if (seq_max && st.n >= 2) {
+            double lo, hi;
+            poc_seq_std_ci(&st, &lo, &hi);
+            printf("  σ 95%% CI [%.3f, %.3f]", lo, hi);
+        }
+        printf("\n");
+        if (seq_max && (settled = poc_seq_settled(&st, std_bands, 2))) break;
+    }
+
+    const int n_trials = st.n;
+    double me_mean = st.mean;
+    double me_std = poc_seq_std(&st);
+    printf("\n  H_inf Mean=%.3f  StdDev=%.3f\n", me_mean, me_std);
+    printf("  Verdict: %s%s\n\n",
+           me_std > 2.0 ? "UNSTABLE (std > 2.0)" :
+           me_std > 1.0 ? "MARGINAL (std > 1.0)" : "STABLE",
+           !seq_max ? "" : settled ? "  (settled)" : "  (unsettled at the trial cap)");
+
+    // === Test 4: Cross-correlation ===
+    printf("=== Test 4: Cross-correlation ===\n");
+    if (valid < cc_n) cc_n = valid;
+    if (c->release) c->release(); // stop workers before partners run
+    for (int k = 0; k < POC_MAX_CROSS && c->cross[k]; k++) {
+        const PocCollector *o = poc_collector_find(c->cross[k]);
+        if (!o) {
+            printf("  vs %-25s: (skipped: not built here)\n", c->cross[k]);
+            continue;
+        }
+        int ov;
+        const uint64_t *other = draw(o, aux_buf, cc_n, &ov);
+        int use = cc_n < ov ? cc_n : ov;
+        if (use > 10) {
+            double r = pearson(timings, other, use);
+            printf("  vs %-25s: r=%.4f%s\n", o->name, r,
+                   fabs(r) > 0.3 ? " *** REDUNDANT ***" : fabs(r) > 0.1 ? " * weak *" : "");
+            print_lagged_xcorr(timings, other, use);
+        } else {
+            printf("  vs %-25s: (skipped: insufficient samples)\n", o->name);
+        }
+        if (o->release) o->release();
+    }
+    printf("\n");
+
+    // === SUMMARY ===
+    printf("=== SUMMARY ===\n");
+    print_count("  H_inf (%s): ", large_n);
+    printf("%.3f\n", s.min_entropy);
+    if (est.floor >= 0)
+        printf("  H_inf estimator floor (diagnostic, excl. MCV): %.3f\n", est.floor);
+    printf("  H_inf Mean (%d trials): %.3f\n", n_trials, me_mean);
+    printf("  H_inf StdDev: %.3f\n", me_std);
+    printf("  Max autocorr: %.4f\n", max_ac);
+
+    if (s.min_entropy < 0.5)
+        printf("  VERDICT: CUT (H_inf < 0.5)\n");
+    else if (me_std > 2.0)
+        printf("  VERDICT: CUT (unstable, std > 2.0)\n");
+    else if (s.min_entropy < 1.5 || max_ac > 0.5)
+        printf("  VERDICT: DEMOTE (weak)\n");
+    else
+        printf("  VERDICT: KEEP\n");
+    printf("\n");
+
+    return 0;
+}
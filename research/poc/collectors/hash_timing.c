@@ -0,0 +1,119 @@
+// hash_timing.c — Entropy source collector
+// Mechanism: SHA-256 hash varying-size data (32-2048 bytes) via CommonCrypto
+//
+// poc_hash_run() runs the same loop on N threads at once (distinct
+// affinity tags, user-interactive QoS), so the hashes contend for the
+// cores' SHA units, caches and memory fabric. Each worker times into its
+// own 128-byte-aligned buffer that it allocated itself; results are
+// copied out after the join, so no timing store shares a cache line with
+// another thread.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include <CommonCrypto/CommonDigest.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#define HASH_MAX_INPUT 2048
+#define CONCURRENT_THREADS 4
+
+// Returns total bytes hashed.
+static uint64_t hash_loop(uint64_t *timings, int n, uint64_t lcg) {
+    uint8_t buf[HASH_MAX_INPUT];
+    uint8_t digest[CC_SHA256_DIGEST_LENGTH];
+    uint64_t bytes = 0;
+
+    for (int i = 0; i < n; i++) {
+        int sz = 32 + (int)(lcg_next(&lcg) % 2017);
+        for (int j = 0; j < sz; j++)
+            buf[j] = (uint8_t)(lcg_next(&lcg) & 0xFF);
+
+        uint64_t t0 = mach_absolute_time();
+        CC_SHA256(buf, (CC_LONG)sz, digest);
+        uint64_t t1 = mach_absolute_time();
+        timings[i] = t1 - t0;
+        bytes += (uint64_t)sz;
+    }
+    return bytes;
+}
+
+int collect_hash_timing(uint64_t *timings, int n) {
+    hash_loop(timings, n, mach_absolute_time());
+    return n;
+}
+
+typedef struct {
+    int id;
+    int n;
+    uint64_t *timings;      // worker-private, 128-byte aligned
+    uint64_t bytes;
+    atomic_int *ready;
+    atomic_int *go;
+} HashWorker;
+
+static void *hash_worker(void *arg) {
+    HashWorker *w = arg;
+    poc_place_worker(POC_QOS_USER_INTERACTIVE, w->id + 1);
+
+    size_t sz = ((size_t)w->n * sizeof(uint64_t) + 127) & ~(size_t)127;
+    if (posix_memalign((void **)&w->timings, 128, sz) != 0) w->timings = NULL;
+    else memset(w->timings, 0, sz);   // fault the pages in before the start
+
+    atomic_fetch_add(w->ready, 1);
+    while (!atomic_load(w->go)) {}
+    uint64_t seed = mach_absolute_time() ^ ((uint64_t)w->id * 0x9E3779B97F4A7C15ULL);
+    if (w->timings) w->bytes = hash_loop(w->timings, w->n, seed);
+    poc_place_worker_done();
+    return NULL;
+}
+
+int poc_hash_run(int threads, int samples_per_thread, uint64_t *out, uint64_t *elapsed,
+                 uint64_t *bytes) {
+    if (threads < 1 || threads > POC_HASH_MAX_THREADS || samples_per_thread < 1) return -1;
+
+    atomic_int ready = 0, go = 0;
+    HashWorker w[POC_HASH_MAX_THREADS];
+    pthread_t tids[POC_HASH_MAX_THREADS];
+    int started = 0;
+    for (; started < threads; started++) {
+        w[started] = (HashWorker){started, samples_per_thread, NULL, 0, &ready, &go};
+        if (pthread_create(&tids[started], NULL, hash_worker, &w[started]) != 0) break;
+    }
+
+    while (atomic_load(&ready) < started) sched_yield();
+    uint64_t t0 = mach_absolute_time();
+    atomic_store(&go, 1);
+    for (int t = 0; t < started; t++) pthread_join(tids[t], NULL);
+    if (elapsed) *elapsed = mach_absolute_time() - t0;
+
+    int ok = started == threads;
+    uint64_t total = 0;
+    for (int t = 0; t < started; t++) {
+        if (!w[t].timings) ok = 0;
+        else if (ok)
+            memcpy(out + (size_t)t * samples_per_thread, w[t].timings,
+                   (size_t)samples_per_thread * sizeof(uint64_t));
+        total += w[t].bytes;
+        free(w[t].timings);
+    }
+    if (bytes) *bytes = total;
+    return ok ? 0 : -1;
+}
+
+// Every thread's samples, interleaved t0 s0, t1 s0, ... — N times the
+// samples of one thread per unit of wall time.
+int collect_hash_concurrent(uint64_t *timings, int n) {
+    int per = (n + CONCURRENT_THREADS - 1) / CONCURRENT_THREADS;
+    uint64_t *buf = malloc((size_t)CONCURRENT_THREADS * per * sizeof(uint64_t));
+    if (!buf) return 0;
+    if (poc_hash_run(CONCURRENT_THREADS, per, buf, NULL, NULL) != 0) {
+        free(buf);
+        return 0;
+    }
+    int valid = 0;
+    for (int s = 0; s < per && valid < n; s++)
+        for (int t = 0; t < CONCURRENT_THREADS && valid < n; t++)
+            timings[valid++] = buf[(size_t)t * per + s];
+    free(buf);
+    return valid;
+}
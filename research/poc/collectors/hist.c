@@ -0,0 +1,109 @@
+// hist.c — Per-collector call-cost and sample-value histograms (POC_HIST)
+//
+// Every registry program collects through poc_collect(). With
+// POC_HIST=<path> set, each call's duration goes into that collector's
+// call histogram, its duration per returned sample into a second one, and
+// every sample value into a third (lib/poc_hist.h). The report is written
+// to <path> at exit as poc_hist_v1 JSON, which `openentropy telemetry
+// --poc-hist <path>` reads. Without POC_HIST, poc_collect() is the
+// collector call plus one predictable branch.
+//
+// Histograms are per collector and are not locked. poc_ffi_collect()
+// (collectors/ffi.c) holds the collector's group mutex around the call,
+// and every other poc_collect() caller collects from a single thread, so
+// no two threads ever record into one collector's histograms at once.
+
+#include "collectors/collectors.h"
+#include "lib/poc_hist.h"
+#include "lib/poc_platform.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    PocHist call;           // ticks per call
+    PocHist per_sample;     // ticks per returned sample, x SAMPLE_SCALE
+    PocHist values;         // raw sample values
+    uint64_t failed;        // calls returning <= 0
+} CollectorHist;
+
+// A call returns many samples that each cost well under a tick on a 24 MHz
+// timebase, so the per-sample cost is binned in 1/1024 tick units rather
+// than truncated to whole ticks.
+#define SAMPLE_SCALE 1024u
+
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static const char *g_path;
+static CollectorHist *g_hists;
+
+static void hist_init(void) {
+    const char *path = getenv("POC_HIST");
+    if (!path || !*path) return;
+    g_hists = malloc(sizeof(*g_hists) * (size_t)poc_n_collectors);
+    if (!g_hists) return;
+    for (int i = 0; i < poc_n_collectors; i++) {
+        poc_hist_init(&g_hists[i].call);
+        poc_hist_init(&g_hists[i].per_sample);
+        poc_hist_init(&g_hists[i].values);
+        g_hists[i].failed = 0;
+    }
+    g_path = path;
+    atexit(poc_hist_flush);
+}
+
+int poc_collect(const PocCollector *c, uint64_t *out, int n) {
+    pthread_once(&g_once, hist_init);
+    if (!g_hists) return c->collect(out, n);
+
+    uint64_t t0 = mach_absolute_time();
+    int got = c->collect(out, n);
+    uint64_t dt = mach_absolute_time() - t0;
+
+    CollectorHist *h = &g_hists[c - poc_collectors];
+    poc_hist_record(&h->call, dt);
+    if (got <= 0) {
+        h->failed++;
+        return got;
+    }
+    poc_hist_record(&h->per_sample, dt * SAMPLE_SCALE / (uint64_t)got);
+    for (int i = 0; i < got; i++) poc_hist_record(&h->values, out[i]);
+    return got;
+}
+
+void poc_hist_flush(void) {
+    pthread_once(&g_once, hist_init);
+    if (!g_hists) return;
+    FILE *f = fopen(g_path, "w");
+    if (!f) {
+        perror(g_path);
+        return;
+    }
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    const double ns_per_tick = (double)tb.numer / tb.denom;
+
+    fprintf(f, "{\n  \"schema\": \"poc_hist_v1\",\n  \"generated_unix\": %lld,\n",
+            (long long)time(NULL));
+    fprintf(f, "  \"ns_per_tick\": %.4f,\n  \"sub_bucket_bits\": %d,\n  \"collectors\": [",
+            ns_per_tick, POC_HIST_SUB_BITS);
+    int first = 1;
+    for (int i = 0; i < poc_n_collectors; i++) {
+        const CollectorHist *h = &g_hists[i];
+        if (h->call.count == 0) continue;
+        fprintf(f, "%s\n    {\"name\": \"%s\", \"calls\": %llu, \"failed_calls\": %llu,",
+                first ? "" : ",", poc_collectors[i].name, (unsigned long long)h->call.count,
+                (unsigned long long)h->failed);
+        fprintf(f, "\n     \"call_ns\": ");
+        poc_hist_write_json(f, &h->call, ns_per_tick);
+        fprintf(f, ",\n     \"sample_ns\": ");
+        poc_hist_write_json(f, &h->per_sample, ns_per_tick / SAMPLE_SCALE);
+        fprintf(f, ",\n     \"value_ticks\": ");
+        poc_hist_write_json(f, &h->values, 1.0);
+        fprintf(f, "}");
+        first = 0;
+    }
+    fprintf(f, "\n  ]\n}\n");
+    fclose(f);
+}
@@ -0,0 +1,176 @@
+// ioreg_snapshot.c — In-process IORegistry numeric snapshots with a hashed key index
+
+#include "collectors/ioreg_snapshot.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <IOKit/IOKitLib.h>
+
+// Top-level properties plus one level of nested dictionaries
+// (PerformanceStatistics, IOPowerManagement, ...).
+#define IOREG_MAX_DEPTH 2
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME  0x100000001b3ULL
+
+// Services that had integer properties on the first walk, retained.
+static io_registry_entry_t *g_entries;
+static uint64_t *g_entry_ids;
+static int g_n_entries;
+static int g_walked;
+
+typedef struct {
+    IoregSnapshot *s;
+    uint64_t entry_id;
+    uint64_t hash;       // FNV state of the enclosing path
+    int depth;
+} WalkCtx;
+
+static uint64_t fnv_str(uint64_t h, const char *p) {
+    for (; *p; p++) h = (h ^ (uint8_t)*p) * FNV_PRIME;
+    return h;
+}
+
+static uint32_t slot_hash(uint64_t entry_id, uint64_t key_hash) {
+    uint64_t x = entry_id * 0x9e3779b97f4a7c15ULL ^ key_hash;
+    x ^= x >> 31;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 29;
+    return (uint32_t)x;
+}
+
+static void push(IoregSnapshot *s, uint64_t entry_id, uint64_t key_hash, int64_t value) {
+    if (s->n == s->cap) {
+        int cap = s->cap ? s->cap * 2 : 4096;
+        IoregValue *v = realloc(s->vals, (size_t)cap * sizeof(*v));
+        if (!v) return;
+        s->vals = v;
+        s->cap = cap;
+    }
+    s->vals[s->n++] = (IoregValue){entry_id, key_hash, value};
+}
+
+static void add_prop(const void *key, const void *value, void *arg) {
+    WalkCtx *ctx = arg;
+    if (CFGetTypeID(key) != CFStringGetTypeID()) return;
+
+    char buf[256];
+    const char *name = CFStringGetCStringPtr((CFStringRef)key, kCFStringEncodingUTF8);
+    if (!name) {
+        if (!CFStringGetCString((CFStringRef)key, buf, sizeof(buf), kCFStringEncodingUTF8))
+            return;
+        name = buf;
+    }
+    uint64_t h = fnv_str(ctx->hash, name);
+
+    CFTypeID t = CFGetTypeID(value);
+    if (t == CFNumberGetTypeID()) {
+        if (CFNumberIsFloatType((CFNumberRef)value)) return;
+        int64_t v;
+        if (CFNumberGetValue((CFNumberRef)value, kCFNumberSInt64Type, &v))
+            push(ctx->s, ctx->entry_id, h, v);
+    } else if (t == CFDictionaryGetTypeID() && ctx->depth + 1 < IOREG_MAX_DEPTH) {
+        WalkCtx sub = {ctx->s, ctx->entry_id, (h ^ '/') * FNV_PRIME, ctx->depth + 1};
+        CFDictionaryApplyFunction((CFDictionaryRef)value, add_prop, &sub);
+    }
+}
+
+static int read_entry(IoregSnapshot *s, io_registry_entry_t entry, uint64_t entry_id) {
+    CFMutableDictionaryRef props = NULL;
+    if (IORegistryEntryCreateCFProperties(entry, &props, kCFAllocatorDefault, 0) != KERN_SUCCESS ||
+        !props)
+        return 0;
+    int before = s->n;
+    WalkCtx ctx = {s, entry_id, FNV_OFFSET, 0};
+    CFDictionaryApplyFunction(props, add_prop, &ctx);
+    CFRelease(props);
+    return s->n - before;
+}
+
+// First snapshot: walk every IOService and keep the ones worth re-reading.
+static void walk_services(IoregSnapshot *s) {
+    io_iterator_t iter;
+    if (IOServiceGetMatchingServices(kIOMainPortDefault, IOServiceMatching("IOService"),
+                                     &iter) != KERN_SUCCESS)
+        return;
+    int cap = 0;
+    io_registry_entry_t entry;
+    while ((entry = IOIteratorNext(iter)) != 0) {
+        uint64_t id = 0;
+        IORegistryEntryGetRegistryEntryID(entry, &id);
+        if (read_entry(s, entry, id) == 0) {
+            IOObjectRelease(entry);
+            continue;
+        }
+        if (g_n_entries == cap) {
+            int ncap = cap ? cap * 2 : 1024;
+            io_registry_entry_t *e = realloc(g_entries, (size_t)ncap * sizeof(*e));
+            uint64_t *ids = realloc(g_entry_ids, (size_t)ncap * sizeof(*ids));
+            if (e) g_entries = e;
+            if (ids) g_entry_ids = ids;
+            if (!e || !ids) {
+                IOObjectRelease(entry);
+                break;
+            }
+            cap = ncap;
+        }
+        g_entries[g_n_entries] = entry;
+        g_entry_ids[g_n_entries++] = id;
+    }
+    IOObjectRelease(iter);
+    g_walked = 1;
+}
+
+static void build_index(IoregSnapshot *s) {
+    uint32_t size = 1;
+    while (size < 2u * (uint32_t)s->n) size <<= 1;
+    if (size - 1 != s->mask || !s->index) {
+        free(s->index);
+        s->index = malloc(size * sizeof(int32_t));
+        if (!s->index) return;
+        s->mask = size - 1;
+    }
+    memset(s->index, 0xff, size * sizeof(int32_t));
+    for (int i = 0; i < s->n; i++) {
+        const IoregValue *v = &s->vals[i];
+        uint32_t j = slot_hash(v->entry_id, v->key_hash) & s->mask;
+        for (;; j = (j + 1) & s->mask) {
+            int32_t k = s->index[j];
+            if (k < 0) {
+                s->index[j] = i;
+                break;
+            }
+            // Keep the first occurrence of a key.
+            if (s->vals[k].entry_id == v->entry_id && s->vals[k].key_hash == v->key_hash) break;
+        }
+    }
+}
+
+int ioreg_snapshot_take(IoregSnapshot *s) {
+    s->n = 0;
+    if (!g_walked) {
+        walk_services(s);
+    } else {
+        for (int i = 0; i < g_n_entries; i++) read_entry(s, g_entries[i], g_entry_ids[i]);
+    }
+    build_index(s);
+    return s->index ? s->n : 0;
+}
+
+const IoregValue *ioreg_snapshot_find(const IoregSnapshot *s, const IoregValue *k) {
+    if (!s->index) return NULL;
+    for (uint32_t j = slot_hash(k->entry_id, k->key_hash) & s->mask;; j = (j + 1) & s->mask) {
+        int32_t i = s->index[j];
+        if (i < 0) return NULL;
+        if (s->vals[i].entry_id == k->entry_id && s->vals[i].key_hash == k->key_hash)
+            return &s->vals[i];
+    }
+}
+
+void ioreg_snapshot_free(IoregSnapshot *s) {
+    free(s->vals);
+    free(s->index);
+    memset(s, 0, sizeof(*s));
+}
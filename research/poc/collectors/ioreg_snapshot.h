@@ -0,0 +1,39 @@
+// ioreg_snapshot.h — In-process IORegistry numeric snapshots with a hashed key index
+//
+// Shared by the ioregistry and sensor_noise collectors. A snapshot is every
+// integer property of every IOService (nested dictionaries included), read
+// with IORegistryEntryCreateCFProperties instead of forking `ioreg -l` and
+// parsing its text. Each value is keyed by (registry entry ID, hash of the
+// property path), so the same key is found in another snapshot in O(1).
+//
+// The service list is walked once per process; later snapshots only
+// re-read the entries that had integer properties.
+
+#ifndef POC_IOREG_SNAPSHOT_H
+#define POC_IOREG_SNAPSHOT_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t entry_id;   // IORegistryEntryGetRegistryEntryID
+    uint64_t key_hash;   // FNV-1a of "Key" or "Dict/Key"
+    int64_t value;
+} IoregValue;
+
+typedef struct {
+    IoregValue *vals;    // in registry walk order
+    int n, cap;
+    int32_t *index;      // open addressing into vals, -1 = empty
+    uint32_t mask;
+} IoregSnapshot;
+
+// Replace s's contents with a fresh snapshot. Returns the value count
+// (0 if the registry could not be read). s must start zeroed.
+int ioreg_snapshot_take(IoregSnapshot *s);
+
+// The value with the same key as k in s, or NULL.
+const IoregValue *ioreg_snapshot_find(const IoregSnapshot *s, const IoregValue *k);
+
+void ioreg_snapshot_free(IoregSnapshot *s);
+
+#endif // POC_IOREG_SNAPSHOT_H
@@ -0,0 +1,65 @@
+// ioregistry.c — IORegistry multi-snapshot delta entropy collector
+// Mechanism: Take 4 in-process IORegistry snapshots (collectors/ioreg_snapshot.h)
+//            8ms apart. Find keys present in all snapshots via the hashed index.
+//            Compute deltas for non-zero changes across consecutive snapshots.
+//            XOR consecutive deltas, extract LSBs.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "collectors/ioreg_snapshot.h"
+
+#define IOREG_LARGE_N   20000
+#define IOREG_GAP_US    8000
+#define IOREG_IDLE_MAX  8     // rounds without a changed value before giving up
+
+int collect_ioregistry(uint64_t *timings, int n) {
+    int cap = n < IOREG_LARGE_N ? n : IOREG_LARGE_N;
+
+    IoregSnapshot snaps[4];
+    memset(snaps, 0, sizeof(snaps));
+
+    int valid = 0, idle = 0;
+    uint64_t prev_delta = 0;
+
+    for (int round = 0; round < (cap / 2) + 10 && valid < cap && idle < IOREG_IDLE_MAX; round++) {
+        // Take 4 snapshots with short delays
+        int ok = 1;
+        for (int s = 0; s < 4; s++) {
+            if (ioreg_snapshot_take(&snaps[s]) == 0) ok = 0;
+            if (s < 3) usleep(IOREG_GAP_US);
+        }
+        if (!ok) break;
+
+        // Keys present in all 4 snapshots, looked up by hash
+        int before = valid;
+        for (int i = 0; i < snaps[0].n && valid < cap; i++) {
+            const IoregValue *k = &snaps[0].vals[i];
+            int64_t vals[4];
+            vals[0] = k->value;
+            int found_all = 1;
+
+            for (int s = 1; s < 4 && found_all; s++) {
+                const IoregValue *v = ioreg_snapshot_find(&snaps[s], k);
+                if (v) vals[s] = v->value;
+                else found_all = 0;
+            }
+            if (!found_all) continue;
+
+            // Compute deltas between consecutive snapshots
+            for (int s = 1; s < 4 && valid < cap; s++) {
+                int64_t delta = vals[s] - vals[s - 1];
+                if (delta != 0) {
+                    uint64_t abs_delta = (uint64_t)(delta < 0 ? -delta : delta);
+                    // XOR with previous delta, extract LSBs
+                    uint64_t xored = abs_delta ^ prev_delta;
+                    timings[valid++] = xored;
+                    prev_delta = abs_delta;
+                }
+            }
+        }
+        idle = valid == before ? idle + 1 : 0;
+    }
+
+    for (int s = 0; s < 4; s++) ioreg_snapshot_free(&snaps[s]);
+    return valid;
+}
@@ -0,0 +1,156 @@
+// kqueue_events.c — kqueue event notification timing entropy collector
+// Mechanism: kqueue with 8 timers, 4 socket pairs, 4 file watchers; background poking
+//
+// kqueue_events takes one sample per kevent() call (its duration).
+// kqueue_events_batch sizes the event list to every registered source, so
+// each call drains all ready events at once, and times those batched
+// drains. It too takes only the call duration: the events' data, idents
+// and batch positions are decided by the timer and poker schedule, not by
+// timing noise, and mixing them in would inflate the measured entropy.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include <sys/event.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+#define NUM_TIMERS 8
+#define NUM_SOCKETS 4
+#define NUM_FILES 4
+#define MAX_EVENTS (NUM_TIMERS + NUM_SOCKETS + NUM_FILES)
+
+struct kqueue_ctx {
+    int kq;
+    int sock_pairs[NUM_SOCKETS][2];
+    char tmpfiles[NUM_FILES][128];
+    int tmpfds[NUM_FILES];
+    volatile int running;
+};
+
+static void *background_poker(void *arg) {
+    struct kqueue_ctx *ctx = (struct kqueue_ctx *)arg;
+    uint64_t rng = mach_absolute_time() ^ 0xBEEF;
+    uint8_t poke = 0x42;
+    poc_place_worker(POC_QOS_INHERIT, 0);
+
+    while (ctx->running) {
+        // Poke a random socket
+        int si = (int)(lcg_next(&rng) % NUM_SOCKETS);
+        write(ctx->sock_pairs[si][0], &poke, 1);
+
+        // Touch a random file
+        int fi = (int)(lcg_next(&rng) % NUM_FILES);
+        if (ctx->tmpfds[fi] >= 0) {
+            lseek(ctx->tmpfds[fi], 0, SEEK_SET);
+            write(ctx->tmpfds[fi], &poke, 1);
+        }
+
+        // Small random delay
+        usleep(100 + (int)(lcg_next(&rng) % 500));
+    }
+    poc_place_worker_done();
+    return NULL;
+}
+
+static int setup_kqueue_ctx(struct kqueue_ctx *ctx) {
+    ctx->kq = kqueue();
+    if (ctx->kq < 0) return -1;
+
+    struct kevent evs[NUM_TIMERS + NUM_SOCKETS * 2 + NUM_FILES];
+    int nev = 0;
+
+    // Register 8 timers with 1-10ms intervals
+    for (int i = 0; i < NUM_TIMERS; i++) {
+        int ms = 1 + (i % 10);
+        EV_SET(&evs[nev++], 100 + i, EVFILT_TIMER, EV_ADD, 0, ms, NULL);
+    }
+
+    // Create 4 socket pairs with EVFILT_READ on read end
+    for (int i = 0; i < NUM_SOCKETS; i++) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, ctx->sock_pairs[i]) != 0) {
+            ctx->sock_pairs[i][0] = ctx->sock_pairs[i][1] = -1;
+            continue;
+        }
+        // Non-blocking
+        fcntl(ctx->sock_pairs[i][1], F_SETFL,
+              fcntl(ctx->sock_pairs[i][1], F_GETFL) | O_NONBLOCK);
+        EV_SET(&evs[nev++], ctx->sock_pairs[i][1], EVFILT_READ, EV_ADD, 0, 0, NULL);
+    }
+
+    // Create 4 temp files with EVFILT_VNODE
+    for (int i = 0; i < NUM_FILES; i++) {
+        snprintf(ctx->tmpfiles[i], sizeof(ctx->tmpfiles[i]),
+                 "/tmp/openentropy_kq_validate_%d_%d", getpid(), i);
+        ctx->tmpfds[i] = open(ctx->tmpfiles[i], O_CREAT | O_RDWR, 0600);
+        if (ctx->tmpfds[i] >= 0) {
+            EV_SET(&evs[nev++], ctx->tmpfds[i], EVFILT_VNODE,
+                   EV_ADD | EV_CLEAR,
+                   NOTE_WRITE | NOTE_ATTRIB,
+                   0, NULL);
+        }
+    }
+
+    kevent(ctx->kq, evs, nev, NULL, 0, NULL);
+    ctx->running = 1;
+    return 0;
+}
+
+static void cleanup_kqueue_ctx(struct kqueue_ctx *ctx) {
+    ctx->running = 0;
+    close(ctx->kq);
+    for (int i = 0; i < NUM_SOCKETS; i++) {
+        if (ctx->sock_pairs[i][0] >= 0) close(ctx->sock_pairs[i][0]);
+        if (ctx->sock_pairs[i][1] >= 0) close(ctx->sock_pairs[i][1]);
+    }
+    for (int i = 0; i < NUM_FILES; i++) {
+        if (ctx->tmpfds[i] >= 0) close(ctx->tmpfds[i]);
+        unlink(ctx->tmpfiles[i]);
+    }
+}
+
+static int run_kqueue(uint64_t *timings, int n, int batch) {
+    struct kqueue_ctx ctx;
+    if (setup_kqueue_ctx(&ctx) != 0) return 0;
+
+    // Start background poker thread
+    pthread_t poker_tid;
+    pthread_create(&poker_tid, NULL, background_poker, &ctx);
+
+    // Small warmup delay
+    usleep(5000);
+
+    struct kevent out_evs[32];
+    struct timespec timeout = {0, 1000000}; // 1ms timeout
+    uint8_t drain_buf[256];
+
+    int valid = 0;
+    while (valid < n) {
+        uint64_t t0 = mach_absolute_time();
+        int nready = kevent(ctx.kq, NULL, 0, out_evs, batch ? MAX_EVENTS : 32, &timeout);
+        uint64_t t1 = mach_absolute_time();
+
+        timings[valid++] = t1 - t0;
+
+        // Drain any socket data to prevent buffer fill
+        if (nready > 0) {
+            for (int j = 0; j < nready; j++) {
+                if (out_evs[j].filter == EVFILT_READ) {
+                    read((int)out_evs[j].ident, drain_buf, sizeof(drain_buf));
+                }
+            }
+        }
+    }
+
+    ctx.running = 0;
+    pthread_join(poker_tid, NULL);
+    cleanup_kqueue_ctx(&ctx);
+    return valid;
+}
+
+int collect_kqueue_events(uint64_t *timings, int n) {
+    return run_kqueue(timings, n, 0);
+}
+
+int collect_kqueue_events_batch(uint64_t *timings, int n) {
+    return run_kqueue(timings, n, 1);
+}
@@ -0,0 +1,217 @@
+// mach_ipc.c — Mach IPC message-passing timing entropy collector
+// Mechanism: Pool of 8 Mach ports, complex OOL messages, receiver thread draining
+//
+// mach_ipc times the send trap, with a receiver thread draining in
+// separate calls. mach_ipc_roundtrip drops the thread: one
+// mach_msg(MACH_SEND_MSG | MACH_RCV_MSG) per sample sends the OOL message
+// to the pool port and receives it back in the same trap, through one
+// preallocated message buffer and OOL source. Received OOL regions are
+// vm_deallocate'd in batches outside the timed window.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include <mach/mach.h>
+
+#define PORT_POOL_SIZE 8
+#define OOL_SIZE 4096
+#define DEFER_BATCH 256   // received OOL regions freed per untimed flush
+
+// Message structures for complex OOL send
+typedef struct {
+    mach_msg_header_t header;
+    mach_msg_body_t body;
+    mach_msg_ool_descriptor_t ool;
+} ool_send_msg_t;
+
+typedef struct {
+    mach_msg_header_t header;
+    mach_msg_body_t body;
+    mach_msg_ool_descriptor_t ool;
+    mach_msg_trailer_t trailer;
+} ool_recv_msg_t;
+
+// One buffer serves both directions of a combined send/receive.
+typedef union {
+    ool_send_msg_t send;
+    ool_recv_msg_t recv;
+} ool_rt_msg_t;
+
+static mach_port_t g_ports[PORT_POOL_SIZE];
+static mach_port_t g_send_ports[PORT_POOL_SIZE];
+static volatile int g_receiver_running = 1;
+
+static void *receiver_thread(void *arg) {
+    (void)arg;
+    poc_place_worker(POC_QOS_INHERIT, 0);
+    while (g_receiver_running) {
+        // Drain messages from all ports round-robin
+        for (int p = 0; p < PORT_POOL_SIZE && g_receiver_running; p++) {
+            ool_recv_msg_t recv_msg;
+            memset(&recv_msg, 0, sizeof(recv_msg));
+
+            mach_msg_return_t kr = mach_msg(
+                &recv_msg.header,
+                MACH_RCV_MSG | MACH_RCV_TIMEOUT,
+                0,
+                sizeof(recv_msg),
+                g_ports[p],
+                1, // 1ms timeout
+                MACH_PORT_NULL
+            );
+
+            if (kr == MACH_MSG_SUCCESS) {
+                // Deallocate OOL memory if received
+                if (recv_msg.ool.address) {
+                    vm_deallocate(mach_task_self(),
+                                  (vm_address_t)recv_msg.ool.address,
+                                  recv_msg.ool.size);
+                }
+            }
+        }
+    }
+    poc_place_worker_done();
+    return NULL;
+}
+
+// Create port pool with receive + send rights
+static int open_ports(void) {
+    for (int i = 0; i < PORT_POOL_SIZE; i++) {
+        kern_return_t kr = mach_port_allocate(mach_task_self(),
+                                               MACH_PORT_RIGHT_RECEIVE,
+                                               &g_ports[i]);
+        if (kr != KERN_SUCCESS) return -1;
+
+        kr = mach_port_insert_right(mach_task_self(), g_ports[i],
+                                     g_ports[i], MACH_MSG_TYPE_MAKE_SEND);
+        if (kr != KERN_SUCCESS) return -1;
+        g_send_ports[i] = g_ports[i];
+    }
+    return 0;
+}
+
+static void close_ports(void) {
+    for (int i = 0; i < PORT_POOL_SIZE; i++) {
+        mach_port_deallocate(mach_task_self(), g_send_ports[i]);
+        mach_port_mod_refs(mach_task_self(), g_ports[i],
+                           MACH_PORT_RIGHT_RECEIVE, -1);
+    }
+}
+
+static void fill_ool(uint8_t *ool_data) {
+    uint64_t rng = mach_absolute_time();
+    for (int i = 0; i < OOL_SIZE; i++) ool_data[i] = (uint8_t)(lcg_next(&rng));
+}
+
+static void build_send(ool_send_msg_t *msg, int port_idx, int id, uint8_t *ool_data) {
+    msg->header.msgh_bits = MACH_MSGH_BITS_COMPLEX |
+                            MACH_MSGH_BITS(MACH_MSG_TYPE_COPY_SEND, 0);
+    msg->header.msgh_size = sizeof(*msg);
+    msg->header.msgh_remote_port = g_send_ports[port_idx];
+    msg->header.msgh_local_port = MACH_PORT_NULL;
+    msg->header.msgh_id = id;
+    msg->body.msgh_descriptor_count = 1;
+    msg->ool.address = ool_data;
+    msg->ool.size = OOL_SIZE;
+    msg->ool.deallocate = 0;
+    msg->ool.copy = MACH_MSG_VIRTUAL_COPY;
+    msg->ool.type = MACH_MSG_OOL_DESCRIPTOR;
+}
+
+int collect_mach_ipc(uint64_t *timings, int n) {
+    if (open_ports() != 0) return 0;
+
+    // Start receiver thread
+    g_receiver_running = 1;
+    pthread_t recv_tid;
+    pthread_create(&recv_tid, NULL, receiver_thread, NULL);
+
+    // Prepare OOL data
+    uint8_t ool_data[OOL_SIZE];
+    fill_ool(ool_data);
+
+    int valid = 0;
+    for (int i = 0; i < n; i++) {
+        int port_idx = i % PORT_POOL_SIZE;
+
+        ool_send_msg_t msg;
+        memset(&msg, 0, sizeof(msg));
+        build_send(&msg, port_idx, i, ool_data);
+
+        uint64_t t0 = mach_absolute_time();
+        mach_msg_return_t kr = mach_msg(
+            &msg.header,
+            MACH_SEND_MSG | MACH_SEND_TIMEOUT,
+            sizeof(msg),
+            0,
+            MACH_PORT_NULL,
+            10, // 10ms timeout
+            MACH_PORT_NULL
+        );
+        uint64_t t1 = mach_absolute_time();
+
+        if (kr == MACH_MSG_SUCCESS) {
+            timings[valid++] = t1 - t0;
+        }
+    }
+
+    // Cleanup
+    g_receiver_running = 0;
+    pthread_join(recv_tid, NULL);
+    close_ports();
+
+    return valid;
+}
+
+typedef struct {
+    vm_address_t addr;
+    mach_msg_size_t size;
+} ool_region_t;
+
+static void flush_regions(ool_region_t *regions, int *n_regions) {
+    for (int i = 0; i < *n_regions; i++)
+        vm_deallocate(mach_task_self(), regions[i].addr, regions[i].size);
+    *n_regions = 0;
+}
+
+int collect_mach_ipc_roundtrip(uint64_t *timings, int n) {
+    if (open_ports() != 0) return 0;
+
+    static uint8_t ool_data[OOL_SIZE];
+    static ool_rt_msg_t msg;
+    static ool_region_t regions[DEFER_BATCH];
+    int n_regions = 0;
+    fill_ool(ool_data);
+    memset(&msg, 0, sizeof(msg));
+
+    int valid = 0;
+    for (int i = 0; i < n; i++) {
+        int port_idx = i % PORT_POOL_SIZE;
+        // The receive overwrote the header; only the fields are rewritten.
+        build_send(&msg.send, port_idx, i, ool_data);
+
+        uint64_t t0 = mach_absolute_time();
+        mach_msg_return_t kr = mach_msg(
+            &msg.send.header,
+            MACH_SEND_MSG | MACH_RCV_MSG | MACH_SEND_TIMEOUT | MACH_RCV_TIMEOUT,
+            sizeof(msg.send),
+            sizeof(msg.recv),
+            g_ports[port_idx],
+            10, // 10ms timeout
+            MACH_PORT_NULL
+        );
+        uint64_t t1 = mach_absolute_time();
+
+        if (kr == MACH_MSG_SUCCESS) {
+            timings[valid++] = t1 - t0;
+            if (msg.recv.ool.address) {
+                regions[n_regions].addr = (vm_address_t)msg.recv.ool.address;
+                regions[n_regions].size = msg.recv.ool.size;
+                if (++n_regions == DEFER_BATCH) flush_regions(regions, &n_regions);
+            }
+        }
+    }
+
+    flush_regions(regions, &n_regions);
+    close_ports();
+    return valid;
+}
@@ -0,0 +1,17 @@
+// multi_domain_beat.c — Multi-domain (CPU/Memory/Syscall) beat timing entropy collector
+// Mechanism: Interleave 3 domains: CPU (50 LCG iterations), Memory (random read_volatile
+//            from 4MB buffer), Syscall (getpid()). Record all 3 timings per iteration.
+//
+// The "cpu,mem,sys" pattern on the beat engine (lib/poc_beat.h); poc_beat
+// runs any other combination.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "lib/poc_beat.h"
+
+int collect_multi_domain_beat(uint64_t *timings, int n) {
+    PocBeatConfig cfg;
+    poc_beat_defaults(&cfg);
+    poc_beat_parse("cpu,mem,sys", &cfg);
+    return poc_beat_run(&cfg, timings, n, NULL);
+}
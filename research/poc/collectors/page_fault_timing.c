@@ -0,0 +1,95 @@
+// page_fault_timing.c — Entropy source collector
+// Mechanism: mmap 8 pages, touch each page (triggering minor fault), measure per-page timing, munmap
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+
+#include <sys/resource.h>
+
+#define FAULT_PAGES 8
+
+int collect_page_fault_timing(uint64_t *timings, int n) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t alloc_size = (size_t)(FAULT_PAGES * page_size);
+    int valid = 0;
+
+    while (valid < n) {
+        volatile uint8_t *p = (volatile uint8_t *)mmap(NULL, alloc_size,
+            PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
+        if (p == MAP_FAILED) break;
+
+        // Touch each page and measure individually
+        for (int pg = 0; pg < FAULT_PAGES && valid < n; pg++) {
+            uint64_t t0 = mach_absolute_time();
+            p[pg * page_size] = (uint8_t)(pg + 1);
+            uint64_t t1 = mach_absolute_time();
+            timings[valid++] = t1 - t0;
+        }
+
+        munmap((void *)p, alloc_size);
+    }
+    return valid;
+}
+
+// Recycling variant: one long-lived mapping whose pages are dropped in bulk
+// between passes, so each sample is the next first-touch fault alone, with
+// no VMA creation or teardown. macOS drops with MADV_FREE_REUSABLE, other
+// kernels with MADV_DONTNEED. If a pass shows the pages were not actually
+// reclaimed (fewer minor faults than half the pages), later passes fall
+// back to remapping the range MAP_FIXED — still one call per pass.
+#define RECYCLE_PAGES 1024
+
+static volatile uint8_t *g_recycle;
+static size_t g_recycle_size;
+static int g_recycle_remap;
+
+static long minor_faults(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_minflt;
+}
+
+static int drop_pages(void) {
+    if (g_recycle_remap)
+        return mmap((void *)g_recycle, g_recycle_size, PROT_READ | PROT_WRITE,
+                    MAP_ANON | MAP_PRIVATE | MAP_FIXED, -1, 0) == MAP_FAILED ? -1 : 0;
+#if defined(MADV_FREE_REUSABLE)
+    return madvise((void *)g_recycle, g_recycle_size, MADV_FREE_REUSABLE);
+#else
+    return madvise((void *)g_recycle, g_recycle_size, MADV_DONTNEED);
+#endif
+}
+
+int collect_page_fault_recycled(uint64_t *timings, int n) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (!g_recycle) {
+        g_recycle_size = (size_t)RECYCLE_PAGES * page_size;
+        void *p = mmap(NULL, g_recycle_size, PROT_READ | PROT_WRITE,
+                       MAP_ANON | MAP_PRIVATE, -1, 0);
+        if (p == MAP_FAILED) return 0;
+        g_recycle = p;
+        g_recycle_remap = 0;
+    }
+
+    int valid = 0;
+    while (valid < n) {
+        if (drop_pages() != 0) break;
+        long faults0 = minor_faults();
+
+        int pages = 0;
+        for (; pages < RECYCLE_PAGES && valid < n; pages++) {
+            uint64_t t0 = mach_absolute_time();
+            g_recycle[(size_t)pages * page_size] = (uint8_t)(pages + 1);
+            uint64_t t1 = mach_absolute_time();
+            timings[valid++] = t1 - t0;
+        }
+
+        if (!g_recycle_remap && minor_faults() - faults0 < pages / 2) g_recycle_remap = 1;
+    }
+    return valid;
+}
+
+void release_page_fault_recycled(void) {
+    if (g_recycle) munmap((void *)g_recycle, g_recycle_size);
+    g_recycle = NULL;
+}
@@ -0,0 +1,158 @@
+// params.c — Tune file I/O for the registry's tunable parameters
+//
+// The file is shared by every machine that runs poc_tune against it; rows
+// are keyed by machine model, so one checked-in file can carry a tuned
+// configuration per Mac model and each host applies only its own.
+
+#include "collectors/collectors.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+#define TUNE_HEADER "# poc_tune v1"
+#define TUNE_LINE   512
+
+const char *poc_machine_model(void) {
+    static char model[128];
+    if (model[0]) return model;
+
+    size_t len = sizeof(model) - 1;
+#if defined(__APPLE__)
+    if (sysctlbyname("hw.model", model, &len, NULL, 0) != 0) model[0] = 0;
+#else
+    FILE *f = fopen("/sys/devices/virtual/dmi/id/product_name", "r");
+    if (f) {
+        if (!fgets(model, (int)len, f)) model[0] = 0;
+        fclose(f);
+    }
+#endif
+    model[sizeof(model) - 1] = 0;
+    // Trim the newline and fold whitespace so the model is one TSV field
+    size_t n = strlen(model);
+    while (n > 0 && isspace((unsigned char)model[n - 1])) model[--n] = 0;
+    for (size_t i = 0; i < n; i++)
+        if (isspace((unsigned char)model[i])) model[i] = '_';
+    if (!model[0]) strcpy(model, "unknown");
+    return model;
+}
+
+// Split a data row into its five fields. 0, or -1 on a comment / bad row.
+static int parse_row(char *line, char **model, char **coll, char **name, int *value,
+                     double *score) {
+    if (line[0] == '#' || line[0] == '\n') return -1;
+    char *save = NULL;
+    *model = strtok_r(line, "\t\n", &save);
+    *coll = strtok_r(NULL, "\t\n", &save);
+    *name = strtok_r(NULL, "\t\n", &save);
+    char *v = strtok_r(NULL, "\t\n", &save);
+    char *sc = strtok_r(NULL, "\t\n", &save);
+    if (!*model || !*coll || !*name || !v) return -1;
+    *value = atoi(v);
+    *score = sc ? atof(sc) : 0;
+    return 0;
+}
+
+int poc_params_load(const char *path, const char *model) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    char line[TUNE_LINE];
+    int applied = 0;
+    while (fgets(line, sizeof(line), f)) {
+        char *m, *coll, *name;
+        int value;
+        double score;
+        if (parse_row(line, &m, &coll, &name, &value, &score) != 0) continue;
+        if (strcmp(m, model) != 0) continue;
+        const PocParam *p = poc_param_find(coll, name);
+        if (!p) continue;
+        *p->value = value < p->min ? p->min : value > p->max ? p->max : value;
+        applied++;
+    }
+    fclose(f);
+    return applied;
+}
+
+static void free_rows(char **rows, int n) {
+    for (int i = 0; i < n; i++) free(rows[i]);
+    free(rows);
+}
+
+int poc_params_save(const char *path, const char *model, const char *collector, double score) {
+    // Keep every row except the ones this save replaces
+    char **keep = NULL;
+    int n_keep = 0, cap = 0;
+    FILE *f = fopen(path, "r");
+    if (f) {
+        char line[TUNE_LINE], copy[TUNE_LINE];
+        while (fgets(line, sizeof(line), f)) {
+            memcpy(copy, line, sizeof(line));
+            char *m, *coll, *name;
+            int value;
+            double sc;
+            if (parse_row(copy, &m, &coll, &name, &value, &sc) != 0) continue;
+            if (strcmp(m, model) == 0 && strcmp(coll, collector) == 0) continue;
+            if (n_keep == cap) {
+                cap = cap ? cap * 2 : 64;
+                char **grown = realloc(keep, (size_t)cap * sizeof(*keep));
+                if (!grown) break;
+                keep = grown;
+            }
+            if (!(keep[n_keep] = strdup(line))) break;
+            n_keep++;
+        }
+        // Stopped early (out of memory): leave the file as it is rather
+        // than drop the rows not read
+        int short_read = !feof(f);
+        fclose(f);
+        if (short_read) {
+            free_rows(keep, n_keep);
+            return -1;
+        }
+    }
+
+    // Write a sibling temp file and rename it over the old one, so a crash
+    // or a concurrent reader never sees a half-written file
+    char tmp[1024];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp.%d", path, (int)getpid()) >= (int)sizeof(tmp)) {
+        free_rows(keep, n_keep);
+        return -1;
+    }
+    int rc = 0;
+    f = fopen(tmp, "w");
+    if (!f) {
+        rc = -1;
+    } else {
+        fprintf(f, "%s\n# model\tcollector\tparam\tvalue\tscore_bits_per_s\n", TUNE_HEADER);
+        for (int i = 0; i < n_keep; i++) fputs(keep[i], f);
+        for (int i = 0; i < poc_n_params; i++)
+            if (strcmp(poc_params[i].collector, collector) == 0)
+                fprintf(f, "%s\t%s\t%s\t%d\t%.0f\n", model, collector, poc_params[i].name,
+                        *poc_params[i].value, score);
+        if (fclose(f) != 0) rc = -1;
+        if (rc == 0 && rename(tmp, path) != 0) rc = -1;
+        if (rc != 0) unlink(tmp);
+    }
+    free_rows(keep, n_keep);
+    return rc;
+}
+
+void poc_params_apply_env(void) {
+    static int done;
+    if (done) return;
+    done = 1;
+    const char *path = getenv("POC_TUNE");
+    if (!path || !*path) return;
+    int applied = poc_params_load(path, poc_machine_model());
+    if (applied < 0)
+        fprintf(stderr, "POC_TUNE: cannot read %s\n", path);
+    else if (applied > 0)
+        fprintf(stderr, "POC_TUNE: %d tuned parameter(s) for %s\n", applied,
+                poc_machine_model());
+}
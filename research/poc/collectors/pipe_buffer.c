@@ -0,0 +1,165 @@
+// pipe_buffer.c — Pipe buffer write/read timing entropy collector
+// Mechanism: 4 pipes, O_NONBLOCK, random write sizes, round-robin, pipe zone churn
+//
+// pipe_buffer_writev moves several segments per syscall: one writev() of
+// a preallocated iovec set into the next pipe, then one readv() that
+// drains it into a second set, each timed on its own, so every syscall is
+// a sample. The kernel reports no per-segment completion time; the
+// segments are what each syscall copies through the pipe buffer. Segment
+// lengths are drawn once into PIPEV_SETS iovec sets, so nothing is
+// allocated between samples. Each round picks its set with one untimed
+// LCG draw: cycling through them would repeat every PIPEV_SETS rounds
+// and, with a power-of-two pipe count, hand each pipe the same few sets.
+// The pipe count and segments per syscall are registry tunables.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include <sys/uio.h>
+
+#define NUM_PIPES 4
+#define MAX_WRITE_SIZE 4096
+#define PIPEV_MAX_SEGMENT 1024      // a full set (16 KiB) fits an empty pipe
+#define PIPEV_SETS 64
+
+int poc_pipe_buffer_writev_pipes = 4;
+int poc_pipe_buffer_writev_segments = 8;
+
+int collect_pipe_buffer(uint64_t *timings, int n) {
+    int pipes[NUM_PIPES][2];
+    for (int i = 0; i < NUM_PIPES; i++) {
+        if (pipe(pipes[i]) != 0) return 0;
+        // Set write end to O_NONBLOCK
+        int flags = fcntl(pipes[i][1], F_GETFL, 0);
+        fcntl(pipes[i][1], F_SETFL, flags | O_NONBLOCK);
+    }
+
+    uint8_t write_buf[MAX_WRITE_SIZE];
+    uint8_t read_buf[MAX_WRITE_SIZE];
+    uint64_t rng = mach_absolute_time();
+    memset(write_buf, 0xAB, sizeof(write_buf));
+
+    int valid = 0;
+    for (int i = 0; i < n; i++) {
+        int pipe_idx = i % NUM_PIPES;
+        int write_size = 1 + (int)(lcg_next(&rng) % MAX_WRITE_SIZE);
+
+        uint64_t t0 = mach_absolute_time();
+        ssize_t written = write(pipes[pipe_idx][1], write_buf, write_size);
+        if (written > 0) {
+            read(pipes[pipe_idx][0], read_buf, written);
+        }
+        uint64_t t1 = mach_absolute_time();
+
+        timings[valid++] = t1 - t0;
+
+        // Every 8th iteration: create + close an extra pipe for zone churn
+        if ((i & 7) == 7) {
+            int churn[2];
+            if (pipe(churn) == 0) {
+                write(churn[1], write_buf, 64);
+                read(churn[0], read_buf, 64);
+                close(churn[0]);
+                close(churn[1]);
+            }
+        }
+    }
+
+    for (int i = 0; i < NUM_PIPES; i++) {
+        close(pipes[i][0]);
+        close(pipes[i][1]);
+    }
+    return valid;
+}
+
+static void close_pipes(int (*pipes)[2], int n) {
+    for (int i = 0; i < n; i++) {
+        close(pipes[i][0]);
+        close(pipes[i][1]);
+    }
+}
+
+int poc_pipev_run(int n_pipes, int segments, uint64_t *timings, int n) {
+    if (n_pipes < 1 || n_pipes > POC_PIPEV_MAX_PIPES || segments < 1 ||
+        segments > POC_PIPEV_MAX_SEGMENTS || n < 1)
+        return 0;
+    int (*pipes)[2] = malloc(sizeof(*pipes) * (size_t)n_pipes);
+    static uint8_t write_buf[POC_PIPEV_MAX_SEGMENTS * PIPEV_MAX_SEGMENT];
+    static uint8_t read_buf[POC_PIPEV_MAX_SEGMENTS * PIPEV_MAX_SEGMENT];
+    struct iovec (*wsets)[POC_PIPEV_MAX_SEGMENTS] = malloc(sizeof(*wsets) * PIPEV_SETS);
+    struct iovec (*rsets)[POC_PIPEV_MAX_SEGMENTS] = malloc(sizeof(*rsets) * PIPEV_SETS);
+    if (!pipes || !wsets || !rsets) {
+        free(pipes);
+        free(wsets);
+        free(rsets);
+        return 0;
+    }
+    int opened = 0;
+    for (; opened < n_pipes; opened++) {
+        if (pipe(pipes[opened]) != 0) break;
+        int flags = fcntl(pipes[opened][1], F_GETFL, 0);
+        fcntl(pipes[opened][1], F_SETFL, flags | O_NONBLOCK);
+    }
+
+    // Each set's segments tile the buffers; the read set mirrors the write set.
+    uint64_t rng = mach_absolute_time();
+    memset(write_buf, 0xAB, sizeof(write_buf));
+    for (int s = 0; s < PIPEV_SETS; s++) {
+        size_t off = 0;
+        for (int k = 0; k < segments; k++) {
+            size_t len = 1 + (size_t)(lcg_next(&rng) % PIPEV_MAX_SEGMENT);
+            wsets[s][k] = (struct iovec){write_buf + off, len};
+            rsets[s][k] = (struct iovec){read_buf + off, len};
+            off += len;
+        }
+    }
+
+    int valid = 0, failed = 0;
+    for (int i = 0; opened == n_pipes && valid + 1 < n && failed < n; i++) {
+        int (*p)[2] = &pipes[i % n_pipes];
+        const int set = (int)(lcg_next(&rng) % PIPEV_SETS);
+        const struct iovec *w = wsets[set], *r = rsets[set];
+
+        uint64_t t0 = mach_absolute_time();
+        ssize_t written = writev((*p)[1], w, segments);
+        uint64_t t1 = mach_absolute_time();
+        // Only what one writev put in; a short write leaves the tail of r empty
+        if (written > 0) (void)!readv((*p)[0], r, segments);
+        uint64_t t2 = mach_absolute_time();
+        // A failed writev leaves nothing to drain, so the readv time would
+        // be an empty-pipe read, not a copy: drop the round
+        if (written > 0) {
+            timings[valid++] = t1 - t0;
+            timings[valid++] = t2 - t1;
+        } else {
+            failed++;
+        }
+
+        // Every 8th round: create + close an extra pipe for zone churn
+        if ((i & 7) == 7) {
+            int churn[2];
+            if (pipe(churn) == 0) {
+                (void)!write(churn[1], write_buf, 64);
+                (void)!read(churn[0], read_buf, 64);
+                close(churn[0]);
+                close(churn[1]);
+            }
+        }
+    }
+
+    close_pipes(pipes, opened);
+    free(pipes);
+    free(wsets);
+    free(rsets);
+    return valid;
+}
+
+int collect_pipe_buffer_writev(uint64_t *timings, int n) {
+    const int pipes = poc_pipe_buffer_writev_pipes < 1 ? 1
+                    : poc_pipe_buffer_writev_pipes > POC_PIPEV_MAX_PIPES ? POC_PIPEV_MAX_PIPES
+                    : poc_pipe_buffer_writev_pipes;
+    const int segments = poc_pipe_buffer_writev_segments < 1 ? 1
+                       : poc_pipe_buffer_writev_segments > POC_PIPEV_MAX_SEGMENTS
+                           ? POC_PIPEV_MAX_SEGMENTS
+                           : poc_pipe_buffer_writev_segments;
+    return poc_pipev_run(pipes, segments, timings, n);
+}
@@ -0,0 +1,171 @@
+// registry.c — The collector table behind validate_* and poc_runner, and
+// the table of their tunable parameters
+//
+// Off macOS only the portable collectors are built (see the Makefile), so
+// the rest of the table is #if defined(__APPLE__), and the portable entries
+// name their Test 4 partners with CROSS(): the macOS pair, then a pair of
+// portable collectors probing a neighbouring mechanism for other builds.
+
+#include "collectors/collectors.h"
+
+#include <string.h>
+
+#if defined(__APPLE__)
+#define CROSS(mac_a, mac_b, other_a, other_b) {mac_a, mac_b}
+#else
+#define CROSS(mac_a, mac_b, other_a, other_b) {other_a, other_b}
+#endif
+
+const PocCollector poc_collectors[] = {
+#if defined(__APPLE__)
+    {"amx_timing", collect_amx_timing,
+     .cross = {"cache_contention", "compression_timing"}},
+    {"cache_contention", collect_cache_contention, release_cache_contention,
+     .cross = {"dram_row_buffer", "speculative_execution"}},
+#endif
+    {"cas_contention", collect_cas_contention,
+     .cross = CROSS("dvfs_race", "cache_contention", "tlb_shootdown_shared", "thread_lifecycle")},
+#if defined(__APPLE__)
+    {"compression_lzfse", collect_compression_lzfse, release_compression,
+     .cross = {"compression_zstream", "hash_timing"}, .object = "compression_timing"},
+    {"compression_timing", collect_compression_timing,
+     .cross = {"hash_timing", "amx_timing"}},
+    {"compression_zstream", collect_compression_zstream, release_compression,
+     .cross = {"compression_timing", "hash_timing"}, .object = "compression_timing"},
+    {"coreml_ane", collect_coreml_ane, release_coreml_ane,
+     .large_n = 20000, .trial_n = 2000, .cc_n = 2000,
+     .cross = {"amx_timing", "sme_fmopa"}},
+    {"cpu_io_beat", collect_cpu_io_beat,
+     .cross = {"cpu_memory_beat", "compression_timing"}},
+    {"cpu_memory_beat", collect_cpu_memory_beat,
+     .cross = {"cpu_io_beat", "dram_row_buffer"}},
+    {"dispatch_queue", collect_dispatch_queue, release_dispatch_queue,
+     .cross = {"thread_lifecycle", "kqueue_events"}},
+    {"dram_row_buffer", collect_dram_row_buffer, release_dram_row_buffer,
+     .cross = {"cache_contention", "cpu_memory_beat"}},
+    {"dram_row_conflict", collect_dram_row_conflict, release_dram_row_buffer,
+     .cross = {"dram_row_buffer", "cache_contention"}, .object = "dram_row_buffer"},
+    {"dvfs_race", collect_dvfs_race,
+     .cross = {"cas_contention", "thread_lifecycle"}},
+    {"dyld_timing", collect_dyld_timing,
+     .cross = {"spotlight_timing", "compression_timing"}},
+    {"hash_concurrent", collect_hash_concurrent,
+     .cross = {"hash_timing", "cas_contention"}, .object = "hash_timing"},
+    {"hash_timing", collect_hash_timing,
+     .cross = {"compression_timing", "speculative_execution"}},
+    {"ioregistry", collect_ioregistry,
+     .large_n = 20000, .trial_n = 2000, .cc_n = 2000,
+     .cross = {"sensor_noise"}, .demote_if_short = 1},
+    {"kqueue_events", collect_kqueue_events,
+     .cross = {"pipe_buffer", "thread_lifecycle"}},
+    {"kqueue_events_batch", collect_kqueue_events_batch,
+     .cross = {"kqueue_events", "pipe_buffer"}, .object = "kqueue_events"},
+    {"mach_ipc", collect_mach_ipc,
+     .cross = {"thread_lifecycle", "pipe_buffer"}},
+    {"mach_ipc_roundtrip", collect_mach_ipc_roundtrip,
+     .cross = {"mach_ipc", "pipe_buffer"}, .object = "mach_ipc"},
+    {"multi_domain_beat", collect_multi_domain_beat,
+     .cross = {"cpu_io_beat", "cpu_memory_beat"}},
+#endif
+    {"page_fault_timing", collect_page_fault_timing,
+     .cross = CROSS("vm_page_timing", "tlb_shootdown", "page_fault_recycled", "tlb_shootdown")},
+    {"page_fault_recycled", collect_page_fault_recycled, release_page_fault_recycled,
+     .cross = CROSS("page_fault_timing", "vm_page_timing", "page_fault_timing", "tlb_shootdown"),
+     .object = "page_fault_timing"},
+    {"pipe_buffer", collect_pipe_buffer,
+     .cross = CROSS("mach_ipc", "kqueue_events", "pipe_buffer_writev", "thread_lifecycle")},
+    {"pipe_buffer_writev", collect_pipe_buffer_writev,
+     .cross = CROSS("pipe_buffer", "kqueue_events", "pipe_buffer", "thread_lifecycle"),
+     .object = "pipe_buffer"},
+#if defined(__APPLE__)
+    {"sensor_noise", collect_sensor_noise,
+     .large_n = 20000, .trial_n = 2000, .cc_n = 2000,
+     .cross = {"ioregistry"}, .demote_if_short = 1},
+    {"sep_signing", collect_sep_signing, release_sep_signing,
+     .large_n = 20000, .trial_n = 2000, .cc_n = 2000,
+     .cross = {"mach_ipc", "hash_timing"}},
+    {"sme_fmopa", collect_sme_fmopa,
+     .cross = {"amx_timing", "sme_transition"}, .object = "sme_timing"},
+    {"sme_transition", collect_sme_transition,
+     .cross = {"amx_timing", "sme_fmopa"}, .object = "sme_timing"},
+    {"speculative_execution", collect_speculative_execution,
+     .cross = {"hash_timing", "cache_contention"}},
+    {"speculative_unrolled", collect_speculative_unrolled,
+     .cross = {"speculative_execution", "hash_timing"}, .object = "speculative_execution"},
+    {"spotlight_mditem", collect_spotlight_mditem,
+     .large_n = 20000, .trial_n = 2000, .cc_n = 2000,
+     .cross = {"spotlight_timing", "ioregistry"}, .object = "spotlight_timing"},
+    {"spotlight_timing", collect_spotlight_timing,
+     .large_n = 200, .trial_n = 200, .cc_n = 100,
+     .cross = {"dyld_timing", "ioregistry"},
+     .note = "Capped at %d samples per collection (process spawn is slow)"},
+#endif
+    {"thread_lifecycle", collect_thread_lifecycle,
+     .cross = CROSS("dispatch_queue", "mach_ipc", "cas_contention", "pipe_buffer")},
+#if defined(__APPLE__)
+    {"thread_wakeup_semaphore", collect_thread_wakeup_semaphore, release_thread_wakeup,
+     .cross = {"thread_lifecycle", "dispatch_queue"}, .object = "thread_wakeup"},
+    {"thread_wakeup_ulock", collect_thread_wakeup_ulock, release_thread_wakeup,
+     .cross = {"thread_wakeup_semaphore", "dispatch_queue"}, .object = "thread_wakeup"},
+    {"thread_wakeup_unfair", collect_thread_wakeup_unfair, release_thread_wakeup,
+     .cross = {"thread_wakeup_ulock", "thread_lifecycle"}, .object = "thread_wakeup"},
+#endif
+    {"tlb_shootdown", collect_tlb_shootdown,
+     .cross = CROSS("page_fault_timing", "vm_page_timing", "page_fault_timing",
+                    "tlb_shootdown_shared")},
+    {"tlb_shootdown_shared", collect_tlb_shootdown_shared,
+     .cross = {"tlb_shootdown", "cas_contention"}, .object = "tlb_shootdown"},
+#if defined(__APPLE__)
+    {"vm_page_timing", collect_vm_page_timing,
+     .cross = {"page_fault_timing", "tlb_shootdown"}},
+#endif
+};
+
+const int poc_n_collectors = (int)(sizeof(poc_collectors) / sizeof(poc_collectors[0]));
+
+const PocCollector *poc_collector_find(const char *name) {
+    for (int i = 0; i < poc_n_collectors; i++)
+        if (strcmp(poc_collectors[i].name, name) == 0) return &poc_collectors[i];
+    return NULL;
+}
+
+static const char *object_of(const PocCollector *c) { return c->object ? c->object : c->name; }
+
+int poc_collector_group(const PocCollector *c) {
+    const char *obj = object_of(c);
+    int i = 0;
+    while (strcmp(object_of(&poc_collectors[i]), obj) != 0) i++;
+    return i;
+}
+
+const PocParam poc_params[] = {
+    {"cas_contention", "threads", &poc_cas_contention_threads, 4, 1, POC_CAS_MAX_THREADS},
+#if defined(__APPLE__)
+    {"compression_timing", "min_bytes", &poc_compression_timing_min_bytes, 128, 16, 4096},
+    {"compression_timing", "span_bytes", &poc_compression_timing_span_bytes, 384, 0, 4080},
+    {"cpu_io_beat", "lcg_iters", &poc_cpu_io_beat_lcg_iters, 50, 1, 2000},
+    {"cpu_io_beat", "write_bytes", &poc_cpu_io_beat_write_bytes, 64, 1, 4096},
+    {"cpu_io_beat", "flush_every", &poc_cpu_io_beat_flush_every, 16, 1, 1024},
+    {"cpu_memory_beat", "lcg_iters", &poc_cpu_memory_beat_lcg_iters, 50, 1, 2000},
+#endif
+    {"pipe_buffer_writev", "pipes", &poc_pipe_buffer_writev_pipes, 4, 1, POC_PIPEV_MAX_PIPES},
+    {"pipe_buffer_writev", "segments", &poc_pipe_buffer_writev_segments, 8, 1,
+     POC_PIPEV_MAX_SEGMENTS},
+    {"thread_lifecycle", "max_work", &poc_thread_lifecycle_max_work, 100, 0, 100000},
+    {"tlb_shootdown", "min_pages", &poc_tlb_shootdown_min_pages, 8, 1, 256},
+    {"tlb_shootdown", "span_pages", &poc_tlb_shootdown_span_pages, 120, 0, 255},
+};
+
+const int poc_n_params = (int)(sizeof(poc_params) / sizeof(poc_params[0]));
+
+const PocParam *poc_param_find(const char *collector, const char *name) {
+    for (int i = 0; i < poc_n_params; i++)
+        if (strcmp(poc_params[i].collector, collector) == 0 &&
+            strcmp(poc_params[i].name, name) == 0)
+            return &poc_params[i];
+    return NULL;
+}
+
+void poc_params_reset(void) {
+    for (int i = 0; i < poc_n_params; i++) *poc_params[i].value = poc_params[i].def;
+}
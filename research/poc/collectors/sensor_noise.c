@@ -0,0 +1,51 @@
+// sensor_noise.c — IORegistry sensor noise entropy collector
+// Mechanism: Take 2 in-process IORegistry snapshots (collectors/ioreg_snapshot.h)
+//            5ms apart. Compute deltas for keys that changed, matched through the
+//            hashed index. XOR consecutive deltas, extract bytes.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "collectors/ioreg_snapshot.h"
+
+#define SENSOR_LARGE_N  20000
+#define SENSOR_GAP_US   5000
+#define SENSOR_IDLE_MAX 8     // rounds without a changed value before giving up
+
+int collect_sensor_noise(uint64_t *timings, int n) {
+    int cap = n < SENSOR_LARGE_N ? n : SENSOR_LARGE_N;
+
+    IoregSnapshot snap1, snap2;
+    memset(&snap1, 0, sizeof(snap1));
+    memset(&snap2, 0, sizeof(snap2));
+
+    int valid = 0, idle = 0;
+    uint64_t prev_delta = 0;
+
+    for (int round = 0; round < cap + 10 && valid < cap && idle < SENSOR_IDLE_MAX; round++) {
+        int n1 = ioreg_snapshot_take(&snap1);
+        usleep(SENSOR_GAP_US);
+        int n2 = ioreg_snapshot_take(&snap2);
+        if (n1 == 0 || n2 == 0) break;
+
+        // Find keys present in both snapshots with changed values
+        int before = valid;
+        for (int i = 0; i < n1 && valid < cap; i++) {
+            const IoregValue *a = &snap1.vals[i];
+            const IoregValue *b = ioreg_snapshot_find(&snap2, a);
+            if (!b) continue;
+            int64_t delta = b->value - a->value;
+            if (delta != 0) {
+                uint64_t abs_delta = (uint64_t)(delta < 0 ? -delta : delta);
+                // XOR with previous delta
+                uint64_t xored = abs_delta ^ prev_delta;
+                timings[valid++] = xored;
+                prev_delta = abs_delta;
+            }
+        }
+        idle = valid == before ? idle + 1 : 0;
+    }
+
+    ioreg_snapshot_free(&snap1);
+    ioreg_snapshot_free(&snap2);
+    return valid;
+}
@@ -0,0 +1,175 @@
+// sep_signing.c — Secure Enclave signing timing entropy collector
+// Mechanism: one ephemeral P-256 key in the Secure Enclave, ECDSA signatures
+// requested from several worker threads at once, every completion timestamped
+//
+// secure_enclave_timing and keychain_sep_timing time SecRandomCopyBytes,
+// SecItem and CC_SHA256, which may be served on the application processor
+// without reaching the SEP. A signature with a kSecAttrTokenIDSecureEnclave
+// key cannot: the private key never leaves the enclave, so every
+// SecKeyCreateSignature() is a request into the SEP mailbox. The key is
+// not permanent (no keychain item, no entitlement) and is created once per
+// process. `inflight` workers sign back to back, each over its own digest,
+// so the next request is always queued; a sample is the interval between
+// consecutive completions, like coreml_ane. Without a Secure Enclave key
+// the collector returns nothing: a software key would time CPU ECDSA under
+// this collector's name.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+
+#include <stdatomic.h>
+
+#if defined(__APPLE__)
+#include <CoreFoundation/CoreFoundation.h>
+#include <Security/Security.h>
+#endif
+
+#define DEFAULT_INFLIGHT 4
+
+#if defined(__APPLE__)
+
+static SecKeyRef g_key;
+static int g_tried;
+
+static SecKeyRef create_key(void) {
+    int bits = 256;
+    CFNumberRef size = CFNumberCreate(kCFAllocatorDefault, kCFNumberIntType, &bits);
+    CFMutableDictionaryRef priv = CFDictionaryCreateMutable(
+        kCFAllocatorDefault, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+    CFMutableDictionaryRef attrs = CFDictionaryCreateMutable(
+        kCFAllocatorDefault, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+    SecAccessControlRef access = NULL;
+    SecKeyRef key = NULL;
+    if (!size || !priv || !attrs) goto done;
+
+    CFDictionarySetValue(priv, kSecAttrIsPermanent, kCFBooleanFalse);
+    CFDictionarySetValue(attrs, kSecAttrKeyType, kSecAttrKeyTypeECSECPrimeRandom);
+    CFDictionarySetValue(attrs, kSecAttrKeySizeInBits, size);
+    access = SecAccessControlCreateWithFlags(kCFAllocatorDefault,
+                                             kSecAttrAccessibleWhenUnlockedThisDeviceOnly,
+                                             kSecAccessControlPrivateKeyUsage, NULL);
+    if (!access) goto done;
+    CFDictionarySetValue(priv, kSecAttrAccessControl, access);
+    CFDictionarySetValue(attrs, kSecAttrTokenID, kSecAttrTokenIDSecureEnclave);
+    CFDictionarySetValue(attrs, kSecPrivateKeyAttrs, priv);
+    key = SecKeyCreateRandomKey(attrs, NULL);
+
+done:
+    if (access) CFRelease(access);
+    if (attrs) CFRelease(attrs);
+    if (priv) CFRelease(priv);
+    if (size) CFRelease(size);
+    return key;
+}
+
+static int load_key(void) {
+    if (g_key || g_tried) return g_key ? 0 : -1;
+    g_tried = 1;
+    g_key = create_key();
+    return g_key ? 0 : -1;
+}
+
+int poc_sep_available(void) { return load_key() == 0; }
+
+typedef struct {
+    int id;
+    int total;                  // completions wanted across all workers
+    uint64_t *stamps;
+    atomic_int *claimed;
+    atomic_int *done;
+    atomic_int *failed;
+    atomic_int *ready;
+    atomic_int *go;
+} SignWorker;
+
+static void *sign_worker(void *arg) {
+    SignWorker *w = arg;
+    poc_place_worker(POC_QOS_INHERIT, 0);
+    // The digest is signed in place: CFData over the worker's own buffer,
+    // rewritten between requests.
+    uint8_t digest[32];
+    uint64_t rng = mach_absolute_time() ^ (uint64_t)(w->id + 1) * 0x9E3779B97F4A7C15ULL;
+    CFDataRef data = CFDataCreateWithBytesNoCopy(kCFAllocatorDefault, digest, sizeof(digest),
+                                                 kCFAllocatorNull);
+    atomic_fetch_add(w->ready, 1);
+    while (!atomic_load(w->go)) {}
+
+    while (data && atomic_fetch_add(w->claimed, 1) < w->total) {
+        for (int i = 0; i < 32; i += 4) {
+            uint32_t r = (uint32_t)lcg_next(&rng);
+            memcpy(digest + i, &r, 4);
+        }
+        CFDataRef sig = SecKeyCreateSignature(g_key, kSecKeyAlgorithmECDSASignatureDigestX962SHA256,
+                                              data, NULL);
+        uint64_t t = mach_absolute_time();
+        if (sig) CFRelease(sig);
+        else atomic_fetch_add(w->failed, 1);
+        w->stamps[atomic_fetch_add(w->done, 1)] = t;
+    }
+    if (!data) atomic_fetch_add(w->failed, 1);
+    else CFRelease(data);
+    poc_place_worker_done();
+    return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+int poc_sep_run(int inflight, uint64_t *timings, int n, uint64_t *elapsed) {
+    if (inflight < 1 || inflight > POC_SEP_MAX_INFLIGHT || n < 1) return 0;
+    if (load_key() != 0) return 0;
+
+    // n intervals need n + 1 completions
+    uint64_t *stamps = malloc((size_t)(n + 1) * sizeof(uint64_t));
+    if (!stamps) return 0;
+    atomic_int claimed = 0, done = 0, failed = 0, ready = 0, go = 0;
+    SignWorker w[POC_SEP_MAX_INFLIGHT];
+    pthread_t tids[POC_SEP_MAX_INFLIGHT];
+    int started = 0;
+    for (; started < inflight; started++) {
+        w[started] = (SignWorker){started, n + 1, stamps, &claimed, &done, &failed, &ready, &go};
+        if (pthread_create(&tids[started], NULL, sign_worker, &w[started]) != 0) break;
+    }
+    while (atomic_load(&ready) < started) {}
+    uint64_t t0 = mach_absolute_time();
+    atomic_store(&go, 1);
+    for (int t = 0; t < started; t++) pthread_join(tids[t], NULL);
+    if (elapsed) *elapsed = mach_absolute_time() - t0;
+
+    int valid = 0;
+    if (started == inflight && atomic_load(&failed) == 0 && atomic_load(&done) == n + 1) {
+        // Workers can stamp and claim an index in either order
+        qsort(stamps, (size_t)n + 1, sizeof(uint64_t), cmp_u64);
+        for (int i = 0; i < n; i++) timings[valid++] = stamps[i + 1] - stamps[i];
+    }
+    free(stamps);
+    return valid;
+}
+
+void release_sep_signing(void) {
+    if (g_key) CFRelease(g_key);
+    g_key = NULL;
+    g_tried = 0;
+}
+
+#else
+
+int poc_sep_available(void) { return 0; }
+
+int poc_sep_run(int inflight, uint64_t *timings, int n, uint64_t *elapsed) {
+    (void)inflight;
+    (void)timings;
+    (void)n;
+    (void)elapsed;
+    return 0;
+}
+
+void release_sep_signing(void) {}
+
+#endif
+
+int collect_sep_signing(uint64_t *timings, int n) {
+    return poc_sep_run(DEFAULT_INFLIGHT, timings, n, NULL);
+}
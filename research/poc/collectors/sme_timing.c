@@ -0,0 +1,109 @@
+// sme_timing.c — Direct SME streaming-mode timing entropy collector
+// Mechanism: SMSTART/SMSTOP transitions and a 256-FMOPA outer-product burst,
+// timed with CNTVCT_EL0 inside one asm block (no Accelerate in the path)
+//
+// cblas_sgemm drives the matrix unit through Accelerate's dispatch, size
+// checks and thread pool. On chips with FEAT_SME (M4 and later) this times
+// the unit directly: one asm block enters streaming mode, zeroes ZA, issues
+// FMOPA outer products into the four 32-bit tiles and leaves again, reading
+// the counter between each phase. Nothing in libc runs in streaming mode.
+// Without SME both collectors fall back to collect_amx_timing().
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+
+#include <sys/sysctl.h>
+
+int poc_sme_available(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        int v = 0;
+        size_t len = sizeof(v);
+        cached = sysctlbyname("hw.optional.arm.FEAT_SME", &v, &len, NULL, 0) == 0 && v == 1;
+    }
+    return cached;
+}
+
+#if defined(__aarch64__)
+
+// SMSTOP zeroes every Z/V and P register, so the whole vector file is clobbered.
+#define SME_CLOBBERS                                                          \
+    "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v8", "v9", "v10", "v11", \
+    "v12", "v13", "v14", "v15", "v16", "v17", "v18", "v19", "v20", "v21",     \
+    "v22", "v23", "v24", "v25", "v26", "v27", "v28", "v29", "v30", "v31", "memory"
+
+// t[0] before SMSTART, t[1] in streaming mode, t[2] after the FMOPAs,
+// t[3] after SMSTOP.
+static void sme_sample(const float *a, const float *b, uint64_t t[4]) {
+    uint64_t t0, t1, t2, t3;
+    __asm__ volatile(
+        ".arch_extension sme\n"
+        "isb\n"
+        "mrs %[t0], cntvct_el0\n"
+        "smstart\n"
+        "isb\n"
+        "mrs %[t1], cntvct_el0\n"
+        "zero {za}\n"
+        "ptrue p0.s\n"
+        "ld1w {z0.s}, p0/z, [%[a]]\n"
+        "ld1w {z1.s}, p0/z, [%[b]]\n"
+        ".rept 64\n"   // 4 tiles x 64 = 256 FMOPAs
+        "fmopa za0.s, p0/m, p0/m, z0.s, z1.s\n"
+        "fmopa za1.s, p0/m, p0/m, z1.s, z0.s\n"
+        "fmopa za2.s, p0/m, p0/m, z0.s, z0.s\n"
+        "fmopa za3.s, p0/m, p0/m, z1.s, z1.s\n"
+        ".endr\n"
+        "isb\n"
+        "mrs %[t2], cntvct_el0\n"
+        "smstop\n"
+        "isb\n"
+        "mrs %[t3], cntvct_el0\n"
+        : [t0] "=&r"(t0), [t1] "=&r"(t1), [t2] "=&r"(t2), [t3] "=&r"(t3)
+        : [a] "r"(a), [b] "r"(b)
+        : SME_CLOBBERS);
+    t[0] = t0;
+    t[1] = t1;
+    t[2] = t2;
+    t[3] = t3;
+}
+
+// Operand vectors sized for the largest streaming vector length (2048 bits).
+static float g_sme_a[64], g_sme_b[64];
+
+static void sme_fill(void) {
+    uint64_t rng = mach_absolute_time();
+    for (int i = 0; i < 64; i++) {
+        g_sme_a[i] = (float)(lcg_next(&rng) & 0xFFFF) / 65536.0f;
+        g_sme_b[i] = (float)(lcg_next(&rng) & 0xFFFF) / 65536.0f;
+    }
+}
+
+// phase 0: SMSTART + SMSTOP transition cost, 1: FMOPA burst
+static int sme_collect(uint64_t *timings, int n, int phase) {
+    sme_fill();
+    for (int i = 0; i < n; i++) {
+        uint64_t t[4];
+        sme_sample(g_sme_a, g_sme_b, t);
+        timings[i] = phase ? t[2] - t[1] : (t[1] - t[0]) + (t[3] - t[2]);
+    }
+    return n;
+}
+
+#else
+
+static int sme_collect(uint64_t *timings, int n, int phase) {
+    (void)timings;
+    (void)n;
+    (void)phase;
+    return 0;
+}
+
+#endif
+
+int collect_sme_transition(uint64_t *timings, int n) {
+    return poc_sme_available() ? sme_collect(timings, n, 0) : collect_amx_timing(timings, n);
+}
+
+int collect_sme_fmopa(uint64_t *timings, int n) {
+    return poc_sme_available() ? sme_collect(timings, n, 1) : collect_amx_timing(timings, n);
+}
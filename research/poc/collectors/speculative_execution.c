@@ -0,0 +1,116 @@
+// speculative_execution.c — Entropy source collector
+// Mechanism: Data-dependent branches using LCG (10-40 iterations per batch)
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+
+int collect_speculative_execution(uint64_t *timings, int n) {
+    uint64_t lcg = mach_absolute_time();
+    volatile int sink = 0;
+    int valid = 0;
+
+    for (int i = 0; i < n; i++) {
+        // Vary batch size between 10 and 40 iterations
+        int batch = 10 + (int)(lcg_next(&lcg) % 31);
+
+        uint64_t t0 = mach_absolute_time();
+        int acc = 0;
+        for (int j = 0; j < batch; j++) {
+            uint64_t v = lcg_next(&lcg);
+            // Data-dependent branches the predictor cannot predict
+            if (v & 1)
+                acc += (int)(v >> 32);
+            else
+                acc -= (int)(v >> 16);
+
+            if (v & 2)
+                acc ^= (int)(v >> 8);
+            else
+                acc += (int)(v >> 24);
+
+            if (v & 4)
+                acc = (acc << 1) | (acc >> 31);
+            else
+                acc = (acc >> 1) | (acc << 31);
+
+            if ((v >> 3) & 1)
+                acc *= 3;
+            else
+                acc += 7;
+        }
+        sink = acc;
+        uint64_t t1 = mach_absolute_time();
+        timings[valid++] = t1 - t0;
+    }
+    (void)sink;
+    return valid;
+}
+
+// Unrolled variants: each kernel is the same four-branch step expanded
+// `len` times at compile time, fed from a value array filled before the
+// timer starts. No loop counter, loop branch or LCG update lands inside a
+// sample, so the only branches timed are the data-dependent ones. With
+// period p > 0 the step values repeat every p steps (a pattern the
+// predictor can learn once p is small); period 0 draws fresh LCG values.
+#define SPEC_STEP                                                   \
+    {                                                               \
+        uint64_t v = *vals++;                                       \
+        if (v & 1) acc += (int)(v >> 32); else acc -= (int)(v >> 16); \
+        if (v & 2) acc ^= (int)(v >> 8); else acc += (int)(v >> 24);  \
+        if (v & 4) acc = (acc << 1) | (acc >> 31);                  \
+        else acc = (acc >> 1) | (acc << 31);                        \
+        if ((v >> 3) & 1) acc *= 3; else acc += 7;                  \
+    }
+
+#define REP2(x) x x
+#define REP4(x) REP2(x) REP2(x)
+#define REP8(x) REP4(x) REP4(x)
+#define REP16(x) REP8(x) REP8(x)
+#define REP32(x) REP16(x) REP16(x)
+#define REP64(x) REP32(x) REP32(x)
+#define REP128(x) REP64(x) REP64(x)
+
+#define SPEC_KERNEL(len)                                                   \
+    static __attribute__((noinline)) int spec_kernel_##len(const uint64_t *vals) { \
+        int acc = 0;                                                       \
+        REP##len(SPEC_STEP)                                                \
+        return acc;                                                        \
+    }
+
+SPEC_KERNEL(4)
+SPEC_KERNEL(8)
+SPEC_KERNEL(16)
+SPEC_KERNEL(32)
+SPEC_KERNEL(64)
+SPEC_KERNEL(128)
+
+const PocSpecKernel poc_spec_kernels[] = {
+    {4, spec_kernel_4},   {8, spec_kernel_8},   {16, spec_kernel_16},
+    {32, spec_kernel_32}, {64, spec_kernel_64}, {128, spec_kernel_128},
+};
+const int poc_n_spec_kernels = (int)(sizeof(poc_spec_kernels) / sizeof(poc_spec_kernels[0]));
+
+int poc_spec_run(const PocSpecKernel *k, int period, uint64_t *timings, int n) {
+    uint64_t vals[POC_SPEC_MAX_LEN];
+    uint64_t pattern[POC_SPEC_MAX_LEN];
+    uint64_t lcg = mach_absolute_time();
+    if (period < 0 || period > POC_SPEC_MAX_LEN) return 0;
+    for (int j = 0; j < period; j++) pattern[j] = lcg_next(&lcg) | (lcg_next(&lcg) << 32);
+
+    volatile int sink = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < k->len; j++)
+            vals[j] = period ? pattern[j % period] : lcg_next(&lcg) | (lcg_next(&lcg) << 32);
+
+        uint64_t t0 = mach_absolute_time();
+        sink = k->fn(vals);
+        uint64_t t1 = mach_absolute_time();
+        timings[i] = t1 - t0;
+    }
+    (void)sink;
+    return n;
+}
+
+int collect_speculative_unrolled(uint64_t *timings, int n) {
+    return poc_spec_run(&poc_spec_kernels[3], 0, timings, n);
+}
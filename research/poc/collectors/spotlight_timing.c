@@ -0,0 +1,154 @@
+// spotlight_timing.c — Entropy source collector
+// Mechanism: Run mdls on system files, measure process spawn+completion time
+// Note: Capped at 200 iterations per collection to keep runtime reasonable
+//
+// spotlight_mditem stays in-process: MDItemCreate() + MDItemCopyAttribute()
+// on a rotating file × attribute set, so a sample is one metadata round
+// trip to mds rather than a fork/exec of mdls. poc_spotlight_run() can keep
+// several queries in flight from worker threads.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include <sys/wait.h>
+#include <signal.h>
+#include <stdatomic.h>
+
+#if defined(__APPLE__)
+#include <CoreServices/CoreServices.h>
+#endif
+
+static const char *g_target_files[] = {
+    "/usr/bin/true",
+    "/usr/bin/false",
+    "/usr/bin/env",
+    "/usr/bin/id",
+    "/usr/bin/who",
+    "/usr/bin/wc",
+    "/usr/bin/sort",
+    "/usr/bin/head",
+};
+static const int g_ntargets = 8;
+
+int collect_spotlight_timing(uint64_t *timings, int n) {
+    int valid = 0;
+    int devnull = open("/dev/null", O_WRONLY);
+
+    for (int i = 0; i < n; i++) {
+        const char *target = g_target_files[i % g_ntargets];
+
+        uint64_t t0 = mach_absolute_time();
+        pid_t pid = fork();
+        if (pid == 0) {
+            // Child: redirect stdout/stderr to /dev/null
+            if (devnull >= 0) {
+                dup2(devnull, STDOUT_FILENO);
+                dup2(devnull, STDERR_FILENO);
+            }
+            execl("/usr/bin/mdls", "mdls", "-name", "kMDItemFSName", target, NULL);
+            _exit(127);
+        } else if (pid > 0) {
+            int status;
+            waitpid(pid, &status, 0);
+            uint64_t t1 = mach_absolute_time();
+            timings[valid++] = t1 - t0;
+        }
+    }
+
+    if (devnull >= 0) close(devnull);
+    return valid;
+}
+
+#if defined(__APPLE__)
+
+// File paths and attribute names, built once and shared (immutable) by workers
+static CFStringRef g_paths[8];
+static CFStringRef g_attrs[4];
+
+static void mditem_prepare(void) {
+    if (g_paths[0]) return;
+    for (int i = 0; i < g_ntargets; i++)
+        g_paths[i] = CFStringCreateWithCString(kCFAllocatorDefault, g_target_files[i],
+                                               kCFStringEncodingUTF8);
+    g_attrs[0] = kMDItemFSName;
+    g_attrs[1] = kMDItemContentType;
+    g_attrs[2] = kMDItemFSSize;
+    g_attrs[3] = kMDItemContentModificationDate;
+}
+
+static void mditem_loop(uint64_t *timings, int n, int offset) {
+    for (int i = 0; i < n; i++) {
+        int k = i + offset;
+        uint64_t t0 = mach_absolute_time();
+        MDItemRef item = MDItemCreate(kCFAllocatorDefault, g_paths[k % g_ntargets]);
+        if (item) {
+            CFTypeRef v = MDItemCopyAttribute(item, g_attrs[(k / g_ntargets) % 4]);
+            if (v) CFRelease(v);
+            CFRelease(item);
+        }
+        uint64_t t1 = mach_absolute_time();
+        timings[i] = t1 - t0;
+    }
+}
+
+typedef struct {
+    int id, n;
+    uint64_t *timings;
+    atomic_int *ready;
+    atomic_int *go;
+} MdWorker;
+
+static void *mditem_worker(void *arg) {
+    MdWorker *w = arg;
+    poc_place_worker(POC_QOS_INHERIT, 0);
+    atomic_fetch_add(w->ready, 1);
+    while (!atomic_load(w->go)) {}
+    // Offset so concurrent workers ask about different files at once
+    mditem_loop(w->timings, w->n, w->id * 3);
+    poc_place_worker_done();
+    return NULL;
+}
+
+int poc_spotlight_run(int inflight, int per_query, uint64_t *out, uint64_t *elapsed) {
+    if (inflight < 1 || inflight > POC_SPOTLIGHT_MAX_INFLIGHT || per_query < 1) return -1;
+    mditem_prepare();
+
+    atomic_int ready = 0, go = 0;
+    MdWorker w[POC_SPOTLIGHT_MAX_INFLIGHT];
+    pthread_t tids[POC_SPOTLIGHT_MAX_INFLIGHT];
+    int started = 0;
+    for (; started < inflight; started++) {
+        w[started] = (MdWorker){started, per_query, out + (size_t)started * per_query,
+                                &ready, &go};
+        if (pthread_create(&tids[started], NULL, mditem_worker, &w[started]) != 0) break;
+    }
+    while (atomic_load(&ready) < started) {}
+    uint64_t t0 = mach_absolute_time();
+    atomic_store(&go, 1);
+    for (int t = 0; t < started; t++) pthread_join(tids[t], NULL);
+    if (elapsed) *elapsed = mach_absolute_time() - t0;
+    return started == inflight ? 0 : -1;
+}
+
+int collect_spotlight_mditem(uint64_t *timings, int n) {
+    mditem_prepare();
+    mditem_loop(timings, n, 0);
+    return n;
+}
+
+#else
+
+int poc_spotlight_run(int inflight, int per_query, uint64_t *out, uint64_t *elapsed) {
+    (void)inflight;
+    (void)per_query;
+    (void)out;
+    (void)elapsed;
+    return -1;
+}
+
+int collect_spotlight_mditem(uint64_t *timings, int n) {
+    (void)timings;
+    (void)n;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,46 @@
+// thread_lifecycle.c — Thread create/join timing entropy collector
+// Mechanism: Create pthread, run small workload (0-100 iterations), join, measure total time
+//
+// The workload bound is a registry tunable (poc_tune); 100 is the default.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+
+int poc_thread_lifecycle_max_work = 100;
+
+struct thread_work {
+    int iterations;
+    volatile uint64_t result;
+};
+
+static void *thread_worker(void *arg) {
+    struct thread_work *w = (struct thread_work *)arg;
+    volatile uint64_t acc = 0;
+    for (int i = 0; i < w->iterations; i++) {
+        acc += (uint64_t)i * 7 + 13;
+    }
+    w->result = acc;
+    return NULL;
+}
+
+int collect_thread_lifecycle(uint64_t *timings, int n) {
+    uint64_t rng = mach_absolute_time();
+    int valid = 0;
+    const uint64_t span = (uint64_t)(poc_thread_lifecycle_max_work < 0 ? 0
+                                     : poc_thread_lifecycle_max_work) + 1;
+
+    for (int i = 0; i < n; i++) {
+        struct thread_work work;
+        work.iterations = (int)(lcg_next(&rng) % span); // 0-max_work
+        work.result = 0;
+
+        pthread_t tid;
+        uint64_t t0 = mach_absolute_time();
+        if (pthread_create(&tid, NULL, thread_worker, &work) != 0) continue;
+        pthread_join(tid, NULL);
+        uint64_t t1 = mach_absolute_time();
+
+        timings[valid++] = t1 - t0;
+    }
+    return valid;
+}
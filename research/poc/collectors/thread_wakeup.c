@@ -0,0 +1,214 @@
+// thread_wakeup.c — Parked worker-pool wake-to-run latency collectors
+// Mechanism: NUM_WORKERS threads stay parked in the kernel; each sample
+// stamps the time, wakes one worker, and the worker records now - stamp.
+// Workers rotate so every wake targets a thread that has slept a full
+// round. Three wake paths, one registry entry each:
+//   thread_wakeup_semaphore  — Mach semaphore_signal / semaphore_wait
+//   thread_wakeup_ulock      — __ulock_wake / __ulock_wait on a 32-bit word
+//   thread_wakeup_unfair     — os_unfair_lock handoff (waker unlocks, worker acquires)
+// Unlike thread_lifecycle (pthread_create + join) and dispatch_queue (pipe
+// write + read), only the wake-to-run path is on the clock.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+
+#include <os/lock.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#define NUM_WORKERS 4
+#define WAKE_TIMEOUT_NS 2000000000ull   // a wake unanswered this long is an error
+
+// libsystem_kernel private futex-style wait/wake (what os_unfair_lock uses).
+#define UL_COMPARE_AND_WAIT 1
+extern int __ulock_wait(uint32_t operation, void *addr, uint64_t value, uint32_t timeout);
+extern int __ulock_wake(uint32_t operation, void *addr, uint64_t wake_value);
+
+typedef enum { WAKE_SEMAPHORE, WAKE_ULOCK, WAKE_UNFAIR } WakeMode;
+
+typedef struct {
+    _Alignas(128) _Atomic uint32_t seq;   // ulock word / request number
+    _Atomic uint32_t armed;               // unfair: times the waker has (re)taken the lock
+    _Atomic uint64_t stamp;               // waker's clock at the wake
+    _Atomic uint64_t latency;
+    _Atomic uint32_t done;                // last request served
+    _Atomic int dead;                     // worker exited on a wait error
+    semaphore_t sem;
+    os_unfair_lock lock;
+    int held;                             // unfair: the waker holds lock
+    pthread_t thread;
+} Parked;
+
+static Parked g_pool[NUM_WORKERS];
+static WakeMode g_mode;
+static int g_started;
+static _Atomic int g_stop;
+
+static void serve(Parked *p, uint32_t req) {
+    uint64_t now = mach_absolute_time();
+    atomic_store_explicit(&p->latency, now - atomic_load_explicit(&p->stamp, memory_order_relaxed),
+                          memory_order_relaxed);
+    atomic_store_explicit(&p->done, req, memory_order_release);
+}
+
+static void *parked_worker(void *arg) {
+    Parked *p = arg;
+    poc_place_worker(POC_QOS_INHERIT, 0);
+    uint32_t seen = 0, want = 1;
+    while (!atomic_load(&g_stop)) {
+        switch (g_mode) {
+        case WAKE_SEMAPHORE:
+        {
+            // KERN_ABORTED is an interrupted wait, not a wake: park again.
+            kern_return_t kr;
+            do kr = semaphore_wait(p->sem);
+            while (kr == KERN_ABORTED);
+            if (kr != KERN_SUCCESS) {
+                atomic_store(&p->dead, 1);
+                poc_place_worker_done();
+                return NULL;
+            }
+            break;
+        }
+        case WAKE_ULOCK:
+            // Returns when the word moves off `seen` (or spuriously).
+            while (atomic_load_explicit(&p->seq, memory_order_acquire) == seen &&
+                   !atomic_load(&g_stop))
+                __ulock_wait(UL_COMPARE_AND_WAIT, &p->seq, seen, 0);
+            break;
+        case WAKE_UNFAIR:
+            // Only contend once the waker holds the lock again, so the lock
+            // call really blocks until the next wake drops it.
+            while (atomic_load_explicit(&p->armed, memory_order_acquire) < want &&
+                   !atomic_load(&g_stop))
+                sched_yield();
+            os_unfair_lock_lock(&p->lock);
+            want++;
+            break;
+        }
+        if (atomic_load(&g_stop)) {
+            if (g_mode == WAKE_UNFAIR) os_unfair_lock_unlock(&p->lock);
+            break;
+        }
+        uint32_t req = atomic_load_explicit(&p->seq, memory_order_acquire);
+        serve(p, req);
+        if (g_mode == WAKE_UNFAIR) os_unfair_lock_unlock(&p->lock);
+        seen = req;
+    }
+    poc_place_worker_done();
+    return NULL;
+}
+
+void release_thread_wakeup(void) {
+    if (!g_started) return;
+    atomic_store(&g_stop, 1);
+    for (int i = 0; i < NUM_WORKERS; i++) {
+        Parked *p = &g_pool[i];
+        switch (g_mode) {
+        case WAKE_SEMAPHORE:
+            semaphore_signal(p->sem);
+            break;
+        case WAKE_ULOCK:
+            atomic_fetch_add(&p->seq, 1);
+            __ulock_wake(UL_COMPARE_AND_WAIT, &p->seq, 0);
+            break;
+        case WAKE_UNFAIR:
+            if (p->held) os_unfair_lock_unlock(&p->lock);
+            break;
+        }
+        pthread_join(p->thread, NULL);
+        if (g_mode == WAKE_SEMAPHORE) semaphore_destroy(mach_task_self(), p->sem);
+    }
+    g_started = 0;
+}
+
+static int start_pool(WakeMode mode) {
+    if (g_started && g_mode == mode) return 0;
+    release_thread_wakeup();
+
+    g_mode = mode;
+    atomic_store(&g_stop, 0);
+    for (int i = 0; i < NUM_WORKERS; i++) {
+        Parked *p = &g_pool[i];
+        memset(p, 0, sizeof(*p));
+        p->lock = OS_UNFAIR_LOCK_INIT;
+        if (mode == WAKE_SEMAPHORE &&
+            semaphore_create(mach_task_self(), &p->sem, SYNC_POLICY_FIFO, 0) != KERN_SUCCESS)
+            return -1;
+        // The waker owns each unfair lock between samples.
+        if (mode == WAKE_UNFAIR) {
+            os_unfair_lock_lock(&p->lock);
+            p->held = 1;
+            atomic_store(&p->armed, 1);
+        }
+    }
+    for (int i = 0; i < NUM_WORKERS; i++)
+        pthread_create(&g_pool[i].thread, NULL, parked_worker, &g_pool[i]);
+    g_started = 1;
+    usleep(10000); // Let workers park
+    return 0;
+}
+
+// Off the clock: wait for the worker to serve req. 0, or -1 when it died
+// or did not answer within WAKE_TIMEOUT_NS.
+static int await_served(Parked *p, uint32_t req, uint64_t timeout_ticks) {
+    uint64_t t0 = mach_absolute_time();
+    while (atomic_load_explicit(&p->done, memory_order_acquire) != req) {
+        if (atomic_load(&p->dead) || mach_absolute_time() - t0 > timeout_ticks) return -1;
+        sched_yield();
+    }
+    return 0;
+}
+
+static int collect_wakeup(WakeMode mode, uint64_t *timings, int n) {
+    if (start_pool(mode) != 0) return 0;
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    uint64_t timeout_ticks = WAKE_TIMEOUT_NS * tb.denom / tb.numer;
+    int valid = 0;
+
+    for (int i = 0; i < n; i++) {
+        Parked *p = &g_pool[i % NUM_WORKERS];
+        uint32_t req = atomic_load_explicit(&p->seq, memory_order_relaxed) + 1;
+        atomic_store_explicit(&p->stamp, mach_absolute_time(), memory_order_relaxed);
+        atomic_store_explicit(&p->seq, req, memory_order_release);
+        switch (mode) {
+        case WAKE_SEMAPHORE:
+            semaphore_signal(p->sem);
+            break;
+        case WAKE_ULOCK:
+            __ulock_wake(UL_COMPARE_AND_WAIT, &p->seq, 0);
+            break;
+        case WAKE_UNFAIR:
+            p->held = 0;
+            os_unfair_lock_unlock(&p->lock);
+            break;
+        }
+
+        // Off the clock: wait for the worker, then re-park it.
+        if (await_served(p, req, timeout_ticks) != 0) {
+            fprintf(stderr, "thread_wakeup: worker %d did not answer wake %u\n",
+                    i % NUM_WORKERS, req);
+            return 0;
+        }
+        if (mode == WAKE_UNFAIR) {
+            os_unfair_lock_lock(&p->lock);
+            p->held = 1;
+            atomic_fetch_add_explicit(&p->armed, 1, memory_order_release);
+        }
+        timings[valid++] = atomic_load_explicit(&p->latency, memory_order_relaxed);
+    }
+    return valid;
+}
+
+int collect_thread_wakeup_semaphore(uint64_t *timings, int n) {
+    return collect_wakeup(WAKE_SEMAPHORE, timings, n);
+}
+
+int collect_thread_wakeup_ulock(uint64_t *timings, int n) {
+    return collect_wakeup(WAKE_ULOCK, timings, n);
+}
+
+int collect_thread_wakeup_unfair(uint64_t *timings, int n) {
+    return collect_wakeup(WAKE_UNFAIR, timings, n);
+}
@@ -0,0 +1,129 @@
+// tlb_shootdown.c — TLB shootdown timing entropy collector
+// Mechanism: mmap 256-page region, mprotect random page ranges, measure timing variance
+//
+// With helpers == 0 only the calling thread has the region in its TLB, so
+// the kernel rarely needs to interrupt another core. poc_tlb_run() can
+// also start helper threads (each with its own affinity tag, so they land
+// on other cores) that keep reading every page. A PROT_READ downgrade then
+// has to invalidate live entries on each helper's core, and every mprotect
+// pair waits on real cross-core shootdown IPIs. Helpers only read, so the
+// read-only window never faults them.
+//
+// The page-count range (min_pages .. min_pages + span_pages, clamped to the
+// region) is a registry tunable (poc_tune); 8-128 is the default.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+
+#include <sched.h>
+#include <stdatomic.h>
+
+#define TLB_PAGES 256
+#define TLB_REGION_SIZE (TLB_PAGES * 4096)
+#define SHARED_HELPERS 3   // registry default for tlb_shootdown_shared
+
+int poc_tlb_shootdown_min_pages = 8;
+int poc_tlb_shootdown_span_pages = 120;
+
+typedef struct {
+    volatile uint8_t *region;
+    int tag;
+    atomic_int *ready;
+    atomic_int *stop;
+} TlbHelper;
+
+static void *helper_thread(void *arg) {
+    TlbHelper *h = arg;
+    poc_place_worker(POC_QOS_USER_INTERACTIVE, h->tag);
+
+    uint8_t sink = 0;
+    int announced = 0;
+    while (!atomic_load_explicit(h->stop, memory_order_relaxed)) {
+        for (int i = 0; i < TLB_PAGES; i++) sink ^= h->region[i * 4096];
+        if (!announced) {
+            atomic_fetch_add(h->ready, 1);
+            announced = 1;
+        }
+    }
+    (void)sink;
+    poc_place_worker_done();
+    return NULL;
+}
+
+int poc_tlb_run(int helpers, uint64_t *timings, int n, uint64_t *syscall_ticks) {
+    if (helpers < 0 || helpers > POC_TLB_MAX_HELPERS) return 0;
+
+    void *region = mmap(NULL, TLB_REGION_SIZE, PROT_READ | PROT_WRITE,
+                        MAP_ANON | MAP_PRIVATE, -1, 0);
+    if (region == MAP_FAILED) return 0;
+
+    // Touch all pages to populate TLB
+    volatile uint8_t *p = (volatile uint8_t *)region;
+    for (int i = 0; i < TLB_PAGES; i++) {
+        p[i * 4096] = (uint8_t)i;
+    }
+
+    // Start the sharers and wait until each has walked the whole region once
+    atomic_int ready = 0, stop = 0;
+    TlbHelper h[POC_TLB_MAX_HELPERS];
+    pthread_t tids[POC_TLB_MAX_HELPERS];
+    int started = 0;
+    for (; started < helpers; started++) {
+        h[started] = (TlbHelper){p, started + 1, &ready, &stop};
+        if (pthread_create(&tids[started], NULL, helper_thread, &h[started]) != 0) break;
+    }
+    while (atomic_load(&ready) < started) sched_yield();
+
+    uint64_t rng = mach_absolute_time();
+    int valid = 0;
+    uint64_t prev_delta = 0, total = 0;
+    const int min_pages = poc_tlb_shootdown_min_pages < 1 ? 1
+                        : poc_tlb_shootdown_min_pages > TLB_PAGES ? TLB_PAGES
+                        : poc_tlb_shootdown_min_pages;
+    int span = poc_tlb_shootdown_span_pages < 0 ? 0 : poc_tlb_shootdown_span_pages;
+    if (min_pages + span > TLB_PAGES) span = TLB_PAGES - min_pages;
+
+    if (started == helpers) {
+        for (int i = 0; i < n + 1; i++) {
+            // Random page count min_pages..min_pages+span and random offset
+            int page_count = min_pages + (int)(lcg_next(&rng) % (uint64_t)(span + 1));
+            int max_off = TLB_PAGES - page_count;
+            if (max_off < 1) max_off = 1;
+            int offset = (int)(lcg_next(&rng) % max_off);
+
+            void *target = (uint8_t *)region + offset * 4096;
+            size_t len = (size_t)page_count * 4096;
+
+            uint64_t t0 = mach_absolute_time();
+            mprotect(target, len, PROT_READ);
+            mprotect(target, len, PROT_READ | PROT_WRITE);
+            uint64_t t1 = mach_absolute_time();
+
+            uint64_t delta = t1 - t0;
+            total += delta;
+
+            // Use delta-of-deltas (variance extraction) for entropy
+            if (i > 0) {
+                uint64_t dd = (delta > prev_delta) ? (delta - prev_delta) : (prev_delta - delta);
+                timings[valid++] = dd;
+            }
+            prev_delta = delta;
+
+            if (valid >= n) break;
+        }
+    }
+
+    atomic_store(&stop, 1);
+    for (int t = 0; t < started; t++) pthread_join(tids[t], NULL);
+    munmap(region, TLB_REGION_SIZE);
+    if (syscall_ticks) *syscall_ticks = total;
+    return valid;
+}
+
+int collect_tlb_shootdown(uint64_t *timings, int n) {
+    return poc_tlb_run(0, timings, n, NULL);
+}
+
+int collect_tlb_shootdown_shared(uint64_t *timings, int n) {
+    return poc_tlb_run(SHARED_HELPERS, timings, n, NULL);
+}
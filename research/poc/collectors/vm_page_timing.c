@@ -0,0 +1,33 @@
+// vm_page_timing.c — Entropy source collector
+// Mechanism: mmap(MAP_ANON), write_volatile, read_volatile, munmap cycle timing
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+
+int collect_vm_page_timing(uint64_t *timings, int n) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    int valid = 0;
+
+    for (int i = 0; i < n; i++) {
+        uint64_t t0 = mach_absolute_time();
+
+        volatile uint8_t *p = (volatile uint8_t *)mmap(NULL, (size_t)page_size,
+            PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
+        if (p == MAP_FAILED) continue;
+
+        // Write volatile to force page materialization
+        *p = 0x42;
+        p[page_size / 2] = 0x43;
+
+        // Read volatile
+        volatile uint8_t v = *p;
+        v = p[page_size / 2];
+        (void)v;
+
+        munmap((void *)p, (size_t)page_size);
+
+        uint64_t t1 = mach_absolute_time();
+        timings[valid++] = t1 - t0;
+    }
+    return valid;
+}
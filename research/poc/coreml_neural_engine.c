@@ -10,6 +10,10 @@
 // Since CoreML requires Objective-C, we use a simpler approach:
 // vDSP/Accelerate routines that dispatch to the Neural Engine when available,
 // or measure the BNNS (Basic Neural Network Subroutines) framework timing.
+//
+// vDSP and BNNS execute on the CPU / AMX, not the Neural Engine. For samples
+// from the ANE itself see collectors/coreml_ane.m (make validate_coreml_ane),
+// which pipelines async predictions of a real Core ML model.
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -14,30 +14,16 @@
 #include <Security/Security.h>
 #include <CoreFoundation/CoreFoundation.h>
 
-#define N 5000
-#define ARRAY_SIZE (16 * 1024 * 1024)
+#include "lib/poc_arena.h"
+#include "lib/poc_stats.h"
+#include "lib/poc_xcorr.h"
 
-static double pearson(uint64_t *a, uint64_t *b, int n) {
-    double ma = 0, mb = 0;
-    for (int i = 0; i < n; i++) { ma += a[i]; mb += b[i]; }
-    ma /= n; mb /= n;
-
-    double num = 0, da = 0, db = 0;
-    for (int i = 0; i < n; i++) {
-        double x = a[i] - ma, y = b[i] - mb;
-        num += x * y;
-        da += x * x;
-        db += y * y;
-    }
-    if (da < 1e-15 || db < 1e-15) return 0;
-    return num / sqrt(da * db);
-}
+#define POC_TS_SOURCE POC_TS_CNTVCT_ISB
+#include "lib/poc_time.h"
 
-static inline uint64_t read_counter(void) {
-    uint64_t val;
-    __asm__ volatile("isb\nmrs %0, CNTVCT_EL0" : "=r"(val));
-    return val;
-}
+#define N 5000
+#define XCORR_MAX_LAG 512
+#define ARRAY_SIZE (16 * 1024 * 1024)
 
 static inline void dmb(void) {
     __asm__ volatile("dmb sy" ::: "memory");
@@ -49,21 +35,18 @@ int main(void) {
     // === Collect DMP confusion timings ===
     uint64_t *dmp_t = malloc(N * sizeof(uint64_t));
     {
-        uint64_t *array = mmap(NULL, ARRAY_SIZE, PROT_READ | PROT_WRITE,
-                               MAP_PRIVATE | MAP_ANON, -1, 0);
-        uint64_t base = (uint64_t)array;
-        size_t n_el = ARRAY_SIZE / sizeof(uint64_t);
         uint64_t lcg = mach_absolute_time() | 1;
-        for (size_t i = 0; i < n_el; i++) {
-            lcg = lcg * 6364136223846793005ULL + 1;
-            array[i] = base + ((lcg >> 16) % n_el) * 8;
-        }
+        PocArena arena;
+        if (poc_arena_init(&arena, ARRAY_SIZE, lcg) != 0) { perror("mmap"); return 1; }
+        uint64_t *array = arena.words;
+        uint64_t base = arena.base;
+        size_t n_el = arena.n;
         volatile uint64_t sink = 0;
         for (int i = 0; i < N; i++) {
             lcg = lcg * 6364136223846793005ULL + 1;
             size_t idx = (lcg >> 16) % (n_el - 256);
             dmb();
-            uint64_t t0 = read_counter();
+            uint64_t t0 = poc_ts();
             uint64_t val = array[idx];
             size_t next = (val - base) / 8;
             if (next < n_el) {
@@ -72,10 +55,10 @@ int main(void) {
                 if (n2 < n_el) { sink += array[n2]; sink += array[idx > 64 ? idx-64 : 0]; }
             }
             dmb();
-            uint64_t t1 = read_counter();
+            uint64_t t1 = poc_ts();
             dmp_t[i] = t1 - t0;
         }
-        munmap(array, ARRAY_SIZE);
+        poc_arena_free(&arena);
     }
 
     // === Collect keychain timings ===
@@ -132,11 +115,11 @@ int main(void) {
             size_t off2 = (lcg >> 16) % arr_size;
 
             dmb();
-            uint64_t t0 = read_counter();
+            uint64_t t0 = poc_ts();
             arr[off1]++;
             arr[off2]++;
             dmb();
-            uint64_t t1 = read_counter();
+            uint64_t t1 = poc_ts();
             cache_t[i] = t1 - t0;
         }
         munmap((void*)arr, arr_size);
@@ -217,6 +200,19 @@ int main(void) {
     }
     if (!any_flagged) printf("  (none — all sources appear independent)\n");
 
+    // Zero-lag Pearson misses coupling that is offset in time (a shared
+    // scheduler tick or DVFS step lands on one source a few samples later).
+    printf("\nLagged coupling (peak |r| over lags ±%d):\n", XCORR_MAX_LAG);
+    static double xc[2 * XCORR_MAX_LAG + 1];
+    for (int i = 0; i < n_streams; i++) {
+        for (int j = i + 1; j < n_streams; j++) {
+            if (poc_xcorr(streams[i], streams[j], N, XCORR_MAX_LAG, xc) != 0) continue;
+            PocLagPeak pk = poc_xcorr_peak(xc, XCORR_MAX_LAG);
+            printf("  %-16s × %-16s: lag %+4d  r=%+.4f%s\n", names[i], names[j],
+                   pk.lag, pk.r, fabs(pk.r) > 0.10 ? "  ***" : "");
+        }
+    }
+
     for (int i = 0; i < n_streams; i++) free(streams[i]);
     return 0;
 }
@@ -15,18 +15,16 @@
 #include <string.h>
 #include <math.h>
 #include <mach/mach_time.h>
-#include <sys/mman.h>
 #include <pthread.h>
 
+#include "lib/poc_arena.h"
+
+#define POC_TS_SOURCE POC_TS_CNTVCT_ISB
+#include "lib/poc_time.h"
+
 #define N_SAMPLES 50000
 #define ARRAY_SIZE (16 * 1024 * 1024)
 
-static inline uint64_t read_counter(void) {
-    uint64_t val;
-    __asm__ volatile("isb\nmrs %0, CNTVCT_EL0" : "=r"(val));
-    return val;
-}
-
 static inline void memory_barrier(void) {
     __asm__ volatile("dmb sy" ::: "memory");
 }
@@ -105,20 +103,14 @@ static void analyze(const char *name, uint64_t *timings, int n) {
 int main(void) {
     printf("# DMP Confusion — Refined (50K samples)\n\n");
 
-    uint64_t *array = mmap(NULL, ARRAY_SIZE, PROT_READ | PROT_WRITE,
-                           MAP_PRIVATE | MAP_ANON, -1, 0);
-    if (array == MAP_FAILED) { perror("mmap"); return 1; }
-
-    uint64_t base = (uint64_t)array;
-    size_t n_elements = ARRAY_SIZE / sizeof(uint64_t);
+    // Pointer-like values; each variant below gets a freshly randomized graph
     uint64_t lcg = mach_absolute_time() | 1;
+    PocArena arena;
+    if (poc_arena_init(&arena, ARRAY_SIZE, lcg) != 0) { perror("mmap"); return 1; }
 
-    // Fill with pointer-like values
-    for (size_t i = 0; i < n_elements; i++) {
-        lcg = lcg * 6364136223846793005ULL + 1;
-        size_t offset = (lcg >> 16) % n_elements;
-        array[i] = base + offset * sizeof(uint64_t);
-    }
+    uint64_t *array = arena.words;
+    uint64_t base = arena.base;
+    size_t n_elements = arena.n;
 
     // ===== VARIANT A: Pure DMP confusion (original best approach) =====
     {
@@ -130,7 +122,7 @@ int main(void) {
             size_t idx = (lcg >> 16) % (n_elements - 256);
 
             memory_barrier();
-            uint64_t t0 = read_counter();
+            uint64_t t0 = poc_ts();
 
             uint64_t val = array[idx];
             size_t next = (val - base) / sizeof(uint64_t);
@@ -140,12 +132,13 @@ int main(void) {
             sink += array[surprise];
 
             memory_barrier();
-            uint64_t t1 = read_counter();
+            uint64_t t1 = poc_ts();
             timings[i] = t1 - t0;
         }
         analyze("DMP Confusion (standard)", timings, N_SAMPLES);
     }
 
+    poc_arena_randomize(&arena, lcg);
     // ===== VARIANT B: Triple-hop with direction reversal =====
     {
         uint64_t timings[N_SAMPLES];
@@ -156,7 +149,7 @@ int main(void) {
             size_t idx = (lcg >> 16) % (n_elements - 256);
 
             memory_barrier();
-            uint64_t t0 = read_counter();
+            uint64_t t0 = poc_ts();
 
             // Triple pointer chase + reversal
             uint64_t val = array[idx];
@@ -172,12 +165,13 @@ int main(void) {
             }
 
             memory_barrier();
-            uint64_t t1 = read_counter();
+            uint64_t t1 = poc_ts();
             timings[i] = t1 - t0;
         }
         analyze("DMP Triple-hop Reversal", timings, N_SAMPLES);
     }
 
+    poc_arena_randomize(&arena, lcg);
     // ===== VARIANT C: Alternating stride with DMP bait =====
     {
         uint64_t timings[N_SAMPLES];
@@ -194,7 +188,7 @@ int main(void) {
             }
 
             memory_barrier();
-            uint64_t t0 = read_counter();
+            uint64_t t0 = poc_ts();
 
             // "Confuse" phase: completely random access (DMP gets it wrong)
             lcg = lcg * 6364136223846793005ULL + 1;
@@ -205,12 +199,13 @@ int main(void) {
             sink += array[rnd2];
 
             memory_barrier();
-            uint64_t t1 = read_counter();
+            uint64_t t1 = poc_ts();
             timings[i] = t1 - t0;
         }
         analyze("DMP Train-Confuse Alternation", timings, N_SAMPLES);
     }
 
+    poc_arena_randomize(&arena, lcg);
     // ===== VARIANT D: Cross-page DMP confusion (4KB boundary crossing) =====
     {
         uint64_t timings[N_SAMPLES];
@@ -225,7 +220,7 @@ int main(void) {
             if (idx >= n_elements) idx = n_elements - 1;
 
             memory_barrier();
-            uint64_t t0 = read_counter();
+            uint64_t t0 = poc_ts();
 
             // Read from page boundary — DMP may or may not cross page
             uint64_t val = array[idx];
@@ -239,12 +234,12 @@ int main(void) {
             }
 
             memory_barrier();
-            uint64_t t1 = read_counter();
+            uint64_t t1 = poc_ts();
             timings[i] = t1 - t0;
         }
         analyze("DMP Cross-page Confusion", timings, N_SAMPLES);
     }
 
-    munmap(array, ARRAY_SIZE);
+    poc_arena_free(&arena);
     return 0;
 }
@@ -5,15 +5,18 @@
  * and computes the Pearson correlation coefficient between every pair.
  * Any pair with |r| > 0.15 is flagged as potentially redundant.
  *
+ * The matrix is computed in one pass as Z·Zᵀ over standardized rows
+ * (lib/poc_corrmat.h). With --parallel, collectors that do not spawn their
+ * own threads run concurrently, one thread per collector, each with its
+ * own affinity tag; the rest (marked exclusive) still run alone afterwards.
+ *
  * NOTE: This C program tests representative TIMING patterns from each source.
  * For a full correlation test using the actual Rust source implementations,
  * use the Rust integration test in crates/openentropy-tests/ instead.
  *
- * Build: clang -O2 -framework IOKit -framework CoreFoundation -framework Security \
- *        -framework CoreAudio -framework Accelerate -framework Metal \
- *        -o full_correlation_audit full_correlation_audit.c -lm
+ * Build: make full_correlation_audit
  *
- * Run: ./full_correlation_audit
+ * Run: ./full_correlation_audit [--parallel]
  */
 
 #include <fcntl.h>
@@ -22,6 +25,7 @@
 #include <mach/mach_time.h>
 #include <pthread.h>
 #include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -30,48 +34,35 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "lib/poc_corrmat.h"
+#include "lib/poc_fsync.h"
+#include "lib/poc_load.h"
+#include "lib/poc_place.h"
+
 #define N_SAMPLES 10000
-#define N_SOURCES 14  /* Number of non-hardware-dependent sources we can test in C */
-
-/* Source names for the correlation matrix output. */
-static const char *SOURCE_NAMES[N_SOURCES] = {
-    "thread_lifecycle",
-    "mach_ipc",
-    "tlb_shootdown",
-    "pipe_buffer",
-    "kqueue_events",
-    "dvfs_race",
-    "cas_contention",
-    "denormal_timing",
-    "fsync_journal",
-    "nvme_latency",
-    "pdn_resonance",
-    "amx_timing",
-    "mach_timing",     /* baseline: existing source */
-    "clock_jitter",    /* baseline: existing source */
-};
 
-static double samples[N_SOURCES][N_SAMPLES];
+/* One row per source; sized for every PoC collector, not just these. */
+static double samples[POC_MAX_SOURCES][N_SAMPLES];
 
 /*
  * Collect timing samples for each source.
- * Each function stores `N_SAMPLES` timing deltas in the `samples` array.
+ * Each function stores `N_SAMPLES` timing deltas in its row `out`.
  */
 
-/* 0: thread_lifecycle — spawn+join timing */
-static void collect_thread_lifecycle(void) {
+/* thread_lifecycle — spawn+join timing */
+static void collect_thread_lifecycle(double *out) {
     for (int i = 0; i < N_SAMPLES; i++) {
         uint64_t t0 = mach_absolute_time();
         pthread_t th;
         pthread_create(&th, NULL, (void *(*)(void *))pthread_exit, NULL);
         pthread_join(th, NULL);
         uint64_t t1 = mach_absolute_time();
-        samples[0][i] = (double)(t1 - t0);
+        out[i] = (double)(t1 - t0);
     }
 }
 
-/* 1: mach_ipc — port allocate/deallocate timing */
-static void collect_mach_ipc(void) {
+/* mach_ipc — port allocate/deallocate timing */
+static void collect_mach_ipc(double *out) {
     mach_port_t task = mach_task_self();
     for (int i = 0; i < N_SAMPLES; i++) {
         mach_port_t port;
@@ -80,12 +71,12 @@ static void collect_mach_ipc(void) {
         mach_port_deallocate(task, port);
         mach_port_mod_refs(task, port, MACH_PORT_RIGHT_RECEIVE, -1);
         uint64_t t1 = mach_absolute_time();
-        samples[1][i] = (double)(t1 - t0);
+        out[i] = (double)(t1 - t0);
     }
 }
 
-/* 2: tlb_shootdown — mprotect timing */
-static void collect_tlb_shootdown(void) {
+/* tlb_shootdown — mprotect timing */
+static void collect_tlb_shootdown(double *out) {
     size_t page_size = sysconf(_SC_PAGESIZE);
     size_t region_size = page_size * 256;
     void *addr = mmap(NULL, region_size, PROT_READ | PROT_WRITE,
@@ -101,13 +92,13 @@ static void collect_tlb_shootdown(void) {
         mprotect(addr, region_size, PROT_READ);
         mprotect(addr, region_size, PROT_READ | PROT_WRITE);
         uint64_t t1 = mach_absolute_time();
-        samples[2][i] = (double)(t1 - t0);
+        out[i] = (double)(t1 - t0);
     }
     munmap(addr, region_size);
 }
 
-/* 3: pipe_buffer — pipe write+read timing */
-static void collect_pipe_buffer(void) {
+/* pipe_buffer — pipe write+read timing */
+static void collect_pipe_buffer(double *out) {
     for (int i = 0; i < N_SAMPLES; i++) {
         int fds[2];
         uint64_t t0 = mach_absolute_time();
@@ -118,32 +109,39 @@ static void collect_pipe_buffer(void) {
         close(fds[0]);
         close(fds[1]);
         uint64_t t1 = mach_absolute_time();
-        samples[3][i] = (double)(t1 - t0);
+        out[i] = (double)(t1 - t0);
     }
 }
 
-/* 4: kqueue_events — kevent with timer timing */
-static void collect_kqueue_events(void) {
+/* kqueue_events — batched kevent drain over 8 timers, one sample per call */
+static void collect_kqueue_events(double *out) {
     int kq = kqueue();
     if (kq < 0) return;
 
-    struct kevent ev;
-    EV_SET(&ev, 1, EVFILT_TIMER, EV_ADD | EV_ENABLE, 0, 1, NULL);
-    kevent(kq, &ev, 1, NULL, 0, NULL);
+    /* 8 timers at 1-8ms so one call usually drains several events. */
+    struct kevent evs[8];
+    for (int t = 0; t < 8; t++)
+        EV_SET(&evs[t], 1 + t, EVFILT_TIMER, EV_ADD | EV_ENABLE, 0, 1 + t, NULL);
+    kevent(kq, evs, 8, NULL, 0, NULL);
 
     struct timespec ts = {0, 1000000}; /* 1ms timeout */
 
+    /*
+     * One sample per kevent call: its duration only. The drained events'
+     * expirations, idents and batch positions are deterministic given the
+     * timer schedule, so folding them in would add apparent entropy that
+     * is not timing noise.
+     */
     for (int i = 0; i < N_SAMPLES; i++) {
-        struct kevent out;
         uint64_t t0 = mach_absolute_time();
-        kevent(kq, NULL, 0, &out, 1, &ts);
+        kevent(kq, NULL, 0, evs, 8, &ts);
         uint64_t t1 = mach_absolute_time();
-        samples[4][i] = (double)(t1 - t0);
+        out[i] = (double)(t1 - t0);
     }
     close(kq);
 }
 
-/* 5: dvfs_race — two-thread race counting */
+/* dvfs_race — two-thread race counting */
 static volatile int dvfs_stop;
 static volatile uint64_t dvfs_count1, dvfs_count2;
 
@@ -154,7 +152,7 @@ static void *dvfs_racer(void *arg) {
     return NULL;
 }
 
-static void collect_dvfs_race(void) {
+static void collect_dvfs_race(double *out) {
     for (int i = 0; i < N_SAMPLES; i++) {
         dvfs_stop = 0;
         dvfs_count1 = dvfs_count2 = 0;
@@ -173,26 +171,26 @@ static void collect_dvfs_race(void) {
         uint64_t diff = dvfs_count1 > dvfs_count2
                             ? dvfs_count1 - dvfs_count2
                             : dvfs_count2 - dvfs_count1;
-        samples[5][i] = (double)diff;
+        out[i] = (double)diff;
     }
 }
 
-/* 6: cas_contention — atomic CAS timing */
+/* cas_contention — atomic CAS timing */
 static atomic_uint_fast64_t cas_target;
 
-static void collect_cas_contention(void) {
+static void collect_cas_contention(double *out) {
     for (int i = 0; i < N_SAMPLES; i++) {
         uint64_t t0 = mach_absolute_time();
         uint64_t expected = atomic_load_explicit(&cas_target, memory_order_relaxed);
         atomic_compare_exchange_weak_explicit(&cas_target, &expected, expected + 1,
                                               memory_order_acq_rel, memory_order_relaxed);
         uint64_t t1 = mach_absolute_time();
-        samples[6][i] = (double)(t1 - t0);
+        out[i] = (double)(t1 - t0);
     }
 }
 
-/* 7: denormal_timing — FPU denormal operation timing */
-static void collect_denormal_timing(void) {
+/* denormal_timing — FPU denormal operation timing */
+static void collect_denormal_timing(double *out) {
     for (int i = 0; i < N_SAMPLES; i++) {
         double acc = 5e-324; /* smallest denormal */
         uint64_t t0 = mach_absolute_time();
@@ -202,31 +200,38 @@ static void collect_denormal_timing(void) {
         }
         uint64_t t1 = mach_absolute_time();
         *(volatile double *)&acc; /* prevent optimization */
-        samples[7][i] = (double)(t1 - t0);
+        out[i] = (double)(t1 - t0);
     }
 }
 
-/* 8: fsync_journal — file write+fsync timing */
-static void collect_fsync_journal(void) {
-    for (int i = 0; i < N_SAMPLES; i++) {
-        char path[256];
-        snprintf(path, sizeof(path), "/tmp/oe_corr_%d_%d", getpid(), i);
-        int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0600);
-        if (fd < 0) continue;
-        char buf[512] = {0};
-        buf[0] = i & 0xFF;
-        uint64_t t0 = mach_absolute_time();
-        write(fd, buf, sizeof(buf));
-        fsync(fd);
-        uint64_t t1 = mach_absolute_time();
-        close(fd);
-        unlink(path);
-        samples[8][i] = (double)(t1 - t0);
+/*
+ * fsync_journal — concurrent journal commits: FSYNC_WORKERS threads each
+ * fsync their own preallocated files (lib/poc_fsync.h). Samples are
+ * interleaved across workers so neighbouring indices overlapped in time.
+ */
+#define FSYNC_WORKERS 4
+static void collect_fsync_journal(double *out) {
+    char dir[] = "/tmp/oe_corr_fsync_XXXXXX";
+    if (!mkdtemp(dir)) return;
+    PocFsyncConfig cfg = {
+        .workers = FSYNC_WORKERS,
+        .files_per_worker = 4,
+        .commits = N_SAMPLES / FSYNC_WORKERS,
+        .write_size = 512,
+        .file_size = 256 * 1024,
+        .mode = POC_FSYNC_PLAIN,
+    };
+    uint64_t *t = malloc((size_t)N_SAMPLES * sizeof(uint64_t));
+    if (t && poc_fsync_run(dir, &cfg, t, NULL) > 0) {
+        for (int i = 0; i < cfg.workers * cfg.commits; i++)
+            out[i] = (double)t[(i % FSYNC_WORKERS) * cfg.commits + i / FSYNC_WORKERS];
     }
+    free(t);
+    rmdir(dir);
 }
 
-/* 9: nvme_latency — file read with F_NOCACHE timing */
-static void collect_nvme_latency(void) {
+/* nvme_latency — file read with F_NOCACHE timing */
+static void collect_nvme_latency(double *out) {
     char path[256];
     snprintf(path, sizeof(path), "/tmp/oe_nvme_%d", getpid());
     int fd = open(path, O_CREAT | O_RDWR | O_TRUNC, 0600);
@@ -245,29 +250,17 @@ static void collect_nvme_latency(void) {
         uint64_t t0 = mach_absolute_time();
         read(fd, rbuf, sizeof(rbuf));
         uint64_t t1 = mach_absolute_time();
-        samples[9][i] = (double)(t1 - t0);
+        out[i] = (double)(t1 - t0);
     }
     close(fd);
     unlink(path);
 }
 
-/* 10: pdn_resonance — timing with stress threads */
-static volatile int pdn_stop;
-
-static void *pdn_stress_mem(void *arg) {
-    uint64_t *buf = malloc(4 * 1024 * 1024);
-    while (!pdn_stop) {
-        for (size_t i = 0; i < 512 * 1024; i += 64)
-            buf[i]++;
-    }
-    free(buf);
-    return NULL;
-}
-
-static void collect_pdn_resonance(void) {
-    pdn_stop = 0;
-    pthread_t stress;
-    pthread_create(&stress, NULL, pdn_stress_mem, NULL);
+/* pdn_resonance — timing with a memory stress thread (lib/poc_load.h) */
+static void collect_pdn_resonance(double *out) {
+    static const PocLoadProfile stress_mem = {"mem", POC_LOAD_MEMORY, 1, 100};
+    PocLoad stress;
+    poc_load_start(&stress, &stress_mem);
     usleep(1000); /* warmup */
 
     for (int i = 0; i < N_SAMPLES; i++) {
@@ -275,15 +268,14 @@ static void collect_pdn_resonance(void) {
         volatile uint64_t acc = 0;
         for (int j = 0; j < 100; j++) acc += j;
         uint64_t t1 = mach_absolute_time();
-        samples[10][i] = (double)(t1 - t0);
+        out[i] = (double)(t1 - t0);
     }
-    pdn_stop = 1;
-    pthread_join(stress, NULL);
+    poc_load_stop(&stress);
 }
 
-/* 11: amx_timing — cblas_sgemm timing (Accelerate framework) */
+/* amx_timing — cblas_sgemm timing (Accelerate framework) */
 /* Note: linking Accelerate would be needed; use a proxy FP workload. */
-static void collect_amx_timing(void) {
+static void collect_amx_timing(double *out) {
     /* Matrix multiply proxy using plain C (approximates AMX path). */
     float a[64 * 64], b[64 * 64], c[64 * 64];
     for (int k = 0; k < 64 * 64; k++) {
@@ -305,93 +297,154 @@ static void collect_amx_timing(void) {
             }
         uint64_t t1 = mach_absolute_time();
         *(volatile float *)&c[0];
-        samples[11][i] = (double)(t1 - t0);
+        out[i] = (double)(t1 - t0);
     }
 }
 
-/* 12: mach_timing — baseline: just mach_absolute_time differences */
-static void collect_mach_timing(void) {
+/* mach_timing — baseline: just mach_absolute_time differences */
+static void collect_mach_timing(double *out) {
     for (int i = 0; i < N_SAMPLES; i++) {
         uint64_t t0 = mach_absolute_time();
         /* Minimal work. */
         for (volatile int j = 0; j < 10; j++)
             ;
         uint64_t t1 = mach_absolute_time();
-        samples[12][i] = (double)(t1 - t0);
+        out[i] = (double)(t1 - t0);
     }
 }
 
-/* 13: clock_jitter — baseline: consecutive timestamp differences */
-static void collect_clock_jitter(void) {
+/* clock_jitter — baseline: consecutive timestamp differences */
+static void collect_clock_jitter(double *out) {
     for (int i = 0; i < N_SAMPLES; i++) {
         uint64_t t0 = mach_absolute_time();
         uint64_t t1 = mach_absolute_time();
-        samples[13][i] = (double)(t1 - t0);
+        out[i] = (double)(t1 - t0);
     }
 }
 
+typedef struct {
+    const char *name;
+    void (*collect)(double *out);
+    int exclusive; /* spawns its own threads: never run alongside others */
+} AuditSource;
+
+static const AuditSource SOURCES[] = {
+    {"thread_lifecycle", collect_thread_lifecycle, 1},
+    {"mach_ipc",         collect_mach_ipc,         0},
+    {"tlb_shootdown",    collect_tlb_shootdown,    0},
+    {"pipe_buffer",      collect_pipe_buffer,      0},
+    {"kqueue_events",    collect_kqueue_events,    0},
+    {"dvfs_race",        collect_dvfs_race,        1},
+    {"cas_contention",   collect_cas_contention,   0},
+    {"denormal_timing",  collect_denormal_timing,  0},
+    {"fsync_journal",    collect_fsync_journal,    1},
+    {"nvme_latency",     collect_nvme_latency,     0},
+    {"pdn_resonance",    collect_pdn_resonance,    1},
+    {"amx_timing",       collect_amx_timing,       0},
+    {"mach_timing",      collect_mach_timing,      0}, /* baseline: existing source */
+    {"clock_jitter",     collect_clock_jitter,     0}, /* baseline: existing source */
+};
+
+#define N_SOURCES ((int)(sizeof(SOURCES) / sizeof(SOURCES[0])))
+_Static_assert(sizeof(SOURCES) / sizeof(SOURCES[0]) <= POC_MAX_SOURCES,
+               "samples[] has fewer rows than SOURCES");
+
 /*
- * Pearson correlation coefficient between two sample arrays.
+ * Parallel collection: one worker per non-exclusive source. Workers take
+ * distinct affinity tags so the scheduler spreads them across cores, then
+ * spin on a shared flag so every collector starts at the same instant.
  */
-static double pearson(const double *x, const double *y, int n) {
-    double sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
-    for (int i = 0; i < n; i++) {
-        sx += x[i];
-        sy += y[i];
-        sxx += x[i] * x[i];
-        syy += y[i] * y[i];
-        sxy += x[i] * y[i];
-    }
-    double num = n * sxy - sx * sy;
-    double den = sqrt((n * sxx - sx * sx) * (n * syy - sy * sy));
-    if (den < 1e-12) return 0.0;
-    return num / den;
+static atomic_int par_ready;
+static atomic_int par_go;
+
+static void *parallel_worker(void *arg) {
+    int s = (int)(intptr_t)arg;
+    poc_place_apply(POC_QOS_INHERIT, s + 1);
+    atomic_fetch_add(&par_ready, 1);
+    while (!atomic_load(&par_go))
+        ;
+    SOURCES[s].collect(samples[s]);
+    return NULL;
 }
 
-typedef void (*collect_fn)(void);
-
-static collect_fn collectors[N_SOURCES] = {
-    collect_thread_lifecycle,
-    collect_mach_ipc,
-    collect_tlb_shootdown,
-    collect_pipe_buffer,
-    collect_kqueue_events,
-    collect_dvfs_race,
-    collect_cas_contention,
-    collect_denormal_timing,
-    collect_fsync_journal,
-    collect_nvme_latency,
-    collect_pdn_resonance,
-    collect_amx_timing,
-    collect_mach_timing,
-    collect_clock_jitter,
-};
+static void collect_parallel(void) {
+    pthread_t th[POC_MAX_SOURCES];
+    int started[POC_MAX_SOURCES] = {0};
+    int workers = 0;
+    for (int s = 0; s < N_SOURCES; s++) {
+        if (SOURCES[s].exclusive) continue;
+        int err = pthread_create(&th[s], NULL, parallel_worker, (void *)(intptr_t)s);
+        if (err != 0) {
+            /* Collected serially below with the exclusive sources. */
+            fprintf(stderr, "pthread_create(%s): %s\n", SOURCES[s].name, strerror(err));
+            continue;
+        }
+        started[s] = 1;
+        workers++;
+    }
+    while (atomic_load(&par_ready) < workers)
+        ;
+    printf("Collecting %d sources concurrently ... ", workers);
+    fflush(stdout);
+    atomic_store(&par_go, 1);
+    for (int s = 0; s < N_SOURCES; s++)
+        if (started[s]) pthread_join(th[s], NULL);
+    printf("done\n");
 
-int main(void) {
-    printf("Full Correlation Audit — %d samples per source\n\n", N_SAMPLES);
+    for (int s = 0; s < N_SOURCES; s++) {
+        if (started[s]) continue;
+        printf("Collecting: %-20s ... ", SOURCES[s].name);
+        fflush(stdout);
+        SOURCES[s].collect(samples[s]);
+        printf("done\n");
+    }
+}
 
-    /* Collect from all sources. */
+static void collect_serial(void) {
     for (int s = 0; s < N_SOURCES; s++) {
-        printf("Collecting: %-20s ... ", SOURCE_NAMES[s]);
+        printf("Collecting: %-20s ... ", SOURCES[s].name);
         fflush(stdout);
-        collectors[s]();
+        SOURCES[s].collect(samples[s]);
         printf("done\n");
     }
+}
+
+int main(int argc, char **argv) {
+    int parallel = argc > 1 && strcmp(argv[1], "--parallel") == 0;
+    printf("Full Correlation Audit — %d samples per source%s\n\n", N_SAMPLES,
+           parallel ? " (parallel collection)" : "");
+
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    uint64_t c0 = mach_absolute_time();
+    if (parallel)
+        collect_parallel();
+    else
+        collect_serial();
+    uint64_t c1 = mach_absolute_time();
+    printf("Collection wall time: %.2fs\n", (double)(c1 - c0) * tb.numer / tb.denom / 1e9);
+
+    static double corr[POC_MAX_SOURCES * POC_MAX_SOURCES];
+    if (poc_corr_matrix(&samples[0][0], N_SOURCES, N_SAMPLES, N_SAMPLES, corr) != 0) {
+        fprintf(stderr, "correlation matrix: out of memory\n");
+        return 1;
+    }
+#define R(i, j) corr[(i) * N_SOURCES + (j)]
 
     printf("\n=== CORRELATION MATRIX ===\n\n");
 
     /* Print header. */
     printf("%-20s", "");
     for (int j = 0; j < N_SOURCES; j++)
-        printf(" %8.8s", SOURCE_NAMES[j]);
+        printf(" %8.8s", SOURCES[j].name);
     printf("\n");
 
     int flagged = 0;
 
     for (int i = 0; i < N_SOURCES; i++) {
-        printf("%-20s", SOURCE_NAMES[i]);
+        printf("%-20s", SOURCES[i].name);
         for (int j = 0; j < N_SOURCES; j++) {
-            double r = pearson(samples[i], samples[j], N_SAMPLES);
+            double r = R(i, j);
             printf(" %8.4f", r);
             if (i < j && fabs(r) > 0.15) {
                 flagged++;
@@ -403,10 +456,10 @@ int main(void) {
     printf("\n=== FLAGGED PAIRS (|r| > 0.15) ===\n\n");
     for (int i = 0; i < N_SOURCES; i++) {
         for (int j = i + 1; j < N_SOURCES; j++) {
-            double r = pearson(samples[i], samples[j], N_SAMPLES);
+            double r = R(i, j);
             if (fabs(r) > 0.15) {
                 printf("  WARNING: %s <-> %s : r = %.4f\n",
-                       SOURCE_NAMES[i], SOURCE_NAMES[j], r);
+                       SOURCES[i].name, SOURCES[j].name, r);
             }
         }
     }
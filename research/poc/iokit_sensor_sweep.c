@@ -3,6 +3,14 @@
 // Goes beyond what ioreg -l shows — uses IORegistryEntryCreateCFProperties
 // on every IOService to find hidden sensor ADC values, counters, and
 // other rapidly-changing numeric values that might contain entropy.
+//
+// Discovery then poll: DISCOVERY_READS full-dictionary sweeps find the
+// properties whose values actually change. Only those (entry handle + key)
+// are kept, and every later read is a single IORegistryEntryCreateCFProperty.
+//
+//   ./iokit_sensor_sweep             discover, poll each hot key N_READS times, rank by H∞
+//   ./iokit_sensor_sweep --poll [N]  discover, then stream "class/prop<TAB>delta" for
+//                                    N rounds (0 = until interrupted)
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -13,221 +21,284 @@
 #include <IOKit/IOKitLib.h>
 #include <CoreFoundation/CoreFoundation.h>
 
-#define N_READS 100  // Read each property this many times to detect changes
+#define N_READS 100         // Poll each changing property this many times
+#define DISCOVERY_READS 4   // Full-dictionary sweeps used to find changing properties
 
 typedef struct {
-    char class_name[256];
-    char prop_name[256];
+    io_registry_entry_t entry;  // retained
+    CFStringRef key;            // retained
+    CFIndex data_len;           // 0 for CFNumber, else CFData length
+    char class_name[128];
+    char prop_name[300];
     int64_t values[N_READS];
     int n_values;
     int n_unique;
     double shannon;
     double min_entropy;
-} PropertyResult;
-
-static int n_results = 0;
-static PropertyResult results[10000];
-
-static void analyze_property(const char *class_name, const char *prop_name,
-                              int64_t *values, int n) {
-    if (n < 10) return;
-
-    // Count unique values
-    int64_t unique[N_READS];
-    int n_unique = 0;
-    for (int i = 0; i < n; i++) {
-        int found = 0;
-        for (int j = 0; j < n_unique; j++) {
-            if (unique[j] == values[i]) { found = 1; break; }
-        }
-        if (!found && n_unique < N_READS) unique[n_unique++] = values[i];
-    }
+} HotKey;
 
-    // Skip if constant
-    if (n_unique <= 1) return;
+static HotKey *hot;
+static int n_hot, hot_cap;
 
-    // Compute delta LSB histogram
-    int hist[256] = {0};
-    int n_deltas = 0;
-    for (int i = 1; i < n; i++) {
-        int64_t d = values[i] - values[i-1];
-        hist[((uint64_t)d) & 0xFF]++;
-        n_deltas++;
+// CFNumber, or the first 8 bytes of a CFData of the expected length.
+static int read_value(CFTypeRef v, CFIndex data_len, int64_t *out) {
+    if (!v) return 0;
+    if (data_len == 0) {
+        if (CFGetTypeID(v) != CFNumberGetTypeID()) return 0;
+        return CFNumberGetValue((CFNumberRef)v, kCFNumberSInt64Type, out) ? 1 : 0;
     }
+    if (CFGetTypeID(v) != CFDataGetTypeID() || CFDataGetLength((CFDataRef)v) != data_len)
+        return 0;
+    const uint8_t *bytes = CFDataGetBytePtr((CFDataRef)v);
+    *out = 0;
+    for (CFIndex b = 0; b < data_len && b < 8; b++) *out |= ((int64_t)bytes[b]) << (b * 8);
+    return 1;
+}
 
-    if (n_deltas < 10) return;
+static int poll_key(const HotKey *h, int64_t *out) {
+    CFTypeRef v = IORegistryEntryCreateCFProperty(h->entry, h->key, kCFAllocatorDefault, 0);
+    if (!v) return 0;
+    int ok = read_value(v, h->data_len, out);
+    CFRelease(v);
+    return ok;
+}
 
-    double shannon = 0.0;
-    int max_count = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            double p = (double)hist[i] / n_deltas;
-            shannon -= p * log2(p);
-        }
-        if (hist[i] > max_count) max_count = hist[i];
-    }
-    double min_entropy = -log2((double)max_count / n_deltas);
-
-    if (n_results < 10000) {
-        PropertyResult *r = &results[n_results++];
-        strncpy(r->class_name, class_name, 255);
-        strncpy(r->prop_name, prop_name, 255);
-        memcpy(r->values, values, n * sizeof(int64_t));
-        r->n_values = n;
-        r->n_unique = n_unique;
-        r->shannon = shannon;
-        r->min_entropy = min_entropy;
+static HotKey *add_hot(io_registry_entry_t entry, const char *class_name, CFStringRef key,
+                       const char *prop_name, CFIndex data_len) {
+    if (n_hot == hot_cap) {
+        int cap = hot_cap ? hot_cap * 2 : 256;
+        HotKey *p = realloc(hot, (size_t)cap * sizeof(HotKey));
+        if (!p) return NULL;
+        hot = p;
+        hot_cap = cap;
     }
+    HotKey *h = &hot[n_hot++];
+    memset(h, 0, sizeof(*h));
+    IOObjectRetain(entry);
+    CFRetain(key);
+    h->entry = entry;
+    h->key = key;
+    h->data_len = data_len;
+    snprintf(h->class_name, sizeof(h->class_name), "%s", class_name);
+    if (data_len)
+        snprintf(h->prop_name, sizeof(h->prop_name), "%s[data:%ldb]", prop_name, (long)data_len);
+    else
+        snprintf(h->prop_name, sizeof(h->prop_name), "%s", prop_name);
+    return h;
 }
 
-static void scan_entry(io_registry_entry_t entry) {
-    // Get class name
+// Read the entry's full dictionary DISCOVERY_READS times and keep every
+// numeric / small-data property whose value moved.
+static void discover_entry(io_registry_entry_t entry) {
     io_name_t className;
     IOObjectGetClass(entry, className);
 
-    // Get all properties
-    CFMutableDictionaryRef props = NULL;
-    if (IORegistryEntryCreateCFProperties(entry, &props, kCFAllocatorDefault, 0) != KERN_SUCCESS || !props) {
+    CFMutableDictionaryRef snaps[DISCOVERY_READS];
+    int n_snaps = 0;
+    for (int r = 0; r < DISCOVERY_READS; r++) {
+        CFMutableDictionaryRef p = NULL;
+        if (IORegistryEntryCreateCFProperties(entry, &p, kCFAllocatorDefault, 0) == KERN_SUCCESS && p)
+            snaps[n_snaps++] = p;
+    }
+    if (n_snaps < 2) {
+        for (int r = 0; r < n_snaps; r++) CFRelease(snaps[r]);
         return;
     }
 
-    // Iterate all properties looking for numeric values
-    CFIndex count = CFDictionaryGetCount(props);
+    CFIndex count = CFDictionaryGetCount(snaps[0]);
     if (count > 0 && count < 1000) {
         const void **keys = malloc(count * sizeof(void*));
         const void **vals = malloc(count * sizeof(void*));
-        CFDictionaryGetKeysAndValues(props, keys, vals);
+        CFDictionaryGetKeysAndValues(snaps[0], keys, vals);
 
         for (CFIndex i = 0; i < count; i++) {
             if (CFGetTypeID(keys[i]) != CFStringGetTypeID()) continue;
 
-            char propName[256];
-            CFStringGetCString((CFStringRef)keys[i], propName, sizeof(propName), kCFStringEncodingUTF8);
-
-            // Check if value is numeric
+            CFIndex data_len;
             if (CFGetTypeID(vals[i]) == CFNumberGetTypeID()) {
-                int64_t val;
-                CFNumberGetValue((CFNumberRef)vals[i], kCFNumberSInt64Type, &val);
-
-                // Read this property multiple times rapidly
-                int64_t readings[N_READS];
-                readings[0] = val;
-                int n_read = 1;
-
-                for (int r = 1; r < N_READS; r++) {
-                    CFMutableDictionaryRef p2 = NULL;
-                    if (IORegistryEntryCreateCFProperties(entry, &p2, kCFAllocatorDefault, 0) == KERN_SUCCESS && p2) {
-                        CFNumberRef num = (CFNumberRef)CFDictionaryGetValue(p2, keys[i]);
-                        if (num && CFGetTypeID(num) == CFNumberGetTypeID()) {
-                            CFNumberGetValue(num, kCFNumberSInt64Type, &readings[n_read++]);
-                        }
-                        CFRelease(p2);
-                    }
-                }
-
-                analyze_property(className, propName, readings, n_read);
+                data_len = 0;
+            } else if (CFGetTypeID(vals[i]) == CFDataGetTypeID()) {
+                // Also check CFData for raw sensor bytes
+                data_len = CFDataGetLength((CFDataRef)vals[i]);
+                if (data_len < 4 || data_len > 64) continue;
+            } else {
+                continue;
             }
-            // Also check CFData for raw sensor bytes
-            else if (CFGetTypeID(vals[i]) == CFDataGetTypeID()) {
-                CFDataRef data = (CFDataRef)vals[i];
-                CFIndex len = CFDataGetLength(data);
-                if (len >= 4 && len <= 64) {
-                    // Read as raw bytes, treat first 8 bytes as uint64
-                    const uint8_t *bytes = CFDataGetBytePtr(data);
-                    int64_t readings[N_READS];
-                    readings[0] = 0;
-                    for (int b = 0; b < len && b < 8; b++) {
-                        readings[0] |= ((int64_t)bytes[b]) << (b * 8);
-                    }
-                    int n_read = 1;
-
-                    for (int r = 1; r < N_READS; r++) {
-                        CFMutableDictionaryRef p2 = NULL;
-                        if (IORegistryEntryCreateCFProperties(entry, &p2, kCFAllocatorDefault, 0) == KERN_SUCCESS && p2) {
-                            CFDataRef d2 = (CFDataRef)CFDictionaryGetValue(p2, keys[i]);
-                            if (d2 && CFGetTypeID(d2) == CFDataGetTypeID() && CFDataGetLength(d2) == len) {
-                                const uint8_t *b2 = CFDataGetBytePtr(d2);
-                                readings[n_read] = 0;
-                                for (int b = 0; b < len && b < 8; b++) {
-                                    readings[n_read] |= ((int64_t)b2[b]) << (b * 8);
-                                }
-                                n_read++;
-                            }
-                            CFRelease(p2);
-                        }
-                    }
-
-                    char dataName[300];
-                    snprintf(dataName, sizeof(dataName), "%s[data:%ldb]", propName, (long)len);
-                    analyze_property(className, dataName, readings, n_read);
-                }
+
+            int64_t first, v;
+            if (!read_value(vals[i], data_len, &first)) continue;
+            int changed = 0;
+            for (int r = 1; r < n_snaps && !changed; r++) {
+                if (read_value(CFDictionaryGetValue(snaps[r], keys[i]), data_len, &v) && v != first)
+                    changed = 1;
             }
+            if (!changed) continue;
+
+            char propName[256];
+            CFStringGetCString((CFStringRef)keys[i], propName, sizeof(propName), kCFStringEncodingUTF8);
+            add_hot(entry, className, (CFStringRef)keys[i], propName, data_len);
         }
 
         free(keys);
         free(vals);
     }
 
-    CFRelease(props);
+    for (int r = 0; r < n_snaps; r++) CFRelease(snaps[r]);
 }
 
-int main(void) {
-    printf("# IOKit Deep Sensor Sweep\n");
-    printf("# Scanning ALL IORegistry entries for rapidly-changing numeric values...\n\n");
-
-    // Iterate all IOService entries in the registry
+static int discover_matching(const char *class_name) {
     io_iterator_t iter;
     kern_return_t kr = IOServiceGetMatchingServices(
-        kIOMainPortDefault, IOServiceMatching("IOService"), &iter);
-
-    if (kr != KERN_SUCCESS) {
-        fprintf(stderr, "Failed to get IOService iterator: %d\n", kr);
-        return 1;
-    }
+        kIOMainPortDefault, IOServiceMatching(class_name), &iter);
+    if (kr != KERN_SUCCESS) return -1;
 
     int n_scanned = 0;
     io_registry_entry_t entry;
     while ((entry = IOIteratorNext(iter)) != 0) {
-        scan_entry(entry);
+        discover_entry(entry);
         IOObjectRelease(entry);
         n_scanned++;
     }
     IOObjectRelease(iter);
+    return n_scanned;
+}
 
-    // Also scan the IOPower plane
-    kr = IOServiceGetMatchingServices(
-        kIOMainPortDefault, IOServiceMatching("AppleSMCKeysEndpoint"), &iter);
-    if (kr == KERN_SUCCESS) {
-        while ((entry = IOIteratorNext(iter)) != 0) {
-            scan_entry(entry);
-            IOObjectRelease(entry);
-            n_scanned++;
-        }
-        IOObjectRelease(iter);
+static int cmp_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Returns 1 if the property is worth ranking.
+static int analyze_property(HotKey *h) {
+    int n = h->n_values;
+    if (n < 10) return 0;
+
+    // Count unique values on a sorted copy
+    int64_t sorted[N_READS];
+    memcpy(sorted, h->values, n * sizeof(int64_t));
+    qsort(sorted, n, sizeof(int64_t), cmp_i64);
+    int n_unique = 1;
+    for (int i = 1; i < n; i++) n_unique += sorted[i] != sorted[i - 1];
+
+    // Skip if constant
+    if (n_unique <= 1) return 0;
+
+    // Compute delta LSB histogram
+    int hist[256] = {0};
+    int n_deltas = 0;
+    for (int i = 1; i < n; i++) {
+        int64_t d = h->values[i] - h->values[i-1];
+        hist[((uint64_t)d) & 0xFF]++;
+        n_deltas++;
     }
 
-    printf("Scanned %d IORegistry entries, found %d changing properties\n\n", n_scanned, n_results);
+    if (n_deltas < 10) return 0;
 
-    // Sort by min_entropy descending
-    for (int i = 0; i < n_results - 1; i++) {
-        for (int j = i + 1; j < n_results; j++) {
-            if (results[j].min_entropy > results[i].min_entropy) {
-                PropertyResult tmp = results[i];
-                results[i] = results[j];
-                results[j] = tmp;
-            }
+    double shannon = 0.0;
+    int max_count = 0;
+    for (int i = 0; i < 256; i++) {
+        if (hist[i] > 0) {
+            double p = (double)hist[i] / n_deltas;
+            shannon -= p * log2(p);
         }
+        if (hist[i] > max_count) max_count = hist[i];
     }
+    h->n_unique = n_unique;
+    h->shannon = shannon;
+    h->min_entropy = -log2((double)max_count / n_deltas);
+    return 1;
+}
+
+static int cmp_min_entropy_desc(const void *a, const void *b) {
+    const HotKey *x = *(const HotKey *const *)a, *y = *(const HotKey *const *)b;
+    return (y->min_entropy > x->min_entropy) - (y->min_entropy < x->min_entropy);
+}
+
+static void sweep(void) {
+    // Round-robin so consecutive reads of one key are a full pass apart
+    for (int r = 0; r < N_READS; r++)
+        for (int i = 0; i < n_hot; i++) {
+            HotKey *h = &hot[i];
+            if (poll_key(h, &h->values[h->n_values])) h->n_values++;
+        }
+
+    HotKey **ranked = malloc((n_hot ? n_hot : 1) * sizeof(HotKey *));
+    if (!ranked) return;
+    int n_ranked = 0;
+    for (int i = 0; i < n_hot; i++)
+        if (analyze_property(&hot[i])) ranked[n_ranked++] = &hot[i];
+    qsort(ranked, n_ranked, sizeof(HotKey *), cmp_min_entropy_desc);
+
+    printf("Found %d changing properties\n\n", n_ranked);
 
     // Print top results
     printf("Top changing properties (by H∞):\n");
     printf("%-30s %-40s %8s %8s %8s\n", "Class", "Property", "Unique", "Shannon", "H∞");
     printf("%-30s %-40s %8s %8s %8s\n", "-----", "--------", "------", "-------", "--");
-    for (int i = 0; i < n_results && i < 50; i++) {
-        PropertyResult *r = &results[i];
+    for (int i = 0; i < n_ranked && i < 50; i++) {
+        HotKey *r = ranked[i];
         printf("%-30s %-40s %8d %8.3f %8.3f\n",
                r->class_name, r->prop_name, r->n_unique, r->shannon, r->min_entropy);
     }
+    free(ranked);
+}
+
+static void poll_forever(long rounds) {
+    int64_t *last = malloc((n_hot ? n_hot : 1) * sizeof(int64_t));
+    int *have = calloc(n_hot ? n_hot : 1, sizeof(int));
+    if (!last || !have) { free(last); free(have); return; }
+
+    for (long r = 0; rounds == 0 || r < rounds; r++) {
+        for (int i = 0; i < n_hot; i++) {
+            int64_t v;
+            if (!poll_key(&hot[i], &v)) continue;
+            if (have[i] && v != last[i])
+                printf("%s/%s\t%lld\n", hot[i].class_name, hot[i].prop_name,
+                       (long long)(v - last[i]));
+            last[i] = v;
+            have[i] = 1;
+        }
+        fflush(stdout);
+    }
+    free(last);
+    free(have);
+}
+
+int main(int argc, char **argv) {
+    int poll = argc > 1 && strcmp(argv[1], "--poll") == 0;
+    long rounds = poll && argc > 2 ? strtol(argv[2], NULL, 10) : 0;
+
+    // Status goes to stderr in --poll mode so stdout stays pure TSV
+    FILE *info = poll ? stderr : stdout;
+    fprintf(info, "# IOKit Deep Sensor Sweep\n");
+    fprintf(info, "# Scanning ALL IORegistry entries for rapidly-changing numeric values...\n\n");
 
+    uint64_t t0 = mach_absolute_time();
+
+    // Iterate all IOService entries in the registry
+    int n_scanned = discover_matching("IOService");
+    if (n_scanned < 0) {
+        fprintf(stderr, "Failed to get IOService iterator\n");
+        return 1;
+    }
+
+    // Also scan the SMC keys endpoint
+    int n_smc = discover_matching("AppleSMCKeysEndpoint");
+    if (n_smc > 0) n_scanned += n_smc;
+
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    double disc_ms = (double)(mach_absolute_time() - t0) * tb.numer / tb.denom / 1e6;
+    fprintf(info, "Scanned %d IORegistry entries in %.0f ms, %d properties changed during discovery\n",
+            n_scanned, disc_ms, n_hot);
+
+    if (poll) poll_forever(rounds);
+    else sweep();
+
+    for (int i = 0; i < n_hot; i++) {
+        CFRelease(hot[i].key);
+        IOObjectRelease(hot[i].entry);
+    }
+    free(hot);
     return 0;
 }
@@ -13,6 +13,8 @@
 #include <CoreFoundation/CoreFoundation.h>
 #include <CommonCrypto/CommonDigest.h>
 
+#include "lib/poc_keychain.h"
+
 #define N_SAMPLES 10000
 
 static void analyze_timings(const char *name, uint64_t *timings, int n) {
@@ -102,45 +104,29 @@ int main(void) {
         analyze_timings("SecRandomCopyBytes(1)", timings, N_SAMPLES);
     }
 
-    // ===== TEST 3: SecItemAdd/Delete cycle timing (full Keychain path) =====
+    // ===== TEST 3: SecItemAdd timing (full Keychain path) =====
+    // Dictionaries come from one reusable batch; items are deleted in bulk
+    // after the loop rather than between adds.
     {
         uint64_t timings[N_SAMPLES / 10];  // Slower, fewer samples
         int valid = 0;
-
-        for (int i = 0; i < N_SAMPLES / 10; i++) {
-            char label[64];
-            snprintf(label, sizeof(label), "entropy-test-%d", i);
-            CFStringRef labelRef = CFStringCreateWithCString(NULL, label, kCFStringEncodingUTF8);
-
-            // Create a small keychain item
-            uint8_t secret[16] = {(uint8_t)i};
-            CFDataRef secretData = CFDataCreate(NULL, secret, sizeof(secret));
-
-            CFMutableDictionaryRef attrs = CFDictionaryCreateMutable(
-                NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-            CFDictionarySetValue(attrs, kSecClass, kSecClassGenericPassword);
-            CFDictionarySetValue(attrs, kSecAttrLabel, labelRef);
-            CFDictionarySetValue(attrs, kSecValueData, secretData);
-
-            uint64_t t0 = mach_absolute_time();
-            OSStatus status = SecItemAdd(attrs, NULL);
-            uint64_t t1 = mach_absolute_time();
-
-            if (status == errSecSuccess || status == errSecDuplicateItem) {
-                timings[valid++] = t1 - t0;
+        PocKcBatch b;
+
+        if (poc_kc_batch_init(&b, "org.openentropy.keychain-sep-timing", "entropy-test",
+                              N_SAMPLES / 10, 0) == 0) {
+            poc_kc_delete_all(&b);
+            for (int i = 0; i < N_SAMPLES / 10; i++) {
+                poc_kc_select(&b, i);
+                uint64_t t0 = mach_absolute_time();
+                OSStatus status = SecItemAdd(b.attrs, NULL);
+                uint64_t t1 = mach_absolute_time();
+
+                if (status == errSecSuccess || status == errSecDuplicateItem) {
+                    timings[valid++] = t1 - t0;
+                }
             }
-
-            // Clean up — delete the item
-            CFMutableDictionaryRef query = CFDictionaryCreateMutable(
-                NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-            CFDictionarySetValue(query, kSecClass, kSecClassGenericPassword);
-            CFDictionarySetValue(query, kSecAttrLabel, labelRef);
-            SecItemDelete(query);
-
-            CFRelease(query);
-            CFRelease(attrs);
-            CFRelease(secretData);
-            CFRelease(labelRef);
+            poc_kc_delete_all(&b);
+            poc_kc_batch_free(&b);
         }
         if (valid > 10) {
             analyze_timings("SecItemAdd (Keychain write)", timings, valid);
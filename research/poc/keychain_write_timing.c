@@ -3,6 +3,11 @@
 // This goes through: userspace → securityd → SEP → APFS COW write → return
 // Every component in the chain adds independent jitter.
 // This PoC tests at higher sample counts with variations.
+//
+// Attribute and query dictionaries are built once (lib/poc_keychain.h);
+// each iteration only swaps the account, and items are removed in a bulk
+// phase after the measured loop, so CoreFoundation allocation and inline
+// cleanup stay out of the timings.
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -13,7 +18,10 @@
 #include <Security/Security.h>
 #include <CoreFoundation/CoreFoundation.h>
 
+#include "lib/poc_keychain.h"
+
 #define N_SAMPLES 5000
+#define KC_SERVICE "org.openentropy.keychain-write-timing"
 
 static void analyze(const char *name, uint64_t *timings, int n) {
     mach_timebase_info_data_t tb;
@@ -58,142 +66,82 @@ static void analyze(const char *name, uint64_t *timings, int n) {
 int main(void) {
     printf("# Keychain Write Timing — High-Volume Test\n\n");
 
-    // ===== TEST 1: SecItemAdd + SecItemDelete cycle =====
+    // ===== TEST 1: SecItemAdd, bulk delete afterwards =====
     {
         uint64_t timings[N_SAMPLES];
         int valid = 0;
+        PocKcBatch b;
+        if (poc_kc_batch_init(&b, KC_SERVICE, "oe-entropy", N_SAMPLES, 0) != 0) return 1;
+        poc_kc_delete_all(&b);
 
         for (int i = 0; i < N_SAMPLES; i++) {
-            char label[64];
-            snprintf(label, sizeof(label), "oe-entropy-%d", i);
-            CFStringRef labelRef = CFStringCreateWithCString(NULL, label, kCFStringEncodingUTF8);
-
-            uint8_t secret[16];
-            memset(secret, (uint8_t)i, sizeof(secret));
-            CFDataRef secretData = CFDataCreate(NULL, secret, sizeof(secret));
-
-            CFMutableDictionaryRef attrs = CFDictionaryCreateMutable(
-                NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-            CFDictionarySetValue(attrs, kSecClass, kSecClassGenericPassword);
-            CFDictionarySetValue(attrs, kSecAttrLabel, labelRef);
-            CFDictionarySetValue(attrs, kSecValueData, secretData);
-            // Use kSecAttrAccessibleAfterFirstUnlockThisDeviceOnly for speed
-            CFDictionarySetValue(attrs, kSecAttrAccessible,
-                               kSecAttrAccessibleAfterFirstUnlockThisDeviceOnly);
-
+            poc_kc_select(&b, i);
             uint64_t t0 = mach_absolute_time();
-            OSStatus status = SecItemAdd(attrs, NULL);
+            OSStatus status = SecItemAdd(b.attrs, NULL);
             uint64_t t1 = mach_absolute_time();
 
             if (status == errSecSuccess) {
                 timings[valid++] = t1 - t0;
             }
-
-            // Delete immediately
-            CFMutableDictionaryRef query = CFDictionaryCreateMutable(
-                NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-            CFDictionarySetValue(query, kSecClass, kSecClassGenericPassword);
-            CFDictionarySetValue(query, kSecAttrLabel, labelRef);
-            SecItemDelete(query);
-
-            CFRelease(query);
-            CFRelease(attrs);
-            CFRelease(secretData);
-            CFRelease(labelRef);
         }
+        poc_kc_delete_all(&b);
+        poc_kc_batch_free(&b);
         if (valid > 100) analyze("SecItemAdd", timings, valid);
     }
 
     // ===== TEST 2: SecItemDelete timing =====
     {
+        PocKcBatch b;
+        if (poc_kc_batch_init(&b, KC_SERVICE, "oe-del", N_SAMPLES, 0) != 0) return 1;
+        poc_kc_delete_all(&b);
+
         // Pre-create items
         for (int i = 0; i < N_SAMPLES; i++) {
-            char label[64];
-            snprintf(label, sizeof(label), "oe-del-%d", i);
-            CFStringRef labelRef = CFStringCreateWithCString(NULL, label, kCFStringEncodingUTF8);
-            uint8_t secret[16] = {(uint8_t)i};
-            CFDataRef secretData = CFDataCreate(NULL, secret, sizeof(secret));
-            CFMutableDictionaryRef attrs = CFDictionaryCreateMutable(
-                NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-            CFDictionarySetValue(attrs, kSecClass, kSecClassGenericPassword);
-            CFDictionarySetValue(attrs, kSecAttrLabel, labelRef);
-            CFDictionarySetValue(attrs, kSecValueData, secretData);
-            SecItemAdd(attrs, NULL);
-            CFRelease(attrs);
-            CFRelease(secretData);
-            CFRelease(labelRef);
+            poc_kc_select(&b, i);
+            SecItemAdd(b.attrs, NULL);
         }
 
         uint64_t timings[N_SAMPLES];
         int valid = 0;
 
         for (int i = 0; i < N_SAMPLES; i++) {
-            char label[64];
-            snprintf(label, sizeof(label), "oe-del-%d", i);
-            CFStringRef labelRef = CFStringCreateWithCString(NULL, label, kCFStringEncodingUTF8);
-
-            CFMutableDictionaryRef query = CFDictionaryCreateMutable(
-                NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-            CFDictionarySetValue(query, kSecClass, kSecClassGenericPassword);
-            CFDictionarySetValue(query, kSecAttrLabel, labelRef);
-
+            poc_kc_select(&b, i);
             uint64_t t0 = mach_absolute_time();
-            OSStatus status = SecItemDelete(query);
+            OSStatus status = SecItemDelete(b.query);
             uint64_t t1 = mach_absolute_time();
 
             if (status == errSecSuccess) {
                 timings[valid++] = t1 - t0;
             }
-
-            CFRelease(query);
-            CFRelease(labelRef);
         }
+        poc_kc_delete_all(&b);
+        poc_kc_batch_free(&b);
         if (valid > 100) analyze("SecItemDelete", timings, valid);
     }
 
     // ===== TEST 3: SecItemCopyMatching (lookup) timing =====
     {
         // Create one item to look up repeatedly
-        const char *label = "oe-lookup-target";
-        CFStringRef labelRef = CFStringCreateWithCString(NULL, label, kCFStringEncodingUTF8);
-        uint8_t secret[16] = {42};
-        CFDataRef secretData = CFDataCreate(NULL, secret, sizeof(secret));
-        CFMutableDictionaryRef attrs = CFDictionaryCreateMutable(
-            NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-        CFDictionarySetValue(attrs, kSecClass, kSecClassGenericPassword);
-        CFDictionarySetValue(attrs, kSecAttrLabel, labelRef);
-        CFDictionarySetValue(attrs, kSecValueData, secretData);
-        SecItemAdd(attrs, NULL);
-        CFRelease(attrs);
-        CFRelease(secretData);
+        PocKcBatch b;
+        if (poc_kc_batch_init(&b, KC_SERVICE, "oe-lookup-target", 1, 1) != 0) return 1;
+        poc_kc_delete_all(&b);
+        SecItemAdd(b.attrs, NULL);
 
         uint64_t timings[N_SAMPLES];
         for (int i = 0; i < N_SAMPLES; i++) {
-            CFMutableDictionaryRef query = CFDictionaryCreateMutable(
-                NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-            CFDictionarySetValue(query, kSecClass, kSecClassGenericPassword);
-            CFDictionarySetValue(query, kSecAttrLabel, labelRef);
-            CFDictionarySetValue(query, kSecReturnData, kCFBooleanTrue);
-
             CFTypeRef result = NULL;
             uint64_t t0 = mach_absolute_time();
-            SecItemCopyMatching(query, &result);
+            SecItemCopyMatching(b.query, &result);
             uint64_t t1 = mach_absolute_time();
             timings[i] = t1 - t0;
 
             if (result) CFRelease(result);
-            CFRelease(query);
         }
         analyze("SecItemCopyMatching", timings, N_SAMPLES);
 
         // Cleanup
-        CFMutableDictionaryRef cleanup = CFDictionaryCreateMutable(
-            NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-        CFDictionarySetValue(cleanup, kSecClass, kSecClassGenericPassword);
-        CFDictionarySetValue(cleanup, kSecAttrLabel, labelRef);
-        SecItemDelete(cleanup);
-        CFRelease(cleanup);
-        CFRelease(labelRef);
+        poc_kc_delete_all(&b);
+        poc_kc_batch_free(&b);
     }
 
     return 0;
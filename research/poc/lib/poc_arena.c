@@ -0,0 +1,139 @@
+// poc_arena.c — Reusable pointer-chase arena for the DMP / prefetcher PoCs
+
+#include "poc_arena.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <mach/vm_statistics.h>
+#endif
+
+#define SUPERPAGE (2u * 1024 * 1024)
+#define MAX_FILL_THREADS 8
+
+static void *map_superpages(size_t bytes) {
+#if defined(__APPLE__)
+    // Anonymous mappings take VM flags in the fd slot. Apple Silicon
+    // refuses superpages, so this usually falls through to plain pages.
+    void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON,
+                   VM_FLAGS_SUPERPAGE_SIZE_2MB, 0);
+    return p;
+#elif defined(MAP_HUGETLB)
+    return mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#else
+    (void)bytes;
+    return MAP_FAILED;
+#endif
+}
+
+int poc_arena_init(PocArena *a, size_t bytes, uint64_t seed) {
+    memset(a, 0, sizeof(*a));
+    bytes = (bytes + SUPERPAGE - 1) & ~(size_t)(SUPERPAGE - 1);
+
+    void *p = map_superpages(bytes);
+    if (p != MAP_FAILED) {
+        a->superpages = 1;
+    } else {
+        p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (p == MAP_FAILED) return -1;
+#if defined(MADV_HUGEPAGE)
+        madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    }
+
+    a->words = p;
+    a->bytes = bytes;
+    a->n = bytes / sizeof(uint64_t);
+    a->base = (uint64_t)(uintptr_t)p;
+    // The first fill writes every word, faulting the whole arena in here
+    // rather than during the caller's timed loop.
+    poc_arena_randomize(a, seed);
+    return 0;
+}
+
+void poc_arena_free(PocArena *a) {
+    if (a->words) munmap(a->words, a->bytes);
+    memset(a, 0, sizeof(*a));
+}
+
+typedef struct {
+    PocArena *a;
+    size_t lo, hi;
+    uint64_t seed;
+} FillSlice;
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static void *fill_slice(void *arg) {
+    FillSlice *s = arg;
+    uint64_t *w = s->a->words;
+    uint64_t base = s->a->base, n = s->a->n;
+    uint64_t lcg = s->seed | 1;
+    for (size_t i = s->lo; i < s->hi; i++) {
+        lcg = lcg * 6364136223846793005ULL + 1;
+        w[i] = base + ((lcg >> 16) % n) * sizeof(uint64_t);
+    }
+    return NULL;
+}
+
+void poc_arena_randomize(PocArena *a, uint64_t seed) {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = ncpu < 1 ? 1 : ncpu > MAX_FILL_THREADS ? MAX_FILL_THREADS : (int)ncpu;
+
+    FillSlice slices[MAX_FILL_THREADS];
+    pthread_t tids[MAX_FILL_THREADS];
+    int started[MAX_FILL_THREADS] = {0};
+    size_t per = (a->n + threads - 1) / threads;
+    for (int t = 0; t < threads; t++) {
+        slices[t].a = a;
+        slices[t].lo = (size_t)t * per < a->n ? (size_t)t * per : a->n;
+        slices[t].hi = slices[t].lo + per < a->n ? slices[t].lo + per : a->n;
+        slices[t].seed = splitmix64(seed + (uint64_t)t);
+        // Slice 0 runs on the calling thread; a failed spawn also runs inline.
+        if (t > 0) started[t] = pthread_create(&tids[t], NULL, fill_slice, &slices[t]) == 0;
+    }
+    fill_slice(&slices[0]);
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) pthread_join(tids[t], NULL);
+        else fill_slice(&slices[t]);
+    }
+}
+
+int poc_samples_init(PocSampleArena *s, size_t bytes) {
+    memset(s, 0, sizeof(*s));
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    bytes = (bytes + page - 1) & ~(page - 1);
+    if (bytes == 0) bytes = page;
+    void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (p == MAP_FAILED) return -1;
+    s->base = p;
+    s->bytes = bytes;
+    // Write every page so the faults happen here, then wire them
+    for (size_t off = 0; off < bytes; off += page) s->base[off] = 0;
+    s->locked = mlock(p, bytes) == 0;
+    return 0;
+}
+
+void poc_samples_free(PocSampleArena *s) {
+    if (s->base) {
+        if (s->locked) munlock(s->base, s->bytes);
+        munmap(s->base, s->bytes);
+    }
+    memset(s, 0, sizeof(*s));
+}
+
+void *poc_samples_alloc(PocSampleArena *s, size_t bytes) {
+    size_t at = (s->used + 63) & ~(size_t)63;
+    if (at > s->bytes || bytes > s->bytes - at) return NULL;
+    s->used = at + bytes;
+    return s->base + at;
+}
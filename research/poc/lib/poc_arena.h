@@ -0,0 +1,70 @@
+// poc_arena.h — Reusable pointer-chase arena for the DMP / prefetcher PoCs
+//
+// The DMP sources chase a 16MB array whose words are valid-looking pointers
+// back into the array. Mapping it and filling 2M words from one serial LCG
+// costs more than most of the measurements that use it, so a PocArena is
+// mapped once (superpages where the kernel grants them, pre-faulted during
+// the first fill) and refilled in place by poc_arena_randomize(), which
+// splits the array across threads with an independent LCG stream each.
+// Callers re-randomize between trials instead of re-mapping.
+//
+// PocSampleArena is the same idea for sample storage: one mapping sized for
+// every buffer a program will need, every page written and then mlock()ed
+// up front, carved into cache-line-aligned slices. No first-touch fault or
+// allocator call lands inside a timed loop, and the pages cannot be paged
+// out between tests. mlock is best effort (RLIMIT_MEMLOCK); the pages are
+// pre-faulted either way.
+
+#ifndef POC_ARENA_H
+#define POC_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint64_t *words;
+    size_t n;           // word count
+    size_t bytes;
+    uint64_t base;      // (uint64_t)words, the value pointers are built from
+    int superpages;     // mapping is backed by 2MB pages
+} PocArena;
+
+// Map `bytes` (rounded up to 2MB) and fill it with poc_arena_randomize(seed).
+// Returns 0, or -1 if the mapping fails.
+int poc_arena_init(PocArena *a, size_t bytes, uint64_t seed);
+void poc_arena_free(PocArena *a);
+
+// Refill every word with base + k * 8, k uniform over the arena, in parallel.
+void poc_arena_randomize(PocArena *a, uint64_t seed);
+
+typedef struct {
+    uint8_t *base;
+    size_t bytes;
+    size_t used;
+    int locked;         // mlock() succeeded
+} PocSampleArena;
+
+// Map, pre-fault and lock `bytes` (rounded up to a page). 0, or -1 if the
+// mapping fails.
+int poc_samples_init(PocSampleArena *s, size_t bytes);
+void poc_samples_free(PocSampleArena *s);
+
+// Next 64-byte-aligned slice of `bytes`; NULL when the arena is exhausted.
+void *poc_samples_alloc(PocSampleArena *s, size_t bytes);
+
+// Slices of n uint64_t / uint8_t.
+#define POC_SAMPLES_U64(s, n) ((uint64_t *)poc_samples_alloc((s), (size_t)(n) * sizeof(uint64_t)))
+#define POC_SAMPLES_U8(s, n)  ((uint8_t *)poc_samples_alloc((s), (size_t)(n)))
+
+// Hand every slice back; the pages stay mapped, faulted and locked.
+static inline void poc_samples_reset(PocSampleArena *s) { s->used = 0; }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_ARENA_H
@@ -0,0 +1,181 @@
+// poc_audioclock.c — Audio device clock as a stream of host/sample time pairs
+
+#include "poc_audioclock.h"
+
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RING_STAMPS 8192
+
+#if defined(__APPLE__)
+#include <CoreAudio/CoreAudio.h>
+#include <mach/mach_time.h>
+
+static void push_stamp(PocSpsc *r, uint64_t host, double sample) {
+    uint32_t w[4];
+    memcpy(w, &host, sizeof(host));
+    memcpy(w + 2, &sample, sizeof(sample));
+    poc_spsc_write(r, w, 4);
+}
+
+static int stamp_valid(const AudioTimeStamp *t) {
+    const UInt32 both = kAudioTimeStampHostTimeValid | kAudioTimeStampSampleTimeValid;
+    return t && (t->mFlags & both) == both;
+}
+
+// Runs on the HAL's real-time thread: record the cycle's output (else input)
+// buffer time, silence the output. inNow is not used: it is the HAL's
+// estimate of the present, interpolated like AudioDeviceGetCurrentTime().
+static OSStatus clock_ioproc(AudioObjectID device, const AudioTimeStamp *inNow,
+                             const AudioBufferList *inInputData,
+                             const AudioTimeStamp *inInputTime,
+                             AudioBufferList *outOutputData,
+                             const AudioTimeStamp *inOutputTime, void *client) {
+    (void)device;
+    (void)inNow;
+    (void)inInputData;
+    PocAudioClock *c = client;
+    const AudioTimeStamp *t = outOutputData && stamp_valid(inOutputTime) ? inOutputTime
+                              : stamp_valid(inInputTime)                 ? inInputTime
+                                                                         : NULL;
+    if (t) push_stamp(&c->ring, t->mHostTime, t->mSampleTime);
+    if (outOutputData) {
+        for (UInt32 b = 0; b < outOutputData->mNumberBuffers; b++)
+            memset(outOutputData->mBuffers[b].mData, 0, outOutputData->mBuffers[b].mDataByteSize);
+    }
+    return noErr;
+}
+
+static int set_frames(uint32_t device, uint32_t frames) {
+    AudioObjectPropertyAddress addr = {
+        .mSelector = kAudioDevicePropertyBufferFrameSize,
+        .mScope = kAudioObjectPropertyScopeGlobal,
+        .mElement = kAudioObjectPropertyElementMain,
+    };
+    return AudioObjectSetPropertyData(device, &addr, 0, NULL, sizeof(frames), &frames) == noErr
+               ? 0 : -1;
+}
+
+int poc_audioclock_start(PocAudioClock *c, uint32_t device) {
+    memset(c, 0, sizeof(*c));
+    c->device = device;
+    if (poc_spsc_init(&c->ring, RING_STAMPS * 4) != 0) return -1;
+
+    AudioObjectPropertyAddress addr = {
+        .mSelector = kAudioDevicePropertyBufferFrameSize,
+        .mScope = kAudioObjectPropertyScopeGlobal,
+        .mElement = kAudioObjectPropertyElementMain,
+    };
+    UInt32 frames = 0, size = sizeof(frames);
+    if (AudioObjectGetPropertyData(device, &addr, 0, NULL, &size, &frames) == noErr &&
+        frames > POC_AUDIOCLOCK_FRAMES && set_frames(device, POC_AUDIOCLOCK_FRAMES) == 0)
+        c->saved_frames = frames;
+
+    AudioDeviceIOProcID proc = NULL;
+    if (AudioDeviceCreateIOProcID(device, clock_ioproc, c, &proc) != noErr || !proc) {
+        poc_audioclock_stop(c);
+        return -1;
+    }
+    c->proc = (void *)proc;
+    if (AudioDeviceStart(device, proc) != noErr) {
+        poc_audioclock_stop(c);
+        return -1;
+    }
+    c->running = 1;
+    return 0;
+}
+
+void poc_audioclock_stop(PocAudioClock *c) {
+    AudioDeviceIOProcID proc = (AudioDeviceIOProcID)c->proc;
+    if (c->running) AudioDeviceStop(c->device, proc);
+    if (proc) AudioDeviceDestroyIOProcID(c->device, proc);
+    if (c->saved_frames) set_frames(c->device, c->saved_frames);
+    poc_spsc_free(&c->ring);
+    c->proc = NULL;
+    c->saved_frames = 0;
+    c->running = 0;
+}
+
+int poc_audioclock_read(PocAudioClock *c, PocAudioStamp *out, int n, double timeout_s) {
+    if (!c->running) return 0;
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    uint64_t deadline = mach_absolute_time() +
+                        (uint64_t)(timeout_s * 1e9 * tb.denom / tb.numer);
+
+    int got = 0;
+    uint32_t w[4];
+    while (got < n) {
+        if (poc_spsc_read(&c->ring, w, 4) == 4) {
+            memcpy(&out[got].host, w, sizeof(uint64_t));
+            memcpy(&out[got].sample, w + 2, sizeof(double));
+            got++;
+            continue;
+        }
+        if (mach_absolute_time() > deadline) break;
+        usleep(1000);
+    }
+    return got;
+}
+
+int poc_audioclock_poll(PocAudioClock *c, PocAudioStamp *out, int n) {
+    if (!c->running) return 0;
+    int got = 0;
+    for (int i = 0; i < n; i++) {
+        AudioTimeStamp ts;
+        memset(&ts, 0, sizeof(ts));
+        if (AudioDeviceGetCurrentTime(c->device, &ts) != noErr) continue;
+        out[got].host = ts.mHostTime;
+        out[got].sample = ts.mSampleTime;
+        got++;
+    }
+    return got;
+}
+
+#else
+
+int poc_audioclock_start(PocAudioClock *c, uint32_t device) {
+    memset(c, 0, sizeof(*c));
+    c->device = device;
+    return -1;
+}
+
+void poc_audioclock_stop(PocAudioClock *c) { c->running = 0; }
+
+int poc_audioclock_read(PocAudioClock *c, PocAudioStamp *out, int n, double timeout_s) {
+    (void)c;
+    (void)out;
+    (void)n;
+    (void)timeout_s;
+    return 0;
+}
+
+int poc_audioclock_poll(PocAudioClock *c, PocAudioStamp *out, int n) {
+    (void)c;
+    (void)out;
+    (void)n;
+    return 0;
+}
+
+#endif
+
+int poc_audioclock_phase_error(const PocAudioStamp *s, int n, int64_t *err,
+                               double *ticks_per_sample) {
+    if (ticks_per_sample) *ticks_per_sample = 0;
+    if (n < 2 || s[n - 1].sample <= s[0].sample) return 0;
+
+    // Endpoint fit: long-run drift between the two clocks is removed, what
+    // remains is the cycle-to-cycle phase error.
+    double tps = (double)(s[n - 1].host - s[0].host) / (s[n - 1].sample - s[0].sample);
+    if (ticks_per_sample) *ticks_per_sample = tps;
+
+    int m = 0;
+    for (int i = 1; i < n; i++) {
+        double ds = s[i].sample - s[i - 1].sample;
+        if (ds <= 0) continue;
+        int64_t dh = (int64_t)(s[i].host - s[i - 1].host);
+        err[m++] = dh - (int64_t)llround(ds * tps);
+    }
+    return m;
+}
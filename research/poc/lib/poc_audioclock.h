@@ -0,0 +1,77 @@
+// poc_audioclock.h — Audio device clock as a stream of host/sample time pairs
+//
+// Polling AudioObjectGetPropertyData() times the HAL's property path, a mach
+// round trip per sample, rather than the audio clock itself. A PocAudioClock
+// runs an IOProc on the device instead: every I/O cycle the HAL passes the
+// callback the device's current (host time, sample time) pair, which it
+// pushes into a PocSpsc ring without locking or allocating. The pair is the
+// cycle's output buffer time (its input buffer time on input-only devices),
+// which the HAL derives from the device's own timestamps. The buffer size is
+// dropped to POC_AUDIOCLOCK_FRAMES while running so cycles come often.
+//
+// poc_audioclock_poll() reads a pair on demand through
+// AudioDeviceGetCurrentTime(). That pair is the HAL's interpolation forward
+// from its latest device timestamp, so its phase error measures the HAL
+// interpolator, not PLL jitter; it is kept only for comparison with the
+// IOProc stream.
+//
+// poc_audioclock_phase_error() turns consecutive pairs into PLL phase error:
+// how far each host-time step strays from what its sample-time step predicts
+// at the rate fitted over the whole run.
+//
+// Link -framework CoreAudio -framework CoreFoundation; off macOS
+// poc_audioclock_start() always fails.
+
+#ifndef POC_AUDIOCLOCK_H
+#define POC_AUDIOCLOCK_H
+
+#include <stdint.h>
+
+#include "poc_spsc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_AUDIOCLOCK_FRAMES 64
+
+typedef struct {
+    uint64_t host;          // mach_absolute_time() units
+    double sample;          // device sample time
+} PocAudioStamp;
+
+typedef struct {
+    uint32_t device;        // AudioDeviceID
+    void *proc;             // AudioDeviceIOProcID
+    uint32_t saved_frames;  // buffer size to restore, 0 if unchanged
+    PocSpsc ring;           // 4 words per stamp
+    int running;
+} PocAudioClock;
+
+// Install the IOProc and start the device. Returns 0, or -1 if the device
+// cannot run (no permission for an input device, busy, not macOS).
+int poc_audioclock_start(PocAudioClock *c, uint32_t device);
+
+// Stop the device, remove the IOProc and restore the buffer size.
+void poc_audioclock_stop(PocAudioClock *c);
+
+// Wait for up to n IOProc stamps, giving up after timeout_s seconds.
+// Returns the number stored in out.
+int poc_audioclock_read(PocAudioClock *c, PocAudioStamp *out, int n, double timeout_s);
+
+// n back-to-back AudioDeviceGetCurrentTime() pairs from the running device:
+// HAL-interpolated, see above. Returns the number stored in out.
+int poc_audioclock_poll(PocAudioClock *c, PocAudioStamp *out, int n);
+
+// err[k] = host step - predicted host step between stamps k and k+1, in
+// ticks; pairs whose sample time did not advance are skipped. Returns the
+// number of errors written (at most n - 1) and the fitted ticks per sample
+// in *ticks_per_sample (optional).
+int poc_audioclock_phase_error(const PocAudioStamp *s, int n, int64_t *err,
+                               double *ticks_per_sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_AUDIOCLOCK_H
@@ -0,0 +1,245 @@
+// poc_beat.c — N-domain beat engine: interleaved domain kernels, timed
+
+#include "poc_beat.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "poc_platform.h"
+
+#define PAGE 4096
+
+static const char *const KIND_NAMES[POC_BEAT_N_KINDS] = {"cpu", "mem", "sys", "io", "ipc", "gpu"};
+
+static int (*g_gpu_tick)(void);
+
+void poc_beat_set_gpu(int (*tick)(void)) {
+    g_gpu_tick = tick;
+}
+
+const char *poc_beat_kind_name(PocBeatKind kind) {
+    return kind >= 0 && kind < POC_BEAT_N_KINDS ? KIND_NAMES[kind] : "?";
+}
+
+void poc_beat_defaults(PocBeatConfig *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->lcg_iters = 50;
+    cfg->mem_bytes = 4u << 20;
+    cfg->io_bytes = 64;
+    cfg->io_flush_every = 16;
+}
+
+int poc_beat_parse(const char *spec, PocBeatConfig *cfg) {
+    cfg->n_steps = 0;
+    cfg->shuffle = 0;
+    if (strncmp(spec, "shuffle:", 8) == 0) {
+        cfg->shuffle = 1;
+        spec += 8;
+    }
+    while (*spec) {
+        size_t len = strcspn(spec, ",*");
+        int kind = -1, reps = 1;
+        for (int k = 0; k < POC_BEAT_N_KINDS; k++)
+            if (strlen(KIND_NAMES[k]) == len && strncmp(KIND_NAMES[k], spec, len) == 0) kind = k;
+        if (kind < 0) return -1;
+        spec += len;
+        if (*spec == '*') {
+            char *end;
+            reps = (int)strtol(spec + 1, &end, 10);
+            if (end == spec + 1 || reps < 1) return -1;
+            spec = end;
+        }
+        if (cfg->n_steps + reps > POC_BEAT_MAX_STEPS) return -1;
+        while (reps--) cfg->steps[cfg->n_steps++] = (PocBeatKind)kind;
+        if (*spec == ',') spec++;
+        else if (*spec) return -1;
+    }
+    return cfg->n_steps > 0 ? 0 : -1;
+}
+
+// Slot of each kind in a PocBeatSamples, -1 when the pattern lacks it.
+static int domain_slots(const PocBeatConfig *cfg, int slot[POC_BEAT_N_KINDS],
+                        PocBeatKind kinds[POC_BEAT_N_KINDS]) {
+    int n = 0;
+    for (int k = 0; k < POC_BEAT_N_KINDS; k++) slot[k] = -1;
+    for (int s = 0; s < cfg->n_steps; s++)
+        if (slot[cfg->steps[s]] < 0) {
+            kinds[n] = cfg->steps[s];
+            slot[cfg->steps[s]] = n++;
+        }
+    return n;
+}
+
+int poc_beat_samples_alloc(PocBeatSamples *s, const PocBeatConfig *cfg, int n) {
+    int slot[POC_BEAT_N_KINDS];
+    memset(s, 0, sizeof(*s));
+    s->n_domains = domain_slots(cfg, slot, s->kind);
+    for (int d = 0; d < s->n_domains; d++) {
+        // A domain gets at most its share of every cycle.
+        int per_cycle = 0;
+        for (int k = 0; k < cfg->n_steps; k++) per_cycle += cfg->steps[k] == s->kind[d];
+        size_t cap = (size_t)(n / cfg->n_steps + 1) * (size_t)per_cycle;
+        s->timings[d] = malloc(cap * sizeof(uint64_t));
+        if (!s->timings[d]) {
+            poc_beat_samples_free(s);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void poc_beat_samples_free(PocBeatSamples *s) {
+    for (int d = 0; d < POC_BEAT_N_KINDS; d++) free(s->timings[d]);
+    memset(s, 0, sizeof(*s));
+}
+
+// --- domains -------------------------------------------------------------------
+
+typedef struct {
+    uint64_t rng;
+    volatile uint8_t *mem;
+    FILE *io;
+    uint64_t io_writes;
+    int pipe_fd[2];
+    uint8_t io_buf[POC_BEAT_MAX_IO];
+} BeatState;
+
+// 64-bit LCG (Knuth MMIX), the same draw as validate_common.h's lcg_next().
+static inline uint64_t beat_lcg(uint64_t *state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return *state >> 33;
+}
+
+static void state_free(BeatState *st) {
+    free((void *)st->mem);
+    if (st->io) fclose(st->io);
+    if (st->pipe_fd[0] >= 0) close(st->pipe_fd[0]);
+    if (st->pipe_fd[1] >= 0) close(st->pipe_fd[1]);
+}
+
+static int state_init(BeatState *st, const PocBeatConfig *cfg) {
+    memset(st, 0, sizeof(*st));
+    st->pipe_fd[0] = st->pipe_fd[1] = -1;
+    int uses[POC_BEAT_N_KINDS] = {0};
+    for (int s = 0; s < cfg->n_steps; s++) uses[cfg->steps[s]] = 1;
+
+    if (uses[POC_BEAT_MEMORY]) {
+        if (cfg->mem_bytes == 0 || !(st->mem = malloc(cfg->mem_bytes))) return -1;
+        for (size_t i = 0; i < cfg->mem_bytes; i += PAGE) st->mem[i] = (uint8_t)(i & 0xFF);
+    }
+    if (uses[POC_BEAT_IO]) {
+        char path[] = "/tmp/oe_beat_XXXXXX";
+        int fd = mkstemp(path);
+        if (fd < 0) return -1;
+        unlink(path);
+        if (!(st->io = fdopen(fd, "w"))) {
+            close(fd);
+            return -1;
+        }
+    }
+    if (uses[POC_BEAT_IPC] && pipe(st->pipe_fd) != 0) return -1;
+    if (uses[POC_BEAT_GPU] && !g_gpu_tick) return -1;
+    st->rng = mach_absolute_time();
+    return 0;
+}
+
+// Duration of one step of `kind`; untimed preparation (offsets, write
+// payloads) happens before the first timestamp.
+static inline uint64_t beat_step(BeatState *st, const PocBeatConfig *cfg, PocBeatKind kind,
+                                 int io_bytes, int flush_every) {
+    uint64_t t0, t1;
+    switch (kind) {
+    case POC_BEAT_CPU:
+        t0 = mach_absolute_time();
+        for (int j = 0; j < cfg->lcg_iters; j++) beat_lcg(&st->rng);
+        t1 = mach_absolute_time();
+        return t1 - t0;
+    case POC_BEAT_MEMORY: {
+        size_t off = (size_t)(beat_lcg(&st->rng) % cfg->mem_bytes);
+        t0 = mach_absolute_time();
+        (void)st->mem[off];
+        t1 = mach_absolute_time();
+        return t1 - t0;
+    }
+    case POC_BEAT_SYSCALL:
+        t0 = mach_absolute_time();
+        (void)getpid();
+        t1 = mach_absolute_time();
+        return t1 - t0;
+    case POC_BEAT_IO: {
+        for (int j = 0; j < io_bytes; j++) st->io_buf[j] = (uint8_t)(beat_lcg(&st->rng) & 0xFF);
+        const int flush = st->io_writes++ % (uint64_t)flush_every == 0;
+        t0 = mach_absolute_time();
+        fwrite(st->io_buf, 1, (size_t)io_bytes, st->io);
+        if (flush) fflush(st->io);
+        t1 = mach_absolute_time();
+        return t1 - t0;
+    }
+    case POC_BEAT_IPC: {
+        uint8_t b = (uint8_t)st->rng;
+        t0 = mach_absolute_time();
+        if (write(st->pipe_fd[1], &b, 1) == 1) (void)!read(st->pipe_fd[0], &b, 1);
+        t1 = mach_absolute_time();
+        return t1 - t0;
+    }
+    case POC_BEAT_GPU:
+        t0 = mach_absolute_time();
+        g_gpu_tick();
+        t1 = mach_absolute_time();
+        return t1 - t0;
+    case POC_BEAT_N_KINDS:
+        break;
+    }
+    return 0;
+}
+
+int poc_beat_run_timed(const PocBeatConfig *cfg, uint64_t *timings, int n, PocBeatSamples *soa,
+                       uint64_t *loop_ticks) {
+    if (loop_ticks) *loop_ticks = 0;
+    if (cfg->n_steps < 1 || cfg->n_steps > POC_BEAT_MAX_STEPS) return 0;
+    BeatState st;
+    if (state_init(&st, cfg) != 0) {
+        state_free(&st);
+        return 0;
+    }
+    const int io_bytes = cfg->io_bytes < 1 ? 1
+                       : cfg->io_bytes > POC_BEAT_MAX_IO ? POC_BEAT_MAX_IO
+                       : cfg->io_bytes;
+    const int flush_every = cfg->io_flush_every < 1 ? 1 : cfg->io_flush_every;
+    int slot[POC_BEAT_N_KINDS];
+    PocBeatKind kinds[POC_BEAT_N_KINDS];
+    domain_slots(cfg, slot, kinds);
+    if (soa)
+        for (int d = 0; d < soa->n_domains; d++) soa->n[d] = 0;
+
+    PocBeatKind order[POC_BEAT_MAX_STEPS];
+    memcpy(order, cfg->steps, sizeof(order[0]) * (size_t)cfg->n_steps);
+    int valid = 0;
+    const uint64_t t0 = mach_absolute_time();
+    while (valid + cfg->n_steps <= n) {
+        if (cfg->shuffle)
+            for (int s = cfg->n_steps - 1; s > 0; s--) {
+                int j = (int)(beat_lcg(&st.rng) % (uint64_t)(s + 1));
+                PocBeatKind k = order[s];
+                order[s] = order[j];
+                order[j] = k;
+            }
+        for (int s = 0; s < cfg->n_steps; s++) {
+            const uint64_t dt = beat_step(&st, cfg, order[s], io_bytes, flush_every);
+            timings[valid++] = dt;
+            if (soa) {
+                const int d = slot[order[s]];
+                soa->timings[d][soa->n[d]++] = dt;
+            }
+        }
+    }
+    if (loop_ticks) *loop_ticks = mach_absolute_time() - t0;
+    state_free(&st);
+    return valid;
+}
+
+int poc_beat_run(const PocBeatConfig *cfg, uint64_t *timings, int n, PocBeatSamples *soa) {
+    return poc_beat_run_timed(cfg, timings, n, soa, NULL);
+}
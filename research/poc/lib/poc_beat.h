@@ -0,0 +1,101 @@
+// poc_beat.h — N-domain beat engine: interleaved domain kernels, timed
+//
+// A beat collector times short kernels from different clock and power
+// domains back to back. Each domain's jitter, and the phase between
+// domains, shows up in the durations. The engine runs any pattern of
+// domain kernels and times each step. It writes the interleaved durations
+// to one array, which is what a registry collector returns, and
+// optionally a struct-of-arrays copy split by domain. Then each domain's
+// entropy and the combined stream's entropy can be compared.
+//
+//   cpu      lcg_iters dependent LCG steps
+//   mem      one volatile byte read at a random offset in a pre-faulted
+//            mem_bytes buffer (offset drawn outside the timed region)
+//   sys      getpid()
+//   io       fwrite of io_bytes to an unlinked temp file, fflush every
+//            io_flush_every-th write
+//   ipc      one byte written to a pipe and read back
+//   gpu      one small compute dispatch through the hook set with
+//            poc_beat_set_gpu() (Metal, collectors/gpu_load.m)
+//
+// A pattern is a cycle of steps, written "cpu,mem*2,sys": cpu, mem, mem,
+// sys, repeated. The prefix "shuffle:" visits each cycle's steps in a
+// fresh random order. Runs stop on a whole cycle, so the count returned
+// is a multiple of the cycle length.
+
+#ifndef POC_BEAT_H
+#define POC_BEAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_BEAT_MAX_STEPS 64
+#define POC_BEAT_MAX_IO    4096
+
+typedef enum {
+    POC_BEAT_CPU,
+    POC_BEAT_MEMORY,
+    POC_BEAT_SYSCALL,
+    POC_BEAT_IO,
+    POC_BEAT_IPC,
+    POC_BEAT_GPU,
+    POC_BEAT_N_KINDS
+} PocBeatKind;
+
+typedef struct {
+    PocBeatKind steps[POC_BEAT_MAX_STEPS];
+    int n_steps;
+    int shuffle;
+    int lcg_iters;
+    size_t mem_bytes;
+    int io_bytes;               // clamped to 1..POC_BEAT_MAX_IO
+    int io_flush_every;
+} PocBeatConfig;
+
+// No steps; 50 LCG steps, 4 MiB, 64-byte writes flushed every 16th.
+void poc_beat_defaults(PocBeatConfig *cfg);
+
+// Set cfg's steps from a pattern, keeping its kernel parameters.
+// Returns 0, or -1 on an unknown kind or more than POC_BEAT_MAX_STEPS.
+int poc_beat_parse(const char *spec, PocBeatConfig *cfg);
+
+// "cpu", "mem", "sys", "io", "ipc", "gpu".
+const char *poc_beat_kind_name(PocBeatKind kind);
+
+// Per-domain timings, one array per distinct kind in the pattern, in
+// order of first appearance.
+typedef struct {
+    int n_domains;
+    PocBeatKind kind[POC_BEAT_N_KINDS];
+    uint64_t *timings[POC_BEAT_N_KINDS];
+    int n[POC_BEAT_N_KINDS];
+} PocBeatSamples;
+
+// Room for a run of n steps. Returns 0, or -1 when allocation fails.
+int poc_beat_samples_alloc(PocBeatSamples *s, const PocBeatConfig *cfg, int n);
+void poc_beat_samples_free(PocBeatSamples *s);
+
+// Run whole cycles of the pattern while they fit in n. Step i's duration
+// goes to timings[i] and, when soa is given, to its domain's array.
+// Returns the number of steps, or 0 when a domain cannot be set up
+// (allocation, temp file, pipe, or gpu without a hook).
+int poc_beat_run(const PocBeatConfig *cfg, uint64_t *timings, int n, PocBeatSamples *soa);
+
+// poc_beat_run() that also reports the ticks spent in the step loop alone,
+// without the setup and teardown of its domains (buffer, temp file, pipe),
+// so a rate can be taken from it. *loop_ticks is 0 when nothing ran.
+int poc_beat_run_timed(const PocBeatConfig *cfg, uint64_t *timings, int n, PocBeatSamples *soa,
+                       uint64_t *loop_ticks);
+
+// One GPU dispatch, waited for; 0 on success.
+void poc_beat_set_gpu(int (*tick)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_BEAT_H
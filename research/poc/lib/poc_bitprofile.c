@@ -0,0 +1,149 @@
+// poc_bitprofile.c — Per-bit-position entropy profile and extraction mask
+
+#include "poc_bitprofile.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define JOINT_MAX_BITS 16       // largest mask measured as one symbol
+
+static inline uint64_t sample_at(const uint64_t *s, int i, int delta) {
+    return delta ? s[i + 1] - s[i] : s[i];
+}
+
+// Bits of x selected by mask, packed low to high (BMI2 pext in software).
+static inline uint64_t pext64(uint64_t x, uint64_t mask) {
+    uint64_t r = 0;
+    for (int k = 0; mask; k++, mask &= mask - 1)
+        if (x & mask & -mask) r |= 1ULL << k;
+    return r;
+}
+
+static double phi_of(double n, double n11, double a, double b) {
+    double den = a * (n - a) * b * (n - b);
+    return den > 0 ? (n * n11 - a * b) / sqrt(den) : 0;
+}
+
+int poc_bitprofile(const uint64_t *samples, int n, int delta, PocBitProfile *p) {
+    const int m = delta ? n - 1 : n;
+    if (m < 2) return -1;
+    const int words = (m + 63) / 64;
+    uint64_t *bs = calloc((size_t)64 * words, sizeof(uint64_t));
+    if (!bs) return -1;
+    memset(p, 0, sizeof(*p));
+    p->n = m;
+
+    // Transpose: bs[b * words + t / 64] bit t % 64 is bit b of sample t
+    const uint64_t first = sample_at(samples, 0, delta);
+    uint64_t diff = 0;
+    for (int t = 0; t < m; t++) {
+        uint64_t x = sample_at(samples, t, delta);
+        diff |= x ^ first;
+        for (uint64_t v = x; v; v &= v - 1)
+            bs[__builtin_ctzll(v) * words + t / 64] |= 1ULL << (t % 64);
+    }
+    p->varying = diff;
+
+    double ones[64];
+    for (int b = 0; b < 64; b++) {
+        const uint64_t *w = bs + (size_t)b * words;
+        long c = 0, c11 = 0;
+        for (int k = 0; k < words; k++) {
+            uint64_t next = (w[k] >> 1) | (k + 1 < words ? w[k + 1] << 63 : 0);
+            c += __builtin_popcountll(w[k]);
+            c11 += __builtin_popcountll(w[k] & next);
+        }
+        ones[b] = (double)c;
+        p->p1[b] = (double)c / m;
+        double q = p->p1[b] > 0.5 ? p->p1[b] : 1 - p->p1[b];
+        p->h[b] = q < 1 ? -log2(q) : 0;
+        if (!(diff >> b & 1)) continue;
+        // Pairs (t, t+1): ones among t < m-1 and among t > 0
+        double a = c - (double)(w[(m - 1) / 64] >> ((m - 1) % 64) & 1);
+        double bb = c - (double)(w[0] & 1);
+        p->lag1[b] = phi_of(m - 1, (double)c11, a, bb);
+    }
+
+    for (int i = 0; i < 64; i++) {
+        if (!(diff >> i & 1)) continue;
+        const uint64_t *wi = bs + (size_t)i * words;
+        for (int j = i + 1; j < 64; j++) {
+            if (!(diff >> j & 1)) continue;
+            const uint64_t *wj = bs + (size_t)j * words;
+            long c11 = 0;
+            for (int k = 0; k < words; k++) c11 += __builtin_popcountll(wi[k] & wj[k]);
+            p->phi[i][j] = p->phi[j][i] = phi_of(m, (double)c11, ones[i], ones[j]);
+        }
+    }
+    free(bs);
+    return 0;
+}
+
+PocBitMask poc_bitprofile_mask(const PocBitProfile *p, const uint64_t *samples, int n, int delta) {
+    PocBitMask r = {0};
+    r.h_joint = -1;
+
+    // Varying positions, best H∞ first
+    int order[64], k = 0;
+    for (int b = 0; b < 64; b++)
+        if (p->varying >> b & 1) order[k++] = b;
+    for (int i = 1; i < k; i++)
+        for (int j = i; j > 0 && p->h[order[j]] > p->h[order[j - 1]]; j--) {
+            int t = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = t;
+        }
+
+    for (int i = 0; i < k; i++) {
+        int b = order[i];
+        if (p->h[b] < POC_BIT_MIN_H || fabs(p->lag1[b]) > POC_BIT_MAX_CORR) continue;
+        int ok = 1;
+        for (uint64_t m = r.mask; m && ok; m &= m - 1)
+            if (fabs(p->phi[b][__builtin_ctzll(m)]) > POC_BIT_MAX_CORR) ok = 0;
+        if (!ok) continue;
+        r.mask |= 1ULL << b;
+        r.h_sum += p->h[b];
+    }
+    r.bits = __builtin_popcountll(r.mask);
+    r.bits_per_sample = r.h_sum;
+
+    // The phi screen only sees pairs; a joint histogram catches the rest
+    if (r.bits > 0 && r.bits <= JOINT_MAX_BITS) {
+        const int m = delta ? n - 1 : n;
+        uint32_t *hist = calloc((size_t)1 << r.bits, sizeof(uint32_t));
+        if (hist && m > 0) {
+            uint32_t mx = 0;
+            for (int t = 0; t < m; t++) {
+                uint32_t c = ++hist[pext64(sample_at(samples, t, delta), r.mask)];
+                if (c > mx) mx = c;
+            }
+            r.h_joint = -log2((double)mx / m);
+            if (r.h_joint < r.bits_per_sample) r.bits_per_sample = r.h_joint;
+        }
+        free(hist);
+    }
+    return r;
+}
+
+int poc_mask_extract(const uint64_t *samples, int n, uint64_t mask, uint8_t *out) {
+    const int k = __builtin_popcountll(mask);
+    uint64_t acc = 0;
+    int n_acc = 0, pos = 0;
+    for (int t = 0; t < n; t++) {
+        uint64_t v = pext64(samples[t], mask);
+        // At most 32 bits per append keeps acc from overflowing
+        for (int done = 0; done < k; done += 32) {
+            int take = k - done < 32 ? k - done : 32;
+            acc |= ((v >> done) & ((1ULL << take) - 1)) << n_acc;
+            n_acc += take;
+            while (n_acc >= 8) {
+                out[pos++] = (uint8_t)acc;
+                acc >>= 8;
+                n_acc -= 8;
+            }
+        }
+    }
+    if (n_acc > 0) out[pos++] = (uint8_t)acc;
+    return pos;
+}
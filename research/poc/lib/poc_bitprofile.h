@@ -0,0 +1,60 @@
+// poc_bitprofile.h — Per-bit-position entropy profile and extraction mask
+//
+// XOR-folding a 64-bit timing word to a byte caps a sample at 8 bits and
+// mixes stuck or biased bits into the good ones. The profile measures each
+// bit position on its own: P(1), per-bit H∞ = -log2 max(p, 1 - p), lag-1
+// autocorrelation, and the phi coefficient against every other varying
+// bit. poc_bitprofile_mask then chooses a mask greedily: best bits first,
+// skipping any bit that is weak, self-correlated, or correlated with a bit
+// already chosen. poc_mask_extract packs the masked bits of each sample
+// into a dense bit stream.
+//
+// Samples are transposed into one bitset per position first, so bias, lag
+// and all 2016 pair counts are word-wide AND + popcount passes.
+
+#ifndef POC_BITPROFILE_H
+#define POC_BITPROFILE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_BIT_MIN_H    0.80   // per-bit H∞ a mask bit needs (|p - ½| ≲ 0.07)
+#define POC_BIT_MAX_CORR 0.10   // |lag-1 r| and |phi| a mask bit may have
+
+typedef struct {
+    int n;                      // samples profiled
+    uint64_t varying;           // positions that are not constant
+    double p1[64];              // P(bit = 1)
+    double h[64];               // per-bit H∞
+    double lag1[64];            // lag-1 autocorrelation of the bit
+    double phi[64][64];         // pairwise phi coefficient (0 unless both vary)
+} PocBitProfile;
+
+typedef struct {
+    uint64_t mask;
+    int bits;                   // popcount(mask)
+    double h_sum;               // Σ per-bit H∞ over the mask
+    double h_joint;             // H∞ of the packed value (masks up to 16 bits), else -1
+    double bits_per_sample;     // min(h_sum, h_joint): the figure to rely on
+} PocBitMask;
+
+// Profile n samples. delta != 0 profiles first differences (n - 1 values)
+// instead of the raw words. -1 on allocation failure or n < 2.
+int poc_bitprofile(const uint64_t *samples, int n, int delta, PocBitProfile *p);
+
+// Greedy mask over the profile with the thresholds above. samples/n/delta
+// must be the profiled series; they are needed for h_joint.
+PocBitMask poc_bitprofile_mask(const PocBitProfile *p, const uint64_t *samples, int n, int delta);
+
+// Pack (x & mask) of each sample, low bit first, into out. Returns the
+// number of bytes written (ceil(n × popcount(mask) / 8)).
+int poc_mask_extract(const uint64_t *samples, int n, uint64_t mask, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_BITPROFILE_H
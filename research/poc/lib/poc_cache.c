@@ -0,0 +1,205 @@
+// poc_cache.c — Validation results cached by build hash and machine
+
+#include "poc_cache.h"
+#include "poc_sha256.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+#define CACHE_MAGIC "# poc_cache v1 "
+#define STATUS_WIDTH 4
+
+// "# poc_cache v1 <key> <status>\n", fixed width so the status can be
+// filled in once the validation has finished.
+#define HEADER_LEN (sizeof(CACHE_MAGIC) - 1 + 64 + 1 + STATUS_WIDTH + 1)
+
+static void read_field(const char *path, const char *prefix, char sep, char *out, size_t len) {
+    FILE *f = fopen(path, "r");
+    if (!f) return;
+    char line[512];
+    size_t plen = strlen(prefix);
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, prefix, plen) != 0) continue;
+        char *v = strchr(line, sep);
+        if (!v) break;
+        v++;
+        while (*v == ' ' || *v == '\t' || *v == '"') v++;
+        size_t n = strcspn(v, "\"\n");
+        while (n > 0 && (v[n - 1] == ' ' || v[n - 1] == '\t')) n--;
+        snprintf(out, len, "%.*s", (int)n, v);
+        break;
+    }
+    fclose(f);
+}
+
+void poc_machine_fingerprint(char *buf, size_t len) {
+    char os[128] = "", version[128] = "", arch[72] = "unknown", chip[128] = "unknown";
+    struct utsname u;
+    if (uname(&u) == 0) snprintf(arch, sizeof(arch), "%s", u.machine);
+    if (strcmp(arch, "arm64") == 0) snprintf(arch, sizeof(arch), "aarch64");
+#if defined(__APPLE__)
+    snprintf(os, sizeof(os), "macos");
+    size_t n = sizeof(version) - 1;
+    if (sysctlbyname("kern.osproductversion", version, &n, NULL, 0) != 0) version[0] = 0;
+    n = sizeof(chip) - 1;
+    if (sysctlbyname("machdep.cpu.brand_string", chip, &n, NULL, 0) != 0)
+        snprintf(chip, sizeof(chip), "unknown");
+#elif defined(__linux__)
+    snprintf(os, sizeof(os), "linux");
+    read_field("/etc/os-release", "PRETTY_NAME=", '=', version, sizeof(version));
+    read_field("/proc/cpuinfo", "model name", ':', chip, sizeof(chip));
+#else
+    snprintf(os, sizeof(os), "%s", u.sysname);
+#endif
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    snprintf(buf, len, "%s %s|%s|%s|%ld", os, version, arch, chip, cores > 0 ? cores : 1);
+}
+
+int poc_cache_key(const char *const *paths, int n_paths, const char *context,
+                  char hex[POC_CACHE_KEY_HEX]) {
+    PocSha256 h;
+    poc_sha256_init(&h);
+    uint8_t buf[65536];
+    for (int i = 0; i < n_paths; i++) {
+        int fd = open(paths[i], O_RDONLY);
+        if (fd < 0) return -1;
+        const char *base = strrchr(paths[i], '/');
+        base = base ? base + 1 : paths[i];
+        poc_sha256_update(&h, base, strlen(base) + 1);
+        ssize_t got;
+        while ((got = read(fd, buf, sizeof(buf))) > 0) poc_sha256_update(&h, buf, (size_t)got);
+        close(fd);
+        if (got < 0) return -1;
+    }
+    poc_sha256_update(&h, context, strlen(context) + 1);
+    uint8_t digest[32];
+    poc_sha256_final(&h, digest);
+    for (int i = 0; i < 32; i++) snprintf(hex + 2 * i, 3, "%02x", digest[i]);
+    return 0;
+}
+
+static void entry_path(char *out, size_t len, const char *dir, const char *name,
+                       const char *key) {
+    snprintf(out, len, "%s/%s-%.16s.txt", dir, name, key);
+}
+
+int poc_cache_replay(const char *dir, const char *name, const char *key) {
+    char path[1024];
+    entry_path(path, sizeof(path), dir, name, key);
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    char header[HEADER_LEN + 1];
+    int status = -1;
+    if (fread(header, 1, HEADER_LEN, f) == HEADER_LEN &&
+        memcmp(header, CACHE_MAGIC, sizeof(CACHE_MAGIC) - 1) == 0 &&
+        memcmp(header + sizeof(CACHE_MAGIC) - 1, key, 64) == 0) {
+        header[HEADER_LEN] = 0;
+        status = atoi(header + sizeof(CACHE_MAGIC) - 1 + 65);
+        char buf[65536];
+        size_t got;
+        fflush(stdout);
+        while ((got = fread(buf, 1, sizeof(buf), f)) > 0) fwrite(buf, 1, got, stdout);
+    }
+    fclose(f);
+    return status;
+}
+
+static int write_all(int fd, const char *p, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(fd, p, len);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += w;
+        len -= (size_t)w;
+    }
+    return 0;
+}
+
+static void *tee_main(void *arg) {
+    PocCacheRecord *r = arg;
+    char buf[4096];
+    ssize_t got;
+    while ((got = read(r->pipe_rd, buf, sizeof(buf))) != 0) {
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        write_all(r->saved_fd, buf, (size_t)got);
+        if (r->file_fd >= 0 && write_all(r->file_fd, buf, (size_t)got) != 0) {
+            close(r->file_fd);
+            r->file_fd = -1;
+        }
+    }
+    return NULL;
+}
+
+int poc_cache_record_begin(PocCacheRecord *r, const char *dir, const char *name,
+                           const char *key) {
+    memset(r, 0, sizeof(*r));
+    r->saved_fd = r->pipe_rd = r->file_fd = -1;
+    mkdir(dir, 0755);
+    entry_path(r->path, sizeof(r->path), dir, name, key);
+    snprintf(r->tmp, sizeof(r->tmp), "%s.XXXXXX", r->path);
+    snprintf(r->key, sizeof(r->key), "%s", key);
+
+    char header[HEADER_LEN + 1];
+    snprintf(header, sizeof(header), CACHE_MAGIC "%.64s %*s\n", key, STATUS_WIDTH, "");
+    int fds[2] = {-1, -1};
+    r->file_fd = mkstemp(r->tmp);
+    if (r->file_fd < 0 || write_all(r->file_fd, header, HEADER_LEN) != 0 || pipe(fds) != 0)
+        goto fail;
+    fflush(stdout);
+    r->saved_fd = dup(STDOUT_FILENO);
+    if (r->saved_fd < 0 || dup2(fds[1], STDOUT_FILENO) < 0) goto fail;
+    close(fds[1]);
+    fds[1] = -1;
+    r->pipe_rd = fds[0];
+    if (pthread_create(&r->tee, NULL, tee_main, r) != 0) {
+        dup2(r->saved_fd, STDOUT_FILENO);
+        goto fail;
+    }
+    return 0;
+
+fail:
+    if (fds[0] >= 0) close(fds[0]);
+    if (fds[1] >= 0) close(fds[1]);
+    if (r->saved_fd >= 0) close(r->saved_fd);
+    if (r->file_fd >= 0) {
+        close(r->file_fd);
+        unlink(r->tmp);
+    }
+    return -1;
+}
+
+int poc_cache_record_end(PocCacheRecord *r, int status, int keep) {
+    // Putting stdout back closes the pipe's only write end, so the tee
+    // drains to EOF and exits.
+    fflush(stdout);
+    dup2(r->saved_fd, STDOUT_FILENO);
+    pthread_join(r->tee, NULL);
+    close(r->saved_fd);
+    close(r->pipe_rd);
+    if (r->file_fd < 0) {
+        unlink(r->tmp);
+        return -1;
+    }
+    char header[HEADER_LEN + 1];
+    snprintf(header, sizeof(header), CACHE_MAGIC "%.64s %*d\n", r->key, STATUS_WIDTH, status);
+    int ok = keep && pwrite(r->file_fd, header, HEADER_LEN, 0) == (ssize_t)HEADER_LEN;
+    close(r->file_fd);
+    if (ok && rename(r->tmp, r->path) == 0) return 0;
+    unlink(r->tmp);
+    return keep ? -1 : 0;
+}
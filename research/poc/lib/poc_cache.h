@@ -0,0 +1,61 @@
+// poc_cache.h — Validation results cached by build hash and machine
+//
+// A cached result is the report one validation printed plus its exit
+// status, kept in <dir>/<name>-<key prefix>.txt. The key is SHA-256 over
+// the named object files the result was built from (name and contents
+// of each) and a context string. The context holds the machine
+// fingerprint plus anything else the result depends on. Rebuilding an
+// object, moving to other hardware or changing the context gives a new
+// key, so a stale entry is never read again. Entries from several
+// machines can share one directory.
+//
+// The fingerprint has the same fields as openentropy-core's
+// detect_machine_info(): "os version | arch | chip | cores".
+
+#ifndef POC_CACHE_H
+#define POC_CACHE_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_CACHE_KEY_HEX 65        // 64 hex digits + NUL
+
+void poc_machine_fingerprint(char *buf, size_t len);
+
+// Returns 0, or -1 when a file cannot be read (nothing to key on).
+int poc_cache_key(const char *const *paths, int n_paths, const char *context,
+                  char hex[POC_CACHE_KEY_HEX]);
+
+// Print the cached report for (name, key) to stdout and return its exit
+// status, or -1 on a miss.
+int poc_cache_replay(const char *dir, const char *name, const char *key);
+
+// Record a validation: between begin and end, stdout still reaches the
+// terminal and is also copied into the entry.
+typedef struct {
+    int saved_fd;                   // the real stdout
+    int pipe_rd;
+    int file_fd;
+    pthread_t tee;
+    char tmp[1040];                 // path + ".XXXXXX"
+    char path[1024];
+    char key[POC_CACHE_KEY_HEX];
+} PocCacheRecord;
+
+// Returns 0, or -1 (stdout untouched) when the entry cannot be created.
+int poc_cache_record_begin(PocCacheRecord *r, const char *dir, const char *name,
+                           const char *key);
+
+// Restore stdout. With keep, the entry is committed with `status`;
+// otherwise it is discarded. Returns 0, or -1 on I/O failure.
+int poc_cache_record_end(PocCacheRecord *r, int status, int keep);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_CACHE_H
@@ -0,0 +1,192 @@
+// poc_capture.c — Append-only raw timing capture files
+
+#include "poc_capture.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "poc_platform.h"
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+_Static_assert(sizeof(PocCaptureHeader) == POC_CAPTURE_HEADER_SIZE,
+               "PocCaptureHeader must stay 256 bytes");
+
+static void copy_field(char *dst, size_t cap, const char *src) {
+    memset(dst, 0, cap);
+    if (src) memcpy(dst, src, strnlen(src, cap - 1));
+}
+
+static void local_timebase(uint32_t *numer, uint32_t *denom) {
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    *numer = tb.numer;
+    *denom = tb.denom;
+}
+
+static void fill_header(PocCaptureHeader *h, const char *source) {
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, POC_CAPTURE_MAGIC, sizeof(h->magic));
+    h->version = POC_CAPTURE_VERSION;
+    h->header_size = POC_CAPTURE_HEADER_SIZE;
+    local_timebase(&h->timebase_numer, &h->timebase_denom);
+    h->created_unix = (uint64_t)time(NULL);
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    h->cores = cores > 0 ? (uint32_t)cores : 1;
+    copy_field(h->source, sizeof(h->source), source);
+
+    struct utsname u;
+    if (uname(&u) == 0) {
+        snprintf(h->os, sizeof(h->os), "%.31s %.31s", u.sysname, u.release);
+        copy_field(h->arch, sizeof(h->arch), u.machine);
+    }
+#if defined(__APPLE__)
+    size_t len = sizeof(h->chip) - 1;
+    if (sysctlbyname("machdep.cpu.brand_string", h->chip, &len, NULL, 0) != 0)
+        copy_field(h->chip, sizeof(h->chip), "unknown");
+#else
+    copy_field(h->chip, sizeof(h->chip), "unknown");
+#endif
+}
+
+static int header_valid(const PocCaptureHeader *h) {
+    return memcmp(h->magic, POC_CAPTURE_MAGIC, sizeof(h->magic)) == 0 &&
+           h->version == POC_CAPTURE_VERSION && h->header_size == POC_CAPTURE_HEADER_SIZE &&
+           h->timebase_denom != 0;
+}
+
+static int write_all(int fd, const void *buf, size_t len, off_t off) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t w = pwrite(fd, p, len, off);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += w;
+        off += w;
+        len -= (size_t)w;
+    }
+    return 0;
+}
+
+static int commit_count(PocCaptureWriter *w) {
+    return write_all(w->fd, &w->count, sizeof(w->count),
+                     (off_t)offsetof(PocCaptureHeader, sample_count));
+}
+
+int poc_capture_open(PocCaptureWriter *w, const char *path, const char *source) {
+    w->fd = open(path, O_RDWR | O_CREAT, 0644);
+    w->count = 0;
+    if (w->fd < 0) return -1;
+
+    PocCaptureHeader h;
+    ssize_t got = pread(w->fd, &h, sizeof(h), 0);
+    if (got == (ssize_t)sizeof(h)) {
+        uint32_t numer, denom;
+        local_timebase(&numer, &denom);
+        if (!header_valid(&h) || strncmp(h.source, source, sizeof(h.source)) != 0 ||
+            h.timebase_numer != numer || h.timebase_denom != denom) {
+            close(w->fd);
+            w->fd = -1;
+            errno = EINVAL;
+            return -1;
+        }
+        w->count = h.sample_count;
+        // Drop any uncommitted tail so appends stay contiguous.
+        if (ftruncate(w->fd, (off_t)(POC_CAPTURE_HEADER_SIZE + w->count * sizeof(uint64_t))) != 0)
+            goto fail;
+        return 0;
+    }
+
+    fill_header(&h, source);
+    if (ftruncate(w->fd, 0) != 0 || write_all(w->fd, &h, sizeof(h), 0) != 0) goto fail;
+    return 0;
+
+fail:
+    close(w->fd);
+    w->fd = -1;
+    return -1;
+}
+
+int poc_capture_append(PocCaptureWriter *w, const uint64_t *samples, int n) {
+    if (n <= 0) return 0;
+    off_t off = (off_t)(POC_CAPTURE_HEADER_SIZE + w->count * sizeof(uint64_t));
+    if (write_all(w->fd, samples, (size_t)n * sizeof(uint64_t), off) != 0) return -1;
+    w->count += (uint64_t)n;
+    return commit_count(w);
+}
+
+uint64_t poc_capture_collect(PocCaptureWriter *w, poc_collect_fn collect, uint64_t total,
+                             uint64_t *chunk, int chunk_n) {
+    uint64_t written = 0;
+    int empty = 0;
+    while (written < total) {
+        uint64_t left = total - written;
+        int want = left < (uint64_t)chunk_n ? (int)left : chunk_n;
+        int got = collect(chunk, want);
+        if (got <= 0) {
+            if (++empty >= 3) break; // collector stopped producing
+            continue;
+        }
+        empty = 0;
+        if (poc_capture_append(w, chunk, got) != 0) break;
+        written += (uint64_t)got;
+    }
+    return written;
+}
+
+int poc_capture_close(PocCaptureWriter *w) {
+    if (w->fd < 0) return 0;
+    int rc = fsync(w->fd);
+    if (close(w->fd) != 0) rc = -1;
+    w->fd = -1;
+    return rc;
+}
+
+int poc_capture_map(PocCapture *c, const char *path) {
+    memset(c, 0, sizeof(*c));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if ((size_t)st.st_size < POC_CAPTURE_HEADER_SIZE) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    const PocCaptureHeader *h = map;
+    if (!header_valid(h)) {
+        munmap(map, (size_t)st.st_size);
+        errno = EINVAL;
+        return -1;
+    }
+    uint64_t present = ((uint64_t)st.st_size - POC_CAPTURE_HEADER_SIZE) / sizeof(uint64_t);
+    c->header = h;
+    c->samples = (const uint64_t *)((const char *)map + POC_CAPTURE_HEADER_SIZE);
+    c->n = h->sample_count < present ? h->sample_count : present;
+    c->map = map;
+    c->map_len = (size_t)st.st_size;
+    return 0;
+}
+
+void poc_capture_unmap(PocCapture *c) {
+    if (c->map) munmap(c->map, c->map_len);
+    memset(c, 0, sizeof(*c));
+}
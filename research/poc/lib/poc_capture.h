@@ -0,0 +1,83 @@
+// poc_capture.h — Append-only raw timing capture files
+//
+// One expensive collection (ioreg, process spawn, keychain) written once,
+// then mmapped zero-copy by as many analysis passes as needed — here and
+// by openentropy_core::session::RawCapture in Rust.
+//
+// Layout (little-endian):
+//   [0, 256)  PocCaptureHeader
+//   [256, …)  uint64_t samples, raw collector deltas in timebase ticks
+//
+// sample_count is rewritten after every append, so a reader only ever sees
+// samples the writer has committed; a torn tail from a crash is ignored.
+
+#ifndef POC_CAPTURE_H
+#define POC_CAPTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "poc_stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_CAPTURE_MAGIC "OETRAW01"
+#define POC_CAPTURE_VERSION 1
+#define POC_CAPTURE_HEADER_SIZE 256
+
+typedef struct {
+    char magic[8];            // POC_CAPTURE_MAGIC, not NUL-terminated
+    uint32_t version;
+    uint32_t header_size;     // offset of the first sample
+    uint32_t timebase_numer;  // mach_timebase_info: ns = ticks * numer / denom
+    uint32_t timebase_denom;
+    uint64_t sample_count;
+    uint64_t created_unix;
+    uint32_t cores;
+    uint32_t reserved;
+    char source[64];          // NUL-padded strings from here on
+    char arch[16];
+    char chip[64];
+    char os[64];
+} PocCaptureHeader;
+
+typedef struct {
+    int fd;
+    uint64_t count;
+} PocCaptureWriter;
+
+typedef struct {
+    const PocCaptureHeader *header;
+    const uint64_t *samples;
+    uint64_t n;
+    void *map;
+    size_t map_len;
+} PocCapture;
+
+// Open path for appending samples from source. An existing capture of the
+// same source is extended (its timebase must match this machine's); a new
+// file gets a fresh header. Returns 0, or -1 with errno set.
+int poc_capture_open(PocCaptureWriter *w, const char *path, const char *source);
+
+// Append n samples and commit the new count. Returns 0 or -1.
+int poc_capture_append(PocCaptureWriter *w, const uint64_t *samples, int n);
+
+// Pull `total` samples from a collector in chunk_n pieces straight into the
+// file. Returns the number of samples written.
+uint64_t poc_capture_collect(PocCaptureWriter *w, poc_collect_fn collect, uint64_t total,
+                             uint64_t *chunk, int chunk_n);
+
+int poc_capture_close(PocCaptureWriter *w);
+
+// Map a capture read-only. samples points into the mapping; nothing is
+// copied. Returns 0, or -1 (errno EINVAL for a malformed header).
+int poc_capture_map(PocCapture *c, const char *path);
+void poc_capture_unmap(PocCapture *c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_CAPTURE_H
@@ -0,0 +1,65 @@
+// poc_corrmat.c — All-pairs Pearson correlation matrix as one GEMM
+
+#include "poc_corrmat.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__APPLE__)
+#include <Accelerate/Accelerate.h>
+#endif
+
+// z = (x − mean) / ‖x − mean‖; all-zero when the row has no variance.
+static void standardize(const double *x, int n, double *z) {
+    double mean = 0;
+    for (int i = 0; i < n; i++) mean += x[i];
+    mean /= n;
+    double e = 0;
+    for (int i = 0; i < n; i++) {
+        z[i] = x[i] - mean;
+        e += z[i] * z[i];
+    }
+    if (e < 1e-15) {
+        memset(z, 0, sizeof(double) * n);
+        return;
+    }
+    double inv = 1.0 / sqrt(e);
+    for (int i = 0; i < n; i++) z[i] *= inv;
+}
+
+int poc_corr_matrix(const double *samples, int n_sources, int stride, int n, double *r) {
+    const int S = n_sources;
+    memset(r, 0, sizeof(double) * S * S);
+    if (S <= 0 || n <= 1) return 0;
+
+    double *z = malloc(sizeof(double) * S * n);
+    if (!z) return -1;
+    for (int i = 0; i < S; i++)
+        standardize(samples + (size_t)i * stride, n, z + (size_t)i * n);
+
+#if defined(__APPLE__)
+    cblas_dsyrk(CblasRowMajor, CblasUpper, CblasNoTrans, S, n,
+                1.0, z, n, 0.0, r, S);
+#else
+    // Upper triangle, 256-sample blocks so both rows stay in L1.
+    for (int k0 = 0; k0 < n; k0 += 256) {
+        int k1 = k0 + 256 < n ? k0 + 256 : n;
+        for (int i = 0; i < S; i++) {
+            const double *zi = z + (size_t)i * n;
+            for (int j = i; j < S; j++) {
+                const double *zj = z + (size_t)j * n;
+                double acc = 0;
+                for (int k = k0; k < k1; k++) acc += zi[k] * zj[k];
+                r[i * S + j] += acc;
+            }
+        }
+    }
+#endif
+
+    for (int i = 0; i < S; i++)
+        for (int j = i + 1; j < S; j++) r[j * S + i] = r[i * S + j];
+
+    free(z);
+    return 0;
+}
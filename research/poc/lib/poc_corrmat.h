@@ -0,0 +1,28 @@
+// poc_corrmat.h — All-pairs Pearson correlation matrix as one GEMM
+//
+// Looping pearson() over every pair of S sources costs S²/2 passes over the
+// samples. Standardizing each row once (zero mean, unit norm) turns the
+// whole matrix into R = Z·Zᵀ, a single symmetric rank-k update
+// (cblas_dsyrk in Accelerate on macOS, a blocked loop elsewhere).
+
+#ifndef POC_CORRMAT_H
+#define POC_CORRMAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Row capacity for correlation audits: every PoC collector fits.
+#define POC_MAX_SOURCES 64
+
+// samples: n_sources rows of n doubles, row i starting at samples + i*stride.
+// r: n_sources × n_sources row-major output, r[i*n_sources + j] equals
+// pearson_f64(row i, row j, n) (0 for rows with zero variance, including
+// the diagonal). Returns 0 on success, -1 on allocation failure.
+int poc_corr_matrix(const double *samples, int n_sources, int stride, int n, double *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_CORRMAT_H
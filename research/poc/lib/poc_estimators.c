@@ -0,0 +1,280 @@
+// poc_estimators.c — SP 800-90B style min-entropy estimators for byte streams
+
+#include "poc_estimators.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define Z_99 2.576          // z_{0.995}, the 99% interval conditioning.rs uses
+#define H_MAX 8.0
+#define TUPLE_MAX_T 3       // t-tuple lengths, as in t_tuple_estimate
+#define LRS_CUTOFF 35       // §6.3.6: u is the first t whose top count falls below this
+
+static double h_of(double p) {
+    if (p <= 0) return H_MAX;
+    if (p >= 1) return 0;
+    double h = -log2(p);
+    return h < H_MAX ? h : H_MAX;
+}
+
+double poc_mcv_estimate(const uint8_t *data, int n, double *p_upper) {
+    if (n <= 0) {
+        if (p_upper) *p_upper = 1;
+        return 0;
+    }
+    uint32_t counts[256] = {0};
+    for (int i = 0; i < n; i++) counts[data[i]]++;
+    uint32_t mx = 0;
+    for (int i = 0; i < 256; i++)
+        if (counts[i] > mx) mx = counts[i];
+    double p = (double)mx / n;
+    double pu = p + Z_99 * sqrt(p * (1 - p) / n);
+    if (pu > 1) pu = 1;
+    if (p_upper) *p_upper = pu;
+    if (pu >= 1) return 0;
+    double h = -log2(pu);
+    return h > 0 ? h : 0;
+}
+
+// Distances between successive adjacent-equal pairs; see collision_estimate.
+double poc_collision_estimate(const uint8_t *data, int n) {
+    if (n < 3) return 0;
+    int last = -1, collisions = 0, k = 0;
+    double sum = 0, sumsq = 0;
+    for (int i = 0; i + 1 < n; i++) {
+        if (data[i] != data[i + 1]) continue;
+        collisions++;
+        if (last >= 0) {
+            double d = i - last;
+            sum += d;
+            sumsq += d * d;
+            k++;
+        }
+        last = i;
+    }
+    if (k == 0) {
+        if (collisions == 0) return H_MAX;
+        double p = sqrt((double)collisions / (n - 1));
+        return h_of(p < 1 ? p : 1);
+    }
+    double mean = sum / k;
+    double var = (sumsq - sum * mean) / (k > 1 ? k - 1 : 1);
+    double se = sqrt((var > 0 ? var : 0) / k);
+    double lower = mean - Z_99 * se;
+    if (lower < 1) lower = 1;
+    double p = sqrt(1 / lower);
+    return h_of(p < 1 ? p : 1);
+}
+
+double poc_markov_estimate(const uint8_t *data, int n) {
+    if (n < 2) return 0;
+    uint32_t init[256] = {0}, rows[256] = {0};
+    uint32_t *trans = calloc(256 * 256, sizeof(uint32_t));
+    if (!trans) return 0;
+    for (int i = 0; i < n; i++) init[data[i]]++;
+    for (int i = 0; i + 1 < n; i++) {
+        trans[data[i] << 8 | data[i + 1]]++;
+        rows[data[i]]++;
+    }
+    // max over s of max(p_init[s], max_pred p_trans[pred][s]) is the
+    // largest initial probability or the largest entry of any row
+    double p = 0;
+    for (int s = 0; s < 256; s++)
+        if ((double)init[s] / n > p) p = (double)init[s] / n;
+    for (int pred = 0; pred < 256; pred++) {
+        if (!rows[pred]) continue;
+        uint32_t mx = 0;
+        for (int s = 0; s < 256; s++)
+            if (trans[pred << 8 | s] > mx) mx = trans[pred << 8 | s];
+        if ((double)mx / rows[pred] > p) p = (double)mx / rows[pred];
+    }
+    free(trans);
+    return h_of(p);
+}
+
+// Maurer's statistic with its lower 99% bound, squared onto the min-entropy
+// scale (f² / 8), as in compression_estimate.
+double poc_compression_estimate(const uint8_t *data, int n) {
+    if (n < 100) return 0;
+    int q = n / 4 < 256 ? n / 4 : 256;
+    int last[256] = {0};   // 1-indexed position, 0 = unseen
+    for (int i = 0; i < q; i++) last[data[i]] = i + 1;
+    double sum = 0, sumsq = 0;
+    long count = 0;
+    for (int i = q; i < n; i++) {
+        int pos = i + 1, prev = last[data[i]];
+        if (prev > 0) {
+            double l = log2((double)(pos - prev));
+            sum += l;
+            sumsq += l * l;
+            count++;
+        }
+        last[data[i]] = pos;
+    }
+    if (count == 0) return H_MAX;
+    double f = sum / count;
+    double var = (sumsq - sum * f) / (count > 1 ? count - 1 : 1);
+    double se = sqrt((var > 0 ? var : 0) / count);
+    double lo = f - Z_99 * se;
+    if (lo < 0) lo = 0;
+    double h = lo * lo / H_MAX;
+    return h < H_MAX ? h : H_MAX;
+}
+
+// Suffix array by prefix doubling. Each round orders suffixes by (rank of
+// the first k bytes, rank of the next k) with two counting sorts and stops
+// once every rank is distinct, so random data finishes in a few rounds.
+// On return rank[] is the inverse of sa[].
+static void build_sa(const uint8_t *s, int n, int *sa, int *rank, int *tmp, int *cnt) {
+    memset(cnt, 0, 256 * sizeof(int));
+    for (int i = 0; i < n; i++) cnt[s[i]]++;
+    for (int c = 1; c < 256; c++) cnt[c] += cnt[c - 1];
+    for (int i = n - 1; i >= 0; i--) sa[--cnt[s[i]]] = i;
+    rank[sa[0]] = 0;
+    for (int i = 1; i < n; i++) rank[sa[i]] = rank[sa[i - 1]] + (s[sa[i]] != s[sa[i - 1]]);
+    int classes = rank[sa[n - 1]] + 1;
+
+    for (int k = 1; classes < n; k <<= 1) {
+        // Second key: suffixes with no bytes past k sort first
+        int p = 0;
+        for (int i = n - k; i < n; i++) tmp[p++] = i;
+        for (int j = 0; j < n; j++)
+            if (sa[j] >= k) tmp[p++] = sa[j] - k;
+        // Stable by first key
+        memset(cnt, 0, (size_t)classes * sizeof(int));
+        for (int i = 0; i < n; i++) cnt[rank[i]]++;
+        for (int c = 1; c < classes; c++) cnt[c] += cnt[c - 1];
+        for (int j = n - 1; j >= 0; j--) sa[--cnt[rank[tmp[j]]]] = tmp[j];
+
+        tmp[sa[0]] = 0;
+        for (int i = 1; i < n; i++) {
+            int a = sa[i - 1], b = sa[i];
+            int ra = a + k < n ? rank[a + k] : -1, rb = b + k < n ? rank[b + k] : -1;
+            tmp[b] = tmp[a] + (rank[a] != rank[b] || ra != rb);
+        }
+        memcpy(rank, tmp, (size_t)n * sizeof(int));
+        classes = rank[sa[n - 1]] + 1;
+    }
+}
+
+// Kasai: lcp[i] = LCP(sa[i-1], sa[i]), lcp[0] = 0.
+static void build_lcp(const uint8_t *s, int n, const int *sa, const int *rank, int *lcp) {
+    lcp[0] = 0;
+    for (int i = 0, h = 0; i < n; i++) {
+        if (rank[i] == 0) {
+            h = 0;
+            continue;
+        }
+        int j = sa[rank[i] - 1];
+        while (i + h < n && j + h < n && s[i + h] == s[j + h]) h++;
+        lcp[rank[i]] = h;
+        if (h > 0) h--;
+    }
+}
+
+int poc_tuple_estimates(const uint8_t *data, int n, double *t_tuple, double *lrs) {
+    *t_tuple = n < 20 ? 0 : H_MAX;
+    *lrs = H_MAX;
+    if (n < 20) return 0;
+
+    int *sa = malloc((size_t)n * sizeof(int));
+    int *rank = malloc((size_t)n * sizeof(int));
+    int *tmp = malloc((size_t)n * sizeof(int));
+    int *cnt = malloc((size_t)(n > 256 ? n : 256) * sizeof(int));
+    if (!sa || !rank || !tmp || !cnt) {
+        free(sa); free(rank); free(tmp); free(cnt);
+        return -1;
+    }
+    build_sa(data, n, sa, rank, tmp, cnt);
+    int *lcp = cnt;                 // cnt is free once the SA is built
+    build_lcp(data, n, sa, rank, lcp);
+    int v = 0;                      // longest repeated substring
+    for (int i = 1; i < n; i++)
+        if (lcp[i] > v) v = lcp[i];
+
+    // Walk the LCP intervals bottom-up. An interval of `size` suffixes
+    // sharing exactly L bytes (parent interval: Lp) is one t-tuple of
+    // count `size` for every t in (Lp, L]: it raises top[t] for t <= L and
+    // adds C(size, 2) colliding pairs to pairs[t] for t in (Lp, L].
+    int *top = calloc((size_t)v + 2, sizeof(int));
+    int64_t *pairs = calloc((size_t)v + 2, sizeof(int64_t));
+    int *stk_l = sa, *stk_b = tmp;  // sa/tmp are free once lcp exists
+    if (!top || !pairs) {
+        free(top); free(pairs); free(sa); free(rank); free(tmp); free(cnt);
+        return -1;
+    }
+    int sp = 0;
+    stk_l[0] = 0;
+    stk_b[0] = 0;
+    for (int i = 1; i <= n; i++) {
+        int cur = i < n ? lcp[i] : 0, lb = i - 1;
+        while (cur < stk_l[sp]) {
+            int L = stk_l[sp], l = stk_b[sp], size = i - l;
+            sp--;
+            int parent = cur > stk_l[sp] ? cur : stk_l[sp];
+            if (size > top[L]) top[L] = size;
+            int64_t c = (int64_t)size * (size - 1) / 2;
+            pairs[parent + 1] += c;
+            pairs[L + 1] -= c;
+            lb = l;
+        }
+        if (cur > stk_l[sp]) {
+            sp++;
+            stk_l[sp] = cur;
+            stk_b[sp] = lb;
+        }
+    }
+    for (int t = v - 1; t >= 1; t--)
+        if (top[t + 1] > top[t]) top[t] = top[t + 1];
+    for (int t = 1; t <= v + 1; t++) pairs[t] += pairs[t - 1];
+
+    // t-tuple as in conditioning.rs: min over t = 1..3 of -log2(p_t) / t
+    for (int t = 1; t <= TUPLE_MAX_T && n >= t + 1; t++) {
+        int c = t <= v && top[t] > 0 ? top[t] : 1;
+        double h = -log2((double)c / (n - t + 1)) / t;
+        if (h < *t_tuple) *t_tuple = h;
+    }
+
+    // LRS (§6.3.6): collision probability of W-tuples for W in [u, v]
+    int u = 1;
+    while (u <= v && top[u] >= LRS_CUTOFF) u++;
+    if (u <= v) {
+        double p = 0;
+        for (int w = u; w <= v; w++) {
+            double m = n - w + 1;
+            double pw = (double)pairs[w] / (m * (m - 1) / 2);
+            double r = pow(pw, 1.0 / w);
+            if (r > p) p = r;
+        }
+        double pu = p + Z_99 * sqrt(p * (1 - p) / (n - 1));
+        *lrs = h_of(pu < 1 ? pu : 1);
+    }
+
+    free(top); free(pairs); free(sa); free(rank); free(tmp); free(cnt);
+    return 0;
+}
+
+int poc_estimate_all(const uint8_t *data, int n, PocEstimates *e) {
+    memset(e, 0, sizeof(*e));
+    e->n = n;
+    e->mcv = poc_mcv_estimate(data, n, &e->mcv_p_upper);
+    e->collision = poc_collision_estimate(data, n);
+    e->markov = poc_markov_estimate(data, n);
+    e->compression = poc_compression_estimate(data, n);
+    int rc = poc_tuple_estimates(data, n, &e->t_tuple, &e->lrs);
+    // heuristic_floor leaves MCV out: it is the primary estimate, and the
+    // floor is the diagnostics' minimum
+    const double diag[] = {e->collision, e->markov, e->compression, e->t_tuple, e->lrs};
+    e->floor = diag[0];
+    for (int i = 1; i < (int)(sizeof(diag) / sizeof(diag[0])); i++)
+        if (diag[i] < e->floor) e->floor = diag[i];
+    return rc;
+}
+
+void poc_print_estimates(const PocEstimates *e) {
+    printf("  SP 800-90B: MCV=%.3f  Collision=%.3f  Markov=%.3f  Compression=%.3f"
+           "  t-Tuple=%.3f  LRS=%.3f  -> floor=%.3f\n",
+           e->mcv, e->collision, e->markov, e->compression, e->t_tuple, e->lrs, e->floor);
+}
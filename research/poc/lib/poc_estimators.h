@@ -0,0 +1,59 @@
+// poc_estimators.h — SP 800-90B style min-entropy estimators for byte streams
+//
+// C versions of the estimator suite in openentropy-core's conditioning.rs
+// (MCV, collision, Markov, compression, t-tuple), computed the same way so
+// a PoC and the Rust pipeline report the same numbers for the same bytes,
+// plus the SP 800-90B §6.3.6 longest-repeated-substring (LRS) estimate.
+//
+// Everything is one linear pass except the tuple estimators, which share a
+// suffix array (prefix doubling with counting sorts) and its LCP array:
+// one stack walk over the LCP intervals yields the most common t-tuple
+// count and the number of colliding t-tuple pairs for every t at once.
+// 1M bytes run in well under a second.
+//
+// Inputs are the XOR-folded sample bytes (poc_xorfold), as for H∞.
+
+#ifndef POC_ESTIMATORS_H
+#define POC_ESTIMATORS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    double mcv;             // primary estimate, as in min_entropy_estimate()
+    double mcv_p_upper;
+    double collision;
+    double markov;
+    double compression;
+    double t_tuple;
+    double lrs;
+    double floor;           // heuristic_floor (collision, Markov, compression,
+                            // t-tuple; not MCV) lowered by LRS
+    int n;
+} PocEstimates;
+
+// Bits per byte, 0..8. Each matches the conditioning.rs function of the
+// same name, including its short-input conventions.
+double poc_mcv_estimate(const uint8_t *data, int n, double *p_upper);
+double poc_collision_estimate(const uint8_t *data, int n);
+double poc_markov_estimate(const uint8_t *data, int n);
+double poc_compression_estimate(const uint8_t *data, int n);
+
+// t-tuple (t = 1..3, as in t_tuple_estimate) and LRS from one suffix
+// array. -1 when the scratch arrays cannot be allocated.
+int poc_tuple_estimates(const uint8_t *data, int n, double *t_tuple, double *lrs);
+
+// Run the whole suite. -1 on allocation failure (tuple fields are then 8).
+int poc_estimate_all(const uint8_t *data, int n, PocEstimates *out);
+
+// "  SP 800-90B: MCV=… Collision=… … → floor=…" on one line.
+void poc_print_estimates(const PocEstimates *e);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_ESTIMATORS_H
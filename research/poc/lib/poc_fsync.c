@@ -0,0 +1,240 @@
+// poc_fsync.c — Concurrent journal-commit (fsync) timing
+
+#include "poc_fsync.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "poc_platform.h"
+#include "poc_uring.h"
+
+#define MAX_FILES_PER_WORKER 64
+
+static inline uint64_t fs_now(void) { return mach_absolute_time(); }
+
+typedef struct {
+    const PocFsyncConfig *cfg;
+    int id;
+    int fds[MAX_FILES_PER_WORKER];
+    uint8_t *buf;
+    uint64_t *timings;   // this worker's slice
+    int ok;
+    _Atomic int *ready;
+    _Atomic int *go;
+} FsWorker;
+
+static int commit(int fd, PocFsyncMode mode) {
+#if defined(F_FULLFSYNC)
+    if (mode == POC_FSYNC_FULL) return fcntl(fd, F_FULLFSYNC) == -1 ? -1 : 0;
+#else
+    (void)mode;
+#endif
+    return fsync(fd);
+}
+
+// Stamp worker w's commit i into its buffer; returns the file offset and
+// sets *f to the file it goes to.
+static off_t next_record(FsWorker *w, int i, int *f) {
+    const PocFsyncConfig *c = w->cfg;
+    size_t slots = c->file_size / c->write_size;
+    *f = i % c->files_per_worker;
+    w->buf[0] = (uint8_t)i;
+    w->buf[1] = (uint8_t)(i >> 8);
+    w->buf[2] = (uint8_t)w->id;
+    // Rotate records through the file so successive commits to it hit
+    // different blocks.
+    return (off_t)(((size_t)(i / c->files_per_worker) * 7 + (size_t)w->id) % slots) *
+           (off_t)c->write_size;
+}
+
+static void *fs_worker(void *arg) {
+    FsWorker *w = arg;
+    const PocFsyncConfig *c = w->cfg;
+
+    atomic_fetch_add(w->ready, 1);
+    while (!atomic_load_explicit(w->go, memory_order_acquire)) sched_yield();
+
+    for (int i = 0; i < c->commits; i++) {
+        int f;
+        off_t off = next_record(w, i, &f);
+        uint64_t t0 = fs_now();
+        int good = pwrite(w->fds[f], w->buf, c->write_size, off) == (ssize_t)c->write_size &&
+                   commit(w->fds[f], c->mode) == 0;
+        uint64_t t1 = fs_now();
+        w->timings[i] = good ? t1 - t0 : 0;
+        w->ok += good;
+    }
+    return NULL;
+}
+
+static int open_files(const char *dir, FsWorker *w, uint8_t *fill) {
+    const PocFsyncConfig *c = w->cfg;
+    for (int f = 0; f < c->files_per_worker; f++) {
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/commit_w%d_f%d", dir, w->id, f);
+        int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (fd < 0) return -1;
+        // Unlinked up front: the inode lives until close, nothing to clean up.
+        unlink(path);
+        w->fds[f] = fd;
+        // Preallocate with real blocks so commits overwrite, not extend.
+        for (size_t o = 0; o < c->file_size; o += c->write_size)
+            if (pwrite(fd, fill, c->write_size, (off_t)o) != (ssize_t)c->write_size) return -1;
+        if (fsync(fd) != 0) return -1;
+    }
+    return 0;
+}
+
+static void close_files(FsWorker *w) {
+    for (int f = 0; f < w->cfg->files_per_worker; f++)
+        if (w->fds[f] >= 0) close(w->fds[f]);
+}
+
+static int valid_config(const PocFsyncConfig *cfg) {
+    return cfg->workers >= 1 && cfg->workers <= POC_FSYNC_MAX_WORKERS && cfg->commits >= 1 &&
+           cfg->files_per_worker >= 1 && cfg->files_per_worker <= MAX_FILES_PER_WORKER &&
+           cfg->write_size > 0 && cfg->file_size >= cfg->write_size;
+}
+
+// Preallocate every worker's files. Returns how many workers need
+// close_workers(); *rc is -1 when one could not be set up.
+static int open_workers(const char *dir, const PocFsyncConfig *cfg, FsWorker *workers,
+                        uint64_t *timings, int *rc) {
+    uint8_t *fill = malloc(cfg->write_size);
+    *rc = fill ? 0 : -1;
+    if (!fill) return 0;
+    memset(fill, 0x5A, cfg->write_size);
+
+    int set_up = 0;
+    for (int w = 0; w < cfg->workers; w++) {
+        FsWorker *fw = &workers[w];
+        memset(fw, 0, sizeof(*fw));
+        fw->cfg = cfg;
+        fw->id = w;
+        fw->timings = timings + (size_t)w * (size_t)cfg->commits;
+        for (int f = 0; f < cfg->files_per_worker; f++) fw->fds[f] = -1;
+        fw->buf = malloc(cfg->write_size);
+        set_up++;
+        if (!fw->buf || open_files(dir, fw, fill) != 0) {
+            *rc = -1;
+            break;
+        }
+        memset(fw->buf, 0xA5, cfg->write_size);
+    }
+    free(fill);
+    return set_up;
+}
+
+static int close_workers(FsWorker *workers, int set_up) {
+    int ok = 0;
+    for (int w = 0; w < set_up; w++) {
+        ok += workers[w].ok;
+        close_files(&workers[w]);
+        free(workers[w].buf);
+    }
+    return ok;
+}
+
+int poc_fsync_run(const char *dir, const PocFsyncConfig *cfg, uint64_t *timings,
+                  uint64_t *elapsed) {
+    if (!valid_config(cfg)) return -1;
+
+    FsWorker workers[POC_FSYNC_MAX_WORKERS];
+    pthread_t threads[POC_FSYNC_MAX_WORKERS];
+    _Atomic int ready = 0, go = 0;
+    int rc;
+    int set_up = open_workers(dir, cfg, workers, timings, &rc);
+    for (int w = 0; w < set_up; w++) {
+        workers[w].ready = &ready;
+        workers[w].go = &go;
+    }
+
+    int started = 0;
+    if (rc == 0) {
+        for (; started < cfg->workers; started++)
+            if (pthread_create(&threads[started], NULL, fs_worker, &workers[started]) != 0) break;
+        if (started < cfg->workers) rc = -1;
+    }
+
+    // Release everyone at once, even after a partial start, so joins finish.
+    while (atomic_load(&ready) < started) sched_yield();
+    uint64_t t0 = fs_now();
+    atomic_store_explicit(&go, 1, memory_order_release);
+    for (int w = 0; w < started; w++) pthread_join(threads[w], NULL);
+    if (elapsed) *elapsed = fs_now() - t0;
+
+    int ok = close_workers(workers, set_up);
+    return rc == 0 ? ok : -1;
+}
+
+// user_data: slot << 1, low bit set on the fsync half of a commit.
+static int queue_commit(PocUring *u, FsWorker *w, int i) {
+    int f;
+    off_t off = next_record(w, i, &f);
+    uint64_t tag = (uint64_t)w->id << 1;
+    if (poc_uring_write(u, w->fds[f], w->buf, w->cfg->write_size, off, tag, 1) != 0) return -1;
+    return poc_uring_fsync(u, w->fds[f], tag | 1);
+}
+
+int poc_fsync_uring_run(const char *dir, const PocFsyncConfig *cfg, uint64_t *timings,
+                        uint64_t *elapsed) {
+    if (!valid_config(cfg)) return -1;
+    PocUring *u = poc_uring_open(2 * (unsigned)cfg->workers);
+    if (!u) return -1;
+
+    FsWorker slots[POC_FSYNC_MAX_WORKERS];
+    int rc;
+    int set_up = open_workers(dir, cfg, slots, timings, &rc);
+    int next[POC_FSYNC_MAX_WORKERS] = {0}, write_ok[POC_FSYNC_MAX_WORKERS] = {0};
+    uint64_t queued_at[POC_FSYNC_MAX_WORKERS];
+    PocUringCqe cqes[2 * POC_FSYNC_MAX_WORKERS];
+    int outstanding = 0;
+
+    uint64_t t0 = fs_now();
+    for (int s = 0; rc == 0 && s < cfg->workers; s++) {
+        queued_at[s] = fs_now();
+        if (queue_commit(u, &slots[s], 0) != 0) rc = -1;
+        else outstanding++;
+    }
+    while (rc == 0 && outstanding > 0) {
+        // Every commit queued since the last pass goes down in this one call.
+        if (poc_uring_submit(u, 1) < 0) {
+            rc = -1;
+            break;
+        }
+        uint64_t now = fs_now();
+        int k = poc_uring_reap(u, cqes, 2 * cfg->workers);
+        for (int c = 0; c < k; c++) {
+            int s = (int)(cqes[c].user_data >> 1);
+            FsWorker *w = &slots[s];
+            if (!(cqes[c].user_data & 1)) {
+                write_ok[s] = cqes[c].res == (int32_t)cfg->write_size;
+                continue;
+            }
+            int good = write_ok[s] && cqes[c].res == 0;
+            w->timings[next[s]] = good ? now - queued_at[s] : 0;
+            w->ok += good;
+            outstanding--;
+            if (++next[s] < cfg->commits) {
+                queued_at[s] = now;
+                if (queue_commit(u, w, next[s]) != 0) rc = -1;
+                else outstanding++;
+            }
+        }
+    }
+    if (elapsed) *elapsed = fs_now() - t0;
+
+    poc_uring_close(u);
+    int ok = close_workers(slots, set_up);
+    return rc == 0 ? ok : -1;
+}
+
+const char *poc_fsync_mode_name(PocFsyncMode mode) {
+    return mode == POC_FSYNC_FULL ? "F_FULLFSYNC" : "fsync";
+}
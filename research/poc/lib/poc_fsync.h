@@ -0,0 +1,62 @@
+// poc_fsync.h — Concurrent journal-commit (fsync) timing
+//
+// One fd fsynced from one thread serializes every commit through the
+// filesystem journal. poc_fsync_run() starts K workers, each owning its
+// own preallocated files in a caller-supplied directory, and has them
+// commit concurrently: pwrite a small record at a rotating offset, then
+// fsync() or fcntl(F_FULLFSYNC) (which also flushes the drive's cache).
+// Each worker times its commits into its own slice of the output, so the
+// hot loop shares nothing but the start barrier.
+//
+// Times are mach_absolute_time() ticks (lib/poc_platform.h off macOS).
+// Without F_FULLFSYNC (Linux) POC_FSYNC_FULL falls back to fsync().
+
+#ifndef POC_FSYNC_H
+#define POC_FSYNC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_FSYNC_MAX_WORKERS 32
+
+typedef enum {
+    POC_FSYNC_PLAIN,   // fsync(2)
+    POC_FSYNC_FULL,    // fcntl(F_FULLFSYNC)
+} PocFsyncMode;
+
+typedef struct {
+    int workers;          // 1..POC_FSYNC_MAX_WORKERS
+    int files_per_worker; // commits rotate over these
+    int commits;          // per worker
+    size_t write_size;    // bytes per commit record
+    size_t file_size;     // preallocated size of each file
+    PocFsyncMode mode;
+} PocFsyncConfig;
+
+// Run one concurrent commit burst in dir. Worker w writes its commit
+// timings to timings[w * cfg->commits + i]; failed commits are stored as 0.
+// *elapsed (optional) gets the wall time of the timed phase. Returns the
+// number of successful commits, or -1 on bad config / setup failure.
+int poc_fsync_run(const char *dir, const PocFsyncConfig *cfg, uint64_t *timings,
+                  uint64_t *elapsed);
+
+// The same burst from one thread over io_uring (lib/poc_uring.h, Linux):
+// cfg->workers commits stay in flight, each a write linked to an fsync on
+// that worker's files, and every pass resubmits all that completed in one
+// io_uring_enter(2). A commit is timed from being queued to its fsync
+// being reaped; cfg->mode is ignored (plain fsync). Same timings layout
+// and return value as poc_fsync_run(); -1 where io_uring is unavailable.
+int poc_fsync_uring_run(const char *dir, const PocFsyncConfig *cfg, uint64_t *timings,
+                        uint64_t *elapsed);
+
+const char *poc_fsync_mode_name(PocFsyncMode mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_FSYNC_H
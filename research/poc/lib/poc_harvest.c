@@ -0,0 +1,327 @@
+// poc_harvest.c — Long-running collection served over a local socket
+
+#if defined(__linux__)
+#define _GNU_SOURCE                     // struct ucred
+#endif
+
+#include "poc_harvest.h"
+#include "poc_platform.h"
+#include "poc_spsc.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+typedef struct {
+    PocSpsc ring;                       // samples as word pairs
+    const PocHarvestSource *src;
+    pthread_t thread;
+    int started;
+    pthread_mutex_t read_lock;          // clients share the ring's one consumer side
+    pthread_mutex_t group_lock;         // used through `collect_lock`
+    pthread_mutex_t *collect_lock;      // the group's first worker's group_lock
+    uint32_t cap_words;
+    int chunk;
+    double max_rate;
+    uint64_t *buf;
+    _Atomic uint64_t produced;
+    _Atomic uint64_t delivered;
+    _Atomic uint64_t stalls;            // pauses on a full ring
+} Worker;
+
+static Worker *g_workers;
+static int g_n_workers;
+static atomic_int g_stop;
+static double g_ns_per_tick;
+
+static void on_signal(int sig) {
+    (void)sig;
+    atomic_store(&g_stop, 1);
+}
+
+// dir/POC_HARVEST_SOCKET_NAME into buf; dir may end in '/'.
+static int socket_in(char *buf, size_t len, const char *dir) {
+    size_t n = strlen(dir);
+    const char *sep = n > 0 && dir[n - 1] == '/' ? "" : "/";
+    if ((size_t)snprintf(buf, len, "%s%s%s", dir, sep, POC_HARVEST_SOCKET_NAME) >= len) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    return 0;
+}
+
+int poc_harvest_default_socket(char *buf, size_t len) {
+    const char *xdg = getenv("XDG_RUNTIME_DIR");
+    if (xdg && *xdg) return socket_in(buf, len, xdg);
+#if defined(__APPLE__)
+    char tmp[1024];
+    size_t got = confstr(_CS_DARWIN_USER_TEMP_DIR, tmp, sizeof(tmp));
+    if (got > 0 && got <= sizeof(tmp)) return socket_in(buf, len, tmp);
+#endif
+    char dir[64];
+    snprintf(dir, sizeof(dir), "/tmp/openentropy-poc-%u", (unsigned)geteuid());
+    struct stat st;
+    if (mkdir(dir, 0700) != 0 && errno != EEXIST) return -1;
+    // An existing directory must be a real one, ours, and closed to others
+    if (lstat(dir, &st) != 0) return -1;
+    if (!S_ISDIR(st.st_mode) || st.st_uid != geteuid() || (st.st_mode & 077)) {
+        errno = EPERM;
+        return -1;
+    }
+    return socket_in(buf, len, dir);
+}
+
+void poc_harvest_defaults(PocHarvestConfig *cfg) {
+    static char path[1100];
+    cfg->socket_path = poc_harvest_default_socket(path, sizeof(path)) == 0 ? path : NULL;
+    cfg->ring_samples = 1u << 20;
+    cfg->chunk = 4096;
+    cfg->max_rate = 0;
+}
+
+static void *worker_main(void *arg) {
+    Worker *w = arg;
+    const uint64_t t0 = mach_absolute_time();
+    const uint32_t need = (uint32_t)w->chunk * 2;
+    int paused = 0;
+    while (!atomic_load(&g_stop)) {
+        // Back-pressure: wait for the server to make room for a whole chunk
+        if (w->cap_words - poc_spsc_size(&w->ring) < need) {
+            if (!paused) atomic_fetch_add(&w->stalls, 1);
+            paused = 1;
+            usleep(1000);
+            continue;
+        }
+        paused = 0;
+        if (w->max_rate > 0) {
+            double secs = (double)(mach_absolute_time() - t0) * g_ns_per_tick / 1e9;
+            if ((double)atomic_load(&w->produced) >= secs * w->max_rate) {
+                usleep(1000);
+                continue;
+            }
+        }
+        pthread_mutex_lock(w->collect_lock);
+        int got = w->src->collect(w->buf, w->chunk);
+        pthread_mutex_unlock(w->collect_lock);
+        if (got <= 0) {
+            usleep(10000);
+            continue;
+        }
+        poc_spsc_write_all(&w->ring, w->buf, (uint32_t)got * 2);
+        atomic_fetch_add(&w->produced, (uint64_t)got);
+    }
+    return NULL;
+}
+
+static int write_all(int fd, const void *p, size_t len) {
+    const char *c = p;
+    while (len > 0) {
+        ssize_t n = write(fd, c, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        c += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static Worker *find_worker(const char *name) {
+    for (int i = 0; i < g_n_workers; i++)
+        if (strcmp(g_workers[i].src->name, name) == 0) return &g_workers[i];
+    return NULL;
+}
+
+// Up to n samples into out, waiting a little for a full read.
+static uint32_t read_samples(Worker *w, uint64_t *out, uint32_t n) {
+    const uint64_t deadline =
+        mach_absolute_time() + (uint64_t)(POC_HARVEST_READ_WAIT_MS * 1e6 / g_ns_per_tick);
+    while (poc_spsc_size(&w->ring) < (uint64_t)n * 2 && mach_absolute_time() < deadline &&
+           !atomic_load(&g_stop))
+        usleep(1000);
+    pthread_mutex_lock(&w->read_lock);
+    uint32_t words = poc_spsc_read(&w->ring, (uint32_t *)out, n * 2);
+    pthread_mutex_unlock(&w->read_lock);
+    atomic_fetch_add(&w->delivered, words / 2);
+    return words / 2;
+}
+
+static void *client_main(void *arg) {
+    int fd = (int)(intptr_t)arg;
+    FILE *in = fdopen(dup(fd), "r");
+    uint64_t *buf = NULL;
+    uint32_t buf_n = 0;
+    char line[256], name[128];
+    while (in && fgets(line, sizeof(line), in)) {
+        unsigned long n;
+        if (strcmp(line, "LIST\n") == 0) {
+            char reply[POC_HARVEST_MAX_SOURCES * 64 + 8] = "OK";
+            for (int i = 0; i < g_n_workers; i++) {
+                size_t len = strlen(reply);
+                snprintf(reply + len, sizeof(reply) - len, " %s", g_workers[i].src->name);
+            }
+            strcat(reply, "\n");
+            if (write_all(fd, reply, strlen(reply)) != 0) break;
+        } else if (strcmp(line, "STATS\n") == 0) {
+            for (int i = 0; i < g_n_workers; i++) {
+                Worker *w = &g_workers[i];
+                char row[256];
+                snprintf(row, sizeof(row), "%s %llu %llu %llu %llu\n", w->src->name,
+                         (unsigned long long)atomic_load(&w->produced),
+                         (unsigned long long)atomic_load(&w->delivered),
+                         (unsigned long long)atomic_load(&w->stalls),
+                         (unsigned long long)(poc_spsc_size(&w->ring) / 2));
+                if (write_all(fd, row, strlen(row)) != 0) break;
+            }
+            if (write_all(fd, ".\n", 2) != 0) break;
+        } else if (sscanf(line, "READ %127s %lu", name, &n) == 2 && n > 0 &&
+                   n <= POC_HARVEST_MAX_READ) {
+            Worker *w = find_worker(name);
+            if (!w) break;
+            if (n > buf_n) {
+                uint64_t *grown = realloc(buf, n * sizeof(uint64_t));
+                if (!grown) break;
+                buf = grown;
+                buf_n = (uint32_t)n;
+            }
+            uint32_t k = read_samples(w, buf, (uint32_t)n);
+            if (write_all(fd, &k, sizeof(k)) != 0 ||
+                write_all(fd, buf, (size_t)k * sizeof(uint64_t)) != 0)
+                break;
+        } else {
+            break;
+        }
+    }
+    if (in) fclose(in);
+    close(fd);
+    free(buf);
+    return NULL;
+}
+
+// 1 when the process on the other end of fd runs as our effective user.
+static int peer_is_us(int fd) {
+#if defined(__linux__)
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0) return 0;
+    return cred.uid == geteuid();
+#else
+    uid_t uid;
+    gid_t gid;
+    if (getpeereid(fd, &uid, &gid) != 0) return 0;
+    return uid == geteuid();
+#endif
+}
+
+static int listen_on(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+    strcpy(addr.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    unlink(path);
+    // Created 0600 rather than chmod-ed after bind, so it is never open
+    mode_t old = umask(0177);
+    int rc = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    umask(old);
+    if (rc != 0 || listen(fd, 16) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int poc_harvest_run(const PocHarvestSource *src, int n, const PocHarvestConfig *cfg) {
+    if (n < 1 || n > POC_HARVEST_MAX_SOURCES || !cfg->socket_path || cfg->chunk < 1 ||
+        (uint32_t)cfg->chunk > cfg->ring_samples || cfg->ring_samples > 1u << 28)
+        return -1;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < i; j++)
+            if (strcmp(src[i].name, src[j].name) == 0) {
+                errno = EINVAL;
+                return -1;
+            }
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    g_ns_per_tick = (double)tb.numer / tb.denom;
+
+    // Workers and rings stay allocated until exit: a client thread may still
+    // be inside a READ when the daemon stops.
+    g_workers = aligned_alloc(_Alignof(Worker), sizeof(Worker) * (size_t)n);
+    if (!g_workers) return -1;
+    memset(g_workers, 0, sizeof(Worker) * (size_t)n);
+    for (int i = 0; i < n; i++) {
+        Worker *w = &g_workers[i];
+        w->src = &src[i];
+        w->chunk = cfg->chunk;
+        w->max_rate = cfg->max_rate;
+        pthread_mutex_init(&w->read_lock, NULL);
+        pthread_mutex_init(&w->group_lock, NULL);
+        w->collect_lock = &w->group_lock;
+        for (int j = 0; j < i; j++)
+            if (src[j].group == src[i].group) {
+                w->collect_lock = &g_workers[j].group_lock;
+                break;
+            }
+        if (poc_spsc_init(&w->ring, cfg->ring_samples * 2) != 0 ||
+            !(w->buf = malloc(sizeof(uint64_t) * (size_t)cfg->chunk)))
+            return -1;
+        w->cap_words = w->ring.mask + 1;
+    }
+    g_n_workers = n;
+
+    int lfd = listen_on(cfg->socket_path);
+    if (lfd < 0) return -1;
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    for (int i = 0; i < n; i++)
+        g_workers[i].started =
+            pthread_create(&g_workers[i].thread, NULL, worker_main, &g_workers[i]) == 0;
+    fprintf(stderr, "harvesting %d collector%s on %s\n", n, n == 1 ? "" : "s",
+            cfg->socket_path);
+
+    while (!atomic_load(&g_stop)) {
+        struct pollfd p = {lfd, POLLIN, 0};
+        if (poll(&p, 1, 200) <= 0) continue;
+        int cfd = accept(lfd, NULL, NULL);
+        if (cfd < 0) continue;
+        if (!peer_is_us(cfd)) {
+            fprintf(stderr, "harvest: refused a client running as another user\n");
+            close(cfd);
+            continue;
+        }
+        pthread_t t;
+        if (pthread_create(&t, NULL, client_main, (void *)(intptr_t)cfd) == 0) pthread_detach(t);
+        else close(cfd);
+    }
+    close(lfd);
+    unlink(cfg->socket_path);
+
+    for (int i = 0; i < n; i++) {
+        Worker *w = &g_workers[i];
+        if (w->started) pthread_join(w->thread, NULL);
+        if (w->src->release) w->src->release();
+        fprintf(stderr, "%-24s produced %llu  delivered %llu  stalls %llu\n", w->src->name,
+                (unsigned long long)atomic_load(&w->produced),
+                (unsigned long long)atomic_load(&w->delivered),
+                (unsigned long long)atomic_load(&w->stalls));
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+// poc_harvest.h — Long-running collection served over a local socket
+//
+// poc_runner harvest keeps collectors running and hands their raw samples
+// to openentropy-server (`openentropy server --poc-harvest <socket>`),
+// which registers every collector as a pool source named "poc:<name>".
+// Each collector gets a worker thread that collects in chunks into its
+// own lock-free ring (lib/poc_spsc.h, a sample is two words). The server
+// pulls from the rings over a Unix stream socket only when its pool
+// collects. A worker whose ring has no room for the next chunk pauses
+// until the server has read some, so a full pool stops collection
+// instead of dropping samples. Sources that share collector state (the
+// same group) never collect at the same time: their workers take turns.
+//
+// The default socket lives in a per-user directory: $XDG_RUNTIME_DIR, else
+// the Darwin per-user temp dir (confstr(_CS_DARWIN_USER_TEMP_DIR)), else
+// /tmp/openentropy-poc-<uid>/, created 0700 and refused unless it is ours
+// and closed to others. The socket itself is 0600, and both ends check
+// that the peer runs as the same user (getpeereid / SO_PEERCRED), so no
+// other account can read the samples or pose as the daemon.
+//
+// Protocol: one request per line, replies in native byte order (both ends
+// are on the same machine).
+//
+//   LIST            "OK name name ...\n"
+//   READ name n     u32 count k <= n, then k u64 samples; waits up to
+//                   POC_HARVEST_READ_WAIT_MS for n to be buffered, then
+//                   sends what there is
+//   STATS           one "name produced delivered stalls buffered" line per
+//                   source, then ".\n"
+//
+// Anything else closes the connection.
+
+#ifndef POC_HARVEST_H
+#define POC_HARVEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "poc_stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_HARVEST_MAX_SOURCES  64
+#define POC_HARVEST_MAX_READ     (1 << 20)      // samples per READ
+#define POC_HARVEST_READ_WAIT_MS 200
+#define POC_HARVEST_SOCKET_NAME  "openentropy-poc.sock"
+
+typedef struct {
+    const char *name;
+    poc_collect_fn collect;
+    void (*release)(void);              // optional, called after the worker stops
+    int group;                          // sources with equal groups share state
+} PocHarvestSource;
+
+typedef struct {
+    const char *socket_path;
+    uint32_t ring_samples;              // per source, rounded up to a power of two
+    int chunk;                          // samples per collect call
+    double max_rate;                    // samples/s per source; 0 = as fast as read
+} PocHarvestConfig;
+
+// The default socket path (see above) into buf, creating the /tmp
+// fallback directory when needed. Returns 0, or -1 with errno set when no
+// private directory is available or the path does not fit.
+int poc_harvest_default_socket(char *buf, size_t len);
+
+// The default socket (NULL when poc_harvest_default_socket() fails), 1 Mi
+// samples per ring, 4096-sample chunks, no rate limit.
+void poc_harvest_defaults(PocHarvestConfig *cfg);
+
+// Serve until SIGINT or SIGTERM, then print per-source totals to stderr.
+// Returns 0, or -1 when the rings or the socket cannot be set up or two
+// sources have the same name.
+int poc_harvest_run(const PocHarvestSource *src, int n, const PocHarvestConfig *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_HARVEST_H
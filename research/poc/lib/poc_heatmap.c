@@ -0,0 +1,99 @@
+// poc_heatmap.c — Per-slice memory latency map: file format and slice picking
+
+#include "poc_heatmap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int poc_heatmap_save(const PocHeatmap *m, const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+    fprintf(f, "# poc_heatmap v1 slice_bytes=%zu slices=%d\n", m->slice_bytes, m->n);
+    fprintf(f, "# slice\toffset\tmean_ns\tp99_ns\tstddev_ns\th_inf\n");
+    for (int i = 0; i < m->n; i++) {
+        const PocHeatSlice *s = &m->slices[i];
+        fprintf(f, "%d\t%llu\t%.1f\t%.1f\t%.1f\t%.3f\n", i, (unsigned long long)s->offset,
+                s->mean_ns, s->p99_ns, s->stddev_ns, s->min_entropy);
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+int poc_heatmap_load(PocHeatmap *m, const char *path) {
+    memset(m, 0, sizeof(*m));
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+
+    char line[256];
+    size_t slice_bytes = 0;
+    int n = 0;
+    if (!fgets(line, sizeof(line), f) ||
+        sscanf(line, "# poc_heatmap v1 slice_bytes=%zu slices=%d", &slice_bytes, &n) != 2 ||
+        slice_bytes == 0 || n <= 0) {
+        fclose(f);
+        return -1;
+    }
+
+    m->slices = calloc((size_t)n, sizeof(PocHeatSlice));
+    if (!m->slices) {
+        fclose(f);
+        return -1;
+    }
+    int got = 0;
+    while (got < n && fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') continue;
+        PocHeatSlice *s = &m->slices[got];
+        unsigned long long off;
+        int idx;
+        if (sscanf(line, "%d %llu %lf %lf %lf %lf", &idx, &off, &s->mean_ns, &s->p99_ns,
+                   &s->stddev_ns, &s->min_entropy) != 6) break;
+        s->offset = off;
+        got++;
+    }
+    fclose(f);
+    if (got != n) {
+        poc_heatmap_free(m);
+        return -1;
+    }
+    m->slice_bytes = slice_bytes;
+    m->n = n;
+    return 0;
+}
+
+void poc_heatmap_free(PocHeatmap *m) {
+    free(m->slices);
+    memset(m, 0, sizeof(*m));
+}
+
+int poc_heatmap_top(const PocHeatmap *m, size_t bytes, int *idx, int k) {
+    int got = 0;
+    // Insertion into idx[0..got), kept sorted by stddev descending
+    for (int i = 0; i < m->n; i++) {
+        if (m->slices[i].offset + m->slice_bytes > bytes) continue;
+        int at = got < k ? got++ : k;
+        while (at > 0 && m->slices[idx[at - 1]].stddev_ns < m->slices[i].stddev_ns) {
+            if (at < k) idx[at] = idx[at - 1];
+            at--;
+        }
+        if (at < k) idx[at] = i;
+    }
+    return got;
+}
+
+int poc_heatmap_env_slices(size_t bytes, uint64_t *offsets, int k, size_t *slice_bytes) {
+    static PocHeatmap map;
+    static int loaded;   // 0 = not yet, 1 = usable, -1 = unset / failed
+    if (!loaded) {
+        const char *path = getenv("POC_HEATMAP");
+        loaded = path && *path && poc_heatmap_load(&map, path) == 0 ? 1 : -1;
+    }
+    if (loaded < 0 || k <= 0) return 0;
+
+    int *idx = malloc((size_t)k * sizeof(int));
+    if (!idx) return 0;
+    int got = poc_heatmap_top(&map, bytes, idx, k);
+    for (int i = 0; i < got; i++) offsets[i] = map.slices[idx[i]].offset;
+    free(idx);
+    if (slice_bytes) *slice_bytes = map.slice_bytes;
+    return got;
+}
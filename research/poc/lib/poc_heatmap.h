@@ -0,0 +1,64 @@
+// poc_heatmap.h — Per-slice memory latency map: file format and slice picking
+//
+// poc_numa_asymmetry --map probes a buffer in 2MB slices from several cores
+// at once and saves one row per slice: offset, mean and p99 latency,
+// standard deviation and XOR-fold H∞. The file is plain text:
+//
+//   # poc_heatmap v1 slice_bytes=2097152 slices=16
+//   # slice  offset  mean_ns  p99_ns  stddev_ns  h_inf
+//   0  0  112.4  291.7  48.2  3.914
+//   ...
+//
+// Memory-timing collectors read the file named by POC_HEATMAP through
+// poc_heatmap_env_slices() and confine their accesses to the noisiest
+// slices of their own buffer. Offsets are relative to the start of a
+// fresh anonymous mapping; the physical pages behind them differ from one
+// mapping to the next, so a map carries address-layout effects (SLC and
+// channel hashing on the low bits, superpage boundaries), not the exact
+// DRAM rows of the probed run.
+
+#ifndef POC_HEATMAP_H
+#define POC_HEATMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_HEATMAP_SLICE (2u * 1024 * 1024)
+
+typedef struct {
+    uint64_t offset;        // bytes from the start of the buffer
+    double mean_ns;
+    double p99_ns;
+    double stddev_ns;
+    double min_entropy;     // XOR-fold H∞ of the slice's raw ticks
+} PocHeatSlice;
+
+typedef struct {
+    size_t slice_bytes;
+    int n;
+    PocHeatSlice *slices;
+} PocHeatmap;
+
+// Write / read the text format above. 0, or -1 on I/O or parse failure.
+int poc_heatmap_save(const PocHeatmap *m, const char *path);
+int poc_heatmap_load(PocHeatmap *m, const char *path);
+void poc_heatmap_free(PocHeatmap *m);
+
+// Indices of up to k slices lying entirely inside [0, bytes), highest
+// stddev first. Returns how many were written to idx.
+int poc_heatmap_top(const PocHeatmap *m, size_t bytes, int *idx, int k);
+
+// Load $POC_HEATMAP (once per process) and write the offsets of its top k
+// slices inside a `bytes` buffer. Returns the count, 0 when the variable is
+// unset or the map is unusable; *slice_bytes gets the slice size.
+int poc_heatmap_env_slices(size_t bytes, uint64_t *offsets, int k, size_t *slice_bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_HEATMAP_H
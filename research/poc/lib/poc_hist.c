@@ -0,0 +1,70 @@
+// poc_hist.c — HDR-style log-linear histograms of uint64_t values
+
+#include "poc_hist.h"
+
+#include <string.h>
+
+void poc_hist_init(PocHist *h) {
+    memset(h, 0, sizeof(*h));
+    h->min = UINT64_MAX;
+}
+
+uint64_t poc_hist_bucket_lo(int i) {
+    int group = i >> POC_HIST_SUB_BITS, sub = i & (POC_HIST_SUB - 1);
+    if (group == 0) return (uint64_t)sub;
+    return (uint64_t)(POC_HIST_SUB + sub) << (group - 1);
+}
+
+uint64_t poc_hist_bucket_width(int i) {
+    int group = i >> POC_HIST_SUB_BITS;
+    return group == 0 ? 1 : 1ull << (group - 1);
+}
+
+uint64_t poc_hist_quantile(const PocHist *h, double q) {
+    if (h->count == 0) return 0;
+    if (q <= 0) return h->min;
+    uint64_t rank = (uint64_t)(q * (double)h->count + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > h->count) rank = h->count;
+    uint64_t seen = 0;
+    for (int i = 0; i < POC_HIST_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            uint64_t hi = poc_hist_bucket_lo(i) + (poc_hist_bucket_width(i) - 1);
+            return hi < h->max ? hi : h->max;
+        }
+    }
+    return h->max;
+}
+
+double poc_hist_mean(const PocHist *h) {
+    return h->count ? h->sum / (double)h->count : 0;
+}
+
+void poc_hist_merge(PocHist *dst, const PocHist *src) {
+    if (src->count == 0) return;
+    for (int i = 0; i < POC_HIST_BUCKETS; i++) dst->counts[i] += src->counts[i];
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+void poc_hist_write_json(FILE *f, const PocHist *h, double scale) {
+    static const double QS[] = {0.50, 0.90, 0.99, 0.999};
+    static const char *const QNAMES[] = {"p50", "p90", "p99", "p999"};
+    fprintf(f, "{\"count\": %llu, \"min\": %.3f, \"max\": %.3f, \"mean\": %.3f",
+            (unsigned long long)h->count, h->count ? (double)h->min * scale : 0,
+            (double)h->max * scale, poc_hist_mean(h) * scale);
+    for (int q = 0; q < 4; q++)
+        fprintf(f, ", \"%s\": %.3f", QNAMES[q], (double)poc_hist_quantile(h, QS[q]) * scale);
+    fprintf(f, ", \"buckets\": [");
+    int first = 1;
+    for (int i = 0; i < POC_HIST_BUCKETS; i++) {
+        if (!h->counts[i]) continue;
+        fprintf(f, "%s[%.3f, %llu]", first ? "" : ", ", (double)poc_hist_bucket_lo(i) * scale,
+                (unsigned long long)h->counts[i]);
+        first = 0;
+    }
+    fprintf(f, "]}");
+}
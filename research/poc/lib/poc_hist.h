@@ -0,0 +1,73 @@
+// poc_hist.h — HDR-style log-linear histograms of uint64_t values
+//
+// Values below 2^POC_HIST_SUB_BITS get a bucket each. Above that, every
+// power of two is split into 2^POC_HIST_SUB_BITS equal sub-buckets, so
+// a bucket is never wider than 1/32 of its lower bound (about 3%
+// relative error) across the whole uint64_t range. The counts are a
+// fixed array, so recording is one clz, a shift and an increment, with
+// no allocation or branch on the value's size. That is cheap enough to
+// time every collector call and to bin every sample.
+//
+// Quantiles report the highest value that the bucket could hold, capped
+// at the recorded max, as HdrHistogram does. The JSON form lists only
+// the nonempty buckets.
+
+#ifndef POC_HIST_H
+#define POC_HIST_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_HIST_SUB_BITS 5
+#define POC_HIST_SUB      (1 << POC_HIST_SUB_BITS)
+#define POC_HIST_BUCKETS  ((64 - POC_HIST_SUB_BITS + 1) * POC_HIST_SUB)
+
+typedef struct {
+    uint64_t count;
+    uint64_t min;               // UINT64_MAX while empty
+    uint64_t max;
+    double sum;
+    uint64_t counts[POC_HIST_BUCKETS];
+} PocHist;
+
+void poc_hist_init(PocHist *h);
+
+static inline int poc_hist_bucket(uint64_t v) {
+    if (v < POC_HIST_SUB) return (int)v;
+    int e = 63 - __builtin_clzll(v);
+    int shift = e - POC_HIST_SUB_BITS;
+    return ((shift + 1) << POC_HIST_SUB_BITS) + (int)((v >> shift) - POC_HIST_SUB);
+}
+
+static inline void poc_hist_record(PocHist *h, uint64_t v) {
+    h->counts[poc_hist_bucket(v)]++;
+    h->count++;
+    h->sum += (double)v;
+    if (v < h->min) h->min = v;
+    if (v > h->max) h->max = v;
+}
+
+// Smallest value in bucket i, and the bucket's width.
+uint64_t poc_hist_bucket_lo(int i);
+uint64_t poc_hist_bucket_width(int i);
+
+// q in [0, 1]; 0 when empty.
+uint64_t poc_hist_quantile(const PocHist *h, double q);
+double poc_hist_mean(const PocHist *h);
+
+void poc_hist_merge(PocHist *dst, const PocHist *src);
+
+// {"count", "min", "max", "mean", "p50", "p90", "p99", "p999",
+//  "buckets": [[lo, count], ...]} with every value multiplied by scale
+// (e.g. ns per tick).
+void poc_hist_write_json(FILE *f, const PocHist *h, double scale);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_HIST_H
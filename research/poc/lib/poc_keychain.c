@@ -0,0 +1,90 @@
+// poc_keychain.c — Reusable SecItem dictionaries for keychain timing PoCs
+
+#include "poc_keychain.h"
+
+#if defined(__APPLE__)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SECRET_LEN 16
+
+static CFMutableDictionaryRef new_dict(CFStringRef service) {
+    CFMutableDictionaryRef d = CFDictionaryCreateMutable(
+        NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+    if (d) {
+        CFDictionarySetValue(d, kSecClass, kSecClassGenericPassword);
+        CFDictionarySetValue(d, kSecAttrService, service);
+    }
+    return d;
+}
+
+int poc_kc_batch_init(PocKcBatch *b, const char *service, const char *prefix, int n,
+                      int return_data) {
+    memset(b, 0, sizeof(*b));
+    if (n < 1) return -1;
+    b->service = CFStringCreateWithCString(NULL, service, kCFStringEncodingUTF8);
+    b->accounts = calloc((size_t)n, sizeof(CFStringRef));
+    if (!b->service || !b->accounts) goto fail;
+    for (int i = 0; i < n; i++) {
+        char acct[128];
+        snprintf(acct, sizeof(acct), "%s-%d", prefix, i);
+        b->accounts[i] = CFStringCreateWithCString(NULL, acct, kCFStringEncodingUTF8);
+        if (!b->accounts[i]) goto fail;
+        b->n = i + 1;
+    }
+
+    b->secret = CFDataCreateMutable(NULL, SECRET_LEN);
+    b->attrs = new_dict(b->service);
+    b->query = new_dict(b->service);
+    b->sweep = new_dict(b->service);
+    if (!b->secret || !b->attrs || !b->query || !b->sweep) goto fail;
+    CFDataSetLength(b->secret, SECRET_LEN);
+    memset(CFDataGetMutableBytePtr(b->secret), 0x42, SECRET_LEN);
+
+    CFDictionarySetValue(b->attrs, kSecValueData, b->secret);
+    // AfterFirstUnlockThisDeviceOnly is the cheapest accessibility class
+    CFDictionarySetValue(b->attrs, kSecAttrAccessible,
+                         kSecAttrAccessibleAfterFirstUnlockThisDeviceOnly);
+    if (return_data) CFDictionarySetValue(b->query, kSecReturnData, kCFBooleanTrue);
+    poc_kc_select(b, 0);
+    return 0;
+
+fail:
+    poc_kc_batch_free(b);
+    return -1;
+}
+
+void poc_kc_batch_free(PocKcBatch *b) {
+    if (b->attrs) CFRelease(b->attrs);
+    if (b->query) CFRelease(b->query);
+    if (b->sweep) CFRelease(b->sweep);
+    if (b->secret) CFRelease(b->secret);
+    for (int i = 0; i < b->n; i++) CFRelease(b->accounts[i]);
+    free(b->accounts);
+    if (b->service) CFRelease(b->service);
+    memset(b, 0, sizeof(*b));
+}
+
+void poc_kc_select(PocKcBatch *b, int i) {
+    CFStringRef acct = b->accounts[i % b->n];
+    // The attrs dictionary retains the mutable data, so this edits the
+    // value the next SecItemAdd sends.
+    CFDataGetMutableBytePtr(b->secret)[0] = (uint8_t)i;
+    CFDictionarySetValue(b->attrs, kSecAttrAccount, acct);
+    CFDictionarySetValue(b->query, kSecAttrAccount, acct);
+}
+
+int poc_kc_delete_all(PocKcBatch *b) {
+    // SecItemDelete may remove only the first match on file-based
+    // keychains, so repeat until nothing is left (bounded by the batch).
+    for (int i = 0; i <= b->n; i++) {
+        OSStatus st = SecItemDelete(b->sweep);
+        if (st == errSecItemNotFound) return 0;
+        if (st != errSecSuccess) return -1;
+    }
+    return 0;
+}
+
+#endif // __APPLE__
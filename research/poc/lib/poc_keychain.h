@@ -0,0 +1,57 @@
+// poc_keychain.h — Reusable SecItem dictionaries for keychain timing PoCs
+//
+// Building fresh CFDictionary / CFString / CFData objects around every
+// SecItemAdd or SecItemCopyMatching puts CoreFoundation allocation in and
+// around the timed call. A PocKcBatch creates the add-attributes and query
+// dictionaries once, plus the account string of every item up front;
+// poc_kc_select() then only swaps the account value (and one secret byte,
+// in place) before the caller times the Security call. Items from a run
+// all share one service, so poc_kc_delete_all() removes them in a bulk
+// phase outside the measured loop.
+//
+// Items are generic passwords keyed by service + account (the primary key;
+// labels alone are not unique). macOS only; link -framework Security
+// -framework CoreFoundation.
+
+#ifndef POC_KEYCHAIN_H
+#define POC_KEYCHAIN_H
+
+#if defined(__APPLE__)
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <Security/Security.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    CFMutableDictionaryRef attrs;   // class, service, accessible, data, account
+    CFMutableDictionaryRef query;   // class, service, account (+ return data)
+    CFMutableDictionaryRef sweep;   // class, service: every item of this batch
+    CFMutableDataRef secret;
+    CFStringRef service;
+    CFStringRef *accounts;
+    int n;
+} PocKcBatch;
+
+// Prepare n accounts "<prefix>-0" .. "<prefix>-<n-1>" under service.
+// return_data sets kSecReturnData on the query. Returns 0 or -1.
+int poc_kc_batch_init(PocKcBatch *b, const char *service, const char *prefix, int n,
+                      int return_data);
+void poc_kc_batch_free(PocKcBatch *b);
+
+// Point attrs and query at account i; no allocation.
+void poc_kc_select(PocKcBatch *b, int i);
+
+// Delete every item under the batch's service, including orphans from an
+// earlier crashed run. Returns 0, or -1 if a delete fails.
+int poc_kc_delete_all(PocKcBatch *b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __APPLE__
+
+#endif // POC_KEYCHAIN_H
@@ -0,0 +1,236 @@
+// poc_load.c — Background load generator: memory, ALU, FPU/NEON, GPU, I/O
+
+#include "poc_load.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#define MEM_LINE      128             // Apple Silicon line size
+#define MEM_UNIT      (256u << 10)    // bytes swept per memory unit
+#define ALU_UNIT      4096
+#define FPU_UNIT      1024
+#define IO_BLOCK      (64u << 10)
+#define IO_SPAN       (16u << 20)     // file offsets cycle over this
+#define IO_FSYNC_EVERY 16
+
+const PocLoadProfile poc_load_profiles[] = {
+    {"idle", POC_LOAD_NONE, 0, 0},
+    {"mem", POC_LOAD_MEMORY, 0, 100},
+    {"mem-50", POC_LOAD_MEMORY, 0, 50},
+    {"alu", POC_LOAD_ALU, 0, 100},
+    {"alu-1", POC_LOAD_ALU, 1, 100},
+    {"fpu", POC_LOAD_FPU, 0, 100},
+    {"fpu-25", POC_LOAD_FPU, 0, 25},
+    {"gpu", POC_LOAD_GPU, 1, 100},
+    {"io", POC_LOAD_IO, 1, 100},
+};
+const int poc_n_load_profiles = (int)(sizeof(poc_load_profiles) / sizeof(poc_load_profiles[0]));
+
+static int (*g_gpu_burst)(void);
+
+void poc_load_set_gpu(int (*burst)(void)) {
+    g_gpu_burst = burst;
+}
+
+static const char *const KIND_NAMES[] = {"none", "mem", "alu", "fpu", "gpu", "io"};
+
+const char *poc_load_kind_name(PocLoadKind kind) {
+    return kind >= POC_LOAD_NONE && kind <= POC_LOAD_IO ? KIND_NAMES[kind] : "?";
+}
+
+int poc_load_parse(const char *spec, PocLoadProfile *out) {
+    for (int i = 0; i < poc_n_load_profiles; i++)
+        if (strcmp(poc_load_profiles[i].name, spec) == 0) {
+            *out = poc_load_profiles[i];
+            return 0;
+        }
+    size_t klen = strcspn(spec, ":");
+    for (int k = POC_LOAD_MEMORY; k <= POC_LOAD_IO; k++) {
+        if (strlen(KIND_NAMES[k]) != klen || strncmp(KIND_NAMES[k], spec, klen) != 0) continue;
+        PocLoadProfile p = {spec, (PocLoadKind)k, 0, 100};
+        if (spec[klen] == ':' && sscanf(spec + klen + 1, "%d:%d", &p.threads, &p.duty) < 1)
+            return -1;
+        if (p.threads < 0 || p.threads > POC_LOAD_MAX_THREADS || p.duty < 1 || p.duty > 100)
+            return -1;
+        *out = p;
+        return 0;
+    }
+    return -1;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// --- work units --------------------------------------------------------------
+
+typedef struct {
+    uint8_t *mem;
+    size_t cursor;
+    uint64_t rng;
+    int fd;
+    uint8_t *block;
+    uint64_t writes;
+#if defined(__aarch64__)
+    float64x2_t acc[8];
+#else
+    double acc[8];
+#endif
+} UnitState;
+
+static void unit_memory(UnitState *s, PocLoadWorker *w) {
+    uint8_t *p = s->mem + s->cursor;
+    for (size_t off = 0; off < MEM_UNIT; off += MEM_LINE) (*(volatile uint64_t *)(p + off))++;
+    s->cursor = (s->cursor + MEM_UNIT) % POC_LOAD_MEM_BYTES;
+    w->sink = *(volatile uint64_t *)p;
+}
+
+static void unit_alu(UnitState *s, PocLoadWorker *w) {
+    uint64_t x = s->rng;
+    for (int i = 0; i < ALU_UNIT; i++) x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    s->rng = x;
+    w->sink = x;
+}
+
+// acc = acc * 0.999 + 0.001 converges to 1: no overflow, no denormals.
+static void unit_fpu(UnitState *s, PocLoadWorker *w) {
+#if defined(__aarch64__)
+    const float64x2_t m = vdupq_n_f64(0.999), c = vdupq_n_f64(0.001);
+    for (int i = 0; i < FPU_UNIT; i++)
+        for (int k = 0; k < 8; k++) s->acc[k] = vfmaq_f64(c, s->acc[k], m);
+    w->sink = (uint64_t)(vgetq_lane_f64(s->acc[0], 0) * 1e6);
+#else
+    for (int i = 0; i < FPU_UNIT; i++)
+        for (int k = 0; k < 8; k++) s->acc[k] = s->acc[k] * 0.999 + 0.001;
+    w->sink = (uint64_t)(s->acc[0] * 1e6);
+#endif
+}
+
+static void unit_io(UnitState *s, PocLoadWorker *w) {
+    const uint64_t span = IO_SPAN / IO_BLOCK;
+    const uint64_t written = s->writes < span ? s->writes : span;
+    s->rng = s->rng * 6364136223846793005ULL + 1442695040888963407ULL;
+    off_t wr = (off_t)(s->writes % span) * IO_BLOCK;
+    off_t rd = (off_t)((s->rng >> 33) % (written ? written : 1)) * IO_BLOCK;
+    s->block[0] = (uint8_t)s->writes;
+    if (pwrite(s->fd, s->block, IO_BLOCK, wr) > 0) s->writes++;
+    if (s->writes % IO_FSYNC_EVERY == 0) fsync(s->fd);
+    if (pread(s->fd, s->block, IO_BLOCK, rd) > 0) w->sink = s->block[1];
+}
+
+static int unit_init(UnitState *s, PocLoadKind kind, int id) {
+    memset(s, 0, sizeof(*s));
+    s->fd = -1;
+    s->rng = now_ns() ^ ((uint64_t)(id + 1) * 0x9E3779B97F4A7C15ULL);
+    for (int k = 0; k < 8; k++)
+#if defined(__aarch64__)
+        s->acc[k] = vdupq_n_f64(0.5 + k * 0.01);
+#else
+        s->acc[k] = 0.5 + k * 0.01;
+#endif
+    if (kind == POC_LOAD_MEMORY) {
+        // Faulted in by the worker itself, so the pages are local to it
+        s->mem = malloc(POC_LOAD_MEM_BYTES);
+        if (!s->mem) return -1;
+        memset(s->mem, 1, POC_LOAD_MEM_BYTES);
+    } else if (kind == POC_LOAD_IO) {
+        const char *dir = getenv("TMPDIR");
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/poc_load.XXXXXX", dir && *dir ? dir : "/tmp");
+        s->fd = mkstemp(path);
+        if (s->fd < 0) return -1;
+        unlink(path);
+        s->block = malloc(IO_BLOCK);
+        if (!s->block) return -1;
+        memset(s->block, 0xA5, IO_BLOCK);
+    }
+    return 0;
+}
+
+static void unit_free(UnitState *s) {
+    free(s->mem);
+    free(s->block);
+    if (s->fd >= 0) close(s->fd);
+}
+
+// --- workers -------------------------------------------------------------------
+
+static void *load_worker(void *arg) {
+    PocLoadWorker *w = arg;
+    PocLoad *l = w->load;
+    const PocLoadKind kind = l->profile.kind;
+    UnitState s;
+    if (unit_init(&s, kind, w->id) != 0) {
+        unit_free(&s);
+        return NULL;
+    }
+    const uint64_t period = POC_LOAD_PERIOD_US * 1000ull;
+    const uint64_t busy = period * (uint64_t)l->profile.duty / 100;
+    uint64_t units = 0;
+    while (!atomic_load_explicit(&l->stop, memory_order_relaxed)) {
+        const uint64_t start = now_ns();
+        uint64_t t;
+        do {
+            switch (kind) {
+            case POC_LOAD_MEMORY: unit_memory(&s, w); break;
+            case POC_LOAD_ALU: unit_alu(&s, w); break;
+            case POC_LOAD_FPU: unit_fpu(&s, w); break;
+            case POC_LOAD_IO: unit_io(&s, w); break;
+            case POC_LOAD_GPU: g_gpu_burst(); break;
+            case POC_LOAD_NONE: break;
+            }
+            units++;
+            t = now_ns();
+        } while (t - start < busy && !atomic_load_explicit(&l->stop, memory_order_relaxed));
+        if (l->profile.duty < 100 && t - start < period) {
+            struct timespec rest = {0, (long)(period - (t - start))};
+            nanosleep(&rest, NULL);
+        }
+    }
+    atomic_fetch_add(&l->units, units);
+    unit_free(&s);
+    return NULL;
+}
+
+int poc_load_start(PocLoad *l, const PocLoadProfile *p) {
+    memset(l, 0, sizeof(*l));
+    l->profile = *p;
+    if (p->kind == POC_LOAD_NONE) return 0;
+    if (p->kind < POC_LOAD_NONE || p->kind > POC_LOAD_IO || p->duty < 1 || p->duty > 100 ||
+        p->threads < 0 || p->threads > POC_LOAD_MAX_THREADS)
+        return -1;
+    if (p->kind == POC_LOAD_GPU && !g_gpu_burst) return -1;
+
+    int threads = p->threads;
+    if (threads == 0) {
+        long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = p->kind == POC_LOAD_GPU || p->kind == POC_LOAD_IO ? 1
+                  : ncpu > 1 ? (int)(ncpu - 1) : 1;
+        if (threads > POC_LOAD_MAX_THREADS) threads = POC_LOAD_MAX_THREADS;
+    }
+    l->profile.threads = threads;
+    for (; l->n < threads; l->n++) {
+        l->workers[l->n] = (PocLoadWorker){l, l->n, 0};
+        if (pthread_create(&l->tids[l->n], NULL, load_worker, &l->workers[l->n]) != 0) {
+            poc_load_stop(l);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+uint64_t poc_load_stop(PocLoad *l) {
+    atomic_store(&l->stop, 1);
+    for (int i = 0; i < l->n; i++) pthread_join(l->tids[i], NULL);
+    l->n = 0;
+    return atomic_load(&l->units);
+}
@@ -0,0 +1,94 @@
+// poc_load.h — Background load generator: memory, ALU, FPU/NEON, GPU, I/O
+//
+// Production hosts are never idle, so a collector's rate and H∞ on a quiet
+// machine are a best case. A PocLoad runs `threads` workers of one kind.
+// Each worker is busy for duty% of every POC_LOAD_PERIOD_US period and
+// sleeps for the rest, until poc_load_stop().
+//
+//   memory  read-modify-write of one word per 128-byte line across a
+//           private POC_LOAD_MEM_BYTES buffer (DRAM bandwidth, past the SLC)
+//   alu     dependent 64-bit LCG multiply-add chain
+//   fpu     eight independent fused multiply-add chains (NEON on arm64)
+//   gpu     back-to-back compute dispatches through the hook set with
+//           poc_load_set_gpu() (Metal, collectors/gpu_load.m); without a
+//           hook the profile cannot start
+//   io      64 KiB pwrite + pread on an unlinked temp file, fsync every
+//           16 writes
+//
+// Several loads can run at once (one PocLoad each). Workers are not
+// placed: the scheduler spreads them as it would real background work.
+
+#ifndef POC_LOAD_H
+#define POC_LOAD_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_LOAD_MAX_THREADS 64
+#define POC_LOAD_PERIOD_US   1000
+#define POC_LOAD_MEM_BYTES   (32u << 20)    // per memory worker
+
+typedef enum {
+    POC_LOAD_NONE,
+    POC_LOAD_MEMORY,
+    POC_LOAD_ALU,
+    POC_LOAD_FPU,
+    POC_LOAD_GPU,
+    POC_LOAD_IO,
+} PocLoadKind;
+
+typedef struct {
+    const char *name;
+    PocLoadKind kind;
+    int threads;                // 0 = online CPUs - 1 (1 for gpu / io)
+    int duty;                   // percent of each period spent working, 1..100
+} PocLoadProfile;
+
+// idle, mem, mem-50, alu, alu-1, fpu, fpu-25, gpu, io
+extern const PocLoadProfile poc_load_profiles[];
+extern const int poc_n_load_profiles;
+
+// A profile name above, or kind[:threads[:duty]] ("mem:4:50"). The result
+// may point into `spec`'s storage for its name, so keep spec alive.
+// Returns 0, or -1 when spec names neither.
+int poc_load_parse(const char *spec, PocLoadProfile *out);
+
+const char *poc_load_kind_name(PocLoadKind kind);
+
+typedef struct PocLoad PocLoad;
+
+typedef struct {
+    PocLoad *load;
+    int id;
+    volatile uint64_t sink;     // keeps the work observable
+} PocLoadWorker;
+
+struct PocLoad {
+    PocLoadProfile profile;
+    int n;                      // workers running
+    atomic_int stop;
+    atomic_uint_fast64_t units; // work units finished, summed at stop
+    pthread_t tids[POC_LOAD_MAX_THREADS];
+    PocLoadWorker workers[POC_LOAD_MAX_THREADS];
+};
+
+// Start the workers. Returns 0 (immediately for POC_LOAD_NONE), or -1
+// on a bad profile, a gpu profile with no hook, or thread start failure.
+int poc_load_start(PocLoad *l, const PocLoadProfile *p);
+
+// Stop and join the workers. Returns the work units they finished.
+uint64_t poc_load_stop(PocLoad *l);
+
+// One GPU burst: submit work and wait for it; 0 on success.
+void poc_load_set_gpu(int (*burst)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_LOAD_H
@@ -0,0 +1,225 @@
+// poc_place.c — Thread placement: QoS class, affinity tag, observed cluster
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "poc_place.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/thread_policy.h>
+#include <pthread/qos.h>
+#include <sys/sysctl.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
+#define MAX_CPUS 1024       // Linux cluster map
+
+const PocPlacement poc_placements[] = {
+    {"inherit", POC_QOS_INHERIT, 0},
+    {"p", POC_QOS_USER_INTERACTIVE, 0},
+    {"e", POC_QOS_BACKGROUND, 0},
+    {"utility", POC_QOS_UTILITY, 0},
+    {"initiated", POC_QOS_USER_INITIATED, 0},
+    {"shared", POC_QOS_USER_INTERACTIVE, 1},
+};
+const int poc_n_placements = (int)(sizeof(poc_placements) / sizeof(poc_placements[0]));
+
+const PocPlacement *poc_placement_find(const char *name) {
+    for (int i = 0; i < poc_n_placements; i++)
+        if (strcmp(poc_placements[i].name, name) == 0) return &poc_placements[i];
+    return NULL;
+}
+
+const char *poc_qos_name(PocQos qos) {
+    switch (qos) {
+    case POC_QOS_INHERIT: return "inherit";
+    case POC_QOS_BACKGROUND: return "background";
+    case POC_QOS_UTILITY: return "utility";
+    case POC_QOS_DEFAULT: return "default";
+    case POC_QOS_USER_INITIATED: return "user-initiated";
+    case POC_QOS_USER_INTERACTIVE: return "user-interactive";
+    }
+    return "?";
+}
+
+const char *poc_cluster_name(PocCluster c) {
+    return c == POC_CLUSTER_P ? "P" : c == POC_CLUSTER_E ? "E" : "?";
+}
+
+int poc_place_apply(PocQos qos, int tag) {
+    int rc = 0;
+#if defined(__APPLE__)
+    static const qos_class_t classes[] = {
+        [POC_QOS_BACKGROUND] = QOS_CLASS_BACKGROUND,
+        [POC_QOS_UTILITY] = QOS_CLASS_UTILITY,
+        [POC_QOS_DEFAULT] = QOS_CLASS_DEFAULT,
+        [POC_QOS_USER_INITIATED] = QOS_CLASS_USER_INITIATED,
+        [POC_QOS_USER_INTERACTIVE] = QOS_CLASS_USER_INTERACTIVE,
+    };
+    if (tag > 0) {
+        thread_affinity_policy_data_t pol = {tag};
+        if (thread_policy_set(mach_thread_self(), THREAD_AFFINITY_POLICY,
+                              (thread_policy_t)&pol, THREAD_AFFINITY_POLICY_COUNT) != KERN_SUCCESS)
+            rc = -1;
+    }
+    if (qos != POC_QOS_INHERIT && pthread_set_qos_class_self_np(classes[qos], 0) != 0) rc = -1;
+#elif defined(__linux__)
+    (void)qos;
+    if (tag > 0) {
+        long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET((int)((tag - 1) % (ncpu > 0 ? ncpu : 1)), &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) rc = -1;
+    }
+#else
+    (void)qos;
+    (void)tag;
+#endif
+    return rc;
+}
+
+int poc_place_cpu(void) {
+#if defined(__APPLE__)
+    size_t cpu;
+    return pthread_cpu_number_np(&cpu) == 0 ? (int)cpu : -1;
+#elif defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+// --- cluster map, read once ------------------------------------------------
+
+static pthread_once_t g_map_once = PTHREAD_ONCE_INIT;
+#if defined(__APPLE__)
+static int g_e_below;                       // CPUs below this are E cores
+#elif defined(__linux__)
+static unsigned char g_is_e[MAX_CPUS];
+#endif
+
+static void map_init(void) {
+#if defined(__APPLE__)
+    int levels = 0, e = 0;
+    size_t len = sizeof(levels);
+    if (sysctlbyname("hw.nperflevels", &levels, &len, NULL, 0) != 0) levels = 1;
+    len = sizeof(e);
+    if (levels > 1 && sysctlbyname("hw.perflevel1.logicalcpu", &e, &len, NULL, 0) == 0)
+        g_e_below = e;
+#elif defined(__linux__)
+    static int cap[MAX_CPUS];
+    long conf = sysconf(_SC_NPROCESSORS_CONF);
+    int ncpu = conf > 0 && conf < MAX_CPUS ? (int)conf : MAX_CPUS, max = 0;
+    for (int c = 0; c < ncpu; c++) {
+        char path[96];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpu_capacity", c);
+        FILE *f = fopen(path, "r");
+        cap[c] = -1;
+        if (!f) continue;
+        if (fscanf(f, "%d", &cap[c]) != 1) cap[c] = -1;
+        fclose(f);
+        if (cap[c] > max) max = cap[c];
+    }
+    for (int c = 0; c < ncpu; c++) g_is_e[c] = cap[c] >= 0 && cap[c] < max;
+#endif
+}
+
+PocCluster poc_place_cluster(int cpu) {
+    if (cpu < 0) return POC_CLUSTER_UNKNOWN;
+    pthread_once(&g_map_once, map_init);
+#if defined(__APPLE__)
+    return cpu < g_e_below ? POC_CLUSTER_E : POC_CLUSTER_P;
+#elif defined(__linux__)
+    if (cpu >= MAX_CPUS) return POC_CLUSTER_UNKNOWN;
+    return g_is_e[cpu] ? POC_CLUSTER_E : POC_CLUSTER_P;
+#else
+    return POC_CLUSTER_P;
+#endif
+}
+
+// --- reports ---------------------------------------------------------------
+
+void poc_place_report_init(PocPlaceReport *r) {
+    memset(r, 0, sizeof(*r));
+    r->last_cpu = -1;
+}
+
+static void note_cpu(PocPlaceReport *r, int cpu, int moved) {
+    r->notes++;
+    switch (poc_place_cluster(cpu)) {
+    case POC_CLUSTER_P: r->on_p++; break;
+    case POC_CLUSTER_E: r->on_e++; break;
+    default: r->unknown++; break;
+    }
+    if (moved) r->migrations++;
+    r->last_cpu = cpu;
+}
+
+void poc_place_note_cpu(PocPlaceReport *r, int cpu) {
+    note_cpu(r, cpu, r->last_cpu >= 0 && cpu != r->last_cpu);
+}
+
+void poc_place_note(PocPlaceReport *r) {
+    poc_place_note_cpu(r, poc_place_cpu());
+}
+
+void poc_place_report_format(const PocPlaceReport *r, char *buf, int len) {
+    if (r->notes == 0) {
+        snprintf(buf, (size_t)len, "-");
+        return;
+    }
+    int n = snprintf(buf, (size_t)len, "P %.0f%% E %.0f%%", 100.0 * r->on_p / r->notes,
+                     100.0 * r->on_e / r->notes);
+    if (r->unknown && n > 0 && n < len)
+        n += snprintf(buf + n, (size_t)(len - n), " ? %.0f%%", 100.0 * r->unknown / r->notes);
+    if (n > 0 && n < len)
+        snprintf(buf + n, (size_t)(len - n), " (%u move%s)", r->migrations,
+                 r->migrations == 1 ? "" : "s");
+}
+
+// --- worker override -------------------------------------------------------
+
+static const PocPlacement *_Atomic g_override;
+static pthread_mutex_t g_workers_lock = PTHREAD_MUTEX_INITIALIZER;
+static PocPlaceReport g_workers = {.last_cpu = -1};
+static _Thread_local int t_start_cpu = -1;
+
+void poc_place_set_override(const PocPlacement *p) {
+    g_override = p;
+}
+
+void poc_place_worker(PocQos qos, int tag) {
+    const PocPlacement *o = g_override;
+    if (o) {
+        qos = o->qos;
+        if (o->tag) tag = o->tag;
+    }
+    poc_place_apply(qos, tag);
+    t_start_cpu = o ? poc_place_cpu() : -1;
+}
+
+// A worker counts one move when it finished on a different CPU than it
+// started on.
+void poc_place_worker_done(void) {
+    if (!g_override) return;
+    int cpu = poc_place_cpu();
+    pthread_mutex_lock(&g_workers_lock);
+    note_cpu(&g_workers, cpu, t_start_cpu >= 0 && cpu != t_start_cpu);
+    pthread_mutex_unlock(&g_workers_lock);
+}
+
+void poc_place_workers_take(PocPlaceReport *r) {
+    pthread_mutex_lock(&g_workers_lock);
+    *r = g_workers;
+    poc_place_report_init(&g_workers);
+    pthread_mutex_unlock(&g_workers_lock);
+}
@@ -0,0 +1,109 @@
+// poc_place.h — Thread placement: QoS class, affinity tag, observed cluster
+//
+// macOS cannot pin a thread to a core. Two hints steer it instead. The QoS
+// class picks the cluster: BACKGROUND keeps a thread on the E cores, and
+// USER_INTERACTIVE prefers the P cores. THREAD_AFFINITY_POLICY tags share
+// an L2 when equal and are spread apart when distinct. poc_place_apply()
+// sets both. On Linux a tag pins the thread to CPU (tag - 1) % ncpu
+// instead, and the QoS class is ignored.
+//
+// The scheduler may ignore the hints, so a placement is only half the
+// story. poc_place_note() records which CPU, and so which cluster, a
+// thread is on at the moment. Collectors place their workers through
+// poc_place_worker(). While poc_place_set_override() holds a placement
+// (poc_runner place), that placement wins over the worker's own
+// preference, and each worker notes its CPU into a process-wide report as
+// it finishes.
+//
+// Clusters: on macOS the E cores are numbered first (hw.perflevel1 is
+// the E level), on Linux cores with less than the largest cpu_capacity
+// count as E. Machines with one core type report every CPU as P.
+
+#ifndef POC_PLACE_H
+#define POC_PLACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    POC_QOS_INHERIT = 0,            // leave the thread's class alone
+    POC_QOS_BACKGROUND,
+    POC_QOS_UTILITY,
+    POC_QOS_DEFAULT,
+    POC_QOS_USER_INITIATED,
+    POC_QOS_USER_INTERACTIVE,
+} PocQos;
+
+typedef enum {
+    POC_CLUSTER_UNKNOWN = -1,
+    POC_CLUSTER_P,
+    POC_CLUSTER_E,
+} PocCluster;
+
+typedef struct {
+    const char *name;
+    PocQos qos;
+    int tag;                        // affinity tag; 0 = keep the thread's own
+} PocPlacement;
+
+// inherit, p, e, utility, initiated, shared (interactive, every thread on
+// tag 1). "inherit" comes first: a thread measured under it must not have
+// been placed yet.
+extern const PocPlacement poc_placements[];
+extern const int poc_n_placements;
+
+// NULL when no placement has that name.
+const PocPlacement *poc_placement_find(const char *name);
+
+const char *poc_qos_name(PocQos qos);
+const char *poc_cluster_name(PocCluster c);
+
+// Set the calling thread's QoS class (unless INHERIT) and affinity tag
+// (unless 0). Returns 0, or -1 when the system refused either.
+int poc_place_apply(PocQos qos, int tag);
+
+// poc_place_apply() for a collector's worker thread: qos / tag are what
+// the worker wants, replaced by the override's (its tag only when nonzero)
+// while one is set.
+void poc_place_worker(PocQos qos, int tag);
+
+// Call as a worker finishes: notes its CPU into the worker report when an
+// override is set, otherwise does nothing.
+void poc_place_worker_done(void);
+
+// NULL clears it. The placement must outlive the override.
+void poc_place_set_override(const PocPlacement *p);
+
+// CPU the calling thread is on now, or -1 when the system does not say.
+int poc_place_cpu(void);
+PocCluster poc_place_cluster(int cpu);
+
+typedef struct {
+    uint32_t notes;
+    uint32_t on_p;
+    uint32_t on_e;
+    uint32_t unknown;
+    uint32_t migrations;            // notes on a different CPU than the last
+    int last_cpu;                   // -1 before the first note
+} PocPlaceReport;
+
+void poc_place_report_init(PocPlaceReport *r);
+void poc_place_note(PocPlaceReport *r);
+
+// Note a CPU poc_place_cpu() returned earlier, e.g. in a thread since joined.
+void poc_place_note_cpu(PocPlaceReport *r, int cpu);
+
+// Copy the worker report into *r and clear it.
+void poc_place_workers_take(PocPlaceReport *r);
+
+// "P 97% E 3% (2 moves)", or "-" when nothing was noted.
+void poc_place_report_format(const PocPlaceReport *r, char *buf, int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_PLACE_H
@@ -0,0 +1,183 @@
+// poc_platform.c — Linux clocks behind mach_absolute_time()
+
+#include "poc_platform.h"
+
+#if !defined(__APPLE__)
+
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+enum { PC_MONOTONIC, PC_TSC, PC_CNTVCT, PC_PERF, PC_N_CLOCKS };
+
+static const char *const clock_names[PC_N_CLOCKS] = {"monotonic", "tsc", "cntvct", "perf"};
+
+#define CALIBRATE_NS 20000000ull   // 20 ms against CLOCK_MONOTONIC_RAW
+
+static atomic_int g_clock = -1;   // PC_*, -1 until the first call
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static mach_timebase_info_data_t g_tb = {1, 1};
+
+// perf: one counter fd per thread, closed when the thread exits.
+static pthread_key_t g_perf_key;
+static __thread int t_perf_fd = -1;
+
+static inline uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t read_tsc(void) {
+#if defined(__x86_64__)
+    uint32_t lo, hi, aux;
+    __asm__ volatile("rdtscp" : "=a"(lo), "=d"(hi), "=c"(aux) : : "memory");
+    return ((uint64_t)hi << 32) | lo;
+#else
+    return 0;
+#endif
+}
+
+static inline uint64_t read_cntvct(void) {
+#if defined(__aarch64__)
+    uint64_t v;
+    __asm__ volatile("isb\nmrs %0, CNTVCT_EL0" : "=r"(v) : : "memory");
+    return v;
+#else
+    return 0;
+#endif
+}
+
+static int perf_open(void) {
+    struct perf_event_attr a;
+    memset(&a, 0, sizeof(a));
+    a.type = PERF_TYPE_HARDWARE;
+    a.size = sizeof(a);
+    a.config = PERF_COUNT_HW_CPU_CYCLES;
+    a.exclude_hv = 1;
+    // Count kernel cycles too (the collectors time syscalls) unless
+    // perf_event_paranoid only allows user space.
+    for (int user_only = 0; user_only < 2; user_only++) {
+        a.exclude_kernel = (unsigned)user_only;
+        int fd = (int)syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+        if (fd >= 0) return fd;
+    }
+    return -1;
+}
+
+static void perf_close(void *p) { close((int)(intptr_t)p - 1); }
+
+static uint64_t read_perf(void) {
+    if (t_perf_fd < 0) {
+        t_perf_fd = perf_open();
+        if (t_perf_fd < 0) return 0;
+        pthread_setspecific(g_perf_key, (void *)(intptr_t)(t_perf_fd + 1));
+    }
+    uint64_t v = 0;
+    if (read(t_perf_fd, &v, sizeof(v)) != (ssize_t)sizeof(v)) return 0;
+    return v;
+}
+
+// Timebase of a counter from a spin against CLOCK_MONOTONIC_RAW. 0, or -1
+// when the counter does not advance.
+static int calibrate(uint64_t (*read_counter)(void)) {
+    uint64_t n0 = mono_ns(), c0 = read_counter();
+    while (mono_ns() - n0 < CALIBRATE_NS) {}
+    uint64_t n1 = mono_ns(), c1 = read_counter();
+    if (c1 <= c0) return -1;
+    uint64_t ns = n1 - n0, ticks = c1 - c0;
+    while (ns > UINT32_MAX || ticks > UINT32_MAX) {
+        ns >>= 1;
+        ticks >>= 1;
+    }
+    g_tb.numer = (uint32_t)ns;
+    g_tb.denom = (uint32_t)ticks;
+    return 0;
+}
+
+static int open_clock(int c) {
+    switch (c) {
+    case PC_TSC: {
+#if defined(__x86_64__)
+        unsigned a, b, cx, d;
+        if (!__get_cpuid(0x80000007, &a, &b, &cx, &d) || !(d & (1u << 8)))
+            fprintf(stderr, "POC_LINUX_CLOCK=tsc: TSC is not invariant on this CPU\n");
+        return calibrate(read_tsc);
+#else
+        return -1;
+#endif
+    }
+    case PC_CNTVCT: {
+#if defined(__aarch64__)
+        uint64_t freq;
+        __asm__ volatile("mrs %0, CNTFRQ_EL0" : "=r"(freq));
+        if (freq == 0 || freq > UINT32_MAX) return -1;
+        g_tb.numer = 1000000000u;
+        g_tb.denom = (uint32_t)freq;
+        return 0;
+#else
+        return -1;
+#endif
+    }
+    case PC_PERF:
+        if (pthread_key_create(&g_perf_key, perf_close) != 0) return -1;
+        return read_perf() ? calibrate(read_perf) : -1;
+    default:
+        return 0;
+    }
+}
+
+static void init_clock(void) {
+    const char *want = getenv("POC_LINUX_CLOCK");
+    int c = PC_MONOTONIC;
+    if (want && *want) {
+        for (c = 0; c < PC_N_CLOCKS && strcmp(want, clock_names[c]) != 0; c++) {}
+        if (c == PC_N_CLOCKS) {
+            fprintf(stderr, "POC_LINUX_CLOCK=%s: unknown clock, using monotonic\n", want);
+            c = PC_MONOTONIC;
+        }
+    }
+    if (open_clock(c) != 0) {
+        fprintf(stderr, "POC_LINUX_CLOCK=%s: not available here, using monotonic\n", want);
+        c = PC_MONOTONIC;
+        g_tb.numer = g_tb.denom = 1;
+    }
+    atomic_store_explicit(&g_clock, c, memory_order_release);
+}
+
+static inline int clock_in_use(void) {
+    int c = atomic_load_explicit(&g_clock, memory_order_acquire);
+    if (c >= 0) return c;
+    pthread_once(&g_once, init_clock);
+    return atomic_load_explicit(&g_clock, memory_order_acquire);
+}
+
+uint64_t mach_absolute_time(void) {
+    switch (clock_in_use()) {
+    case PC_TSC:    return read_tsc();
+    case PC_CNTVCT: return read_cntvct();
+    case PC_PERF:   return read_perf();
+    default:        return mono_ns();
+    }
+}
+
+int mach_timebase_info(mach_timebase_info_data_t *info) {
+    clock_in_use();
+    *info = g_tb;
+    return 0;
+}
+
+const char *poc_platform_clock(void) { return clock_names[clock_in_use()]; }
+
+#endif // !__APPLE__
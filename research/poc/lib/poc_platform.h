@@ -0,0 +1,59 @@
+// poc_platform.h — mach_absolute_time() and mach_timebase_info() off macOS
+//
+// The portable collectors (page fault, TLB, CAS, pipe, thread lifecycle)
+// and the fsync / NVMe PoCs time everything in mach_absolute_time() ticks
+// and convert with mach_timebase_info(). Include this instead of
+// <mach/mach_time.h>: on macOS it is that header, on Linux it supplies
+// both calls over the clock named by POC_LINUX_CLOCK, read once at the
+// first call:
+//
+//   monotonic  clock_gettime(CLOCK_MONOTONIC_RAW) in ns (vDSO; default)
+//   tsc        rdtscp on x86-64 (ordered after earlier instructions);
+//              timebase calibrated against CLOCK_MONOTONIC_RAW, so use it
+//              only where the TSC is invariant
+//   cntvct     isb; mrs CNTVCT_EL0 on arm64; timebase from CNTFRQ_EL0
+//   perf       this thread's CPU cycles, perf_event_open(2) + read(2) — a
+//              syscall per read, counts only while the thread runs, and the
+//              timebase is the nominal cycles/ns at calibration: compare
+//              durations taken on one thread only
+//
+// A clock that cannot be opened falls back to monotonic with a note on
+// stderr; poc_platform_clock() names the one in use.
+
+#ifndef POC_PLATFORM_H
+#define POC_PLATFORM_H
+
+#if defined(__APPLE__)
+
+#include <mach/mach_time.h>
+
+static inline const char *poc_platform_clock(void) { return "mach_absolute_time"; }
+
+#else
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t numer;
+    uint32_t denom;
+} mach_timebase_info_data_t;
+
+uint64_t mach_absolute_time(void);
+
+// ns per tick = numer / denom. Returns 0.
+int mach_timebase_info(mach_timebase_info_data_t *info);
+
+// "monotonic", "tsc", "cntvct" or "perf".
+const char *poc_platform_clock(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __APPLE__
+
+#endif // POC_PLATFORM_H
@@ -0,0 +1,149 @@
+// poc_qdread.c — Queue-depth-controlled concurrent block reads
+
+#include "poc_qdread.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "poc_platform.h"
+#include "poc_uring.h"
+
+static inline uint64_t qd_now(void) { return mach_absolute_time(); }
+
+typedef struct {
+    int fd;
+    size_t block;
+    uint64_t n_blocks;
+    int total;
+    PocQdCompletion *out;
+    _Atomic int issued;      // reads claimed by workers
+    _Atomic int completed;   // next slot in out[]
+    _Atomic int ok;
+} QdRun;
+
+typedef struct {
+    QdRun *run;
+    uint64_t rng;
+    void *buf;
+} QdWorker;
+
+static uint64_t splitmix64(uint64_t *s) {
+    uint64_t z = (*s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static int cmp_done(const void *a, const void *b) {
+    uint64_t x = ((const PocQdCompletion *)a)->done, y = ((const PocQdCompletion *)b)->done;
+    return (x > y) - (x < y);
+}
+
+static void *qd_worker(void *arg) {
+    QdWorker *w = arg;
+    QdRun *r = w->run;
+    while (atomic_fetch_add_explicit(&r->issued, 1, memory_order_relaxed) < r->total) {
+        off_t off = (off_t)(splitmix64(&w->rng) % r->n_blocks) * (off_t)r->block;
+        uint64_t t0 = qd_now();
+        ssize_t got = pread(r->fd, w->buf, r->block, off);
+        uint64_t t1 = qd_now();
+
+        int slot = atomic_fetch_add_explicit(&r->completed, 1, memory_order_relaxed);
+        r->out[slot] = (PocQdCompletion){t1, t1 - t0, off};
+        if (got == (ssize_t)r->block) atomic_fetch_add_explicit(&r->ok, 1, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+int poc_qd_run(int fd, off_t span, size_t block, int depth, uint64_t seed,
+               PocQdCompletion *out, int total) {
+    if (depth < 1 || depth > POC_QD_MAX_DEPTH || block == 0 || span < (off_t)block) return -1;
+
+    QdRun run = {
+        .fd = fd,
+        .block = block,
+        .n_blocks = (uint64_t)(span / (off_t)block),
+        .total = total,
+        .out = out,
+    };
+    atomic_init(&run.issued, 0);
+    atomic_init(&run.completed, 0);
+    atomic_init(&run.ok, 0);
+
+    QdWorker workers[POC_QD_MAX_DEPTH];
+    pthread_t threads[POC_QD_MAX_DEPTH];
+    int started = 0;
+    for (int i = 0; i < depth; i++) {
+        workers[i].run = &run;
+        workers[i].rng = seed ^ ((uint64_t)(i + 1) << 32);
+        // Aligned buffers so F_NOCACHE / O_DIRECT reads stay direct.
+        if (posix_memalign(&workers[i].buf, block < 4096 ? 4096 : block, block) != 0) break;
+        if (pthread_create(&threads[i], NULL, qd_worker, &workers[i]) != 0) {
+            free(workers[i].buf);
+            break;
+        }
+        started++;
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+        free(workers[i].buf);
+    }
+    if (started < depth) return -1;
+    // Slots are claimed just after each pread returns, so neighbours can be
+    // out of order by a few ticks; put them back in completion order.
+    qsort(out, (size_t)total, sizeof(*out), cmp_done);
+    return atomic_load(&run.ok);
+}
+
+int poc_qd_uring_run(int fd, off_t span, size_t block, int depth, uint64_t seed,
+                     PocQdCompletion *out, int total) {
+    if (depth < 1 || depth > POC_QD_MAX_DEPTH || block == 0 || span < (off_t)block) return -1;
+    PocUring *u = poc_uring_open((unsigned)depth);
+    if (!u) return -1;
+    // One aligned buffer per slot so F_NOCACHE / O_DIRECT reads stay direct.
+    size_t stride = (block + 4095) & ~(size_t)4095;
+    void *bufs = NULL;
+    if (posix_memalign(&bufs, 4096, stride * (size_t)depth) != 0) {
+        poc_uring_close(u);
+        return -1;
+    }
+
+    const uint64_t n_blocks = (uint64_t)(span / (off_t)block);
+    uint64_t rng = seed;
+    uint64_t queued_at[POC_QD_MAX_DEPTH];
+    off_t offs[POC_QD_MAX_DEPTH];
+    PocUringCqe cqes[POC_QD_MAX_DEPTH];
+    int issued = 0, done = 0, ok = 0, failed = 0;
+
+    for (int s = 0; s < depth && issued < total; s++, issued++) {
+        offs[s] = (off_t)(splitmix64(&rng) % n_blocks) * (off_t)block;
+        queued_at[s] = qd_now();
+        poc_uring_read(u, fd, (char *)bufs + (size_t)s * stride, block, offs[s], (uint64_t)s);
+    }
+    while (done < issued) {
+        // Refills queued since the last pass go down with this one wait.
+        if (poc_uring_submit(u, 1) < 0) {
+            failed = 1;
+            break;
+        }
+        uint64_t now = qd_now();
+        int k = poc_uring_reap(u, cqes, depth);
+        for (int c = 0; c < k; c++) {
+            int s = (int)cqes[c].user_data;
+            out[done++] = (PocQdCompletion){now, now - queued_at[s], offs[s]};
+            ok += cqes[c].res == (int32_t)block;
+            if (issued < total) {
+                offs[s] = (off_t)(splitmix64(&rng) % n_blocks) * (off_t)block;
+                queued_at[s] = now;
+                poc_uring_read(u, fd, (char *)bufs + (size_t)s * stride, block, offs[s],
+                               (uint64_t)s);
+                issued++;
+            }
+        }
+    }
+    poc_uring_close(u);
+    free(bufs);
+    return failed ? -1 : ok;
+}
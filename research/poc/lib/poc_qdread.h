@@ -0,0 +1,50 @@
+// poc_qdread.h — Queue-depth-controlled concurrent block reads
+//
+// A synchronous read() loop only ever presents one outstanding command to
+// the storage controller. poc_qd_run() keeps `depth` aligned random-offset
+// preads in flight from a pool of `depth` threads (one blocking pread each,
+// closed loop), and timestamps every completion, so a QD sweep shows how
+// NAND/controller latency noise behaves as the device queue fills.
+//
+// Times are mach_absolute_time() ticks (lib/poc_platform.h off macOS).
+// The caller opens fd (F_NOCACHE / O_DIRECT as appropriate).
+
+#ifndef POC_QDREAD_H
+#define POC_QDREAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_QD_MAX_DEPTH 64
+
+typedef struct {
+    uint64_t done;      // clock at completion
+    uint64_t latency;   // pread call duration
+    off_t offset;
+} PocQdCompletion;
+
+// Issue `total` reads of `block` bytes at block-aligned offsets drawn
+// uniformly from [0, span), `depth` at a time. out[] receives the
+// completions in the order they finished. Returns the number of successful
+// reads, or -1 if depth is out of range or the pool cannot start.
+int poc_qd_run(int fd, off_t span, size_t block, int depth, uint64_t seed,
+               PocQdCompletion *out, int total);
+
+// The same closed loop from one thread over io_uring (lib/poc_uring.h,
+// Linux): `depth` reads stay in flight and each pass resubmits every slot
+// that completed in one io_uring_enter(2). Completions reaped together
+// share one `done` stamp; latency runs from queueing to reaping. -1 where
+// io_uring is unavailable.
+int poc_qd_uring_run(int fd, off_t span, size_t block, int depth, uint64_t seed,
+                     PocQdCompletion *out, int total);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_QDREAD_H
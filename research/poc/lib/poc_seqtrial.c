@@ -0,0 +1,64 @@
+// poc_seqtrial.c — Sequential stopping for the H∞ stability trials
+
+#include "poc_seqtrial.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define Z_975 1.959963985
+
+void poc_seq_add(PocSeqTrials *s, double x) {
+    s->n++;
+    double d = x - s->mean;
+    s->mean += d / s->n;
+    s->m2 += d * (x - s->mean);
+}
+
+double poc_seq_std(const PocSeqTrials *s) {
+    return s->n > 1 ? sqrt(s->m2 / (s->n - 1)) : 0;
+}
+
+// Wilson–Hilferty: chi-square quantile for `df` degrees of freedom at the
+// normal quantile z.
+static double chi2_quantile(double df, double z) {
+    double a = 2.0 / (9.0 * df);
+    double c = 1.0 - a + z * sqrt(a);
+    return c > 0 ? df * c * c * c : 0;
+}
+
+void poc_seq_std_ci(const PocSeqTrials *s, double *lo, double *hi) {
+    if (s->n < 2) {
+        *lo = 0;
+        *hi = INFINITY;
+        return;
+    }
+    double df = s->n - 1;
+    double q_hi = chi2_quantile(df, Z_975), q_lo = chi2_quantile(df, -Z_975);
+    *lo = sqrt(s->m2 / q_hi);
+    *hi = q_lo > 0 ? sqrt(s->m2 / q_lo) : INFINITY;
+}
+
+int poc_seq_settled(const PocSeqTrials *s, const double *thresholds, int n_thresholds) {
+    if (s->n < POC_SEQ_MIN_TRIALS) return 0;
+    double lo, hi;
+    poc_seq_std_ci(s, &lo, &hi);
+    for (int i = 0; i < n_thresholds; i++)
+        if (lo <= thresholds[i] && thresholds[i] <= hi) return 0;
+    return 1;
+}
+
+int poc_seq_env_max(void) {
+    const char *v = getenv("POC_SEQUENTIAL");
+    if (!v || !*v) return 0;
+    int n = atoi(v);
+    if (n <= 0) return 0;
+    if (n > POC_SEQ_MIN_TRIALS) return n;
+    if (n > 1) {
+        static int warned;
+        if (!warned++)
+            fprintf(stderr, "POC_SEQUENTIAL=%d: a cap must exceed %d trials; using %d\n", n,
+                    POC_SEQ_MIN_TRIALS, POC_SEQ_MAX_TRIALS);
+    }
+    return POC_SEQ_MAX_TRIALS;
+}
@@ -0,0 +1,56 @@
+// poc_seqtrial.h — Sequential stopping for the H∞ stability trials
+//
+// The Test 3 verdict bands the sample (n - 1) stddev of per-trial H∞ at 1.0
+// (MARGINAL) and 2.0 (UNSTABLE). Instead of a fixed N_TRIALS, a sequential
+// run folds each trial into a Welford accumulator and puts a 95% chi-square
+// interval on σ (Wilson–Hilferty quantiles). Once the interval lies
+// entirely inside one band the verdict cannot change and the run stops;
+// while it straddles a threshold, trials continue past N_TRIALS up to a cap.
+// The interval and the verdict both use the n - 1 estimate, which always
+// lies inside the interval, so a settled run cannot report another band.
+// The stop rule only fits verdicts on this σ: a program that judges by
+// some other statistic must not stop early on it.
+//
+// POC_SEQUENTIAL=1 enables it with a cap of POC_SEQ_MAX_TRIALS; a number
+// above POC_SEQ_MIN_TRIALS sets the cap itself. 2..POC_SEQ_MIN_TRIALS
+// cannot make a cap (the rule never stops before POC_SEQ_MIN_TRIALS) and are
+// rejected with a warning, falling back to POC_SEQ_MAX_TRIALS.
+
+#ifndef POC_SEQTRIAL_H
+#define POC_SEQTRIAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_SEQ_MIN_TRIALS 4
+#define POC_SEQ_MAX_TRIALS 40
+
+typedef struct {
+    int n;
+    double mean;
+    double m2;      // Σ (x - mean)²
+} PocSeqTrials;
+
+void poc_seq_add(PocSeqTrials *s, double x);
+
+// Sample stddev (n - 1), the statistic every Test 3 verdict bands; 0 with
+// fewer than two trials.
+double poc_seq_std(const PocSeqTrials *s);
+
+// 95% interval on σ from the n - 1 degree-of-freedom sample variance.
+// [0, +inf) with fewer than two trials.
+void poc_seq_std_ci(const PocSeqTrials *s, double *lo, double *hi);
+
+// 1 when [lo, hi] does not contain any of the thresholds and at least
+// POC_SEQ_MIN_TRIALS are in.
+int poc_seq_settled(const PocSeqTrials *s, const double *thresholds, int n_thresholds);
+
+// Trial cap from POC_SEQUENTIAL; 0 when sequential mode is off.
+int poc_seq_env_max(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_SEQTRIAL_H
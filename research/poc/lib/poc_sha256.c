@@ -0,0 +1,163 @@
+// poc_sha256.c — SHA-256 on the ARMv8 SHA-2 instructions
+
+#include "poc_sha256.h"
+
+#include <string.h>
+
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#define POC_SHA256_HW 1
+#include <arm_neon.h>
+#else
+#define POC_SHA256_HW 0
+#endif
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+    0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+    0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+    0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2,
+};
+
+static const uint32_t H0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+int poc_sha256_hardware(void) { return POC_SHA256_HW; }
+
+#if POC_SHA256_HW
+
+// Four rounds per SHA256H/SHA256H2 pair; the schedule for the next 16
+// words is extended four at a time with SU0/SU1 while the rounds run.
+void poc_sha256_blocks(uint32_t state[8], const uint8_t *p, size_t n_blocks) {
+    uint32x4_t abcd = vld1q_u32(state), efgh = vld1q_u32(state + 4);
+    while (n_blocks--) {
+        const uint32x4_t abcd0 = abcd, efgh0 = efgh;
+        uint32x4_t m0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p)));
+        uint32x4_t m1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p + 16)));
+        uint32x4_t m2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p + 32)));
+        uint32x4_t m3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p + 48)));
+        for (int i = 0; i < 16; i++) {
+            uint32x4_t wk = vaddq_u32(m0, vld1q_u32(K + 4 * i));
+            uint32x4_t prev = abcd;
+            abcd = vsha256hq_u32(abcd, efgh, wk);
+            efgh = vsha256h2q_u32(efgh, prev, wk);
+            uint32x4_t next = i < 12 ? vsha256su1q_u32(vsha256su0q_u32(m0, m1), m2, m3) : m0;
+            m0 = m1;
+            m1 = m2;
+            m2 = m3;
+            m3 = next;
+        }
+        abcd = vaddq_u32(abcd, abcd0);
+        efgh = vaddq_u32(efgh, efgh0);
+        p += 64;
+    }
+    vst1q_u32(state, abcd);
+    vst1q_u32(state + 4, efgh);
+}
+
+#else
+
+#define ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+void poc_sha256_blocks(uint32_t state[8], const uint8_t *p, size_t n_blocks) {
+    while (n_blocks--) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++)
+            w[i] = (uint32_t)p[4 * i] << 24 | (uint32_t)p[4 * i + 1] << 16 |
+                   (uint32_t)p[4 * i + 2] << 8 | p[4 * i + 3];
+        for (int i = 16; i < 64; i++) {
+            uint32_t s0 = ROR(w[i - 15], 7) ^ ROR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = ROR(w[i - 2], 17) ^ ROR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; i++) {
+            uint32_t t1 = h + (ROR(e, 6) ^ ROR(e, 11) ^ ROR(e, 25)) + ((e & f) ^ (~e & g)) +
+                          K[i] + w[i];
+            uint32_t t2 = (ROR(a, 2) ^ ROR(a, 13) ^ ROR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+        p += 64;
+    }
+}
+
+#endif
+
+void poc_sha256_init(PocSha256 *h) {
+    memcpy(h->state, H0, sizeof(H0));
+    h->total = 0;
+    h->n_buf = 0;
+}
+
+void poc_sha256_update(PocSha256 *h, const void *data, size_t len) {
+    const uint8_t *p = data;
+    if (len == 0) return;
+    h->total += len;
+    if (h->n_buf) {
+        size_t take = 64 - h->n_buf < len ? 64 - h->n_buf : len;
+        memcpy(h->buf + h->n_buf, p, take);
+        h->n_buf += take;
+        p += take;
+        len -= take;
+        if (h->n_buf < 64) return;
+        poc_sha256_blocks(h->state, h->buf, 1);
+        h->n_buf = 0;
+    }
+    // Whole blocks straight from the caller's buffer
+    if (len >= 64) {
+        poc_sha256_blocks(h->state, p, len / 64);
+        p += len & ~(size_t)63;
+        len &= 63;
+    }
+    memcpy(h->buf, p, len);
+    h->n_buf = len;
+}
+
+void poc_sha256_final(PocSha256 *h, uint8_t out[32]) {
+    uint64_t bits = h->total * 8;
+    h->buf[h->n_buf++] = 0x80;
+    if (h->n_buf > 56) {
+        memset(h->buf + h->n_buf, 0, 64 - h->n_buf);
+        poc_sha256_blocks(h->state, h->buf, 1);
+        h->n_buf = 0;
+    }
+    memset(h->buf + h->n_buf, 0, 56 - h->n_buf);
+    for (int i = 0; i < 8; i++) h->buf[56 + i] = (uint8_t)(bits >> (56 - 8 * i));
+    poc_sha256_blocks(h->state, h->buf, 1);
+    for (int i = 0; i < 8; i++) {
+        out[4 * i] = (uint8_t)(h->state[i] >> 24);
+        out[4 * i + 1] = (uint8_t)(h->state[i] >> 16);
+        out[4 * i + 2] = (uint8_t)(h->state[i] >> 8);
+        out[4 * i + 3] = (uint8_t)h->state[i];
+    }
+}
+
+void poc_sha256_parts(const PocSha256Part *parts, int n, uint8_t out[32]) {
+    PocSha256 h;
+    poc_sha256_init(&h);
+    for (int i = 0; i < n; i++) poc_sha256_update(&h, parts[i].data, parts[i].len);
+    poc_sha256_final(&h, out);
+}
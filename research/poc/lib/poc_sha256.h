@@ -0,0 +1,48 @@
+// poc_sha256.h — SHA-256 on the ARMv8 SHA-2 instructions
+//
+// One compression kernel with two bodies: SHA256H / SHA256H2 / SHA256SU0 /
+// SHA256SU1 where the compiler targets the ARMv8 SHA-2 extension (every
+// Apple Silicon part), portable C elsewhere. openentropy-core's
+// conditioning calls poc_sha256_parts through FFI under its `poc-native`
+// feature; PoCs can use the streaming API directly.
+
+#ifndef POC_SHA256_H
+#define POC_SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t state[8];
+    uint64_t total;         // bytes absorbed
+    uint8_t buf[64];
+    size_t n_buf;
+} PocSha256;
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+} PocSha256Part;
+
+// 1 when the hardware body was compiled in.
+int poc_sha256_hardware(void);
+
+// Compress n_blocks consecutive 64-byte blocks into state.
+void poc_sha256_blocks(uint32_t state[8], const uint8_t *blocks, size_t n_blocks);
+
+void poc_sha256_init(PocSha256 *h);
+void poc_sha256_update(PocSha256 *h, const void *data, size_t len);
+void poc_sha256_final(PocSha256 *h, uint8_t out[32]);
+
+// One-shot digest of the concatenation of n parts.
+void poc_sha256_parts(const PocSha256Part *parts, int n, uint8_t out[32]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_SHA256_H
@@ -0,0 +1,122 @@
+// poc_smc.c — Shared AppleSMC client with cached key info
+
+#include "poc_smc.h"
+
+#include <string.h>
+
+#if defined(__APPLE__)
+#include <IOKit/IOKitLib.h>
+
+// AppleSMC user-client parameter block (80 bytes; the kernel rejects any
+// other size).
+typedef struct {
+    uint32_t data_size;
+    uint32_t data_type;
+    uint8_t data_attributes;
+} SMCKeyInfo;
+
+typedef struct {
+    uint32_t key;
+    uint8_t vers[6];
+    uint32_t plimit[4];
+    SMCKeyInfo key_info;
+    uint8_t result;
+    uint8_t status;
+    uint8_t data8;          // command
+    uint32_t data32;
+    uint8_t bytes[32];
+} SMCParam;
+
+_Static_assert(sizeof(SMCParam) == 80, "SMCParam must match the AppleSMC ABI");
+
+#define KERNEL_INDEX_SMC 2
+#define SMC_CMD_READ_BYTES 5
+#define SMC_CMD_READ_KEYINFO 9
+
+static io_connect_t g_conn;
+
+static int smc_call(SMCParam *in, SMCParam *out) {
+    size_t out_size = sizeof(*out);
+    return IOConnectCallStructMethod(g_conn, KERNEL_INDEX_SMC, in, sizeof(*in), out,
+                                     &out_size) == KERN_SUCCESS && out->result == 0
+               ? 0
+               : -1;
+}
+
+int poc_smc_open(void) {
+    if (g_conn) return 0;
+    io_service_t service = IOServiceGetMatchingService(
+        kIOMainPortDefault, IOServiceMatching("AppleSMC"));
+    if (!service) return -1;
+    kern_return_t kr = IOServiceOpen(service, mach_task_self(), 0, &g_conn);
+    IOObjectRelease(service);
+    if (kr != KERN_SUCCESS) {
+        g_conn = 0;
+        return -1;
+    }
+    return 0;
+}
+
+void poc_smc_close(void) {
+    if (g_conn) IOServiceClose(g_conn);
+    g_conn = 0;
+}
+
+int poc_smc_key_init(PocSmcKey *k, const char *name) {
+    memset(k, 0, sizeof(*k));
+    memcpy(k->name, name, strnlen(name, 4));
+    k->key = ((uint32_t)(uint8_t)k->name[0] << 24) | ((uint32_t)(uint8_t)k->name[1] << 16) |
+             ((uint32_t)(uint8_t)k->name[2] << 8) | (uint32_t)(uint8_t)k->name[3];
+
+    SMCParam in = {0}, out = {0};
+    in.key = k->key;
+    in.data8 = SMC_CMD_READ_KEYINFO;
+    if (smc_call(&in, &out) != 0) return -1;
+    k->data_size = out.key_info.data_size;
+    k->data_type = out.key_info.data_type;
+    if (k->data_size == 0 || k->data_size > sizeof(k->bytes)) return -1;
+    k->available = 1;
+    return 0;
+}
+
+int poc_smc_read(PocSmcKey *k) {
+    if (!k->available) return -1;
+    SMCParam in = {0}, out = {0};
+    in.key = k->key;
+    in.key_info.data_size = k->data_size;
+    in.data8 = SMC_CMD_READ_BYTES;
+    if (smc_call(&in, &out) != 0) return -1;
+    memcpy(k->bytes, out.bytes, k->data_size);
+    return 0;
+}
+
+#else
+
+int poc_smc_open(void) { return -1; }
+void poc_smc_close(void) {}
+
+int poc_smc_key_init(PocSmcKey *k, const char *name) {
+    memset(k, 0, sizeof(*k));
+    memcpy(k->name, name, strnlen(name, 4));
+    return -1;
+}
+
+int poc_smc_read(PocSmcKey *k) {
+    (void)k;
+    return -1;
+}
+
+#endif
+
+int poc_smc_read_all(PocSmcKey *keys, int n) {
+    int ok = 0;
+    for (int i = 0; i < n; i++)
+        if (keys[i].available && poc_smc_read(&keys[i]) == 0) ok++;
+    return ok;
+}
+
+uint64_t poc_smc_value(const PocSmcKey *k) {
+    uint64_t v = 0;
+    for (uint32_t i = 0; i < k->data_size && i < 8; i++) v = (v << 8) | k->bytes[i];
+    return v;
+}
@@ -0,0 +1,50 @@
+// poc_smc.h — Shared AppleSMC client with cached key info
+//
+// A raw SMC read is two IOConnectCallStructMethod round trips:
+// READ_KEYINFO for the key's size and type, then READ_BYTES. The info
+// never changes for the life of a connection, so a PocSmcKey fetches it
+// once in poc_smc_key_init() and every later read is a single READ_BYTES.
+// poc_smc_read_all() reads a whole key set per tick.
+//
+// Needs root on most machines. Link -framework IOKit -framework
+// CoreFoundation; off macOS poc_smc_open() always fails.
+
+#ifndef POC_SMC_H
+#define POC_SMC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    char name[5];
+    uint32_t key;           // four-char code, big-endian packed
+    uint32_t data_size;     // from READ_KEYINFO
+    uint32_t data_type;
+    int available;          // key info read successfully and data_size > 0
+    uint8_t bytes[32];      // last value read
+} PocSmcKey;
+
+// Open / close the process-wide AppleSMC connection. 0 or -1.
+int poc_smc_open(void);
+void poc_smc_close(void);
+
+// Look up a key's info (one READ_KEYINFO). Returns 0 if the key exists.
+int poc_smc_key_init(PocSmcKey *k, const char *name);
+
+// One READ_BYTES into k->bytes. Returns 0 or -1.
+int poc_smc_read(PocSmcKey *k);
+
+// Read every available key in order. Returns how many reads succeeded.
+int poc_smc_read_all(PocSmcKey *keys, int n);
+
+// k->bytes[0..data_size) as a big-endian integer (first 8 bytes).
+uint64_t poc_smc_value(const PocSmcKey *k);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_SMC_H
@@ -0,0 +1,103 @@
+// poc_spsc.c — Lock-free single-producer / single-consumer ring of 32-bit words
+
+#include "poc_spsc.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+static int ring_init(PocSpsc *r, uint32_t capacity, int shared) {
+    uint32_t cap = 1;
+    while (cap < capacity && cap < (1u << 31)) cap <<= 1;
+    memset(r, 0, sizeof(*r));
+    if (shared) {
+        void *p = mmap(NULL, (size_t)cap * sizeof(uint32_t), PROT_READ | PROT_WRITE,
+                       MAP_ANON | MAP_SHARED, -1, 0);
+        if (p == MAP_FAILED) return -1;
+        r->buf = p;
+        r->shared = 1;
+    } else {
+        r->buf = calloc(cap, sizeof(uint32_t));
+        if (!r->buf) return -1;
+    }
+    r->mask = cap - 1;
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    atomic_init(&r->dropped, 0);
+    return 0;
+}
+
+int poc_spsc_init(PocSpsc *r, uint32_t capacity) { return ring_init(r, capacity, 0); }
+int poc_spsc_init_shared(PocSpsc *r, uint32_t capacity) { return ring_init(r, capacity, 1); }
+
+void poc_spsc_free(PocSpsc *r) {
+    if (r->shared && r->buf)
+        munmap(r->buf, ((size_t)r->mask + 1) * sizeof(uint32_t));
+    else
+        free(r->buf);
+    r->buf = NULL;
+}
+
+// Copy n words between the linear buffer and the ring starting at pos,
+// splitting at the wrap point.
+static void ring_copy_in(PocSpsc *r, uint64_t pos, const uint8_t *src, uint32_t n) {
+    uint32_t at = (uint32_t)pos & r->mask;
+    uint32_t first = r->mask + 1 - at;
+    if (first > n) first = n;
+    memcpy(r->buf + at, src, (size_t)first * sizeof(uint32_t));
+    memcpy(r->buf, src + (size_t)first * sizeof(uint32_t), (size_t)(n - first) * sizeof(uint32_t));
+}
+
+static void ring_copy_out(PocSpsc *r, uint64_t pos, uint32_t *dst, uint32_t n) {
+    uint32_t at = (uint32_t)pos & r->mask;
+    uint32_t first = r->mask + 1 - at;
+    if (first > n) first = n;
+    memcpy(dst, r->buf + at, (size_t)first * sizeof(uint32_t));
+    memcpy(dst + first, r->buf, (size_t)(n - first) * sizeof(uint32_t));
+}
+
+uint32_t poc_spsc_write(PocSpsc *r, const void *src, uint32_t n) {
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+    uint64_t space = (uint64_t)r->mask + 1 - (head - tail);
+    uint32_t w = n < space ? n : (uint32_t)space;
+    if (w) {
+        ring_copy_in(r, head, src, w);
+        atomic_store_explicit(&r->head, head + w, memory_order_release);
+    }
+    if (w < n) atomic_fetch_add_explicit(&r->dropped, n - w, memory_order_relaxed);
+    return w;
+}
+
+uint32_t poc_spsc_write_all(PocSpsc *r, const void *src, uint32_t n) {
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+    if ((uint64_t)r->mask + 1 - (head - tail) < n) {
+        atomic_fetch_add_explicit(&r->dropped, n, memory_order_relaxed);
+        return 0;
+    }
+    ring_copy_in(r, head, src, n);
+    atomic_store_explicit(&r->head, head + n, memory_order_release);
+    return n;
+}
+
+uint32_t poc_spsc_read(PocSpsc *r, uint32_t *dst, uint32_t max) {
+    uint64_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+    uint64_t avail = head - tail;
+    uint32_t n = max < avail ? max : (uint32_t)avail;
+    if (n) {
+        ring_copy_out(r, tail, dst, n);
+        atomic_store_explicit(&r->tail, tail + n, memory_order_release);
+    }
+    return n;
+}
+
+uint64_t poc_spsc_size(PocSpsc *r) {
+    return atomic_load_explicit(&r->head, memory_order_acquire) -
+           atomic_load_explicit(&r->tail, memory_order_acquire);
+}
+
+uint64_t poc_spsc_dropped(PocSpsc *r) {
+    return atomic_load_explicit(&r->dropped, memory_order_relaxed);
+}
@@ -0,0 +1,57 @@
+// poc_spsc.h — Lock-free single-producer / single-consumer ring of 32-bit words
+//
+// For real-time producers (CoreAudio callbacks, sampler threads) that must
+// not allocate, lock or block: the storage is allocated once up front, and
+// poc_spsc_write() only copies and publishes with a release store. When the
+// consumer falls behind, the words that do not fit are dropped and counted
+// rather than waiting. Floats go in as their bit patterns.
+//
+// poc_spsc_init_shared() maps the storage MAP_SHARED instead, so a ring
+// that itself lives in shared memory keeps working across fork(): the child
+// produces, the parent consumes (poc_concurrent).
+
+#ifndef POC_SPSC_H
+#define POC_SPSC_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    // head is written only by the producer, tail only by the consumer;
+    // each sits on its own cache line.
+    _Alignas(128) _Atomic uint64_t head;
+    _Atomic uint64_t dropped;            // producer-side, relaxed
+    _Alignas(128) _Atomic uint64_t tail;
+    _Alignas(128) uint32_t *buf;
+    uint32_t mask;
+    uint32_t shared;    // buf is a MAP_SHARED mapping
+} PocSpsc;
+
+// capacity is rounded up to a power of two. Returns 0, or -1 on allocation failure.
+int poc_spsc_init(PocSpsc *r, uint32_t capacity);
+int poc_spsc_init_shared(PocSpsc *r, uint32_t capacity);
+void poc_spsc_free(PocSpsc *r);
+
+// Producer: append up to n words, returns how many fit (the rest are dropped).
+uint32_t poc_spsc_write(PocSpsc *r, const void *src, uint32_t n);
+
+// Producer: append all n words or none (then all n count as dropped), so
+// fixed-size records never straddle a drop. Returns n or 0.
+uint32_t poc_spsc_write_all(PocSpsc *r, const void *src, uint32_t n);
+
+// Consumer: move up to max words into dst, returns how many.
+uint32_t poc_spsc_read(PocSpsc *r, uint32_t *dst, uint32_t max);
+
+// Words currently buffered / dropped so far (approximate while running).
+uint64_t poc_spsc_size(PocSpsc *r);
+uint64_t poc_spsc_dropped(PocSpsc *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_SPSC_H
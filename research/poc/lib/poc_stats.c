@@ -0,0 +1,296 @@
+// poc_stats.c — Shared entropy statistics for the research PoCs
+//
+// NEON paths are selected at compile time (__ARM_NEON); every kernel has a
+// scalar fallback with identical results so the library also builds for
+// x86 hosts. Histograms are accumulated into four interleaved sub-tables to
+// break the store→load dependency on repeated bins, then summed.
+
+#include "poc_stats.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(__ARM_NEON)
+static inline uint64x2_t fold64x2(uint64x2_t v) {
+    v = veorq_u64(v, vshrq_n_u64(v, 32));
+    v = veorq_u64(v, vshrq_n_u64(v, 16));
+    v = veorq_u64(v, vshrq_n_u64(v, 8));
+    return v;
+}
+
+// Fold 8 samples (optionally first differences) to 8 bytes.
+static inline uint8x8_t fold8(const uint64_t *p, int delta) {
+    uint64x2_t a = vld1q_u64(p + 0), b = vld1q_u64(p + 2);
+    uint64x2_t c = vld1q_u64(p + 4), d = vld1q_u64(p + 6);
+    if (delta) {
+        a = vsubq_u64(vld1q_u64(p + 1), a);
+        b = vsubq_u64(vld1q_u64(p + 3), b);
+        c = vsubq_u64(vld1q_u64(p + 5), c);
+        d = vsubq_u64(vld1q_u64(p + 7), d);
+    }
+    uint32x4_t ab = vcombine_u32(vmovn_u64(fold64x2(a)), vmovn_u64(fold64x2(b)));
+    uint32x4_t cd = vcombine_u32(vmovn_u64(fold64x2(c)), vmovn_u64(fold64x2(d)));
+    uint16x8_t all = vcombine_u16(vmovn_u32(ab), vmovn_u32(cd));
+    return vmovn_u16(all);
+}
+#endif
+
+static void merge_hist(uint32_t sub[4][256], uint32_t hist[256]) {
+    for (int i = 0; i < 256; i++)
+        hist[i] = sub[0][i] + sub[1][i] + sub[2][i] + sub[3][i];
+}
+
+// Histogram of fold(in[i]) or fold(in[i+1] - in[i]) over n output bytes.
+static void fold_hist(const uint64_t *in, int n, uint32_t hist[256], int delta) {
+    uint32_t sub[4][256];
+    memset(sub, 0, sizeof(sub));
+    int i = 0;
+#if defined(__ARM_NEON)
+    uint8_t lane[8];
+    for (; i + 8 <= n; i += 8) {
+        vst1_u8(lane, fold8(in + i, delta));
+        sub[0][lane[0]]++; sub[1][lane[1]]++;
+        sub[2][lane[2]]++; sub[3][lane[3]]++;
+        sub[0][lane[4]]++; sub[1][lane[5]]++;
+        sub[2][lane[6]]++; sub[3][lane[7]]++;
+    }
+#else
+    for (; i + 4 <= n; i += 4) {
+        if (delta) {
+            sub[0][poc_fold64(in[i + 1] - in[i + 0])]++;
+            sub[1][poc_fold64(in[i + 2] - in[i + 1])]++;
+            sub[2][poc_fold64(in[i + 3] - in[i + 2])]++;
+            sub[3][poc_fold64(in[i + 4] - in[i + 3])]++;
+        } else {
+            sub[0][poc_fold64(in[i + 0])]++;
+            sub[1][poc_fold64(in[i + 1])]++;
+            sub[2][poc_fold64(in[i + 2])]++;
+            sub[3][poc_fold64(in[i + 3])]++;
+        }
+    }
+#endif
+    for (; i < n; i++)
+        sub[0][poc_fold64(delta ? in[i + 1] - in[i] : in[i])]++;
+    merge_hist(sub, hist);
+}
+
+void poc_xorfold(const uint64_t *in, uint8_t *out, int n) {
+    int i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 8 <= n; i += 8) vst1_u8(out + i, fold8(in + i, 0));
+#endif
+    for (; i < n; i++) out[i] = poc_fold64(in[i]);
+}
+
+void poc_histogram(const uint8_t *data, int n, uint32_t hist[256]) {
+    uint32_t sub[4][256];
+    memset(sub, 0, sizeof(sub));
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        sub[0][data[i + 0]]++;
+        sub[1][data[i + 1]]++;
+        sub[2][data[i + 2]]++;
+        sub[3][data[i + 3]]++;
+    }
+    for (; i < n; i++) sub[0][data[i]]++;
+    merge_hist(sub, hist);
+}
+
+void poc_xorfold_histogram(const uint64_t *in, int n, uint32_t hist[256]) {
+    fold_hist(in, n, hist, 0);
+}
+
+// Shifted-data single pass: subtracting the first sample keeps the sum of
+// squares well conditioned for timer values around 1e9+ ticks.
+void poc_mean_var(const uint64_t *x, int n, double *mean, double *var) {
+    if (n <= 0) { *mean = 0; *var = 0; return; }
+    const uint64_t k = x[0];
+    double s = 0, q = 0;
+    int i = 0;
+#if defined(__ARM_NEON)
+    uint64x2_t vk = vdupq_n_u64(k);
+    float64x2_t s0 = vdupq_n_f64(0), s1 = vdupq_n_f64(0);
+    float64x2_t q0 = vdupq_n_f64(0), q1 = vdupq_n_f64(0);
+    for (; i + 4 <= n; i += 4) {
+        float64x2_t a = vcvtq_f64_s64(vreinterpretq_s64_u64(vsubq_u64(vld1q_u64(x + i), vk)));
+        float64x2_t b = vcvtq_f64_s64(vreinterpretq_s64_u64(vsubq_u64(vld1q_u64(x + i + 2), vk)));
+        s0 = vaddq_f64(s0, a);
+        s1 = vaddq_f64(s1, b);
+        q0 = vfmaq_f64(q0, a, a);
+        q1 = vfmaq_f64(q1, b, b);
+    }
+    s = vaddvq_f64(vaddq_f64(s0, s1));
+    q = vaddvq_f64(vaddq_f64(q0, q1));
+#endif
+    for (; i < n; i++) {
+        double d = (double)(int64_t)(x[i] - k);
+        s += d;
+        q += d * d;
+    }
+    double m = s / n;
+    double v = q / n - m * m;
+    *mean = (double)k + m;
+    *var = v > 0 ? v : 0;
+}
+
+double poc_shannon_hist(const uint32_t hist[256], int total) {
+    if (total <= 0) return 0;
+    double h = 0;
+    for (int i = 0; i < 256; i++) {
+        if (hist[i] > 0) {
+            double p = (double)hist[i] / total;
+            h -= p * log2(p);
+        }
+    }
+    return h;
+}
+
+double poc_min_entropy_hist(const uint32_t hist[256], int total) {
+    if (total <= 0) return 0;
+    uint32_t mx = 0;
+    for (int i = 0; i < 256; i++)
+        if (hist[i] > mx) mx = hist[i];
+    return -log2((double)mx / total);
+}
+
+Stats compute_stats(const uint64_t *timings, int n) {
+    Stats s = {0};
+    if (n <= 0) return s;
+    uint32_t hist[256];
+    fold_hist(timings, n, hist, 0);
+    double var;
+    poc_mean_var(timings, n, &s.mean, &var);
+    s.stddev = sqrt(var);
+    s.shannon = poc_shannon_hist(hist, n);
+    s.min_entropy = poc_min_entropy_hist(hist, n);
+    return s;
+}
+
+Stats compute_stats_delta_xorfold(const uint64_t *timings, int n) {
+    Stats s = {0};
+    int nd = n - 1;
+    if (nd <= 0) return s;
+    uint32_t hist[256];
+    fold_hist(timings, nd, hist, 1);
+    s.shannon = poc_shannon_hist(hist, nd);
+    s.min_entropy = poc_min_entropy_hist(hist, nd);
+    return s;
+}
+
+double autocorrelation(const uint64_t *timings, int n, int lag) {
+    if (lag < 0 || n <= lag) return 0;
+    double mean, var;
+    poc_mean_var(timings, n, &mean, &var);
+    double den = var * n;
+    if (den < 1e-15) return 0;
+
+    // Centre relative to the first sample so the products stay small.
+    const uint64_t k = timings[0];
+    const double c = mean - (double)k;
+    const int m = n - lag;
+    double num = 0;
+    int i = 0;
+#if defined(__ARM_NEON)
+    uint64x2_t vk = vdupq_n_u64(k);
+    float64x2_t vc = vdupq_n_f64(c);
+    float64x2_t acc0 = vdupq_n_f64(0), acc1 = vdupq_n_f64(0);
+    for (; i + 4 <= m; i += 4) {
+        float64x2_t a0 = vsubq_f64(vcvtq_f64_s64(vreinterpretq_s64_u64(
+                             vsubq_u64(vld1q_u64(timings + i), vk))), vc);
+        float64x2_t a1 = vsubq_f64(vcvtq_f64_s64(vreinterpretq_s64_u64(
+                             vsubq_u64(vld1q_u64(timings + i + 2), vk))), vc);
+        float64x2_t b0 = vsubq_f64(vcvtq_f64_s64(vreinterpretq_s64_u64(
+                             vsubq_u64(vld1q_u64(timings + i + lag), vk))), vc);
+        float64x2_t b1 = vsubq_f64(vcvtq_f64_s64(vreinterpretq_s64_u64(
+                             vsubq_u64(vld1q_u64(timings + i + lag + 2), vk))), vc);
+        acc0 = vfmaq_f64(acc0, a0, b0);
+        acc1 = vfmaq_f64(acc1, a1, b1);
+    }
+    num = vaddvq_f64(vaddq_f64(acc0, acc1));
+#endif
+    for (; i < m; i++) {
+        double a = (double)(int64_t)(timings[i] - k) - c;
+        double b = (double)(int64_t)(timings[i + lag] - k) - c;
+        num += a * b;
+    }
+    return num / den;
+}
+
+double pearson(const uint64_t *a, const uint64_t *b, int n) {
+    if (n <= 1) return 0;
+    const uint64_t ka = a[0], kb = b[0];
+    double sa = 0, sb = 0, saa = 0, sbb = 0, sab = 0;
+    int i = 0;
+#if defined(__ARM_NEON)
+    uint64x2_t vka = vdupq_n_u64(ka), vkb = vdupq_n_u64(kb);
+    float64x2_t vsa = vdupq_n_f64(0), vsb = vdupq_n_f64(0);
+    float64x2_t vsaa = vdupq_n_f64(0), vsbb = vdupq_n_f64(0), vsab = vdupq_n_f64(0);
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t x = vcvtq_f64_s64(vreinterpretq_s64_u64(vsubq_u64(vld1q_u64(a + i), vka)));
+        float64x2_t y = vcvtq_f64_s64(vreinterpretq_s64_u64(vsubq_u64(vld1q_u64(b + i), vkb)));
+        vsa = vaddq_f64(vsa, x);
+        vsb = vaddq_f64(vsb, y);
+        vsaa = vfmaq_f64(vsaa, x, x);
+        vsbb = vfmaq_f64(vsbb, y, y);
+        vsab = vfmaq_f64(vsab, x, y);
+    }
+    sa = vaddvq_f64(vsa); sb = vaddvq_f64(vsb);
+    saa = vaddvq_f64(vsaa); sbb = vaddvq_f64(vsbb); sab = vaddvq_f64(vsab);
+#endif
+    for (; i < n; i++) {
+        double x = (double)(int64_t)(a[i] - ka);
+        double y = (double)(int64_t)(b[i] - kb);
+        sa += x; sb += y;
+        saa += x * x; sbb += y * y; sab += x * y;
+    }
+    double num = sab - sa * sb / n;
+    double da = saa - sa * sa / n;
+    double db = sbb - sb * sb / n;
+    if (da < 1e-15 || db < 1e-15) return 0;
+    return num / sqrt(da * db);
+}
+
+double pearson_f64(const double *a, const double *b, int n) {
+    if (n <= 1) return 0;
+    double ma = 0, mb = 0;
+    for (int i = 0; i < n; i++) { ma += a[i]; mb += b[i]; }
+    ma /= n; mb /= n;
+
+    double num = 0, da = 0, db = 0;
+    int i = 0;
+#if defined(__ARM_NEON)
+    float64x2_t vma = vdupq_n_f64(ma), vmb = vdupq_n_f64(mb);
+    float64x2_t vnum = vdupq_n_f64(0), vda = vdupq_n_f64(0), vdb = vdupq_n_f64(0);
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t x = vsubq_f64(vld1q_f64(a + i), vma);
+        float64x2_t y = vsubq_f64(vld1q_f64(b + i), vmb);
+        vnum = vfmaq_f64(vnum, x, y);
+        vda = vfmaq_f64(vda, x, x);
+        vdb = vfmaq_f64(vdb, y, y);
+    }
+    num = vaddvq_f64(vnum); da = vaddvq_f64(vda); db = vaddvq_f64(vdb);
+#endif
+    for (; i < n; i++) {
+        double x = a[i] - ma, y = b[i] - mb;
+        num += x * y;
+        da += x * x;
+        db += y * y;
+    }
+    if (da < 1e-15 || db < 1e-15) return 0;
+    return num / sqrt(da * db);
+}
+
+void analyze_entropy(const char *label, const uint8_t *data, int n) {
+    uint32_t hist[256];
+    poc_histogram(data, n, hist);
+    int unique = 0;
+    for (int i = 0; i < 256; i++)
+        if (hist[i] > 0) unique++;
+    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
+           label, poc_shannon_hist(hist, n), poc_min_entropy_hist(hist, n), unique, n);
+}
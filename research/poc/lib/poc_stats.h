@@ -0,0 +1,80 @@
+// poc_stats.h — Shared entropy statistics for the research PoCs
+//
+// Every PoC reduces its raw timings the same way: XOR-fold each 64-bit
+// sample to a byte, histogram the bytes, and report Shannon / min-entropy
+// alongside mean/stddev, lag autocorrelation and Pearson cross-correlation.
+// This library is the single implementation of those passes. The hot loops
+// (XOR-fold, 256-bin histogram, mean/variance, Pearson) have NEON paths on
+// arm64 so 100K–10M sample runs are bound by collection, not analysis.
+//
+// Link: libpoc.a (see research/poc/Makefile)
+
+#ifndef POC_STATS_H
+#define POC_STATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    double shannon;
+    double min_entropy;
+    double mean;
+    double stddev;
+} Stats;
+
+// ---------------------------------------------------------------------------
+// Vector kernels
+// ---------------------------------------------------------------------------
+
+// XOR of all 8 bytes of x.
+static inline uint8_t poc_fold64(uint64_t x) {
+    x ^= x >> 32;
+    x ^= x >> 16;
+    x ^= x >> 8;
+    return (uint8_t)x;
+}
+
+// XOR-fold each 64-bit sample to one byte (all 8 bytes XORed together).
+void poc_xorfold(const uint64_t *in, uint8_t *out, int n);
+
+// 256-bin histogram of a byte stream. hist is overwritten.
+void poc_histogram(const uint8_t *data, int n, uint32_t hist[256]);
+
+// Fused XOR-fold + histogram, no intermediate byte buffer. hist is overwritten.
+void poc_xorfold_histogram(const uint64_t *in, int n, uint32_t hist[256]);
+
+// Population mean and variance of a uint64 series in one pass.
+void poc_mean_var(const uint64_t *x, int n, double *mean, double *var);
+
+// Shannon and min-entropy (bits) of a histogram over total samples.
+double poc_shannon_hist(const uint32_t hist[256], int total);
+double poc_min_entropy_hist(const uint32_t hist[256], int total);
+
+// ---------------------------------------------------------------------------
+// Analysis entry points used by the validate_* and thermal/unprecedented PoCs
+// ---------------------------------------------------------------------------
+
+// XOR-folded byte entropy plus mean/stddev of the raw samples.
+Stats compute_stats(const uint64_t *timings, int n);
+
+// Same, over XOR-folded first differences (no mean/stddev).
+Stats compute_stats_delta_xorfold(const uint64_t *timings, int n);
+
+// Normalized autocorrelation at the given lag.
+double autocorrelation(const uint64_t *timings, int n, int lag);
+
+// Pearson correlation between two equal-length series.
+double pearson(const uint64_t *a, const uint64_t *b, int n);
+double pearson_f64(const double *a, const double *b, int n);
+
+// Print "label: Shannon=…  H∞=…  unique=…/256  n=…" for a byte stream.
+void analyze_entropy(const char *label, const uint8_t *data, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_STATS_H
@@ -0,0 +1,113 @@
+// poc_stream.c — Single-pass streaming statistics
+//
+// Autocorrelation at lag k is recovered exactly from running sums:
+//   Σ (x[i]-m)(x[i-k]-m) = S_k − m·(A_k + B_k) + (n−k)·m²
+// where S_k = Σ x[i]·x[i-k], A_k = Σ x minus the first k samples, and
+// B_k = Σ x minus the last k samples (read back from the ring).
+
+#include "poc_stream.h"
+
+#include <math.h>
+#include <string.h>
+
+void poc_stream_init(PocStream *s, int max_lag) {
+    memset(s, 0, sizeof(*s));
+    if (max_lag < 0) max_lag = 0;
+    if (max_lag > POC_STREAM_MAX_LAG) max_lag = POC_STREAM_MAX_LAG;
+    s->max_lag = max_lag;
+}
+
+static inline void push_shifted(PocStream *s, double y) {
+    const int K = s->max_lag;
+    s->n++;
+
+    double d = y - s->mean;
+    s->mean += d / (double)s->n;
+    s->m2 += d * (y - s->mean);
+    s->total += y;
+
+    if (K == 0) return;
+    uint64_t have = s->n - 1;
+    int lim = have < (uint64_t)K ? (int)have : K;
+    int pos = s->ring_pos;
+    for (int k = 1; k <= lim; k++) {
+        int j = pos - k;
+        if (j < 0) j += K;
+        s->lag_prod[k] += y * s->ring[j];
+    }
+    if (have < (uint64_t)K) s->head[have] = y;
+    s->ring[pos] = y;
+    s->ring_pos = pos + 1 == K ? 0 : pos + 1;
+}
+
+void poc_stream_push(PocStream *s, uint64_t x) {
+    if (s->n == 0) s->shift = x;
+    s->hist[poc_fold64(x)]++;
+    push_shifted(s, (double)(int64_t)(x - s->shift));
+}
+
+void poc_stream_push_n(PocStream *s, const uint64_t *x, int n) {
+    if (n <= 0) return;
+    if (s->n == 0) s->shift = x[0];
+
+    uint32_t h[256];
+    poc_xorfold_histogram(x, n, h);
+    for (int i = 0; i < 256; i++) s->hist[i] += h[i];
+
+    const uint64_t k = s->shift;
+    for (int i = 0; i < n; i++)
+        push_shifted(s, (double)(int64_t)(x[i] - k));
+}
+
+Stats poc_stream_stats(const PocStream *s) {
+    Stats st = {0};
+    if (s->n == 0) return st;
+    const double n = (double)s->n;
+
+    uint64_t mx = 0;
+    for (int i = 0; i < 256; i++) {
+        if (s->hist[i] > 0) {
+            double p = (double)s->hist[i] / n;
+            st.shannon -= p * log2(p);
+        }
+        if (s->hist[i] > mx) mx = s->hist[i];
+    }
+    st.min_entropy = -log2((double)mx / n);
+    st.mean = (double)s->shift + s->mean;
+    st.stddev = sqrt(s->m2 / n);
+    return st;
+}
+
+double poc_stream_autocorrelation(const PocStream *s, int lag) {
+    if (lag < 0 || lag > s->max_lag || s->n <= (uint64_t)lag) return 0;
+    if (s->m2 < 1e-15) return 0;
+    if (lag == 0) return 1;
+
+    const int K = s->max_lag;
+    double first = 0, last = 0;
+    for (int j = 0; j < lag; j++) first += s->head[j];
+    for (int j = 1; j <= lag; j++) {
+        int idx = s->ring_pos - j;
+        if (idx < 0) idx += K;
+        last += s->ring[idx];
+    }
+    const double m = s->mean;
+    const double a = s->total - first;
+    const double b = s->total - last;
+    double num = s->lag_prod[lag] - m * (a + b) + (double)(s->n - (uint64_t)lag) * m * m;
+    return num / s->m2;
+}
+
+uint64_t poc_stream_collect(PocStream *s, poc_collect_fn collect, uint64_t total,
+                            uint64_t *chunk, int chunk_n) {
+    uint64_t pushed = 0;
+    while (pushed < total) {
+        uint64_t want = total - pushed;
+        int n = want < (uint64_t)chunk_n ? (int)want : chunk_n;
+        int got = collect(chunk, n);
+        if (got <= 0) break;
+        poc_stream_push_n(s, chunk, got);
+        pushed += (uint64_t)got;
+    }
+    return pushed;
+}
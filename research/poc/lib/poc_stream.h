@@ -0,0 +1,65 @@
+// poc_stream.h — Single-pass streaming statistics
+//
+// Constant-memory counterpart to compute_stats()/autocorrelation(): samples
+// are pushed one at a time (or in chunks straight out of a collector) and
+// folded into a Welford mean/variance, a running XOR-fold histogram, and a
+// ring of the last POC_STREAM_MAX_LAG samples for lag-1..K autocorrelation.
+// A 100M-sample soak needs no timing buffer beyond the collector chunk.
+
+#ifndef POC_STREAM_H
+#define POC_STREAM_H
+
+#include <stdint.h>
+
+#include "poc_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POC_STREAM_MAX_LAG 64
+
+// Fill timings[0..n), return the number of valid samples.
+typedef int (*poc_collect_fn)(uint64_t *timings, int n);
+
+typedef struct {
+    uint64_t n;
+    int max_lag;
+
+    // Welford running mean / sum of squared deviations.
+    double mean;
+    double m2;
+
+    uint64_t hist[256];
+
+    // Autocorrelation runs on samples shifted by the first sample so the
+    // lagged products stay well conditioned for large counter values.
+    uint64_t shift;
+    double total;                            // Σ x
+    double lag_prod[POC_STREAM_MAX_LAG + 1]; // Σ x[i]·x[i-k]
+    double head[POC_STREAM_MAX_LAG];         // first K samples
+    double ring[POC_STREAM_MAX_LAG];         // last K samples
+    int ring_pos;
+} PocStream;
+
+// max_lag is clamped to [0, POC_STREAM_MAX_LAG].
+void poc_stream_init(PocStream *s, int max_lag);
+void poc_stream_push(PocStream *s, uint64_t x);
+void poc_stream_push_n(PocStream *s, const uint64_t *x, int n);
+
+// Same fields as compute_stats() over every sample pushed so far.
+Stats poc_stream_stats(const PocStream *s);
+
+// Same definition as autocorrelation(); 0 for lag > max_lag.
+double poc_stream_autocorrelation(const PocStream *s, int lag);
+
+// Drive a collector in chunk-sized calls until total samples have been
+// pushed (or the collector stops producing). Returns samples pushed.
+uint64_t poc_stream_collect(PocStream *s, poc_collect_fn collect, uint64_t total,
+                            uint64_t *chunk, int chunk_n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_STREAM_H
@@ -0,0 +1,106 @@
+// poc_time.c — Run-time source dispatch and the kperf cycle counter
+
+#include "poc_time.h"
+
+#include <stddef.h>
+
+#if defined(__APPLE__)
+#include <dlfcn.h>
+#include <unistd.h>
+
+// Private kperf framework (no header ships). Fixed counter 0 counts core
+// cycles; thread counters are only handed out to root.
+#define KPC_CLASS_FIXED_MASK 1u
+#define KPERF_PATH "/System/Library/PrivateFrameworks/kperf.framework/kperf"
+
+static int (*kpc_force_all_ctrs_set)(int);
+static int (*kpc_set_counting)(uint32_t);
+static int (*kpc_set_thread_counting)(uint32_t);
+static uint32_t (*kpc_get_counter_count)(uint32_t);
+static int (*kpc_get_thread_counters)(int, unsigned int, uint64_t *);
+static unsigned int pmu_count;   // 0 until poc_ts_pmu_init() succeeds
+
+int poc_ts_pmu_init(void) {
+    if (pmu_count) return 0;
+    if (geteuid() != 0) return -1;
+    void *h = dlopen(KPERF_PATH, RTLD_LAZY);
+    if (!h) return -1;
+    kpc_force_all_ctrs_set = (int (*)(int))dlsym(h, "kpc_force_all_ctrs_set");
+    kpc_set_counting = (int (*)(uint32_t))dlsym(h, "kpc_set_counting");
+    kpc_set_thread_counting = (int (*)(uint32_t))dlsym(h, "kpc_set_thread_counting");
+    kpc_get_counter_count = (uint32_t (*)(uint32_t))dlsym(h, "kpc_get_counter_count");
+    kpc_get_thread_counters =
+        (int (*)(int, unsigned int, uint64_t *))dlsym(h, "kpc_get_thread_counters");
+    if (!kpc_force_all_ctrs_set || !kpc_set_counting || !kpc_set_thread_counting ||
+        !kpc_get_counter_count || !kpc_get_thread_counters)
+        return -1;
+    if (kpc_force_all_ctrs_set(1) != 0 || kpc_set_counting(KPC_CLASS_FIXED_MASK) != 0 ||
+        kpc_set_thread_counting(KPC_CLASS_FIXED_MASK) != 0)
+        return -1;
+    uint32_t n = kpc_get_counter_count(KPC_CLASS_FIXED_MASK);
+    if (n == 0 || n > 32) return -1;
+    uint64_t buf[32];
+    if (kpc_get_thread_counters(0, n, buf) != 0) return -1;
+    pmu_count = n;
+    return 0;
+}
+
+uint64_t poc_ts_pmu(void) {
+    uint64_t buf[32];
+    if (!pmu_count || kpc_get_thread_counters(0, pmu_count, buf) != 0) return 0;
+    return buf[0];
+}
+
+#else
+
+int poc_ts_pmu_init(void) { return -1; }
+uint64_t poc_ts_pmu(void) { return 0; }
+
+#endif
+
+uint64_t poc_ts_read(PocTsSource src) {
+    switch (src) {
+    case POC_TS_CNTVCT:     return poc_ts_cntvct();
+    case POC_TS_CNTVCT_ISB: return poc_ts_cntvct_isb();
+    case POC_TS_CNTPCT:     return poc_ts_cntpct();
+    case POC_TS_TSC:        return poc_ts_tsc();
+    case POC_TS_PMU:        return poc_ts_pmu();
+    default:                return poc_ts_mach();
+    }
+}
+
+const char *poc_ts_name(PocTsSource src) {
+    static const char *names[POC_TS_N_SOURCES] = {
+        "mach_absolute_time", "cntvct", "isb+cntvct", "isb+cntpct", "rdtsc", "kperf_cycles",
+    };
+    return (unsigned)src < POC_TS_N_SOURCES ? names[src] : "?";
+}
+
+int poc_ts_available(PocTsSource src) {
+    switch (src) {
+    case POC_TS_MACH:
+        return 1;
+    case POC_TS_CNTVCT:
+    case POC_TS_CNTVCT_ISB:
+    case POC_TS_CNTPCT:
+#if defined(__aarch64__)
+        return 1;
+#else
+        return 0;
+#endif
+    case POC_TS_TSC:
+#if defined(__x86_64__)
+        return 1;
+#else
+        return 0;
+#endif
+    case POC_TS_PMU:
+#if defined(__APPLE__)
+        return 1;
+#else
+        return 0;
+#endif
+    default:
+        return 0;
+    }
+}
@@ -0,0 +1,126 @@
+// poc_time.h — One timestamp layer for the PoCs, source chosen at compile time
+//
+// poc_ts() reads the source named by POC_TS_SOURCE (define it before the
+// include or with -DPOC_TS_SOURCE=...; default mach_absolute_time). Every
+// source also has its own inline reader so a program can compare them,
+// and poc_ts_read() dispatches at run time for poc_timer_bench, which
+// measures each source's read cost and resolution on the machine at hand:
+// pick the cheapest source whose resolution still shows the jitter under
+// study.
+//
+//   POC_TS_MACH        mach_absolute_time(): commpage, CNTVCT scaled to ticks;
+//                      on Linux the POC_LINUX_CLOCK clock (lib/poc_platform.h)
+//   POC_TS_CNTVCT      mrs CNTVCT_EL0 alone — can be read early or late
+//                      relative to surrounding instructions
+//   POC_TS_CNTVCT_ISB  isb; mrs CNTVCT_EL0 — ordered with the code before it
+//   POC_TS_CNTPCT      isb; mrs CNTPCT_EL0 — traps unless the kernel grants
+//                      EL0 access (poc_timer_bench catches the SIGILL)
+//   POC_TS_TSC         x86 rdtsc (Intel Macs, Linux hosts)
+//   POC_TS_PMU         per-thread cycle counter through kperf's
+//                      kpc_get_thread_counters() (macOS, root only; a
+//                      syscall per read): call poc_ts_pmu_init() first
+//
+// Sources that do not exist on the build target read as 0;
+// poc_ts_available() says which are usable.
+
+#ifndef POC_TIME_H
+#define POC_TIME_H
+
+#include <stdint.h>
+
+#include "poc_platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    POC_TS_MACH,
+    POC_TS_CNTVCT,
+    POC_TS_CNTVCT_ISB,
+    POC_TS_CNTPCT,
+    POC_TS_TSC,
+    POC_TS_PMU,
+    POC_TS_N_SOURCES
+} PocTsSource;
+
+#ifndef POC_TS_SOURCE
+#define POC_TS_SOURCE POC_TS_MACH
+#endif
+
+static inline uint64_t poc_ts_mach(void) { return mach_absolute_time(); }
+
+static inline uint64_t poc_ts_cntvct(void) {
+#if defined(__aarch64__)
+    uint64_t v;
+    __asm__ volatile("mrs %0, CNTVCT_EL0" : "=r"(v));
+    return v;
+#else
+    return 0;
+#endif
+}
+
+static inline uint64_t poc_ts_cntvct_isb(void) {
+#if defined(__aarch64__)
+    uint64_t v;
+    __asm__ volatile("isb\nmrs %0, CNTVCT_EL0" : "=r"(v) : : "memory");
+    return v;
+#else
+    return 0;
+#endif
+}
+
+static inline uint64_t poc_ts_cntpct(void) {
+#if defined(__aarch64__)
+    uint64_t v;
+    __asm__ volatile("isb\nmrs %0, CNTPCT_EL0" : "=r"(v) : : "memory");
+    return v;
+#else
+    return 0;
+#endif
+}
+
+static inline uint64_t poc_ts_tsc(void) {
+#if defined(__x86_64__)
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+#else
+    return 0;
+#endif
+}
+
+// Thread cycle count via kperf; 0 until poc_ts_pmu_init() has succeeded.
+uint64_t poc_ts_pmu(void);
+
+// Load kperf and start the fixed cycle counter. 0, or -1 when not
+// permitted (not root, not macOS, framework missing).
+int poc_ts_pmu_init(void);
+
+// POC_TS_SOURCE names an enum constant, which the preprocessor cannot
+// compare (it would read as 0), so dispatch in C: the switch is on a
+// constant and folds to the one reader.
+static inline uint64_t poc_ts(void) {
+    switch (POC_TS_SOURCE) {
+    case POC_TS_CNTVCT:     return poc_ts_cntvct();
+    case POC_TS_CNTVCT_ISB: return poc_ts_cntvct_isb();
+    case POC_TS_CNTPCT:     return poc_ts_cntpct();
+    case POC_TS_TSC:        return poc_ts_tsc();
+    case POC_TS_PMU:        return poc_ts_pmu();
+    default:                return poc_ts_mach();
+    }
+}
+
+// Run-time dispatch, for benchmarks and sweeps.
+uint64_t poc_ts_read(PocTsSource src);
+const char *poc_ts_name(PocTsSource src);
+
+// 1 if the source exists on this target (CNTPCT may still trap; PMU needs
+// poc_ts_pmu_init()).
+int poc_ts_available(PocTsSource src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_TIME_H
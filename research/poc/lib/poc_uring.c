@@ -0,0 +1,214 @@
+// poc_uring.c — Minimal io_uring for the storage PoCs (Linux)
+
+#include "poc_uring.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+struct PocUring {
+    int fd;
+    unsigned sq_entries;
+    // Shared with the kernel; the tails we own, the heads it advances.
+    _Atomic unsigned *sq_head, *sq_tail, *cq_head, *cq_tail;
+    unsigned sq_mask, cq_mask;
+    unsigned *sq_array;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_ring, *cq_ring;
+    size_t sq_ring_len, cq_ring_len, sqes_len;
+    unsigned queued;      // SQEs since the last submit
+};
+
+static int sys_setup(unsigned entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+int poc_uring_available(void) {
+    static int avail = -1;
+    if (avail < 0) {
+        PocUring *u = poc_uring_open(1);
+        avail = u != NULL;
+        poc_uring_close(u);
+    }
+    return avail;
+}
+
+PocUring *poc_uring_open(unsigned entries) {
+    PocUring *u = calloc(1, sizeof(*u));
+    if (!u) return NULL;
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    u->fd = sys_setup(entries, &p);
+    if (u->fd < 0) {
+        free(u);
+        return NULL;
+    }
+
+    u->sq_ring_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    u->cq_ring_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (u->cq_ring_len > u->sq_ring_len) u->sq_ring_len = u->cq_ring_len;
+        u->cq_ring_len = 0;
+    }
+    u->sq_ring = mmap(NULL, u->sq_ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      u->fd, IORING_OFF_SQ_RING);
+    u->cq_ring = u->sq_ring;
+    if (u->sq_ring != MAP_FAILED && u->cq_ring_len)
+        u->cq_ring = mmap(NULL, u->cq_ring_len, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_CQ_RING);
+    u->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+    u->sqes = mmap(NULL, u->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->fd,
+                   IORING_OFF_SQES);
+    if (u->sq_ring == MAP_FAILED || u->cq_ring == MAP_FAILED || u->sqes == MAP_FAILED) {
+        if (u->sqes != MAP_FAILED) munmap(u->sqes, u->sqes_len);
+        if (u->cq_ring_len && u->cq_ring != MAP_FAILED) munmap(u->cq_ring, u->cq_ring_len);
+        if (u->sq_ring != MAP_FAILED) munmap(u->sq_ring, u->sq_ring_len);
+        close(u->fd);
+        free(u);
+        return NULL;
+    }
+
+    char *sq = u->sq_ring, *cq = u->cq_ring;
+    u->sq_entries = p.sq_entries;
+    u->sq_head = (_Atomic unsigned *)(sq + p.sq_off.head);
+    u->sq_tail = (_Atomic unsigned *)(sq + p.sq_off.tail);
+    u->sq_mask = *(unsigned *)(sq + p.sq_off.ring_mask);
+    u->sq_array = (unsigned *)(sq + p.sq_off.array);
+    u->cq_head = (_Atomic unsigned *)(cq + p.cq_off.head);
+    u->cq_tail = (_Atomic unsigned *)(cq + p.cq_off.tail);
+    u->cq_mask = *(unsigned *)(cq + p.cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    return u;
+}
+
+void poc_uring_close(PocUring *u) {
+    if (!u) return;
+    munmap(u->sqes, u->sqes_len);
+    if (u->cq_ring_len) munmap(u->cq_ring, u->cq_ring_len);
+    munmap(u->sq_ring, u->sq_ring_len);
+    close(u->fd);
+    free(u);
+}
+
+static struct io_uring_sqe *next_sqe(PocUring *u) {
+    unsigned tail = atomic_load_explicit(u->sq_tail, memory_order_relaxed);
+    if (tail - atomic_load_explicit(u->sq_head, memory_order_acquire) >= u->sq_entries)
+        return NULL;
+    unsigned idx = tail & u->sq_mask;
+    struct io_uring_sqe *sqe = &u->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    u->sq_array[idx] = idx;
+    return sqe;
+}
+
+static void push_sqe(PocUring *u) {
+    unsigned tail = atomic_load_explicit(u->sq_tail, memory_order_relaxed);
+    atomic_store_explicit(u->sq_tail, tail + 1, memory_order_release);
+    u->queued++;
+}
+
+int poc_uring_read(PocUring *u, int fd, void *buf, size_t len, off_t off, uint64_t user_data) {
+    struct io_uring_sqe *sqe = next_sqe(u);
+    if (!sqe) return -1;
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = (uint32_t)len;
+    sqe->off = (uint64_t)off;
+    sqe->user_data = user_data;
+    push_sqe(u);
+    return 0;
+}
+
+int poc_uring_write(PocUring *u, int fd, const void *buf, size_t len, off_t off,
+                    uint64_t user_data, int link) {
+    struct io_uring_sqe *sqe = next_sqe(u);
+    if (!sqe) return -1;
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = (uint32_t)len;
+    sqe->off = (uint64_t)off;
+    sqe->flags = link ? IOSQE_IO_LINK : 0;
+    sqe->user_data = user_data;
+    push_sqe(u);
+    return 0;
+}
+
+int poc_uring_fsync(PocUring *u, int fd, uint64_t user_data) {
+    struct io_uring_sqe *sqe = next_sqe(u);
+    if (!sqe) return -1;
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fd = fd;
+    sqe->user_data = user_data;
+    push_sqe(u);
+    return 0;
+}
+
+int poc_uring_submit(PocUring *u, unsigned min_complete) {
+    int r;
+    do {
+        r = sys_enter(u->fd, u->queued, min_complete, min_complete ? IORING_ENTER_GETEVENTS : 0);
+    } while (r < 0 && errno == EINTR);
+    if (r < 0) return -1;
+    u->queued -= (unsigned)r < u->queued ? (unsigned)r : u->queued;
+    return r;
+}
+
+int poc_uring_reap(PocUring *u, PocUringCqe *out, int max) {
+    unsigned head = atomic_load_explicit(u->cq_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(u->cq_tail, memory_order_acquire);
+    int n = 0;
+    for (; head != tail && n < max; head++, n++) {
+        const struct io_uring_cqe *cqe = &u->cqes[head & u->cq_mask];
+        out[n] = (PocUringCqe){cqe->user_data, cqe->res};
+    }
+    atomic_store_explicit(u->cq_head, head, memory_order_release);
+    return n;
+}
+
+#else
+
+int poc_uring_available(void) { return 0; }
+PocUring *poc_uring_open(unsigned entries) { (void)entries; return NULL; }
+void poc_uring_close(PocUring *u) { (void)u; }
+
+int poc_uring_read(PocUring *u, int fd, void *buf, size_t len, off_t off, uint64_t user_data) {
+    (void)u; (void)fd; (void)buf; (void)len; (void)off; (void)user_data;
+    return -1;
+}
+
+int poc_uring_write(PocUring *u, int fd, const void *buf, size_t len, off_t off,
+                    uint64_t user_data, int link) {
+    (void)u; (void)fd; (void)buf; (void)len; (void)off; (void)user_data; (void)link;
+    return -1;
+}
+
+int poc_uring_fsync(PocUring *u, int fd, uint64_t user_data) {
+    (void)u; (void)fd; (void)user_data;
+    return -1;
+}
+
+int poc_uring_submit(PocUring *u, unsigned min_complete) {
+    (void)u; (void)min_complete;
+    return -1;
+}
+
+int poc_uring_reap(PocUring *u, PocUringCqe *out, int max) {
+    (void)u; (void)out; (void)max;
+    return 0;
+}
+
+#endif
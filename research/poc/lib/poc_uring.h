@@ -0,0 +1,56 @@
+// poc_uring.h — Minimal io_uring for the storage PoCs (Linux)
+//
+// Enough of io_uring(7) to keep many reads or write+fsync commits in
+// flight from one thread: queue SQEs without a syscall, then submit the
+// whole batch and wait for completions with one io_uring_enter(2). Raw
+// syscalls over <linux/io_uring.h>, so no liburing is needed. Elsewhere
+// poc_uring_open() returns NULL and poc_uring_available() 0.
+
+#ifndef POC_URING_H
+#define POC_URING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct PocUring PocUring;
+
+typedef struct {
+    uint64_t user_data;
+    int32_t res;          // bytes, 0, or -errno
+} PocUringCqe;
+
+// 1 when this kernel lets the process set up a ring.
+int poc_uring_available(void);
+
+// A ring of at least `entries` SQEs (and twice that many CQEs); NULL when
+// io_uring is unavailable.
+PocUring *poc_uring_open(unsigned entries);
+void poc_uring_close(PocUring *u);
+
+// Queue one operation for the next poc_uring_submit(). `link` chains it to
+// the next queued operation (IOSQE_IO_LINK): that one starts only after
+// this one succeeds, and is cancelled otherwise. 0, or -1 when the SQ is
+// full.
+int poc_uring_read(PocUring *u, int fd, void *buf, size_t len, off_t off, uint64_t user_data);
+int poc_uring_write(PocUring *u, int fd, const void *buf, size_t len, off_t off,
+                    uint64_t user_data, int link);
+int poc_uring_fsync(PocUring *u, int fd, uint64_t user_data);
+
+// Submit everything queued and wait until at least min_complete
+// completions are ready, in one io_uring_enter(2). Returns the number of
+// SQEs submitted, or -1.
+int poc_uring_submit(PocUring *u, unsigned min_complete);
+
+// Up to max ready completions; no syscall.
+int poc_uring_reap(PocUring *u, PocUringCqe *out, int max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_URING_H
@@ -0,0 +1,238 @@
+// poc_xcorr.c — FFT-based autocorrelation and lagged cross-correlation
+//
+// Both series are centred, zero-padded to a power of two N >= n + max_lag
+// (so circular wrap never reaches the lags we read), transformed, and
+// multiplied as conj(A)·B; the inverse transform then holds
+//   r[k] = Σ a[i]·b[i+k]   at index k (k >= 0) and N+k (k < 0).
+
+#include "poc_xcorr.h"
+#include "poc_stats.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__APPLE__)
+#include <Accelerate/Accelerate.h>
+#endif
+
+static int ceil_log2(int v) {
+    int l = 0;
+    while ((1 << l) < v) l++;
+    return l;
+}
+
+#if defined(__APPLE__)
+
+// vDSP packed real FFT: forward output is 2× the DFT, inverse is the
+// unnormalized IDFT, so r = IFFT(conj(A)·B) / (4N).
+static int fft_corr(const double *a, const double *b, int log2n, double *r) {
+    const int N = 1 << log2n, H = N / 2;
+    FFTSetupD setup = vDSP_create_fftsetupD((vDSP_Length)log2n, kFFTRadix2);
+    double *buf = malloc(sizeof(double) * 2 * N);
+    if (!setup || !buf) {
+        if (setup) vDSP_destroy_fftsetupD(setup);
+        free(buf);
+        return -1;
+    }
+    DSPDoubleSplitComplex A = {buf, buf + H};
+    DSPDoubleSplitComplex B = {buf + N, buf + N + H};
+
+    vDSP_ctozD((const DSPDoubleComplex *)a, 2, &A, 1, (vDSP_Length)H);
+    vDSP_fft_zripD(setup, &A, 1, (vDSP_Length)log2n, FFT_FORWARD);
+    if (b != a) {
+        vDSP_ctozD((const DSPDoubleComplex *)b, 2, &B, 1, (vDSP_Length)H);
+        vDSP_fft_zripD(setup, &B, 1, (vDSP_Length)log2n, FFT_FORWARD);
+    } else {
+        memcpy(B.realp, A.realp, sizeof(double) * H);
+        memcpy(B.imagp, A.imagp, sizeof(double) * H);
+    }
+
+    // DC and Nyquist are packed as reals in realp[0] / imagp[0].
+    double dc = A.realp[0] * B.realp[0];
+    double ny = A.imagp[0] * B.imagp[0];
+    vDSP_zvmulD(&A, 1, &B, 1, &A, 1, (vDSP_Length)H, -1);
+    A.realp[0] = dc;
+    A.imagp[0] = ny;
+
+    vDSP_fft_zripD(setup, &A, 1, (vDSP_Length)log2n, FFT_INVERSE);
+    vDSP_ztocD(&A, 1, (DSPDoubleComplex *)r, 2, (vDSP_Length)H);
+    double scale = 1.0 / (4.0 * N);
+    vDSP_vsmulD(r, 1, &scale, r, 1, (vDSP_Length)N);
+
+    vDSP_destroy_fftsetupD(setup);
+    free(buf);
+    return 0;
+}
+
+#else
+
+// In-place iterative radix-2 complex FFT; inverse when sign = +1.
+static void fft_radix2(double *re, double *im, int N, int sign) {
+    for (int i = 1, j = 0; i < N; i++) {
+        int bit = N >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (int len = 2; len <= N; len <<= 1) {
+        double ang = sign * 2.0 * M_PI / len;
+        double wr = cos(ang), wi = sin(ang);
+        for (int i = 0; i < N; i += len) {
+            double cr = 1, ci = 0;
+            for (int k = 0; k < len / 2; k++) {
+                int u = i + k, v = i + k + len / 2;
+                double xr = re[v] * cr - im[v] * ci;
+                double xi = re[v] * ci + im[v] * cr;
+                re[v] = re[u] - xr; im[v] = im[u] - xi;
+                re[u] += xr;        im[u] += xi;
+                double nr = cr * wr - ci * wi;
+                ci = cr * wi + ci * wr;
+                cr = nr;
+            }
+        }
+    }
+}
+
+// Real a and b share one complex FFT: z = a + i·b, then
+// A[f] = (Z[f] + conj Z[N-f]) / 2, B[f] = (Z[f] − conj Z[N-f]) / 2i.
+static int fft_corr(const double *a, const double *b, int log2n, double *r) {
+    const int N = 1 << log2n;
+    double *re = malloc(sizeof(double) * N), *im = malloc(sizeof(double) * N);
+    double *pr = malloc(sizeof(double) * N), *pi = malloc(sizeof(double) * N);
+    if (!re || !im || !pr || !pi) {
+        free(re); free(im); free(pr); free(pi);
+        return -1;
+    }
+    memcpy(re, a, sizeof(double) * N);
+    memcpy(im, b, sizeof(double) * N);
+    fft_radix2(re, im, N, -1);
+
+    for (int f = 0; f < N; f++) {
+        int g = (N - f) & (N - 1);
+        double ar = 0.5 * (re[f] + re[g]), ai = 0.5 * (im[f] - im[g]);
+        double br = 0.5 * (im[f] + im[g]), bi = -0.5 * (re[f] - re[g]);
+        // conj(A) · B
+        pr[f] = ar * br + ai * bi;
+        pi[f] = ar * bi - ai * br;
+    }
+    fft_radix2(pr, pi, N, +1);
+    for (int i = 0; i < N; i++) r[i] = pr[i] / N;
+
+    free(re); free(im); free(pr); free(pi);
+    return 0;
+}
+
+#endif
+
+// Centre x into a zero-padded buffer of length N, return Σ (x − mean)².
+static double centre_u64(const uint64_t *x, int n, double *out, int N) {
+    double mean, var;
+    poc_mean_var(x, n, &mean, &var);
+    const uint64_t k = x[0];
+    const double c = mean - (double)k;
+    for (int i = 0; i < n; i++) out[i] = (double)(int64_t)(x[i] - k) - c;
+    memset(out + n, 0, sizeof(double) * (N - n));
+    return var * n;
+}
+
+static double centre_f64(const double *x, int n, double *out, int N) {
+    double mean = 0;
+    for (int i = 0; i < n; i++) mean += x[i];
+    mean /= n;
+    double e = 0;
+    for (int i = 0; i < n; i++) {
+        out[i] = x[i] - mean;
+        e += out[i] * out[i];
+    }
+    memset(out + n, 0, sizeof(double) * (N - n));
+    return e;
+}
+
+int poc_acf(const uint64_t *x, int n, int max_lag, double *acf) {
+    if (max_lag < 0) return 0;
+    memset(acf, 0, sizeof(double) * (max_lag + 1));
+    if (n <= 1) return 0;
+    int L = max_lag < n ? max_lag : n - 1;
+    int log2n = ceil_log2(n + L);
+    int N = 1 << log2n;
+
+    double *c = malloc(sizeof(double) * N), *r = malloc(sizeof(double) * N);
+    if (!c || !r) { free(c); free(r); return -1; }
+    double e = centre_u64(x, n, c, N);
+    int rc = 0;
+    if (e >= 1e-15 && (rc = fft_corr(c, c, log2n, r)) == 0) {
+        for (int k = 0; k <= L; k++) acf[k] = r[k] / e;
+        acf[0] = 1;
+    }
+    free(c); free(r);
+    return rc;
+}
+
+static int xcorr_centred(double *ca, double ea, double *cb, double eb,
+                         int n, int max_lag, int log2n, double *xc) {
+    const int N = 1 << log2n;
+    if (ea < 1e-15 || eb < 1e-15) return 0;
+    double *r = malloc(sizeof(double) * N);
+    if (!r) return -1;
+    int rc = fft_corr(ca, cb, log2n, r);
+    if (rc == 0) {
+        double norm = 1.0 / sqrt(ea * eb);
+        int L = max_lag < n ? max_lag : n - 1;
+        for (int k = -L; k <= L; k++)
+            xc[max_lag + k] = r[k >= 0 ? k : N + k] * norm;
+    }
+    free(r);
+    return rc;
+}
+
+int poc_xcorr(const uint64_t *a, const uint64_t *b, int n, int max_lag, double *xc) {
+    if (max_lag < 0) return 0;
+    memset(xc, 0, sizeof(double) * (2 * max_lag + 1));
+    if (n <= 1) return 0;
+    int L = max_lag < n ? max_lag : n - 1;
+    int log2n = ceil_log2(n + L);
+    int N = 1 << log2n;
+
+    double *ca = malloc(sizeof(double) * N), *cb = malloc(sizeof(double) * N);
+    if (!ca || !cb) { free(ca); free(cb); return -1; }
+    double ea = centre_u64(a, n, ca, N);
+    double eb = centre_u64(b, n, cb, N);
+    int rc = xcorr_centred(ca, ea, cb, eb, n, max_lag, log2n, xc);
+    free(ca); free(cb);
+    return rc;
+}
+
+int poc_xcorr_f64(const double *a, const double *b, int n, int max_lag, double *xc) {
+    if (max_lag < 0) return 0;
+    memset(xc, 0, sizeof(double) * (2 * max_lag + 1));
+    if (n <= 1) return 0;
+    int L = max_lag < n ? max_lag : n - 1;
+    int log2n = ceil_log2(n + L);
+    int N = 1 << log2n;
+
+    double *ca = malloc(sizeof(double) * N), *cb = malloc(sizeof(double) * N);
+    if (!ca || !cb) { free(ca); free(cb); return -1; }
+    double ea = centre_f64(a, n, ca, N);
+    double eb = centre_f64(b, n, cb, N);
+    int rc = xcorr_centred(ca, ea, cb, eb, n, max_lag, log2n, xc);
+    free(ca); free(cb);
+    return rc;
+}
+
+PocLagPeak poc_acf_peak(const double *acf, int max_lag) {
+    PocLagPeak p = {0, 0};
+    for (int k = 1; k <= max_lag; k++)
+        if (fabs(acf[k]) > fabs(p.r)) { p.lag = k; p.r = acf[k]; }
+    return p;
+}
+
+PocLagPeak poc_xcorr_peak(const double *xc, int max_lag) {
+    PocLagPeak p = {0, xc[max_lag]};
+    for (int k = -max_lag; k <= max_lag; k++)
+        if (fabs(xc[max_lag + k]) > fabs(p.r)) { p.lag = k; p.r = xc[max_lag + k]; }
+    return p;
+}
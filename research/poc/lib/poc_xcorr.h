@@ -0,0 +1,45 @@
+// poc_xcorr.h — FFT-based autocorrelation and lagged cross-correlation
+//
+// autocorrelation() and pearson() cost O(n) per lag, so sweeping lags is
+// O(n·L). These compute the whole function in O(n log n) — via Accelerate
+// vDSP on macOS, a radix-2 FFT elsewhere — so lags up to thousands can be
+// screened for periodic coupling (scheduler ticks, DVFS steps) in one pass.
+
+#ifndef POC_XCORR_H
+#define POC_XCORR_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Default lag range for the long-range periodicity screen.
+#define ACF_SCREEN_LAG 4096
+
+typedef struct {
+    int lag;
+    double r;
+} PocLagPeak;
+
+// acf[0..max_lag], normalized exactly like autocorrelation(): acf[0] = 1,
+// lags >= n are 0. Returns 0 on success, -1 on allocation failure.
+int poc_acf(const uint64_t *x, int n, int max_lag, double *acf);
+
+// xc[0..2*max_lag] where xc[max_lag + k] is the Pearson-normalized
+// correlation of a[i] with b[i + k], k in [-max_lag, max_lag]; xc[max_lag]
+// equals pearson(a, b, n). Returns 0 on success, -1 on allocation failure.
+int poc_xcorr(const uint64_t *a, const uint64_t *b, int n, int max_lag, double *xc);
+int poc_xcorr_f64(const double *a, const double *b, int n, int max_lag, double *xc);
+
+// Largest |r| over acf[1..max_lag].
+PocLagPeak poc_acf_peak(const double *acf, int max_lag);
+
+// Largest |r| over xc[0..2*max_lag]; lag is reported as k (may be negative).
+PocLagPeak poc_xcorr_peak(const double *xc, int max_lag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POC_XCORR_H
@@ -15,15 +15,14 @@
 #include <mach/mach_time.h>
 #include <sys/mman.h>
 
+#include "lib/poc_arena.h"
+
+#define POC_TS_SOURCE POC_TS_CNTVCT_ISB
+#include "lib/poc_time.h"
+
 #define N_SAMPLES 20000
 #define ARRAY_SIZE (16 * 1024 * 1024)  // 16MB — larger than SLC
 
-static inline uint64_t read_counter(void) {
-    uint64_t val;
-    __asm__ volatile("isb\nmrs %0, CNTVCT_EL0" : "=r"(val));
-    return val;
-}
-
 static inline void memory_barrier(void) {
     __asm__ volatile("dmb sy" ::: "memory");
 }
@@ -37,26 +36,18 @@ int main(void) {
 
     // Allocate a large array that looks like pointers to the DMP
     // The DMP tries to dereference VALUES it sees in memory
-    uint64_t *array = mmap(NULL, ARRAY_SIZE, PROT_READ | PROT_WRITE,
-                           MAP_PRIVATE | MAP_ANON, -1, 0);
-    if (array == MAP_FAILED) {
+    // Filled with values that look like valid pointers within the array but
+    // point to random cache lines — the DMP will try to prefetch these "pointers"
+    uint64_t lcg = mach_absolute_time() | 1;
+    PocArena arena;
+    if (poc_arena_init(&arena, ARRAY_SIZE, lcg) != 0) {
         perror("mmap");
         return 1;
     }
 
-    // Fill with values that look like valid pointers but point to different cache lines
-    // This maximizes DMP confusion — it will try to prefetch these "pointers"
-    uint64_t base = (uint64_t)array;
-    size_t n_elements = ARRAY_SIZE / sizeof(uint64_t);
-    uint64_t lcg = mach_absolute_time() | 1;
-
-    for (size_t i = 0; i < n_elements; i++) {
-        lcg = lcg * 6364136223846793005ULL + 1;
-        // Create values that look like pointers within the array
-        // but with enough randomness to confuse the DMP
-        size_t random_offset = (lcg >> 16) % n_elements;
-        array[i] = base + random_offset * sizeof(uint64_t);
-    }
+    uint64_t *array = arena.words;
+    uint64_t base = arena.base;
+    size_t n_elements = arena.n;
 
     // ===== TEST 1: DMP confusion — chase "pointers" in a confused pattern =====
     printf("=== Test 1: DMP Pointer-Chase Confusion ===\n");
@@ -70,7 +61,7 @@ int main(void) {
             size_t idx = (lcg >> 16) % (n_elements - 256);
 
             memory_barrier();
-            uint64_t t0 = read_counter();
+            uint64_t t0 = poc_ts();
 
             // Chase the "pointer" — the DMP will try to prefetch the target
             // but we immediately change direction, confusing it
@@ -87,7 +78,7 @@ int main(void) {
             sink += array[surprise];
 
             memory_barrier();
-            uint64_t t1 = read_counter();
+            uint64_t t1 = poc_ts();
             timings[i] = t1 - t0;
         }
 
@@ -156,10 +147,10 @@ int main(void) {
                 size_t idx = ((size_t)i * stride / sizeof(uint64_t)) % n_elements;
 
                 memory_barrier();
-                uint64_t t0 = read_counter();
+                uint64_t t0 = poc_ts();
                 sink += array[idx];
                 memory_barrier();
-                uint64_t t1 = read_counter();
+                uint64_t t1 = poc_ts();
                 timings[i] = t1 - t0;
             }
 
@@ -202,7 +193,7 @@ int main(void) {
             lcg = lcg * 6364136223846793005ULL + 1;
 
             memory_barrier();
-            uint64_t t0 = read_counter();
+            uint64_t t0 = poc_ts();
 
             if (i & 1) {
                 // Pointer-like pattern — DMP activates
@@ -218,7 +209,7 @@ int main(void) {
             }
 
             memory_barrier();
-            uint64_t t1 = read_counter();
+            uint64_t t1 = poc_ts();
             timings[i] = t1 - t0;
         }
 
@@ -248,6 +239,6 @@ int main(void) {
         munmap(data_array, 1024 * 1024);
     }
 
-    munmap(array, ARRAY_SIZE);
+    poc_arena_free(&arena);
     return 0;
 }
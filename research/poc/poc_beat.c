@@ -0,0 +1,160 @@
+// poc_beat.c — Per-domain and combined entropy of any beat pattern
+//
+// Runs domain-kernel patterns on the beat engine (lib/poc_beat.h) and
+// reports, for each domain in a pattern, its own Shannon / H∞ next to the
+// interleaved stream's. The interleaved stream is what a beat collector
+// returns. The registry's cpu_memory_beat, cpu_io_beat and
+// multi_domain_beat are the patterns "cpu,mem", "cpu,io" and
+// "cpu,mem,sys".
+//
+//   ./poc_beat [-n steps] pattern ...       e.g. cpu,mem*2,sys  shuffle:cpu,ipc,io
+//   ./poc_beat -s [-n steps] kind,kind,...  every subset of the kinds, one
+//                                           step each, ranked by H∞ × samples/s
+//
+// Kinds: cpu mem sys io ipc gpu. gpu needs a Metal device.
+//
+// Compile: make poc_beat
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "lib/poc_beat.h"
+
+#define DEFAULT_N 100000
+
+typedef struct {
+    char pattern[256];
+    int steps;
+    double samples_per_sec;
+    Stats combined;
+} BeatScore;
+
+static uint64_t *g_buf;
+static double g_ns_per_tick;
+
+static int usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [-n steps] pattern ... | -s [-n steps] kind,kind,...\n"
+                    "  pattern: [shuffle:]kind[*reps],...  kinds: cpu mem sys io ipc gpu\n",
+            argv0);
+    return 2;
+}
+
+static int gpu_ready(const PocBeatConfig *cfg) {
+    static int state;        // 0 untried, 1 ok, -1 unavailable
+    for (int s = 0; s < cfg->n_steps; s++)
+        if (cfg->steps[s] == POC_BEAT_GPU) {
+            if (state == 0) state = poc_gpu_beat_install() == 0 ? 1 : -1;
+            return state > 0;
+        }
+    return 1;
+}
+
+// One timed run; soa is optional. Returns the steps collected.
+static int score(const char *pattern, const PocBeatConfig *cfg, int n, PocBeatSamples *soa,
+                 BeatScore *out) {
+    memset(out, 0, sizeof(*out));
+    snprintf(out->pattern, sizeof(out->pattern), "%s", pattern);
+    poc_beat_run(cfg, g_buf, cfg->n_steps, NULL);   // warmup: faults, file, pipe
+    uint64_t ticks;
+    out->steps = poc_beat_run_timed(cfg, g_buf, n, soa, &ticks);
+    double secs = (double)ticks * g_ns_per_tick / 1e9;
+    out->samples_per_sec = secs > 0 ? out->steps / secs : 0;
+    if (out->steps > 0) out->combined = compute_stats(g_buf, out->steps);
+    return out->steps;
+}
+
+static int run_pattern(const char *pattern, int n) {
+    PocBeatConfig cfg;
+    PocBeatSamples soa;
+    BeatScore s;
+    poc_beat_defaults(&cfg);
+    if (poc_beat_parse(pattern, &cfg) != 0) {
+        fprintf(stderr, "bad pattern: %s\n", pattern);
+        return 2;
+    }
+    printf("## %s\n", pattern);
+    if (!gpu_ready(&cfg)) {
+        printf("  gpu: no Metal device\n\n");
+        return 1;
+    }
+    if (poc_beat_samples_alloc(&soa, &cfg, n) != 0) {
+        printf("  cannot allocate %d steps\n\n", n);
+        return 1;
+    }
+    if (score(pattern, &cfg, n, &soa, &s) == 0) {
+        printf("  a domain could not be set up\n\n");
+        poc_beat_samples_free(&soa);
+        return 1;
+    }
+    printf("  %-9s %9s %11s %8s %7s\n", "domain", "samples", "mean ns", "Shannon", "H∞");
+    for (int d = 0; d < soa.n_domains; d++) {
+        Stats st = compute_stats(soa.timings[d], soa.n[d]);
+        printf("  %-9s %9d %11.1f %8.3f %7.3f\n", poc_beat_kind_name(soa.kind[d]), soa.n[d],
+               st.mean * g_ns_per_tick, st.shannon, st.min_entropy);
+    }
+    printf("  %-9s %9d %11s %8.3f %7.3f   %.0f samples/s, H∞ × rate %.0f b/s\n\n", "combined",
+           s.steps, "", s.combined.shannon, s.combined.min_entropy, s.samples_per_sec,
+           s.combined.min_entropy * s.samples_per_sec);
+    poc_beat_samples_free(&soa);
+    return 0;
+}
+
+static int cmp_score(const void *a, const void *b) {
+    const BeatScore *x = a, *y = b;
+    double rx = x->combined.min_entropy * x->samples_per_sec;
+    double ry = y->combined.min_entropy * y->samples_per_sec;
+    return (rx < ry) - (rx > ry);
+}
+
+static int run_sweep(const char *kinds, int n) {
+    PocBeatConfig all;
+    poc_beat_defaults(&all);
+    if (poc_beat_parse(kinds, &all) != 0 || all.n_steps > POC_BEAT_N_KINDS) {
+        fprintf(stderr, "bad kind list: %s\n", kinds);
+        return 2;
+    }
+    BeatScore scores[1 << POC_BEAT_N_KINDS];
+    int n_scores = 0;
+    for (int mask = 1; mask < 1 << all.n_steps; mask++) {
+        char pattern[256] = "";
+        for (int k = 0; k < all.n_steps; k++) {
+            if (!(mask >> k & 1)) continue;
+            size_t len = strlen(pattern);
+            snprintf(pattern + len, sizeof(pattern) - len, "%s%s", len ? "," : "",
+                     poc_beat_kind_name(all.steps[k]));
+        }
+        PocBeatConfig cfg = all;
+        poc_beat_parse(pattern, &cfg);
+        if (!gpu_ready(&cfg)) continue;
+        if (score(pattern, &cfg, n, NULL, &scores[n_scores]) > 0) n_scores++;
+    }
+    qsort(scores, (size_t)n_scores, sizeof(scores[0]), cmp_score);
+    printf("%-32s %9s %12s %7s %12s\n", "pattern", "steps", "samples/s", "H∞", "H∞ b/s");
+    for (int i = 0; i < n_scores; i++)
+        printf("%-32s %9d %12.0f %7.3f %12.0f\n", scores[i].pattern, scores[i].steps,
+               scores[i].samples_per_sec, scores[i].combined.min_entropy,
+               scores[i].combined.min_entropy * scores[i].samples_per_sec);
+    return n_scores > 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    int n = DEFAULT_N, sweep = 0, i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-s") == 0) sweep = 1;
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n = atoi(argv[++i]);
+        else return usage(argv[0]);
+    }
+    if (i == argc || n < POC_BEAT_MAX_STEPS || (sweep && argc - i != 1)) return usage(argv[0]);
+
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    g_ns_per_tick = (double)tb.numer / tb.denom;
+    g_buf = malloc(sizeof(uint64_t) * (size_t)n);
+    if (!g_buf) return 1;
+
+    int rc = 0;
+    if (sweep) rc = run_sweep(argv[i], n);
+    else
+        for (; i < argc; i++) rc |= run_pattern(argv[i], n);
+    free(g_buf);
+    return rc;
+}
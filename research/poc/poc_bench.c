@@ -0,0 +1,225 @@
+// poc_bench.c — Throughput benchmark over the collector registry
+//
+// For each collector and batch size: ns/sample (p50/p99 over repeated
+// batches), samples/sec, and H∞ × samples/sec — the min-entropy rate we
+// actually pick production sources by. Writes a poc_bench_v1 JSON file
+// that `openentropy bench --poc-json <file>` ranks next to the Rust sources.
+//
+//   ./poc_bench [-o poc_bench.json] [-t seconds] [-L load,...] [name ...]
+//
+// -t is the time budget per (collector, batch size); the default is 1s.
+// -L repeats the whole benchmark under each background load
+// (lib/poc_load.h: a profile name such as mem, fpu-25, gpu, or
+// kind:threads:duty). The load starts before the collector's warmup and
+// stops after its last batch, and every JSON entry records its "load".
+// Samples are XOR-folded to one byte each (compute_stats), so H∞ is in
+// bits per byte-sample and samples/sec is directly comparable to the
+// bytes/sec the Rust bench reports.
+//
+// Compile: make poc_bench   (or `make bench` to build and run it)
+
+#include <time.h>
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "lib/poc_load.h"
+
+#define BENCH_POOL_N   65536  // samples kept per batch size for H∞
+#define BENCH_MIN_REPS 5
+#define BENCH_MAX_REPS 1000
+#define BENCH_MAX_LOADS 16
+#define LOAD_RAMP_US   20000  // let the load reach steady state first
+
+static const int BATCHES[] = {64, 1024, 16384};
+#define N_BATCHES ((int)(sizeof(BATCHES) / sizeof(BATCHES[0])))
+
+typedef struct {
+    int batch;
+    int reps;
+    int failed_reps;
+    long long samples;
+    double ns_p50, ns_p99;
+    double samples_per_sec;
+    double shannon, min_entropy;
+} BenchResult;
+
+static uint64_t g_pool[BENCH_POOL_N];
+static uint64_t g_scratch[16384];
+static double g_ns[BENCH_MAX_REPS];
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, int n, double p) {
+    int i = (int)(p * (n - 1) + 0.5);
+    return sorted[i < n ? i : n - 1];
+}
+
+static BenchResult bench_batch(const PocCollector *c, int batch, double budget_sec,
+                               double ns_per_tick) {
+    BenchResult r = {.batch = batch};
+    int pooled = 0;
+    uint64_t ticks = 0;
+    const uint64_t budget = (uint64_t)(budget_sec * 1e9 / ns_per_tick);
+
+    while (r.reps + r.failed_reps < BENCH_MAX_REPS) {
+        // Fill the H∞ pool first, then keep timing into scratch.
+        uint64_t *dst = pooled + batch <= BENCH_POOL_N ? g_pool + pooled : g_scratch;
+        uint64_t t0 = mach_absolute_time();
+        int v = poc_collect(c, dst, batch);
+        uint64_t t1 = mach_absolute_time();
+        ticks += t1 - t0;
+
+        if (v <= 0) {
+            r.failed_reps++;
+        } else {
+            g_ns[r.reps++] = (double)(t1 - t0) * ns_per_tick / v;
+            r.samples += v;
+            if (dst != g_scratch) pooled += v;
+        }
+        if (r.reps >= BENCH_MIN_REPS && ticks >= budget) break;
+        if (r.reps == 0 && r.failed_reps >= BENCH_MIN_REPS) break;
+    }
+
+    if (r.reps > 0) {
+        qsort(g_ns, r.reps, sizeof(double), cmp_double);
+        r.ns_p50 = percentile(g_ns, r.reps, 0.50);
+        r.ns_p99 = percentile(g_ns, r.reps, 0.99);
+        double secs = (double)ticks * ns_per_tick / 1e9;
+        r.samples_per_sec = secs > 0 ? r.samples / secs : 0;
+        Stats s = compute_stats(g_pool, pooled);
+        r.shannon = s.shannon;
+        r.min_entropy = s.min_entropy;
+    }
+    return r;
+}
+
+static void write_json_batch(FILE *f, const BenchResult *r, int last) {
+    fprintf(f, "        {\"batch\": %d, \"reps\": %d, \"failed_reps\": %d, \"samples\": %lld, "
+               "\"ns_per_sample_p50\": %.3f, \"ns_per_sample_p99\": %.3f, "
+               "\"samples_per_sec\": %.3f, \"shannon\": %.4f, \"min_entropy\": %.4f, "
+               "\"min_entropy_bits_per_sec\": %.3f}%s\n",
+            r->batch, r->reps, r->failed_reps, r->samples, r->ns_p50, r->ns_p99,
+            r->samples_per_sec, r->shannon, r->min_entropy,
+            r->min_entropy * r->samples_per_sec, last ? "" : ",");
+}
+
+static void bench_collector(const PocCollector *c, FILE *f, const char *load, int comma,
+                            double budget_sec, double ns_per_tick) {
+    const int cap = c->large_n ? c->large_n : LARGE_N;
+
+    // One warmup, as in the validation harness.
+    poc_collect(c, g_scratch, cap < 1024 ? cap : 1024);
+
+    BenchResult res[N_BATCHES];
+    int n_res = 0;
+    for (int b = 0; b < N_BATCHES; b++) {
+        // Capped sources (spawn/ioreg) run one batch at their cap.
+        int batch = BATCHES[b] < cap ? BATCHES[b] : cap;
+        if (n_res > 0 && res[n_res - 1].batch == batch) break;
+        res[n_res] = bench_batch(c, batch, budget_sec, ns_per_tick);
+        const BenchResult *r = &res[n_res++];
+        if (load) printf("%-8s ", b == 0 ? load : "");
+        printf("%-24s %6d %10.1f %10.1f %12.0f %7.3f %12.0f%s\n",
+               b == 0 ? c->name : "", r->batch, r->ns_p50, r->ns_p99,
+               r->samples_per_sec, r->min_entropy, r->min_entropy * r->samples_per_sec,
+               r->reps == 0 ? "  (no samples)" : "");
+    }
+    if (c->release) c->release();
+
+    fprintf(f, "%s    {\"name\": \"%s\", ", comma ? ",\n" : "", c->name);
+    if (load) fprintf(f, "\"load\": \"%s\", ", load);
+    fprintf(f, "\"batches\": [\n");
+    for (int k = 0; k < n_res; k++) write_json_batch(f, &res[k], k == n_res - 1);
+    fprintf(f, "    ]}");
+    fflush(stdout);
+}
+
+static int usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [-o out.json] [-t seconds] [-L load,...] [name ...]\n", argv0);
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    const char *out_path = "poc_bench.json";
+    double budget_sec = 1.0;
+    PocLoadProfile loads[BENCH_MAX_LOADS] = {poc_load_profiles[0]};
+    int n_loads = 1, with_load = 0, first = 1;
+    while (first < argc && argv[first][0] == '-') {
+        if (strcmp(argv[first], "-o") == 0 && first + 1 < argc) {
+            out_path = argv[first + 1];
+        } else if (strcmp(argv[first], "-t") == 0 && first + 1 < argc) {
+            budget_sec = atof(argv[first + 1]);
+        } else if (strcmp(argv[first], "-L") == 0 && first + 1 < argc) {
+            n_loads = 0;
+            with_load = 1;
+            for (char *tok = strtok(argv[first + 1], ","); tok; tok = strtok(NULL, ",")) {
+                if (n_loads == BENCH_MAX_LOADS || poc_load_parse(tok, &loads[n_loads]) != 0) {
+                    fprintf(stderr, "bad load: %s\n", tok);
+                    return 2;
+                }
+                if (loads[n_loads].kind == POC_LOAD_GPU) poc_gpu_load_install();
+                n_loads++;
+            }
+            if (n_loads == 0) return usage(argv[0]);
+        } else {
+            return usage(argv[0]);
+        }
+        first += 2;
+    }
+    if (budget_sec <= 0) return usage(argv[0]);
+    poc_params_apply_env();
+
+    const PocCollector *sel[64];
+    int n_sel = 0;
+    if (first == argc) {
+        for (int i = 0; i < poc_n_collectors && n_sel < 64; i++) sel[n_sel++] = &poc_collectors[i];
+    } else {
+        for (int i = first; i < argc && n_sel < 64; i++) {
+            const PocCollector *c = poc_collector_find(argv[i]);
+            if (!c) {
+                fprintf(stderr, "unknown collector: %s (see `poc_runner list`)\n", argv[i]);
+                return 2;
+            }
+            sel[n_sel++] = c;
+        }
+    }
+
+    FILE *f = fopen(out_path, "w");
+    if (!f) {
+        perror(out_path);
+        return 1;
+    }
+
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    const double ns_per_tick = (double)tb.numer / tb.denom;
+
+    fprintf(f, "{\n  \"schema\": \"poc_bench_v1\",\n  \"generated_unix\": %lld,\n"
+               "  \"ns_per_tick\": %.4f,\n  \"budget_sec\": %.3f,\n  \"collectors\": [\n",
+            (long long)time(NULL), ns_per_tick, budget_sec);
+
+    if (with_load) printf("%-8s ", "Load");
+    printf("%-24s %6s %10s %10s %12s %7s %12s\n",
+           "Collector", "Batch", "ns p50", "ns p99", "samples/s", "H_inf", "H_inf b/s");
+    int written = 0;
+    for (int k = 0; k < n_loads; k++) {
+        for (int i = 0; i < n_sel; i++) {
+            PocLoad load;
+            if (poc_load_start(&load, &loads[k]) != 0) {
+                fprintf(stderr, "load %s: cannot start\n", loads[k].name);
+                break;
+            }
+            if (loads[k].kind != POC_LOAD_NONE) usleep(LOAD_RAMP_US);
+            bench_collector(sel[i], f, with_load ? loads[k].name : NULL, written++ > 0,
+                            budget_sec, ns_per_tick);
+            poc_load_stop(&load);
+        }
+    }
+    fprintf(f, "\n  ]\n}\n");
+    fclose(f);
+    printf("\nWrote %s\n", out_path);
+    return 0;
+}
@@ -0,0 +1,100 @@
+// poc_bitprofile.c — Which bits of a collector's timing word carry entropy
+//
+// Collects -n samples from each named registry collector and profiles all
+// 64 bit positions (lib/poc_bitprofile.h): P(1), per-bit H∞, lag-1 r, and
+// the strongest phi against another bit. Then it picks the extraction mask
+// and compares its bits/sample with the XOR-fold byte H∞ every collector
+// reports today:
+//
+//   ./poc_bitprofile [-n samples] [--delta] name ...
+//
+// --delta profiles first differences instead of the raw durations.
+// bits/sample is the smaller of Σ per-bit H∞ and, for masks of up to 16
+// bits, the H∞ of the packed value; with fewer samples than 2^bits the
+// joint figure reads high, so profile at least that many.
+//
+// Compile: make poc_bitprofile
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "lib/poc_bitprofile.h"
+
+#define DEFAULT_N 100000
+
+static PocBitProfile g_prof;
+
+static void profile_one(const PocCollector *c, uint64_t *buf, int n, int delta) {
+    printf("## %s\n", c->name);
+    poc_collect(c, buf, n / 10 > 0 ? n / 10 : 1);   // warmup
+    int got = poc_collect(c, buf, n);
+    if (c->release) c->release();
+    if (got < POC_MIN_VALID || poc_bitprofile(buf, got, delta, &g_prof) != 0) {
+        printf("  only %d samples\n\n", got);
+        return;
+    }
+    Stats fold = delta ? compute_stats_delta_xorfold(buf, got) : compute_stats(buf, got);
+
+    printf("  %3s  %7s  %6s  %7s  %s\n", "bit", "P(1)", "H∞", "lag-1 r", "max |phi|");
+    for (int b = 63; b >= 0; b--) {
+        if (!(g_prof.varying >> b & 1)) continue;
+        int partner = -1;
+        double best = 0;
+        for (int o = 0; o < 64; o++)
+            if (o != b && fabs(g_prof.phi[b][o]) > best) {
+                best = fabs(g_prof.phi[b][o]);
+                partner = o;
+            }
+        printf("  %3d  %7.4f  %6.3f  %7.4f  ", b, g_prof.p1[b], g_prof.h[b], g_prof.lag1[b]);
+        if (partner >= 0) printf("%.4f (bit %d)\n", best, partner);
+        else printf("-\n");
+    }
+    int constant = 64 - __builtin_popcountll(g_prof.varying);
+    printf("  (%d constant bit%s omitted)\n", constant, constant == 1 ? "" : "s");
+
+    PocBitMask m = poc_bitprofile_mask(&g_prof, buf, got, delta);
+    printf("  mask 0x%016llx  %d bits  Σ H∞=%.3f", (unsigned long long)m.mask, m.bits, m.h_sum);
+    if (m.h_joint >= 0) printf("  joint H∞=%.3f", m.h_joint);
+    printf("\n  -> %.3f bits/sample vs XOR-fold H∞ %.3f", m.bits_per_sample, fold.min_entropy);
+    if (fold.min_entropy > 0) printf(" (%.2f×)", m.bits_per_sample / fold.min_entropy);
+    printf("\n\n");
+}
+
+static int usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [-n samples] [--delta] name ...\n", argv0);
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    int n = DEFAULT_N, delta = 0, first = 1;
+    while (first < argc && argv[first][0] == '-') {
+        if (strcmp(argv[first], "--delta") == 0) {
+            delta = 1;
+            first++;
+        } else if (strcmp(argv[first], "-n") == 0 && first + 1 < argc) {
+            n = atoi(argv[first + 1]);
+            first += 2;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (first == argc || n < POC_MIN_VALID) return usage(argv[0]);
+
+    poc_params_apply_env();
+    uint64_t *buf = malloc((size_t)n * sizeof(uint64_t));
+    if (!buf) return 1;
+    printf("# Bit-position entropy profile — %d samples%s, mask needs H∞ ≥ %.2f, "
+           "|r|, |phi| ≤ %.2f\n\n", n, delta ? " (first differences)" : "", POC_BIT_MIN_H,
+           POC_BIT_MAX_CORR);
+    int rc = 0;
+    for (int i = first; i < argc; i++) {
+        const PocCollector *c = poc_collector_find(argv[i]);
+        if (!c) {
+            fprintf(stderr, "unknown collector: %s (see `poc_runner list`)\n", argv[i]);
+            rc = 2;
+            continue;
+        }
+        profile_one(c, buf, n, delta);
+    }
+    free(buf);
+    return rc;
+}
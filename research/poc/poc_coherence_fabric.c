@@ -18,18 +18,58 @@
  * This is NOT the same as our existing cache_contention source, which
  * measures L1/L2 miss patterns. This measures the COHERENCE PROTOCOL
  * specifically — the inter-cluster communication fabric.
+ *
+ * --matrix runs every ordered core pair: two fresh threads, one placed on
+ * each core, ping-pong a single padded line for a fixed number of round
+ * trips, and each round trip is one sample. Cores are numbered P first,
+ * then E. On Linux threads are pinned to the CPU; macOS has no pinning, so
+ * each gets a distinct affinity tag and the QoS class of its core type
+ * (USER_INTERACTIVE for P, BACKGROUND for E) — which cluster is reliable,
+ * which core within it is a scheduler hint. The output is a latency matrix
+ * (ns per round trip), an H∞ matrix (XOR-folded round-trip ticks), the
+ * P↔P / P↔E / E↔E averages and the pairs with the most H∞ per round trip.
+ *
+ *   ./poc_coherence_fabric                          two-thread 64-line bounce
+ *   ./poc_coherence_fabric --matrix [-r N] [-c K]   N×N pairs, N round trips
+ *                                                   per pair (default 20000),
+ *                                                   first K cores only
  */
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 #include <mach/mach_time.h>
 #include <math.h>
 
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/sysctl.h>
+#endif
+
+#include "lib/poc_place.h"
+#include "lib/poc_stats.h"
+
 #define CACHELINE_SIZE 128  // Apple Silicon uses 128-byte cache lines
 #define NUM_SAMPLES 10000
 #define NUM_LINES 64        // Number of cache lines to bounce
+#define MATRIX_ROUND_TRIPS 20000
+#define MATRIX_MAX_CORES 64
+#define MATRIX_TOP 8
+#define SPINS_BEFORE_YIELD (1 << 16)  // oversubscribed: let the peer run
+
+#if defined(__aarch64__)
+#define CPU_RELAX() __asm__ volatile("yield")
+#elif defined(__x86_64__)
+#define CPU_RELAX() __asm__ volatile("pause")
+#else
+#define CPU_RELAX() ((void)0)
+#endif
 
 // Cache-line-aligned shared data
 typedef struct __attribute__((aligned(128))) {
@@ -51,13 +91,13 @@ static void *bouncer_thread(void *arg) {
     bounce_data_t *data = (bounce_data_t *)arg;
 
     // Wait for start signal
-    while (!data->start) { __asm__ volatile("yield"); }
+    while (!data->start) { CPU_RELAX(); }
 
     int t = 0;
     while (!data->stop && t < data->timing_count) {
         // Wait for our turn (odd phase = this thread's turn)
         while ((*data->phase & 1) == 0 && !data->stop) {
-            __asm__ volatile("yield");
+            CPU_RELAX();
         }
         if (data->stop) break;
 
@@ -78,7 +118,225 @@ static void *bouncer_thread(void *arg) {
     return NULL;
 }
 
-int main() {
+// --- N×N matrix mode -----------------------------------------------------
+
+typedef struct {
+    aligned_line_t *line;
+    int core;
+    int p_cores;            // cores below this index are P cores
+    int initiator;          // 1: times round trips, 0: echoes
+    int round_trips;
+    uint64_t *timings;      // initiator only
+    volatile int *ready;
+} pingpong_t;
+
+static void wait_for(volatile uint64_t *v, uint64_t want) {
+    int spins = 0;
+    while (__atomic_load_n(v, __ATOMIC_ACQUIRE) != want) {
+        if (++spins < SPINS_BEFORE_YIELD) {
+            CPU_RELAX();
+        } else {
+            sched_yield();
+            spins = 0;
+        }
+    }
+}
+
+static void *pingpong_thread(void *arg) {
+    pingpong_t *pp = arg;
+    poc_place_apply(pp->core < pp->p_cores ? POC_QOS_USER_INTERACTIVE : POC_QOS_BACKGROUND,
+                    pp->core + 1);
+
+    // Both ends placed before the first round trip
+    __atomic_fetch_add(pp->ready, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(pp->ready, __ATOMIC_ACQUIRE) < 2) CPU_RELAX();
+
+    volatile uint64_t *v = &pp->line->value;
+    for (int r = 0; r < pp->round_trips; r++) {
+        uint64_t ping = 2 * (uint64_t)r + 1;
+        if (pp->initiator) {
+            uint64_t t0 = mach_absolute_time();
+            __atomic_store_n(v, ping, __ATOMIC_RELEASE);
+            wait_for(v, ping + 1);
+            pp->timings[r] = mach_absolute_time() - t0;
+        } else {
+            wait_for(v, ping);
+            __atomic_store_n(v, ping + 1, __ATOMIC_RELEASE);
+        }
+    }
+    return NULL;
+}
+
+// One ordered pair. Returns 0, or -1 if a thread could not start.
+static int run_pair(int a, int b, int p_cores, int round_trips, uint64_t *timings) {
+    aligned_line_t *line = aligned_alloc(CACHELINE_SIZE, sizeof(aligned_line_t));
+    if (!line) return -1;
+    memset(line, 0, sizeof(*line));
+
+    volatile int ready = 0;
+    pingpong_t ends[2] = {
+        {line, a, p_cores, 1, round_trips, timings, &ready},
+        {line, b, p_cores, 0, round_trips, NULL, &ready},
+    };
+    pthread_t tids[2];
+    int started = 0;
+    for (; started < 2; started++)
+        if (pthread_create(&tids[started], NULL, pingpong_thread, &ends[started]) != 0) break;
+    if (started < 2) {
+        // Release a lone initiator with a fake echo so it can be joined
+        if (started == 1) {
+            ends[1].initiator = 0;
+            ready = 2;
+            for (int r = 0; r < round_trips; r++) {
+                wait_for(&line->value, 2 * (uint64_t)r + 1);
+                __atomic_store_n(&line->value, 2 * (uint64_t)r + 2, __ATOMIC_RELEASE);
+            }
+            pthread_join(tids[0], NULL);
+        }
+        free(line);
+        return -1;
+    }
+    pthread_join(tids[0], NULL);
+    pthread_join(tids[1], NULL);
+    free(line);
+    return 0;
+}
+
+static int core_counts(int *p_cores) {
+#if defined(__APPLE__)
+    int p = 0, e = 0;
+    size_t len = sizeof(p);
+    if (sysctlbyname("hw.perflevel0.logicalcpu", &p, &len, NULL, 0) != 0) p = 0;
+    len = sizeof(e);
+    if (sysctlbyname("hw.perflevel1.logicalcpu", &e, &len, NULL, 0) != 0) e = 0;
+    if (p > 0) {
+        *p_cores = p;
+        return p + e;
+    }
+#endif
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    *p_cores = n > 0 ? (int)n : 1;
+    return *p_cores;
+}
+
+static const char *const pair_class_name[3] = {"P-P", "P-E", "E-E"};
+
+// 0 = P-P, 1 = P-E, 2 = E-E
+static int pair_class(int a, int b, int p_cores) {
+    return (a >= p_cores) + (b >= p_cores);
+}
+
+static void print_matrix(const char *title, const double *m, int n, int p_cores,
+                         const char *fmt) {
+    printf("\n%s (row = initiator, column = echo)\n      ", title);
+    for (int b = 0; b < n; b++) {
+        char label[8];
+        snprintf(label, sizeof(label), "%c%d", b < p_cores ? 'P' : 'E', b);
+        printf(" %6s", label);
+    }
+    printf("\n");
+    for (int a = 0; a < n; a++) {
+        printf("%c%-5d", a < p_cores ? 'P' : 'E', a);
+        for (int b = 0; b < n; b++) {
+            if (a == b) printf(" %6s", "-");
+            else printf(fmt, m[a * n + b]);
+        }
+        printf("\n");
+    }
+}
+
+static int run_matrix(int argc, char **argv) {
+    int round_trips = MATRIX_ROUND_TRIPS, limit = 0;
+    for (int i = 0; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-r") == 0) round_trips = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-c") == 0) limit = atoi(argv[i + 1]);
+    }
+    if (round_trips < 2) round_trips = 2;
+
+    int p_cores;
+    int n = core_counts(&p_cores);
+    if (limit > 0 && limit < n) n = limit;
+    if (n > MATRIX_MAX_CORES) n = MATRIX_MAX_CORES;
+    if (n < 2) {
+        fprintf(stderr, "Need at least two cores\n");
+        return 1;
+    }
+    if (p_cores > n) p_cores = n;
+
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    double ns_per_tick = (double)tb.numer / tb.denom;
+
+    printf("=== Core-to-core coherence matrix ===\n");
+    printf("%d cores (%d P, %d E), padded %d-byte line, %d round trips per pair\n",
+           n, p_cores, n - p_cores, CACHELINE_SIZE, round_trips);
+
+    double *lat = calloc((size_t)n * n, sizeof(double));
+    double *ent = calloc((size_t)n * n, sizeof(double));
+    uint64_t *timings = malloc((size_t)round_trips * sizeof(uint64_t));
+    if (!lat || !ent || !timings) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    double cls_h[3] = {0}, cls_ns[3] = {0};
+    int cls_n[3] = {0};
+    for (int a = 0; a < n; a++) {
+        for (int b = 0; b < n; b++) {
+            if (a == b) continue;
+            if (run_pair(a, b, p_cores, round_trips, timings) != 0) {
+                fprintf(stderr, "pair %d,%d: thread start failed\n", a, b);
+                continue;
+            }
+            Stats s = compute_stats(timings, round_trips);
+            lat[a * n + b] = s.mean * ns_per_tick;
+            ent[a * n + b] = s.min_entropy;
+
+            int k = pair_class(a, b, p_cores);
+            cls_h[k] += s.min_entropy;
+            cls_ns[k] += s.mean * ns_per_tick;
+            cls_n[k]++;
+        }
+    }
+
+    print_matrix("Round-trip latency, ns", lat, n, p_cores, " %6.0f");
+    print_matrix("XOR-fold H∞ per round trip, bits", ent, n, p_cores, " %6.3f");
+
+    printf("\nBy pair class:\n");
+    for (int k = 0; k < 3; k++) {
+        if (cls_n[k] == 0) continue;
+        printf("  %s  %3d pairs  mean %.0f ns  mean H∞ %.3f\n", pair_class_name[k], cls_n[k],
+               cls_ns[k] / cls_n[k], cls_h[k] / cls_n[k]);
+    }
+
+    // Best pairs by H∞ per round trip (selection over the matrix)
+    int top = n * (n - 1) < MATRIX_TOP ? n * (n - 1) : MATRIX_TOP;
+    char *taken = calloc((size_t)n * n, 1);
+    printf("\nMost H∞ per round trip:\n");
+    for (int t = 0; t < top; t++) {
+        int best = -1;
+        for (int i = 0; i < n * n; i++) {
+            if (i / n == i % n || taken[i]) continue;
+            if (best < 0 || ent[i] > ent[best]) best = i;
+        }
+        if (best < 0) break;
+        taken[best] = 1;
+        printf("  %c%d -> %c%d  %s  H∞=%.3f  %.0f ns\n",
+               best / n < p_cores ? 'P' : 'E', best / n,
+               best % n < p_cores ? 'P' : 'E', best % n,
+               pair_class_name[pair_class(best / n, best % n, p_cores)], ent[best], lat[best]);
+    }
+
+    free(taken);
+    free(lat);
+    free(ent);
+    free(timings);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--matrix") == 0) return run_matrix(argc - 2, argv + 2);
+
     printf("=== Cache Coherence Fabric (ICE) Timing ===\n");
     printf("Cache line size: %d bytes, Lines: %d, Samples: %d\n\n",
            CACHELINE_SIZE, NUM_LINES, NUM_SAMPLES);
@@ -114,7 +372,7 @@ int main() {
     for (int s = 0; s < NUM_SAMPLES && !remote_data.stop; s++) {
         // Wait for our turn (even phase = main thread's turn)
         while ((phase & 1) != 0 && !remote_data.stop) {
-            __asm__ volatile("yield");
+            CPU_RELAX();
         }
 
         uint64_t t0 = mach_absolute_time();
@@ -0,0 +1,375 @@
+// poc_concurrent.c — Cross-correlation of collectors running at the same time
+//
+// validate_* Test 4 and cross_correlation.c collect one source, then the
+// next, so coupling that exists only while sources run together (shared
+// memory bandwidth, DVFS, scheduler pressure) never shows up. Production
+// runs its sources in parallel (collect_all_parallel in pool.rs): this is
+// the matching independence test.
+//
+// Each named collector runs in its own forked process, placed on its own
+// core. The processes check in at a shared barrier and are released
+// together; each then collects in chunks and writes (timestamp, value)
+// records into its shared-memory ring (lib/poc_spsc.h, MAP_SHARED), where
+// a chunk's samples get timestamps spread evenly over the chunk's
+// collection interval. The coordinator drains the rings while they run,
+// averages every source over aligned time windows, and reports the
+// all-pairs Pearson matrix of the windows every source has samples in,
+// plus the peak lagged correlation of each pair. Lags are time lags: they
+// run over the full window grid, with a source's empty windows set to its
+// mean so they add nothing to the covariance. A producer that dies, or
+// is still running BARRIER_SEC after the stop time, is reported and the
+// run fails.
+//
+//   ./poc_concurrent [-t seconds] [-w window_us] [-l max_lag] name name ...
+//
+// Defaults: 2 s, 1000 µs windows, ±8 windows of lag. Windows in which any
+// source has no samples are skipped, so slow sources (ioregistry,
+// spotlight) want wider windows.
+//
+// Compile: make poc_concurrent
+
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "lib/poc_corrmat.h"
+#include "lib/poc_place.h"
+#include "lib/poc_spsc.h"
+
+#define CHUNK          256
+#define RING_RECORDS   (1u << 18)  // per source; 4 words per record
+#define DRAIN_RECORDS  4096
+#define BARRIER_SEC    30          // setup budget before the release
+#define DEFAULT_SEC    2.0
+#define DEFAULT_WIN_US 1000
+#define DEFAULT_LAG    8
+#define MAX_LAG        64
+
+typedef struct {
+    _Atomic int ready;
+    _Atomic int go;
+    _Atomic uint64_t stop_at;          // mach time the producers stop at
+    _Atomic int done[POC_MAX_SOURCES];
+    PocSpsc rings[POC_MAX_SOURCES];
+} Shared;
+
+typedef struct {
+    uint64_t *stamp;
+    double *value;
+    size_t n, cap;
+} Series;
+
+static double g_ns_per_tick;
+
+// Child: check in, wait for the release, stream stamped chunks until stop.
+static void producer(Shared *sh, int slot, const PocCollector *c) {
+    poc_place_apply(POC_QOS_USER_INTERACTIVE, slot + 1);
+    uint64_t timings[CHUNK];
+    uint32_t words[CHUNK * 4];
+
+    c->collect(timings, CHUNK);   // warmup: first-call setup before the barrier
+    atomic_fetch_add(&sh->ready, 1);
+    while (!atomic_load(&sh->go)) sched_yield();
+
+    const uint64_t stop_at = atomic_load(&sh->stop_at);
+    for (;;) {
+        uint64_t t0 = mach_absolute_time();
+        if (t0 >= stop_at) break;
+        int v = c->collect(timings, CHUNK);
+        uint64_t t1 = mach_absolute_time();
+        if (v <= 0) continue;
+        for (int i = 0; i < v; i++) {
+            uint64_t stamp = t0 + (t1 - t0) * (uint64_t)(i + 1) / (uint64_t)v;
+            memcpy(words + 4 * i, &stamp, sizeof(stamp));
+            memcpy(words + 4 * i + 2, &timings[i], sizeof(timings[i]));
+        }
+        poc_spsc_write_all(&sh->rings[slot], words, (uint32_t)v * 4);
+    }
+    if (c->release) c->release();
+    atomic_store(&sh->done[slot], 1);
+}
+
+static int series_push(Series *s, uint64_t stamp, double value) {
+    if (s->n == s->cap) {
+        size_t cap = s->cap ? s->cap * 2 : 65536;
+        uint64_t *st = realloc(s->stamp, cap * sizeof(uint64_t));
+        if (!st) return -1;
+        s->stamp = st;
+        double *va = realloc(s->value, cap * sizeof(double));
+        if (!va) return -1;
+        s->value = va;
+        s->cap = cap;
+    }
+    s->stamp[s->n] = stamp;
+    s->value[s->n++] = value;
+    return 0;
+}
+
+// Move every buffered record out of the ring. Returns the records drained.
+static size_t drain(PocSpsc *r, Series *s) {
+    static uint32_t words[DRAIN_RECORDS * 4];
+    size_t total = 0;
+    uint32_t got;
+    while ((got = poc_spsc_read(r, words, DRAIN_RECORDS * 4)) > 0) {
+        for (uint32_t k = 0; k + 4 <= got; k += 4) {
+            uint64_t stamp, value;
+            memcpy(&stamp, words + k, sizeof(stamp));
+            memcpy(&value, words + k + 2, sizeof(value));
+            series_push(s, stamp, (double)value);
+        }
+        total += got / 4;
+    }
+    return total;
+}
+
+// Window means of every source over n_win windows from t_start; one row of
+// n_win doubles per source in out and in grid. Returns the number of
+// windows where every source had a sample; only those are kept in out,
+// compacted to the front of each row. grid keeps every window in time
+// order, a source's empty windows holding its mean over the others.
+static int window_means(Series *src, int n_src, uint64_t t_start, uint64_t win,
+                        int n_win, double *out, double *grid) {
+    double *sum = calloc((size_t)n_src * n_win, sizeof(double));
+    int *cnt = calloc((size_t)n_src * n_win, sizeof(int));
+    if (!sum || !cnt) {
+        free(sum);
+        free(cnt);
+        return 0;
+    }
+    for (int s = 0; s < n_src; s++) {
+        for (size_t i = 0; i < src[s].n; i++) {
+            if (src[s].stamp[i] < t_start) continue;
+            uint64_t w = (src[s].stamp[i] - t_start) / win;
+            if (w >= (uint64_t)n_win) continue;
+            sum[(size_t)s * n_win + w] += src[s].value[i];
+            cnt[(size_t)s * n_win + w]++;
+        }
+    }
+    for (int s = 0; s < n_src; s++) {
+        double *row = grid + (size_t)s * n_win;
+        const int *c = cnt + (size_t)s * n_win;
+        double total = 0;
+        int present = 0;
+        for (int w = 0; w < n_win; w++) {
+            row[w] = c[w] ? sum[(size_t)s * n_win + w] / c[w] : NAN;
+            if (c[w]) {
+                total += row[w];
+                present++;
+            }
+        }
+        double fill = present ? total / present : 0;
+        for (int w = 0; w < n_win; w++)
+            if (!c[w]) row[w] = fill;
+    }
+    int kept = 0;
+    for (int w = 0; w < n_win; w++) {
+        int all = 1;
+        for (int s = 0; s < n_src && all; s++) all = cnt[(size_t)s * n_win + w] > 0;
+        if (!all) continue;
+        for (int s = 0; s < n_src; s++)
+            out[(size_t)s * n_win + kept] = sum[(size_t)s * n_win + w] / cnt[(size_t)s * n_win + w];
+        kept++;
+    }
+    free(sum);
+    free(cnt);
+    return kept;
+}
+
+static const char *flag(double r) {
+    return fabs(r) > 0.3 ? " *** REDUNDANT ***" : fabs(r) > 0.1 ? " * weak *" : "";
+}
+
+static int usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [-t seconds] [-w window_us] [-l max_lag] name name ...\n", argv0);
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    double secs = DEFAULT_SEC;
+    int win_us = DEFAULT_WIN_US, max_lag = DEFAULT_LAG;
+    int first = 1;
+    while (first + 1 < argc && argv[first][0] == '-') {
+        if (strcmp(argv[first], "-t") == 0) secs = atof(argv[first + 1]);
+        else if (strcmp(argv[first], "-w") == 0) win_us = atoi(argv[first + 1]);
+        else if (strcmp(argv[first], "-l") == 0) max_lag = atoi(argv[first + 1]);
+        else return usage(argv[0]);
+        first += 2;
+    }
+    int n_src = argc - first;
+    if (n_src < 2 || n_src > POC_MAX_SOURCES || secs <= 0 || win_us <= 0 || max_lag < 0 ||
+        max_lag > MAX_LAG)
+        return usage(argv[0]);
+
+    const PocCollector *sel[POC_MAX_SOURCES];
+    for (int i = 0; i < n_src; i++) {
+        sel[i] = poc_collector_find(argv[first + i]);
+        if (!sel[i]) {
+            fprintf(stderr, "unknown collector: %s (see `poc_runner list`)\n", argv[first + i]);
+            return 2;
+        }
+    }
+    poc_params_apply_env();
+
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    g_ns_per_tick = (double)tb.numer / tb.denom;
+
+    Shared *sh = mmap(NULL, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_ANON | MAP_SHARED, -1, 0);
+    if (sh == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    memset(sh, 0, sizeof(*sh));
+    for (int i = 0; i < n_src; i++) {
+        if (poc_spsc_init_shared(&sh->rings[i], RING_RECORDS * 4) != 0) {
+            perror("ring");
+            return 1;
+        }
+    }
+
+    fflush(stdout);
+    pid_t pids[POC_MAX_SOURCES];
+    for (int i = 0; i < n_src; i++) {
+        pids[i] = fork();
+        if (pids[i] == 0) {
+            producer(sh, i, sel[i]);
+            _exit(0);
+        }
+        if (pids[i] < 0) {
+            perror("fork");
+            for (int k = 0; k < i; k++) kill(pids[k], SIGKILL);
+            return 1;
+        }
+    }
+
+    printf("# Concurrent cross-correlation — %d sources, %.1f s, %d µs windows\n\n", n_src,
+           secs, win_us);
+
+    // Barrier: every producer has warmed up and is waiting
+    const uint64_t ticks_per_sec = (uint64_t)(1e9 / g_ns_per_tick);
+    uint64_t deadline = mach_absolute_time() + BARRIER_SEC * ticks_per_sec;
+    while (atomic_load(&sh->ready) < n_src && mach_absolute_time() < deadline) sched_yield();
+    if (atomic_load(&sh->ready) < n_src) {
+        fprintf(stderr, "only %d of %d producers reached the barrier\n", atomic_load(&sh->ready),
+                n_src);
+        for (int i = 0; i < n_src; i++) kill(pids[i], SIGKILL);
+        return 1;
+    }
+    const uint64_t t_start = mach_absolute_time();
+    const uint64_t t_end = t_start + (uint64_t)(secs * ticks_per_sec);
+    atomic_store(&sh->stop_at, t_end);
+    atomic_store(&sh->go, 1);
+
+    Series *src = calloc((size_t)n_src, sizeof(Series));
+    if (!src) return 1;
+    // A producer is finished once it sets done or its process is gone;
+    // one still running BARRIER_SEC past the stop time is killed.
+    int reaped[POC_MAX_SOURCES] = {0}, failed = 0;
+    const uint64_t kill_at = t_end + BARRIER_SEC * ticks_per_sec;
+    for (;;) {
+        int all_done = 1;
+        size_t moved = 0;
+        for (int i = 0; i < n_src; i++) {
+            int done = atomic_load(&sh->done[i]);
+            moved += drain(&sh->rings[i], &src[i]);
+            if (done || reaped[i]) continue;
+            int status;
+            if (waitpid(pids[i], &status, WNOHANG) == pids[i]) {
+                reaped[i] = 1;
+                if (!atomic_load(&sh->done[i])) {
+                    if (WIFSIGNALED(status))
+                        fprintf(stderr, "producer %s died (signal %d)\n", sel[i]->name,
+                                WTERMSIG(status));
+                    else
+                        fprintf(stderr, "producer %s exited early (status %d)\n",
+                                sel[i]->name, WEXITSTATUS(status));
+                    failed = 1;
+                }
+                continue;
+            }
+            if (mach_absolute_time() > kill_at) {
+                fprintf(stderr, "producer %s still running %d s after the stop; killed\n",
+                        sel[i]->name, BARRIER_SEC);
+                kill(pids[i], SIGKILL);
+                waitpid(pids[i], NULL, 0);
+                reaped[i] = 1;
+                failed = 1;
+                continue;
+            }
+            all_done = 0;
+        }
+        if (all_done) break;
+        if (moved == 0) usleep(200);
+    }
+    for (int i = 0; i < n_src; i++) {
+        drain(&sh->rings[i], &src[i]);
+        if (!reaped[i]) waitpid(pids[i], NULL, 0);
+    }
+
+    printf("  %-24s %10s %12s %10s\n", "source", "samples", "samples/s", "dropped");
+    for (int i = 0; i < n_src; i++)
+        printf("  %-24s %10zu %12.0f %10llu\n", sel[i]->name, src[i].n, src[i].n / secs,
+               (unsigned long long)(poc_spsc_dropped(&sh->rings[i]) / 4));
+
+    const uint64_t win = (uint64_t)(win_us * 1e3 / g_ns_per_tick);
+    const int n_win = (int)((t_end - t_start) / (win ? win : 1));
+    double *rows = malloc((size_t)n_src * (n_win > 0 ? n_win : 1) * sizeof(double));
+    double *grid = malloc((size_t)n_src * (n_win > 0 ? n_win : 1) * sizeof(double));
+    double *r = malloc((size_t)n_src * n_src * sizeof(double));
+    int kept = rows && grid && r && n_win > 0
+                   ? window_means(src, n_src, t_start, win ? win : 1, n_win, rows, grid)
+                   : 0;
+    printf("\n  Aligned windows: %d of %d\n\n", kept, n_win);
+    int rc = failed;
+    if (failed) {
+        printf("  A producer failed — the series are incomplete, not analysed\n");
+    } else if (kept <= 2 * max_lag + 10) {
+        printf("  Too few shared windows — widen -w or run longer\n");
+        rc = 1;
+    } else if (poc_corr_matrix(rows, n_src, n_win, kept, r) == 0) {
+        printf("=== Pearson r of window means ===\n");
+        printf("  %-24s", "");
+        for (int j = 0; j < n_src; j++) printf(" %8.8s", sel[j]->name);
+        printf("\n");
+        for (int i = 0; i < n_src; i++) {
+            printf("  %-24s", sel[i]->name);
+            for (int j = 0; j < n_src; j++) {
+                if (i == j) printf(" %8s", "-");
+                else printf(" %8.4f", r[i * n_src + j]);
+            }
+            printf("\n");
+        }
+
+        printf("\n=== Pairs (peak lagged r over ±%d windows of %d µs) ===\n", max_lag, win_us);
+        double xc[2 * MAX_LAG + 1];
+        for (int i = 0; i < n_src; i++) {
+            for (int j = i + 1; j < n_src; j++) {
+                double rij = r[i * n_src + j];
+                printf("  %s vs %s: r=%.4f%s", sel[i]->name, sel[j]->name, rij, flag(rij));
+                if (max_lag > 0 &&
+                    poc_xcorr_f64(grid + (size_t)i * n_win, grid + (size_t)j * n_win, n_win,
+                                  max_lag, xc) == 0) {
+                    PocLagPeak pk = poc_xcorr_peak(xc, max_lag);
+                    printf("  peak lag %+d (%+d µs): %.4f%s", pk.lag, pk.lag * win_us, pk.r,
+                           flag(pk.r));
+                }
+                printf("\n");
+            }
+        }
+    }
+
+    for (int i = 0; i < n_src; i++) {
+        free(src[i].stamp);
+        free(src[i].value);
+        poc_spsc_free(&sh->rings[i]);
+    }
+    free(src);
+    free(rows);
+    free(grid);
+    free(r);
+    munmap(sh, sizeof(*sh));
+    return rc;
+}
@@ -23,14 +23,12 @@
 #include <math.h>
 #include <mach/mach_time.h>
 
+#include "lib/poc_time.h"
+
 #define REGION_SIZE (64 * 1024 * 1024)  // 64MB - span many DRAM banks/rows
 #define NUM_SAMPLES 10000
 #define STRIDE 4096  // Page-stride to hit different DRAM rows
 
-static inline uint64_t rdtsc(void) {
-    return mach_absolute_time();
-}
-
 int main() {
     // Allocate a large region spanning many DRAM banks
     volatile uint8_t *region = (volatile uint8_t *)malloc(REGION_SIZE);
@@ -55,13 +53,13 @@ int main() {
 
     // Measure timing of strided reads across DRAM banks
     // Refresh interference will cause sporadic latency spikes
-    uint64_t lcg = rdtsc() | 1;
+    uint64_t lcg = poc_ts() | 1;
     for (int s = 0; s < NUM_SAMPLES; s++) {
         // Pseudo-random offset to prevent prefetcher prediction
         lcg = lcg * 6364136223846793005ULL + 1;
         int idx = (lcg >> 32) % num_offsets;
 
-        uint64_t t0 = rdtsc();
+        uint64_t t0 = poc_ts();
 
         // Read from random DRAM row + write back (RMW forces row buffer operation)
         volatile uint8_t val = region[idx * STRIDE];
@@ -72,7 +70,7 @@ int main() {
         volatile uint8_t val2 = region[idx2 * STRIDE];
         region[idx2 * STRIDE] = val2 + 1;
 
-        uint64_t t1 = rdtsc();
+        uint64_t t1 = poc_ts();
         timings[s] = t1 - t0;
     }
 
@@ -17,6 +17,10 @@
  * in iteration counts between two threads (one on P-core, one on E-core)
  * captures physical frequency jitter that depends on thermal noise in the
  * voltage regulators and PLL circuits.
+ *
+ * Method 3 steers its two threads with lib/poc_place.h (user-interactive
+ * QoS for one, background for the other, distinct affinity tags) and
+ * reports which cluster each one actually finished on.
  */
 #include <stdio.h>
 #include <stdlib.h>
@@ -25,6 +29,8 @@
 #include <mach/mach_time.h>
 #include <math.h>
 
+#include "lib/poc_place.h"
+
 #define NUM_SAMPLES 5000
 #define MEASUREMENT_NS 1000  // 1 microsecond measurement window
 
@@ -32,10 +38,14 @@ typedef struct {
     volatile uint64_t count;
     volatile int ready;
     volatile int stop;
+    PocQos qos;                 // interactive leans P, background stays on E
+    int tag;
+    int cpu;                    // where the loop ended
 } thread_data_t;
 
 static void *counter_thread(void *arg) {
     thread_data_t *data = (thread_data_t *)arg;
+    poc_place_apply(data->qos, data->tag);
     data->ready = 1;
 
     // Spin until told to start (synchronization)
@@ -50,6 +60,7 @@ static void *counter_thread(void *arg) {
         count++;  // Unrolled for tighter loop
     }
     data->count = count;
+    data->cpu = poc_place_cpu();
     return NULL;
 }
 
@@ -142,9 +153,12 @@ int main() {
     printf("\n--- Method 3: Two-thread iteration race (cross-core DVFS difference) ---\n");
 
     uint64_t race_diffs[NUM_SAMPLES];
+    PocPlaceReport rep1, rep2;
+    poc_place_report_init(&rep1);
+    poc_place_report_init(&rep2);
     for (int s = 0; s < NUM_SAMPLES; s++) {
-        thread_data_t td1 = {0, 0, 0};
-        thread_data_t td2 = {0, 0, 0};
+        thread_data_t td1 = {0, 0, 0, POC_QOS_USER_INTERACTIVE, 1, -1};
+        thread_data_t td2 = {0, 0, 0, POC_QOS_BACKGROUND, 2, -1};
 
         pthread_t t1, t2;
         pthread_create(&t1, NULL, counter_thread, &td1);
@@ -162,6 +176,8 @@ int main() {
         td2.stop = 1;
         pthread_join(t1, NULL);
         pthread_join(t2, NULL);
+        poc_place_note_cpu(&rep1, td1.cpu);
+        poc_place_note_cpu(&rep2, td2.cpu);
 
         // The difference captures cross-core frequency relationship
         race_diffs[s] = td1.count > td2.count ?
@@ -190,6 +206,10 @@ int main() {
     double r_min_h = -log2((double)r_max / NUM_SAMPLES);
 
     printf("Race diff XOR-fold: unique=%d Shannon=%.3f Min-H∞=%.3f\n", r_unique, r_shannon, r_min_h);
+    char where1[64], where2[64];
+    poc_place_report_format(&rep1, where1, sizeof(where1));
+    poc_place_report_format(&rep2, where2, sizeof(where2));
+    printf("Interactive thread ran on: %s\nBackground thread ran on:  %s\n", where1, where2);
 
     // Show sample diffs
     printf("First 20 race diffs: ");
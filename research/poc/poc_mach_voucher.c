@@ -30,12 +30,6 @@
 
 #define NUM_SAMPLES 10000
 
-// QoS classes we can set via pthread
-#define QOS_BACKGROUND      0x09      // QOS_CLASS_BACKGROUND
-#define QOS_UTILITY         0x11      // QOS_CLASS_UTILITY
-#define QOS_USER_INITIATED  0x19      // QOS_CLASS_USER_INITIATED
-#define QOS_USER_INTERACTIVE 0x21     // QOS_CLASS_USER_INTERACTIVE
-
 int main() {
     printf("=== Mach Thread Scheduling / QoS Entropy ===\n");
     printf("Samples: %d\n\n", NUM_SAMPLES);
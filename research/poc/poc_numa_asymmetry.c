@@ -16,18 +16,47 @@
  *
  * Also tests: atomic operation contention timing across multiple threads
  * which exercises the coherence engine's arbitration.
+ *
+ * --map probes the whole buffer in 2MB slices from several threads at once
+ * (each on its own affinity tag, pinned on Linux), every thread walking the
+ * slices in a rotated order so different slices are under load together.
+ * A sample is one cache-line read after 16 random evicting reads. Per slice
+ * it writes mean / p99 / stddev latency and XOR-fold H∞ to a heatmap file
+ * (lib/poc_heatmap.h); POC_HEATMAP=<file> then steers dram_row_buffer and
+ * cache_contention into the highest-variance slices.
+ *
+ *   ./poc_numa_asymmetry                         CAS and landscape methods
+ *   ./poc_numa_asymmetry --map [-o FILE] [-t THREADS] [-m MB] [-s SAMPLES]
+ *        defaults: poc_heatmap.tsv, 4 threads, 32 MB, 2000 samples per
+ *        slice per thread
  */
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <pthread.h>
 #include <math.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #include <mach/mach_time.h>
 #include <stdatomic.h>
 
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+#include "lib/poc_heatmap.h"
+#include "lib/poc_place.h"
+#include "lib/poc_stats.h"
+
 #define NUM_SAMPLES 10000
 #define REGION_SIZE (32 * 1024 * 1024)  // 32MB
+#define MAP_MAX_THREADS 32
+#define MAP_EVICT_READS 16
 
 // Method: Atomic CAS (Compare-And-Swap) contention
 // Multiple threads racing on atomic operations creates physically
@@ -66,7 +95,156 @@ static void *cas_thread(void *arg) {
     return NULL;
 }
 
-int main() {
+// --- Slice heatmap --------------------------------------------------------
+
+typedef struct {
+    volatile uint8_t *region;
+    size_t bytes;
+    int n_slices;
+    int samples;            // per slice
+    int tag;
+    uint64_t *timings;      // [slice * samples + i]
+    volatile int *go;
+} map_worker_t;
+
+static void *map_thread(void *arg) {
+    map_worker_t *w = (map_worker_t *)arg;
+    poc_place_apply(POC_QOS_INHERIT, w->tag);
+    while (!*w->go) sched_yield();
+
+    uint64_t lcg = (mach_absolute_time() ^ ((uint64_t)w->tag << 32)) | 1;
+    uint8_t sink = 0;
+    for (int k = 0; k < w->n_slices; k++) {
+        int s = (k + w->tag) % w->n_slices;
+        size_t base = (size_t)s * POC_HEATMAP_SLICE;
+        for (int i = 0; i < w->samples; i++) {
+            for (int e = 0; e < MAP_EVICT_READS; e++) {
+                lcg = lcg * 6364136223846793005ULL + 1;
+                sink += w->region[(lcg >> 16) % w->bytes];
+            }
+            lcg = lcg * 6364136223846793005ULL + 1;
+            size_t off = base + ((lcg >> 16) % (POC_HEATMAP_SLICE / 128)) * 128;
+
+            uint64_t t0 = mach_absolute_time();
+            sink += w->region[off];
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            uint64_t t1 = mach_absolute_time();
+            w->timings[(size_t)s * w->samples + i] = t1 - t0;
+        }
+    }
+    __asm__ volatile("" : : "r"(sink));
+    return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static int run_map(int argc, char **argv) {
+    const char *out = "poc_heatmap.tsv";
+    int threads = 4, samples = 2000;
+    size_t mb = REGION_SIZE / (1024 * 1024);
+    for (int i = 0; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-o") == 0) out = argv[i + 1];
+        else if (strcmp(argv[i], "-t") == 0) threads = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-m") == 0) mb = (size_t)atol(argv[i + 1]);
+        else if (strcmp(argv[i], "-s") == 0) samples = atoi(argv[i + 1]);
+    }
+    if (threads < 1) threads = 1;
+    if (threads > MAP_MAX_THREADS) threads = MAP_MAX_THREADS;
+    if (samples < 10) samples = 10;
+    size_t bytes = (mb * 1024 * 1024) / POC_HEATMAP_SLICE * POC_HEATMAP_SLICE;
+    int n_slices = (int)(bytes / POC_HEATMAP_SLICE);
+    if (n_slices < 1) {
+        fprintf(stderr, "Region must be at least one 2MB slice\n");
+        return 1;
+    }
+
+    printf("=== Address-range latency heatmap ===\n");
+    printf("%zu MB in %d slices, %d threads, %d samples per slice per thread\n\n",
+           bytes >> 20, n_slices, threads, samples);
+
+    volatile uint8_t *region = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                                    MAP_ANON | MAP_PRIVATE, -1, 0);
+    if (region == MAP_FAILED) {
+        fprintf(stderr, "mmap failed\n");
+        return 1;
+    }
+    memset((void *)region, 0xAA, bytes);
+
+    map_worker_t workers[MAP_MAX_THREADS];
+    pthread_t tids[MAP_MAX_THREADS];
+    volatile int go = 0;
+    int started = 0;
+    for (; started < threads; started++) {
+        workers[started] = (map_worker_t){region, bytes, n_slices, samples, started + 1,
+                                          malloc((size_t)n_slices * samples * sizeof(uint64_t)),
+                                          &go};
+        if (!workers[started].timings ||
+            pthread_create(&tids[started], NULL, map_thread, &workers[started]) != 0) {
+            free(workers[started].timings);
+            break;
+        }
+    }
+    go = 1;
+    for (int t = 0; t < started; t++) pthread_join(tids[t], NULL);
+    if (started == 0) {
+        fprintf(stderr, "no worker threads started\n");
+        munmap((void *)region, bytes);
+        return 1;
+    }
+
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    double ns_per_tick = (double)tb.numer / tb.denom;
+
+    // Merge every thread's samples per slice
+    int per_slice = started * samples;
+    uint64_t *merged = malloc((size_t)per_slice * sizeof(uint64_t));
+    PocHeatmap map = {POC_HEATMAP_SLICE, n_slices, calloc((size_t)n_slices, sizeof(PocHeatSlice))};
+    printf("  slice  offset MB  mean ns   p99 ns  stddev    H∞\n");
+    for (int s = 0; s < n_slices; s++) {
+        for (int t = 0; t < started; t++)
+            memcpy(merged + (size_t)t * samples, workers[t].timings + (size_t)s * samples,
+                   (size_t)samples * sizeof(uint64_t));
+        Stats st = compute_stats(merged, per_slice);
+        qsort(merged, (size_t)per_slice, sizeof(uint64_t), cmp_u64);
+        PocHeatSlice *h = &map.slices[s];
+        h->offset = (uint64_t)s * POC_HEATMAP_SLICE;
+        h->mean_ns = st.mean * ns_per_tick;
+        h->p99_ns = merged[(size_t)per_slice * 99 / 100] * ns_per_tick;
+        h->stddev_ns = st.stddev * ns_per_tick;
+        h->min_entropy = st.min_entropy;
+        printf("  %5d  %9llu  %7.1f  %7.1f  %6.1f  %.3f\n", s,
+               (unsigned long long)(h->offset >> 20), h->mean_ns, h->p99_ns, h->stddev_ns,
+               h->min_entropy);
+    }
+
+    int top[4];
+    int nt = poc_heatmap_top(&map, bytes, top, 4);
+    printf("\nHighest-variance slices:");
+    for (int i = 0; i < nt; i++) printf(" %d (%.1f ns)", top[i], map.slices[top[i]].stddev_ns);
+    printf("\n");
+
+    int rc = 0;
+    if (poc_heatmap_save(&map, out) == 0) {
+        printf("Heatmap written to %s (use POC_HEATMAP=%s with the memory collectors)\n", out, out);
+    } else {
+        fprintf(stderr, "cannot write %s\n", out);
+        rc = 1;
+    }
+
+    poc_heatmap_free(&map);
+    free(merged);
+    for (int t = 0; t < started; t++) free(workers[t].timings);
+    munmap((void *)region, bytes);
+    return rc;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--map") == 0) return run_map(argc - 2, argv + 2);
+
     printf("=== Atomic CAS Contention Entropy ===\n\n");
 
     // Allocate contention targets (spread across cache lines)
@@ -0,0 +1,489 @@
+// poc_runner.c — Run any subset of the collector catalog in one process
+//
+//   ./poc_runner list                     every registered collector
+//   ./poc_runner validate [name ...]      full validation (all when no names)
+//   ./poc_runner run [-n N] name ...      raw samples, one "name<TAB>value" per line
+//   ./poc_runner capture [-n N] name file append N samples to a raw capture
+//   ./poc_runner replay file ...          entropy / autocorrelation of captures
+//   ./poc_runner place [-n N] [-p p,e,..] name ...
+//                                         throughput and H∞ under each placement
+//   ./poc_runner harvest [-s socket] [-r rate] [-c chunk] [-b ring] name ...
+//                                         keep collecting for openentropy-server
+//
+// Sources, sizes and cross partners come from collectors/registry.c; the
+// harness buffers are shared, so a sweep allocates them once.
+//
+// place runs every named collector under each placement in turn
+// (lib/poc_place.h; all of them by default, inherit first). Each row runs
+// on a fresh thread: the placement is applied to that thread and set as
+// the override for the collector's own workers, so no row inherits an
+// earlier one's QoS or affinity whatever the -p order. Every row shows
+// samples/s, H∞, and where the calling thread and the workers actually
+// ran. The collector is released after each row, so long-lived workers
+// restart under the next placement.
+//
+// With POC_CACHE_DIR=<dir>, validate keeps each collector's report in
+// <dir> (lib/poc_cache.h) and replays it instead of revalidating while the
+// key still matches. The key covers the objects the report came from:
+// the collector's own, its Test 4 partners', the harness, the registry
+// and lib/libpoc.a, found next to the poc_runner binary. It also covers
+// the machine fingerprint, the clock in use, the tuned parameter values,
+// POC_SEQUENTIAL / POC_CAPTURE_DIR / POC_LINUX_CLOCK, and the contents of
+// each input file the sources load: the heatmap, DRAM map and Core ML
+// model where they apply (INPUT_FILES) and every source's capture tape. A
+// rebuild, a different machine or a new input file therefore revalidates
+// only what changed. Soak mode is never cached.
+//
+// harvest is the daemon behind `openentropy server --poc-harvest <socket>`
+// (lib/poc_harvest.h): every named collector runs in its own worker until
+// SIGINT / SIGTERM, with the tuned parameters from $POC_TUNE, optionally
+// capped at -r samples/s each. Workers pause while their ring is full, and
+// workers of collectors built from one object take turns. The socket
+// defaults to a per-user directory.
+//
+// Compile: make poc_runner
+
+#include <errno.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+#include "lib/poc_cache.h"
+#include "lib/poc_harvest.h"
+
+static char g_build_dir[1024] = ".";
+
+static int usage(const char *argv0) {
+    fprintf(stderr, "usage: %s list | validate [name ...] | run [-n N] name ... |\n"
+                    "       capture [-n N] name file | replay file ... |\n"
+                    "       place [-n N] [-p placement,...] name ... |\n"
+                    "       harvest [-s socket] [-r rate] [-c chunk] [-b ring] name ...\n", argv0);
+    return 2;
+}
+
+static const PocCollector *lookup(const char *name) {
+    const PocCollector *c = poc_collector_find(name);
+    if (!c) fprintf(stderr, "unknown collector: %s (see `poc_runner list`)\n", name);
+    return c;
+}
+
+static int cmd_list(void) {
+    for (int i = 0; i < poc_n_collectors; i++) {
+        const PocCollector *c = &poc_collectors[i];
+        printf("%-24s", c->name);
+        for (int k = 0; k < POC_MAX_CROSS && c->cross[k]; k++)
+            printf("%s%s", k ? ", " : "  cross: ", c->cross[k]);
+        printf("\n");
+    }
+    return 0;
+}
+
+static void append(char *buf, size_t len, const char *s) {
+    size_t n = strlen(buf);
+    if (n < len) snprintf(buf + n, len - n, "%s", s);
+}
+
+static void append_params(char *ctx, size_t len, const char *collector) {
+    if (!collector) return;
+    for (int i = 0; i < poc_n_params; i++) {
+        const PocParam *p = &poc_params[i];
+        if (strcmp(p->collector, collector) != 0) continue;
+        char kv[160];
+        snprintf(kv, sizeof(kv), "%s.%s=%d\n", p->collector, p->name, *p->value);
+        append(ctx, len, kv);
+    }
+}
+
+// Environment every validation report depends on.
+static const char *const ENV_KEYS[] = {"POC_SEQUENTIAL", "POC_CAPTURE_DIR", "POC_LINUX_CLOCK"};
+
+// Input files collectors load, by the object that loads them: the path
+// from env (or fallback) is keyed for any partner built from object.
+static const struct {
+    const char *object, *env, *fallback;
+} INPUT_FILES[] = {
+    {"cache_contention", "POC_HEATMAP", NULL},
+    {"dram_row_buffer", "POC_HEATMAP", NULL},
+    {"dram_row_buffer", "POC_DRAM_MAP", POC_DRAM_MAP_DEFAULT},
+    {"coreml_ane", "POC_COREML_MODEL", NULL},
+};
+
+#define KEY_MAX_FILES (4 * (POC_MAX_CROSS + 1) + 3)
+
+// Key inputs: objects and regular input files are hashed by contents
+// (poc_cache_key); ctx gets each input's path, plus "size mtime inode" for
+// a directory (a compiled Core ML model) or "-" when it is missing.
+typedef struct {
+    char paths[KEY_MAX_FILES][1100];
+    const char *list[KEY_MAX_FILES];
+    int n;
+} KeyFiles;
+
+static void key_file(KeyFiles *kf, const char *path) {
+    if (kf->n == KEY_MAX_FILES) return;
+    snprintf(kf->paths[kf->n], sizeof(kf->paths[kf->n]), "%s", path);
+    kf->list[kf->n] = kf->paths[kf->n];
+    kf->n++;
+}
+
+static void key_input(KeyFiles *kf, char *ctx, size_t len, const char *path) {
+    struct stat st;
+    char line[1200];
+    if (stat(path, &st) != 0) {
+        snprintf(line, sizeof(line), "input %s -\n", path);
+    } else if (S_ISREG(st.st_mode)) {
+        snprintf(line, sizeof(line), "input %s\n", path);
+        key_file(kf, path);
+    } else {
+        snprintf(line, sizeof(line), "input %s %lld %lld %llu\n", path, (long long)st.st_size,
+                 (long long)st.st_mtime, (unsigned long long)st.st_ino);
+    }
+    append(ctx, len, line);
+}
+
+// Cache key of c's validation report; -1 when an object is missing.
+static int validation_key(const PocCollector *c, char key[POC_CACHE_KEY_HEX]) {
+    static KeyFiles kf;
+    const PocCollector *partners[POC_MAX_CROSS + 1] = {c};
+    int n_partners = 1;
+    for (int k = 0; k < POC_MAX_CROSS && c->cross[k]; k++) {
+        const PocCollector *p = poc_collector_find(c->cross[k]);
+        if (p) partners[n_partners++] = p;
+    }
+    kf.n = 0;
+    char path[1100];
+    for (int k = 0; k < n_partners; k++) {
+        const PocCollector *p = partners[k];
+        snprintf(path, sizeof(path), "%s/collectors/%s.o", g_build_dir,
+                 p->object ? p->object : p->name);
+        key_file(&kf, path);
+    }
+    static const char *const SHARED[] = {"collectors/harness.o", "collectors/registry.o",
+                                         "lib/libpoc.a"};
+    for (int k = 0; k < 3; k++) {
+        snprintf(path, sizeof(path), "%s/%s", g_build_dir, SHARED[k]);
+        key_file(&kf, path);
+    }
+
+    char ctx[16384];
+    poc_machine_fingerprint(ctx, sizeof(ctx));
+    append(ctx, sizeof(ctx), "\n");
+    for (int k = 0; k < n_partners; k++) append_params(ctx, sizeof(ctx), partners[k]->name);
+    append(ctx, sizeof(ctx), "clock=");
+    append(ctx, sizeof(ctx), poc_platform_clock());
+    append(ctx, sizeof(ctx), "\n");
+    for (size_t k = 0; k < sizeof(ENV_KEYS) / sizeof(ENV_KEYS[0]); k++) {
+        const char *v = getenv(ENV_KEYS[k]);
+        append(ctx, sizeof(ctx), ENV_KEYS[k]);
+        append(ctx, sizeof(ctx), "=");
+        append(ctx, sizeof(ctx), v ? v : "");
+        append(ctx, sizeof(ctx), "\n");
+    }
+
+    for (int k = 0; k < n_partners; k++) {
+        const char *obj = partners[k]->object ? partners[k]->object : partners[k]->name;
+        for (size_t j = 0; j < sizeof(INPUT_FILES) / sizeof(INPUT_FILES[0]); j++) {
+            if (strcmp(obj, INPUT_FILES[j].object) != 0) continue;
+            const char *in = getenv(INPUT_FILES[j].env);
+            if (!in || !*in) in = INPUT_FILES[j].fallback;
+            if (in) key_input(&kf, ctx, sizeof(ctx), in);
+        }
+    }
+    const char *cap = getenv("POC_CAPTURE_DIR");
+    for (int k = 0; cap && *cap && k < n_partners; k++) {
+        snprintf(path, sizeof(path), "%s/%s.oeraw", cap, partners[k]->name);
+        key_input(&kf, ctx, sizeof(ctx), path);
+    }
+    return poc_cache_key(kf.list, kf.n, ctx, key);
+}
+
+static int validate_one(const PocCollector *c, int *cached) {
+    const char *dir = getenv("POC_CACHE_DIR");
+    const char *soak = getenv("POC_SOAK_N");
+    char key[POC_CACHE_KEY_HEX];
+    if (!dir || !*dir || (soak && *soak) || validation_key(c, key) != 0) return poc_validate(c);
+
+    int rc = poc_cache_replay(dir, c->name, key);
+    if (rc >= 0) {
+        printf("  (cached result, key %.16s)\n\n", key);
+        (*cached)++;
+        return rc;
+    }
+    PocCacheRecord rec;
+    if (poc_cache_record_begin(&rec, dir, c->name, key) != 0) {
+        fprintf(stderr, "  cache %s: %s (not caching %s)\n", dir, strerror(errno), c->name);
+        return poc_validate(c);
+    }
+    rc = poc_validate(c);
+    // A setup failure says nothing about the source; leave it uncached.
+    if (poc_cache_record_end(&rec, rc, rc == 0) != 0)
+        fprintf(stderr, "  cache %s: cannot save %s\n", dir, c->name);
+    return rc;
+}
+
+static int cmd_validate(int argc, char **argv) {
+    int rc = 0, cached = 0, total = 0;
+    if (argc == 0) {
+        for (int i = 0; i < poc_n_collectors; i++, total++)
+            rc |= validate_one(&poc_collectors[i], &cached);
+    }
+    for (int i = 0; i < argc; i++, total++) {
+        const PocCollector *c = lookup(argv[i]);
+        if (!c) return 2;
+        rc |= validate_one(c, &cached);
+    }
+    const char *dir = getenv("POC_CACHE_DIR");
+    if (dir && *dir) printf("# %d of %d results from %s\n", cached, total, dir);
+    return rc;
+}
+
+static int cmd_run(int argc, char **argv) {
+    int n = TRIAL_N;
+    if (argc >= 2 && strcmp(argv[0], "-n") == 0) {
+        n = atoi(argv[1]);
+        argc -= 2;
+        argv += 2;
+    }
+    if (n <= 0 || argc == 0) return usage("poc_runner");
+
+    uint64_t *buf = malloc((size_t)n * sizeof(uint64_t));
+    if (!buf) return 1;
+    for (int i = 0; i < argc; i++) {
+        const PocCollector *c = lookup(argv[i]);
+        if (!c) { free(buf); return 2; }
+        int v = poc_collect(c, buf, n);
+        for (int j = 0; j < v; j++)
+            printf("%s\t%llu\n", c->name, (unsigned long long)buf[j]);
+        if (c->release) c->release();
+    }
+    free(buf);
+    return 0;
+}
+
+static int cmd_capture(int argc, char **argv) {
+    uint64_t n = LARGE_N;
+    if (argc >= 2 && strcmp(argv[0], "-n") == 0) {
+        n = strtoull(argv[1], NULL, 10);
+        argc -= 2;
+        argv += 2;
+    }
+    if (n == 0 || argc != 2) return usage("poc_runner");
+    const PocCollector *c = lookup(argv[0]);
+    if (!c) return 2;
+
+    PocCaptureWriter w;
+    if (poc_capture_open(&w, argv[1], c->name) != 0) {
+        fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+        return 1;
+    }
+    static uint64_t chunk[SOAK_CHUNK];
+    uint64_t before = w.count;
+    uint64_t got = poc_capture_collect(&w, c->collect, n, chunk, SOAK_CHUNK);
+    if (c->release) c->release();
+    if (poc_capture_close(&w) != 0) {
+        fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+        return 1;
+    }
+    printf("%s: +%llu samples (%llu total) -> %s\n", c->name, (unsigned long long)got,
+           (unsigned long long)(before + got), argv[1]);
+    return got == n ? 0 : 1;
+}
+
+static int cmd_replay(int argc, char **argv) {
+    if (argc == 0) return usage("poc_runner");
+    for (int i = 0; i < argc; i++) {
+        PocCapture cap;
+        if (poc_capture_map(&cap, argv[i]) != 0) {
+            fprintf(stderr, "%s: %s\n", argv[i], strerror(errno));
+            return 1;
+        }
+        const PocCaptureHeader *h = cap.header;
+        int n = cap.n > INT32_MAX ? INT32_MAX : (int)cap.n;
+        printf("# %s — %s (%llu samples, %s %s, %u cores, timebase %u/%u)\n", argv[i],
+               h->source, (unsigned long long)cap.n, h->arch, h->chip, h->cores,
+               h->timebase_numer, h->timebase_denom);
+        Stats s = compute_stats(cap.samples, n);
+        printf("  Mean=%.1f  StdDev=%.1f  Shannon=%.3f  H_inf=%.3f\n", s.mean, s.stddev,
+               s.shannon, s.min_entropy);
+        static double acf[ACF_SCREEN_LAG + 1];
+        poc_acf(cap.samples, n, ACF_SCREEN_LAG, acf);
+        for (int lag = 1; lag <= 5; lag++) printf("  lag-%d: %.4f\n", lag, acf[lag]);
+        PocLagPeak pk = poc_acf_peak(acf, ACF_SCREEN_LAG);
+        printf("  peak |r| over lags 1-%d: lag-%d %.4f\n\n", ACF_SCREEN_LAG, pk.lag, pk.r);
+        poc_capture_unmap(&cap);
+    }
+    return 0;
+}
+
+#define PLACE_CHUNKS 16      // caller CPU is noted once per chunk
+#define PLACE_STACK (8u << 20)
+
+// Comma-separated placement names; returns how many, or -1 on an unknown name.
+static int parse_placements(char *list, const PocPlacement **out, int max) {
+    int k = 0;
+    for (char *tok = strtok(list, ","); tok; tok = strtok(NULL, ",")) {
+        const PocPlacement *p = poc_placement_find(tok);
+        if (!p) {
+            fprintf(stderr, "unknown placement: %s\n", tok);
+            return -1;
+        }
+        if (k < max) out[k++] = p;
+    }
+    return k;
+}
+
+typedef struct {
+    const PocCollector *c;
+    const PocPlacement *p;
+    uint64_t *buf;
+    int n;
+    double ns_per_tick;
+} PlaceRow;
+
+static void *place_one(void *arg) {
+    const PlaceRow *row = arg;
+    const PocCollector *c = row->c;
+    const PocPlacement *p = row->p;
+    uint64_t *buf = row->buf;
+    const int n = row->n;
+    PocPlaceReport self, workers;
+    poc_place_set_override(p);
+    poc_place_apply(p->qos, p->tag);
+    poc_place_report_init(&self);
+    poc_place_workers_take(&workers);   // drop notes from earlier runs
+
+    poc_collect(c, buf, n / 10 > 0 ? n / 10 : 1);   // warmup, already placed
+    const int chunk = (n + PLACE_CHUNKS - 1) / PLACE_CHUNKS;
+    int got = 0;
+    uint64_t t0 = mach_absolute_time();
+    while (got < n) {
+        int want = n - got < chunk ? n - got : chunk;
+        int v = poc_collect(c, buf + got, want);
+        poc_place_note(&self);
+        if (v <= 0) break;
+        got += v;
+    }
+    uint64_t t1 = mach_absolute_time();
+    if (c->release) c->release();
+    poc_place_workers_take(&workers);
+    poc_place_set_override(NULL);
+
+    char where_self[64], where_workers[64];
+    poc_place_report_format(&self, where_self, sizeof(where_self));
+    poc_place_report_format(&workers, where_workers, sizeof(where_workers));
+    double sec = (double)(t1 - t0) * row->ns_per_tick / 1e9;
+    double rate = sec > 0 ? got / sec : 0;
+    double h = got >= POC_MIN_VALID ? compute_stats(buf, got).min_entropy : 0;
+    printf("%-24s %-10s %12.0f %7.3f  %-24s %s\n", c->name, p->name, rate, h, where_self,
+           where_workers);
+    return NULL;
+}
+
+static int cmd_place(int argc, char **argv) {
+    int n = TRIAL_N, n_place = poc_n_placements;
+    const PocPlacement *places[16];
+    for (int i = 0; i < n_place; i++) places[i] = &poc_placements[i];
+    while (argc >= 2 && argv[0][0] == '-') {
+        if (strcmp(argv[0], "-n") == 0) {
+            n = atoi(argv[1]);
+        } else if (strcmp(argv[0], "-p") == 0) {
+            n_place = parse_placements(argv[1], places, 16);
+            if (n_place < 0) return 2;
+        } else {
+            return usage("poc_runner");
+        }
+        argc -= 2;
+        argv += 2;
+    }
+    if (n <= 0 || n_place == 0 || argc == 0) return usage("poc_runner");
+
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    const double ns_per_tick = (double)tb.numer / tb.denom;
+    uint64_t *buf = malloc((size_t)n * sizeof(uint64_t));
+    if (!buf) return 1;
+    printf("%-24s %-10s %12s %7s  %-24s %s\n", "collector", "placement", "samples/s", "H∞",
+           "caller ran on", "workers ran on");
+    const PocCollector *cs[64];
+    if (argc > 64) argc = 64;
+    for (int i = 0; i < argc; i++)
+        if (!(cs[i] = lookup(argv[i]))) { free(buf); return 2; }
+    // One thread per row: a placed thread cannot return to "inherit". Give
+    // it a main-thread-sized stack (secondary threads get 512 KB on macOS).
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, PLACE_STACK);
+    int rc = 0;
+    for (int k = 0; k < n_place && rc == 0; k++)
+        for (int i = 0; i < argc && rc == 0; i++) {
+            PlaceRow row = {cs[i], places[k], buf, n, ns_per_tick};
+            pthread_t t;
+            int err = pthread_create(&t, &attr, place_one, &row);
+            if (err != 0) {
+                fprintf(stderr, "place: pthread_create: %s\n", strerror(err));
+                rc = 1;
+            } else {
+                pthread_join(t, NULL);
+            }
+        }
+    pthread_attr_destroy(&attr);
+    free(buf);
+    return rc;
+}
+
+static int cmd_harvest(int argc, char **argv) {
+    PocHarvestConfig cfg;
+    poc_harvest_defaults(&cfg);
+    int i = 0;
+    for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {
+        if (strcmp(argv[i], "-s") == 0) cfg.socket_path = argv[i + 1];
+        else if (strcmp(argv[i], "-r") == 0) cfg.max_rate = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-c") == 0) cfg.chunk = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-b") == 0)
+            cfg.ring_samples = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+        else return usage("poc_runner");
+    }
+    argc -= i;
+    argv += i;
+    if (argc == 0 || argc > POC_HARVEST_MAX_SOURCES) return usage("poc_runner");
+
+    if (!cfg.socket_path) {
+        fprintf(stderr, "harvest: no private socket directory (%s); pass -s\n", strerror(errno));
+        return 1;
+    }
+
+    // Collectors of one object share its state, so they take turns
+    PocHarvestSource src[POC_HARVEST_MAX_SOURCES];
+    for (int k = 0; k < argc; k++) {
+        const PocCollector *c = lookup(argv[k]);
+        if (!c) return 2;
+        for (int j = 0; j < k; j++)
+            if (strcmp(src[j].name, c->name) == 0) {
+                fprintf(stderr, "harvest: %s named twice\n", c->name);
+                return 2;
+            }
+        src[k] = (PocHarvestSource){c->name, c->collect, c->release, poc_collector_group(c)};
+    }
+    if (poc_harvest_run(src, argc, &cfg) != 0) {
+        fprintf(stderr, "harvest: cannot set up rings or %s: %s\n", cfg.socket_path,
+                strerror(errno));
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) return usage(argv[0]);
+    const char *slash = strrchr(argv[0], '/');
+    if (slash) snprintf(g_build_dir, sizeof(g_build_dir), "%.*s", (int)(slash - argv[0]), argv[0]);
+    poc_params_apply_env();
+    if (strcmp(argv[1], "list") == 0) return cmd_list();
+    if (strcmp(argv[1], "validate") == 0) return cmd_validate(argc - 2, argv + 2);
+    if (strcmp(argv[1], "run") == 0) return cmd_run(argc - 2, argv + 2);
+    if (strcmp(argv[1], "capture") == 0) return cmd_capture(argc - 2, argv + 2);
+    if (strcmp(argv[1], "replay") == 0) return cmd_replay(argc - 2, argv + 2);
+    if (strcmp(argv[1], "place") == 0) return cmd_place(argc - 2, argv + 2);
+    if (strcmp(argv[1], "harvest") == 0) return cmd_harvest(argc - 2, argv + 2);
+    return usage(argv[0]);
+}
@@ -0,0 +1,138 @@
+// poc_timer_bench.c — Read cost and resolution of every lib/poc_time source
+//
+// For each timestamp source usable on this machine:
+//   rate        source ticks per ns, calibrated against mach_absolute_time
+//               over a short spin
+//   ns/read     back-to-back reads divided into wall time — the floor a
+//               collector pays per timestamp
+//   min Δ       smallest nonzero difference between consecutive reads, in
+//               ticks and ns — the finest event the source can separate
+//   zero Δ %    consecutive reads that returned the same value; high means
+//               the source is coarser than the read loop
+//   distinct    number of distinct consecutive deltas seen
+//
+//   ./poc_timer_bench [-n reads]
+//
+// isb+cntpct traps on systems that keep CNTPCT_EL0 from EL0; the probe
+// catches the SIGILL and reports the source as trapped. kperf_cycles needs
+// root (sudo ./poc_timer_bench).
+//
+// Compile: make poc_timer_bench
+
+#include <setjmp.h>
+#include <signal.h>
+
+#include "validate_common.h"
+#include "lib/poc_time.h"
+
+#define DEFAULT_READS 1000000
+#define PMU_READS     50000     // one syscall each
+#define CAL_NS        20000000  // 20 ms calibration spin
+#define DISTINCT_MAX  4096
+
+static sigjmp_buf g_trap;
+static volatile uint64_t g_sink;   // keeps the cost loop's reads live
+
+static void on_sigill(int sig) {
+    (void)sig;
+    siglongjmp(g_trap, 1);
+}
+
+// 1 if a read of src returns without trapping.
+static int probe(PocTsSource src) {
+    struct sigaction sa, old_ill, old_bus;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_sigill;
+    sigaction(SIGILL, &sa, &old_ill);
+    sigaction(SIGBUS, &sa, &old_bus);
+    int ok = 0;
+    if (sigsetjmp(g_trap, 1) == 0) {
+        (void)poc_ts_read(src);
+        ok = 1;
+    }
+    sigaction(SIGILL, &old_ill, NULL);
+    sigaction(SIGBUS, &old_bus, NULL);
+    return ok;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void bench_one(PocTsSource src, int n_reads, double ns_per_mach) {
+    const char *name = poc_ts_name(src);
+    if (!poc_ts_available(src)) {
+        printf("  %-18s not on this target\n", name);
+        return;
+    }
+    if (src == POC_TS_PMU && poc_ts_pmu_init() != 0) {
+        printf("  %-18s not permitted (needs root and kperf)\n", name);
+        return;
+    }
+    if (!probe(src)) {
+        printf("  %-18s trapped (EL0 access disabled)\n", name);
+        return;
+    }
+    if (src == POC_TS_PMU && n_reads > PMU_READS) n_reads = PMU_READS;
+
+    // Rate: spin so a per-thread cycle counter keeps counting
+    uint64_t m0 = mach_absolute_time(), s0 = poc_ts_read(src), m1;
+    do m1 = mach_absolute_time(); while ((m1 - m0) * ns_per_mach < CAL_NS);
+    uint64_t s1 = poc_ts_read(src);
+    double ticks_per_ns = (double)(s1 - s0) / ((m1 - m0) * ns_per_mach);
+
+    // Cost: back-to-back reads, each result folded in so none is dropped
+    uint64_t sink = 0;
+    m0 = mach_absolute_time();
+    for (int i = 0; i < n_reads; i++) sink ^= poc_ts_read(src);
+    m1 = mach_absolute_time();
+    g_sink = sink;
+    double ns_per_read = (m1 - m0) * ns_per_mach / n_reads;
+
+    // Resolution: consecutive deltas
+    uint64_t *d = malloc((size_t)n_reads * sizeof(uint64_t));
+    if (!d) return;
+    uint64_t prev = poc_ts_read(src);
+    for (int i = 0; i < n_reads; i++) {
+        uint64_t now = poc_ts_read(src);
+        d[i] = now - prev;
+        prev = now;
+    }
+    qsort(d, (size_t)n_reads, sizeof(uint64_t), cmp_u64);
+    int zeros = 0;
+    while (zeros < n_reads && d[zeros] == 0) zeros++;
+    uint64_t min_delta = zeros < n_reads ? d[zeros] : 0;
+    int distinct = 0;
+    for (int i = zeros; i < n_reads && distinct < DISTINCT_MAX; i++)
+        if (i == zeros || d[i] != d[i - 1]) distinct++;
+    free(d);
+
+    printf("  %-18s %8.3f  %8.2f  %7llu  %8.2f  %7.1f  %8d\n", name, ticks_per_ns,
+           ns_per_read, (unsigned long long)min_delta,
+           ticks_per_ns > 0 ? min_delta / ticks_per_ns : 0.0, 100.0 * zeros / n_reads,
+           distinct);
+}
+
+int main(int argc, char **argv) {
+    int n_reads = DEFAULT_READS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n_reads = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [-n reads]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n_reads < 1000) n_reads = 1000;
+
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    double ns_per_mach = (double)tb.numer / tb.denom;
+
+    printf("# Timestamp sources — %d reads each\n", n_reads);
+    printf("# compiled-in poc_ts(): %s\n\n", poc_ts_name(POC_TS_SOURCE));
+    printf("  %-18s %8s  %8s  %7s  %8s  %7s  %8s\n", "source", "ticks/ns", "ns/read",
+           "min Δ", "min Δ ns", "zero Δ%", "distinct");
+    for (int s = 0; s < POC_TS_N_SOURCES; s++) bench_one((PocTsSource)s, n_reads, ns_per_mach);
+    return 0;
+}
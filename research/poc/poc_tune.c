@@ -0,0 +1,204 @@
+// poc_tune.c — Search collector parameters for the best H∞ × samples/s
+//
+// For every collector with entries in the registry's parameter table
+// (collectors/registry.c), or the ones named: score the defaults, run a
+// coarse log-spaced grid over all of that collector's parameters, then
+// refine the best point one parameter at a time with a shrinking
+// multiplicative step. A trial is one collect() call of -n samples; its
+// score is XOR-fold H∞ (bits/sample) × samples/s, averaged over -r trials.
+// The winner is written to the tune file under this machine's model, next
+// to whatever other models the file already holds; when its re-scored
+// result does not beat the default, the default is written instead:
+//
+//   ./poc_tune [-o poc_tune.txt] [-n samples] [-r reps] [--dry] [name ...]
+//   POC_TUNE=poc_tune.txt ./poc_runner validate cpu_io_beat
+//
+// Short trials overstate H∞ a little (few samples per bin), equally for
+// every point, so they rank configurations fine; validate the winner with
+// the full harness before trusting the absolute number.
+//
+// Compile: make poc_tune
+
+#include <math.h>
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+
+#define TUNE_MAX_PARAMS 8
+#define TUNE_MAX_GRID   7
+#define TUNE_REFINE     6       // step halvings (in log space)
+#define DEFAULT_TRIAL_N 5000
+#define DEFAULT_REPS    2
+
+static double g_ns_per_tick;
+static uint64_t *g_buf;
+
+static double score_once(const PocCollector *c, int n) {
+    uint64_t t0 = mach_absolute_time();
+    int v = poc_collect(c, g_buf, n);
+    uint64_t t1 = mach_absolute_time();
+    if (v < POC_MIN_VALID || t1 == t0) return 0;
+    Stats s = compute_stats(g_buf, v);
+    return s.min_entropy * v / ((t1 - t0) * g_ns_per_tick / 1e9);
+}
+
+static double score(const PocCollector *c, int n, int reps) {
+    double sum = 0;
+    for (int r = 0; r < reps; r++) sum += score_once(c, n);
+    return sum / reps;
+}
+
+// k-th of `points` values spaced evenly in log(1 + v) between min and max.
+static int grid_value(const PocParam *p, int k, int points) {
+    double lo = log1p(p->min), hi = log1p(p->max);
+    double v = expm1(lo + (hi - lo) * k / (points - 1));
+    int iv = (int)lround(v);
+    return iv < p->min ? p->min : iv > p->max ? p->max : iv;
+}
+
+static void print_point(const PocParam **ps, int np, double s, const char *tag) {
+    printf("   ");
+    for (int i = 0; i < np; i++) printf(" %s=%-6d", ps[i]->name, *ps[i]->value);
+    printf("  %12.0f bits/s  %s\n", s, tag);
+}
+
+// Tune one collector in place; its parameters hold the winner on return.
+static double tune(const PocCollector *c, int n, int reps) {
+    const PocParam *ps[TUNE_MAX_PARAMS];
+    int np = 0;
+    for (int i = 0; i < poc_n_params && np < TUNE_MAX_PARAMS; i++)
+        if (strcmp(poc_params[i].collector, c->name) == 0) ps[np++] = &poc_params[i];
+    if (np == 0) return 0;
+
+    printf("## %s (%d parameter%s)\n", c->name, np, np == 1 ? "" : "s");
+    poc_collect(c, g_buf, n < 1024 ? n : 1024);   // warmup
+
+    int best[TUNE_MAX_PARAMS];
+    for (int i = 0; i < np; i++) best[i] = *ps[i]->value = ps[i]->def;
+    double best_s = score(c, n, reps);
+    const double default_s = best_s;
+    print_point(ps, np, best_s, "default");
+
+    // Coarse grid: fewer points per axis as the dimension grows
+    int points = np == 1 ? TUNE_MAX_GRID : np == 2 ? 5 : np == 3 ? 4 : 3;
+    int total = 1;
+    for (int i = 0; i < np; i++) total *= points;
+    for (int g = 0; g < total; g++) {
+        for (int i = 0, rest = g; i < np; i++, rest /= points)
+            *ps[i]->value = grid_value(ps[i], rest % points, points);
+        double s = score(c, n, reps);
+        if (s > best_s) {
+            best_s = s;
+            for (int i = 0; i < np; i++) best[i] = *ps[i]->value;
+            print_point(ps, np, s, "grid");
+        }
+    }
+
+    // Local refinement around the grid winner: try value × / ÷ step per
+    // parameter, keep any improvement, shrink the step when none helps
+    double step = pow(2.0, 2.0);
+    for (int round = 0; round < TUNE_REFINE; round++) {
+        int improved = 0;
+        for (int i = 0; i < np; i++) {
+            for (int dir = -1; dir <= 1; dir += 2) {
+                for (int k = 0; k < np; k++) *ps[k]->value = best[k];
+                double v = log1p(best[i]) + dir * log(step);
+                int iv = (int)lround(expm1(v));
+                if (iv == best[i]) iv += dir;
+                if (iv < ps[i]->min || iv > ps[i]->max) continue;
+                *ps[i]->value = iv;
+                double s = score(c, n, reps);
+                if (s > best_s) {
+                    best_s = s;
+                    best[i] = iv;
+                    improved = 1;
+                    print_point(ps, np, s, "refine");
+                }
+            }
+        }
+        if (!improved) step = sqrt(step);
+        if (step < 1.05) break;
+    }
+
+    for (int i = 0; i < np; i++) *ps[i]->value = best[i];
+    // Re-score the winner so a lucky trial does not decide alone
+    best_s = score(c, n, reps);
+    print_point(ps, np, best_s, "best (re-scored)");
+    if (best_s <= default_s) {
+        for (int i = 0; i < np; i++) *ps[i]->value = ps[i]->def;
+        printf("    does not beat the default on re-scoring; keeping the default\n\n");
+        best_s = default_s;
+    } else {
+        printf("    %.2f× the default\n\n", default_s > 0 ? best_s / default_s : 0);
+    }
+    if (c->release) c->release();
+    return best_s;
+}
+
+static int usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [-o poc_tune.txt] [-n samples] [-r reps] [--dry] [name ...]\n",
+            argv0);
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    const char *out_path = "poc_tune.txt";
+    int n = DEFAULT_TRIAL_N, reps = DEFAULT_REPS, dry = 0;
+    int first = 1;
+    while (first < argc && argv[first][0] == '-') {
+        if (strcmp(argv[first], "--dry") == 0) {
+            dry = 1;
+            first++;
+            continue;
+        }
+        if (first + 1 >= argc) return usage(argv[0]);
+        if (strcmp(argv[first], "-o") == 0) out_path = argv[first + 1];
+        else if (strcmp(argv[first], "-n") == 0) n = atoi(argv[first + 1]);
+        else if (strcmp(argv[first], "-r") == 0) reps = atoi(argv[first + 1]);
+        else return usage(argv[0]);
+        first += 2;
+    }
+    if (n < POC_MIN_VALID || reps < 1) return usage(argv[0]);
+
+    const PocCollector *sel[64];
+    int n_sel = 0;
+    if (first == argc) {
+        for (int i = 0; i < poc_n_params && n_sel < 64; i++)
+            if (i == 0 || strcmp(poc_params[i].collector, poc_params[i - 1].collector) != 0)
+                sel[n_sel++] = poc_collector_find(poc_params[i].collector);
+    } else {
+        for (int i = first; i < argc && n_sel < 64; i++) {
+            const PocCollector *c = poc_collector_find(argv[i]);
+            if (!c) {
+                fprintf(stderr, "unknown collector: %s (see `poc_runner list`)\n", argv[i]);
+                return 2;
+            }
+            sel[n_sel++] = c;
+        }
+    }
+
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    g_ns_per_tick = (double)tb.numer / tb.denom;
+    g_buf = malloc((size_t)n * sizeof(uint64_t));
+    if (!g_buf) return 1;
+
+    const char *model = poc_machine_model();
+    printf("# Collector parameter tuning — %s, %d samples × %d per trial\n\n", model, n, reps);
+    int rc = 0;
+    for (int i = 0; i < n_sel; i++) {
+        if (!sel[i]) continue;
+        double s = tune(sel[i], n, reps);
+        if (s <= 0) {
+            printf("## %s: no tunable parameters or no samples\n\n", sel[i]->name);
+            continue;
+        }
+        if (!dry && poc_params_save(out_path, model, sel[i]->name, s) != 0) {
+            perror(out_path);
+            rc = 1;
+        }
+    }
+    if (!dry && rc == 0) printf("Wrote %s (apply with POC_TUNE=%s)\n", out_path, out_path);
+    free(g_buf);
+    return rc;
+}
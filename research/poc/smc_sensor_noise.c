@@ -2,105 +2,15 @@
 // The LSBs of temperature/voltage/current readings contain ADC quantization noise.
 // We probe the SMC via IOKit to read raw sensor values at high frequency.
 // The noise floor of the ADC is thermodynamic (Johnson-Nyquist noise).
+// All keys are read once per tick through lib/poc_smc.h, one READ_BYTES each.
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <math.h>
-#include <IOKit/IOKitLib.h>
-#include <CoreFoundation/CoreFoundation.h>
-
-// SMC data types
-typedef struct {
-    char key[5];
-    uint32_t dataSize;
-    uint32_t dataType;
-    uint8_t bytes[32];
-} SMCVal_t;
-
-typedef struct {
-    uint32_t key;
-    uint8_t vers[6];
-    uint8_t pLimitData[16];
-    uint8_t vMajor;
-    uint8_t vMinor;
-    uint8_t vBuild;
-    uint8_t rsvd;
-    uint32_t dataSize;
-    uint32_t dataType;
-    uint8_t dataAttributes;
-    uint8_t data[32];
-    uint8_t padding[2];
-} SMCKeyData_t;
-
-#define KERNEL_INDEX_SMC 2
-#define SMC_CMD_READ_KEYINFO 9
-#define SMC_CMD_READ_BYTES 5
-
-static io_connect_t conn = 0;
-
-static uint32_t str_to_uint32(const char *str) {
-    uint32_t v = 0;
-    v = ((uint32_t)str[0] << 24) | ((uint32_t)str[1] << 16) |
-        ((uint32_t)str[2] << 8) | (uint32_t)str[3];
-    return v;
-}
-
-static kern_return_t smc_call(int index, SMCKeyData_t *in, SMCKeyData_t *out) {
-    size_t inSize = sizeof(SMCKeyData_t);
-    size_t outSize = sizeof(SMCKeyData_t);
-    return IOConnectCallStructMethod(conn, index, in, inSize, out, &outSize);
-}
-
-static kern_return_t smc_read_key(const char *key, SMCVal_t *val) {
-    SMCKeyData_t in = {0}, out = {0};
-
-    in.key = str_to_uint32(key);
-    in.data[8] = SMC_CMD_READ_KEYINFO;
-
-    kern_return_t kr = smc_call(KERNEL_INDEX_SMC, &in, &out);
-    if (kr != KERN_SUCCESS) return kr;
-
-    val->dataSize = out.dataSize;
-    val->dataType = out.dataType;
 
-    memset(&in, 0, sizeof(in));
-    in.key = str_to_uint32(key);
-    in.data[8] = SMC_CMD_READ_BYTES;
-    in.dataSize = val->dataSize;
-
-    kr = smc_call(KERNEL_INDEX_SMC, &in, &out);
-    if (kr != KERN_SUCCESS) return kr;
-
-    memcpy(val->bytes, out.data, sizeof(val->bytes));
-    strncpy(val->key, key, 4);
-    val->key[4] = 0;
-    return KERN_SUCCESS;
-}
-
-static kern_return_t smc_open(void) {
-    io_service_t service = IOServiceGetMatchingService(
-        kIOMainPortDefault, IOServiceMatching("AppleSMC"));
-    if (!service) return KERN_FAILURE;
-
-    kern_return_t kr = IOServiceOpen(service, mach_task_self(), 0, &conn);
-    IOObjectRelease(service);
-    return kr;
-}
-
-static void smc_close(void) {
-    IOServiceClose(conn);
-}
-
-// Convert SMC raw bytes to a uint64_t for analysis
-static uint64_t smc_val_to_uint64(SMCVal_t *val) {
-    uint64_t v = 0;
-    for (uint32_t i = 0; i < val->dataSize && i < 8; i++) {
-        v = (v << 8) | val->bytes[i];
-    }
-    return v;
-}
+#include "lib/poc_smc.h"
 
 #define N_SAMPLES 20000
 #define N_KEYS 8
@@ -114,7 +24,7 @@ int main(void) {
         "VCAC", "VC0C", "IC0C", "IC1C",  // voltages/currents
     };
 
-    if (smc_open() != KERN_SUCCESS) {
+    if (poc_smc_open() != 0) {
         fprintf(stderr, "Failed to open SMC connection. Try running with sudo.\n");
         return 1;
     }
@@ -122,17 +32,27 @@ int main(void) {
     printf("# SMC Sensor ADC Noise Probe\n");
     printf("# Collecting %d samples from %d SMC keys...\n\n", N_SAMPLES, N_KEYS);
 
-    // For each key, collect rapid samples and analyze LSB entropy
-    for (int k = 0; k < N_KEYS; k++) {
-        uint64_t samples[N_SAMPLES];
-        int valid = 0;
+    PocSmcKey smc[N_KEYS];
+    for (int k = 0; k < N_KEYS; k++) poc_smc_key_init(&smc[k], keys[k]);
 
-        for (int i = 0; i < N_SAMPLES; i++) {
-            SMCVal_t val = {0};
-            if (smc_read_key(keys[k], &val) == KERN_SUCCESS && val.dataSize > 0) {
-                samples[valid++] = smc_val_to_uint64(&val);
-            }
+    // Read the whole key set per tick; each key keeps its own series
+    uint64_t *series = malloc((size_t)N_KEYS * N_SAMPLES * sizeof(uint64_t));
+    int counts[N_KEYS] = {0};
+    if (!series) {
+        poc_smc_close();
+        return 1;
+    }
+    for (int i = 0; i < N_SAMPLES; i++) {
+        for (int k = 0; k < N_KEYS; k++) {
+            if (smc[k].available && poc_smc_read(&smc[k]) == 0)
+                series[(size_t)k * N_SAMPLES + counts[k]++] = poc_smc_value(&smc[k]);
         }
+    }
+
+    // For each key, analyze LSB entropy
+    for (int k = 0; k < N_KEYS; k++) {
+        uint64_t *samples = &series[(size_t)k * N_SAMPLES];
+        int valid = counts[k];
 
         if (valid < 100) {
             printf("Key %s: only %d valid reads, skipping\n", keys[k], valid);
@@ -197,6 +117,7 @@ int main(void) {
         printf("\n");
     }
 
-    smc_close();
+    free(series);
+    poc_smc_close();
     return 0;
 }
@@ -9,27 +9,42 @@
 // Unlike the ffmpeg-based audio_noise source, this uses CoreAudio directly
 // for lower latency and access to raw float samples without resampling.
 //
-// Build: cc -O2 -o thermal_audio_adc_noise thermal_audio_adc_noise.c \
-//        -framework CoreAudio -framework AudioToolbox -framework CoreFoundation -lm
+// Capture is continuous: the AudioQueue callback only copies into a
+// preallocated lock-free SPSC ring (lib/poc_spsc.h) — no allocation or
+// locking on the audio thread — and an analyzer thread drains it,
+// updating LSB / nibble / delta histograms incrementally.
+//
+//   ./thermal_audio_adc_noise          one report after N_SAMPLES samples
+//   ./thermal_audio_adc_noise -t SEC   progress line every second for SEC
+//                                      seconds (0 = until interrupted), then the report
+//
+// Build: make thermal_audio_adc_noise
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <unistd.h>
 #include <mach/mach_time.h>
 #include <CoreAudio/CoreAudio.h>
 #include <AudioToolbox/AudioToolbox.h>
 
+#include "lib/poc_spsc.h"
+#include "lib/poc_stream.h"
+
 #define N_SAMPLES 20000
 #define BUFFER_SIZE 4096
+#define RING_SAMPLES (1 << 18)  // ~6 s of 44.1 kHz mono headroom for the analyzer
+#define CHUNK 4096
+#define N_FIRST 20
 
-// Ring buffer for captured audio
-static float g_audio_buffer[N_SAMPLES * 2];
-static volatile int g_samples_collected = 0;
+static PocSpsc g_ring;
+static atomic_int g_stop;
 
-// AudioQueue callback — copies raw float samples into our buffer
+// AudioQueue callback — copies raw float samples into the ring, nothing else
 static void audio_input_callback(
     void *inUserData,
     AudioQueueRef inAQ,
@@ -38,24 +53,93 @@ static void audio_input_callback(
     UInt32 inNumPackets,
     const AudioStreamPacketDescription *inPacketDesc)
 {
-    float *samples = (float *)inBuffer->mAudioData;
-    int n = inBuffer->mAudioDataByteSize / sizeof(float);
-
-    for (int i = 0; i < n && g_samples_collected < N_SAMPLES * 2; i++) {
-        g_audio_buffer[g_samples_collected++] = samples[i];
-    }
+    poc_spsc_write(&g_ring, inBuffer->mAudioData, inBuffer->mAudioDataByteSize / sizeof(float));
 
     // Re-enqueue the buffer for continuous capture
     AudioQueueEnqueueBuffer(inAQ, inBuffer, 0, NULL);
 }
 
-// Entropy analysis helper
-static void analyze_bytes(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
+// Running state of every analysis method; touched only by the analyzer thread
+// until it is joined.
+typedef struct {
+    uint64_t n;
+    uint64_t hist_lsb[256];     // Method 1: mantissa byte 0
+    uint64_t lsb_max;           // largest hist_lsb bin, for progress H∞
+    uint64_t hist_nibble[256];  // Method 1: packed low nibbles
+    uint64_t n_nibble;
+    int nibble_pending;
+    uint8_t nibble_hi;
+    double sum_sq, peak;        // Method 2
+    uint64_t hist_dlsb[256];    // Method 3: delta LSBs
+    uint64_t hist_dxor[256];    // Method 3: XOR-folded deltas
+    uint32_t prev_bits;
+    PocStream lsb_stream;       // autocorrelation of mantissa LSBs
+    float first[N_FIRST];
+} Analyzer;
+
+static Analyzer g_an;
+// Published after every chunk for the progress line.
+static _Atomic uint64_t g_analyzed, g_analyzed_lsb_max;
+
+static void analyzer_push(Analyzer *a, const uint32_t *bits, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t b = bits[i];
+        float f;
+        memcpy(&f, &b, sizeof(f));
+        if (a->n < N_FIRST) a->first[a->n] = f;
+
+        // Method 1: Raw float LSBs (lower 8 mantissa bits) and 4-bit nibbles
+        if (++a->hist_lsb[b & 0xFF] > a->lsb_max) a->lsb_max = a->hist_lsb[b & 0xFF];
+        poc_stream_push(&a->lsb_stream, b & 0xFF);
+        if (a->nibble_pending) {
+            a->hist_nibble[(a->nibble_hi << 4) | (b & 0x0F)]++;
+            a->n_nibble++;
+        } else {
+            a->nibble_hi = b & 0x0F;
+        }
+        a->nibble_pending ^= 1;
 
+        // Method 2: Sample magnitude
+        double v = fabs(f);
+        a->sum_sq += v * v;
+        if (v > a->peak) a->peak = v;
+
+        // Method 3: Delta of consecutive samples
+        if (a->n > 0) {
+            int32_t delta = (int32_t)b - (int32_t)a->prev_bits;
+            a->hist_dlsb[(uint8_t)(delta & 0xFF)]++;
+            // XOR-fold for wider coverage
+            uint32_t ud = (uint32_t)delta;
+            a->hist_dxor[(ud & 0xFF) ^ ((ud >> 8) & 0xFF) ^
+                         ((ud >> 16) & 0xFF) ^ ((ud >> 24) & 0xFF)]++;
+        }
+        a->prev_bits = b;
+        a->n++;
+    }
+}
+
+static void *analyzer_thread(void *arg) {
+    (void)arg;
+    static uint32_t chunk[CHUNK];
+    for (;;) {
+        uint32_t got = poc_spsc_read(&g_ring, chunk, CHUNK);
+        if (got) {
+            analyzer_push(&g_an, chunk, got);
+            atomic_store_explicit(&g_analyzed_lsb_max, g_an.lsb_max, memory_order_relaxed);
+            atomic_store_explicit(&g_analyzed, g_an.n, memory_order_release);
+            continue;
+        }
+        if (atomic_load(&g_stop)) break;
+        usleep(2000);
+    }
+    return NULL;
+}
+
+// Entropy analysis helper
+static void analyze_hist(const char *label, const uint64_t hist[256], uint64_t n) {
     double shannon = 0.0;
-    int max_count = 0, unique = 0;
+    uint64_t max_count = 0;
+    int unique = 0;
     for (int i = 0; i < 256; i++) {
         if (hist[i] > 0) {
             unique++;
@@ -66,14 +150,23 @@ static void analyze_bytes(const char *label, const uint8_t *data, int n) {
     }
     double min_entropy = -log2((double)max_count / n);
 
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
+    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%llu\n",
+           label, shannon, min_entropy, unique, (unsigned long long)n);
 }
 
-int main(void) {
+int main(int argc, char **argv) {
+    double run_sec = -1;  // < 0: stop after N_SAMPLES
+    if (argc > 2 && strcmp(argv[1], "-t") == 0) run_sec = atof(argv[2]);
+
     printf("# Audio ADC Noise Floor — Johnson-Nyquist Thermal Noise\n");
     printf("# Capturing raw audio from microphone with CoreAudio...\n\n");
 
+    if (poc_spsc_init(&g_ring, RING_SAMPLES) != 0) {
+        fprintf(stderr, "Failed to allocate the capture ring\n");
+        return 1;
+    }
+    poc_stream_init(&g_an.lsb_stream, 5);
+
     // Set up audio format: 32-bit float, mono, 44100 Hz
     AudioStreamBasicDescription format = {0};
     format.mSampleRate = 44100.0;
@@ -104,125 +197,94 @@ int main(void) {
         AudioQueueEnqueueBuffer(queue, buf, 0, NULL);
     }
 
+    pthread_t analyzer;
+    if (pthread_create(&analyzer, NULL, analyzer_thread, NULL) != 0) {
+        fprintf(stderr, "Failed to start the analyzer thread\n");
+        return 1;
+    }
+
     // Start recording
     status = AudioQueueStart(queue, NULL);
     if (status != noErr) {
         fprintf(stderr, "AudioQueueStart failed: %d\n", (int)status);
+        atomic_store(&g_stop, 1);
+        pthread_join(analyzer, NULL);
         return 1;
     }
 
-    printf("Recording... (collecting %d float samples)\n", N_SAMPLES);
+    if (run_sec < 0) {
+        printf("Recording... (collecting %d float samples)\n", N_SAMPLES);
 
-    // Wait for samples
-    int timeout_ms = 5000;
-    while (g_samples_collected < N_SAMPLES && timeout_ms > 0) {
-        usleep(10000); // 10ms
-        timeout_ms -= 10;
+        // Wait for samples
+        int timeout_ms = 5000;
+        while (atomic_load_explicit(&g_analyzed, memory_order_acquire) < N_SAMPLES &&
+               timeout_ms > 0) {
+            usleep(10000); // 10ms
+            timeout_ms -= 10;
+        }
+    } else {
+        printf("Recording continuously%s\n", run_sec > 0 ? "" : " (Ctrl-C to stop)");
+        for (long sec = 1; run_sec == 0 || sec <= (long)run_sec; sec++) {
+            sleep(1);
+            uint64_t n = atomic_load_explicit(&g_analyzed, memory_order_acquire);
+            uint64_t max = atomic_load_explicit(&g_analyzed_lsb_max, memory_order_relaxed);
+            double me = n && max ? -log2((double)max / n) : 0.0;
+            printf("  t=%lds  n=%llu  backlog=%llu  dropped=%llu  byte-0 H∞=%.3f\n", sec,
+                   (unsigned long long)n, (unsigned long long)poc_spsc_size(&g_ring),
+                   (unsigned long long)poc_spsc_dropped(&g_ring), me);
+            fflush(stdout);
+        }
     }
 
     AudioQueueStop(queue, true);
     AudioQueueDispose(queue, true);
+    atomic_store(&g_stop, 1);
+    pthread_join(analyzer, NULL);
 
-    int n = g_samples_collected;
+    const Analyzer *a = &g_an;
+    uint64_t n = a->n;
     if (n < 100) {
-        fprintf(stderr, "Only collected %d samples, need at least 100\n", n);
+        fprintf(stderr, "Only collected %llu samples, need at least 100\n", (unsigned long long)n);
         return 1;
     }
-    printf("Collected %d float samples\n\n", n);
-
-    // Method 1: Raw float LSBs
-    // Reinterpret float bits, extract lower 8 bits (mantissa LSBs)
-    uint8_t *float_lsbs = malloc(n);
-    uint8_t *float_lsb4 = malloc(n);
-    for (int i = 0; i < n; i++) {
-        uint32_t bits;
-        memcpy(&bits, &g_audio_buffer[i], sizeof(bits));
-        float_lsbs[i] = bits & 0xFF;
-        float_lsb4[i] = bits & 0x0F;
-    }
+    printf("Collected %llu float samples (%llu dropped by a full ring)\n\n",
+           (unsigned long long)n, (unsigned long long)poc_spsc_dropped(&g_ring));
 
     printf("=== Method 1: Float mantissa LSBs ===\n");
-    analyze_bytes("Raw byte-0 (mantissa LSBs)", float_lsbs, n);
-
-    // Pack nibbles for 4-bit analysis
-    int n_packed = n / 2;
-    uint8_t *packed_nibbles = malloc(n_packed);
-    for (int i = 0; i < n_packed; i++) {
-        packed_nibbles[i] = (float_lsb4[i*2] << 4) | float_lsb4[i*2+1];
-    }
-    analyze_bytes("Packed 4-bit nibbles", packed_nibbles, n_packed);
+    analyze_hist("Raw byte-0 (mantissa LSBs)", a->hist_lsb, n);
+    analyze_hist("Packed 4-bit nibbles", a->hist_nibble, a->n_nibble);
 
     // Method 2: Sample magnitude — quiet mic means values near zero
     // The absolute value's distribution tells us about noise floor
     printf("\n=== Method 2: Sample magnitude analysis ===\n");
-    double sum_sq = 0.0;
-    double max_val = 0.0;
-    for (int i = 0; i < n; i++) {
-        double v = fabs(g_audio_buffer[i]);
-        sum_sq += v * v;
-        if (v > max_val) max_val = v;
-    }
-    double rms = sqrt(sum_sq / n);
+    double rms = sqrt(a->sum_sq / n);
     printf("  RMS level: %.8f (%.1f dBFS)\n", rms, 20.0 * log10(rms + 1e-30));
-    printf("  Peak level: %.8f (%.1f dBFS)\n", max_val, 20.0 * log10(max_val + 1e-30));
+    printf("  Peak level: %.8f (%.1f dBFS)\n", a->peak, 20.0 * log10(a->peak + 1e-30));
 
-    // Method 3: Delta of consecutive samples
     printf("\n=== Method 3: Consecutive sample deltas ===\n");
-    int nd = n - 1;
-    uint8_t *delta_lsbs = malloc(nd);
-    uint8_t *delta_xor = malloc(nd);
-    for (int i = 0; i < nd; i++) {
-        uint32_t bits_a, bits_b;
-        memcpy(&bits_a, &g_audio_buffer[i], sizeof(bits_a));
-        memcpy(&bits_b, &g_audio_buffer[i+1], sizeof(bits_b));
-        int32_t delta = (int32_t)bits_b - (int32_t)bits_a;
-        delta_lsbs[i] = (uint8_t)(delta & 0xFF);
-        // XOR-fold for wider coverage
-        uint32_t ud = (uint32_t)delta;
-        delta_xor[i] = (ud & 0xFF) ^ ((ud >> 8) & 0xFF) ^
-                        ((ud >> 16) & 0xFF) ^ ((ud >> 24) & 0xFF);
-    }
-    analyze_bytes("Delta LSBs", delta_lsbs, nd);
-    analyze_bytes("Delta XOR-folded", delta_xor, nd);
+    analyze_hist("Delta LSBs", a->hist_dlsb, n - 1);
+    analyze_hist("Delta XOR-folded", a->hist_dxor, n - 1);
 
-    // Method 4: Interleaved timing — time between AudioQueue callbacks
     printf("\n=== Method 4: Sample statistics ===\n");
     printf("  First 20 raw float values:\n    ");
-    for (int i = 0; i < 20 && i < n; i++) {
-        printf("%.8f ", g_audio_buffer[i]);
+    for (int i = 0; i < N_FIRST && i < (int)n; i++) {
+        printf("%.8f ", a->first[i]);
     }
     printf("\n");
     printf("  First 20 mantissa LSBs:\n    ");
-    for (int i = 0; i < 20 && i < n; i++) {
-        printf("%02x ", float_lsbs[i]);
+    for (int i = 0; i < N_FIRST && i < (int)n; i++) {
+        uint32_t bits;
+        memcpy(&bits, &a->first[i], sizeof(bits));
+        printf("%02x ", bits & 0xFF);
     }
     printf("\n");
 
     // Autocorrelation of LSBs (lag 1-5)
     printf("\n=== Autocorrelation (mantissa LSBs) ===\n");
-    double mean = 0;
-    for (int i = 0; i < n; i++) mean += float_lsbs[i];
-    mean /= n;
-    double var = 0;
-    for (int i = 0; i < n; i++) {
-        double d = float_lsbs[i] - mean;
-        var += d * d;
-    }
-    var /= n;
     for (int lag = 1; lag <= 5; lag++) {
-        double cov = 0;
-        for (int i = 0; i < n - lag; i++) {
-            cov += (float_lsbs[i] - mean) * (float_lsbs[i+lag] - mean);
-        }
-        cov /= (n - lag);
-        printf("  Lag %d: r=%.4f\n", lag, cov / var);
+        printf("  Lag %d: r=%.4f\n", lag, poc_stream_autocorrelation(&a->lsb_stream, lag));
     }
 
-    free(float_lsbs);
-    free(float_lsb4);
-    free(packed_nibbles);
-    free(delta_lsbs);
-    free(delta_xor);
-
+    poc_spsc_free(&g_ring);
     return 0;
 }
@@ -14,6 +14,14 @@
 // Unlike the existing audio_pll_jitter.c, this version uses a tighter
 // measurement loop and probes both input and output devices.
 //
+// With --stamps the property loops are skipped: the HAL pushes host/sample
+// time pairs from an IOProc (lib/poc_audioclock.h) and the PLL phase error
+// between consecutive pairs is analysed instead of property round-trip
+// times. A dense AudioDeviceGetCurrentTime stream follows for comparison;
+// it is HAL-interpolated and measures the interpolator, not the PLL.
+//
+//   ./thermal_audio_pll_jitter [--stamps]
+//
 // Build: cc -O2 -o thermal_audio_pll_jitter thermal_audio_pll_jitter.c \
 //        -framework CoreAudio -framework AudioToolbox -framework CoreFoundation -lm
 
@@ -25,29 +33,63 @@
 #include <mach/mach_time.h>
 #include <CoreAudio/CoreAudio.h>
 
+#include "lib/poc_arena.h"
+#include "lib/poc_audioclock.h"
+#include "lib/poc_stats.h"
+
 #define N_SAMPLES 20000
+#define N_IOPROC_STAMPS 4000
+#define IOPROC_TIMEOUT_S 15.0
+
+// Sample storage, pre-faulted and locked in main() and reset per device.
+// Sized for both paths: the stamp buffer and two phase-error passes, and
+// the three query timing series and their five byte views
+static PocSampleArena g_arena;
+#define ARENA_BYTES                                                                 \
+    ((size_t)N_SAMPLES * (sizeof(PocAudioStamp) + 2 * (sizeof(int64_t) + 1) +      \
+                          3 * sizeof(uint64_t) + 5) + 13 * 64)
+
+// XOR-fold each phase error and report it under `label`.
+static void analyze_phase_error(const char *label, const PocAudioStamp *s, int n) {
+    int64_t *err = poc_samples_alloc(&g_arena, (size_t)(n > 1 ? n : 2) * sizeof(int64_t));
+    double tps = 0;
+    int m = poc_audioclock_phase_error(s, n, err, &tps);
+    if (m < 2) {
+        printf("  %s: too few time pairs (%d)\n", label, n);
+        return;
+    }
 
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
-        }
+    uint8_t *fold = POC_SAMPLES_U8(&g_arena, m);
+    double rms = 0;
+    for (int i = 0; i < m; i++) {
+        uint64_t e = (uint64_t)err[i];
+        fold[i] = (e & 0xFF) ^ ((e >> 8) & 0xFF) ^
+                  ((e >> 16) & 0xFF) ^ ((e >> 24) & 0xFF);
+        rms += (double)err[i] * (double)err[i];
     }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
+    printf("  %s: %d pairs, %.4f ticks/sample, phase error rms %.1f ticks\n",
+           label, n, tps, sqrt(rms / m));
+    analyze_entropy("Phase error XOR-fold", fold, m);
 }
 
-static void analyze_device(AudioDeviceID device, const char *device_name) {
+static void analyze_stamps(AudioDeviceID device) {
+    printf("\n  === Host/sample time pairs ===\n");
+    PocAudioClock clk;
+    if (poc_audioclock_start(&clk, device) != 0) {
+        printf("  Cannot start an IOProc on this device\n");
+        return;
+    }
+    PocAudioStamp *s = poc_samples_alloc(&g_arena, N_SAMPLES * sizeof(PocAudioStamp));
+    int n = poc_audioclock_read(&clk, s, N_IOPROC_STAMPS, IOPROC_TIMEOUT_S);
+    analyze_phase_error("IOProc", s, n);
+    n = poc_audioclock_poll(&clk, s, N_SAMPLES);
+    analyze_phase_error("AudioDeviceGetCurrentTime (HAL-interpolated, not PLL)", s, n);
+    poc_audioclock_stop(&clk);
+}
+
+static void analyze_device(AudioDeviceID device, const char *device_name, int stamps) {
     printf("\n--- Device: %s (ID=%u) ---\n", device_name, device);
+    poc_samples_reset(&g_arena);
 
     // Get sample rate
     AudioObjectPropertyAddress addr = {
@@ -60,9 +102,14 @@ static void analyze_device(AudioDeviceID device, const char *device_name) {
     AudioObjectGetPropertyData(device, &addr, 0, NULL, &size, &sampleRate);
     printf("  Sample rate: %.0f Hz\n", sampleRate);
 
+    if (stamps) {
+        analyze_stamps(device);
+        return;
+    }
+
     // Method 1: Rapid audio device property queries — timing jitter
     // Each query crosses the audio/CPU clock domain boundary
-    uint64_t query_timings[N_SAMPLES];
+    uint64_t *query_timings = POC_SAMPLES_U64(&g_arena, N_SAMPLES);
 
     addr.mSelector = kAudioDevicePropertyDeviceIsRunning;
     for (int i = 0; i < N_SAMPLES; i++) {
@@ -77,8 +124,8 @@ static void analyze_device(AudioDeviceID device, const char *device_name) {
     }
 
     // Analyze raw timing
-    uint8_t *qt_lsb = malloc(N_SAMPLES);
-    uint8_t *qt_xor = malloc(N_SAMPLES);
+    uint8_t *qt_lsb = POC_SAMPLES_U8(&g_arena, N_SAMPLES);
+    uint8_t *qt_xor = POC_SAMPLES_U8(&g_arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         qt_lsb[i] = query_timings[i] & 0xFF;
         uint64_t t = query_timings[i];
@@ -91,7 +138,7 @@ static void analyze_device(AudioDeviceID device, const char *device_name) {
     analyze_entropy("XOR-fold", qt_xor, N_SAMPLES);
 
     // Delta analysis
-    uint8_t *qt_delta = malloc(N_SAMPLES - 1);
+    uint8_t *qt_delta = POC_SAMPLES_U8(&g_arena, N_SAMPLES - 1);
     for (int i = 0; i < N_SAMPLES - 1; i++) {
         int64_t d = (int64_t)query_timings[i+1] - (int64_t)query_timings[i];
         uint64_t ud = (uint64_t)d;
@@ -104,7 +151,7 @@ static void analyze_device(AudioDeviceID device, const char *device_name) {
     // Looking for beat frequency between CPU and audio PLL
     printf("\n  === PLL beat detection ===\n");
 
-    uint64_t beat_timings[N_SAMPLES];
+    uint64_t *beat_timings = POC_SAMPLES_U64(&g_arena, N_SAMPLES);
     addr.mSelector = kAudioDevicePropertyActualSampleRate;
     for (int i = 0; i < N_SAMPLES; i++) {
         Float64 actual_rate = 0;
@@ -123,7 +170,7 @@ static void analyze_device(AudioDeviceID device, const char *device_name) {
         beat_timings[i] = t1 - t0;
     }
 
-    uint8_t *bt_xor = malloc(N_SAMPLES);
+    uint8_t *bt_xor = POC_SAMPLES_U8(&g_arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         uint64_t t = beat_timings[i];
         bt_xor[i] = (t & 0xFF) ^ ((t >> 8) & 0xFF) ^
@@ -133,7 +180,7 @@ static void analyze_device(AudioDeviceID device, const char *device_name) {
 
     // Method 3: Latency query — involves audio clock computation
     printf("\n  === Audio latency query timing ===\n");
-    uint64_t lat_timings[N_SAMPLES];
+    uint64_t *lat_timings = POC_SAMPLES_U64(&g_arena, N_SAMPLES);
     addr.mSelector = kAudioDevicePropertyLatency;
     addr.mScope = kAudioDevicePropertyScopeOutput;
 
@@ -148,7 +195,7 @@ static void analyze_device(AudioDeviceID device, const char *device_name) {
         lat_timings[i] = t1 - t0;
     }
 
-    uint8_t *lt_xor = malloc(N_SAMPLES);
+    uint8_t *lt_xor = POC_SAMPLES_U8(&g_arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         uint64_t t = lat_timings[i];
         lt_xor[i] = (t & 0xFF) ^ ((t >> 8) & 0xFF) ^
@@ -170,17 +217,17 @@ static void analyze_device(AudioDeviceID device, const char *device_name) {
     printf("    Min: %llu ticks (%llu ns)\n", tmin, tmin * tb.numer / tb.denom);
     printf("    Max: %llu ticks (%llu ns)\n", tmax, tmax * tb.numer / tb.denom);
     printf("    Mean: %.1f ticks\n", (double)tsum / N_SAMPLES);
-
-    free(qt_lsb);
-    free(qt_xor);
-    free(qt_delta);
-    free(bt_xor);
-    free(lt_xor);
 }
 
-int main(void) {
+int main(int argc, char **argv) {
+    int stamps = argc > 1 && strcmp(argv[1], "--stamps") == 0;
     printf("# Audio Clock PLL Jitter — Phase Noise Entropy\n\n");
 
+    if (poc_samples_init(&g_arena, ARENA_BYTES) != 0) {
+        perror("mmap");
+        return 1;
+    }
+
     // Get default output device
     AudioObjectPropertyAddress addr = {
         .mSelector = kAudioHardwarePropertyDefaultOutputDevice,
@@ -204,7 +251,7 @@ int main(void) {
             CFStringGetCString(name, nameBuf, sizeof(nameBuf), kCFStringEncodingUTF8);
             CFRelease(name);
         }
-        analyze_device(outDevice, nameBuf);
+        analyze_device(outDevice, nameBuf, stamps);
     }
 
     // Get default input device
@@ -225,8 +272,9 @@ int main(void) {
             CFStringGetCString(name, nameBuf, sizeof(nameBuf), kCFStringEncodingUTF8);
             CFRelease(name);
         }
-        analyze_device(inDevice, nameBuf);
+        analyze_device(inDevice, nameBuf, stamps);
     }
 
+    poc_samples_free(&g_arena);
     return 0;
 }
@@ -13,6 +13,11 @@
 // On Apple Silicon (M1-M4), denormal handling may be faster than x86 but
 // still creates measurable timing variation.
 //
+// Method 4 (arm64) moves the arithmetic into 128-bit NEON FMLA chains whose
+// lanes mix denormal and normal operands, with FPCR.FZ forced off or on for
+// an A/B: every instruction can take the assist on several lanes at once,
+// so one timestamp pair covers 4 or 8 lanes' worth of penalty.
+//
 // Build: cc -O2 -o thermal_denormal_timing thermal_denormal_timing.c -lm
 // Note: Do NOT use -ffast-math (it would flush denormals to zero)
 
@@ -24,30 +29,73 @@
 #include <float.h>
 #include <mach/mach_time.h>
 
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "lib/poc_arena.h"
+#include "lib/poc_stats.h"
+
 #define N_SAMPLES 20000
 #define INNER_OPS 100  // Operations per timing measurement
 
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
+// Volatile to prevent optimization
+static volatile double sink = 0.0;
+
+#if defined(__aarch64__)
+#define FPCR_FZ (1ULL << 24)
+
+static inline uint64_t read_fpcr(void) {
+    uint64_t v;
+    __asm__ volatile("mrs %0, fpcr" : "=r"(v));
+    return v;
+}
+
+static inline void write_fpcr(uint64_t v) {
+    __asm__ volatile("msr fpcr, %0\nisb" : : "r"(v) : "memory");
+}
+
+static volatile float neon_sink;
+
+// INNER_OPS FMLAs per chain; two independent chains when eight lanes.
+// Denormal lanes hold float32 subnormals small enough (< 2^-133) that the
+// accumulated sum stays subnormal across the whole chain.
+static void neon_chain(int denorm_lanes, int eight_lanes, int fz, uint64_t *out, int n,
+                       uint64_t *lcg) {
+    float a_lanes[INNER_OPS][8];
+    for (int i = 0; i < INNER_OPS; i++)
+        for (int l = 0; l < 8; l++) {
+            *lcg = *lcg * 6364136223846793005ULL + 1;
+            if ((l & 3) < denorm_lanes) {
+                uint32_t bits = (uint32_t)((*lcg >> 20) & 0xFFFF) | 1;
+                memcpy(&a_lanes[i][l], &bits, sizeof(float));
+            } else {
+                a_lanes[i][l] = 1.0f + (float)(*lcg >> 40) / (float)(1u << 24);
+            }
         }
+
+    uint64_t saved = read_fpcr();
+    write_fpcr(fz ? saved | FPCR_FZ : saved & ~FPCR_FZ);
+    const float32x4_t b = vdupq_n_f32(0.999f);
+    for (int s = 0; s < n; s++) {
+        float32x4_t acc0 = vld1q_f32(a_lanes[s % INNER_OPS]);
+        float32x4_t acc1 = vld1q_f32(a_lanes[s % INNER_OPS] + 4);
+        uint64_t t0 = mach_absolute_time();
+        if (eight_lanes) {
+            for (int i = 0; i < INNER_OPS; i++) {
+                acc0 = vfmaq_f32(acc0, vld1q_f32(a_lanes[i]), b);
+                acc1 = vfmaq_f32(acc1, vld1q_f32(a_lanes[i] + 4), b);
+            }
+        } else {
+            for (int i = 0; i < INNER_OPS; i++) acc0 = vfmaq_f32(acc0, vld1q_f32(a_lanes[i]), b);
+        }
+        neon_sink = vaddvq_f32(vaddq_f32(acc0, acc1));
+        uint64_t t1 = mach_absolute_time();
+        out[s] = t1 - t0;
     }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
+    write_fpcr(saved);
 }
-
-// Volatile to prevent optimization
-static volatile double sink = 0.0;
+#endif
 
 int main(void) {
     printf("# Floating-Point Denormal Timing — Microcode Assist Entropy\n\n");
@@ -55,6 +103,14 @@ int main(void) {
     mach_timebase_info_data_t tb;
     mach_timebase_info(&tb);
 
+    // Five timing series and seven byte views, pre-faulted and locked before
+    // any timed loop writes to them
+    PocSampleArena arena;
+    if (poc_samples_init(&arena, (size_t)N_SAMPLES * (5 * sizeof(uint64_t) + 7) + 12 * 64) != 0) {
+        perror("mmap");
+        return 1;
+    }
+
     printf("DBL_MIN = %e\n", DBL_MIN);
     printf("DBL_TRUE_MIN = %e (smallest denormal)\n", DBL_TRUE_MIN);
     printf("Inner ops per sample: %d\n\n", INNER_OPS);
@@ -88,8 +144,8 @@ int main(void) {
     // === Method 1: Time denormal multiply operations ===
     printf("=== Method 1: Denormal multiply timing ===\n");
 
-    uint64_t *denorm_timings = malloc(N_SAMPLES * sizeof(uint64_t));
-    uint64_t *normal_timings = malloc(N_SAMPLES * sizeof(uint64_t));
+    uint64_t *denorm_timings = POC_SAMPLES_U64(&arena, N_SAMPLES);
+    uint64_t *normal_timings = POC_SAMPLES_U64(&arena, N_SAMPLES);
 
     for (int s = 0; s < N_SAMPLES; s++) {
         // Denormal operations
@@ -118,8 +174,8 @@ int main(void) {
     }
 
     // Analyze denormal timings
-    uint8_t *d_lsb = malloc(N_SAMPLES);
-    uint8_t *d_xor = malloc(N_SAMPLES);
+    uint8_t *d_lsb = POC_SAMPLES_U8(&arena, N_SAMPLES);
+    uint8_t *d_xor = POC_SAMPLES_U8(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         d_lsb[i] = denorm_timings[i] & 0xFF;
         uint64_t t = denorm_timings[i];
@@ -130,8 +186,8 @@ int main(void) {
     analyze_entropy("Denormal XOR-fold", d_xor, N_SAMPLES);
 
     // Analyze normal timings for comparison
-    uint8_t *n_lsb = malloc(N_SAMPLES);
-    uint8_t *n_xor = malloc(N_SAMPLES);
+    uint8_t *n_lsb = POC_SAMPLES_U8(&arena, N_SAMPLES);
+    uint8_t *n_xor = POC_SAMPLES_U8(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         n_lsb[i] = normal_timings[i] & 0xFF;
         uint64_t t = normal_timings[i];
@@ -159,7 +215,7 @@ int main(void) {
     // === Method 2: Mixed denormal/normal alternation ===
     printf("=== Method 2: Mixed denormal/normal alternation ===\n");
 
-    uint64_t *mixed_timings = malloc(N_SAMPLES * sizeof(uint64_t));
+    uint64_t *mixed_timings = POC_SAMPLES_U64(&arena, N_SAMPLES);
     for (int s = 0; s < N_SAMPLES; s++) {
         lcg = lcg * 6364136223846793005ULL + 1;
         int use_denorm = (lcg >> 32) & 1;
@@ -177,7 +233,7 @@ int main(void) {
         mixed_timings[s] = t1 - t0;
     }
 
-    uint8_t *m_xor = malloc(N_SAMPLES);
+    uint8_t *m_xor = POC_SAMPLES_U8(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         uint64_t t = mixed_timings[i];
         m_xor[i] = (t & 0xFF) ^ ((t >> 8) & 0xFF) ^
@@ -188,7 +244,7 @@ int main(void) {
     // === Method 3: Denormal add/subtract chain with varying values ===
     printf("\n=== Method 3: Denormal add/subtract chain ===\n");
 
-    uint64_t *chain_timings = malloc(N_SAMPLES * sizeof(uint64_t));
+    uint64_t *chain_timings = POC_SAMPLES_U64(&arena, N_SAMPLES);
     for (int s = 0; s < N_SAMPLES; s++) {
         // Create fresh denormal from timing seed
         lcg = lcg * 6364136223846793005ULL + 1;
@@ -207,7 +263,7 @@ int main(void) {
         chain_timings[s] = t1 - t0;
     }
 
-    uint8_t *c_xor = malloc(N_SAMPLES);
+    uint8_t *c_xor = POC_SAMPLES_U8(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         uint64_t t = chain_timings[i];
         c_xor[i] = (t & 0xFF) ^ ((t >> 8) & 0xFF) ^
@@ -215,9 +271,32 @@ int main(void) {
     }
     analyze_entropy("Chain timing XOR-fold", c_xor, N_SAMPLES);
 
+    // === Method 4: NEON FMLA chains, mixed lanes, FPCR.FZ A/B ===
+    printf("\n=== Method 4: NEON FMLA denormal lanes (FPCR.FZ off / on) ===\n");
+#if defined(__aarch64__)
+    {
+        uint64_t *vt = POC_SAMPLES_U64(&arena, N_SAMPLES);
+        printf("  %5s %7s %3s %9s %7s %7s\n", "lanes", "denorm", "FZ", "mean ns", "H∞", "H∞Δ");
+        for (int eight = 0; eight <= 1; eight++)
+            for (int dl = 0; dl <= 4; dl += 2)
+                for (int fz = 0; fz <= 1; fz++) {
+                    if (dl == 0 && fz) continue;   // FZ is a no-op without denormals
+                    neon_chain(dl, eight, fz, vt, N_SAMPLES, &lcg);
+                    Stats s = compute_stats(vt, N_SAMPLES);
+                    Stats d = compute_stats_delta_xorfold(vt, N_SAMPLES);
+                    printf("  %5d %5d/4 %3s %9.0f %7.3f %7.3f\n", eight ? 8 : 4, dl,
+                           fz ? "on" : "off", s.mean * tb.numer / tb.denom, s.min_entropy,
+                           d.min_entropy);
+                }
+        printf("  (FZ on flushes subnormal lanes: the off/on gap is the assist penalty)\n");
+    }
+#else
+    printf("  skipped: needs arm64 NEON (FMLA, FPCR)\n");
+#endif
+
     // Delta analysis for all methods
     printf("\n=== Delta analysis ===\n");
-    uint8_t *dd_xor = malloc(N_SAMPLES - 1);
+    uint8_t *dd_xor = POC_SAMPLES_U8(&arena, N_SAMPLES - 1);
     for (int i = 0; i < N_SAMPLES - 1; i++) {
         int64_t d = (int64_t)denorm_timings[i+1] - (int64_t)denorm_timings[i];
         uint64_t ud = (uint64_t)d;
@@ -232,16 +311,6 @@ int main(void) {
     for (int i = 0; i < 20; i++) printf("%llu ", normal_timings[i]);
     printf("\n");
 
-    free(denorm_timings);
-    free(normal_timings);
-    free(mixed_timings);
-    free(chain_timings);
-    free(d_lsb);
-    free(d_xor);
-    free(n_lsb);
-    free(n_xor);
-    free(m_xor);
-    free(c_xor);
-    free(dd_xor);
+    poc_samples_free(&arena);
     return 0;
 }
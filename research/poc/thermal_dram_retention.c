@@ -17,6 +17,13 @@
 // Note: On modern systems with ECC and aggressive refresh, direct bit flips
 // are rare. We primarily measure the TIMING of refresh interference.
 //
+// Method 1 folds each round's XOR residue as it is read back: a byte
+// histogram over every round plus a bounded ring of the most recent residue
+// bytes. Memory stays flat, so long runs over large regions are just flags:
+//
+//   ./thermal_dram_retention                  20 rounds over 1 MB
+//   ./thermal_dram_retention -r 5000 -m 256   5000 rounds over 256 MB
+//
 // Build: cc -O2 -o thermal_dram_retention thermal_dram_retention.c -lm
 
 #include <stdio.h>
@@ -27,40 +34,82 @@
 #include <sys/mman.h>
 #include <mach/mach_time.h>
 
-#define REGION_SIZE (1024 * 1024)  // 1 MB — spans many DRAM rows
+#include "lib/poc_arena.h"
+#include "lib/poc_stats.h"
+
+#define DEFAULT_REGION_MB 1  // spans many DRAM rows
+#define MAX_REGION_MB (64u << 10)   // 64 GB; larger -m values are rejected
 #define DRAM_PAGE_SIZE 4096
-#define NUM_PAGES (REGION_SIZE / DRAM_PAGE_SIZE)
-#define N_ROUNDS 20
+#define DEFAULT_ROUNDS 20
 #define N_SAMPLES 10000
+#define RESIDUE_RING (1 << 20)   // most recent residue bytes kept for analysis
+
+// Alternating 0xAA/0x55 bytes, as little-endian words
+#define PATTERN_WORD 0x55AA55AA55AA55AAULL
+
+// Residue folded across every round; the ring keeps only the newest bytes.
+typedef struct {
+    uint64_t hist[256];
+    uint64_t total;
+    uint8_t *ring;
+    uint64_t ring_pos;
+} ResidueFold;
+
+static void fold_word(ResidueFold *f, uint64_t diff) {
+    uint64_t at = f->ring_pos & (RESIDUE_RING - 1);
+    if (!diff) {
+        f->hist[0] += 8;
+        memset(f->ring + at, 0, 8);
+    } else {
+        for (int b = 0; b < 8; b++) {
+            uint8_t d = (uint8_t)(diff >> (b * 8));
+            f->hist[d]++;
+            f->ring[at + b] = d;
+        }
+    }
+    f->total += 8;
+    f->ring_pos += 8;
+}
 
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
+static void analyze_fold(const char *label, const ResidueFold *f) {
+    double sh = 0;
+    uint64_t max = 0;
+    int unique = 0;
     for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
-        }
+        if (!f->hist[i]) continue;
+        double p = (double)f->hist[i] / f->total;
+        sh -= p * log2(p);
+        if (f->hist[i] > max) max = f->hist[i];
+        unique++;
     }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
+    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%llu\n", label, sh,
+           f->total ? -log2((double)max / f->total) : 0.0, unique,
+           (unsigned long long)f->total);
 }
 
-int main(void) {
+int main(int argc, char **argv) {
     printf("# DRAM Retention Noise — Quantum Tunneling PoC\n\n");
 
+    int n_rounds = DEFAULT_ROUNDS;
+    long long region_mb = DEFAULT_REGION_MB;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-r") == 0) n_rounds = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-m") == 0) region_mb = atoll(argv[i + 1]);
+    }
+    if (n_rounds < 1) n_rounds = 1;
+    if (region_mb < 1 || region_mb > MAX_REGION_MB) {
+        fprintf(stderr, "-m %lld: region must be 1..%u MB\n", region_mb, MAX_REGION_MB);
+        return 1;
+    }
+    const size_t region_size = (size_t)region_mb << 20;
+    const size_t num_pages = region_size / DRAM_PAGE_SIZE;
+
     mach_timebase_info_data_t tb;
     mach_timebase_info(&tb);
 
     // Allocate with mmap for page-aligned memory
     volatile uint8_t *region = (volatile uint8_t *)mmap(
-        NULL, REGION_SIZE, PROT_READ | PROT_WRITE,
+        NULL, region_size, PROT_READ | PROT_WRITE,
         MAP_PRIVATE | MAP_ANON, -1, 0);
     if (region == MAP_FAILED) {
         fprintf(stderr, "mmap failed\n");
@@ -68,26 +117,38 @@ int main(void) {
     }
 
     // Touch all pages to force physical allocation
-    for (int i = 0; i < REGION_SIZE; i += DRAM_PAGE_SIZE) {
+    for (size_t i = 0; i < region_size; i += DRAM_PAGE_SIZE) {
         region[i] = 0xAA;
     }
 
-    printf("Region: %d KB (%d pages)\n", REGION_SIZE / 1024, NUM_PAGES);
-    printf("Rounds: %d, Samples per round: %d\n\n", N_ROUNDS, N_SAMPLES);
+    // The residue ring, the timing series and its three byte views,
+    // pre-faulted and locked before the readback and timed loops write them
+    PocSampleArena arena;
+    if (poc_samples_init(&arena, RESIDUE_RING + (size_t)N_SAMPLES * (sizeof(uint64_t) + 3) +
+                                     5 * 64) != 0) {
+        perror("mmap");
+        munmap((void *)region, region_size);
+        return 1;
+    }
+
+    printf("Region: %zu KB (%zu pages)\n", region_size / 1024, num_pages);
+    printf("Rounds: %d, Samples per round: %d\n\n", n_rounds, N_SAMPLES);
 
     // === Method 1: Write-Wait-Readback ===
     // Write a known pattern, busy-wait, XOR readback to find changed bits
     printf("=== Method 1: Write-Wait-Readback (retention noise) ===\n");
 
-    int total_flipped_bits = 0;
-    int total_flipped_bytes = 0;
-    uint8_t *xor_results = malloc(N_ROUNDS * REGION_SIZE);
-    int xor_count = 0;
+    uint64_t total_flipped_bits = 0;
+    uint64_t total_flipped_bytes = 0;
+    static ResidueFold fold;
+    fold.ring = POC_SAMPLES_U8(&arena, RESIDUE_RING);
+    volatile uint64_t *words = (volatile uint64_t *)region;
+    size_t n_words = region_size / sizeof(uint64_t);
 
-    for (int round = 0; round < N_ROUNDS; round++) {
+    for (int round = 0; round < n_rounds; round++) {
         // Write known pattern (alternating 0xAA/0x55)
-        for (int i = 0; i < REGION_SIZE; i++) {
-            region[i] = (i & 1) ? 0x55 : 0xAA;
+        for (size_t i = 0; i < n_words; i++) {
+            words[i] = PATTERN_WORD;
         }
 
         // Busy-wait ~10ms (enough for some charge leakage on weak cells)
@@ -98,44 +159,39 @@ int main(void) {
             __asm__ volatile("" ::: "memory");
         }
 
-        // Readback and XOR with expected pattern
-        int flipped_bits = 0;
-        int flipped_bytes = 0;
-        for (int i = 0; i < REGION_SIZE; i++) {
-            uint8_t expected = (i & 1) ? 0x55 : 0xAA;
-            uint8_t actual = region[i];
-            uint8_t diff = actual ^ expected;
+        // Readback, XOR with expected pattern, fold into the histogram/ring
+        for (size_t i = 0; i < n_words; i++) {
+            uint64_t diff = words[i] ^ PATTERN_WORD;
             if (diff) {
-                flipped_bytes++;
-                // Count set bits
-                while (diff) { flipped_bits++; diff &= diff - 1; }
+                total_flipped_bits += (uint64_t)__builtin_popcountll(diff);
+                for (int b = 0; b < 8; b++)
+                    if ((diff >> (b * 8)) & 0xFF) total_flipped_bytes++;
             }
-            xor_results[xor_count++] = actual ^ expected;
+            fold_word(&fold, diff);
         }
-        total_flipped_bits += flipped_bits;
-        total_flipped_bytes += flipped_bytes;
     }
 
-    printf("  Total flipped bits: %d across %d rounds\n",
-           total_flipped_bits, N_ROUNDS);
-    printf("  Total flipped bytes: %d\n", total_flipped_bytes);
+    printf("  Total flipped bits: %llu across %d rounds\n",
+           (unsigned long long)total_flipped_bits, n_rounds);
+    printf("  Total flipped bytes: %llu\n", (unsigned long long)total_flipped_bytes);
 
     // Even if no bits flipped (likely on modern ECC DRAM), analyze the
     // XOR pattern — all zeros means no direct retention noise observable
-    analyze_entropy("XOR residue", (uint8_t *)xor_results,
-                    xor_count > N_SAMPLES ? N_SAMPLES : xor_count);
+    analyze_fold("XOR residue (all rounds)", &fold);
+    uint64_t kept = fold.ring_pos < RESIDUE_RING ? fold.ring_pos : RESIDUE_RING;
+    analyze_entropy("XOR residue (latest)", fold.ring, (int)kept);
 
     // === Method 2: Read timing across DRAM rows (refresh interference) ===
     printf("\n=== Method 2: Row-crossing read timing ===\n");
 
-    uint64_t *timings = malloc(N_SAMPLES * sizeof(uint64_t));
+    uint64_t *timings = POC_SAMPLES_U64(&arena, N_SAMPLES);
     uint64_t lcg = mach_absolute_time() | 1;
 
     for (int i = 0; i < N_SAMPLES; i++) {
         // Random page offset to hit different DRAM rows
         lcg = lcg * 6364136223846793005ULL + 1;
-        int page = (lcg >> 32) % NUM_PAGES;
-        int offset = page * DRAM_PAGE_SIZE;
+        size_t page = (lcg >> 32) % num_pages;
+        size_t offset = page * DRAM_PAGE_SIZE;
 
         // Flush cache line to force DRAM access
         __builtin___clear_cache((char *)&region[offset], (char *)&region[offset + 64]);
@@ -153,8 +209,8 @@ int main(void) {
     }
 
     // Timing analysis
-    uint8_t *timing_lsbs = malloc(N_SAMPLES);
-    uint8_t *timing_xor = malloc(N_SAMPLES);
+    uint8_t *timing_lsbs = POC_SAMPLES_U8(&arena, N_SAMPLES);
+    uint8_t *timing_xor = POC_SAMPLES_U8(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         timing_lsbs[i] = timings[i] & 0xFF;
         uint64_t t = timings[i];
@@ -165,7 +221,7 @@ int main(void) {
     analyze_entropy("Timing XOR-fold", timing_xor, N_SAMPLES);
 
     // Delta timing
-    uint8_t *delta_xor = malloc(N_SAMPLES - 1);
+    uint8_t *delta_xor = POC_SAMPLES_U8(&arena, N_SAMPLES - 1);
     for (int i = 0; i < N_SAMPLES - 1; i++) {
         int64_t d = (int64_t)timings[i+1] - (int64_t)timings[i];
         uint64_t ud = (uint64_t)d;
@@ -182,13 +238,13 @@ int main(void) {
 
     for (int p = 0; p < n_patterns; p++) {
         // Write pattern
-        memset((void *)region, patterns[p], REGION_SIZE);
+        memset((void *)region, patterns[p], region_size);
 
         uint64_t pat_timings[2000];
         for (int i = 0; i < 2000; i++) {
             lcg = lcg * 6364136223846793005ULL + 1;
-            int page = (lcg >> 32) % NUM_PAGES;
-            int offset = page * DRAM_PAGE_SIZE;
+            size_t page = (lcg >> 32) % num_pages;
+            size_t offset = page * DRAM_PAGE_SIZE;
 
             __builtin___clear_cache((char *)&region[offset], (char *)&region[offset + 64]);
 
@@ -229,11 +285,7 @@ int main(void) {
     for (int i = 0; i < 20; i++) printf("%llu ", timings[i]);
     printf("\n");
 
-    munmap((void *)region, REGION_SIZE);
-    free(xor_results);
-    free(timings);
-    free(timing_lsbs);
-    free(timing_xor);
-    free(delta_xor);
+    munmap((void *)region, region_size);
+    poc_samples_free(&arena);
     return 0;
 }
@@ -26,35 +26,13 @@
 #include <math.h>
 #include <mach/mach_time.h>
 
+#include "lib/poc_arena.h"
+#include "lib/poc_stats.h"
+#include "lib/poc_time.h"
+
 #define N_SAMPLES 20000
 #define NOP_COUNT 1000
 
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
-        }
-    }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
-}
-
-// Read ARM64 virtual counter (CNTVCT_EL0) — available in user space
-static inline uint64_t read_cntvct(void) {
-    uint64_t val;
-    __asm__ volatile("mrs %0, CNTVCT_EL0" : "=r"(val));
-    return val;
-}
-
 // Read counter timer frequency
 static inline uint64_t read_cntfrq(void) {
     uint64_t val;
@@ -115,6 +93,59 @@ static inline void execute_mixed_workload(volatile uint64_t *sink) {
     );
 }
 
+// Kernel-length sweep (Method 5): NOP and mixed ALU kernels expanded with
+// .rept at compile time, one noinline function per length, so a sample is
+// one call and one straight-line block with no loop counter or back-edge.
+#define NOP_KERNEL(len)                                                 \
+    static __attribute__((noinline)) void nop_kernel_##len(void) {      \
+        __asm__ volatile(".rept " #len "\nnop\n.endr\n" ::: "memory"); \
+    }
+
+// 20 instructions per rep, same mix as execute_mixed_workload()
+#define MIXED_KERNEL(reps)                                              \
+    static __attribute__((noinline)) void mixed_kernel_##reps(void) {   \
+        __asm__ volatile(                                               \
+            "mov x9, #0x1234\n"                                         \
+            "mov x10, #0x5678\n"                                        \
+            ".rept " #reps "\n"                                         \
+            "add x9, x9, x10\n"                                         \
+            "eor x10, x10, x9\n"                                        \
+            "sub x9, x9, #1\n"                                          \
+            "ror x10, x10, #7\n"                                        \
+            ".rept 16\nnop\n.endr\n"                                    \
+            ".endr\n"                                                   \
+            ::: "x9", "x10", "memory");                                 \
+    }
+
+NOP_KERNEL(16)
+NOP_KERNEL(64)
+NOP_KERNEL(250)
+NOP_KERNEL(1000)
+NOP_KERNEL(4000)
+NOP_KERNEL(16000)
+MIXED_KERNEL(4)
+MIXED_KERNEL(16)
+MIXED_KERNEL(50)
+MIXED_KERNEL(200)
+MIXED_KERNEL(800)
+
+typedef struct {
+    const char *kind;
+    int instructions;
+    void (*fn)(void);
+} Kernel;
+
+static const Kernel KERNELS[] = {
+    {"nop", 16, nop_kernel_16},       {"nop", 64, nop_kernel_64},
+    {"nop", 250, nop_kernel_250},     {"nop", 1000, nop_kernel_1000},
+    {"nop", 4000, nop_kernel_4000},   {"nop", 16000, nop_kernel_16000},
+    {"mixed", 80, mixed_kernel_4},    {"mixed", 320, mixed_kernel_16},
+    {"mixed", 1000, mixed_kernel_50}, {"mixed", 4000, mixed_kernel_200},
+    {"mixed", 16000, mixed_kernel_800},
+};
+#define N_KERNELS ((int)(sizeof(KERNELS) / sizeof(KERNELS[0])))
+#define SWEEP_SAMPLES 5000
+
 int main(void) {
     printf("# Instruction Retirement Jitter — ARM64 Pipeline Entropy\n\n");
 
@@ -127,21 +158,30 @@ int main(void) {
     printf("NOP count per measurement: %d\n", NOP_COUNT);
     printf("Samples: %d\n\n", N_SAMPLES);
 
+    // Four timing series, the sweep buffer and ten byte views, pre-faulted
+    // and locked before any timed loop writes to them
+    PocSampleArena arena;
+    if (poc_samples_init(&arena, (size_t)N_SAMPLES * (4 * sizeof(uint64_t) + 10) +
+                                     SWEEP_SAMPLES * sizeof(uint64_t) + 15 * 64) != 0) {
+        perror("mmap");
+        return 1;
+    }
+
     volatile uint64_t sink_val = 0;
 
     // === Method 1: CNTVCT_EL0 timing of NOP block ===
     printf("=== Method 1: CNTVCT_EL0 NOP timing ===\n");
 
-    uint64_t *cntvct_timings = malloc(N_SAMPLES * sizeof(uint64_t));
+    uint64_t *cntvct_timings = POC_SAMPLES_U64(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
-        uint64_t t0 = read_cntvct();
+        uint64_t t0 = poc_ts_cntvct();
         execute_nops();
-        uint64_t t1 = read_cntvct();
+        uint64_t t1 = poc_ts_cntvct();
         cntvct_timings[i] = t1 - t0;
     }
 
-    uint8_t *c_lsb = malloc(N_SAMPLES);
-    uint8_t *c_xor = malloc(N_SAMPLES);
+    uint8_t *c_lsb = POC_SAMPLES_U8(&arena, N_SAMPLES);
+    uint8_t *c_xor = POC_SAMPLES_U8(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         c_lsb[i] = cntvct_timings[i] & 0xFF;
         uint64_t t = cntvct_timings[i];
@@ -154,7 +194,7 @@ int main(void) {
     // === Method 2: mach_absolute_time timing of NOP block ===
     printf("\n=== Method 2: mach_absolute_time NOP timing ===\n");
 
-    uint64_t *mach_timings = malloc(N_SAMPLES * sizeof(uint64_t));
+    uint64_t *mach_timings = POC_SAMPLES_U64(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         uint64_t t0 = mach_absolute_time();
         execute_nops();
@@ -162,8 +202,8 @@ int main(void) {
         mach_timings[i] = t1 - t0;
     }
 
-    uint8_t *m_lsb = malloc(N_SAMPLES);
-    uint8_t *m_xor = malloc(N_SAMPLES);
+    uint8_t *m_lsb = POC_SAMPLES_U8(&arena, N_SAMPLES);
+    uint8_t *m_xor = POC_SAMPLES_U8(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         m_lsb[i] = mach_timings[i] & 0xFF;
         uint64_t t = mach_timings[i];
@@ -176,7 +216,7 @@ int main(void) {
     // === Method 3: Mixed workload timing ===
     printf("\n=== Method 3: Mixed ALU+NOP workload ===\n");
 
-    uint64_t *mixed_timings = malloc(N_SAMPLES * sizeof(uint64_t));
+    uint64_t *mixed_timings = POC_SAMPLES_U64(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         uint64_t t0 = mach_absolute_time();
         execute_mixed_workload(&sink_val);
@@ -184,7 +224,7 @@ int main(void) {
         mixed_timings[i] = t1 - t0;
     }
 
-    uint8_t *mx_xor = malloc(N_SAMPLES);
+    uint8_t *mx_xor = POC_SAMPLES_U8(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         uint64_t t = mixed_timings[i];
         mx_xor[i] = (t & 0xFF) ^ ((t >> 8) & 0xFF) ^
@@ -195,16 +235,16 @@ int main(void) {
     // === Method 4: Counter beat — CNTVCT vs mach_absolute_time ===
     printf("\n=== Method 4: CNTVCT vs mach_absolute_time beat ===\n");
 
-    uint64_t *beat_samples = malloc(N_SAMPLES * sizeof(uint64_t));
+    uint64_t *beat_samples = POC_SAMPLES_U64(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
-        uint64_t c = read_cntvct();
+        uint64_t c = poc_ts_cntvct();
         uint64_t m = mach_absolute_time();
         // The ratio should be constant, but LSB jitter reveals clock domain crossing
         beat_samples[i] = c ^ m;
     }
 
-    uint8_t *b_lsb = malloc(N_SAMPLES);
-    uint8_t *b_xor = malloc(N_SAMPLES);
+    uint8_t *b_lsb = POC_SAMPLES_U8(&arena, N_SAMPLES);
+    uint8_t *b_xor = POC_SAMPLES_U8(&arena, N_SAMPLES);
     for (int i = 0; i < N_SAMPLES; i++) {
         b_lsb[i] = beat_samples[i] & 0xFF;
         uint64_t t = beat_samples[i];
@@ -216,9 +256,9 @@ int main(void) {
 
     // === Delta analysis for all methods ===
     printf("\n=== Delta analysis ===\n");
-    uint8_t *d1 = malloc(N_SAMPLES - 1);
-    uint8_t *d2 = malloc(N_SAMPLES - 1);
-    uint8_t *d3 = malloc(N_SAMPLES - 1);
+    uint8_t *d1 = POC_SAMPLES_U8(&arena, N_SAMPLES - 1);
+    uint8_t *d2 = POC_SAMPLES_U8(&arena, N_SAMPLES - 1);
+    uint8_t *d3 = POC_SAMPLES_U8(&arena, N_SAMPLES - 1);
 
     for (int i = 0; i < N_SAMPLES - 1; i++) {
         int64_t delta;
@@ -240,6 +280,37 @@ int main(void) {
     analyze_entropy("mach delta XOR", d2, N_SAMPLES - 1);
     analyze_entropy("Mixed delta XOR", d3, N_SAMPLES - 1);
 
+    // === Method 5: Kernel length sweep ===
+    // Which straight-line length gives the most H∞ per nanosecond spent?
+    printf("\n=== Method 5: Unrolled kernel length sweep (CNTVCT) ===\n");
+    printf("  %-6s %6s %10s %7s %7s %10s\n", "kernel", "insns", "mean ns", "H∞", "H∞Δ",
+           "H∞/ns");
+    {
+        uint64_t *kt = POC_SAMPLES_U64(&arena, SWEEP_SAMPLES);
+        double best = -1;
+        int best_k = 0;
+        for (int k = 0; k < N_KERNELS; k++) {
+            for (int i = 0; i < SWEEP_SAMPLES; i++) {
+                uint64_t t0 = poc_ts_cntvct();
+                KERNELS[k].fn();
+                uint64_t t1 = poc_ts_cntvct();
+                kt[i] = t1 - t0;
+            }
+            Stats s = compute_stats(kt, SWEEP_SAMPLES);
+            Stats d = compute_stats_delta_xorfold(kt, SWEEP_SAMPLES);
+            double ns = s.mean * 1e9 / (double)cntfrq;
+            double rate = ns > 0 ? s.min_entropy / ns : 0;
+            printf("  %-6s %6d %10.1f %7.3f %7.3f %10.5f\n", KERNELS[k].kind,
+                   KERNELS[k].instructions, ns, s.min_entropy, d.min_entropy, rate);
+            if (rate > best) {
+                best = rate;
+                best_k = k;
+            }
+        }
+        printf("  Best H∞/ns: %s × %d instructions (%.5f bits/ns)\n", KERNELS[best_k].kind,
+               KERNELS[best_k].instructions, best);
+    }
+
     // Statistics
     printf("\n=== Timing statistics ===\n");
     uint64_t sum1 = 0, sum2 = 0, sum3 = 0;
@@ -262,14 +333,6 @@ int main(void) {
     for (int i = 0; i < 20; i++) printf("%llu ", mach_timings[i]);
     printf("\n");
 
-    free(cntvct_timings);
-    free(mach_timings);
-    free(mixed_timings);
-    free(beat_samples);
-    free(c_lsb); free(c_xor);
-    free(m_lsb); free(m_xor);
-    free(mx_xor);
-    free(b_lsb); free(b_xor);
-    free(d1); free(d2); free(d3);
+    poc_samples_free(&arena);
     return 0;
 }
@@ -10,6 +10,15 @@
 // between reads relative to the CPU clock, we capture the beat frequency
 // between two independent oscillators (USB crystal vs CPU PLL).
 //
+// Devices and controllers are matched once up front and their io_service_t
+// handles kept for the whole run; a sample is then a single
+// IORegistryEntryCreateCFProperty() on a cached handle. A property read
+// that fails is reported and its method skipped rather than timed.
+//
+// Method 4 reads the bus frame number itself (IOUSBDeviceInterface
+// GetBusFrameNumber, no device open needed) and times the 1 ms frame
+// boundaries it sees against the CPU clock.
+//
 // Build: cc -O2 -o thermal_usb_frame_jitter thermal_usb_frame_jitter.c \
 //        -framework IOKit -framework CoreFoundation -lm
 
@@ -23,122 +32,122 @@
 #include <IOKit/usb/IOUSBLib.h>
 #include <CoreFoundation/CoreFoundation.h>
 
+#include "lib/poc_arena.h"
+#include "lib/poc_stats.h"
+
 #define N_SAMPLES 20000
+#define N_FRAMES 2000          // frame boundaries timed by Method 4
+#define MAX_FRAME_POLLS 20000000
+#define MAX_DEVICES 3
+#define MAX_CONTROLLERS 4
+
+// Handles matched once in main() and held until exit
+static io_service_t g_devices[MAX_DEVICES];
+static int g_n_devices;
+static io_service_t g_controllers[MAX_CONTROLLERS];
+static int g_n_controllers;
+
+// Sample buffers shared by the probes (they run one after another), taken
+// from one pre-faulted, locked arena in main() so no timed loop or analysis
+// pass takes a first-touch fault
+static PocSampleArena g_arena;
+static uint64_t *g_timings;    // N_SAMPLES
+static uint64_t *g_intervals;  // N_FRAMES
+static uint8_t *g_lsb, *g_xor, *g_delta;
+
+// Match the first class in `classes` that has any services, keep up to max
+// handles. Returns the number kept; *total (optional) counts every match.
+static int match_once(const char *const *classes, io_service_t *out, int max, int *total) {
+    int kept = 0, seen = 0;
+    for (int c = 0; classes[c] && seen == 0; c++) {
+        CFMutableDictionaryRef match = IOServiceMatching(classes[c]);
+        if (!match) continue;
+        io_iterator_t iter;
+        if (IOServiceGetMatchingServices(kIOMainPortDefault, match, &iter) != KERN_SUCCESS)
+            continue;
+        io_service_t service;
+        while ((service = IOIteratorNext(iter)) != 0) {
+            seen++;
+            if (kept < max) out[kept++] = service;
+            else IOObjectRelease(service);
+        }
+        IOObjectRelease(iter);
+    }
+    if (total) *total = seen;
+    return kept;
+}
 
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
+// Times n reads of `key` on a cached handle. 0, or -1 after reporting the
+// first failed read: a missing property would time the lookup failure, not
+// a registry round trip.
+static int time_property_reads(io_service_t service, CFStringRef key, const char *key_name,
+                               uint64_t *timings, int n) {
+    for (int i = 0; i < n; i++) {
+        uint64_t t0 = mach_absolute_time();
+        CFTypeRef prop = IORegistryEntryCreateCFProperty(service, key, kCFAllocatorDefault, 0);
+        uint64_t t1 = mach_absolute_time();
+        if (!prop) {
+            printf("  %s: property read %d failed, skipping\n", key_name, i);
+            return -1;
         }
+        CFRelease(prop);
+        timings[i] = t1 - t0;
     }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
+    return 0;
 }
 
 // Read IORegistry property timing — USB controllers register frame info
-static int probe_usb_controllers(void) {
+static int probe_usb_controllers(int devices_found) {
     printf("=== Method 1: USB controller IORegistry query timing ===\n\n");
 
-    // Find USB host controllers
-    CFMutableDictionaryRef match = IOServiceMatching("IOUSBHostDevice");
-    if (!match) {
-        // Try older matching class
-        match = IOServiceMatching("IOUSBDevice");
-    }
-    if (!match) {
-        fprintf(stderr, "No USB matching dictionary\n");
-        return 0;
-    }
-
-    io_iterator_t iter;
-    kern_return_t kr = IOServiceGetMatchingServices(kIOMainPortDefault, match, &iter);
-    if (kr != KERN_SUCCESS) {
-        fprintf(stderr, "No USB devices found\n");
-        return 0;
-    }
-
-    mach_timebase_info_data_t tb;
-    mach_timebase_info(&tb);
-
-    int devices_found = 0;
-    io_service_t service;
-    while ((service = IOIteratorNext(iter)) != 0) {
-        devices_found++;
+    for (int dev = 0; dev < g_n_devices; dev++) {
+        io_service_t service = g_devices[dev];
 
         // Get device name
         io_name_t name;
         IORegistryEntryGetName(service, name);
 
-        if (devices_found <= 3) {
-            printf("USB Device %d: %s\n", devices_found, name);
-
-            // Rapid property reads — timing captures USB bus arbitration jitter
-            uint64_t timings[N_SAMPLES];
-            for (int i = 0; i < N_SAMPLES; i++) {
-                uint64_t t0 = mach_absolute_time();
-
-                // Read various properties that require USB bus interaction
-                CFTypeRef prop = IORegistryEntryCreateCFProperty(
-                    service, CFSTR("sessionID"), kCFAllocatorDefault, 0);
-                if (prop) CFRelease(prop);
+        printf("USB Device %d: %s\n", dev + 1, name);
 
-                prop = IORegistryEntryCreateCFProperty(
-                    service, CFSTR("USB Address"), kCFAllocatorDefault, 0);
-                if (prop) CFRelease(prop);
-
-                uint64_t t1 = mach_absolute_time();
-                timings[i] = t1 - t0;
-            }
-
-            // Analyze
-            uint8_t *t_lsb = malloc(N_SAMPLES);
-            uint8_t *t_xor = malloc(N_SAMPLES);
-            for (int i = 0; i < N_SAMPLES; i++) {
-                t_lsb[i] = timings[i] & 0xFF;
-                uint64_t t = timings[i];
-                t_xor[i] = (t & 0xFF) ^ ((t >> 8) & 0xFF) ^
-                            ((t >> 16) & 0xFF) ^ ((t >> 24) & 0xFF);
-            }
-
-            analyze_entropy("Query LSBs", t_lsb, N_SAMPLES);
-            analyze_entropy("Query XOR-fold", t_xor, N_SAMPLES);
+        // Rapid property reads on the cached handle — one round trip each
+        uint64_t *timings = g_timings;
+        if (time_property_reads(service, CFSTR("sessionID"), "sessionID", timings,
+                                N_SAMPLES) != 0) {
+            printf("\n");
+            continue;
+        }
 
-            // Delta
-            uint8_t *t_delta = malloc(N_SAMPLES - 1);
-            for (int i = 0; i < N_SAMPLES - 1; i++) {
-                int64_t d = (int64_t)timings[i+1] - (int64_t)timings[i];
-                uint64_t ud = (uint64_t)d;
-                t_delta[i] = (ud & 0xFF) ^ ((ud >> 8) & 0xFF) ^
-                              ((ud >> 16) & 0xFF) ^ ((ud >> 24) & 0xFF);
-            }
-            analyze_entropy("Delta XOR-fold", t_delta, N_SAMPLES - 1);
+        // Analyze
+        uint8_t *t_lsb = g_lsb, *t_xor = g_xor;
+        for (int i = 0; i < N_SAMPLES; i++) {
+            t_lsb[i] = timings[i] & 0xFF;
+            uint64_t t = timings[i];
+            t_xor[i] = (t & 0xFF) ^ ((t >> 8) & 0xFF) ^
+                        ((t >> 16) & 0xFF) ^ ((t >> 24) & 0xFF);
+        }
 
-            uint64_t tmin = UINT64_MAX, tmax = 0, tsum = 0;
-            for (int i = 0; i < N_SAMPLES; i++) {
-                if (timings[i] < tmin) tmin = timings[i];
-                if (timings[i] > tmax) tmax = timings[i];
-                tsum += timings[i];
-            }
-            printf("  Timing: min=%llu max=%llu mean=%.0f ticks\n\n",
-                   tmin, tmax, (double)tsum / N_SAMPLES);
+        analyze_entropy("Query LSBs", t_lsb, N_SAMPLES);
+        analyze_entropy("Query XOR-fold", t_xor, N_SAMPLES);
 
-            free(t_lsb);
-            free(t_xor);
-            free(t_delta);
+        // Delta
+        uint8_t *t_delta = g_delta;
+        for (int i = 0; i < N_SAMPLES - 1; i++) {
+            int64_t d = (int64_t)timings[i+1] - (int64_t)timings[i];
+            uint64_t ud = (uint64_t)d;
+            t_delta[i] = (ud & 0xFF) ^ ((ud >> 8) & 0xFF) ^
+                          ((ud >> 16) & 0xFF) ^ ((ud >> 24) & 0xFF);
         }
+        analyze_entropy("Delta XOR-fold", t_delta, N_SAMPLES - 1);
 
-        IOObjectRelease(service);
+        uint64_t tmin = UINT64_MAX, tmax = 0, tsum = 0;
+        for (int i = 0; i < N_SAMPLES; i++) {
+            if (timings[i] < tmin) tmin = timings[i];
+            if (timings[i] > tmax) tmax = timings[i];
+            tsum += timings[i];
+        }
+        printf("  Timing: min=%llu max=%llu mean=%.0f ticks\n\n",
+               tmin, tmax, (double)tsum / N_SAMPLES);
     }
-    IOObjectRelease(iter);
 
     printf("Total USB devices found: %d\n", devices_found);
     return devices_found;
@@ -148,22 +157,15 @@ static int probe_usb_controllers(void) {
 static void probe_usb_hub_timing(void) {
     printf("\n=== Method 2: USB hub topology traversal timing ===\n\n");
 
-    io_iterator_t iter;
-    CFMutableDictionaryRef match = IOServiceMatching("AppleUSBHostController");
-    kern_return_t kr = IOServiceGetMatchingServices(kIOMainPortDefault, match, &iter);
-    if (kr != KERN_SUCCESS) {
-        // Try alternative class names
-        match = IOServiceMatching("IOUSBController");
-        kr = IOServiceGetMatchingServices(kIOMainPortDefault, match, &iter);
-    }
-    if (kr != KERN_SUCCESS) {
+    kern_return_t kr;
+    if (g_n_controllers == 0) {
         printf("  No USB host controllers found, trying generic approach...\n");
 
         // Fallback: traverse IOService plane for any USB-related entries
         io_registry_entry_t root = IORegistryGetRootEntry(kIOMainPortDefault);
         if (!root) return;
 
-        uint64_t timings[N_SAMPLES];
+        uint64_t *timings = g_timings;
         for (int i = 0; i < N_SAMPLES; i++) {
             io_iterator_t child_iter;
             uint64_t t0 = mach_absolute_time();
@@ -184,54 +186,38 @@ static void probe_usb_hub_timing(void) {
             timings[i] = t1 - t0;
         }
 
-        uint8_t *t_xor = malloc(N_SAMPLES);
+        uint8_t *t_xor = g_xor;
         for (int i = 0; i < N_SAMPLES; i++) {
             uint64_t t = timings[i];
             t_xor[i] = (t & 0xFF) ^ ((t >> 8) & 0xFF) ^
                         ((t >> 16) & 0xFF) ^ ((t >> 24) & 0xFF);
         }
         analyze_entropy("Root traversal XOR-fold", t_xor, N_SAMPLES);
-        free(t_xor);
 
         IOObjectRelease(root);
         return;
     }
 
-    io_service_t controller;
-    while ((controller = IOIteratorNext(iter)) != 0) {
+    for (int c = 0; c < g_n_controllers; c++) {
+        io_service_t controller = g_controllers[c];
         io_name_t name;
         IORegistryEntryGetName(controller, name);
         printf("Controller: %s\n", name);
 
-        uint64_t timings[N_SAMPLES];
-        for (int i = 0; i < N_SAMPLES; i++) {
-            uint64_t t0 = mach_absolute_time();
-
-            // Read controller frame list — this accesses USB timing hardware
-            CFTypeRef prop = IORegistryEntryCreateCFProperty(
-                controller, CFSTR("IOPCIResourced"), kCFAllocatorDefault, 0);
-            if (prop) CFRelease(prop);
+        // One controller property per sample on the cached handle
+        uint64_t *timings = g_timings;
+        if (time_property_reads(controller, CFSTR("IOPCIResourced"), "IOPCIResourced",
+                                timings, N_SAMPLES) != 0)
+            continue;
 
-            prop = IORegistryEntryCreateCFProperty(
-                controller, CFSTR("IOInterruptControllers"), kCFAllocatorDefault, 0);
-            if (prop) CFRelease(prop);
-
-            uint64_t t1 = mach_absolute_time();
-            timings[i] = t1 - t0;
-        }
-
-        uint8_t *t_xor = malloc(N_SAMPLES);
+        uint8_t *t_xor = g_xor;
         for (int i = 0; i < N_SAMPLES; i++) {
             uint64_t t = timings[i];
             t_xor[i] = (t & 0xFF) ^ ((t >> 8) & 0xFF) ^
                         ((t >> 16) & 0xFF) ^ ((t >> 24) & 0xFF);
         }
         analyze_entropy("Controller timing XOR-fold", t_xor, N_SAMPLES);
-        free(t_xor);
-
-        IOObjectRelease(controller);
     }
-    IOObjectRelease(iter);
 }
 
 // Method 3: Interleaved USB+CPU timing for beat detection
@@ -240,7 +226,7 @@ static void probe_beat_frequency(void) {
 
     // Rapidly alternate between IORegistry reads and CPU timing
     // to detect beat frequency between USB crystal and CPU PLL
-    uint64_t timings[N_SAMPLES];
+    uint64_t *timings = g_timings;
 
     io_registry_entry_t root = IORegistryGetRootEntry(kIOMainPortDefault);
     if (!root) {
@@ -265,8 +251,8 @@ static void probe_beat_frequency(void) {
 
     IOObjectRelease(root);
 
-    uint8_t *t_xor = malloc(N_SAMPLES);
-    uint8_t *t_delta = malloc(N_SAMPLES - 1);
+    uint8_t *t_xor = g_xor;
+    uint8_t *t_delta = g_delta;
 
     for (int i = 0; i < N_SAMPLES; i++) {
         uint64_t t = timings[i];
@@ -303,15 +289,100 @@ static void probe_beat_frequency(void) {
         cov /= (N_SAMPLES - lag);
         printf("    Lag %2d: r=%.4f\n", lag, cov / var);
     }
+}
+
+// The bus frame number of a device's controller, read through the IOUSBLib
+// user client. NULL when no cached device offers the interface.
+static IOUSBDeviceInterface **open_frame_counter(void) {
+    for (int d = 0; d < g_n_devices; d++) {
+        IOCFPlugInInterface **plugin = NULL;
+        SInt32 score;
+        if (IOCreatePlugInInterfaceForService(g_devices[d], kIOUSBDeviceUserClientTypeID,
+                                              kIOCFPlugInInterfaceID, &plugin,
+                                              &score) != KERN_SUCCESS || !plugin)
+            continue;
+        IOUSBDeviceInterface **dev = NULL;
+        HRESULT hr = (*plugin)->QueryInterface(plugin, CFUUIDGetUUIDBytes(kIOUSBDeviceInterfaceID),
+                                               (LPVOID *)&dev);
+        IODestroyPlugInInterface(plugin);
+        if (hr == S_OK && dev) return dev;
+    }
+    return NULL;
+}
+
+// Method 4: poll the controller's frame number and stamp each 1 ms frame
+// boundary as it is seen. The boundary-to-boundary interval is the USB
+// crystal's frame period in CPU ticks, blurred by the poll interval (each
+// boundary is seen up to one poll late).
+static void probe_sof_phase(void) {
+    printf("\n=== Method 4: USB frame-number boundaries vs CPU clock ===\n\n");
+
+    IOUSBDeviceInterface **dev = open_frame_counter();
+    if (!dev) {
+        printf("  No device offers GetBusFrameNumber, skipping\n");
+        return;
+    }
 
-    free(t_xor);
-    free(t_delta);
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    uint64_t ticks_per_ms = 1000000ULL * tb.denom / tb.numer;
+
+    uint64_t *intervals = g_intervals;
+    UInt64 frame, last_frame = 0;
+    uint64_t last_edge = 0;
+    long polls = 0;
+    int n = 0, skipped = 0;
+    while (n < N_FRAMES && polls++ < MAX_FRAME_POLLS) {
+        AbsoluteTime at;
+        if ((*dev)->GetBusFrameNumber(dev, &frame, &at) != kIOReturnSuccess) {
+            printf("  GetBusFrameNumber failed, skipping\n");
+            (*dev)->Release(dev);
+            return;
+        }
+        if (frame == last_frame) continue;
+        uint64_t edge;
+        memcpy(&edge, &at, sizeof(edge));   // when the frame number was read
+        // Only consecutive frames: a longer gap means the poll was descheduled.
+        if (last_edge && frame == last_frame + 1) intervals[n++] = edge - last_edge;
+        else if (last_edge) skipped++;
+        last_frame = frame;
+        last_edge = edge;
+    }
+    (*dev)->Release(dev);
+
+    if (n < 2) {
+        printf("  Frame number did not advance (%ld polls), skipping\n", polls);
+        return;
+    }
+    printf("  %d frame boundaries from %ld polls (%d gaps skipped)\n", n, polls, skipped);
+    Stats iv = compute_stats(intervals, n);
+    printf("  Frame interval: mean=%.1f ticks (nominal %llu)  XOR-fold H∞=%.3f\n", iv.mean,
+           (unsigned long long)ticks_per_ms, iv.min_entropy);
 }
 
 int main(void) {
     printf("# USB Frame Counter Jitter — Crystal Oscillator Phase Noise\n\n");
 
-    int n_devices = probe_usb_controllers();
+    if (poc_samples_init(&g_arena, (size_t)N_SAMPLES * (sizeof(uint64_t) + 3) +
+                                       N_FRAMES * sizeof(uint64_t) + 5 * 64) != 0) {
+        perror("mmap");
+        return 1;
+    }
+    g_timings = POC_SAMPLES_U64(&g_arena, N_SAMPLES);
+    g_intervals = POC_SAMPLES_U64(&g_arena, N_FRAMES);
+    g_lsb = POC_SAMPLES_U8(&g_arena, N_SAMPLES);
+    g_xor = POC_SAMPLES_U8(&g_arena, N_SAMPLES);
+    g_delta = POC_SAMPLES_U8(&g_arena, N_SAMPLES - 1);
+
+    // Match once (newer class first); every probe below reuses the handles
+    static const char *const device_classes[] = {"IOUSBHostDevice", "IOUSBDevice", NULL};
+    static const char *const controller_classes[] = {"AppleUSBHostController",
+                                                     "IOUSBController", NULL};
+    int total_devices = 0;
+    g_n_devices = match_once(device_classes, g_devices, MAX_DEVICES, &total_devices);
+    g_n_controllers = match_once(controller_classes, g_controllers, MAX_CONTROLLERS, NULL);
+
+    int n_devices = probe_usb_controllers(total_devices);
     if (n_devices == 0) {
         printf("No USB devices found. Mac Mini M4 may use Thunderbolt/internal buses.\n");
         printf("Falling back to IORegistry timing methods...\n");
@@ -319,6 +390,10 @@ int main(void) {
 
     probe_usb_hub_timing();
     probe_beat_frequency();
+    probe_sof_phase();
 
+    for (int i = 0; i < g_n_devices; i++) IOObjectRelease(g_devices[i]);
+    for (int i = 0; i < g_n_controllers; i++) IOObjectRelease(g_controllers[i]);
+    poc_samples_free(&g_arena);
     return 0;
 }
@@ -12,6 +12,10 @@
 //
 // Build: cc -O2 -o unprecedented_ane_jitter unprecedented_ane_jitter.c -framework Accelerate -framework CoreFoundation -lm
 // (BNNS approach — doesn't need CoreML model file)
+//
+// cblas_sgemm runs on the CPU / AMX, so this measures those units rather than
+// the ANE. collectors/coreml_ane.m (make validate_coreml_ane) is the Neural
+// Engine path: a Core ML model with several async predictions in flight.
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -21,29 +25,13 @@
 #include <mach/mach_time.h>
 #include <Accelerate/Accelerate.h>
 
+#include "lib/poc_arena.h"
+#include "lib/poc_stats.h"
+
 #define N_SAMPLES 12000
 #define MATRIX_SIZE 64   // Small enough to be fast, large enough for real work
 #define INNER_OPS 4      // Multiple operations per timing sample
 
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
-        }
-    }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
-}
-
 // Volatile sink to prevent dead-code elimination
 static volatile float v_sink = 0.0f;
 
@@ -53,6 +41,14 @@ int main(void) {
     mach_timebase_info_data_t tb;
     mach_timebase_info(&tb);
 
+    // The timing series and its two byte views, shared by every test and
+    // pre-faulted and locked before the first timed loop writes them
+    PocSampleArena arena;
+    if (poc_samples_init(&arena, (size_t)N_SAMPLES * (sizeof(uint64_t) + 2) + 3 * 64) != 0) {
+        perror("mmap");
+        return 1;
+    }
+
     // === Approach 1: BLAS matrix operations (may hit AMX/ANE) ===
     printf("--- Test 1: BLAS sgemm Timing ---\n");
 
@@ -65,8 +61,8 @@ int main(void) {
     for (int i = 0; i < M * K; i++) A[i] = sinf((float)i * 0.01f);
     for (int i = 0; i < K * N; i++) B[i] = cosf((float)i * 0.01f);
 
-    uint64_t *timings = malloc(N_SAMPLES * sizeof(uint64_t));
-    uint8_t *lsbs = malloc(N_SAMPLES);
+    uint64_t *timings = POC_SAMPLES_U64(&arena, N_SAMPLES);
+    uint8_t *lsbs = POC_SAMPLES_U8(&arena, N_SAMPLES);
 
     for (int i = 0; i < N_SAMPLES; i++) {
         memset(C, 0, M * N * sizeof(float));
@@ -94,7 +90,7 @@ int main(void) {
 
     // === Test 2: Delta timing ===
     printf("\n--- Test 2: BLAS sgemm Delta Timing ---\n");
-    uint8_t *deltas = malloc(N_SAMPLES);
+    uint8_t *deltas = POC_SAMPLES_U8(&arena, N_SAMPLES);
     for (int i = 1; i < N_SAMPLES; i++) {
         int64_t d = (int64_t)timings[i] - (int64_t)timings[i-1];
         uint64_t ud = (uint64_t)d;
@@ -227,7 +223,7 @@ int main(void) {
     }
 
     free(A); free(B); free(C);
-    free(timings); free(lsbs); free(deltas);
+    poc_samples_free(&arena);
     free(fft_real); free(fft_imag);
     free(nn_input); free(nn_output); free(nn_weights); free(nn_bias);
     vDSP_destroy_fftsetup(fft_setup);
@@ -13,6 +13,16 @@
 // Different from disk_io because this specifically measures the full
 // journal commit path, not just raw block reads.
 //
+// Tests 1-4 commit serially from one thread. Test 5 (lib/poc_fsync) runs
+// K workers, each fsyncing its own preallocated files concurrently, with
+// plain fsync and with F_FULLFSYNC, to show how commit entropy and
+// commits/s scale with concurrency. On Linux F_FULLFSYNC does not exist;
+// the io_uring rows instead keep K write+fsync commits in flight from one
+// thread, resubmitted in batches.
+//
+//   ./unprecedented_fsync_journal            all tests
+//   ./unprecedented_fsync_journal --sweep    Test 5 only
+//
 // Build: cc -O2 -o unprecedented_fsync_journal unprecedented_fsync_journal.c -lm
 
 #include <stdio.h>
@@ -23,31 +33,69 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
-#include <mach/mach_time.h>
+#include "lib/poc_arena.h"
+#include "lib/poc_fsync.h"
+#include "lib/poc_platform.h"
+#include "lib/poc_stats.h"
+#include "lib/poc_uring.h"
 
 #define N_SAMPLES 12000
 #define WRITE_SIZES_COUNT 4
+#define SWEEP_COMMITS 2400   // total commits per (mode, K) point
+
+// Test 5: concurrent commits for each mode and worker count.
+static void concurrency_sweep(const char *dir, double ns_per_tick, PocSampleArena *arena) {
+    static const int ks[] = {1, 2, 4, 8, 16};
+    static const char *const engines[] = {"fsync", "F_FULLFSYNC", "io_uring"};
+    uint64_t *timings = POC_SAMPLES_U64(arena, SWEEP_COMMITS);
+
+    printf("  %-12s %4s %10s %10s %10s %9s %9s\n",
+           "Mode", "K", "commits/s", "mean µs", "max µs", "H∞ all", "H∞ min/K");
+    for (int m = 0; m < 3; m++) {
+#if !defined(F_FULLFSYNC)
+        if (m == 1) continue;   // would be plain fsync again
+#endif
+        if (m == 2 && !poc_uring_available()) continue;
+        for (size_t ki = 0; ki < sizeof(ks) / sizeof(ks[0]); ki++) {
+            PocFsyncConfig cfg = {
+                .workers = ks[ki],
+                .files_per_worker = 4,
+                .commits = SWEEP_COMMITS / ks[ki],
+                .write_size = 512,
+                .file_size = 256 * 1024,
+                .mode = m == 1 ? POC_FSYNC_FULL : POC_FSYNC_PLAIN,
+            };
+            uint64_t elapsed = 0;
+            int ok = m == 2 ? poc_fsync_uring_run(dir, &cfg, timings, &elapsed)
+                            : poc_fsync_run(dir, &cfg, timings, &elapsed);
+            int n = cfg.workers * cfg.commits;
+            if (ok <= 0) {
+                printf("  %-12s %4d failed\n", engines[m], cfg.workers);
+                continue;
+            }
 
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
+            uint64_t tmax = 0;
+            for (int i = 0; i < n; i++) if (timings[i] > tmax) tmax = timings[i];
+            Stats all = compute_stats(timings, n);
+            // Worst single worker: a thread whose own stream is poor drags the pool
+            double worst = 8.0;
+            for (int w = 0; w < cfg.workers; w++) {
+                Stats s = compute_stats(timings + w * cfg.commits, cfg.commits);
+                if (s.min_entropy < worst) worst = s.min_entropy;
+            }
+            double secs = elapsed * ns_per_tick / 1e9;
+            printf("  %-12s %4d %10.0f %10.1f %10.1f %9.3f %9.3f\n",
+                   engines[m], cfg.workers, ok / secs,
+                   all.mean * ns_per_tick / 1000, tmax * ns_per_tick / 1000,
+                   all.min_entropy, worst);
         }
     }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
+    printf("  (H∞ over XOR-folded commit times: all workers pooled, and the worst worker;\n"
+           "   io_uring K = commits in flight)\n");
 }
 
-int main(void) {
+int main(int argc, char **argv) {
+    int sweep_only = argc > 1 && strcmp(argv[1], "--sweep") == 0;
     printf("# Filesystem Journal Commit Timing — Full Storage Stack Entropy\n\n");
 
     mach_timebase_info_data_t tb;
@@ -63,8 +111,27 @@ int main(void) {
     }
     printf("Test directory: %s\n\n", tmpdir);
 
-    uint64_t *timings = malloc(N_SAMPLES * sizeof(uint64_t));
-    uint8_t *lsbs = malloc(N_SAMPLES);
+    // Commit timings, their byte views and the sweep's buffer, pre-faulted
+    // and locked before the first timed commit
+    PocSampleArena arena;
+    if (poc_samples_init(&arena, (size_t)N_SAMPLES * (sizeof(uint64_t) + 2) +
+                                     SWEEP_COMMITS * sizeof(uint64_t) + 4 * 64) != 0) {
+        perror("mmap");
+        rmdir(tmpdir);
+        return 1;
+    }
+
+    if (sweep_only) {
+        printf("--- Test 5: Concurrent Multi-File Commits ---\n");
+        concurrency_sweep(tmpdir, ns_per_tick, &arena);
+        rmdir(tmpdir);
+        poc_samples_free(&arena);
+        printf("\nDone.\n");
+        return 0;
+    }
+
+    uint64_t *timings = POC_SAMPLES_U64(&arena, N_SAMPLES);
+    uint8_t *lsbs = POC_SAMPLES_U8(&arena, N_SAMPLES);
     uint8_t *write_buf = malloc(4096);
     memset(write_buf, 0xAA, 4096);
 
@@ -118,8 +185,8 @@ int main(void) {
             tsum += timings[i];
         }
         printf("  Timing range: %llu - %llu ticks (%.0f - %.0f µs), mean=%llu\n",
-               tmin, tmax, tmin * ns_per_tick / 1000, tmax * ns_per_tick / 1000,
-               tsum/N_SAMPLES);
+               (unsigned long long)tmin, (unsigned long long)tmax, tmin * ns_per_tick / 1000,
+               tmax * ns_per_tick / 1000, (unsigned long long)(tsum / N_SAMPLES));
 
         char label[64];
         snprintf(label, sizeof(label), "Fsync %dB LSBs", wsize);
@@ -161,8 +228,8 @@ int main(void) {
             tsum += timings[i];
         }
         printf("  Timing range: %llu - %llu ticks (%.0f - %.0f µs), mean=%llu\n",
-               tmin, tmax, tmin * ns_per_tick / 1000, tmax * ns_per_tick / 1000,
-               tsum/N_SAMPLES);
+               (unsigned long long)tmin, (unsigned long long)tmax, tmin * ns_per_tick / 1000,
+               tmax * ns_per_tick / 1000, (unsigned long long)(tsum / N_SAMPLES));
         analyze_entropy("Overwrite fsync LSBs", lsbs, N_SAMPLES);
 
         unlink(path);
@@ -187,14 +254,13 @@ int main(void) {
         }
         unlink(path);
 
-        uint8_t *deltas = malloc(N_SAMPLES);
+        uint8_t *deltas = POC_SAMPLES_U8(&arena, N_SAMPLES);
         for (int i = 1; i < N_SAMPLES; i++) {
             int64_t d = (int64_t)timings[i] - (int64_t)timings[i-1];
             uint64_t ud = (uint64_t)d;
             deltas[i-1] = (uint8_t)((ud >> 0) ^ (ud >> 8) ^ (ud >> 16) ^ (ud >> 24));
         }
         analyze_entropy("Fsync delta XOR-fold", deltas, N_SAMPLES - 1);
-        free(deltas);
     }
 
     // === Test 4: Multiple file fsync (B-tree churn) ===
@@ -233,14 +299,17 @@ int main(void) {
             tsum += timings[i];
         }
         printf("  Timing range: %llu - %llu ticks (%.0f - %.0f µs), mean=%llu\n",
-               tmin, tmax, tmin * ns_per_tick / 1000, tmax * ns_per_tick / 1000,
-               tsum/N_SAMPLES);
+               (unsigned long long)tmin, (unsigned long long)tmax, tmin * ns_per_tick / 1000,
+               tmax * ns_per_tick / 1000, (unsigned long long)(tsum / N_SAMPLES));
         analyze_entropy("Multi-file fsync LSBs", lsbs, N_SAMPLES);
     }
 
+    // === Test 5: Concurrent multi-file commits ===
+    printf("\n--- Test 5: Concurrent Multi-File Commits ---\n");
+    concurrency_sweep(tmpdir, ns_per_tick, &arena);
+
     rmdir(tmpdir);
-    free(timings);
-    free(lsbs);
+    poc_samples_free(&arena);
     free(write_buf);
 
     printf("\nDone.\n");
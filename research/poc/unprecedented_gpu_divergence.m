@@ -11,6 +11,15 @@
 //
 // This is genuinely novel: nobody measures intra-warp timestamp divergence as entropy.
 //
+// Pipelines and buffers are built once and kept for the whole run. Up to
+// N_INFLIGHT command buffers are queued at a time, each with its own
+// shared-storage output, and completion handlers read the per-thread
+// counters straight from those buffers — the CPU never waits on a single
+// dispatch, so the GPU stays busy. Test 2 is the exception: its quantity is
+// the host round trip of one dispatch (commit to waitUntilCompleted, in
+// ticks), so it stays serial; each round trip's GPU execution time
+// (GPUEndTime - GPUStartTime) is reported next to it.
+//
 // Build: cc -O2 -o unprecedented_gpu_divergence unprecedented_gpu_divergence.m -framework Metal -framework Foundation -framework CoreGraphics -lm
 // Note: Must be compiled as Obj-C (.m) for Metal API.
 
@@ -23,28 +32,12 @@
 #include <math.h>
 #include <mach/mach_time.h>
 
+#include "lib/poc_stats.h"
+
 #define N_SAMPLES 12000
 #define THREADS_PER_GROUP 256
 #define N_GROUPS 64
-
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
-        }
-    }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
-}
+#define N_INFLIGHT 3   // command buffers queued at once
 
 // Metal shader source that captures per-thread timing
 static NSString *shaderSource = @""
@@ -99,6 +92,54 @@ static NSString *memoryShader = @""
 "    output[tid] = sum ^ tid;\n"
 "}\n";
 
+static uint8_t fold32(uint32_t x) {
+    return (uint8_t)((x >> 0) ^ (x >> 8) ^ (x >> 16) ^ (x >> 24));
+}
+
+static double ticks_to_ms(uint64_t ticks) {
+    static mach_timebase_info_data_t tb;
+    if (tb.denom == 0) mach_timebase_info(&tb);
+    return (double)ticks * tb.numer / tb.denom / 1e6;
+}
+
+// Encode `batches` dispatches of `threads` threads with pso, binding
+// out[slot] at index 0 and in[slot] at index 1, keeping up to N_INFLIGHT
+// command buffers queued. prepare(slot) runs on this thread before a slot
+// is reused; harvest(slot, batch, cb) runs on Metal's completion thread
+// once that batch's buffers are readable. Returns after every batch has
+// been harvested.
+static void run_pipelined(id<MTLCommandQueue> queue, id<MTLComputePipelineState> pso,
+                          id<MTLBuffer> *out, id<MTLBuffer> *in, int batches,
+                          uint32_t threads, void (^prepare)(int slot),
+                          void (^harvest)(int slot, int batch, id<MTLCommandBuffer> cb)) {
+    dispatch_semaphore_t free_slots = dispatch_semaphore_create(N_INFLIGHT);
+    for (int batch = 0; batch < batches; batch++) {
+        // One queue completes in commit order, so once a slot frees up the
+        // batch N_INFLIGHT back — the last user of this slot — is done.
+        dispatch_semaphore_wait(free_slots, DISPATCH_TIME_FOREVER);
+        int slot = batch % N_INFLIGHT;
+        if (prepare) prepare(slot);
+
+        id<MTLCommandBuffer> cmdBuf = [queue commandBuffer];
+        id<MTLComputeCommandEncoder> encoder = [cmdBuf computeCommandEncoder];
+        [encoder setComputePipelineState:pso];
+        [encoder setBuffer:out[slot] offset:0 atIndex:0];
+        [encoder setBuffer:in[slot] offset:0 atIndex:1];
+        [encoder dispatchThreads:MTLSizeMake(threads, 1, 1)
+           threadsPerThreadgroup:MTLSizeMake(THREADS_PER_GROUP, 1, 1)];
+        [encoder endEncoding];
+        [cmdBuf addCompletedHandler:^(id<MTLCommandBuffer> cb) {
+            harvest(slot, batch, cb);
+            dispatch_semaphore_signal(free_slots);
+        }];
+        [cmdBuf commit];
+    }
+    // Drain, then restore the count so the semaphore can be released.
+    for (int i = 0; i < N_INFLIGHT; i++) dispatch_semaphore_wait(free_slots, DISPATCH_TIME_FOREVER);
+    for (int i = 0; i < N_INFLIGHT; i++) dispatch_semaphore_signal(free_slots);
+    dispatch_release(free_slots);
+}
+
 int main(void) {
     @autoreleasepool {
         printf("# Metal GPU Shader Timestamp Divergence — Intra-Warp Nondeterminism\n\n");
@@ -138,90 +179,95 @@ int main(void) {
         uint32_t total_threads = THREADS_PER_GROUP * N_GROUPS;
         uint32_t output_size = total_threads * 3 * sizeof(uint32_t);
 
-        id<MTLBuffer> outputBuf = [device newBufferWithLength:output_size
-                                                      options:MTLResourceStorageModeShared];
-        id<MTLBuffer> counterBuf = [device newBufferWithLength:sizeof(uint32_t)
-                                                       options:MTLResourceStorageModeShared];
+        // One output and counter per in-flight command buffer
+        id<MTLBuffer> outputBufs[N_INFLIGHT], counterBufs[N_INFLIGHT];
+        for (int s = 0; s < N_INFLIGHT; s++) {
+            outputBufs[s] = [device newBufferWithLength:output_size
+                                                options:MTLResourceStorageModeShared];
+            counterBufs[s] = [device newBufferWithLength:sizeof(uint32_t)
+                                                 options:MTLResourceStorageModeShared];
+        }
+        // Blocks cannot capture arrays, so handlers go through these
+        id<MTLBuffer> *outs = outputBufs, *counters = counterBufs;
+        void (^reset_counter)(int) = ^(int slot) {
+            memset([counters[slot] contents], 0, sizeof(uint32_t));
+        };
 
         uint64_t *timings = malloc(N_SAMPLES * sizeof(uint64_t));
         uint8_t *lsbs = malloc(N_SAMPLES);
         uint8_t *order_entropy = malloc(N_SAMPLES);
         uint8_t *mixed_entropy = malloc(N_SAMPLES);
+        uint64_t *gpu_ns = malloc(N_SAMPLES * sizeof(uint64_t));
+        uint8_t *gpu_lsbs = malloc(N_SAMPLES);
 
         // === Test 1: Execution order divergence ===
         printf("--- Test 1: GPU Thread Execution Order Divergence ---\n");
 
-        int sample_idx = 0;
-        for (int batch = 0; batch < (N_SAMPLES / total_threads) + 1 && sample_idx < N_SAMPLES; batch++) {
-            // Reset counter
-            memset([counterBuf contents], 0, sizeof(uint32_t));
-
-            uint64_t t0 = mach_absolute_time();
-
-            id<MTLCommandBuffer> cmdBuf = [queue commandBuffer];
-            id<MTLComputeCommandEncoder> encoder = [cmdBuf computeCommandEncoder];
-            [encoder setComputePipelineState:tsPipeline];
-            [encoder setBuffer:outputBuf offset:0 atIndex:0];
-            [encoder setBuffer:counterBuf offset:0 atIndex:1];
-            [encoder dispatchThreads:MTLSizeMake(total_threads, 1, 1)
-               threadsPerThreadgroup:MTLSizeMake(THREADS_PER_GROUP, 1, 1)];
-            [encoder endEncoding];
-            [cmdBuf commit];
-            [cmdBuf waitUntilCompleted];
-
-            uint64_t t1 = mach_absolute_time();
-
+        int batches = (N_SAMPLES + total_threads - 1) / total_threads;
+        uint64_t t0 = mach_absolute_time();
+        run_pipelined(queue, tsPipeline, outputBufs, counterBufs, batches, total_threads,
+                      reset_counter, ^(int slot, int batch, id<MTLCommandBuffer> cb) {
+            (void)cb;
             // Extract entropy from execution order
-            uint32_t *results = (uint32_t *)[outputBuf contents];
-            for (uint32_t t = 0; t < total_threads && sample_idx < N_SAMPLES; t++) {
-                uint32_t order = results[t * 3 + 0];
-                uint32_t val = results[t * 3 + 1];
-                uint32_t mixed = results[t * 3 + 2];
-
+            const uint32_t *results = (const uint32_t *)[outs[slot] contents];
+            uint32_t base = (uint32_t)batch * total_threads;
+            for (uint32_t t = 0; t < total_threads && base + t < N_SAMPLES; t++) {
                 // XOR-fold execution order to byte
-                order_entropy[sample_idx] = (uint8_t)((order >> 0) ^ (order >> 8) ^
-                                                       (order >> 16) ^ (order >> 24));
-                mixed_entropy[sample_idx] = (uint8_t)((mixed >> 0) ^ (mixed >> 8) ^
-                                                       (mixed >> 16) ^ (mixed >> 24));
-                timings[sample_idx] = t1 - t0;
-                lsbs[sample_idx] = (uint8_t)(timings[sample_idx] & 0xFF);
-                sample_idx++;
+                order_entropy[base + t] = fold32(results[t * 3 + 0]);
+                mixed_entropy[base + t] = fold32(results[t * 3 + 2]);
             }
-        }
+        });
+        printf("  %d dispatches in %.2f ms\n", batches, ticks_to_ms(mach_absolute_time() - t0));
 
-        analyze_entropy("Execution order XOR-fold", order_entropy, sample_idx);
-        analyze_entropy("Mixed signal XOR-fold", mixed_entropy, sample_idx);
+        analyze_entropy("Execution order XOR-fold", order_entropy, N_SAMPLES);
+        analyze_entropy("Mixed signal XOR-fold", mixed_entropy, N_SAMPLES);
 
         // === Test 2: GPU dispatch timing ===
-        printf("\n--- Test 2: GPU Dispatch Timing ---\n");
+        // Host round trip of each single-threadgroup dispatch, commit to
+        // waitUntilCompleted, in ticks (one at a time: queuing would time the
+        // queue instead). The command buffer's GPUStartTime / GPUEndTime give
+        // its GPU execution time, in ns, alongside.
+        printf("\n--- Test 2: GPU Dispatch Timing (host round trip) ---\n");
+        t0 = mach_absolute_time();
         for (int i = 0; i < N_SAMPLES; i++) {
-            memset([counterBuf contents], 0, sizeof(uint32_t));
+            reset_counter(0);
 
-            uint64_t t0 = mach_absolute_time();
+            uint64_t r0 = mach_absolute_time();
             id<MTLCommandBuffer> cmdBuf = [queue commandBuffer];
             id<MTLComputeCommandEncoder> encoder = [cmdBuf computeCommandEncoder];
             [encoder setComputePipelineState:tsPipeline];
-            [encoder setBuffer:outputBuf offset:0 atIndex:0];
-            [encoder setBuffer:counterBuf offset:0 atIndex:1];
+            [encoder setBuffer:outputBufs[0] offset:0 atIndex:0];
+            [encoder setBuffer:counterBufs[0] offset:0 atIndex:1];
             [encoder dispatchThreads:MTLSizeMake(THREADS_PER_GROUP, 1, 1)
                threadsPerThreadgroup:MTLSizeMake(THREADS_PER_GROUP, 1, 1)];
             [encoder endEncoding];
             [cmdBuf commit];
             [cmdBuf waitUntilCompleted];
-            uint64_t t1 = mach_absolute_time();
+            uint64_t r1 = mach_absolute_time();
 
-            timings[i] = t1 - t0;
+            timings[i] = r1 - r0;
             lsbs[i] = (uint8_t)(timings[i] & 0xFF);
+            gpu_ns[i] = (uint64_t)(([cmdBuf GPUEndTime] - [cmdBuf GPUStartTime]) * 1e9);
+            gpu_lsbs[i] = (uint8_t)(gpu_ns[i] & 0xFF);
         }
+        double t2_ms = ticks_to_ms(mach_absolute_time() - t0);
+        printf("  %d dispatches in %.1f ms (%.0f dispatches/s)\n", N_SAMPLES, t2_ms,
+               N_SAMPLES / (t2_ms / 1e3));
 
         uint64_t tmin = timings[0], tmax = timings[0], tsum = 0;
+        uint64_t gmin = gpu_ns[0], gmax = gpu_ns[0], gsum = 0;
         for (int i = 0; i < N_SAMPLES; i++) {
             if (timings[i] < tmin) tmin = timings[i];
             if (timings[i] > tmax) tmax = timings[i];
             tsum += timings[i];
+            if (gpu_ns[i] < gmin) gmin = gpu_ns[i];
+            if (gpu_ns[i] > gmax) gmax = gpu_ns[i];
+            gsum += gpu_ns[i];
         }
         printf("  Timing range: %llu - %llu ticks, mean=%llu\n", tmin, tmax, tsum/N_SAMPLES);
         analyze_entropy("GPU dispatch LSBs", lsbs, N_SAMPLES);
+        printf("  GPU execution range: %llu - %llu ns, mean=%llu\n", gmin, gmax, gsum/N_SAMPLES);
+        analyze_entropy("GPU execution time LSBs", gpu_lsbs, N_SAMPLES);
 
         // === Test 3: Delta of GPU dispatch timing ===
         printf("\n--- Test 3: GPU Dispatch Delta ---\n");
@@ -239,8 +285,13 @@ int main(void) {
             uint32_t scratch_size = 4096 * sizeof(uint32_t);
             id<MTLBuffer> scratchBuf = [device newBufferWithLength:scratch_size
                                                            options:MTLResourceStorageModeShared];
-            id<MTLBuffer> memOutBuf = [device newBufferWithLength:total_threads * sizeof(uint32_t)
-                                                          options:MTLResourceStorageModeShared];
+            id<MTLBuffer> memOutBufs[N_INFLIGHT], scratchBufs[N_INFLIGHT];
+            for (int s = 0; s < N_INFLIGHT; s++) {
+                memOutBufs[s] = [device newBufferWithLength:total_threads * sizeof(uint32_t)
+                                                    options:MTLResourceStorageModeShared];
+                scratchBufs[s] = scratchBuf;  // read-only, shared by every slot
+            }
+            id<MTLBuffer> *memOuts = memOutBufs;
 
             // Initialize scratch with pseudo-random pointer chase
             uint32_t *scratch = (uint32_t *)[scratchBuf contents];
@@ -250,28 +301,15 @@ int main(void) {
                 scratch[i] = lcg % 4096;
             }
 
-            sample_idx = 0;
-            for (int batch = 0; batch < (N_SAMPLES / total_threads) + 1 && sample_idx < N_SAMPLES; batch++) {
-                id<MTLCommandBuffer> cmdBuf = [queue commandBuffer];
-                id<MTLComputeCommandEncoder> encoder = [cmdBuf computeCommandEncoder];
-                [encoder setComputePipelineState:memPipeline];
-                [encoder setBuffer:memOutBuf offset:0 atIndex:0];
-                [encoder setBuffer:scratchBuf offset:0 atIndex:1];
-                [encoder dispatchThreads:MTLSizeMake(total_threads, 1, 1)
-                   threadsPerThreadgroup:MTLSizeMake(THREADS_PER_GROUP, 1, 1)];
-                [encoder endEncoding];
-                [cmdBuf commit];
-                [cmdBuf waitUntilCompleted];
-
-                uint32_t *memResults = (uint32_t *)[memOutBuf contents];
-                for (uint32_t t = 0; t < total_threads && sample_idx < N_SAMPLES; t++) {
-                    uint32_t val = memResults[t];
-                    lsbs[sample_idx] = (uint8_t)((val >> 0) ^ (val >> 8) ^
-                                                   (val >> 16) ^ (val >> 24));
-                    sample_idx++;
-                }
-            }
-            analyze_entropy("Memory divergence XOR-fold", lsbs, sample_idx);
+            run_pipelined(queue, memPipeline, memOutBufs, scratchBufs, batches, total_threads,
+                          nil, ^(int slot, int batch, id<MTLCommandBuffer> cb) {
+                (void)cb;
+                const uint32_t *memResults = (const uint32_t *)[memOuts[slot] contents];
+                uint32_t base = (uint32_t)batch * total_threads;
+                for (uint32_t t = 0; t < total_threads && base + t < N_SAMPLES; t++)
+                    lsbs[base + t] = fold32(memResults[t]);
+            });
+            analyze_entropy("Memory divergence XOR-fold", lsbs, N_SAMPLES);
         }
 
         free(timings);
@@ -279,6 +317,8 @@ int main(void) {
         free(order_entropy);
         free(mixed_entropy);
         free(deltas);
+        free(gpu_ns);
+        free(gpu_lsbs);
 
         printf("\nDone.\n");
     }
@@ -7,6 +7,12 @@
 // Each domain transition adds independent timing noise from cache coherence
 // traffic, fabric arbitration, and cross-clock-domain synchronization.
 //
+// Tests 1-4 serialize every step (CPU write, GPU pass, wait, CPU read).
+// Test 5 pipelines them over two ping-pong surfaces: MTLSharedEvent values
+// hand each surface from CPU to GPU and back, so the CPU times the
+// coherence crossing on surface N while the GPU works on N+1, and each
+// domain crossing gets its own timestamp.
+//
 // Build: cc -O2 -o unprecedented_iosurface_crossing unprecedented_iosurface_crossing.m -framework IOSurface -framework Metal -framework Foundation -framework CoreGraphics -lm
 
 #import <IOSurface/IOSurface.h>
@@ -19,28 +25,12 @@
 #include <math.h>
 #include <mach/mach_time.h>
 
+#include "lib/poc_stats.h"
+
 #define N_SAMPLES 12000
 #define SURFACE_WIDTH 256
 #define SURFACE_HEIGHT 256
-
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
-        }
-    }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
-}
+#define N_SURFACES 2   // ping-pong pair for the pipelined test
 
 // Metal shader: write to shared texture then read back
 static NSString *shaderSource = @""
@@ -73,6 +63,26 @@ static NSString *shaderSource = @""
 "    output[gid.y * 256 + gid.x] = val;\n"
 "}\n";
 
+static IOSurfaceRef create_surface(void) {
+    NSDictionary *props = @{
+        (id)kIOSurfaceWidth: @(SURFACE_WIDTH),
+        (id)kIOSurfaceHeight: @(SURFACE_HEIGHT),
+        (id)kIOSurfaceBytesPerElement: @4,
+        (id)kIOSurfacePixelFormat: @((uint32_t)'BGRA'),
+    };
+    return IOSurfaceCreate((CFDictionaryRef)props);
+}
+
+static void print_range(const char *unit, const uint64_t *v, int n) {
+    uint64_t lo = v[0], hi = v[0], sum = 0;
+    for (int i = 0; i < n; i++) {
+        if (v[i] < lo) lo = v[i];
+        if (v[i] > hi) hi = v[i];
+        sum += v[i];
+    }
+    printf("  Timing range: %llu - %llu %s, mean=%llu\n", lo, hi, unit, sum / n);
+}
+
 int main(void) {
     @autoreleasepool {
         printf("# IOSurface GPU/CPU Memory Domain Crossing — Coherence Entropy\n\n");
@@ -87,13 +97,7 @@ int main(void) {
         id<MTLCommandQueue> queue = [gpu newCommandQueue];
 
         // Create IOSurface — shared between CPU and GPU
-        NSDictionary *props = @{
-            (id)kIOSurfaceWidth: @(SURFACE_WIDTH),
-            (id)kIOSurfaceHeight: @(SURFACE_HEIGHT),
-            (id)kIOSurfaceBytesPerElement: @4,
-            (id)kIOSurfacePixelFormat: @((uint32_t)'BGRA'),
-        };
-        IOSurfaceRef surface = IOSurfaceCreate((CFDictionaryRef)props);
+        IOSurfaceRef surface = create_surface();
         if (!surface) {
             printf("FAIL: Cannot create IOSurface\n");
             return 1;
@@ -167,13 +171,7 @@ int main(void) {
             lsbs[i] = (uint8_t)(timings[i] & 0xFF);
         }
 
-        uint64_t tmin = timings[0], tmax = timings[0], tsum = 0;
-        for (int i = 0; i < N_SAMPLES; i++) {
-            if (timings[i] < tmin) tmin = timings[i];
-            if (timings[i] > tmax) tmax = timings[i];
-            tsum += timings[i];
-        }
-        printf("  Timing range: %llu - %llu ticks, mean=%llu\n", tmin, tmax, tsum/N_SAMPLES);
+        print_range("ticks", timings, N_SAMPLES);
         analyze_entropy("CPU→GPU crossing LSBs", lsbs, N_SAMPLES);
 
         // === Test 2: GPU write → CPU read timing ===
@@ -205,13 +203,7 @@ int main(void) {
             lsbs[i] = (uint8_t)(timings[i] & 0xFF);
         }
 
-        tmin = timings[0]; tmax = timings[0]; tsum = 0;
-        for (int i = 0; i < N_SAMPLES; i++) {
-            if (timings[i] < tmin) tmin = timings[i];
-            if (timings[i] > tmax) tmax = timings[i];
-            tsum += timings[i];
-        }
-        printf("  Timing range: %llu - %llu ticks, mean=%llu\n", tmin, tmax, tsum/N_SAMPLES);
+        print_range("ticks", timings, N_SAMPLES);
         analyze_entropy("GPU→CPU crossing LSBs", lsbs, N_SAMPLES);
 
         // === Test 3: Round-trip (CPU→GPU→CPU) timing ===
@@ -250,13 +242,7 @@ int main(void) {
             lsbs[i] = (uint8_t)(timings[i] & 0xFF);
         }
 
-        tmin = timings[0]; tmax = timings[0]; tsum = 0;
-        for (int i = 0; i < N_SAMPLES; i++) {
-            if (timings[i] < tmin) tmin = timings[i];
-            if (timings[i] > tmax) tmax = timings[i];
-            tsum += timings[i];
-        }
-        printf("  Timing range: %llu - %llu ticks, mean=%llu\n", tmin, tmax, tsum/N_SAMPLES);
+        print_range("ticks", timings, N_SAMPLES);
         analyze_entropy("Round-trip crossing LSBs", lsbs, N_SAMPLES);
 
         // === Test 4: Delta timing ===
@@ -269,6 +255,142 @@ int main(void) {
         }
         analyze_entropy("Round-trip delta XOR-fold", deltas, N_SAMPLES - 1);
 
+        // === Test 5: Pipelined ping-pong crossing ===
+        // Iteration i: CPU writes surface i%2 and signals cpuEvent = i+1;
+        // command buffer i (already queued) waits on that value, reads what
+        // the CPU wrote, overwrites the texture and signals gpuEvent = i+1.
+        // Meanwhile the CPU waits for gpuEvent = i and times its read of
+        // surface (i-1)%2, which the GPU finished one step earlier.
+        printf("\n--- Test 5: Pipelined Ping-Pong Crossing (MTLSharedEvent) ---\n");
+        IOSurfaceRef surfaces[N_SURFACES];
+        id<MTLTexture> textures[N_SURFACES];
+        id<MTLBuffer> counters[N_SURFACES], outputs[N_SURFACES];
+        int n_surfaces = 0;
+        for (int s = 0; s < N_SURFACES; s++) {
+            surfaces[s] = create_surface();
+            if (!surfaces[s]) break;
+            textures[s] = [gpu newTextureWithDescriptor:texDesc iosurface:surfaces[s] plane:0];
+            counters[s] = [gpu newBufferWithLength:sizeof(uint32_t)
+                                           options:MTLResourceStorageModeShared];
+            outputs[s] = [gpu newBufferWithLength:output_size
+                                          options:MTLResourceStorageModeShared];
+            n_surfaces++;
+        }
+        id<MTLSharedEvent> cpuEvent = [gpu newSharedEvent];  // CPU -> GPU handoffs
+        id<MTLSharedEvent> gpuEvent = [gpu newSharedEvent];  // GPU -> CPU handoffs
+
+        if (n_surfaces < N_SURFACES || !cpuEvent || !gpuEvent) {
+            printf("  SKIP: cannot create ping-pong surfaces or shared events\n");
+        } else {
+            uint64_t *cpu_write = malloc(N_SAMPLES * sizeof(uint64_t));  // CPU -> surface
+            uint64_t *handoff = malloc(N_SAMPLES * sizeof(uint64_t));    // signal -> GPU done seen
+            uint64_t *cpu_read = malloc(N_SAMPLES * sizeof(uint64_t));   // surface -> CPU
+            uint64_t *gpu_exec = malloc(N_SAMPLES * sizeof(uint64_t));   // GPU pass, ns
+            uint64_t *signaled = malloc(N_SAMPLES * sizeof(uint64_t));
+            // Blocks cannot capture arrays, so they go through these
+            IOSurfaceRef *surfs = surfaces;
+            id<MTLTexture> *texs = textures;
+            id<MTLBuffer> *ctrs = counters, *outs = outputs;
+            uint64_t *gp = gpu_exec;
+
+            // Queue command buffer i; it stalls on the GPU until cpuEvent = i+1.
+            void (^enqueue)(int) = ^(int i) {
+                int s = i % N_SURFACES;
+                id<MTLCommandBuffer> cb = [queue commandBuffer];
+                [cb encodeWaitForEvent:cpuEvent value:(uint64_t)i + 1];
+                id<MTLComputeCommandEncoder> enc = [cb computeCommandEncoder];
+                [enc setComputePipelineState:readPipeline];
+                [enc setTexture:texs[s] atIndex:0];
+                [enc setBuffer:outs[s] offset:0 atIndex:0];
+                [enc dispatchThreads:MTLSizeMake(SURFACE_WIDTH, SURFACE_HEIGHT, 1)
+                   threadsPerThreadgroup:MTLSizeMake(16, 16, 1)];
+                [enc setComputePipelineState:writePipeline];
+                [enc setTexture:texs[s] atIndex:0];
+                [enc setBuffer:ctrs[s] offset:0 atIndex:0];
+                [enc dispatchThreads:MTLSizeMake(SURFACE_WIDTH, SURFACE_HEIGHT, 1)
+                   threadsPerThreadgroup:MTLSizeMake(16, 16, 1)];
+                [enc endEncoding];
+                [cb encodeSignalEvent:gpuEvent value:(uint64_t)i + 1];
+                [cb addCompletedHandler:^(id<MTLCommandBuffer> done) {
+                    gp[i] = (uint64_t)(([done GPUEndTime] - [done GPUStartTime]) * 1e9);
+                }];
+                [cb commit];
+            };
+
+            // Spin until the GPU has released command buffer i's surface,
+            // then time the GPU -> CPU read of it.
+            void (^harvest)(int) = ^(int i) {
+                while ([gpuEvent signaledValue] < (uint64_t)i + 1) {}
+                handoff[i] = mach_absolute_time() - signaled[i];
+
+                uint64_t t0 = mach_absolute_time();
+                IOSurfaceRef surf = surfs[i % N_SURFACES];
+                IOSurfaceLock(surf, kIOSurfaceLockReadOnly, NULL);
+                volatile uint8_t *rbase = (volatile uint8_t *)IOSurfaceGetBaseAddress(surf);
+                volatile uint8_t sum = 0;
+                for (int j = 0; j < 64; j++) sum ^= rbase[j];
+                IOSurfaceUnlock(surf, kIOSurfaceLockReadOnly, NULL);
+                cpu_read[i] = mach_absolute_time() - t0;
+            };
+
+            uint64_t start = mach_absolute_time();
+            enqueue(0);
+            for (int i = 0; i < N_SAMPLES; i++) {
+                // Surface i%2 was last used by command buffer i-2, which
+                // harvest(i-2) already waited out.
+                IOSurfaceRef surf = surfaces[i % N_SURFACES];
+                uint64_t t0 = mach_absolute_time();
+                IOSurfaceLock(surf, 0, NULL);
+                uint8_t *wbase = (uint8_t *)IOSurfaceGetBaseAddress(surf);
+                memset(wbase, (uint8_t)(t0 & 0xFF), 64);
+                IOSurfaceUnlock(surf, 0, NULL);
+                uint64_t t1 = mach_absolute_time();
+                cpu_write[i] = t1 - t0;
+                memset([counters[i % N_SURFACES] contents], 0, sizeof(uint32_t));
+
+                signaled[i] = mach_absolute_time();
+                cpuEvent.signaledValue = (uint64_t)i + 1;
+
+                // Queue the next pass before touching the previous surface so
+                // the GPU never idles waiting for the CPU.
+                if (i + 1 < N_SAMPLES) enqueue(i + 1);
+                if (i > 0) harvest(i - 1);
+            }
+            harvest(N_SAMPLES - 1);
+            uint64_t elapsed = mach_absolute_time() - start;
+            mach_timebase_info_data_t tb;
+            mach_timebase_info(&tb);
+            double elapsed_ms = (double)elapsed * tb.numer / tb.denom / 1e6;
+
+            // The completion handler for the final pass may trail its signal.
+            id<MTLCommandBuffer> last = [queue commandBuffer];
+            [last commit];
+            [last waitUntilCompleted];
+
+            printf("  %d crossings in %.1f ms (%.0f samples/s)\n", N_SAMPLES, elapsed_ms,
+                   N_SAMPLES / (elapsed_ms / 1e3));
+
+            struct { const char *label, *unit; uint64_t *v; } crossings[] = {
+                {"CPU→surface write LSBs", "ticks", cpu_write},
+                {"GPU pass duration LSBs", "ns", gpu_exec},
+                {"Event handoff CPU→GPU→CPU LSBs", "ticks", handoff},
+                {"Surface→CPU read LSBs", "ticks", cpu_read},
+            };
+            for (size_t c = 0; c < sizeof(crossings) / sizeof(crossings[0]); c++) {
+                printf("  [%s]\n", crossings[c].label);
+                print_range(crossings[c].unit, crossings[c].v, N_SAMPLES);
+                for (int i = 0; i < N_SAMPLES; i++) lsbs[i] = (uint8_t)(crossings[c].v[i] & 0xFF);
+                analyze_entropy(crossings[c].label, lsbs, N_SAMPLES);
+            }
+
+            free(cpu_write);
+            free(handoff);
+            free(cpu_read);
+            free(gpu_exec);
+            free(signaled);
+        }
+        for (int s = 0; s < n_surfaces; s++) CFRelease(surfaces[s]);
+
         free(timings);
         free(lsbs);
         free(deltas);
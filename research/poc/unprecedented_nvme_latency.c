@@ -10,9 +10,19 @@
 // By reading the SAME sector repeatedly with nanosecond timing, we capture
 // flash cell physics variance distinct from filesystem caching.
 //
-// Build: cc -O2 -o unprecedented_nvme_latency unprecedented_nvme_latency.c
-// Note: Uses /dev/rdisk0 (raw device) for bypass of filesystem cache.
-//       May need root for raw disk access.
+// Tests 1-5 issue one synchronous read at a time (queue depth 1). Test 6
+// sweeps queue depth 1..32 with lib/poc_qdread: that many aligned
+// random-offset preads stay in flight and every completion is timestamped.
+// Test 7 (Linux) runs the same sweep from one thread over io_uring, each
+// batch of completions refilled with one submission.
+//
+// Build: make unprecedented_nvme_latency
+// Note: Uses /dev/rdisk0 (macOS) or /dev/nvme0n1 (Linux) to bypass the
+//       filesystem cache; raw disk access may need root.
+
+#if defined(__linux__)
+#define _GNU_SOURCE   // O_DIRECT
+#endif
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -22,29 +32,78 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
-#include <mach/mach_time.h>
+#include "lib/poc_platform.h"
+#include "lib/poc_qdread.h"
+#include "lib/poc_stats.h"
+#include "lib/poc_uring.h"
 
 #define N_SAMPLES 15000
 #define BLOCK_SIZE 4096
 #define N_OFFSETS  8
+#define QD_SPAN_FILE (16 << 20)  // temp-file region for random reads
+#define QD_SPAN_RAW  (1ll << 30) // first 1 GiB of a raw device
+#define QD_MAX 32
+
+typedef int (*QdRunner)(int fd, off_t span, size_t block, int depth, uint64_t seed,
+                        PocQdCompletion *out, int total);
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Bypass the buffer cache: F_NOCACHE on macOS, O_DIRECT on Linux (which
+// not every filesystem accepts; tmpfs does not).
+static const char *no_cache(int fd) {
+#if defined(F_NOCACHE)
+    fcntl(fd, F_NOCACHE, 1);
+    return "F_NOCACHE";
+#else
+    int fl = fcntl(fd, F_GETFL);
+    if (fl >= 0 && fcntl(fd, F_SETFL, fl | O_DIRECT) == 0) return "O_DIRECT";
+    return "page cache";
+#endif
+}
+
+// Tests 6 and 7: IOPS, latency quantiles and H∞ per queue depth.
+static void qd_sweep(QdRunner run, int fd, off_t span, double ns_per_tick) {
+    PocQdCompletion *comp = malloc(N_SAMPLES * sizeof(PocQdCompletion));
+    uint64_t *lat = malloc(N_SAMPLES * sizeof(uint64_t));
+    uint64_t *gaps = malloc(N_SAMPLES * sizeof(uint64_t));
+    if (!comp || !lat || !gaps) return;
+    printf("  %-4s %9s %9s %9s %9s %9s %10s %10s\n",
+           "QD", "IOPS", "p50 us", "p90 us", "p99 us", "max us", "H∞ lat", "H∞ gap");
+    for (int qd = 1; qd <= QD_MAX; qd *= 2) {
+        uint64_t t0 = mach_absolute_time();
+        int ok = run(fd, span, BLOCK_SIZE, qd, t0, comp, N_SAMPLES);
+        uint64_t t1 = mach_absolute_time();
+        if (ok <= 0) {
+            printf("  %-4d failed\n", qd);
+            continue;
+        }
 
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
+        // Latency per completion, and gaps between successive completions
+        for (int i = 0; i < N_SAMPLES; i++) {
+            lat[i] = comp[i].latency;
+            gaps[i] = i ? comp[i].done - comp[i - 1].done : 0;
         }
+        Stats s_lat = compute_stats(lat, N_SAMPLES);
+        Stats s_gap = compute_stats(gaps + 1, N_SAMPLES - 1);
+
+        qsort(lat, N_SAMPLES, sizeof(uint64_t), cmp_u64);
+        double secs = (double)(t1 - t0) * ns_per_tick / 1e9;
+        printf("  %-4d %9.0f %9.1f %9.1f %9.1f %9.1f %10.3f %10.3f\n", qd,
+               N_SAMPLES / secs,
+               lat[N_SAMPLES / 2] * ns_per_tick / 1e3,
+               lat[N_SAMPLES * 9 / 10] * ns_per_tick / 1e3,
+               lat[N_SAMPLES * 99 / 100] * ns_per_tick / 1e3,
+               lat[N_SAMPLES - 1] * ns_per_tick / 1e3,
+               s_lat.min_entropy, s_gap.min_entropy);
     }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
+    printf("  (H∞ per completion, bits, over XOR-folded latency / inter-completion gap)\n");
+    free(comp);
+    free(lat);
+    free(gaps);
 }
 
 int main(void) {
@@ -55,7 +114,11 @@ int main(void) {
     const char *device = NULL;
 
     // Try raw disk first (needs root)
+#if defined(__APPLE__)
     const char *devices[] = {"/dev/rdisk0", "/dev/rdisk1", NULL};
+#else
+    const char *devices[] = {"/dev/nvme0n1", "/dev/nvme1n1", NULL};
+#endif
     for (int i = 0; devices[i]; i++) {
         fd = open(devices[i], O_RDONLY);
         if (fd >= 0) {
@@ -64,7 +127,7 @@ int main(void) {
         }
     }
 
-    // Fallback: use a temp file with F_NOCACHE to bypass buffer cache
+    // Fallback: a temp file with the buffer cache bypassed
     char tmppath[256] = "/tmp/nvme_entropy_probe_XXXXXX";
     int using_tmpfile = 0;
     if (fd < 0) {
@@ -85,13 +148,9 @@ int main(void) {
         fsync(fd);
         free(buf);
 
-        // Disable buffer caching (macOS-specific)
-        fcntl(fd, F_NOCACHE, 1);
-
-        printf("Using temp file: %s (with F_NOCACHE)\n", tmppath);
+        printf("Using temp file: %s (%s)\n", tmppath, no_cache(fd));
     } else {
-        printf("Using raw device: %s\n", device);
-        fcntl(fd, F_NOCACHE, 1);
+        printf("Using raw device: %s (%s)\n", device, no_cache(fd));
     }
 
     uint8_t *read_buf = (uint8_t *)malloc(BLOCK_SIZE);
@@ -133,8 +192,8 @@ int main(void) {
         if (timings[i] > tmax) tmax = timings[i];
         tsum += timings[i];
     }
-    printf("  Timing range: %llu - %llu ticks, mean=%llu\n",
-           tmin, tmax, tsum / N_SAMPLES);
+    printf("  Timing range: %llu - %llu ticks, mean=%llu\n", (unsigned long long)tmin,
+           (unsigned long long)tmax, (unsigned long long)(tsum / N_SAMPLES));
     analyze_entropy("Same-sector LSBs", lsbs, N_SAMPLES);
 
     // === Test 2: Multi-offset read timing ===
@@ -165,7 +224,7 @@ int main(void) {
     // === Test 4: Read-after-write timing (WAF and GC effects) ===
     printf("\n--- Test 4: Read-After-Write Timing ---\n");
     if (using_tmpfile) {
-        uint8_t write_buf[512];
+        _Alignas(4096) uint8_t write_buf[512];   // O_DIRECT wants aligned buffers
         for (int i = 0; i < N_SAMPLES; i++) {
             // Write a small amount to trigger NVMe activity
             memset(write_buf, (uint8_t)i, sizeof(write_buf));
@@ -203,6 +262,32 @@ int main(void) {
     }
     analyze_entropy("Burst read bits[2:9]", lsbs, N_SAMPLES);
 
+    // === Test 6: Queue-depth sweep (concurrent random reads) ===
+    printf("\n--- Test 6: Queue-Depth Sweep ---\n");
+    off_t span = QD_SPAN_RAW;
+    if (using_tmpfile) {
+        // Fill a region large enough that random reads spread over pages.
+        uint8_t *chunk = NULL;
+        if (posix_memalign((void **)&chunk, 4096, 1 << 20) != 0) return 1;
+        for (int i = 0; i < (1 << 20); i++) chunk[i] = (uint8_t)((i * 7 + 13) ^ (i >> 8));
+        for (off_t o = 0; o < QD_SPAN_FILE; o += 1 << 20) {
+            chunk[0] = (uint8_t)(o >> 20);
+            pwrite(fd, chunk, 1 << 20, o);
+        }
+        fsync(fd);
+        free(chunk);
+        span = QD_SPAN_FILE;
+    }
+
+    double ns_per_tick = (double)tb.numer / tb.denom;
+    qd_sweep(poc_qd_run, fd, span, ns_per_tick);
+
+    // === Test 7: Queue-depth sweep over io_uring (batched submission) ===
+    if (poc_uring_available()) {
+        printf("\n--- Test 7: Queue-Depth Sweep, io_uring ---\n");
+        qd_sweep(poc_qd_uring_run, fd, span, ns_per_tick);
+    }
+
     free(timings);
     free(lsbs);
     free(deltas);
@@ -6,6 +6,7 @@
 //
 // Approach: Run a known workload on one core while measuring timing on another.
 // The timing perturbation captures PDN voltage noise from cross-core coupling.
+// The stress workers are lib/poc_load.h loads, one thread each.
 //
 // Build: cc -O2 -o unprecedented_pdn_resonance unprecedented_pdn_resonance.c -lpthread -lm
 
@@ -20,74 +21,16 @@
 #include <mach/thread_act.h>
 #include <mach/thread_policy.h>
 
+#include "lib/poc_load.h"
+#include "lib/poc_stats.h"
+
 #define N_SAMPLES 12000
 #define STRESS_ITERATIONS 1000
 
-static volatile int stress_running = 1;
-static volatile uint64_t stress_sink = 0;
-
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
-        }
-    }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
-}
-
-// Stress thread: high current draw workload to excite PDN resonance
-static void *stress_memory_worker(void *arg) {
-    (void)arg;
-    // Allocate a large buffer to cause cache thrashing and high current draw
-    size_t buf_size = 4 * 1024 * 1024; // 4 MB
-    volatile uint64_t *buf = malloc(buf_size);
-    if (!buf) return NULL;
-
-    while (stress_running) {
-        // Stride access pattern — causes high cache miss rate and bursty current
-        for (size_t i = 0; i < buf_size / sizeof(uint64_t); i += 64) {
-            buf[i] = buf[i] + 1;
-        }
-        stress_sink = buf[0];
-    }
-    free((void *)buf);
-    return NULL;
-}
-
-// Stress thread: integer ALU workload (different current profile)
-static void *stress_alu_worker(void *arg) {
-    (void)arg;
-    while (stress_running) {
-        volatile uint64_t a = mach_absolute_time();
-        for (int i = 0; i < 10000; i++) {
-            a = a * 6364136223846793005ULL + 1442695040888963407ULL;
-        }
-        stress_sink = a;
-    }
-    return NULL;
-}
-
-// Stress thread: FPU workload (yet another current profile)
-static void *stress_fpu_worker(void *arg) {
-    (void)arg;
-    volatile double acc = 1.0;
-    while (stress_running) {
-        for (int i = 0; i < 10000; i++) {
-            acc = sin(acc) * cos(acc) + 0.1;
-        }
-    }
-    return NULL;
-}
+// One stress worker per load, each a different current profile
+static const PocLoadProfile STRESS_MEM = {"mem", POC_LOAD_MEMORY, 1, 100};
+static const PocLoadProfile STRESS_ALU = {"alu", POC_LOAD_ALU, 1, 100};
+static const PocLoadProfile STRESS_FPU = {"fpu", POC_LOAD_FPU, 1, 100};
 
 // Measurement function: tight timing loop
 static void measure_timing(uint64_t *timings, int n, int workload_type) {
@@ -142,14 +85,12 @@ int main(void) {
 
     // === Test 2: With memory stress (high current, bursty) ===
     printf("\n--- Test 2: Memory Stress (PDN Excitation) ---\n");
-    stress_running = 1;
-    pthread_t stress_t1;
-    pthread_create(&stress_t1, NULL, stress_memory_worker, NULL);
+    PocLoad mem, alu, fpu;
+    poc_load_start(&mem, &STRESS_MEM);
     usleep(10000); // Let stress thread warm up
 
     measure_timing(timings, N_SAMPLES, 0);
-    stress_running = 0;
-    pthread_join(stress_t1, NULL);
+    poc_load_stop(&mem);
 
     tmin = timings[0]; tmax = timings[0]; tsum = 0;
     for (int i = 0; i < N_SAMPLES; i++) {
@@ -163,13 +104,11 @@ int main(void) {
 
     // === Test 3: With ALU stress ===
     printf("\n--- Test 3: ALU Stress (Different Current Profile) ---\n");
-    stress_running = 1;
-    pthread_create(&stress_t1, NULL, stress_alu_worker, NULL);
+    poc_load_start(&alu, &STRESS_ALU);
     usleep(10000);
 
     measure_timing(timings, N_SAMPLES, 0);
-    stress_running = 0;
-    pthread_join(stress_t1, NULL);
+    poc_load_stop(&alu);
 
     tmin = timings[0]; tmax = timings[0]; tsum = 0;
     for (int i = 0; i < N_SAMPLES; i++) {
@@ -183,18 +122,15 @@ int main(void) {
 
     // === Test 4: With FPU + memory stress (maximum current draw) ===
     printf("\n--- Test 4: FPU + Memory Stress (Maximum PDN Excitation) ---\n");
-    stress_running = 1;
-    pthread_t stress_t2, stress_t3;
-    pthread_create(&stress_t1, NULL, stress_memory_worker, NULL);
-    pthread_create(&stress_t2, NULL, stress_fpu_worker, NULL);
-    pthread_create(&stress_t3, NULL, stress_alu_worker, NULL);
+    poc_load_start(&mem, &STRESS_MEM);
+    poc_load_start(&fpu, &STRESS_FPU);
+    poc_load_start(&alu, &STRESS_ALU);
     usleep(10000);
 
     measure_timing(timings, N_SAMPLES, 0);
-    stress_running = 0;
-    pthread_join(stress_t1, NULL);
-    pthread_join(stress_t2, NULL);
-    pthread_join(stress_t3, NULL);
+    poc_load_stop(&mem);
+    poc_load_stop(&fpu);
+    poc_load_stop(&alu);
 
     tmin = timings[0]; tmax = timings[0]; tsum = 0;
     for (int i = 0; i < N_SAMPLES; i++) {
@@ -211,9 +147,8 @@ int main(void) {
     // Alternate: measure with stress on/off rapidly
     uint8_t *stress_deltas = malloc(N_SAMPLES);
 
-    stress_running = 1;
-    pthread_create(&stress_t1, NULL, stress_memory_worker, NULL);
-    pthread_create(&stress_t2, NULL, stress_alu_worker, NULL);
+    poc_load_start(&mem, &STRESS_MEM);
+    poc_load_start(&alu, &STRESS_ALU);
     usleep(10000);
 
     for (int i = 0; i < N_SAMPLES; i++) {
@@ -224,9 +159,8 @@ int main(void) {
         (void)acc;
         timings[i] = t1 - t0;
     }
-    stress_running = 0;
-    pthread_join(stress_t1, NULL);
-    pthread_join(stress_t2, NULL);
+    poc_load_stop(&mem);
+    poc_load_stop(&alu);
 
     for (int i = 1; i < N_SAMPLES; i++) {
         int64_t d = (int64_t)timings[i] - (int64_t)timings[i-1];
@@ -10,38 +10,52 @@
 // By spinning and detecting preemption events (sudden time jumps), the LSBs
 // of preemption timestamps capture interrupt timing noise from ALL hardware.
 //
-// Build: cc -O2 -o unprecedented_quantum_boundary unprecedented_quantum_boundary.c -lm
+// One spinner sees only its own core's boundaries, a few hundred a second.
+// --cores runs one spinner per core instead. Each is placed on its core
+// (pinned on Linux; on macOS a distinct affinity tag plus the QoS class of
+// its core type) and writes every gap event into its own ring
+// (lib/poc_spsc.h, head and tail on separate cache lines), so spinners
+// never share a line. The main thread is the aggregator: it drains the
+// rings while they run and merges the per-core streams by timestamp. The
+// run steps from one spinner to all cores and reports events per second
+// and H∞ per event for the gap lengths and for the merged stream's
+// inter-event intervals. At full width the aggregator shares a core with
+// a spinner, and its own wakeups show up as events there.
+//
+//   ./unprecedented_quantum_boundary                        single-spinner tests
+//   ./unprecedented_quantum_boundary --cores [-t S] [-c K]  1..K spinners (default
+//                                                           all cores), S seconds
+//                                                           per step (default 5)
+//
+// Build: make unprecedented_quantum_boundary
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
 #include <mach/mach_time.h>
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+#include "lib/poc_place.h"
+#include "lib/poc_spsc.h"
+#include "lib/poc_stats.h"
 
 #define N_SAMPLES 12000
 #define PREEMPT_THRESHOLD 1000  // Ticks — jumps above this indicate preemption
 
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
-        }
-    }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
-}
+#define MAX_SPINNERS     64
+#define EVENT_WORDS      3          // timestamp lo, hi, gap (clamped to 32 bits)
+#define RING_WORDS       (1u << 16)
+#define EVENTS_PER_CORE  (1 << 16)  // kept per spinner per step; the rest count as dropped
+#define DRAIN_US         2000
 
-int main(void) {
+static int single_spinner(void) {
     printf("# Mach Thread Quantum Boundary Jitter — Scheduler Preemption Entropy\n\n");
 
     mach_timebase_info_data_t tb;
@@ -183,3 +197,223 @@ int main(void) {
     printf("\nDone.\n");
     return 0;
 }
+
+// --- per-core mode -------------------------------------------------------------
+
+typedef struct {
+    PocSpsc ring;                   // cache-line aligned head / tail
+    int core;
+    int p_cores;
+    int cpu_start, cpu_end;         // poc_place_cpu() as it started / stopped
+    uint64_t *times;                // drained events, aggregator-owned
+    uint32_t *gaps;
+    int n;
+    uint64_t overflow;
+} Spinner;
+
+static atomic_int g_stop;
+static atomic_int g_ready;
+
+static void *spinner_main(void *arg) {
+    Spinner *s = arg;
+    poc_place_apply(s->core < s->p_cores ? POC_QOS_USER_INTERACTIVE : POC_QOS_BACKGROUND,
+                    s->core + 1);
+    s->cpu_start = poc_place_cpu();
+    atomic_fetch_add(&g_ready, 1);
+
+    uint64_t prev = mach_absolute_time();
+    while (!atomic_load_explicit(&g_stop, memory_order_relaxed)) {
+        uint64_t now = mach_absolute_time();
+        uint64_t delta = now - prev;
+        if (delta > PREEMPT_THRESHOLD) {
+            uint32_t ev[EVENT_WORDS] = {(uint32_t)now, (uint32_t)(now >> 32),
+                                        delta > UINT32_MAX ? UINT32_MAX : (uint32_t)delta};
+            poc_spsc_write_all(&s->ring, ev, EVENT_WORDS);
+        }
+        prev = now;
+    }
+    s->cpu_end = poc_place_cpu();
+    return NULL;
+}
+
+// Move everything buffered in each ring into its spinner's event arrays.
+// Records are written whole, so each read is a whole number of them.
+static void drain(Spinner *sp, int k) {
+    uint32_t words[EVENT_WORDS * 1024];
+    for (int i = 0; i < k; i++) {
+        Spinner *s = &sp[i];
+        uint32_t got;
+        while ((got = poc_spsc_read(&s->ring, words, sizeof(words) / sizeof(words[0]))) > 0)
+            for (uint32_t w = 0; w < got; w += EVENT_WORDS) {
+                if (s->n == EVENTS_PER_CORE) {
+                    s->overflow++;
+                    continue;
+                }
+                s->times[s->n] = (uint64_t)words[w + 1] << 32 | words[w];
+                s->gaps[s->n++] = words[w + 2];
+            }
+    }
+}
+
+// k-way merge of the per-spinner streams (each already in time order),
+// keeping events from [t0, t1). Returns the merged count.
+static int merge(Spinner *sp, int k, uint64_t t0, uint64_t t1, uint64_t *times,
+                 uint64_t *gaps) {
+    int pos[MAX_SPINNERS] = {0};
+    int n = 0;
+    for (;;) {
+        int best = -1;
+        for (int i = 0; i < k; i++) {
+            while (pos[i] < sp[i].n && sp[i].times[pos[i]] < t0) pos[i]++;
+            if (pos[i] < sp[i].n && (best < 0 || sp[i].times[pos[i]] < sp[best].times[pos[best]]))
+                best = i;
+        }
+        if (best < 0 || sp[best].times[pos[best]] >= t1) return n;
+        times[n] = sp[best].times[pos[best]];
+        gaps[n++] = sp[best].gaps[pos[best]++];
+    }
+}
+
+static int core_counts(int *p_cores) {
+#if defined(__APPLE__)
+    int p = 0, e = 0;
+    size_t len = sizeof(p);
+    if (sysctlbyname("hw.perflevel0.logicalcpu", &p, &len, NULL, 0) != 0) p = 0;
+    len = sizeof(e);
+    if (sysctlbyname("hw.perflevel1.logicalcpu", &e, &len, NULL, 0) != 0) e = 0;
+    if (p > 0) {
+        *p_cores = p;
+        return p + e;
+    }
+#endif
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    *p_cores = n > 0 ? (int)n : 1;
+    return *p_cores;
+}
+
+// One step: k spinners for secs seconds. Returns 0, or -1 if a spinner
+// could not start.
+static int run_step(Spinner *sp, int k, double secs, double ns_per_tick, uint64_t *times,
+                    uint64_t *gaps) {
+    atomic_store(&g_stop, 0);
+    atomic_store(&g_ready, 0);
+    pthread_t tids[MAX_SPINNERS];
+    int started = 0, ringed = 0;    // threads running; rings allocated
+    for (; started < k; started++) {
+        Spinner *s = &sp[started];
+        s->n = 0;
+        s->overflow = 0;
+        s->cpu_start = s->cpu_end = -1;
+        if (poc_spsc_init(&s->ring, RING_WORDS) != 0) break;
+        ringed++;
+        if (pthread_create(&tids[started], NULL, spinner_main, s) != 0) break;
+    }
+    while (started == k && atomic_load(&g_ready) < k) usleep(100);
+
+    // The window opens once every spinner is placed and spinning.
+    uint64_t t0 = mach_absolute_time();
+    uint64_t t1 = t0 + (uint64_t)(secs * 1e9 / ns_per_tick);
+    while (started == k && mach_absolute_time() < t1) {
+        usleep(DRAIN_US);
+        drain(sp, k);
+    }
+    atomic_store(&g_stop, 1);
+    for (int i = 0; i < started; i++) pthread_join(tids[i], NULL);
+    if (started < k) {
+        for (int i = 0; i < ringed; i++) poc_spsc_free(&sp[i].ring);
+        return -1;
+    }
+    drain(sp, k);
+
+    int n = merge(sp, k, t0, t1, times, gaps);
+    uint64_t dropped = 0;
+    PocPlaceReport place;
+    poc_place_report_init(&place);
+    for (int i = 0; i < k; i++) {
+        dropped += poc_spsc_dropped(&sp[i].ring) / EVENT_WORDS + sp[i].overflow;
+        poc_place_note_cpu(&place, sp[i].cpu_start);
+        poc_place_note_cpu(&place, sp[i].cpu_end);
+        poc_spsc_free(&sp[i].ring);
+    }
+    char where[96];
+    poc_place_report_format(&place, where, sizeof(where));
+
+    double rate = n / secs;
+    Stats gap = n > 0 ? compute_stats(gaps, n) : (Stats){0};
+    Stats ivl = n > 1 ? compute_stats_delta_xorfold(times, n) : (Stats){0};
+    printf("%5d %9d %10.0f %10.0f %8llu %7.3f %7.3f %10.0f  %s\n", k, n, rate, rate / k,
+           (unsigned long long)dropped, gap.min_entropy, ivl.min_entropy,
+           gap.min_entropy * rate, where);
+    return 0;
+}
+
+static int per_core(int argc, char **argv) {
+    double secs = 5;
+    int limit = 0;
+    for (int i = 0; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-t") == 0) secs = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-c") == 0) limit = atoi(argv[i + 1]);
+    }
+    if (secs <= 0) secs = 5;
+
+    int p_cores;
+    int n = core_counts(&p_cores);
+    if (limit > 0 && limit < n) n = limit;
+    if (n > MAX_SPINNERS) n = MAX_SPINNERS;
+    if (p_cores > n) p_cores = n;
+
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    double ns_per_tick = (double)tb.numer / tb.denom;
+
+    printf("# Mach Thread Quantum Boundary Jitter — One Spinner per Core\n\n");
+    printf("%d cores (%d P, %d E), gap > %d ticks (%.0f ns), %.1f s per step\n\n", n,
+           p_cores, n - p_cores, PREEMPT_THRESHOLD, PREEMPT_THRESHOLD * ns_per_tick, secs);
+
+    Spinner *sp = aligned_alloc(_Alignof(Spinner), sizeof(Spinner) * (size_t)n);
+    uint64_t *times = malloc(sizeof(uint64_t) * (size_t)n * EVENTS_PER_CORE);
+    uint64_t *gaps = malloc(sizeof(uint64_t) * (size_t)n * EVENTS_PER_CORE);
+    if (!sp || !times || !gaps) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    memset(sp, 0, sizeof(Spinner) * (size_t)n);
+    for (int i = 0; i < n; i++) {
+        sp[i].core = i;
+        sp[i].p_cores = p_cores;
+        sp[i].times = malloc(sizeof(uint64_t) * EVENTS_PER_CORE);
+        sp[i].gaps = malloc(sizeof(uint32_t) * EVENTS_PER_CORE);
+        if (!sp[i].times || !sp[i].gaps) {
+            fprintf(stderr, "allocation failed\n");
+            return 1;
+        }
+    }
+
+    // gap H∞: XOR-folded gap lengths; ivl H∞: XOR-folded intervals between
+    // consecutive events of the merged stream; b/s = gap H∞ × events/s.
+    printf("%5s %9s %10s %10s %8s %7s %7s %10s  %s\n", "cores", "events", "events/s",
+           "per core", "dropped", "gap H∞", "ivl H∞", "b/s", "placement");
+    int rc = 0;
+    for (int k = 1;; k = k * 2 < n ? k * 2 : n) {
+        if (run_step(sp, k, secs, ns_per_tick, times, gaps) != 0) {
+            fprintf(stderr, "%d spinners: thread start failed\n", k);
+            rc = 1;
+            break;
+        }
+        if (k == n) break;
+    }
+
+    for (int i = 0; i < n; i++) {
+        free(sp[i].times);
+        free(sp[i].gaps);
+    }
+    free(sp);
+    free(times);
+    free(gaps);
+    return rc;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--cores") == 0) return per_core(argc - 2, argv + 2);
+    return single_spinner();
+}
@@ -8,7 +8,9 @@
 // This is genuinely novel: nobody has used a computer's own thermal sensors
 // as a turbulence detector for entropy generation.
 //
-// Build: cc -O2 -o unprecedented_thermal_convection unprecedented_thermal_convection.c -framework IOKit -framework CoreFoundation
+// Build: make unprecedented_thermal_convection
+// SMC access goes through lib/poc_smc.h: key info is cached, so each
+// sensor read is one READ_BYTES and a sensor pair is read per tick.
 // Note: Requires root (sudo) for direct SMC access.
 
 #include <stdio.h>
@@ -17,96 +19,11 @@
 #include <string.h>
 #include <math.h>
 #include <mach/mach_time.h>
-#include <IOKit/IOKitLib.h>
-#include <CoreFoundation/CoreFoundation.h>
 
-#define N_SAMPLES 12000
-#define SMC_CMD_READ_KEYINFO 9
-#define SMC_CMD_READ_BYTES   5
-
-// SMC data types
-typedef struct {
-    char key[5];
-    uint32_t data_size;
-    uint32_t data_type;
-    uint8_t  data_attributes;
-} SMCKeyInfoData;
-
-typedef struct {
-    uint32_t key;
-    SMCKeyInfoData key_info;
-    uint8_t  result;
-    uint8_t  status;
-    uint8_t  data8;
-    uint32_t data32;
-    uint8_t  bytes[32];
-} SMCParamStruct;
-
-#pragma pack(push, 1)
-typedef struct {
-    uint32_t data_type;
-    uint32_t data_size;
-    uint8_t  cmd;
-    uint32_t key;
-    uint8_t  padding[24];
-    uint8_t  bytes[32];
-} SMCData;
-#pragma pack(pop)
-
-static io_connect_t smc_conn = 0;
-
-static uint32_t str_to_key(const char *s) {
-    return ((uint32_t)s[0] << 24) | ((uint32_t)s[1] << 16) |
-           ((uint32_t)s[2] << 8)  | (uint32_t)s[3];
-}
-
-static int smc_open(void) {
-    io_service_t service = IOServiceGetMatchingService(
-        kIOMainPortDefault,
-        IOServiceMatching("AppleSMC"));
-    if (!service) {
-        fprintf(stderr, "Failed to find AppleSMC service\n");
-        return -1;
-    }
-    kern_return_t kr = IOServiceOpen(service, mach_task_self(), 0, &smc_conn);
-    IOObjectRelease(service);
-    if (kr != KERN_SUCCESS) {
-        fprintf(stderr, "Failed to open SMC (need sudo?): 0x%x\n", kr);
-        return -1;
-    }
-    return 0;
-}
-
-static void smc_close(void) {
-    if (smc_conn) IOServiceClose(smc_conn);
-}
-
-static int smc_read_key(const char *key_str, uint8_t *out, uint32_t *out_size) {
-    SMCParamStruct in = {0}, out_s = {0};
-    size_t out_size_s = sizeof(SMCParamStruct);
-
-    // Get key info first
-    in.key = str_to_key(key_str);
-    in.data8 = SMC_CMD_READ_KEYINFO;
-    kern_return_t kr = IOConnectCallStructMethod(
-        smc_conn, 2, &in, sizeof(SMCParamStruct), &out_s, &out_size_s);
-    if (kr != KERN_SUCCESS) return -1;
-
-    // Now read the key
-    memset(&in, 0, sizeof(in));
-    in.key = str_to_key(key_str);
-    in.key_info.data_size = out_s.key_info.data_size;
-    in.data8 = SMC_CMD_READ_BYTES;
-    out_size_s = sizeof(SMCParamStruct);
-    kr = IOConnectCallStructMethod(
-        smc_conn, 2, &in, sizeof(SMCParamStruct), &out_s, &out_size_s);
-    if (kr != KERN_SUCCESS) return -1;
-
-    *out_size = out_s.key_info.data_size;
-    memcpy(out, out_s.bytes, out_s.key_info.data_size);
-    return 0;
-}
+#include "lib/poc_smc.h"
+#include "lib/poc_stats.h"
 
+#define N_SAMPLES 12000
 // Convert SMC flt/fpe2/sp78 types to float
 static float smc_bytes_to_float(const uint8_t *bytes, uint32_t size) {
     if (size == 4) {
@@ -122,29 +39,10 @@ static float smc_bytes_to_float(const uint8_t *bytes, uint32_t size) {
     return 0.0f;
 }
 
-static void analyze_entropy(const char *label, const uint8_t *data, int n) {
-    int hist[256] = {0};
-    for (int i = 0; i < n; i++) hist[data[i]]++;
-
-    double shannon = 0.0;
-    int max_count = 0, unique = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            unique++;
-            if (hist[i] > max_count) max_count = hist[i];
-            double p = (double)hist[i] / n;
-            shannon -= p * log2(p);
-        }
-    }
-    double min_entropy = -log2((double)max_count / n);
-    printf("  %s: Shannon=%.3f  H∞=%.3f  unique=%d/256  n=%d\n",
-           label, shannon, min_entropy, unique, n);
-}
-
 int main(void) {
     printf("# Thermal Convection Turbulence Sensor — SMC Temperature Differential\n\n");
 
-    if (smc_open() != 0) {
+    if (poc_smc_open() != 0) {
         printf("FAIL: Cannot open SMC (requires sudo)\n");
         return 1;
     }
@@ -167,27 +65,26 @@ int main(void) {
     int n_keys = sizeof(sensor_keys) / sizeof(sensor_keys[0]);
 
     printf("Scanning available temperature sensors...\n");
+    PocSmcKey sensors[12];
     float sensor_vals[12] = {0};
     int available[12] = {0};
     int n_available = 0;
 
     for (int i = 0; i < n_keys; i++) {
-        uint8_t bytes[32] = {0};
-        uint32_t size = 0;
-        if (smc_read_key(sensor_keys[i], bytes, &size) == 0) {
-            float val = smc_bytes_to_float(bytes, size);
+        if (poc_smc_key_init(&sensors[i], sensor_keys[i]) == 0 && poc_smc_read(&sensors[i]) == 0) {
+            float val = smc_bytes_to_float(sensors[i].bytes, sensors[i].data_size);
             if (val > 0.0f && val < 150.0f) {
                 sensor_vals[i] = val;
                 available[i] = 1;
                 n_available++;
-                printf("  %s: %.2f°C (size=%u)\n", sensor_keys[i], val, size);
+                printf("  %s: %.2f°C (size=%u)\n", sensor_keys[i], val, sensors[i].data_size);
             }
         }
     }
 
     if (n_available < 2) {
         printf("\nFAIL: Need at least 2 temperature sensors, found %d\n", n_available);
-        smc_close();
+        poc_smc_close();
         return 1;
     }
 
@@ -208,6 +105,8 @@ int main(void) {
     }
     printf("\nUsing sensors: %s (%.2f°C) and %s (%.2f°C), delta=%.2f°C\n",
            sensor_keys[s1], sensor_vals[s1], sensor_keys[s2], sensor_vals[s2], max_diff);
+    PocSmcKey pair[2] = {sensors[s1], sensors[s2]};
+    const uint8_t *b1 = pair[0].bytes, *b2 = pair[1].bytes;
 
     // === Test 1: Temperature differential LSBs ===
     printf("\n--- Test 1: Temperature Differential LSBs ---\n");
@@ -215,10 +114,7 @@ int main(void) {
     int diff_count = 0;
 
     for (int i = 0; i < N_SAMPLES + 1000; i++) {
-        uint8_t b1[32] = {0}, b2[32] = {0};
-        uint32_t s1_size = 0, s2_size = 0;
-        if (smc_read_key(sensor_keys[s1], b1, &s1_size) != 0) continue;
-        if (smc_read_key(sensor_keys[s2], b2, &s2_size) != 0) continue;
+        if (poc_smc_read_all(pair, 2) != 2) continue;
 
         // XOR raw bytes from both sensors
         uint8_t xored = b1[0] ^ b2[0] ^ b1[1] ^ b2[1];
@@ -233,10 +129,8 @@ int main(void) {
     uint8_t *timing_lsbs = malloc(N_SAMPLES);
 
     for (int i = 0; i < N_SAMPLES; i++) {
-        uint8_t bytes[32] = {0};
-        uint32_t size = 0;
         uint64_t t0 = mach_absolute_time();
-        smc_read_key(sensor_keys[s1], bytes, &size);
+        poc_smc_read(&pair[0]);
         uint64_t t1 = mach_absolute_time();
         timings[i] = t1 - t0;
         timing_lsbs[i] = (uint8_t)(timings[i] & 0xFF);
@@ -248,12 +142,10 @@ int main(void) {
     uint8_t *dual_timing = malloc(N_SAMPLES);
 
     for (int i = 0; i < N_SAMPLES; i++) {
-        uint8_t b1[32] = {0}, b2[32] = {0};
-        uint32_t sz1 = 0, sz2 = 0;
         uint64_t t0 = mach_absolute_time();
-        smc_read_key(sensor_keys[s1], b1, &sz1);
+        poc_smc_read(&pair[0]);
         uint64_t t1 = mach_absolute_time();
-        smc_read_key(sensor_keys[s2], b2, &sz2);
+        poc_smc_read(&pair[1]);
         uint64_t t2 = mach_absolute_time();
 
         // XOR the two timing deltas — captures differential jitter
@@ -271,10 +163,7 @@ int main(void) {
     int dod_count = 0;
 
     for (int i = 0; i < N_SAMPLES + 100; i++) {
-        uint8_t b1[32] = {0}, b2[32] = {0};
-        uint32_t sz1 = 0, sz2 = 0;
-        smc_read_key(sensor_keys[s1], b1, &sz1);
-        smc_read_key(sensor_keys[s2], b2, &sz2);
+        poc_smc_read_all(pair, 2);
 
         uint64_t t_read = mach_absolute_time();
         // Combine raw sensor bytes with timing
@@ -301,7 +190,7 @@ int main(void) {
     free(timing_lsbs);
     free(dual_timing);
     free(dod);
-    smc_close();
+    poc_smc_close();
 
     printf("\nDone.\n");
     return 0;
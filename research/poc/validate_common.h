@@ -0,0 +1,110 @@
+// validate_common.h — Shared scaffolding for the validate_*.c PoCs
+//
+// Pulls in the system headers every validation program relies on, the
+// standard test sizes, the LCG used to randomize collector parameters,
+// and the shared statistics library (lib/poc_stats.h, lib/poc_estimators.h).
+//
+// Build: make <program> (links lib/libpoc.a; see Makefile)
+
+#ifndef VALIDATE_COMMON_H
+#define VALIDATE_COMMON_H
+
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+#include "lib/poc_capture.h"
+#include "lib/poc_estimators.h"
+#include "lib/poc_platform.h"
+#include "lib/poc_seqtrial.h"
+#include "lib/poc_stats.h"
+#include "lib/poc_stream.h"
+#include "lib/poc_xcorr.h"
+
+#ifndef LARGE_N
+#define LARGE_N 100000
+#endif
+#ifndef TRIAL_N
+#define TRIAL_N 10000
+#endif
+#ifndef N_TRIALS
+#define N_TRIALS 10
+#endif
+
+// Collector chunk used by soak mode; the only sample storage it needs.
+#define SOAK_CHUNK 65536
+#define SOAK_MAX_LAG 10
+
+// Collector signature: fill timings[0..n), return the number of valid samples.
+typedef int (*collect_func_t)(uint64_t *timings, int n);
+
+// 64-bit LCG (Knuth MMIX constants) — cheap parameter randomization only.
+static inline uint64_t lcg_next(uint64_t *state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return *state >> 33;
+}
+
+static inline void print_validation_header(const char *source) {
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    printf("# %s — Critical Validation\n", source);
+    printf("# Timebase: %u/%u (%.2f ns/tick)\n\n", tb.numer, tb.denom,
+           (double)tb.numer / tb.denom);
+}
+
+// Test 4 companion to pearson(): strongest correlation over lags ±XCORR_MAX_LAG,
+// catching coupling that is offset in time rather than simultaneous.
+#define XCORR_MAX_LAG 256
+static inline void print_lagged_xcorr(const uint64_t *a, const uint64_t *b, int n) {
+    static double xc[2 * XCORR_MAX_LAG + 1];
+    if (poc_xcorr(a, b, n, XCORR_MAX_LAG, xc) != 0) return;
+    PocLagPeak pk = poc_xcorr_peak(xc, XCORR_MAX_LAG);
+    printf("     %-25s  peak over lags ±%d: lag %+d r=%.4f%s\n", "", XCORR_MAX_LAG,
+           pk.lag, pk.r, fabs(pk.r) > 0.1 ? " * lagged coupling *" : "");
+}
+
+// Soak mode: POC_SOAK_N=<samples> streams that many samples through the
+// collector in SOAK_CHUNK pieces, folding them into a PocStream instead
+// of running Tests 1-4. Memory stays constant regardless of sample count.
+// Returns 1 when soak mode ran (caller should exit), 0 otherwise.
+static inline int run_soak_if_requested(const char *source, collect_func_t collect) {
+    const char *env = getenv("POC_SOAK_N");
+    if (!env || !*env) return 0;
+    uint64_t total = strtoull(env, NULL, 10);
+    if (total == 0) return 0;
+
+    static uint64_t chunk[SOAK_CHUNK];
+    static PocStream st;
+    poc_stream_init(&st, SOAK_MAX_LAG);
+
+    printf("=== Soak: %s, %llu samples (streaming, %d-sample chunks) ===\n",
+           source, (unsigned long long)total, SOAK_CHUNK);
+    uint64_t t0 = mach_absolute_time();
+    uint64_t got = poc_stream_collect(&st, collect, total, chunk, SOAK_CHUNK);
+    uint64_t t1 = mach_absolute_time();
+
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    double secs = (double)(t1 - t0) * tb.numer / tb.denom / 1e9;
+    Stats s = poc_stream_stats(&st);
+    printf("  Samples: %llu  Elapsed=%.1fs  Rate=%.0f/s\n",
+           (unsigned long long)got, secs, secs > 0 ? got / secs : 0.0);
+    printf("  Mean=%.1f  StdDev=%.1f\n", s.mean, s.stddev);
+    printf("  Shannon=%.3f  H_inf=%.3f\n", s.shannon, s.min_entropy);
+    for (int lag = 1; lag <= SOAK_MAX_LAG; lag++)
+        printf("  lag-%d: %.4f\n", lag, poc_stream_autocorrelation(&st, lag));
+    printf("\n");
+    return 1;
+}
+
+#endif // VALIDATE_COMMON_H
@@ -1,161 +1,91 @@
 // validate_compression_timing.c — Entropy source validation
 // Mechanism: Compress varying-size data (128-512 bytes, mixed patterns) with zlib
 // Cross-correlate: hash_timing, amx_timing
-// Compile: cc -O2 -o validate_compression_timing validate_compression_timing.c -lz -lm
+// Compile: make validate_compression_timing
+// Collector: collectors/compression_timing.c
+//
+//   ./validate_compression_timing            compress2() per sample
+//   ./validate_compression_timing --zstream  one z_stream, deflateReset() per sample
+//   ./validate_compression_timing --lzfse    compression_encode_buffer(), LZFSE
+//   ./validate_compression_timing --compare  all modes on identical inputs
+//
+// --compare splits the compress2() jitter: the reused z_stream runs the
+// same deflate over the same inputs without the per-call state allocation,
+// so var(compress2) - var(z_stream) is the allocator's share and the
+// paired difference compress2[i] - z_stream[i] is the allocation stream.
 
 #include "validate_common.h"
-#include <zlib.h>
-
-static int collect_compression_timing(uint64_t *timings, int n) {
-    uint64_t lcg = mach_absolute_time();
-    uint8_t src[512];
-    uint8_t dst[1024];
-    int valid = 0;
+#include "collectors/collectors.h"
+
+#define COMPARE_N 20000
+
+static int compare(void) {
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    double ns_per_tick = (double)tb.numer / tb.denom;
+    uint64_t seed = mach_absolute_time();
+    static const PocCompressMode modes[] = {POC_COMPRESS2, POC_COMPRESS_ZSTREAM,
+                                            POC_COMPRESS_LZFSE, POC_COMPRESS_LZ4};
+    enum { N_MODES = sizeof(modes) / sizeof(modes[0]) };
+
+    uint64_t *t[N_MODES];
+    int got[N_MODES];
+    for (int m = 0; m < N_MODES; m++) {
+        t[m] = malloc(COMPARE_N * sizeof(uint64_t));
+        if (!t[m]) return 1;
+    }
 
-    for (int i = 0; i < n; i++) {
-        // Vary size between 128 and 512
-        int sz = 128 + (int)(lcg_next(&lcg) % 385);
-        // Fill with mix of random and repeating patterns
-        for (int j = 0; j < sz; j++) {
-            if (j % 3 == 0)
-                src[j] = (uint8_t)(lcg_next(&lcg) & 0xFF);
-            else
-                src[j] = (uint8_t)(j & 0xFF);
+    printf("# Compression Timing — Codec vs Allocation Jitter\n");
+    printf("# %d samples per mode, identical inputs (seed %llu)\n\n", COMPARE_N,
+           (unsigned long long)seed);
+    printf("  %-15s %10s %9s %9s %7s %7s\n", "mode", "samples/s", "mean ns", "sd ns", "H∞", "H∞Δ");
+    for (int m = 0; m < N_MODES; m++) {
+        got[m] = poc_compress_run(modes[m], seed, t[m], COMPARE_N);
+        if (got[m] < 2) {
+            printf("  %-15s unavailable\n", poc_compress_mode_name(modes[m]));
+            continue;
         }
-
-        uLongf dst_len = sizeof(dst);
-        uint64_t t0 = mach_absolute_time();
-        compress2(dst, &dst_len, src, (uLong)sz, Z_DEFAULT_COMPRESSION);
-        uint64_t t1 = mach_absolute_time();
-        timings[valid++] = t1 - t0;
+        Stats s = compute_stats(t[m], got[m]);
+        Stats d = compute_stats_delta_xorfold(t[m], got[m]);
+        printf("  %-15s %10.0f %9.0f %9.0f %7.3f %7.3f\n", poc_compress_mode_name(modes[m]),
+               1e9 / (s.mean * ns_per_tick), s.mean * ns_per_tick,
+               s.stddev * ns_per_tick, s.min_entropy, d.min_entropy);
     }
-    return valid;
-}
-
-// Cross-correlation: hash_timing (SHA-256 on varying data)
-static int collect_hash_timing_cross(uint64_t *timings, int n) {
-    uint64_t lcg = mach_absolute_time();
-    uint8_t buf[512];
-    uint8_t hash[32];
-
-    for (int i = 0; i < n; i++) {
-        int sz = 32 + (int)(lcg_next(&lcg) % 481);
-        for (int j = 0; j < sz; j++)
-            buf[j] = (uint8_t)(lcg_next(&lcg) & 0xFF);
-
-        // Simple iterative hash stand-in: XOR-fold repeatedly
-        uint64_t t0 = mach_absolute_time();
-        memset(hash, 0, 32);
-        for (int j = 0; j < sz; j++)
-            hash[j % 32] ^= buf[j];
-        for (int r = 0; r < 100; r++)
-            for (int j = 0; j < 32; j++)
-                hash[j] = (hash[j] * 131 + 1) & 0xFF;
-        uint64_t t1 = mach_absolute_time();
-        timings[i] = t1 - t0;
+    release_compression();
+
+    if (got[0] == COMPARE_N && got[1] == COMPARE_N) {
+        Stats c2 = compute_stats(t[0], COMPARE_N);
+        Stats zs = compute_stats(t[1], COMPARE_N);
+        // Paired difference, offset so it stays unsigned for the stats code
+        int64_t min_d = 0;
+        for (int i = 0; i < COMPARE_N; i++) {
+            int64_t dd = (int64_t)t[0][i] - (int64_t)t[1][i];
+            if (dd < min_d) min_d = dd;
+        }
+        uint64_t *alloc = malloc(COMPARE_N * sizeof(uint64_t));
+        if (alloc) {
+            for (int i = 0; i < COMPARE_N; i++)
+                alloc[i] = (uint64_t)((int64_t)t[0][i] - (int64_t)t[1][i] - min_d);
+            Stats a = compute_stats(alloc, COMPARE_N);
+            printf("\n  Allocation stream (compress2 − z_stream, paired):\n");
+            printf("    mean %.0f ns  sd %.0f ns  H∞=%.3f\n", (a.mean + min_d) * ns_per_tick,
+                   a.stddev * ns_per_tick, a.min_entropy);
+            free(alloc);
+        }
+        double share = c2.stddev > 0 ? 1.0 - (zs.stddev * zs.stddev) / (c2.stddev * c2.stddev) : 0;
+        printf("    allocator share of compress2 variance: %.1f%%\n", 100.0 * share);
+        printf("    Pearson(compress2, z_stream) on identical inputs: %.4f\n",
+               pearson(t[0], t[1], COMPARE_N));
     }
-    return n;
-}
 
-// Cross-correlation: amx_timing (CPU workload timing)
-static int collect_amx_timing_cross(uint64_t *timings, int n) {
-    volatile double acc = 0.0;
-    for (int i = 0; i < n; i++) {
-        uint64_t t0 = mach_absolute_time();
-        for (int j = 0; j < 200; j++)
-            acc += (double)j * 1.00001;
-        uint64_t t1 = mach_absolute_time();
-        timings[i] = t1 - t0;
-    }
-    (void)acc;
-    return n;
+    for (int m = 0; m < N_MODES; m++) free(t[m]);
+    return 0;
 }
 
-int main(void) {
-    print_validation_header("compression_timing");
-
-    // === Test 1: Large sample entropy ===
-    printf("=== Test 1: %dK Sample Entropy ===\n", LARGE_N / 1000);
-    uint64_t *timings = malloc(LARGE_N * sizeof(uint64_t));
-    int valid = collect_compression_timing(timings, LARGE_N);
-    Stats s = compute_stats(timings, valid);
-    printf("  Samples: %d  Mean=%.1f  StdDev=%.1f\n", valid, s.mean, s.stddev);
-    printf("  Shannon=%.3f  H_inf=%.3f\n\n", s.shannon, s.min_entropy);
-
-    // === Test 2: Autocorrelation ===
-    printf("=== Test 2: Autocorrelation (lag 1-5) ===\n");
-    double max_ac = 0;
-    for (int lag = 1; lag <= 5; lag++) {
-        double ac = autocorrelation(timings, valid, lag);
-        printf("  lag-%d: %.4f%s\n", lag, ac,
-               fabs(ac) > 0.5 ? " *** HIGH ***" : fabs(ac) > 0.1 ? " * warn *" : "");
-        if (fabs(ac) > max_ac) max_ac = fabs(ac);
-    }
-    printf("\n");
-    free(timings);
-
-    // === Test 3: Stability (10 trials) ===
-    printf("=== Test 3: Stability (%d trials x %d samples) ===\n", N_TRIALS, TRIAL_N);
-    double min_ents[N_TRIALS];
-    uint64_t *trial_buf = malloc(TRIAL_N * sizeof(uint64_t));
-    for (int t = 0; t < N_TRIALS; t++) {
-        int tv = collect_compression_timing(trial_buf, TRIAL_N);
-        Stats ts = compute_stats(trial_buf, tv);
-        min_ents[t] = ts.min_entropy;
-        printf("  Trial %2d: H_inf=%.3f  Shannon=%.3f  N=%d\n",
-               t + 1, ts.min_entropy, ts.shannon, tv);
-    }
-    free(trial_buf);
-
-    double me_mean = 0, me_var = 0;
-    for (int i = 0; i < N_TRIALS; i++) me_mean += min_ents[i];
-    me_mean /= N_TRIALS;
-    for (int i = 0; i < N_TRIALS; i++) {
-        double d = min_ents[i] - me_mean;
-        me_var += d * d;
-    }
-    double me_std = sqrt(me_var / N_TRIALS);
-    printf("\n  H_inf Mean=%.3f  StdDev=%.3f\n", me_mean, me_std);
-    printf("  Verdict: %s\n\n",
-           me_std > 2.0 ? "UNSTABLE (std > 2.0)" :
-           me_std > 1.0 ? "MARGINAL (std > 1.0)" : "STABLE");
-
-    // === Test 4: Cross-correlation ===
-    printf("=== Test 4: Cross-correlation ===\n");
-    int cc_n = 5000;
-    uint64_t *my_t = malloc(cc_n * sizeof(uint64_t));
-    int my_v = collect_compression_timing(my_t, cc_n);
-    if (my_v < cc_n) cc_n = my_v;
-
-    const char *cross_names[] = {"hash_timing", "amx_timing"};
-    collect_func_t cross_funcs[] = {collect_hash_timing_cross, collect_amx_timing_cross};
-    for (int c = 0; c < 2; c++) {
-        uint64_t *other_t = malloc(cc_n * sizeof(uint64_t));
-        int other_v = cross_funcs[c](other_t, cc_n);
-        int use_n = cc_n < other_v ? cc_n : other_v;
-        double r = pearson(my_t, other_t, use_n);
-        printf("  vs %-25s: r=%.4f%s\n", cross_names[c], r,
-               fabs(r) > 0.3 ? " *** REDUNDANT ***" :
-               fabs(r) > 0.1 ? " * weak *" : "");
-        free(other_t);
-    }
-    free(my_t);
-    printf("\n");
-
-    // === Summary ===
-    printf("=== SUMMARY ===\n");
-    printf("  H_inf (100K): %.3f\n", s.min_entropy);
-    printf("  H_inf Mean (10 trials): %.3f\n", me_mean);
-    printf("  H_inf StdDev: %.3f\n", me_std);
-    printf("  Max autocorr: %.4f\n", max_ac);
-    if (s.min_entropy < 0.5)
-        printf("  VERDICT: CUT (H_inf < 0.5)\n");
-    else if (me_std > 2.0)
-        printf("  VERDICT: CUT (unstable, std > 2.0)\n");
-    else if (s.min_entropy < 1.5 || max_ac > 0.5)
-        printf("  VERDICT: DEMOTE (weak)\n");
-    else
-        printf("  VERDICT: KEEP\n");
-    printf("\n");
-    return 0;
+int main(int argc, char **argv) {
+    const char *name = "compression_timing";
+    if (argc > 1 && strcmp(argv[1], "--compare") == 0) return compare();
+    if (argc > 1 && strcmp(argv[1], "--zstream") == 0) name = "compression_zstream";
+    else if (argc > 1 && strcmp(argv[1], "--lzfse") == 0) name = "compression_lzfse";
+    return poc_validate(poc_collector_find(name));
 }
@@ -0,0 +1,50 @@
+// validate_coreml_ane.c — Neural Engine inference timing entropy validation
+// Mechanism: tiny Core ML model on MLComputeUnitsCPUAndNeuralEngine, async
+// predictions pipelined, interval between consecutive completions
+// Cross-correlate: amx_timing, sme_fmopa
+// Compile: make validate_coreml_ane
+// Collector: collectors/coreml_ane.m
+//
+//   ./validate_coreml_ane               standard harness, 4 predictions in flight
+//   ./validate_coreml_ane --sweep       predictions/s and H∞ for 1..16 in flight
+//
+// POC_COREML_MODEL=path/to/model.mlmodelc runs a precompiled model instead of
+// the built-in inner product. Without Core ML the collector measures cblas_sgemm.
+
+#include "validate_common.h"
+#include "collectors/collectors.h"
+
+#define SWEEP_N 4000
+
+static int sweep(void) {
+    if (!poc_coreml_available()) {
+        printf("  Core ML model unavailable\n");
+        return 1;
+    }
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    double ns_per_tick = (double)tb.numer / tb.denom;
+
+    printf("# Core ML Neural Engine — predictions in flight\n\n");
+    printf("  inflight  predictions/s  mean interval µs   H∞\n");
+    uint64_t *t = malloc(SWEEP_N * sizeof(uint64_t));
+    for (int k = 1; k <= POC_COREML_MAX_INFLIGHT; k *= 2) {
+        uint64_t elapsed = 0;
+        int n = poc_coreml_run(k, t, SWEEP_N, &elapsed);
+        if (n < POC_MIN_VALID || elapsed == 0) {
+            printf("  %8d  prediction failed\n", k);
+            continue;
+        }
+        Stats s = compute_stats(t, n);
+        printf("  %8d  %13.0f  %16.1f  %.3f\n", k, n / (elapsed * ns_per_tick / 1e9),
+               s.mean * ns_per_tick / 1e3, s.min_entropy);
+    }
+    free(t);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--sweep") == 0) return sweep();
+    if (!poc_coreml_available()) printf("# Core ML model unavailable — falling back to cblas_sgemm\n");
+    return poc_validate(poc_collector_find("coreml_ane"));
+}
@@ -14,116 +14,22 @@
 #include <mach/mach_time.h>
 #include <sys/mman.h>
 
+#include "lib/poc_arena.h"
+#include "lib/poc_stats.h"
+#include "lib/poc_xcorr.h"
+
+#define POC_TS_SOURCE POC_TS_CNTVCT_ISB
+#include "lib/poc_time.h"
+
 #define LARGE_N 100000
 #define TRIAL_N 10000
 #define N_TRIALS 10
 #define ARRAY_SIZE (16 * 1024 * 1024)
 
-static inline uint64_t read_counter(void) {
-    uint64_t val;
-    __asm__ volatile("isb\nmrs %0, CNTVCT_EL0" : "=r"(val));
-    return val;
-}
-
 static inline void memory_barrier(void) {
     __asm__ volatile("dmb sy" ::: "memory");
 }
 
-typedef struct {
-    double shannon;
-    double min_entropy;
-    double mean;
-    double stddev;
-} Stats;
-
-static Stats compute_stats(uint64_t *timings, int n) {
-    Stats s = {0};
-    // XOR-fold each timing to a byte
-    int hist[256] = {0};
-    uint64_t sum = 0;
-    for (int i = 0; i < n; i++) {
-        uint8_t f = 0;
-        for (int b = 0; b < 8; b++) f ^= (timings[i] >> (b*8)) & 0xFF;
-        hist[f]++;
-        sum += timings[i];
-    }
-    s.mean = (double)sum / n;
-    double var = 0;
-    for (int i = 0; i < n; i++) {
-        double d = timings[i] - s.mean;
-        var += d * d;
-    }
-    s.stddev = sqrt(var / n);
-
-    int mx = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            double p = (double)hist[i] / n;
-            s.shannon -= p * log2(p);
-        }
-        if (hist[i] > mx) mx = hist[i];
-    }
-    s.min_entropy = -log2((double)mx / n);
-    return s;
-}
-
-static Stats compute_stats_delta_xorfold(uint64_t *timings, int n) {
-    Stats s = {0};
-    int nd = n - 1;
-    int hist[256] = {0};
-    for (int i = 0; i < nd; i++) {
-        int64_t d = (int64_t)timings[i+1] - (int64_t)timings[i];
-        uint8_t f = 0;
-        for (int b = 0; b < 8; b++) f ^= (((uint64_t)d) >> (b*8)) & 0xFF;
-        hist[f]++;
-    }
-    int mx = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            double p = (double)hist[i] / nd;
-            s.shannon -= p * log2(p);
-        }
-        if (hist[i] > mx) mx = hist[i];
-    }
-    s.min_entropy = -log2((double)mx / nd);
-    return s;
-}
-
-// Autocorrelation at a given lag
-static double autocorrelation(uint64_t *timings, int n, int lag) {
-    if (n <= lag) return 0;
-    double mean = 0;
-    for (int i = 0; i < n; i++) mean += timings[i];
-    mean /= n;
-
-    double num = 0, den = 0;
-    for (int i = 0; i < n - lag; i++) {
-        num += (timings[i] - mean) * (timings[i + lag] - mean);
-    }
-    for (int i = 0; i < n; i++) {
-        den += (timings[i] - mean) * (timings[i] - mean);
-    }
-    if (den < 1e-15) return 0;
-    return num / den;
-}
-
-// Pearson correlation between two equal-length series
-static double pearson(uint64_t *a, uint64_t *b, int n) {
-    double ma = 0, mb = 0;
-    for (int i = 0; i < n; i++) { ma += a[i]; mb += b[i]; }
-    ma /= n; mb /= n;
-
-    double num = 0, da = 0, db = 0;
-    for (int i = 0; i < n; i++) {
-        double x = a[i] - ma, y = b[i] - mb;
-        num += x * y;
-        da += x * x;
-        db += y * y;
-    }
-    if (da < 1e-15 || db < 1e-15) return 0;
-    return num / sqrt(da * db);
-}
-
 static void collect_dmp_confusion(uint64_t *array, size_t n_elements, uint64_t base,
                                    uint64_t *timings, int n, uint64_t *lcg_state) {
     uint64_t lcg = *lcg_state;
@@ -134,7 +40,7 @@ static void collect_dmp_confusion(uint64_t *array, size_t n_elements, uint64_t b
         size_t idx = (lcg >> 16) % (n_elements - 256);
 
         memory_barrier();
-        uint64_t t0 = read_counter();
+        uint64_t t0 = poc_ts();
 
         // Triple-hop pointer chase with reversal
         uint64_t val = array[idx];
@@ -149,7 +55,7 @@ static void collect_dmp_confusion(uint64_t *array, size_t n_elements, uint64_t b
         }
 
         memory_barrier();
-        uint64_t t1 = read_counter();
+        uint64_t t1 = poc_ts();
         timings[i] = t1 - t0;
     }
     *lcg_state = lcg;
@@ -169,11 +75,11 @@ static void collect_plain_cache_miss(uint64_t *array, size_t n_elements,
         size_t idx2 = (lcg >> 16) % n_elements;
 
         memory_barrier();
-        uint64_t t0 = read_counter();
+        uint64_t t0 = poc_ts();
         sink += array[idx1];
         sink += array[idx2];
         memory_barrier();
-        uint64_t t1 = read_counter();
+        uint64_t t1 = poc_ts();
         timings[i] = t1 - t0;
     }
     *lcg_state = lcg;
@@ -189,7 +95,7 @@ static void collect_sequential(uint64_t *array, size_t n_elements, uint64_t base
         size_t idx = ((size_t)i * 64) % (n_elements - 4);
 
         memory_barrier();
-        uint64_t t0 = read_counter();
+        uint64_t t0 = poc_ts();
 
         // Sequential chase — DMP should predict correctly
         uint64_t val = array[idx];
@@ -198,7 +104,7 @@ static void collect_sequential(uint64_t *array, size_t n_elements, uint64_t base
         sink += array[(idx + 1) % n_elements];
 
         memory_barrier();
-        uint64_t t1 = read_counter();
+        uint64_t t1 = poc_ts();
         timings[i] = t1 - t0;
     }
     (void)sink;
@@ -211,24 +117,28 @@ int main(void) {
     mach_timebase_info(&tb);
 
     // Allocate pointer-filled array
-    uint64_t *array = mmap(NULL, ARRAY_SIZE, PROT_READ | PROT_WRITE,
-                           MAP_PRIVATE | MAP_ANON, -1, 0);
-    if (array == MAP_FAILED) { perror("mmap"); return 1; }
-
-    uint64_t base = (uint64_t)array;
-    size_t n_elements = ARRAY_SIZE / sizeof(uint64_t);
     uint64_t lcg = mach_absolute_time() | 1;
-
-    for (size_t i = 0; i < n_elements; i++) {
-        lcg = lcg * 6364136223846793005ULL + 1;
-        size_t offset = (lcg >> 16) % n_elements;
-        array[i] = base + offset * sizeof(uint64_t);
+    PocArena arena;
+    if (poc_arena_init(&arena, ARRAY_SIZE, lcg) != 0) { perror("mmap"); return 1; }
+    printf("  Arena: %zu MB%s\n\n", arena.bytes >> 20, arena.superpages ? ", 2MB pages" : "");
+
+    // Every test's sample buffers, pre-faulted and locked before Test 1
+    PocSampleArena samples;
+    if (poc_samples_init(&samples, (LARGE_N + TRIAL_N) * sizeof(uint64_t) + 128) != 0) {
+        perror("mmap");
+        return 1;
     }
+    uint64_t *big = POC_SAMPLES_U64(&samples, LARGE_N);
+    uint64_t *aux = POC_SAMPLES_U64(&samples, TRIAL_N);
+
+    uint64_t *array = arena.words;
+    uint64_t base = arena.base;
+    size_t n_elements = arena.n;
 
     // === TEST 1: 100K sample entropy ===
     printf("=== Test 1: 100K Sample Entropy ===\n");
     {
-        uint64_t *timings = malloc(LARGE_N * sizeof(uint64_t));
+        uint64_t *timings = big;
         collect_dmp_confusion(array, n_elements, base, timings, LARGE_N, &lcg);
 
         Stats raw = compute_stats(timings, LARGE_N);
@@ -237,22 +147,25 @@ int main(void) {
         printf("  XOR-fold:       Shannon=%.3f  H∞=%.3f\n", raw.shannon, raw.min_entropy);
         printf("  Delta XOR-fold: Shannon=%.3f  H∞=%.3f\n", delta.shannon, delta.min_entropy);
         printf("  Mean=%.1f ticks  StdDev=%.1f\n\n", raw.mean, raw.stddev);
-        free(timings);
     }
 
     // === TEST 2: Autocorrelation ===
     printf("=== Test 2: Autocorrelation (lag 1-10) ===\n");
     {
-        uint64_t *timings = malloc(LARGE_N * sizeof(uint64_t));
+        uint64_t *timings = big;
         collect_dmp_confusion(array, n_elements, base, timings, LARGE_N, &lcg);
 
         printf("  (Values near 0 = good. >0.1 or <-0.1 = concerning)\n");
+        static double acf[ACF_SCREEN_LAG + 1];
+        poc_acf(timings, LARGE_N, ACF_SCREEN_LAG, acf);
         for (int lag = 1; lag <= 10; lag++) {
-            double ac = autocorrelation(timings, LARGE_N, lag);
+            double ac = acf[lag];
             printf("  lag-%d: %.4f %s\n", lag, ac, fabs(ac) > 0.1 ? " *** HIGH ***" : "");
         }
+        PocLagPeak pk = poc_acf_peak(acf, ACF_SCREEN_LAG);
+        printf("  peak |r| over lags 1-%d: lag-%d %.4f%s\n", ACF_SCREEN_LAG, pk.lag, pk.r,
+               fabs(pk.r) > 0.1 ? " * periodic coupling *" : "");
         printf("\n");
-        free(timings);
     }
 
     // === TEST 3: Stability across 10 trials ===
@@ -260,9 +173,11 @@ int main(void) {
     {
         double min_ents[N_TRIALS];
         double shannon_ents[N_TRIALS];
-        uint64_t *timings = malloc(TRIAL_N * sizeof(uint64_t));
+        uint64_t *timings = big;
 
         for (int t = 0; t < N_TRIALS; t++) {
+            // Fresh pointer graph per trial, in place
+            poc_arena_randomize(&arena, lcg + (uint64_t)t);
             collect_dmp_confusion(array, n_elements, base, timings, TRIAL_N, &lcg);
             Stats s = compute_stats(timings, TRIAL_N);
             min_ents[t] = s.min_entropy;
@@ -287,7 +202,6 @@ int main(void) {
                me_mean, me_min, me_max, sqrt(me_var / N_TRIALS));
         printf("  Verdict: %s\n\n",
                (me_max - me_min) < 1.0 ? "STABLE" : "UNSTABLE — wide variation");
-        free(timings);
     }
 
     // === TEST 4: DMP vs plain cache miss ===
@@ -301,8 +215,7 @@ int main(void) {
             data_array[i] = (uint64_t)i * 3 + 7;
         }
 
-        uint64_t *dmp_timings = malloc(TRIAL_N * sizeof(uint64_t));
-        uint64_t *cache_timings = malloc(TRIAL_N * sizeof(uint64_t));
+        uint64_t *dmp_timings = big, *cache_timings = aux;
 
         collect_dmp_confusion(array, n_elements, base, dmp_timings, TRIAL_N, &lcg);
         collect_plain_cache_miss(data_array, n_elements, cache_timings, TRIAL_N, &lcg);
@@ -335,16 +248,13 @@ int main(void) {
         printf("  Verdict: %s\n\n", fabs(r) < 0.1 ? "Independent" :
                fabs(r) < 0.3 ? "Weakly correlated" : "SIGNIFICANTLY correlated — CONCERN");
 
-        free(dmp_timings);
-        free(cache_timings);
         munmap(data_array, ARRAY_SIZE);
     }
 
     // === TEST 5: Sequential (DMP-predictable) vs random ===
     printf("=== Test 5: Sequential (DMP-predictable) vs Random (DMP-confusing) ===\n");
     {
-        uint64_t *seq_timings = malloc(TRIAL_N * sizeof(uint64_t));
-        uint64_t *rnd_timings = malloc(TRIAL_N * sizeof(uint64_t));
+        uint64_t *seq_timings = big, *rnd_timings = aux;
 
         collect_sequential(array, n_elements, base, seq_timings, TRIAL_N);
         collect_dmp_confusion(array, n_elements, base, rnd_timings, TRIAL_N, &lcg);
@@ -363,10 +273,9 @@ int main(void) {
                "DMP confusion MEASURABLY increases entropy vs predictable access" :
                "Minimal difference — DMP may not be the entropy driver — CONCERN");
 
-        free(seq_timings);
-        free(rnd_timings);
     }
 
-    munmap(array, ARRAY_SIZE);
+    poc_samples_free(&samples);
+    poc_arena_free(&arena);
     return 0;
 }
@@ -1,191 +1,70 @@
 // validate_dram_row_buffer.c — Entropy source validation
 // Mechanism: Allocate 32MB buffer, random reads from 2 distant locations, measure timing
 // Cross-correlate: cache_contention, cpu_memory_beat
-// Compile: cc -O2 -o validate_dram_row_buffer validate_dram_row_buffer.c -lm
+// Compile: make validate_dram_row_buffer
+// Collector: collectors/dram_row_buffer.c
+//
+//   ./validate_dram_row_buffer              two random distant reads per sample
+//   ./validate_dram_row_buffer --conflict   a mapped row-conflict pair per sample
+//   ./validate_dram_row_buffer --map        re-measure the row-conflict map for
+//                                           this boot, then compare both
+//                                           collectors: ns/sample, H∞, bits/s
 
 #include "validate_common.h"
+#include "collectors/collectors.h"
 
-#define DRAM_BUF_SIZE (32 * 1024 * 1024)
+#define COMPARE_N 50000
 
-static volatile uint8_t *g_dram_buf = NULL;
-
-static void ensure_dram_buf(void) {
-    if (g_dram_buf) return;
-    g_dram_buf = (volatile uint8_t *)mmap(NULL, DRAM_BUF_SIZE,
-        PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
-    if (g_dram_buf == MAP_FAILED) {
-        g_dram_buf = NULL;
+static void compare_one(const char *label, collect_func_t fn, double ns_per_tick) {
+    uint64_t *t = malloc(COMPARE_N * sizeof(uint64_t));
+    if (!t) {
+        printf("  %-18s out of memory\n", label);
         return;
     }
-    // Touch every page to populate
-    long page_size = sysconf(_SC_PAGESIZE);
-    for (size_t off = 0; off < DRAM_BUF_SIZE; off += (size_t)page_size) {
-        ((volatile uint8_t *)g_dram_buf)[off] = (uint8_t)(off & 0xFF);
-    }
-}
-
-static int collect_dram_row_buffer(uint64_t *timings, int n) {
-    ensure_dram_buf();
-    if (!g_dram_buf) return 0;
-
-    uint64_t lcg = mach_absolute_time();
-    int valid = 0;
-
-    for (int i = 0; i < n; i++) {
-        // Two distant random locations (at least 16MB apart)
-        size_t off1 = (size_t)(lcg_next(&lcg) % (DRAM_BUF_SIZE / 2));
-        size_t off2 = (DRAM_BUF_SIZE / 2) + (size_t)(lcg_next(&lcg) % (DRAM_BUF_SIZE / 2));
-
-        uint64_t t0 = mach_absolute_time();
-        volatile uint8_t v1 = g_dram_buf[off1];
-        volatile uint8_t v2 = g_dram_buf[off2];
-        uint64_t t1 = mach_absolute_time();
-        (void)v1; (void)v2;
-
-        timings[valid++] = t1 - t0;
-    }
-    return valid;
-}
-
-// Cross-correlation: cache_contention (sequential + random memory access)
-static int collect_cache_cross(uint64_t *timings, int n) {
-    ensure_dram_buf();
-    if (!g_dram_buf) return 0;
-
-    uint64_t lcg = mach_absolute_time();
-    volatile uint8_t sink;
-
-    for (int i = 0; i < n; i++) {
-        size_t base = (size_t)(lcg_next(&lcg) % (DRAM_BUF_SIZE - 4096));
-        uint64_t t0 = mach_absolute_time();
-        for (int j = 0; j < 64; j++)
-            sink = g_dram_buf[base + j * 64];
-        uint64_t t1 = mach_absolute_time();
-        (void)sink;
-        timings[i] = t1 - t0;
-    }
-    return n;
-}
-
-// Cross-correlation: cpu_memory_beat (interleaved CPU + memory)
-static int collect_cpu_mem_beat_cross(uint64_t *timings, int n) {
-    ensure_dram_buf();
-    if (!g_dram_buf) return 0;
-
-    uint64_t lcg = mach_absolute_time();
-    volatile uint64_t acc = 0;
-
-    for (int i = 0; i < n; i++) {
-        size_t off = (size_t)(lcg_next(&lcg) % (DRAM_BUF_SIZE - 8));
-
-        uint64_t t0 = mach_absolute_time();
-        // CPU work
-        for (int j = 0; j < 20; j++)
-            acc += lcg_next(&lcg);
-        // Memory access
-        volatile uint8_t v = g_dram_buf[off];
-        (void)v;
-        uint64_t t1 = mach_absolute_time();
-
-        timings[i] = t1 - t0;
+    uint64_t t0 = mach_absolute_time();
+    int n = fn(t, COMPARE_N);
+    uint64_t elapsed = mach_absolute_time() - t0;
+    if (n < POC_MIN_VALID) {
+        printf("  %-18s collection failed\n", label);
+        free(t);
+        return;
     }
-    (void)acc;
-    return n;
+    Stats s = compute_stats(t, n);
+    double ns = elapsed * ns_per_tick / n;
+    printf("  %-18s %7.1f ns/sample  H∞=%.3f  %8.0f bits/s\n", label, ns, s.min_entropy,
+           s.min_entropy * 1e9 / ns);
+    free(t);
 }
 
-int main(void) {
-    print_validation_header("dram_row_buffer");
+static int map_and_compare(void) {
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    double ns_per_tick = (double)tb.numer / tb.denom;
 
-    // === Test 1: Large sample entropy ===
-    printf("=== Test 1: %dK Sample Entropy ===\n", LARGE_N / 1000);
-    uint64_t *timings = malloc(LARGE_N * sizeof(uint64_t));
-    int valid = collect_dram_row_buffer(timings, LARGE_N);
-    if (valid < 100) {
-        printf("  FAIL: Only got %d samples\n", valid);
-        free(timings);
+    printf("# DRAM row-conflict map\n\n");
+    PocDramMap m = {0};
+    int ok = poc_dram_map(&m, 1) == 0;
+    if (!m.page_size) {
+        printf("  Could not allocate the collector buffer\n");
         return 1;
     }
-    Stats s = compute_stats(timings, valid);
-    printf("  Samples: %d  Mean=%.1f  StdDev=%.1f\n", valid, s.mean, s.stddev);
-    printf("  Shannon=%.3f  H_inf=%.3f\n\n", s.shannon, s.min_entropy);
-
-    // === Test 2: Autocorrelation ===
-    printf("=== Test 2: Autocorrelation (lag 1-5) ===\n");
-    double max_ac = 0;
-    for (int lag = 1; lag <= 5; lag++) {
-        double ac = autocorrelation(timings, valid, lag);
-        printf("  lag-%d: %.4f%s\n", lag, ac,
-               fabs(ac) > 0.5 ? " *** HIGH ***" : fabs(ac) > 0.1 ? " * warn *" : "");
-        if (fabs(ac) > max_ac) max_ac = fabs(ac);
-    }
-    printf("\n");
-    free(timings);
-
-    // === Test 3: Stability ===
-    printf("=== Test 3: Stability (%d trials x %d samples) ===\n", N_TRIALS, TRIAL_N);
-    double min_ents[N_TRIALS];
-    uint64_t *trial_buf = malloc(TRIAL_N * sizeof(uint64_t));
-    for (int t = 0; t < N_TRIALS; t++) {
-        int tv = collect_dram_row_buffer(trial_buf, TRIAL_N);
-        Stats ts = compute_stats(trial_buf, tv > 0 ? tv : 1);
-        min_ents[t] = ts.min_entropy;
-        printf("  Trial %2d: H_inf=%.3f  Shannon=%.3f  N=%d\n",
-               t + 1, ts.min_entropy, ts.shannon, tv);
-    }
-    free(trial_buf);
-
-    double me_mean = 0, me_var = 0;
-    for (int i = 0; i < N_TRIALS; i++) me_mean += min_ents[i];
-    me_mean /= N_TRIALS;
-    for (int i = 0; i < N_TRIALS; i++) {
-        double d = min_ents[i] - me_mean;
-        me_var += d * d;
-    }
-    double me_std = sqrt(me_var / N_TRIALS);
-    printf("\n  H_inf Mean=%.3f  StdDev=%.3f\n", me_mean, me_std);
-    printf("  Verdict: %s\n\n",
-           me_std > 2.0 ? "UNSTABLE (std > 2.0)" :
-           me_std > 1.0 ? "MARGINAL (std > 1.0)" : "STABLE");
-
-    // === Test 4: Cross-correlation ===
-    printf("=== Test 4: Cross-correlation ===\n");
-    int cc_n = 5000;
-    uint64_t *my_t = malloc(cc_n * sizeof(uint64_t));
-    int my_v = collect_dram_row_buffer(my_t, cc_n);
-    if (my_v < cc_n) cc_n = my_v;
-
-    const char *cross_names[] = {"cache_contention", "cpu_memory_beat"};
-    collect_func_t cross_funcs[] = {collect_cache_cross, collect_cpu_mem_beat_cross};
-    for (int c = 0; c < 2; c++) {
-        uint64_t *other_t = malloc(cc_n * sizeof(uint64_t));
-        int other_v = cross_funcs[c](other_t, cc_n);
-        int use_n = cc_n < other_v ? cc_n : other_v;
-        double r = pearson(my_t, other_t, use_n);
-        printf("  vs %-25s: r=%.4f%s\n", cross_names[c], r,
-               fabs(r) > 0.3 ? " *** REDUNDANT ***" :
-               fabs(r) > 0.1 ? " * weak *" : "");
-        free(other_t);
+    printf("  page %d B  hit %.1f ns  conflict %.1f ns  threshold %.1f ns\n", m.page_size,
+           m.hit_ticks * ns_per_tick, m.conflict_ticks * ns_per_tick,
+           m.threshold_ticks * ns_per_tick);
+    if (!ok) {
+        printf("  No separate conflict cluster — the conflict collector falls back\n\n");
+    } else {
+        printf("  Conflicting page pairs in the collector buffer: %d\n\n",
+               poc_dram_conflict_pairs());
     }
-    free(my_t);
-    printf("\n");
-
-    // Cleanup
-    if (g_dram_buf) munmap((void *)g_dram_buf, DRAM_BUF_SIZE);
 
-    // === Summary ===
-    printf("=== SUMMARY ===\n");
-    printf("  H_inf (100K): %.3f\n", s.min_entropy);
-    printf("  H_inf Mean (10 trials): %.3f\n", me_mean);
-    printf("  H_inf StdDev: %.3f\n", me_std);
-    printf("  Max autocorr: %.4f\n", max_ac);
-    if (s.min_entropy < 0.5)
-        printf("  VERDICT: CUT (H_inf < 0.5)\n");
-    else if (me_std > 2.0)
-        printf("  VERDICT: CUT (unstable, std > 2.0)\n");
-    else if (s.min_entropy < 1.5 || max_ac > 0.5)
-        printf("  VERDICT: DEMOTE (weak)\n");
-    else
-        printf("  VERDICT: KEEP\n");
-    printf("\n");
+    compare_one("random pairs", collect_dram_row_buffer, ns_per_tick);
+    compare_one("row-conflict pairs", collect_dram_row_conflict, ns_per_tick);
     return 0;
 }
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--map") == 0) return map_and_compare();
+    int conflict = argc > 1 && strcmp(argv[1], "--conflict") == 0;
+    return poc_validate(poc_collector_find(conflict ? "dram_row_conflict" : "dram_row_buffer"));
+}
@@ -3,7 +3,8 @@
 // 1. Repeated reads of SAME key — does securityd cache degrade entropy?
 // 2. Entropy at 100K samples (read path)
 // 3. Autocorrelation
-// 4. Stability across 10 trials
+// 4. Stability across 10 trials: H∞ stddev banded like the harness's Test 3
+//    (POC_SEQUENTIAL=1: stop once the σ interval settles, lib/poc_seqtrial.h)
 // 5. Comparison with mach_ipc timing (is this just IPC noise?)
 // 6. Audit log check — does this leave traces?
 
@@ -17,166 +18,63 @@
 #include <Security/Security.h>
 #include <CoreFoundation/CoreFoundation.h>
 
+#include "lib/poc_arena.h"
+#include "lib/poc_keychain.h"
+#include "lib/poc_seqtrial.h"
+#include "lib/poc_stats.h"
+#include "lib/poc_xcorr.h"
+
 #define LARGE_N 10000
 #define TRIAL_N 2000
 #define N_TRIALS 10
 
-typedef struct {
-    double shannon;
-    double min_entropy;
-    double mean;
-    double stddev;
-} Stats;
-
-static Stats compute_stats(uint64_t *timings, int n) {
-    Stats s = {0};
-    int hist[256] = {0};
-    uint64_t sum = 0;
-    for (int i = 0; i < n; i++) {
-        uint8_t f = 0;
-        for (int b = 0; b < 8; b++) f ^= (timings[i] >> (b*8)) & 0xFF;
-        hist[f]++;
-        sum += timings[i];
-    }
-    s.mean = (double)sum / n;
-    double var = 0;
-    for (int i = 0; i < n; i++) {
-        double d = timings[i] - s.mean;
-        var += d * d;
-    }
-    s.stddev = sqrt(var / n);
-
-    int mx = 0;
-    for (int i = 0; i < 256; i++) {
-        if (hist[i] > 0) {
-            double p = (double)hist[i] / n;
-            s.shannon -= p * log2(p);
-        }
-        if (hist[i] > mx) mx = hist[i];
-    }
-    s.min_entropy = -log2((double)mx / n);
-    return s;
-}
-
-static double autocorrelation(uint64_t *timings, int n, int lag) {
-    if (n <= lag) return 0;
-    double mean = 0;
-    for (int i = 0; i < n; i++) mean += timings[i];
-    mean /= n;
-
-    double num = 0, den = 0;
-    for (int i = 0; i < n - lag; i++) {
-        num += (timings[i] - mean) * (timings[i + lag] - mean);
-    }
-    for (int i = 0; i < n; i++) {
-        den += (timings[i] - mean) * (timings[i] - mean);
-    }
-    if (den < 1e-15) return 0;
-    return num / den;
-}
-
-static double pearson(uint64_t *a, uint64_t *b, int n) {
-    double ma = 0, mb = 0;
-    for (int i = 0; i < n; i++) { ma += a[i]; mb += b[i]; }
-    ma /= n; mb /= n;
-
-    double num = 0, da = 0, db = 0;
-    for (int i = 0; i < n; i++) {
-        double x = a[i] - ma, y = b[i] - mb;
-        num += x * y;
-        da += x * x;
-        db += y * y;
-    }
-    if (da < 1e-15 || db < 1e-15) return 0;
-    return num / sqrt(da * db);
-}
-
-// Helper: create keychain item, return label CF string
-static CFStringRef create_keychain_item(const char *label) {
-    CFStringRef labelRef = CFStringCreateWithCString(NULL, label, kCFStringEncodingUTF8);
-    uint8_t secret[16] = {0x42};
-    CFDataRef secretData = CFDataCreate(NULL, secret, sizeof(secret));
-
-    CFMutableDictionaryRef attrs = CFDictionaryCreateMutable(
-        NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-    CFDictionarySetValue(attrs, kSecClass, kSecClassGenericPassword);
-    CFDictionarySetValue(attrs, kSecAttrLabel, labelRef);
-    CFDictionarySetValue(attrs, kSecValueData, secretData);
-    CFDictionarySetValue(attrs, kSecAttrAccessible,
-                         kSecAttrAccessibleAfterFirstUnlockThisDeviceOnly);
-
-    // Delete first in case it exists
-    CFMutableDictionaryRef del = CFDictionaryCreateMutable(
-        NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-    CFDictionarySetValue(del, kSecClass, kSecClassGenericPassword);
-    CFDictionarySetValue(del, kSecAttrLabel, labelRef);
-    SecItemDelete((CFDictionaryRef)del);
-    CFRelease(del);
-
-    SecItemAdd((CFDictionaryRef)attrs, NULL);
-    CFRelease(attrs);
-    CFRelease(secretData);
-    return labelRef;
-}
-
-static void delete_keychain_item(CFStringRef labelRef) {
-    CFMutableDictionaryRef del = CFDictionaryCreateMutable(
-        NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-    CFDictionarySetValue(del, kSecClass, kSecClassGenericPassword);
-    CFDictionarySetValue(del, kSecAttrLabel, labelRef);
-    SecItemDelete((CFDictionaryRef)del);
-    CFRelease(del);
-}
-
-// Collect keychain read timings
-static int collect_keychain_reads(CFStringRef labelRef, uint64_t *timings, int n) {
-    CFMutableDictionaryRef query = CFDictionaryCreateMutable(
-        NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-    CFDictionarySetValue(query, kSecClass, kSecClassGenericPassword);
-    CFDictionarySetValue(query, kSecAttrLabel, labelRef);
-    CFDictionarySetValue(query, kSecReturnData, kCFBooleanTrue);
-
+// Collect keychain read timings. The query dictionary is the batch's
+// prebuilt one, so nothing is allocated around the timed call.
+static int collect_keychain_reads(PocKcBatch *item, uint64_t *timings, int n) {
     int valid = 0;
     for (int i = 0; i < n; i++) {
         CFTypeRef result = NULL;
         uint64_t t0 = mach_absolute_time();
-        OSStatus status = SecItemCopyMatching((CFDictionaryRef)query, &result);
+        OSStatus status = SecItemCopyMatching(item->query, &result);
         uint64_t t1 = mach_absolute_time();
         if (status == errSecSuccess) {
             timings[valid++] = t1 - t0;
         }
         if (result) CFRelease(result);
     }
-    CFRelease(query);
     return valid;
 }
 
-// Collect mach IPC round-trip timings for comparison
-static void collect_mach_ipc(uint64_t *timings, int n) {
-    for (int i = 0; i < n; i++) {
-        mach_port_t port;
-        uint64_t t0 = mach_absolute_time();
-        // Mach port allocate + deallocate = pure IPC overhead
-        mach_port_allocate(mach_task_self(), MACH_PORT_RIGHT_RECEIVE, &port);
-        mach_port_deallocate(mach_task_self(), port);
-        uint64_t t1 = mach_absolute_time();
-        timings[i] = t1 - t0;
-    }
-}
-
 int main(void) {
     printf("# Keychain Timing — Critical Validation\n\n");
 
     mach_timebase_info_data_t tb;
     mach_timebase_info(&tb);
 
-    CFStringRef label = create_keychain_item("openentropy-validation-probe");
+    // Every test's sample buffers, pre-faulted and locked before Test 1
+    PocSampleArena samples;
+    if (poc_samples_init(&samples, (LARGE_N + TRIAL_N) * sizeof(uint64_t) + 128) != 0) {
+        perror("mmap");
+        return 1;
+    }
+    uint64_t *big = POC_SAMPLES_U64(&samples, LARGE_N);
+    uint64_t *aux = POC_SAMPLES_U64(&samples, TRIAL_N);
+
+    // One item, created up front (after clearing any orphan from a crashed run)
+    PocKcBatch item;
+    if (poc_kc_batch_init(&item, "org.openentropy.validate-keychain",
+                          "openentropy-validation-probe", 1, 1) != 0) {
+        printf("FAIL: cannot build keychain query\n");
+        return 1;
+    }
+    poc_kc_delete_all(&item);
+    SecItemAdd(item.attrs, NULL);
 
     // === TEST 1: Repeated reads of SAME key — caching check ===
     printf("=== Test 1: Same-Key Caching Check (does entropy degrade over 10K reads?) ===\n");
     {
-        uint64_t *timings = malloc(LARGE_N * sizeof(uint64_t));
-        int valid = collect_keychain_reads(label, timings, LARGE_N);
+        uint64_t *timings = big;
+        int valid = collect_keychain_reads(&item, timings, LARGE_N);
 
         // Analyze first 1K, middle 1K, last 1K
         int chunk = valid / 5;
@@ -200,89 +98,100 @@ int main(void) {
                    "Stable — no significant caching degradation" :
                    "DEGRADATION detected — securityd may be caching");
         }
-        free(timings);
     }
 
     // === TEST 2: Full entropy at large sample count ===
     printf("=== Test 2: %dK Sample Entropy ===\n", LARGE_N/1000);
     {
-        uint64_t *timings = malloc(LARGE_N * sizeof(uint64_t));
-        int valid = collect_keychain_reads(label, timings, LARGE_N);
+        uint64_t *timings = big;
+        int valid = collect_keychain_reads(&item, timings, LARGE_N);
 
         Stats s = compute_stats(timings, valid);
         uint64_t mns = (uint64_t)(s.mean * tb.numer / tb.denom);
         printf("  Samples: %d  Mean=%.0f ticks (≈%llu ns = %.2f ms)\n",
                valid, s.mean, mns, (double)mns/1e6);
         printf("  XOR-fold: Shannon=%.3f  H∞=%.3f\n\n", s.shannon, s.min_entropy);
-        free(timings);
     }
 
     // === TEST 3: Autocorrelation ===
     printf("=== Test 3: Autocorrelation (lag 1-10) ===\n");
     {
-        uint64_t *timings = malloc(LARGE_N * sizeof(uint64_t));
-        int valid = collect_keychain_reads(label, timings, LARGE_N);
+        uint64_t *timings = big;
+        int valid = collect_keychain_reads(&item, timings, LARGE_N);
 
         printf("  (Values near 0 = good. >0.1 or <-0.1 = concerning)\n");
+        static double acf[ACF_SCREEN_LAG + 1];
+        poc_acf(timings, valid, ACF_SCREEN_LAG, acf);
         for (int lag = 1; lag <= 10; lag++) {
-            double ac = autocorrelation(timings, valid, lag);
+            double ac = acf[lag];
             printf("  lag-%d: %.4f %s\n", lag, ac, fabs(ac) > 0.1 ? " *** HIGH ***" : "");
         }
+        PocLagPeak pk = poc_acf_peak(acf, ACF_SCREEN_LAG);
+        printf("  peak |r| over lags 1-%d: lag-%d %.4f%s\n", ACF_SCREEN_LAG, pk.lag, pk.r,
+               fabs(pk.r) > 0.1 ? " * periodic coupling *" : "");
         printf("\n");
-        free(timings);
     }
 
     // === TEST 4: Stability across 10 trials ===
-    printf("=== Test 4: Stability (%d trials × %d samples) ===\n", N_TRIALS, TRIAL_N);
     {
-        double min_ents[N_TRIALS];
-        uint64_t *timings = malloc(TRIAL_N * sizeof(uint64_t));
-
-        for (int t = 0; t < N_TRIALS; t++) {
-            int valid = collect_keychain_reads(label, timings, TRIAL_N);
+        static const double std_bands[] = {1.0, 2.0};
+        const int seq_max = poc_seq_env_max();
+        const int max_trials = seq_max ? seq_max : N_TRIALS;
+        if (seq_max)
+            printf("=== Test 4: Stability (sequential, %d-%d trials × %d samples) ===\n",
+                   POC_SEQ_MIN_TRIALS, seq_max, TRIAL_N);
+        else
+            printf("=== Test 4: Stability (%d trials × %d samples) ===\n", N_TRIALS, TRIAL_N);
+        double *min_ents = malloc(max_trials * sizeof(double));
+        uint64_t *timings = big;
+        PocSeqTrials st = {0};
+
+        int n_trials = 0, settled = 0;
+        while (n_trials < max_trials) {
+            int valid = collect_keychain_reads(&item, timings, TRIAL_N);
             Stats s = compute_stats(timings, valid);
-            min_ents[t] = s.min_entropy;
+            min_ents[n_trials++] = s.min_entropy;
+            poc_seq_add(&st, s.min_entropy);
             printf("  Trial %2d: Shannon=%.3f  H∞=%.3f  Mean=%.0f  N=%d\n",
-                   t+1, s.shannon, s.min_entropy, s.mean, valid);
+                   n_trials, s.shannon, s.min_entropy, s.mean, valid);
+            if (seq_max && (settled = poc_seq_settled(&st, std_bands, 2))) break;
         }
 
         double me_mean = 0, me_min = 999, me_max = 0;
-        for (int i = 0; i < N_TRIALS; i++) {
+        for (int i = 0; i < n_trials; i++) {
             me_mean += min_ents[i];
             if (min_ents[i] < me_min) me_min = min_ents[i];
             if (min_ents[i] > me_max) me_max = min_ents[i];
         }
-        me_mean /= N_TRIALS;
-
-        printf("\n  H∞ across trials: Mean=%.3f  Min=%.3f  Max=%.3f  Range=%.3f\n",
-               me_mean, me_min, me_max, me_max - me_min);
-        printf("  Verdict: %s\n\n",
-               (me_max - me_min) < 1.0 ? "STABLE" : "UNSTABLE — wide variation");
-        free(timings);
+        me_mean /= n_trials;
+        // Judge on the σ the sequential rule settles on; a range verdict
+        // would be biased by stopping as soon as σ settles.
+        double me_std = poc_seq_std(&st);
+
+        printf("\n  H∞ across trials: Mean=%.3f  StdDev=%.3f  Min=%.3f  Max=%.3f  Range=%.3f\n",
+               me_mean, me_std, me_min, me_max, me_max - me_min);
+        printf("  Verdict: %s%s\n\n",
+               me_std > 2.0 ? "UNSTABLE (std > 2.0)" :
+               me_std > 1.0 ? "MARGINAL (std > 1.0)" : "STABLE",
+               !seq_max ? "" : settled ? "  (settled)" : "  (unsettled at the trial cap)");
+        free(min_ents);
     }
 
     // === TEST 5: Comparison with mach_ipc (is this just IPC noise?) ===
     printf("=== Test 5: Keychain vs Mach IPC (independence check) ===\n");
     {
         int test_n = TRIAL_N;
-        uint64_t *kc_timings = malloc(test_n * sizeof(uint64_t));
-        uint64_t *ipc_timings = malloc(test_n * sizeof(uint64_t));
+        uint64_t *kc_timings = big, *ipc_timings = aux;
 
         // Collect interleaved samples for best correlation estimate
         for (int i = 0; i < test_n; i++) {
             // Keychain read
-            CFMutableDictionaryRef query = CFDictionaryCreateMutable(
-                NULL, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
-            CFDictionarySetValue(query, kSecClass, kSecClassGenericPassword);
-            CFDictionarySetValue(query, kSecAttrLabel, label);
-            CFDictionarySetValue(query, kSecReturnData, kCFBooleanTrue);
             CFTypeRef result = NULL;
             uint64_t t0 = mach_absolute_time();
-            SecItemCopyMatching((CFDictionaryRef)query, &result);
+            SecItemCopyMatching(item.query, &result);
             uint64_t t1 = mach_absolute_time();
             kc_timings[i] = t1 - t0;
             if (result) CFRelease(result);
-            CFRelease(query);
 
             // Mach IPC
             mach_port_t port;
@@ -311,16 +220,14 @@ int main(void) {
         printf("  H∞ advantage over IPC: %.3f bits\n\n",
                kc_s.min_entropy - ipc_s.min_entropy);
 
-        free(kc_timings);
-        free(ipc_timings);
     }
 
     // === TEST 6: Performance impact ===
     printf("=== Test 6: Performance Assessment ===\n");
     {
-        uint64_t *timings = malloc(1000 * sizeof(uint64_t));
+        uint64_t *timings = big;
         uint64_t wall_start = mach_absolute_time();
-        int valid = collect_keychain_reads(label, timings, 1000);
+        int valid = collect_keychain_reads(&item, timings, 1000);
         uint64_t wall_end = mach_absolute_time();
 
         double wall_ns = (double)(wall_end - wall_start) * tb.numer / tb.denom;
@@ -335,12 +242,12 @@ int main(void) {
                bytes_per_sec);
         printf("  For 64 bytes: ~%.0f ms\n", 64 * 4 * per_sample_ms);
         printf("  For 256 bytes: ~%.0f ms\n\n", 256 * 4 * per_sample_ms);
-        free(timings);
     }
 
     // Cleanup
-    delete_keychain_item(label);
-    CFRelease(label);
+    poc_kc_delete_all(&item);
+    poc_kc_batch_free(&item);
+    poc_samples_free(&samples);
 
     // === TEST 7: Audit log concern ===
     printf("=== Test 7: Audit & Side-Effect Assessment ===\n");
@@ -348,7 +255,7 @@ int main(void) {
     printf("  - Does NOT trigger Keychain Access prompts (item created by us)\n");
     printf("  - Does NOT appear in Console.app security logs (checked manually)\n");
     printf("  - Does NOT persist after cleanup (item deleted at end)\n");
-    printf("  - Creates ONE keychain item labeled 'openentropy-timing-probe'\n");
+    printf("  - Creates ONE keychain item (account 'openentropy-validation-probe-0')\n");
     printf("  - If the process crashes, one orphan item remains (harmless)\n");
     printf("  - No disk write per read (only initial add + final delete)\n\n");
 